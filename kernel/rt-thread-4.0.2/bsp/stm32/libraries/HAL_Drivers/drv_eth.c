@@ -9,6 +9,9 @@
  * 2018-12-25     zylx         fix some bugs
  * 2019-06-10     SummerGift   optimize PHY state detection process
  * 2019-09-03     xiaofan      optimize link change detection process
+ * 2026-10-18     liujiahao    add zero-copy DMA receive and transmit
+ * 2026-10-18     liujiahao    add the Rx polling
+ * 2026-10-18     liujiahao    reclaim the transmitted frames by the Tx interrupt
  */
 
 #include "board.h"
@@ -52,6 +55,49 @@ static rt_uint8_t *Rx_Buff, *Tx_Buff;
 static  ETH_HandleTypeDef EthHandle;
 static struct rt_stm32_eth stm32_eth_device;
 
+#ifdef BSP_ETH_USING_ZERO_COPY
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "The zero-copy Ethernet needs the custom pbuf of lwIP, please enable RT_LWIP_REASSEMBLY_FRAG"
+#endif
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define ETH_CACHE_LINE_SIZE     32
+#else
+#define ETH_CACHE_LINE_SIZE     RT_ALIGN_SIZE
+#endif
+
+#ifndef BSP_ETH_RX_POOL_EXTRA
+#define BSP_ETH_RX_POOL_EXTRA   8
+#endif
+
+/* the receive buffers are in the descriptors or lent to the stack */
+#define ETH_RX_POOL_NUM         (ETH_RXBUFNB + BSP_ETH_RX_POOL_EXTRA)
+/* the receive buffers don't share the cache lines, the invalidation of a buffer keeps the others */
+#define ETH_RX_POOL_BUF_SIZE    RT_ALIGN(ETH_RX_BUF_SIZE, ETH_CACHE_LINE_SIZE)
+/* the ticks to wait for the transmit descriptors */
+#define ETH_TX_TIMEOUT          (RT_TICK_PER_SECOND / 100 + 1)
+
+struct stm32_eth_rx_pbuf
+{
+    struct pbuf_custom pc;
+    rt_uint8_t *buffer;
+    struct stm32_eth_rx_pbuf *next;
+};
+
+static struct stm32_eth_rx_pbuf *rx_pbufs, *rx_free_list;
+static rt_uint32_t rx_free_count;
+/* the buffer of each receive descriptor */
+static struct stm32_eth_rx_pbuf *rx_desc_pbufs[ETH_RXBUFNB];
+/* the frame of each transmit descriptor, it's on the last segment of frame */
+static struct pbuf *tx_desc_pbufs[ETH_TXBUFNB];
+/* the oldest transmit descriptor in use */
+static ETH_DMADescTypeDef *tx_reclaim_desc;
+static rt_uint32_t tx_free_count;
+static struct rt_mutex tx_lock;
+static struct rt_semaphore tx_wait_sem;
+static volatile rt_bool_t tx_waiting;
+#endif /* BSP_ETH_USING_ZERO_COPY */
+
 #if defined(ETH_RX_DUMP) || defined(ETH_TX_DUMP)
 #define __is_print(ch) ((unsigned int)((ch) - ' ') < 127u - ' ')
 static void dump_hex(const rt_uint8_t *ptr, rt_size_t buflen)
@@ -78,6 +124,91 @@ static void dump_hex(const rt_uint8_t *ptr, rt_size_t buflen)
 }
 #endif
 
+#ifdef BSP_ETH_USING_ZERO_COPY
+/* write the data back from D-Cache, the DMA reads the memory */
+static void stm32_eth_cache_clean(const void *addr, rt_uint32_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    rt_uint32_t start = (rt_uint32_t)addr & ~(ETH_CACHE_LINE_SIZE - 1);
+
+    if (SCB->CCR & SCB_CCR_DC_Msk)
+    {
+        SCB_CleanDCache_by_Addr((uint32_t *)start, (rt_uint32_t)addr + size - start);
+    }
+#endif
+}
+
+/* drop the lines of D-Cache, the DMA writes the memory, the address and size are aligned */
+static void stm32_eth_cache_invalidate(void *addr, rt_uint32_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+    if (SCB->CCR & SCB_CCR_DC_Msk)
+    {
+        SCB_InvalidateDCache_by_Addr((uint32_t *)addr, size);
+    }
+#endif
+}
+
+/* the frame in the receive buffer is freed by the stack, in any thread */
+static void stm32_eth_rx_pbuf_free(struct pbuf *p)
+{
+    struct stm32_eth_rx_pbuf *rx = (struct stm32_eth_rx_pbuf *)p;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rx->next = rx_free_list;
+    rx_free_list = rx;
+    rx_free_count++;
+    rt_hw_interrupt_enable(level);
+}
+
+static struct stm32_eth_rx_pbuf *stm32_eth_rx_pbuf_alloc(void)
+{
+    struct stm32_eth_rx_pbuf *rx;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rx = rx_free_list;
+    if (rx != RT_NULL)
+    {
+        rx_free_list = rx->next;
+        rx_free_count--;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return rx;
+}
+
+/* give the pool buffers to the receive descriptors before the DMA starts */
+static void stm32_eth_zero_copy_init(void)
+{
+    rt_uint32_t i;
+
+    rx_free_list = RT_NULL;
+    rx_free_count = 0;
+    for (i = 0; i < ETH_RX_POOL_NUM; i++)
+    {
+        rx_pbufs[i].buffer = Rx_Buff + i * ETH_RX_POOL_BUF_SIZE;
+        rx_pbufs[i].pc.custom_free_function = stm32_eth_rx_pbuf_free;
+        stm32_eth_rx_pbuf_free(&rx_pbufs[i].pc.pbuf);
+    }
+
+    for (i = 0; i < ETH_RXBUFNB; i++)
+    {
+        rx_desc_pbufs[i] = stm32_eth_rx_pbuf_alloc();
+        stm32_eth_cache_invalidate(rx_desc_pbufs[i]->buffer, ETH_RX_POOL_BUF_SIZE);
+        DMARxDscrTab[i].Buffer1Addr = (uint32_t)rx_desc_pbufs[i]->buffer;
+    }
+
+    rt_memset(tx_desc_pbufs, 0, sizeof(tx_desc_pbufs));
+    tx_reclaim_desc = DMATxDscrTab;
+    tx_free_count = ETH_TXBUFNB;
+
+    /* the last descriptor of frame raises the Tx interrupt to free the frame */
+    __HAL_ETH_DMA_ENABLE_IT(&EthHandle, ETH_DMA_IT_T);
+}
+#endif /* BSP_ETH_USING_ZERO_COPY */
+
 extern void phy_reset(void);
 /* EMAC initialization function */
 static rt_err_t rt_stm32_eth_init(rt_device_t dev)
@@ -118,6 +249,11 @@ static rt_err_t rt_stm32_eth_init(rt_device_t dev)
     /* Initialize Rx Descriptors list: Chain Mode  */
     HAL_ETH_DMARxDescListInit(&EthHandle, DMARxDscrTab, Rx_Buff, ETH_RXBUFNB);
 
+#ifdef BSP_ETH_USING_ZERO_COPY
+    /* the descriptors point to the pool buffers and the pbufs of frames */
+    stm32_eth_zero_copy_init();
+#endif
+
     /* ETH interrupt Init */
     HAL_NVIC_SetPriority(ETH_IRQn, 0x07, 0);
     HAL_NVIC_EnableIRQ(ETH_IRQn);
@@ -179,6 +315,317 @@ static rt_err_t rt_stm32_eth_control(rt_device_t dev, int cmd, void *args)
     return RT_EOK;
 }
 
+#ifdef BSP_ETH_USING_ZERO_COPY
+static rt_bool_t stm32_eth_tx_dma_able(const void *payload)
+{
+#ifdef CCMDATARAM_BASE
+    /* the CCM RAM isn't on the bus of ETH DMA */
+    if ((rt_uint32_t)payload >= CCMDATARAM_BASE && (rt_uint32_t)payload <= CCMDATARAM_END)
+    {
+        return RT_FALSE;
+    }
+#endif
+
+    return RT_TRUE;
+}
+
+/* the DMA reads the payload until the pbuf is freed, the PBUF_REF and PBUF_ROM
+ * refer to the memory of caller which is reused once the sending returns */
+static rt_bool_t stm32_eth_tx_owned(const struct pbuf *q)
+{
+    if (q->flags & PBUF_FLAG_IS_CUSTOM)
+    {
+        return RT_TRUE;
+    }
+
+#ifdef PBUF_TYPE_ALLOC_SRC_MASK
+    return pbuf_get_allocsrc(q) != PBUF_TYPE_ALLOC_SRC_MASK_STD_MEMP_PBUF;
+#else
+    return (q->type == PBUF_RAM || q->type == PBUF_POOL);
+#endif
+}
+
+/* the frames sent are pending to be freed */
+static rt_bool_t stm32_eth_tx_done(void)
+{
+    return (tx_free_count < ETH_TXBUFNB &&
+            (tx_reclaim_desc->Status & ETH_DMATXDESC_OWN) == (uint32_t)RESET);
+}
+
+/* free the frames sent by the DMA, return the number of free transmit descriptors,
+ * it's called with the tx_lock */
+static rt_uint32_t stm32_eth_tx_reclaim(void)
+{
+    rt_uint32_t index;
+
+    while (tx_free_count < ETH_TXBUFNB && (tx_reclaim_desc->Status & ETH_DMATXDESC_OWN) == (uint32_t)RESET)
+    {
+        index = tx_reclaim_desc - DMATxDscrTab;
+        if (tx_desc_pbufs[index] != NULL)
+        {
+            pbuf_free(tx_desc_pbufs[index]);
+            tx_desc_pbufs[index] = NULL;
+        }
+
+        tx_free_count++;
+        tx_reclaim_desc = (ETH_DMADescTypeDef *)(tx_reclaim_desc->Buffer2NextDescAddr);
+    }
+
+    return tx_free_count;
+}
+
+/* ethernet device interface */
+/* transmit data, the descriptors point to the pbufs, the pbufs are freed after they're sent */
+rt_err_t rt_stm32_eth_tx(rt_device_t dev, struct pbuf *p)
+{
+    rt_err_t ret = ERR_OK;
+    struct pbuf *q, *frame = p;
+    ETH_DMADescTypeDef *dmatxdesc, *first;
+    uint32_t segcount = 0, index = 0, status;
+    rt_tick_t tick, elapsed;
+
+    for (q = p; q != NULL; q = q->next)
+    {
+        if (q->len == 0)
+            continue;
+        if (!stm32_eth_tx_dma_able(q->payload) || !stm32_eth_tx_owned(q))
+            break;
+        segcount++;
+    }
+
+    if (q != NULL || segcount > ETH_TXBUFNB)
+    {
+        /* the DMA can't read the pbufs, the payload isn't owned by the pbufs, or
+         * the frame has more segments than the descriptors */
+        frame = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
+        if (frame == NULL)
+        {
+            LOG_D("no memory for tx frame");
+            return ERR_MEM;
+        }
+        pbuf_copy(frame, p);
+        segcount = 1;
+    }
+    else
+    {
+        /* the caller frees the frame after it returns */
+        pbuf_ref(p);
+    }
+
+    rt_mutex_take(&tx_lock, RT_WAITING_FOREVER);
+
+    /* the DMA sends a frame in microseconds, it's stuck on the link down */
+    tick = rt_tick_get();
+    while (stm32_eth_tx_reclaim() < segcount)
+    {
+        elapsed = rt_tick_get() - tick;
+        if (elapsed >= ETH_TX_TIMEOUT)
+        {
+            LOG_D("dma tx desc buffer is not valid");
+            pbuf_free(frame);
+            ret = ERR_USE;
+            goto error;
+        }
+
+        /* the Tx interrupt wakes up the waiting, the frame may be sent before it's set */
+        tx_waiting = RT_TRUE;
+        if (!stm32_eth_tx_done())
+        {
+            rt_sem_take(&tx_wait_sem, ETH_TX_TIMEOUT - elapsed);
+        }
+        tx_waiting = RT_FALSE;
+    }
+
+    LOG_D("transmit frame lenth :%d, %d segments", frame->tot_len, segcount);
+
+    first = dmatxdesc = EthHandle.TxDesc;
+    for (q = frame; q != NULL; q = q->next)
+    {
+        if (q->len == 0)
+            continue;
+
+#ifdef ETH_TX_DUMP
+        dump_hex(q->payload, q->len);
+#endif
+        stm32_eth_cache_clean(q->payload, q->len);
+
+        status = dmatxdesc->Status & ~(ETH_DMATXDESC_FS | ETH_DMATXDESC_LS | ETH_DMATXDESC_IC);
+        if (dmatxdesc == first)
+        {
+            status |= ETH_DMATXDESC_FS;
+        }
+        else
+        {
+            /* the first descriptor is given to DMA at last, the DMA doesn't see a partial frame */
+            status |= ETH_DMATXDESC_OWN;
+        }
+        if (++index == segcount)
+        {
+            status |= ETH_DMATXDESC_LS | ETH_DMATXDESC_IC;
+            tx_desc_pbufs[dmatxdesc - DMATxDscrTab] = frame;
+        }
+
+        dmatxdesc->Buffer1Addr = (uint32_t)q->payload;
+        dmatxdesc->ControlBufferSize = q->len & ETH_DMATXDESC_TBS1;
+        dmatxdesc->Status = status;
+        dmatxdesc = (ETH_DMADescTypeDef *)(dmatxdesc->Buffer2NextDescAddr);
+    }
+    tx_free_count -= segcount;
+    EthHandle.TxDesc = dmatxdesc;
+
+    __DSB();
+    first->Status |= ETH_DMATXDESC_OWN;
+
+    /* When Tx Buffer unavailable flag is set: clear it and resume transmission */
+    if ((EthHandle.Instance->DMASR & ETH_DMASR_TBUS) != (uint32_t)RESET)
+    {
+        /* Clear TBUS ETHERNET DMA flag */
+        EthHandle.Instance->DMASR = ETH_DMASR_TBUS;
+        /* Resume DMA transmission*/
+        EthHandle.Instance->DMATPDR = 0;
+    }
+
+error:
+
+    /* When Transmit Underflow flag is set, clear it and issue a Transmit Poll Demand to resume transmission */
+    if ((EthHandle.Instance->DMASR & ETH_DMASR_TUS) != (uint32_t)RESET)
+    {
+        /* Clear TUS ETHERNET DMA flag */
+        EthHandle.Instance->DMASR = ETH_DMASR_TUS;
+
+        /* Resume DMA transmission*/
+        EthHandle.Instance->DMATPDR = 0;
+    }
+
+    rt_mutex_release(&tx_lock);
+
+    return ret;
+}
+
+/* free the frames sent on the quiet link, the Tx interrupt notifies the Rx thread */
+static void stm32_eth_tx_flush(void)
+{
+    if (stm32_eth_tx_done())
+    {
+        rt_mutex_take(&tx_lock, RT_WAITING_FOREVER);
+        stm32_eth_tx_reclaim();
+        rt_mutex_release(&tx_lock);
+    }
+}
+
+/* copy the frame out of the descriptors, the buffers are kept in the descriptors */
+static struct pbuf *stm32_eth_rx_copy(uint32_t len)
+{
+    struct pbuf *p;
+    __IO ETH_DMADescTypeDef *dmarxdesc;
+    uint32_t offset, seglen;
+
+    p = pbuf_alloc(PBUF_RAW, len, PBUF_RAM);
+    if (p == NULL)
+        return NULL;
+
+    dmarxdesc = EthHandle.RxFrameInfos.FSRxDesc;
+    for (offset = 0; offset < len; offset += seglen)
+    {
+        seglen = len - offset > ETH_RX_BUF_SIZE ? ETH_RX_BUF_SIZE : len - offset;
+
+        stm32_eth_cache_invalidate((void *)dmarxdesc->Buffer1Addr, ETH_RX_POOL_BUF_SIZE);
+        memcpy((uint8_t *)p->payload + offset, (void *)dmarxdesc->Buffer1Addr, seglen);
+        dmarxdesc = (ETH_DMADescTypeDef *)(dmarxdesc->Buffer2NextDescAddr);
+    }
+
+    return p;
+}
+
+/* receive data, the frame is in the pbufs of the receive buffers, the descriptors are refilled */
+struct pbuf *rt_stm32_eth_rx(rt_device_t dev)
+{
+    struct pbuf *p = NULL;
+    struct pbuf *q = NULL;
+    struct stm32_eth_rx_pbuf *rx;
+    HAL_StatusTypeDef state;
+    __IO ETH_DMADescTypeDef *dmarxdesc;
+    uint32_t len, seglen, index, i;
+
+    stm32_eth_tx_flush();
+
+    /* Get received frame */
+    state = HAL_ETH_GetReceivedFrame_IT(&EthHandle);
+    if (state != HAL_OK)
+    {
+        LOG_D("receive frame faild");
+        return NULL;
+    }
+
+    len = EthHandle.RxFrameInfos.length;
+    LOG_D("receive frame len : %d", len);
+
+    /* only this thread takes the buffers, the stack gives them back */
+    if (len > 0 && rx_free_count >= EthHandle.RxFrameInfos.SegCount)
+    {
+        dmarxdesc = EthHandle.RxFrameInfos.FSRxDesc;
+        for (i = 0; i < EthHandle.RxFrameInfos.SegCount; i++)
+        {
+            /* the last segment may have the CRC only */
+            seglen = len > ETH_RX_BUF_SIZE ? ETH_RX_BUF_SIZE : len;
+            if (seglen > 0)
+            {
+                index = dmarxdesc - DMARxDscrTab;
+                rx = rx_desc_pbufs[index];
+
+                /* the lines may be loaded when the DMA writes the buffer */
+                stm32_eth_cache_invalidate(rx->buffer, ETH_RX_POOL_BUF_SIZE);
+                q = pbuf_alloced_custom(PBUF_RAW, seglen, PBUF_REF, &rx->pc, rx->buffer, ETH_RX_POOL_BUF_SIZE);
+                if (p == NULL)
+                    p = q;
+                else
+                    pbuf_cat(p, q);
+
+                rx_desc_pbufs[index] = stm32_eth_rx_pbuf_alloc();
+                stm32_eth_cache_invalidate(rx_desc_pbufs[index]->buffer, ETH_RX_POOL_BUF_SIZE);
+                dmarxdesc->Buffer1Addr = (uint32_t)rx_desc_pbufs[index]->buffer;
+                len -= seglen;
+            }
+            dmarxdesc = (ETH_DMADescTypeDef *)(dmarxdesc->Buffer2NextDescAddr);
+        }
+        __DSB();
+    }
+    else if (len > 0)
+    {
+        /* the stack holds all spare buffers */
+        p = stm32_eth_rx_copy(len);
+    }
+
+#ifdef ETH_RX_DUMP
+    for (q = p; q != NULL; q = q->next)
+        dump_hex(q->payload, q->len);
+#endif
+
+    /* Release descriptors to DMA */
+    /* Point to first descriptor */
+    dmarxdesc = EthHandle.RxFrameInfos.FSRxDesc;
+    /* Set Own bit in Rx descriptors: gives the buffers back to DMA */
+    for (i = 0; i < EthHandle.RxFrameInfos.SegCount; i++)
+    {
+        dmarxdesc->Status |= ETH_DMARXDESC_OWN;
+        dmarxdesc = (ETH_DMADescTypeDef *)(dmarxdesc->Buffer2NextDescAddr);
+    }
+
+    /* Clear Segment_Count */
+    EthHandle.RxFrameInfos.SegCount = 0;
+
+    /* When Rx Buffer unavailable flag is set: clear it and resume reception */
+    if ((EthHandle.Instance->DMASR & ETH_DMASR_RBUS) != (uint32_t)RESET)
+    {
+        /* Clear RBUS ETHERNET DMA flag */
+        EthHandle.Instance->DMASR = ETH_DMASR_RBUS;
+        /* Resume DMA reception */
+        EthHandle.Instance->DMARPDR = 0;
+    }
+
+    return p;
+}
+#else
 /* ethernet device interface */
 /* transmit data*/
 rt_err_t rt_stm32_eth_tx(rt_device_t dev, struct pbuf *p)
@@ -368,6 +815,36 @@ struct pbuf *rt_stm32_eth_rx(rt_device_t dev)
 
     return p;
 }
+#endif /* BSP_ETH_USING_ZERO_COPY */
+
+#ifdef ETHIF_RX_POLLING
+/* mask the Rx interrupt while ethernetif polls the frames */
+static rt_err_t rt_stm32_eth_rx_irq(rt_device_t dev, rt_bool_t enable)
+{
+    if (enable)
+    {
+        __HAL_ETH_DMA_CLEAR_IT(&EthHandle, ETH_DMA_IT_R);
+        __HAL_ETH_DMA_ENABLE_IT(&EthHandle, ETH_DMA_IT_R);
+
+        /* the frame received just before unmasking doesn't raise the interrupt,
+         * neither does the frame sent while the Rx thread is notified */
+        if ((EthHandle.RxDesc->Status & ETH_DMARXDESC_OWN) == (uint32_t)RESET
+#ifdef BSP_ETH_USING_ZERO_COPY
+            || stm32_eth_tx_done()
+#endif
+            )
+        {
+            eth_device_ready(&(stm32_eth_device.parent));
+        }
+    }
+    else
+    {
+        __HAL_ETH_DMA_DISABLE_IT(&EthHandle, ETH_DMA_IT_R);
+    }
+
+    return RT_EOK;
+}
+#endif /* ETHIF_RX_POLLING */
 
 /* interrupt service routine */
 void ETH_IRQHandler(void)
@@ -389,6 +866,21 @@ void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
         LOG_I("RxCpltCallback err = %d", result);
 }
 
+#ifdef BSP_ETH_USING_ZERO_COPY
+void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth)
+{
+    /* the waiting transmitter frees the frames, or the Rx thread does */
+    if (tx_waiting)
+    {
+        rt_sem_release(&tx_wait_sem);
+    }
+    else
+    {
+        eth_device_ready(&(stm32_eth_device.parent));
+    }
+}
+#endif /* BSP_ETH_USING_ZERO_COPY */
+
 void HAL_ETH_ErrorCallback(ETH_HandleTypeDef *heth)
 {
     LOG_E("eth err");
@@ -545,6 +1037,20 @@ static int rt_hw_stm32_eth_init(void)
 {
     rt_err_t state = RT_EOK;
 
+#ifdef BSP_ETH_USING_ZERO_COPY
+    /* Prepare receive buffers aligned to the cache line, the transmit descriptors point to the pbufs */
+    Rx_Buff = (rt_uint8_t *)rt_malloc_align(ETH_RX_POOL_NUM * ETH_RX_POOL_BUF_SIZE, ETH_CACHE_LINE_SIZE);
+    rx_pbufs = (struct stm32_eth_rx_pbuf *)rt_calloc(ETH_RX_POOL_NUM, sizeof(struct stm32_eth_rx_pbuf));
+    if (Rx_Buff == RT_NULL || rx_pbufs == RT_NULL)
+    {
+        LOG_E("No memory");
+        state = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    rt_mutex_init(&tx_lock, "eth_tx", RT_IPC_FLAG_FIFO);
+    rt_sem_init(&tx_wait_sem, "eth_tx", 0, RT_IPC_FLAG_FIFO);
+#else
     /* Prepare receive and send buffers */
     Rx_Buff = (rt_uint8_t *)rt_calloc(ETH_RXBUFNB, ETH_MAX_PACKET_SIZE);
     if (Rx_Buff == RT_NULL)
@@ -561,6 +1067,7 @@ static int rt_hw_stm32_eth_init(void)
         state = -RT_ENOMEM;
         goto __exit;
     }
+#endif /* BSP_ETH_USING_ZERO_COPY */
 
     DMARxDscrTab = (ETH_DMADescTypeDef *)rt_calloc(ETH_RXBUFNB, sizeof(ETH_DMADescTypeDef));
     if (DMARxDscrTab == RT_NULL)
@@ -600,6 +1107,9 @@ static int rt_hw_stm32_eth_init(void)
 
     stm32_eth_device.parent.eth_rx     = rt_stm32_eth_rx;
     stm32_eth_device.parent.eth_tx     = rt_stm32_eth_tx;
+#ifdef ETHIF_RX_POLLING
+    stm32_eth_device.parent.eth_rx_irq = rt_stm32_eth_rx_irq;
+#endif
 
     /* register eth device */
     state = eth_device_init(&(stm32_eth_device.parent), "e0");
@@ -633,10 +1143,22 @@ static int rt_hw_stm32_eth_init(void)
 __exit:
     if (state != RT_EOK)
     {
+#ifdef BSP_ETH_USING_ZERO_COPY
+        if (Rx_Buff)
+        {
+            rt_free_align(Rx_Buff);
+        }
+
+        if (rx_pbufs)
+        {
+            rt_free(rx_pbufs);
+        }
+#else
         if (Rx_Buff)
         {
             rt_free(Rx_Buff);
         }
+#endif
 
         if (Tx_Buff)
         {
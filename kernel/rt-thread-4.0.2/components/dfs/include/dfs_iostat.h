@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#ifndef DFS_IOSTAT_H__
+#define DFS_IOSTAT_H__
+
+#include <dfs.h>
+#include <dfs_fs.h>
+#include <dfs_file.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* operations which are counted */
+#define DFS_IOSTAT_OPEN         0
+#define DFS_IOSTAT_READ         1
+#define DFS_IOSTAT_WRITE        2
+#define DFS_IOSTAT_STAT         3
+#define DFS_IOSTAT_FLUSH        4
+#define DFS_IOSTAT_OP_NUM       5
+
+/* latency histogram, bucket n holds the latency in [2^n, 2^(n+1)) microseconds */
+#define DFS_IOSTAT_HIST_NUM     20
+
+#ifdef DFS_USING_IOSTAT
+
+struct dfs_iostat_op
+{
+    rt_uint32_t count;
+    rt_uint32_t errors;
+    rt_uint64_t bytes;
+    rt_uint64_t time_us;                /* total latency */
+    rt_uint32_t max_us;
+    rt_uint32_t hist[DFS_IOSTAT_HIST_NUM];
+};
+
+struct dfs_iostat
+{
+    struct dfs_iostat_op op[DFS_IOSTAT_OP_NUM];
+};
+
+void dfs_iostat_attach(struct dfs_filesystem *fs);
+void dfs_iostat_detach(struct dfs_filesystem *fs);
+
+rt_uint32_t dfs_iostat_time(void);
+void dfs_iostat_fs(struct dfs_filesystem *fs, int op, rt_uint32_t begin, int result);
+void dfs_iostat_fd(struct dfs_fd *fd, int op, rt_uint32_t begin, int result);
+
+void dfs_iostat_reset(void);
+int dfs_iostat_format(char *buf, rt_size_t size, rt_bool_t histogram);
+
+#else
+
+#define dfs_iostat_attach(fs)
+#define dfs_iostat_detach(fs)
+
+#define dfs_iostat_time()                       0
+#define dfs_iostat_fs(fs, op, begin, result)    ((void)(begin))
+#define dfs_iostat_fd(fd, op, begin, result)    ((void)(begin))
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
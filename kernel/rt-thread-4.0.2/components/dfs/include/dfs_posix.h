@@ -10,6 +10,7 @@
  * 2011-05-16     Yi.qiu       Change parameter name of rename, "new" is C++ key word.
  * 2017-12-27     Bernard      Add fcntl API.
  * 2018-02-07     Bernard      Change the 3rd parameter of open/fcntl/ioctl to '...'
+ * 2026-10-18     liujiahao    Add readv/writev.
  */
 
 #ifndef __DFS_POSIX_H__
@@ -50,6 +51,19 @@ int read(int fd, void *buf, size_t len);
 int write(int fd, const void *buf, size_t len);
 #endif
 
+/* scatter/gather I/O, it's the same as the iovec in lwIP */
+#ifndef _STRUCT_IOVEC_DEFINED
+#define _STRUCT_IOVEC_DEFINED
+struct iovec
+{
+    void  *iov_base;
+    size_t iov_len;
+};
+#endif
+
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt);
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt);
+
 off_t lseek(int fd, off_t offset, int whence);
 int rename(const char *from, const char *to);
 int unlink(const char *pathname);
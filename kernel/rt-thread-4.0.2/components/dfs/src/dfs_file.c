@@ -9,10 +9,12 @@
  * 2011-12-08     Bernard      Merges rename patch from iamcacy.
  * 2015-05-27     Bernard      Fix the fd clear issue.
  * 2019-01-24     Bernard      Remove file repeatedly open check.
+ * 2026-10-18     liujiahao    Add I/O statistics.
  */
 
 #include <dfs.h>
 #include <dfs_file.h>
+#include <dfs_iostat.h>
 #include <dfs_private.h>
 
 /**
@@ -34,12 +36,15 @@ int dfs_file_open(struct dfs_fd *fd, const char *path, int flags)
 {
     struct dfs_filesystem *fs;
     char *fullpath;
+    rt_uint32_t begin;
     int result;
 
     /* parameter check */
     if (fd == NULL)
         return -EINVAL;
 
+    begin = dfs_iostat_time();
+
     /* make sure we have an absolute path */
     fullpath = dfs_normalize_path(NULL, path);
     if (fullpath == NULL)
@@ -93,7 +98,9 @@ int dfs_file_open(struct dfs_fd *fd, const char *path, int flags)
         return -ENOSYS;
     }
 
-    if ((result = fd->fops->open(fd)) < 0)
+    result = fd->fops->open(fd);
+    dfs_iostat_fs(fs, DFS_IOSTAT_OPEN, begin, result);
+    if (result < 0)
     {
         /* clear fd */
         rt_free(fd->path);
@@ -194,6 +201,7 @@ int dfs_file_ioctl(struct dfs_fd *fd, int cmd, void *args)
  */
 int dfs_file_read(struct dfs_fd *fd, void *buf, size_t len)
 {
+    rt_uint32_t begin;
     int result = 0;
 
     if (fd == NULL)
@@ -202,8 +210,10 @@ int dfs_file_read(struct dfs_fd *fd, void *buf, size_t len)
     if (fd->fops->read == NULL)
         return -ENOSYS;
 
+    begin = dfs_iostat_time();
     if ((result = fd->fops->read(fd, buf, len)) < 0)
         fd->flags |= DFS_F_EOF;
+    dfs_iostat_fd(fd, DFS_IOSTAT_READ, begin, result);
 
     return result;
 }
@@ -293,13 +303,20 @@ __exit:
  */
 int dfs_file_write(struct dfs_fd *fd, const void *buf, size_t len)
 {
+    rt_uint32_t begin;
+    int result;
+
     if (fd == NULL)
         return -EINVAL;
 
     if (fd->fops->write == NULL)
         return -ENOSYS;
 
-    return fd->fops->write(fd, buf, len);
+    begin = dfs_iostat_time();
+    result = fd->fops->write(fd, buf, len);
+    dfs_iostat_fd(fd, DFS_IOSTAT_WRITE, begin, result);
+
+    return result;
 }
 
 /**
@@ -311,13 +328,20 @@ int dfs_file_write(struct dfs_fd *fd, const void *buf, size_t len)
  */
 int dfs_file_flush(struct dfs_fd *fd)
 {
+    rt_uint32_t begin;
+    int result;
+
     if (fd == NULL)
         return -EINVAL;
 
     if (fd->fops->flush == NULL)
         return -ENOSYS;
 
-    return fd->fops->flush(fd);
+    begin = dfs_iostat_time();
+    result = fd->fops->flush(fd);
+    dfs_iostat_fd(fd, DFS_IOSTAT_FLUSH, begin, result);
+
+    return result;
 }
 
 /**
@@ -359,6 +383,7 @@ int dfs_file_stat(const char *path, struct stat *buf)
 {
     int result;
     char *fullpath;
+    rt_uint32_t begin;
     struct dfs_filesystem *fs;
 
     fullpath = dfs_normalize_path(NULL, path);
@@ -404,10 +429,12 @@ int dfs_file_stat(const char *path, struct stat *buf)
         }
 
         /* get the real file path and get file stat */
+        begin = dfs_iostat_time();
         if (fs->ops->flags & DFS_FS_FLAG_FULLPATH)
             result = fs->ops->stat(fs, fullpath, buf);
         else
             result = fs->ops->stat(fs, dfs_subdir(fs->path, fullpath), buf);
+        dfs_iostat_fs(fs, DFS_IOSTAT_STAT, begin, result);
     }
 
     rt_free(fullpath);
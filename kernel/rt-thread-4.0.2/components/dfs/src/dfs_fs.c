@@ -10,10 +10,12 @@
  * 2011-03-12     Bernard      fix the filesystem lookup issue.
  * 2017-11-30     Bernard      fix the filesystem_operation_table issue.
  * 2017-12-05     Bernard      fix the fs type search issue in mkfs.
+ * 2026-10-18     liujiahao    Add I/O statistics.
  */
 
 #include <dfs_fs.h>
 #include <dfs_file.h>
+#include <dfs_iostat.h>
 #include "dfs_private.h"
 
 /**
@@ -344,6 +346,8 @@ int dfs_mount(const char   *device_name,
         goto err1;
     }
 
+    dfs_iostat_attach(fs);
+
     return 0;
 
 err1:
@@ -395,6 +399,8 @@ int dfs_unmount(const char *specialfile)
         goto err1;
     }
 
+    dfs_iostat_detach(fs);
+
     /* close device, but do not check the status of device */
     if (fs->dev_id != NULL)
         rt_device_close(fs->dev_id);
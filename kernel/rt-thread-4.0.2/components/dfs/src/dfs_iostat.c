@@ -0,0 +1,691 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * I/O statistics of the file systems.
+ *
+ * The DFS counts the operations, bytes and latency of every mounted file system and
+ * of the block device under it. The read and write functions of the block device are
+ * hooked on mount, so the device I/O of the file system (FAT table, directory entries)
+ * is counted too. The busiest files are kept in a small table with the space-saving
+ * algorithm, the files marked with "~" may be over counted.
+ *
+ * The statistics are shown by the finsh command "iostat", or read from the device
+ * "iostat" (/dev/iostat when devfs is used).
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include <dfs_iostat.h>
+#include <dfs_private.h>
+
+#ifdef DFS_USING_IOSTAT
+
+#define IOSTAT_BUF_SIZE         4096
+#define IOSTAT_NAME_MAX         32
+
+struct iostat_dev
+{
+    rt_device_t device;
+    rt_uint16_t ref_count;
+    rt_uint16_t sector_size;
+
+    /* the original interface of the device */
+#ifdef RT_USING_DEVICE_OPS
+    const struct rt_device_ops *ops;
+    struct rt_device_ops hook_ops;
+#endif
+    rt_size_t (*read)(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size);
+    rt_size_t (*write)(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size);
+
+    struct dfs_iostat_op rd;
+    struct dfs_iostat_op wr;
+};
+
+#if DFS_IOSTAT_TOP_FILES > 0
+struct iostat_file
+{
+    rt_uint32_t hash;
+    rt_int16_t fs_index;                /* -1 for the empty entry */
+    rt_uint16_t ops;
+    rt_uint32_t read_bytes;
+    rt_uint32_t write_bytes;
+    rt_uint32_t over;                   /* over estimated bytes of the replaced entry */
+    char name[IOSTAT_NAME_MAX];
+};
+
+static struct iostat_file _files[DFS_IOSTAT_TOP_FILES];
+#endif
+
+static struct dfs_iostat _fs_stat[DFS_FILESYSTEMS_MAX];
+static struct iostat_dev _dev_stat[DFS_FILESYSTEMS_MAX];
+
+static const char *_op_name[DFS_IOSTAT_OP_NUM] =
+{
+    "open", "read", "write", "stat", "flush"
+};
+
+static struct rt_device _iostat_device;
+static struct rt_mutex _iostat_lock;
+static char *_iostat_buf;
+static int _iostat_len;
+
+/**
+ * this function will return the time stamp for the latency measurement, the CPU
+ * time is used if it's available.
+ *
+ * @return the time stamp.
+ */
+rt_uint32_t dfs_iostat_time(void)
+{
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_gettime();
+#else
+    return rt_tick_get();
+#endif
+}
+
+static rt_uint32_t _elapsed_us(rt_uint32_t begin)
+{
+    rt_uint32_t elapsed = dfs_iostat_time() - begin;
+
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_microsecond(elapsed);
+#else
+    return (rt_uint32_t)((rt_uint64_t)elapsed * 1000000 / RT_TICK_PER_SECOND);
+#endif
+}
+
+static void _op_update(struct dfs_iostat_op *op, rt_uint32_t us, rt_uint32_t bytes, rt_bool_t error)
+{
+    rt_uint32_t bucket = 0, value = us;
+
+    while (value > 1 && bucket < DFS_IOSTAT_HIST_NUM - 1)
+    {
+        value >>= 1;
+        bucket ++;
+    }
+
+    rt_enter_critical();
+    op->count ++;
+    if (error)
+        op->errors ++;
+    op->bytes += bytes;
+    op->time_us += us;
+    if (us > op->max_us)
+        op->max_us = us;
+    op->hist[bucket] ++;
+    rt_exit_critical();
+}
+
+/* the upper bound of the latency which percent of the operations are below */
+static rt_uint32_t _op_percentile(const struct dfs_iostat_op *op, rt_uint32_t percent)
+{
+    rt_uint32_t target, sum = 0;
+    int index;
+
+    if (op->count == 0)
+        return 0;
+
+    target = (rt_uint32_t)(((rt_uint64_t)op->count * percent + 99) / 100);
+    for (index = 0; index < DFS_IOSTAT_HIST_NUM - 1; index ++)
+    {
+        sum += op->hist[index];
+        if (sum >= target)
+            break;
+    }
+
+    if (index == DFS_IOSTAT_HIST_NUM - 1 || (2UL << index) > op->max_us)
+        return op->max_us;
+
+    return 2UL << index;
+}
+
+static int _fs_index(struct dfs_filesystem *fs)
+{
+    if (fs < &filesystem_table[0] || fs >= &filesystem_table[DFS_FILESYSTEMS_MAX])
+        return -1;
+
+    return fs - &filesystem_table[0];
+}
+
+static struct iostat_dev *_dev_find(rt_device_t device)
+{
+    int index;
+
+    for (index = 0; index < DFS_FILESYSTEMS_MAX; index ++)
+    {
+        if (_dev_stat[index].device == device)
+            return &_dev_stat[index];
+    }
+
+    return RT_NULL;
+}
+
+static rt_size_t _dev_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    struct iostat_dev *stat;
+    rt_uint32_t begin;
+    rt_size_t result;
+
+    stat = _dev_find(dev);
+    RT_ASSERT(stat != RT_NULL);
+
+    begin = dfs_iostat_time();
+    result = stat->read(dev, pos, buffer, size);
+    _op_update(&stat->rd, _elapsed_us(begin), result * stat->sector_size, result != size);
+
+    return result;
+}
+
+static rt_size_t _dev_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct iostat_dev *stat;
+    rt_uint32_t begin;
+    rt_size_t result;
+
+    stat = _dev_find(dev);
+    RT_ASSERT(stat != RT_NULL);
+
+    begin = dfs_iostat_time();
+    result = stat->write(dev, pos, buffer, size);
+    _op_update(&stat->wr, _elapsed_us(begin), result * stat->sector_size, result != size);
+
+    return result;
+}
+
+static void _dev_hook(struct iostat_dev *stat, rt_device_t device, rt_uint16_t sector_size)
+{
+    stat->device = device;
+    stat->sector_size = sector_size;
+    rt_memset(&stat->rd, 0, sizeof(stat->rd));
+    rt_memset(&stat->wr, 0, sizeof(stat->wr));
+
+#ifdef RT_USING_DEVICE_OPS
+    stat->ops = device->ops;
+    stat->hook_ops = *device->ops;
+    stat->read = device->ops->read;
+    stat->write = device->ops->write;
+    if (stat->read)
+        stat->hook_ops.read = _dev_read;
+    if (stat->write)
+        stat->hook_ops.write = _dev_write;
+    device->ops = &stat->hook_ops;
+#else
+    stat->read = device->read;
+    stat->write = device->write;
+    if (stat->read)
+        device->read = _dev_read;
+    if (stat->write)
+        device->write = _dev_write;
+#endif
+}
+
+static void _dev_unhook(struct iostat_dev *stat)
+{
+    rt_device_t device = stat->device;
+
+    /* the entry is kept for the callers which are still in the hooks */
+#ifdef RT_USING_DEVICE_OPS
+    device->ops = stat->ops;
+#else
+    device->read = stat->read;
+    device->write = stat->write;
+#endif
+}
+
+/**
+ * this function will clear the statistics of a file system which is just mounted
+ * and hook the block device under it.
+ *
+ * @param fs the mounted file system.
+ */
+void dfs_iostat_attach(struct dfs_filesystem *fs)
+{
+    struct rt_device_blk_geometry geometry;
+    struct iostat_dev *stat;
+    int index;
+
+    index = _fs_index(fs);
+    if (index < 0)
+        return;
+
+    rt_enter_critical();
+    rt_memset(&_fs_stat[index], 0, sizeof(struct dfs_iostat));
+#if DFS_IOSTAT_TOP_FILES > 0
+    for (index = 0; index < DFS_IOSTAT_TOP_FILES; index ++)
+    {
+        if (_files[index].fs_index == fs - &filesystem_table[0])
+            _files[index].fs_index = -1;
+    }
+#endif
+    rt_exit_critical();
+
+    if (fs->dev_id == RT_NULL || fs->dev_id->type != RT_Device_Class_Block)
+        return;
+
+    rt_memset(&geometry, 0, sizeof(geometry));
+    rt_device_control(fs->dev_id, RT_DEVICE_CTRL_BLK_GETGEOME, &geometry);
+
+    rt_enter_critical();
+    stat = _dev_find(fs->dev_id);
+    if (stat == RT_NULL || stat->ref_count == 0)
+    {
+        if (stat == RT_NULL)
+            stat = _dev_find(RT_NULL);
+        /* a stale entry of an unmounted device can be used again */
+        for (index = 0; stat == RT_NULL && index < DFS_FILESYSTEMS_MAX; index ++)
+        {
+            if (_dev_stat[index].ref_count == 0)
+                stat = &_dev_stat[index];
+        }
+        if (stat != RT_NULL)
+            _dev_hook(stat, fs->dev_id, geometry.bytes_per_sector);
+    }
+    if (stat != RT_NULL)
+        stat->ref_count ++;
+    rt_exit_critical();
+}
+
+/**
+ * this function will restore the block device of a file system which is going to be
+ * unmounted.
+ *
+ * @param fs the mounted file system.
+ */
+void dfs_iostat_detach(struct dfs_filesystem *fs)
+{
+    struct iostat_dev *stat;
+
+    if (fs->dev_id == RT_NULL)
+        return;
+
+    rt_enter_critical();
+    stat = _dev_find(fs->dev_id);
+    if (stat != RT_NULL && stat->ref_count > 0)
+    {
+        stat->ref_count --;
+        if (stat->ref_count == 0)
+            _dev_unhook(stat);
+    }
+    rt_exit_critical();
+}
+
+/**
+ * this function will count an operation on the path of a file system.
+ *
+ * @param fs the file system.
+ * @param op the operation, DFS_IOSTAT_OPEN or DFS_IOSTAT_STAT.
+ * @param begin the time stamp before the operation.
+ * @param result the result of the operation.
+ */
+void dfs_iostat_fs(struct dfs_filesystem *fs, int op, rt_uint32_t begin, int result)
+{
+    int index;
+
+    index = _fs_index(fs);
+    if (index < 0 || op >= DFS_IOSTAT_OP_NUM)
+        return;
+
+    _op_update(&_fs_stat[index].op[op], _elapsed_us(begin), 0, result < 0);
+}
+
+#if DFS_IOSTAT_TOP_FILES > 0
+static rt_uint32_t _file_hash(int fs_index, const char *path)
+{
+    rt_uint32_t hash = 2166136261UL ^ (rt_uint32_t)fs_index;
+
+    while (*path)
+    {
+        hash ^= (rt_uint8_t)*path++;
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+static void _file_update(int fs_index, const char *path, int op, rt_uint32_t bytes)
+{
+    struct iostat_file *file = RT_NULL, *victim = RT_NULL;
+    rt_uint32_t hash, total, min = 0;
+    rt_size_t length;
+    int index;
+
+    hash = _file_hash(fs_index, path);
+    /* keep the tail of a long path */
+    length = rt_strlen(path);
+    if (length > IOSTAT_NAME_MAX - 1)
+        path += length - (IOSTAT_NAME_MAX - 1);
+
+    rt_enter_critical();
+    for (index = 0; index < DFS_IOSTAT_TOP_FILES; index ++)
+    {
+        struct iostat_file *iter = &_files[index];
+
+        if (iter->fs_index < 0)
+        {
+            if (victim == RT_NULL || min > 0)
+            {
+                victim = iter;
+                min = 0;
+            }
+            continue;
+        }
+        if (iter->hash == hash && iter->fs_index == fs_index &&
+            rt_strncmp(iter->name, path, IOSTAT_NAME_MAX) == 0)
+        {
+            file = iter;
+            break;
+        }
+
+        total = iter->read_bytes + iter->write_bytes + iter->over;
+        if (victim == RT_NULL || total < min)
+        {
+            victim = iter;
+            min = total;
+        }
+    }
+
+    if (file == RT_NULL)
+    {
+        /* the least busy file is replaced, the new one inherits its bytes */
+        file = victim;
+        file->hash = hash;
+        file->fs_index = fs_index;
+        file->ops = 0;
+        file->read_bytes = 0;
+        file->write_bytes = 0;
+        file->over = min;
+        rt_strncpy(file->name, path, IOSTAT_NAME_MAX - 1);
+        file->name[IOSTAT_NAME_MAX - 1] = '\0';
+    }
+
+    file->ops ++;
+    if (op == DFS_IOSTAT_READ)
+        file->read_bytes += bytes;
+    else
+        file->write_bytes += bytes;
+    rt_exit_critical();
+}
+#endif
+
+/**
+ * this function will count a read, write or flush operation on a file descriptor.
+ *
+ * @param fd the file descriptor.
+ * @param op the operation, DFS_IOSTAT_READ, DFS_IOSTAT_WRITE or DFS_IOSTAT_FLUSH.
+ * @param begin the time stamp before the operation.
+ * @param result the result of the operation, the bytes for read and write.
+ */
+void dfs_iostat_fd(struct dfs_fd *fd, int op, rt_uint32_t begin, int result)
+{
+    rt_uint32_t bytes = 0;
+    int index;
+
+    /* socket and the other descriptors without file system */
+    index = _fs_index(fd->fs);
+    if (index < 0 || op >= DFS_IOSTAT_OP_NUM)
+        return;
+
+    if ((op == DFS_IOSTAT_READ || op == DFS_IOSTAT_WRITE) && result > 0)
+        bytes = result;
+    _op_update(&_fs_stat[index].op[op], _elapsed_us(begin), bytes, result < 0);
+
+#if DFS_IOSTAT_TOP_FILES > 0
+    if (bytes > 0 && fd->path != RT_NULL)
+        _file_update(index, fd->path, op, bytes);
+#endif
+}
+
+/**
+ * this function will clear all the statistics.
+ */
+void dfs_iostat_reset(void)
+{
+    int index;
+
+    rt_enter_critical();
+    rt_memset(_fs_stat, 0, sizeof(_fs_stat));
+    for (index = 0; index < DFS_FILESYSTEMS_MAX; index ++)
+    {
+        rt_memset(&_dev_stat[index].rd, 0, sizeof(struct dfs_iostat_op));
+        rt_memset(&_dev_stat[index].wr, 0, sizeof(struct dfs_iostat_op));
+    }
+#if DFS_IOSTAT_TOP_FILES > 0
+    for (index = 0; index < DFS_IOSTAT_TOP_FILES; index ++)
+        _files[index].fs_index = -1;
+#endif
+    rt_exit_critical();
+}
+
+static int _format_op(char *buf, rt_size_t size, const char *name, const char *op_name,
+                      const struct dfs_iostat_op *op, rt_bool_t histogram)
+{
+    int length, index;
+
+    length = rt_snprintf(buf, size, "%-10.10s %-5s %8d %6d %10d %8d %8d %8d %8d\n",
+                         name, op_name, op->count, op->errors, (rt_uint32_t)(op->bytes >> 10),
+                         (rt_uint32_t)(op->time_us / op->count),
+                         _op_percentile(op, 50), _op_percentile(op, 99), op->max_us);
+
+    if (histogram)
+    {
+        for (index = 0; index < DFS_IOSTAT_HIST_NUM && length < (int)size; index ++)
+        {
+            if (op->hist[index] == 0)
+                continue;
+            length += rt_snprintf(buf + length, size - length, "%24s< %8dus %8d\n",
+                                  "", 2UL << index, op->hist[index]);
+        }
+    }
+
+    return length < (int)size ? length : (int)size;
+}
+
+/**
+ * this function will format the statistics to a text buffer.
+ *
+ * @param buf the text buffer.
+ * @param size the size of buffer.
+ * @param histogram RT_TRUE to show the latency histogram.
+ *
+ * @return the length of text.
+ */
+int dfs_iostat_format(char *buf, rt_size_t size, rt_bool_t histogram)
+{
+    int length = 0, index, op;
+
+    if (size == 0)
+        return 0;
+    buf[0] = '\0';
+
+#define IOSTAT_PRINT(...) \
+    do { \
+        if (length < (int)size) \
+            length += rt_snprintf(buf + length, size - length, __VA_ARGS__); \
+    } while (0)
+
+    IOSTAT_PRINT("mount      op       count errors   bytes(K)  avg(us)  p50(us)  p99(us)  max(us)\n");
+    IOSTAT_PRINT("---------- ----- -------- ------ ---------- -------- -------- -------- --------\n");
+    for (index = 0; index < DFS_FILESYSTEMS_MAX; index ++)
+    {
+        struct dfs_filesystem *fs = &filesystem_table[index];
+
+        if (fs->ops == RT_NULL)
+            continue;
+
+        for (op = 0; op < DFS_IOSTAT_OP_NUM; op ++)
+        {
+            if (_fs_stat[index].op[op].count == 0 || length >= (int)size)
+                continue;
+            length += _format_op(buf + length, size - length, fs->path, _op_name[op],
+                                 &_fs_stat[index].op[op], histogram);
+        }
+    }
+
+    IOSTAT_PRINT("\ndevice     op       count errors   bytes(K)  avg(us)  p50(us)  p99(us)  max(us)\n");
+    IOSTAT_PRINT("---------- ----- -------- ------ ---------- -------- -------- -------- --------\n");
+    for (index = 0; index < DFS_FILESYSTEMS_MAX; index ++)
+    {
+        struct iostat_dev *stat = &_dev_stat[index];
+
+        if (stat->ref_count == 0)
+            continue;
+
+        if (stat->rd.count && length < (int)size)
+            length += _format_op(buf + length, size - length, stat->device->parent.name, "read",
+                                 &stat->rd, histogram);
+        if (stat->wr.count && length < (int)size)
+            length += _format_op(buf + length, size - length, stat->device->parent.name, "write",
+                                 &stat->wr, histogram);
+    }
+
+#if DFS_IOSTAT_TOP_FILES > 0
+    IOSTAT_PRINT("\nmount      file                              ops   read(K)  write(K)\n");
+    IOSTAT_PRINT("---------- -------------------------------- ------ --------- ---------\n");
+    {
+        rt_uint8_t shown[DFS_IOSTAT_TOP_FILES];
+
+        rt_memset(shown, 0, sizeof(shown));
+        /* the busiest file first */
+        for (op = 0; op < DFS_IOSTAT_TOP_FILES; op ++)
+        {
+            struct iostat_file *file = RT_NULL;
+            int busiest = -1;
+
+            for (index = 0; index < DFS_IOSTAT_TOP_FILES; index ++)
+            {
+                if (shown[index] || _files[index].fs_index < 0)
+                    continue;
+                if (file == RT_NULL ||
+                    _files[index].read_bytes + _files[index].write_bytes + _files[index].over >
+                    file->read_bytes + file->write_bytes + file->over)
+                {
+                    file = &_files[index];
+                    busiest = index;
+                }
+            }
+            if (file == RT_NULL)
+                break;
+
+            shown[busiest] = 1;
+            IOSTAT_PRINT("%-10.10s %-32.32s %6d %9d %9d%s\n",
+                         filesystem_table[file->fs_index].path, file->name, file->ops,
+                         file->read_bytes >> 10, file->write_bytes >> 10, file->over ? " ~" : "");
+        }
+    }
+#endif
+
+#undef IOSTAT_PRINT
+
+    return length < (int)size ? length : (int)size - 1;
+}
+
+/* the text is made when it's read from the beginning */
+static rt_size_t _iostat_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    rt_size_t length = 0;
+
+    rt_mutex_take(&_iostat_lock, RT_WAITING_FOREVER);
+    if (pos == 0)
+    {
+        if (_iostat_buf == RT_NULL)
+            _iostat_buf = (char *)rt_malloc(IOSTAT_BUF_SIZE);
+        _iostat_len = _iostat_buf ? dfs_iostat_format(_iostat_buf, IOSTAT_BUF_SIZE, RT_FALSE) : 0;
+    }
+    if (pos < _iostat_len)
+    {
+        length = _iostat_len - pos;
+        if (length > size)
+            length = size;
+        rt_memcpy(buffer, _iostat_buf + pos, length);
+    }
+    rt_mutex_release(&_iostat_lock);
+
+    return length;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops _iostat_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    _iostat_read,
+    RT_NULL,
+    RT_NULL
+};
+#endif
+
+int dfs_iostat_init(void)
+{
+#if DFS_IOSTAT_TOP_FILES > 0
+    int index;
+#endif
+
+    rt_mutex_init(&_iostat_lock, "iostat", RT_IPC_FLAG_FIFO);
+#if DFS_IOSTAT_TOP_FILES > 0
+    for (index = 0; index < DFS_IOSTAT_TOP_FILES; index ++)
+        _files[index].fs_index = -1;
+#endif
+
+    _iostat_device.type = RT_Device_Class_Char;
+#ifdef RT_USING_DEVICE_OPS
+    _iostat_device.ops = &_iostat_ops;
+#else
+    _iostat_device.read = _iostat_read;
+#endif
+    return rt_device_register(&_iostat_device, "iostat", RT_DEVICE_FLAG_RDONLY);
+}
+INIT_PREV_EXPORT(dfs_iostat_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void iostat(int argc, char **argv)
+{
+    rt_bool_t histogram = RT_FALSE;
+    char *buf;
+
+    if (argc > 1)
+    {
+        if (rt_strcmp(argv[1], "-c") == 0)
+        {
+            dfs_iostat_reset();
+            return;
+        }
+        else if (rt_strcmp(argv[1], "-h") == 0)
+        {
+            histogram = RT_TRUE;
+        }
+        else
+        {
+            rt_kprintf("Usage: iostat [-h] [-c]\n");
+            rt_kprintf("  -h show the latency histogram\n");
+            rt_kprintf("  -c clear the statistics\n");
+            return;
+        }
+    }
+
+    buf = (char *)rt_malloc(IOSTAT_BUF_SIZE);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return;
+    }
+    dfs_iostat_format(buf, IOSTAT_BUF_SIZE, histogram);
+    rt_kputs(buf);
+    rt_free(buf);
+}
+MSH_CMD_EXPORT(iostat, show file system I/O statistics: iostat [-h] [-c]);
+#endif
+
+#endif /* DFS_USING_IOSTAT */
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2009-05-27     Yi.qiu       The first version
  * 2018-02-07     Bernard      Change the 3rd parameter of open/fcntl/ioctl to '...'
+ * 2026-10-18     liujiahao    Add readv/writev.
  */
 
 #include <dfs.h>
@@ -188,6 +189,132 @@ int write(int fd, const void *buf, size_t len)
 }
 RTM_EXPORT(write);
 
+/**
+ * this function is a POSIX compliant version, which will read data from an
+ * open file descriptor into several buffers.
+ *
+ * @param fd the file descriptor.
+ * @param iov the buffers to save the read data.
+ * @param iovcnt the number of buffers.
+ *
+ * @return the actual read data length, or -1 on failed.
+ */
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt)
+{
+    int result = 0, index;
+    ssize_t total = 0;
+    struct dfs_fd *d;
+    int avail;
+
+    if (iovcnt < 0)
+    {
+        rt_set_errno(-EINVAL);
+
+        return -1;
+    }
+
+    /* get the fd */
+    d = fd_get(fd);
+    if (d == NULL)
+    {
+        rt_set_errno(-EBADF);
+
+        return -1;
+    }
+
+    for (index = 0; index < iovcnt; index ++)
+    {
+        if (iov[index].iov_len == 0)
+            continue;
+
+        /* don't block for the rest buffers once some data is read, the fd
+         * flags are shared so check the pending data instead of them */
+        if (total > 0 && dfs_file_ioctl(d, FIONREAD, &avail) == 0 && avail <= 0)
+            break;
+
+        result = dfs_file_read(d, iov[index].iov_base, iov[index].iov_len);
+        if (result <= 0)
+            break;
+
+        total += result;
+        if (result < iov[index].iov_len)
+            break;
+    }
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    if (total == 0 && result < 0)
+    {
+        rt_set_errno(result);
+
+        return -1;
+    }
+
+    return total;
+}
+RTM_EXPORT(readv);
+
+/**
+ * this function is a POSIX compliant version, which will write data from
+ * several buffers to an open file descriptor.
+ *
+ * @param fd the file descriptor.
+ * @param iov the data buffers to be written.
+ * @param iovcnt the number of buffers.
+ *
+ * @return the actual written data length, or -1 on failed.
+ */
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt)
+{
+    int result = 0, index;
+    ssize_t total = 0;
+    struct dfs_fd *d;
+
+    if (iovcnt < 0)
+    {
+        rt_set_errno(-EINVAL);
+
+        return -1;
+    }
+
+    /* get the fd */
+    d = fd_get(fd);
+    if (d == NULL)
+    {
+        rt_set_errno(-EBADF);
+
+        return -1;
+    }
+
+    for (index = 0; index < iovcnt; index ++)
+    {
+        if (iov[index].iov_len == 0)
+            continue;
+
+        result = dfs_file_write(d, iov[index].iov_base, iov[index].iov_len);
+        if (result <= 0)
+            break;
+
+        total += result;
+        if (result < iov[index].iov_len)
+            break;
+    }
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    if (total == 0 && result < 0)
+    {
+        rt_set_errno(result);
+
+        return -1;
+    }
+
+    return total;
+}
+RTM_EXPORT(writev);
+
 /**
  * this function is a POSIX compliant version, which will seek the offset for
  * an open file descriptor.
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#ifndef __MTD_NOR_KV_H__
+#define __MTD_NOR_KV_H__
+
+#include <rtthread.h>
+#include <drivers/mtd_nor.h>
+
+/*
+ * Introduction:
+ * The MTD NOR key-value storage keeps small values (configurations, counters) in a log
+ * which is appended across the erase blocks of a NOR flash. An update only programs a new
+ * record, the erase of a block is deferred to the incremental garbage collector which
+ * recycles the oldest block, so all the blocks are erased in turn (wear leveling).
+ * The location of every key is kept in a RAM hash index. The index is rebuilt by scanning
+ * the log at startup, or loaded from the checkpoint which is written on deinit.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RT_MTD_KV_KEY_MAX
+#define RT_MTD_KV_KEY_MAX               32
+#endif
+
+#ifndef RT_MTD_KV_TXN_MAX
+#define RT_MTD_KV_TXN_MAX               8
+#endif
+
+/* the garbage collector starts to work when the free blocks are less than this */
+#ifndef RT_MTD_KV_GC_WATERMARK
+#define RT_MTD_KV_GC_WATERMARK          2
+#endif
+
+/* the maximum number of records which are moved by the collector in one update */
+#ifndef RT_MTD_KV_GC_STEP
+#define RT_MTD_KV_GC_STEP               4
+#endif
+
+struct rt_mtd_kv_sector
+{
+    rt_uint32_t seq;                    /* log sequence, RT_MTD_KV_SEQ_FREE when the block is free */
+    rt_uint32_t erase_count;            /* erase times of the block */
+    rt_uint32_t used;                   /* write offset in the block */
+    rt_uint32_t live;                   /* bytes of the records referenced by the index */
+};
+
+struct rt_mtd_kv_node
+{
+    rt_uint32_t hash;
+    rt_uint32_t addr;                   /* record offset on the MTD device */
+    rt_uint16_t size;                   /* record size on the MTD device */
+    rt_uint16_t next;                   /* next node in the bucket or in the free list */
+};
+
+struct rt_mtd_kv
+{
+    struct rt_mtd_nor_device *mtd;
+    struct rt_mutex lock;
+
+    rt_uint32_t sector_size;
+    rt_uint16_t sector_num;
+    rt_uint16_t free_num;               /* number of free blocks */
+    rt_uint16_t head;                   /* the block which is appended */
+    rt_uint16_t tail;                   /* the oldest block, the victim of the collector */
+    rt_uint32_t gc_off;                 /* the collector position in the tail block */
+    rt_uint32_t seq;                    /* sequence for the next opened block */
+    rt_uint16_t txn;                    /* last used transaction id */
+
+    struct rt_mtd_kv_sector *sectors;
+
+    /* RAM hash index */
+    struct rt_mtd_kv_node *nodes;
+    rt_uint16_t *buckets;
+    rt_uint16_t bucket_mask;
+    rt_uint16_t node_max;
+    rt_uint16_t node_free;
+    rt_uint16_t key_num;
+
+    /* statistics */
+    rt_uint32_t erase_num;
+    rt_uint32_t prog_bytes;
+    rt_uint32_t gc_moved;
+};
+typedef struct rt_mtd_kv *rt_mtd_kv_t;
+
+struct rt_mtd_kv_txn
+{
+    rt_mtd_kv_t kv;
+    rt_uint8_t num;
+    struct
+    {
+        const char *key;
+        const void *value;              /* RT_NULL for delete */
+        rt_uint16_t len;
+    } ops[RT_MTD_KV_TXN_MAX];
+};
+
+rt_err_t rt_mtd_kv_init(rt_mtd_kv_t kv, struct rt_mtd_nor_device *mtd, rt_uint16_t max_keys);
+rt_err_t rt_mtd_kv_deinit(rt_mtd_kv_t kv);
+rt_err_t rt_mtd_kv_format(rt_mtd_kv_t kv);
+
+int rt_mtd_kv_get(rt_mtd_kv_t kv, const char *key, void *buf, rt_size_t size);
+rt_err_t rt_mtd_kv_set(rt_mtd_kv_t kv, const char *key, const void *value, rt_size_t len);
+rt_err_t rt_mtd_kv_del(rt_mtd_kv_t kv, const char *key);
+
+void rt_mtd_kv_txn_begin(rt_mtd_kv_t kv, struct rt_mtd_kv_txn *txn);
+rt_err_t rt_mtd_kv_txn_set(struct rt_mtd_kv_txn *txn, const char *key, const void *value, rt_size_t len);
+rt_err_t rt_mtd_kv_txn_del(struct rt_mtd_kv_txn *txn, const char *key);
+rt_err_t rt_mtd_kv_txn_commit(struct rt_mtd_kv_txn *txn);
+
+rt_err_t rt_mtd_kv_gc(rt_mtd_kv_t kv, rt_uint32_t steps);
+rt_err_t rt_mtd_kv_checkpoint(rt_mtd_kv_t kv);
+void rt_mtd_kv_dump(rt_mtd_kv_t kv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-18     liujiahao    Add lock-free ring buffer and vmsplice.
  */
 #ifndef PIPE_H__
 #define PIPE_H__
@@ -21,6 +22,26 @@
 #define PIPE_BUFSZ    RT_PIPE_BUFSZ
 #endif
 
+#ifdef RT_PIPE_USING_LOCKFREE
+#ifndef RT_PIPE_SEGMENT_MAX
+#define RT_PIPE_SEGMENT_MAX     4
+#endif
+
+/* flags of vmsplice */
+#define SPLICE_F_NONBLOCK       0x02    /* don't block on the pipe */
+#define SPLICE_F_GIFT           0x08    /* the buffer is given to pipe, and freed by rt_free */
+
+/* the buffer which is handed off to pipe */
+struct rt_pipe_segment
+{
+    const rt_uint8_t *buf;
+    rt_uint32_t len;
+    rt_uint32_t offset;                 /* bytes which are read */
+    rt_uint32_t pos;                    /* position in ring buffer, it's read after the bytes before it */
+    rt_bool_t gift;
+};
+#endif
+
 struct rt_pipe_device
 {
     struct rt_device parent;
@@ -37,9 +58,35 @@ struct rt_pipe_device
     rt_wqueue_t writer_queue;
 
     struct rt_mutex lock;
+
+#ifdef RT_PIPE_USING_LOCKFREE
+    /* single-producer single-consumer ring, the head is only moved by writer and
+     * the tail is only moved by reader, the readers (writers) are serialized by
+     * read_lock (write_lock). */
+    rt_uint8_t *ring;
+    rt_uint32_t ring_size;              /* power of 2 */
+    volatile rt_uint32_t head;
+    volatile rt_uint32_t tail;
+
+    /* the thread is going to sleep, the other side must wake it up */
+    volatile rt_uint8_t reader_waiting;
+    volatile rt_uint8_t writer_waiting;
+
+    struct rt_mutex read_lock;
+    struct rt_mutex write_lock;
+
+    struct rt_pipe_segment segments[RT_PIPE_SEGMENT_MAX];
+    volatile rt_uint16_t seg_head;
+    volatile rt_uint16_t seg_tail;
+#endif
 };
 typedef struct rt_pipe_device rt_pipe_t;
 
 rt_pipe_t *rt_pipe_create(const char *name, int bufsz);
 int rt_pipe_delete(const char *name);
+
+#if defined(RT_PIPE_USING_LOCKFREE) && defined(RT_USING_POSIX)
+struct iovec;
+int vmsplice(int fd, const struct iovec *iov, rt_size_t nr_segs, unsigned int flags);
+#endif
 #endif /* PIPE_H__ */
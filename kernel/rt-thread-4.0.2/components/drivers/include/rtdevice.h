@@ -42,6 +42,9 @@ extern "C" {
 
 #ifdef RT_USING_MTD_NOR
 #include "drivers/mtd_nor.h"
+#ifdef RT_USING_MTD_NOR_KV
+#include "drivers/mtd_nor_kv.h"
+#endif
 #endif /* RT_USING_MTD_NOR */
 
 #ifdef RT_USING_MTD_NAND
@@ -0,0 +1,1459 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <drivers/mtd_nor_kv.h>
+
+#ifdef RT_USING_MTD_NOR_KV
+
+#define DBG_TAG               "MTD.kv"
+#define DBG_LVL               DBG_INFO
+#include <rtdbg.h>
+
+/*
+ * Flash layout, each erase block:
+ *
+ * +------------------+--------+--------+-----+--------+---------------+
+ * | block header     | record | record | ... | record | erased (0xFF) |
+ * +------------------+--------+--------+-----+--------+---------------+
+ *
+ * A record is programmed key and value first, then the header, so a record is valid only
+ * when its header is complete. Records are never modified after programmed: an update
+ * appends a new version, a delete appends a tombstone.
+ */
+
+#define MTD_KV_SECTOR_MAGIC   0x564B544D      /* "MTKV" */
+#define MTD_KV_REC_MAGIC      0x5A
+#define MTD_KV_SEQ_FREE       0xFFFFFFFF
+#define MTD_KV_NIL            0xFFFF
+#define MTD_KV_ALIGN          4
+#define MTD_KV_COPY_SIZE      64
+
+enum mtd_kv_rec_type
+{
+    MTD_KV_REC_SET = 1,
+    MTD_KV_REC_DEL,
+    MTD_KV_REC_COMMIT,
+    MTD_KV_REC_CKPT,
+};
+
+struct mtd_kv_sector_hdr
+{
+    rt_uint32_t magic;
+    rt_uint32_t erase_count;
+    rt_uint32_t seq;                    /* programmed when the block is opened */
+    rt_uint32_t reserved;
+};
+
+struct mtd_kv_rec_hdr
+{
+    rt_uint8_t  magic;
+    rt_uint8_t  type;
+    rt_uint8_t  key_len;
+    rt_uint8_t  sum;                    /* checksum of the header */
+    rt_uint16_t val_len;
+    rt_uint16_t txn;                    /* 0 for the record out of transaction */
+    rt_uint32_t crc;                    /* crc32 of key and value */
+};
+
+/* the checkpoint record payload */
+struct mtd_kv_ckpt_hdr
+{
+    rt_uint16_t key_num;
+    rt_uint16_t txn;
+};
+
+struct mtd_kv_ckpt_node
+{
+    rt_uint32_t hash;
+    rt_uint32_t addr;
+    rt_uint32_t size;
+};
+
+#define SECTOR_HDR_SIZE       sizeof(struct mtd_kv_sector_hdr)
+#define REC_HDR_SIZE          sizeof(struct mtd_kv_rec_hdr)
+#define REC_SIZE(klen, vlen)  RT_ALIGN(REC_HDR_SIZE + (klen) + (vlen), MTD_KV_ALIGN)
+
+static const rt_uint32_t crc32_nibble[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+static rt_uint32_t _kv_crc32(rt_uint32_t crc, const void *buf, rt_size_t len)
+{
+    const rt_uint8_t *p = (const rt_uint8_t *)buf;
+
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *p++;
+        crc = crc32_nibble[crc & 0x0F] ^ (crc >> 4);
+        crc = crc32_nibble[crc & 0x0F] ^ (crc >> 4);
+    }
+
+    return ~crc;
+}
+
+/* FNV-1a */
+static rt_uint32_t _kv_hash(const char *key, rt_size_t len)
+{
+    rt_uint32_t hash = 2166136261UL;
+
+    while (len--)
+    {
+        hash ^= (rt_uint8_t)*key++;
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+static rt_uint8_t _kv_hdr_sum(const struct mtd_kv_rec_hdr *hdr)
+{
+    return (rt_uint8_t)~(hdr->magic + hdr->type + hdr->key_len +
+                         (hdr->val_len & 0xFF) + (hdr->val_len >> 8) +
+                         (hdr->txn & 0xFF) + (hdr->txn >> 8));
+}
+
+static rt_bool_t _kv_is_blank(const void *buf, rt_size_t len)
+{
+    const rt_uint8_t *p = (const rt_uint8_t *)buf;
+
+    while (len--)
+    {
+        if (*p++ != 0xFF)
+            return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+
+rt_inline rt_uint32_t _kv_addr(rt_mtd_kv_t kv, rt_uint16_t sector, rt_uint32_t offset)
+{
+    return (kv->mtd->block_start + sector) * kv->sector_size + offset;
+}
+
+rt_inline rt_uint16_t _kv_sector_of(rt_mtd_kv_t kv, rt_uint32_t addr)
+{
+    return addr / kv->sector_size - kv->mtd->block_start;
+}
+
+static rt_err_t _kv_read(rt_mtd_kv_t kv, rt_uint32_t addr, void *buf, rt_size_t len)
+{
+    if (rt_mtd_nor_read(kv->mtd, addr, (rt_uint8_t *)buf, len) != len)
+        return -RT_EIO;
+
+    return RT_EOK;
+}
+
+static rt_err_t _kv_prog(rt_mtd_kv_t kv, rt_uint32_t addr, const void *buf, rt_size_t len)
+{
+    if (len == 0)
+        return RT_EOK;
+
+    if (rt_mtd_nor_write(kv->mtd, addr, (const rt_uint8_t *)buf, len) != len)
+        return -RT_EIO;
+
+    kv->prog_bytes += len;
+    return RT_EOK;
+}
+
+static rt_err_t _kv_read_rec(rt_mtd_kv_t kv, rt_uint32_t addr, struct mtd_kv_rec_hdr *hdr)
+{
+    rt_err_t result;
+
+    result = _kv_read(kv, addr, hdr, REC_HDR_SIZE);
+    if (result != RT_EOK)
+        return result;
+
+    if (_kv_is_blank(hdr, REC_HDR_SIZE))
+        return -RT_EEMPTY;
+
+    if (hdr->magic != MTD_KV_REC_MAGIC || hdr->sum != _kv_hdr_sum(hdr) ||
+            addr % kv->sector_size + REC_SIZE(hdr->key_len, hdr->val_len) > kv->sector_size)
+        return -RT_ERROR;
+
+    return RT_EOK;
+}
+
+/* calculate crc32 of the record payload which is on the flash */
+static rt_err_t _kv_rec_crc(rt_mtd_kv_t kv, rt_uint32_t addr, rt_size_t len, rt_uint32_t *crc)
+{
+    rt_uint8_t buf[MTD_KV_COPY_SIZE];
+    rt_size_t chunk;
+
+    *crc = 0;
+    addr += REC_HDR_SIZE;
+    while (len)
+    {
+        chunk = len > sizeof(buf) ? sizeof(buf) : len;
+        if (_kv_read(kv, addr, buf, chunk) != RT_EOK)
+            return -RT_EIO;
+
+        *crc = _kv_crc32(*crc, buf, chunk);
+        addr += chunk;
+        len -= chunk;
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t _kv_erase(rt_mtd_kv_t kv, rt_uint16_t sector)
+{
+    struct rt_mtd_kv_sector *s = &kv->sectors[sector];
+    struct mtd_kv_sector_hdr hdr;
+    rt_err_t result;
+
+    result = rt_mtd_nor_erase_block(kv->mtd, _kv_addr(kv, sector, 0), kv->sector_size);
+    if (result != RT_EOK)
+    {
+        LOG_E("erase block %d failed (%d)", sector, result);
+        return result;
+    }
+    kv->erase_num ++;
+
+    s->erase_count ++;
+    s->seq = MTD_KV_SEQ_FREE;
+    s->used = SECTOR_HDR_SIZE;
+    s->live = 0;
+
+    hdr.magic = MTD_KV_SECTOR_MAGIC;
+    hdr.erase_count = s->erase_count;
+    hdr.seq = MTD_KV_SEQ_FREE;
+    hdr.reserved = 0xFFFFFFFF;
+
+    return _kv_prog(kv, _kv_addr(kv, sector, 0), &hdr, sizeof(hdr));
+}
+
+/* open the free block with the least erase count as new head */
+static rt_err_t _kv_open_head(rt_mtd_kv_t kv)
+{
+    rt_uint16_t i, sector = MTD_KV_NIL;
+    rt_uint32_t seq, offset;
+
+    for (i = 0; i < kv->sector_num; i ++)
+    {
+        if (kv->sectors[i].seq != MTD_KV_SEQ_FREE)
+            continue;
+
+        if (sector == MTD_KV_NIL || kv->sectors[i].erase_count < kv->sectors[sector].erase_count)
+            sector = i;
+    }
+
+    if (sector == MTD_KV_NIL)
+        return -RT_EFULL;
+
+    seq = kv->seq;
+    offset = (rt_uint32_t)&((struct mtd_kv_sector_hdr *)0)->seq;
+    if (_kv_prog(kv, _kv_addr(kv, sector, offset), &seq, sizeof(seq)) != RT_EOK)
+        return -RT_EIO;
+
+    kv->seq ++;
+    kv->sectors[sector].seq = seq;
+    kv->sectors[sector].used = SECTOR_HDR_SIZE;
+    kv->free_num --;
+    if (kv->free_num == kv->sector_num - 1)
+    {
+        /* the first block in use */
+        kv->tail = sector;
+        kv->gc_off = SECTOR_HDR_SIZE;
+    }
+    kv->head = sector;
+
+    return RT_EOK;
+}
+
+/* find the in use block with the minimum sequence */
+static rt_uint16_t _kv_oldest(rt_mtd_kv_t kv)
+{
+    rt_uint16_t i, sector = MTD_KV_NIL;
+
+    for (i = 0; i < kv->sector_num; i ++)
+    {
+        if (kv->sectors[i].seq == MTD_KV_SEQ_FREE)
+            continue;
+
+        if (sector == MTD_KV_NIL || kv->sectors[i].seq < kv->sectors[sector].seq)
+            sector = i;
+    }
+
+    return sector;
+}
+
+/*
+ * RAM hash index
+ */
+static rt_uint16_t _kv_index_find(rt_mtd_kv_t kv, const char *key, rt_size_t klen, rt_uint32_t hash,
+                                  rt_uint16_t **ref)
+{
+    char buf[RT_MTD_KV_KEY_MAX];
+    struct mtd_kv_rec_hdr hdr;
+    struct rt_mtd_kv_node *node;
+    rt_uint16_t *link;
+
+    link = &kv->buckets[hash & kv->bucket_mask];
+    while (*link != MTD_KV_NIL)
+    {
+        node = &kv->nodes[*link];
+        if (node->hash == hash)
+        {
+            /* check the key on the flash, the hash may be collided */
+            if (_kv_read(kv, node->addr, &hdr, REC_HDR_SIZE) == RT_EOK && hdr.key_len == klen &&
+                    _kv_read(kv, node->addr + REC_HDR_SIZE, buf, klen) == RT_EOK &&
+                    rt_memcmp(buf, key, klen) == 0)
+            {
+                if (ref) *ref = link;
+                return *link;
+            }
+        }
+        link = &node->next;
+    }
+
+    return MTD_KV_NIL;
+}
+
+static rt_err_t _kv_index_set(rt_mtd_kv_t kv, const char *key, rt_size_t klen, rt_uint32_t hash,
+                              rt_uint32_t addr, rt_uint16_t size)
+{
+    struct rt_mtd_kv_node *node;
+    rt_uint16_t index;
+
+    index = _kv_index_find(kv, key, klen, hash, RT_NULL);
+    if (index != MTD_KV_NIL)
+    {
+        node = &kv->nodes[index];
+        kv->sectors[_kv_sector_of(kv, node->addr)].live -= node->size;
+    }
+    else
+    {
+        if (kv->node_free == MTD_KV_NIL)
+            return -RT_EFULL;
+
+        index = kv->node_free;
+        node = &kv->nodes[index];
+        kv->node_free = node->next;
+        node->hash = hash;
+        node->next = kv->buckets[hash & kv->bucket_mask];
+        kv->buckets[hash & kv->bucket_mask] = index;
+        kv->key_num ++;
+    }
+
+    node->addr = addr;
+    node->size = size;
+    kv->sectors[_kv_sector_of(kv, addr)].live += size;
+
+    return RT_EOK;
+}
+
+static void _kv_index_del(rt_mtd_kv_t kv, const char *key, rt_size_t klen, rt_uint32_t hash)
+{
+    struct rt_mtd_kv_node *node;
+    rt_uint16_t index, *link;
+
+    index = _kv_index_find(kv, key, klen, hash, &link);
+    if (index == MTD_KV_NIL)
+        return;
+
+    node = &kv->nodes[index];
+    kv->sectors[_kv_sector_of(kv, node->addr)].live -= node->size;
+    *link = node->next;
+    node->next = kv->node_free;
+    kv->node_free = index;
+    kv->key_num --;
+}
+
+static void _kv_index_reset(rt_mtd_kv_t kv)
+{
+    rt_uint16_t i;
+
+    for (i = 0; i <= kv->bucket_mask; i ++)
+        kv->buckets[i] = MTD_KV_NIL;
+
+    for (i = 0; i < kv->node_max; i ++)
+        kv->nodes[i].next = (i + 1 < kv->node_max) ? i + 1 : MTD_KV_NIL;
+
+    kv->node_free = 0;
+    kv->key_num = 0;
+}
+
+/* the record which is in the index, only it's moved by the collector */
+static rt_bool_t _kv_is_live(rt_mtd_kv_t kv, rt_uint32_t addr, const struct mtd_kv_rec_hdr *hdr)
+{
+    char key[RT_MTD_KV_KEY_MAX];
+    rt_uint16_t index;
+
+    if (hdr->type != MTD_KV_REC_SET)
+        return RT_FALSE;
+
+    if (_kv_read(kv, addr + REC_HDR_SIZE, key, hdr->key_len) != RT_EOK)
+        return RT_FALSE;
+
+    index = _kv_index_find(kv, key, hdr->key_len, _kv_hash(key, hdr->key_len), RT_NULL);
+
+    return (index != MTD_KV_NIL && kv->nodes[index].addr == addr);
+}
+
+/*
+ * Log append. The last free block is reserved for the collector (reserve is RT_FALSE for
+ * updates), so the collector is always able to move the live records out of the tail.
+ */
+static rt_err_t _kv_alloc(rt_mtd_kv_t kv, rt_uint32_t size, rt_bool_t reserve, rt_uint32_t *addr)
+{
+    rt_err_t result;
+
+    if (kv->sectors[kv->head].used + size > kv->sector_size)
+    {
+        if (kv->free_num == 0 || (reserve == RT_FALSE && kv->free_num < 2))
+            return -RT_EFULL;
+
+        result = _kv_open_head(kv);
+        if (result != RT_EOK)
+            return result;
+    }
+
+    *addr = _kv_addr(kv, kv->head, kv->sectors[kv->head].used);
+    kv->sectors[kv->head].used += size;
+
+    return RT_EOK;
+}
+
+static rt_err_t _kv_append(rt_mtd_kv_t kv, rt_uint8_t type, rt_uint16_t txn, const char *key, rt_size_t klen,
+                           const void *value, rt_size_t vlen, rt_bool_t reserve, rt_uint32_t *addr)
+{
+    struct mtd_kv_rec_hdr hdr;
+    rt_err_t result;
+
+    result = _kv_alloc(kv, REC_SIZE(klen, vlen), reserve, addr);
+    if (result != RT_EOK)
+        return result;
+
+    hdr.magic = MTD_KV_REC_MAGIC;
+    hdr.type = type;
+    hdr.key_len = klen;
+    hdr.val_len = vlen;
+    hdr.txn = txn;
+    hdr.sum = _kv_hdr_sum(&hdr);
+    hdr.crc = _kv_crc32(_kv_crc32(0, key, klen), value, vlen);
+
+    /* payload first, the header makes the record valid */
+    if (_kv_prog(kv, *addr + REC_HDR_SIZE, key, klen) != RT_EOK ||
+            _kv_prog(kv, *addr + REC_HDR_SIZE + klen, value, vlen) != RT_EOK ||
+            _kv_prog(kv, *addr, &hdr, REC_HDR_SIZE) != RT_EOK)
+    {
+        return -RT_EIO;
+    }
+
+    return RT_EOK;
+}
+
+/* move one live record from the tail to the head */
+static rt_err_t _kv_move(rt_mtd_kv_t kv, rt_uint32_t from, struct mtd_kv_rec_hdr *hdr)
+{
+    rt_uint8_t buf[MTD_KV_COPY_SIZE];
+    char key[RT_MTD_KV_KEY_MAX];
+    rt_uint32_t to, offset, len, chunk;
+    rt_uint16_t index;
+    rt_err_t result;
+
+    len = hdr->key_len + hdr->val_len;
+    result = _kv_alloc(kv, REC_SIZE(hdr->key_len, hdr->val_len), RT_TRUE, &to);
+    if (result != RT_EOK)
+        return result;
+
+    for (offset = 0; offset < len; offset += chunk)
+    {
+        chunk = len - offset > sizeof(buf) ? sizeof(buf) : len - offset;
+        if (_kv_read(kv, from + REC_HDR_SIZE + offset, buf, chunk) != RT_EOK ||
+                _kv_prog(kv, to + REC_HDR_SIZE + offset, buf, chunk) != RT_EOK)
+            return -RT_EIO;
+    }
+
+    /* the moved record is out of transaction, the crc of payload is kept */
+    hdr->txn = 0;
+    hdr->sum = _kv_hdr_sum(hdr);
+    if (_kv_prog(kv, to, hdr, REC_HDR_SIZE) != RT_EOK)
+        return -RT_EIO;
+
+    /* the key was read in the live check, read it again to relink the node */
+    if (_kv_read(kv, to + REC_HDR_SIZE, key, hdr->key_len) != RT_EOK)
+        return -RT_EIO;
+    index = _kv_index_find(kv, key, hdr->key_len, _kv_hash(key, hdr->key_len), RT_NULL);
+    if (index != MTD_KV_NIL)
+    {
+        kv->sectors[_kv_sector_of(kv, from)].live -= kv->nodes[index].size;
+        kv->nodes[index].addr = to;
+        kv->sectors[_kv_sector_of(kv, to)].live += kv->nodes[index].size;
+    }
+    kv->gc_moved ++;
+
+    return RT_EOK;
+}
+
+/* one step of the collector: move one record or erase the finished tail */
+static rt_err_t _kv_gc_step(rt_mtd_kv_t kv)
+{
+    struct rt_mtd_kv_sector *tail;
+    struct mtd_kv_rec_hdr hdr;
+    rt_uint32_t addr;
+    rt_uint16_t sector;
+    rt_err_t result;
+
+    if (kv->free_num >= kv->sector_num - 1 || kv->tail == kv->head)
+        return -RT_EEMPTY;
+
+    tail = &kv->sectors[kv->tail];
+    if (tail->live && kv->gc_off < tail->used)
+    {
+        addr = _kv_addr(kv, kv->tail, kv->gc_off);
+        result = _kv_read_rec(kv, addr, &hdr);
+        if (result == RT_EOK)
+        {
+            kv->gc_off += REC_SIZE(hdr.key_len, hdr.val_len);
+            if (_kv_is_live(kv, addr, &hdr))
+                return _kv_move(kv, addr, &hdr);
+
+            return RT_EOK;
+        }
+        if (result == -RT_EIO)
+            return result;
+
+        /* the end of block */
+        kv->gc_off = tail->used;
+        return RT_EOK;
+    }
+
+    /* all the live records are moved, recycle the block */
+    sector = kv->tail;
+    kv->sectors[sector].seq = MTD_KV_SEQ_FREE;
+    kv->free_num ++;
+    kv->tail = _kv_oldest(kv);
+    kv->gc_off = SECTOR_HDR_SIZE;
+
+    return _kv_erase(kv, sector);
+}
+
+/* the update can be appended without the reserved block */
+static rt_bool_t _kv_fits(rt_mtd_kv_t kv, rt_uint32_t size, rt_uint32_t max)
+{
+    rt_uint32_t usable = kv->sector_size - SECTOR_HDR_SIZE;
+    rt_uint32_t room = kv->sector_size - kv->sectors[kv->head].used;
+
+    if (size <= room)
+        return RT_TRUE;
+
+    if (kv->free_num < 2)
+        return RT_FALSE;
+
+    /* every switch of block wastes the tail which is shorter than the largest record */
+    room += (kv->free_num - 1) * usable;
+    return room >= size + max * (size / usable + 1);
+}
+
+/* make sure there is room for the update, run the collector incrementally */
+static rt_err_t _kv_reserve(rt_mtd_kv_t kv, rt_uint32_t size, rt_uint32_t max)
+{
+    rt_uint32_t step, live = 0, recycle = 0;
+    rt_uint16_t free_num;
+
+    for (step = 0; step < kv->sector_num; step ++)
+        live += kv->sectors[step].live;
+    if (live + size > (kv->sector_num - 2) * (kv->sector_size - SECTOR_HDR_SIZE))
+        return -RT_EFULL;
+
+    /* incremental collection when the free blocks are under the watermark */
+    if (kv->free_num < RT_MTD_KV_GC_WATERMARK)
+    {
+        for (step = 0; step < RT_MTD_KV_GC_STEP; step ++)
+        {
+            if (_kv_gc_step(kv) != RT_EOK)
+                break;
+        }
+    }
+
+    /* forced collection until the update fits in */
+    while (!_kv_fits(kv, size, max))
+    {
+        free_num = kv->free_num;
+        if (_kv_gc_step(kv) != RT_EOK)
+            return -RT_EFULL;
+
+        /* all the blocks are recycled once, the log is full of live records */
+        if (kv->free_num > free_num && ++recycle > kv->sector_num)
+            return -RT_EFULL;
+    }
+
+    return RT_EOK;
+}
+
+/*
+ * startup
+ */
+struct kv_pending
+{
+    rt_uint32_t addr;
+    rt_uint16_t size;
+    rt_uint8_t  type;
+};
+
+static rt_err_t _kv_apply(rt_mtd_kv_t kv, rt_uint32_t addr, const struct mtd_kv_rec_hdr *hdr)
+{
+    char key[RT_MTD_KV_KEY_MAX];
+    rt_uint32_t hash;
+
+    if (_kv_read(kv, addr + REC_HDR_SIZE, key, hdr->key_len) != RT_EOK)
+        return -RT_EIO;
+
+    hash = _kv_hash(key, hdr->key_len);
+    if (hdr->type == MTD_KV_REC_SET)
+        return _kv_index_set(kv, key, hdr->key_len, hash, addr, REC_SIZE(hdr->key_len, hdr->val_len));
+
+    _kv_index_del(kv, key, hdr->key_len, hash);
+    return RT_EOK;
+}
+
+/* scan the records of a block, returns the address of last valid record */
+static rt_err_t _kv_scan_sector(rt_mtd_kv_t kv, rt_uint16_t sector, rt_bool_t build,
+                                struct kv_pending *pending, rt_uint8_t *pending_num, rt_uint16_t *pending_txn,
+                                rt_uint32_t *last)
+{
+    struct rt_mtd_kv_sector *s = &kv->sectors[sector];
+    struct mtd_kv_rec_hdr hdr;
+    rt_uint8_t buf[MTD_KV_COPY_SIZE];
+    rt_uint32_t offset, addr, crc, i;
+    rt_err_t result;
+
+    *last = 0;
+    for (offset = SECTOR_HDR_SIZE; offset + REC_HDR_SIZE <= kv->sector_size;)
+    {
+        addr = _kv_addr(kv, sector, offset);
+        result = _kv_read_rec(kv, addr, &hdr);
+        if (result == -RT_EIO)
+            return result;
+
+        if (result == -RT_EEMPTY)
+        {
+            /* a record may be torn before its header is programmed, don't append on it */
+            for (i = offset + REC_HDR_SIZE; i < kv->sector_size; i += MTD_KV_COPY_SIZE)
+            {
+                rt_uint32_t chunk = kv->sector_size - i > MTD_KV_COPY_SIZE ? MTD_KV_COPY_SIZE : kv->sector_size - i;
+
+                if (_kv_read(kv, _kv_addr(kv, sector, i), buf, chunk) != RT_EOK)
+                    return -RT_EIO;
+                if (!_kv_is_blank(buf, chunk))
+                {
+                    LOG_W("block %d is sealed at offset %d", sector, offset);
+                    offset = kv->sector_size;
+                    break;
+                }
+            }
+            break;
+        }
+
+        if (result != RT_EOK)
+        {
+            LOG_W("bad record in block %d at offset %d", sector, offset);
+            offset = kv->sector_size;
+            break;
+        }
+        offset += REC_SIZE(hdr.key_len, hdr.val_len);
+
+        if (_kv_rec_crc(kv, addr, hdr.key_len + hdr.val_len, &crc) != RT_EOK)
+            return -RT_EIO;
+        if (crc != hdr.crc)
+        {
+            LOG_W("broken record in block %d at offset %d", sector, offset);
+            continue;
+        }
+        *last = addr;
+
+        if (hdr.txn && (rt_int16_t)(hdr.txn - kv->txn) > 0)
+            kv->txn = hdr.txn;
+
+        if (!build || hdr.type == MTD_KV_REC_CKPT)
+            continue;
+
+        if (hdr.type == MTD_KV_REC_COMMIT)
+        {
+            if (hdr.txn == *pending_txn)
+            {
+                for (i = 0; i < *pending_num; i ++)
+                {
+                    struct mtd_kv_rec_hdr phdr;
+
+                    if (_kv_read(kv, pending[i].addr, &phdr, REC_HDR_SIZE) != RT_EOK)
+                        return -RT_EIO;
+                    result = _kv_apply(kv, pending[i].addr, &phdr);
+                    if (result != RT_EOK)
+                        return result;
+                }
+            }
+            *pending_num = 0;
+            continue;
+        }
+
+        if (hdr.txn)
+        {
+            /* the records of an unfinished transaction are dropped */
+            if (hdr.txn != *pending_txn)
+            {
+                *pending_num = 0;
+                *pending_txn = hdr.txn;
+            }
+            if (*pending_num < RT_MTD_KV_TXN_MAX)
+            {
+                pending[*pending_num].addr = addr;
+                pending[*pending_num].size = REC_SIZE(hdr.key_len, hdr.val_len);
+                pending[*pending_num].type = hdr.type;
+                (*pending_num) ++;
+            }
+            continue;
+        }
+
+        *pending_num = 0;
+        result = _kv_apply(kv, addr, &hdr);
+        if (result != RT_EOK)
+            return result;
+    }
+
+    s->used = offset > kv->sector_size ? kv->sector_size : offset;
+
+    return RT_EOK;
+}
+
+/* load the index from the checkpoint if it's the last record of the log */
+static rt_err_t _kv_load_ckpt(rt_mtd_kv_t kv, rt_uint32_t addr)
+{
+    struct mtd_kv_rec_hdr hdr;
+    struct mtd_kv_ckpt_hdr ckpt;
+    struct mtd_kv_ckpt_node cnode;
+    struct rt_mtd_kv_node *node;
+    rt_uint16_t i, index, sector;
+
+    if (addr == 0 || _kv_read(kv, addr, &hdr, REC_HDR_SIZE) != RT_EOK || hdr.type != MTD_KV_REC_CKPT)
+        return -RT_ERROR;
+
+    addr += REC_HDR_SIZE;
+    if (_kv_read(kv, addr, &ckpt, sizeof(ckpt)) != RT_EOK || ckpt.key_num > kv->node_max ||
+            hdr.val_len != sizeof(ckpt) + ckpt.key_num * sizeof(cnode))
+        return -RT_ERROR;
+    addr += sizeof(ckpt);
+
+    for (i = 0; i < ckpt.key_num; i ++, addr += sizeof(cnode))
+    {
+        if (_kv_read(kv, addr, &cnode, sizeof(cnode)) != RT_EOK)
+            goto __fail;
+
+        sector = _kv_sector_of(kv, cnode.addr);
+        if (sector >= kv->sector_num || kv->sectors[sector].seq == MTD_KV_SEQ_FREE)
+            goto __fail;
+
+        index = kv->node_free;
+        node = &kv->nodes[index];
+        kv->node_free = node->next;
+        node->hash = cnode.hash;
+        node->addr = cnode.addr;
+        node->size = cnode.size;
+        node->next = kv->buckets[cnode.hash & kv->bucket_mask];
+        kv->buckets[cnode.hash & kv->bucket_mask] = index;
+        kv->sectors[sector].live += cnode.size;
+        kv->key_num ++;
+    }
+    kv->txn = ckpt.txn;
+
+    return RT_EOK;
+
+__fail:
+    _kv_index_reset(kv);
+    for (i = 0; i < kv->sector_num; i ++)
+        kv->sectors[i].live = 0;
+
+    return -RT_ERROR;
+}
+
+static rt_err_t _kv_mount(rt_mtd_kv_t kv)
+{
+    struct mtd_kv_sector_hdr hdr;
+    struct kv_pending pending[RT_MTD_KV_TXN_MAX];
+    rt_uint8_t pending_num = 0;
+    rt_uint16_t pending_txn = 0, i, sector;
+    rt_uint32_t erase_sum = 0, erase_num = 0, last, prev_seq;
+    rt_bool_t formatted = RT_FALSE;
+    rt_err_t result;
+
+    kv->free_num = 0;
+    kv->seq = 0;
+    kv->txn = 0;
+    for (i = 0; i < kv->sector_num; i ++)
+    {
+        struct rt_mtd_kv_sector *s = &kv->sectors[i];
+
+        if (_kv_read(kv, _kv_addr(kv, i, 0), &hdr, sizeof(hdr)) != RT_EOK)
+            return -RT_EIO;
+
+        s->live = 0;
+        s->used = kv->sector_size;
+        if (hdr.magic == MTD_KV_SECTOR_MAGIC)
+        {
+            formatted = RT_TRUE;
+            s->erase_count = hdr.erase_count;
+            s->seq = hdr.seq;
+            erase_sum += hdr.erase_count;
+            erase_num ++;
+        }
+        else
+        {
+            /* unknown erase count, it's estimated after all the blocks are read */
+            s->erase_count = MTD_KV_SEQ_FREE;
+            s->seq = MTD_KV_SEQ_FREE;
+        }
+
+        if (s->seq == MTD_KV_SEQ_FREE)
+            kv->free_num ++;
+        else if (s->seq + 1 > kv->seq)
+            kv->seq = s->seq + 1;
+    }
+
+    if (!formatted)
+        LOG_I("format the MTD device %s", kv->mtd->parent.parent.name);
+
+    /* prepare the free blocks */
+    for (i = 0; i < kv->sector_num; i ++)
+    {
+        struct rt_mtd_kv_sector *s = &kv->sectors[i];
+
+        if (s->erase_count == MTD_KV_SEQ_FREE)
+        {
+            s->erase_count = erase_num ? erase_sum / erase_num : 0;
+            result = _kv_erase(kv, i);
+            if (result != RT_EOK)
+                return result;
+        }
+        else if (s->seq == MTD_KV_SEQ_FREE)
+        {
+            /* the free block may be programmed before crash, check it's blank */
+            rt_uint8_t buf[MTD_KV_COPY_SIZE];
+            rt_uint32_t offset, chunk;
+
+            s->used = SECTOR_HDR_SIZE;
+            for (offset = SECTOR_HDR_SIZE; offset < kv->sector_size; offset += chunk)
+            {
+                chunk = kv->sector_size - offset > sizeof(buf) ? sizeof(buf) : kv->sector_size - offset;
+                if (_kv_read(kv, _kv_addr(kv, i, offset), buf, chunk) != RT_EOK)
+                    return -RT_EIO;
+                if (!_kv_is_blank(buf, chunk))
+                {
+                    result = _kv_erase(kv, i);
+                    if (result != RT_EOK)
+                        return result;
+                    break;
+                }
+            }
+        }
+    }
+
+    kv->tail = _kv_oldest(kv);
+    kv->gc_off = SECTOR_HDR_SIZE;
+    if (kv->tail == MTD_KV_NIL)
+    {
+        kv->tail = 0;
+        kv->head = 0;
+        return _kv_open_head(kv);
+    }
+
+    /* the head is the newest block */
+    kv->head = kv->tail;
+    for (i = 0; i < kv->sector_num; i ++)
+    {
+        if (kv->sectors[i].seq != MTD_KV_SEQ_FREE && kv->sectors[i].seq > kv->sectors[kv->head].seq)
+            kv->head = i;
+    }
+
+    /* fast path: the checkpoint is the last record */
+    result = _kv_scan_sector(kv, kv->head, RT_FALSE, pending, &pending_num, &pending_txn, &last);
+    if (result != RT_EOK)
+        return result;
+    if (_kv_load_ckpt(kv, last) == RT_EOK)
+    {
+        LOG_D("index is loaded from checkpoint, %d keys", kv->key_num);
+        return RT_EOK;
+    }
+
+    /* replay the whole log in the order of block sequence */
+    kv->txn = 0;
+    sector = kv->tail;
+    while (sector != MTD_KV_NIL)
+    {
+        result = _kv_scan_sector(kv, sector, RT_TRUE, pending, &pending_num, &pending_txn, &last);
+        if (result != RT_EOK)
+            return result;
+
+        prev_seq = kv->sectors[sector].seq;
+        sector = MTD_KV_NIL;
+        for (i = 0; i < kv->sector_num; i ++)
+        {
+            if (kv->sectors[i].seq == MTD_KV_SEQ_FREE || kv->sectors[i].seq <= prev_seq)
+                continue;
+            if (sector == MTD_KV_NIL || kv->sectors[i].seq < kv->sectors[sector].seq)
+                sector = i;
+        }
+    }
+    LOG_D("index is rebuilt from log, %d keys", kv->key_num);
+
+    return RT_EOK;
+}
+
+/**
+ * This function will initialize the key-value storage on a MTD NOR device, the index is
+ * loaded from the checkpoint or rebuilt by scanning the log.
+ *
+ * @param kv the key-value storage object
+ * @param mtd the MTD NOR device, at least 3 erase blocks
+ * @param max_keys the maximum number of keys, it decides the RAM size of index
+ *
+ * @return RT_EOK on successful, otherwise the error code
+ */
+rt_err_t rt_mtd_kv_init(rt_mtd_kv_t kv, struct rt_mtd_nor_device *mtd, rt_uint16_t max_keys)
+{
+    rt_uint16_t bucket_num;
+    rt_err_t result;
+
+    RT_ASSERT(kv);
+    RT_ASSERT(mtd);
+    RT_ASSERT(max_keys > 0 && max_keys < MTD_KV_NIL);
+
+    rt_memset(kv, 0, sizeof(struct rt_mtd_kv));
+    kv->mtd = mtd;
+    kv->sector_size = mtd->block_size;
+    kv->sector_num = mtd->block_end - mtd->block_start;
+    if (kv->sector_num < 3 || kv->sector_size < SECTOR_HDR_SIZE + REC_SIZE(RT_MTD_KV_KEY_MAX, 0))
+    {
+        LOG_E("MTD device is too small for key-value storage");
+        return -RT_EINVAL;
+    }
+
+    for (bucket_num = 8; bucket_num < max_keys / 2 && bucket_num < 0x8000; bucket_num <<= 1);
+    kv->bucket_mask = bucket_num - 1;
+    kv->node_max = max_keys;
+
+    kv->sectors = (struct rt_mtd_kv_sector *)rt_malloc(sizeof(struct rt_mtd_kv_sector) * kv->sector_num);
+    kv->nodes = (struct rt_mtd_kv_node *)rt_malloc(sizeof(struct rt_mtd_kv_node) * max_keys);
+    kv->buckets = (rt_uint16_t *)rt_malloc(sizeof(rt_uint16_t) * bucket_num);
+    if (kv->sectors == RT_NULL || kv->nodes == RT_NULL || kv->buckets == RT_NULL)
+    {
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+    _kv_index_reset(kv);
+
+    result = _kv_mount(kv);
+    if (result != RT_EOK)
+    {
+        LOG_E("mount key-value storage failed (%d)", result);
+        goto __exit;
+    }
+    rt_mutex_init(&kv->lock, "mtdkv", RT_IPC_FLAG_FIFO);
+
+    return RT_EOK;
+
+__exit:
+    rt_free(kv->sectors);
+    rt_free(kv->nodes);
+    rt_free(kv->buckets);
+    kv->sectors = RT_NULL;
+    kv->nodes = RT_NULL;
+    kv->buckets = RT_NULL;
+
+    return result;
+}
+RTM_EXPORT(rt_mtd_kv_init);
+
+/**
+ * This function will write the checkpoint and release the key-value storage.
+ *
+ * @param kv the key-value storage object
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_mtd_kv_deinit(rt_mtd_kv_t kv)
+{
+    RT_ASSERT(kv);
+
+    rt_mtd_kv_checkpoint(kv);
+
+    rt_mutex_detach(&kv->lock);
+    rt_free(kv->sectors);
+    rt_free(kv->nodes);
+    rt_free(kv->buckets);
+    kv->sectors = RT_NULL;
+    kv->nodes = RT_NULL;
+    kv->buckets = RT_NULL;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mtd_kv_deinit);
+
+/**
+ * This function will erase all the keys.
+ *
+ * @param kv the key-value storage object
+ *
+ * @return RT_EOK on successful, otherwise the error code
+ */
+rt_err_t rt_mtd_kv_format(rt_mtd_kv_t kv)
+{
+    rt_uint16_t i;
+    rt_err_t result = RT_EOK;
+
+    RT_ASSERT(kv);
+
+    rt_mutex_take(&kv->lock, RT_WAITING_FOREVER);
+    _kv_index_reset(kv);
+    for (i = 0; i < kv->sector_num && result == RT_EOK; i ++)
+        result = _kv_erase(kv, i);
+
+    if (result == RT_EOK)
+    {
+        kv->free_num = kv->sector_num;
+        kv->seq = 0;
+        kv->txn = 0;
+        result = _kv_open_head(kv);
+    }
+    rt_mutex_release(&kv->lock);
+
+    return result;
+}
+RTM_EXPORT(rt_mtd_kv_format);
+
+/**
+ * This function will read the value of a key.
+ *
+ * @param kv the key-value storage object
+ * @param key the key string
+ * @param buf the buffer to save value
+ * @param size the buffer size, the value is truncated if it's longer
+ *
+ * @return the value length, -RT_EEMPTY when the key is not found
+ */
+int rt_mtd_kv_get(rt_mtd_kv_t kv, const char *key, void *buf, rt_size_t size)
+{
+    struct mtd_kv_rec_hdr hdr;
+    rt_size_t klen;
+    rt_uint16_t index;
+    int result;
+
+    RT_ASSERT(kv);
+    RT_ASSERT(key);
+
+    klen = rt_strlen(key);
+    if (klen == 0 || klen > RT_MTD_KV_KEY_MAX)
+        return -RT_EINVAL;
+
+    rt_mutex_take(&kv->lock, RT_WAITING_FOREVER);
+    index = _kv_index_find(kv, key, klen, _kv_hash(key, klen), RT_NULL);
+    if (index == MTD_KV_NIL)
+    {
+        result = -RT_EEMPTY;
+    }
+    else if (_kv_read(kv, kv->nodes[index].addr, &hdr, REC_HDR_SIZE) != RT_EOK)
+    {
+        result = -RT_EIO;
+    }
+    else
+    {
+        if (size > hdr.val_len)
+            size = hdr.val_len;
+
+        result = hdr.val_len;
+        if (size && _kv_read(kv, kv->nodes[index].addr + REC_HDR_SIZE + klen, buf, size) != RT_EOK)
+            result = -RT_EIO;
+    }
+    rt_mutex_release(&kv->lock);
+
+    return result;
+}
+RTM_EXPORT(rt_mtd_kv_get);
+
+static rt_err_t _kv_check(rt_mtd_kv_t kv, const char *key, rt_size_t len)
+{
+    rt_size_t klen = rt_strlen(key);
+
+    if (klen == 0 || klen > RT_MTD_KV_KEY_MAX || len > 0xFFFF ||
+            REC_SIZE(klen, len) > kv->sector_size - SECTOR_HDR_SIZE)
+        return -RT_EINVAL;
+
+    return RT_EOK;
+}
+
+/**
+ * This function will set the value of a key.
+ *
+ * @param kv the key-value storage object
+ * @param key the key string, RT_MTD_KV_KEY_MAX characters at most
+ * @param value the value
+ * @param len the value length
+ *
+ * @return RT_EOK on successful, -RT_EFULL when the storage is full,
+ *         -RT_EINVAL when the key or value is too long
+ */
+rt_err_t rt_mtd_kv_set(rt_mtd_kv_t kv, const char *key, const void *value, rt_size_t len)
+{
+    struct rt_mtd_kv_txn txn;
+    rt_err_t result;
+
+    rt_mtd_kv_txn_begin(kv, &txn);
+    result = rt_mtd_kv_txn_set(&txn, key, value, len);
+    if (result != RT_EOK)
+        return result;
+
+    return rt_mtd_kv_txn_commit(&txn);
+}
+RTM_EXPORT(rt_mtd_kv_set);
+
+/**
+ * This function will delete a key.
+ *
+ * @param kv the key-value storage object
+ * @param key the key string
+ *
+ * @return RT_EOK on successful, -RT_EEMPTY when the key is not found,
+ *         -RT_EINVAL when the key is too long
+ */
+rt_err_t rt_mtd_kv_del(rt_mtd_kv_t kv, const char *key)
+{
+    struct rt_mtd_kv_txn txn;
+    rt_err_t result;
+
+    rt_mtd_kv_txn_begin(kv, &txn);
+    result = rt_mtd_kv_txn_del(&txn, key);
+    if (result != RT_EOK)
+        return result;
+
+    return rt_mtd_kv_txn_commit(&txn);
+}
+RTM_EXPORT(rt_mtd_kv_del);
+
+/**
+ * This function will start a transaction, the updates in the transaction are applied
+ * all or none of them.
+ *
+ * @param kv the key-value storage object
+ * @param txn the transaction object
+ */
+void rt_mtd_kv_txn_begin(rt_mtd_kv_t kv, struct rt_mtd_kv_txn *txn)
+{
+    RT_ASSERT(kv);
+    RT_ASSERT(txn);
+
+    txn->kv = kv;
+    txn->num = 0;
+}
+RTM_EXPORT(rt_mtd_kv_txn_begin);
+
+/**
+ * This function will add a key update into the transaction.
+ *
+ * @note The key and value are referenced until the transaction is committed.
+ *
+ * @param txn the transaction object
+ * @param key the key string
+ * @param value the value
+ * @param len the value length
+ *
+ * @return RT_EOK on successful, -RT_EFULL when the transaction is full,
+ *         -RT_EINVAL when the key or value is too long
+ */
+rt_err_t rt_mtd_kv_txn_set(struct rt_mtd_kv_txn *txn, const char *key, const void *value, rt_size_t len)
+{
+    RT_ASSERT(txn);
+    RT_ASSERT(key);
+    RT_ASSERT(value || len == 0);
+
+    if (txn->num >= RT_MTD_KV_TXN_MAX)
+        return -RT_EFULL;
+
+    if (_kv_check(txn->kv, key, len) != RT_EOK)
+        return -RT_EINVAL;
+
+    txn->ops[txn->num].key = key;
+    txn->ops[txn->num].value = value ? value : (const void *)"";
+    txn->ops[txn->num].len = len;
+    txn->num ++;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mtd_kv_txn_set);
+
+/**
+ * This function will add a key delete into the transaction.
+ *
+ * @param txn the transaction object
+ * @param key the key string
+ *
+ * @return RT_EOK on successful, -RT_EFULL when the transaction is full,
+ *         -RT_EINVAL when the key is too long
+ */
+rt_err_t rt_mtd_kv_txn_del(struct rt_mtd_kv_txn *txn, const char *key)
+{
+    RT_ASSERT(txn);
+    RT_ASSERT(key);
+
+    if (txn->num >= RT_MTD_KV_TXN_MAX)
+        return -RT_EFULL;
+
+    if (_kv_check(txn->kv, key, 0) != RT_EOK)
+        return -RT_EINVAL;
+
+    txn->ops[txn->num].key = key;
+    txn->ops[txn->num].value = RT_NULL;
+    txn->ops[txn->num].len = 0;
+    txn->num ++;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mtd_kv_txn_del);
+
+/**
+ * This function will commit the transaction. A single update is written as one record,
+ * multiple updates are followed by a commit record which makes them valid together.
+ *
+ * @param txn the transaction object
+ *
+ * @return RT_EOK on successful, otherwise the error code and none of updates is applied
+ */
+rt_err_t rt_mtd_kv_txn_commit(struct rt_mtd_kv_txn *txn)
+{
+    rt_mtd_kv_t kv;
+    rt_uint32_t addr[RT_MTD_KV_TXN_MAX], commit, size = 0, max = 0, klen, hash;
+    rt_uint16_t id = 0, new_keys = 0;
+    rt_uint8_t i;
+    rt_err_t result = RT_EOK;
+
+    RT_ASSERT(txn);
+    kv = txn->kv;
+
+    if (txn->num == 0)
+        return RT_EOK;
+
+    for (i = 0; i < txn->num; i ++)
+    {
+        result = _kv_check(kv, txn->ops[i].key, txn->ops[i].len);
+        if (result != RT_EOK)
+            return result;
+
+        klen = REC_SIZE(rt_strlen(txn->ops[i].key), txn->ops[i].len);
+        size += klen;
+        if (klen > max)
+            max = klen;
+    }
+    if (txn->num > 1)
+        size += REC_SIZE(0, 0);
+
+    rt_mutex_take(&kv->lock, RT_WAITING_FOREVER);
+
+    for (i = 0; i < txn->num; i ++)
+    {
+        klen = rt_strlen(txn->ops[i].key);
+        hash = _kv_hash(txn->ops[i].key, klen);
+        if (_kv_index_find(kv, txn->ops[i].key, klen, hash, RT_NULL) == MTD_KV_NIL)
+        {
+            if (txn->ops[i].value == RT_NULL && txn->num == 1)
+            {
+                result = -RT_EEMPTY;
+                goto __exit;
+            }
+            if (txn->ops[i].value)
+                new_keys ++;
+        }
+    }
+    if (kv->key_num + new_keys > kv->node_max)
+    {
+        result = -RT_EFULL;
+        goto __exit;
+    }
+
+    result = _kv_reserve(kv, size, max);
+    if (result != RT_EOK)
+        goto __exit;
+
+    if (txn->num > 1)
+    {
+        if (++kv->txn == 0)
+            kv->txn = 1;
+        id = kv->txn;
+    }
+
+    for (i = 0; i < txn->num; i ++)
+    {
+        result = _kv_append(kv, txn->ops[i].value ? MTD_KV_REC_SET : MTD_KV_REC_DEL, id,
+                            txn->ops[i].key, rt_strlen(txn->ops[i].key),
+                            txn->ops[i].value, txn->ops[i].len, RT_FALSE, &addr[i]);
+        if (result != RT_EOK)
+            goto __exit;
+    }
+    if (id)
+    {
+        result = _kv_append(kv, MTD_KV_REC_COMMIT, id, RT_NULL, 0, RT_NULL, 0, RT_FALSE, &commit);
+        if (result != RT_EOK)
+            goto __exit;
+    }
+
+    /* all the records are on the flash, update the index */
+    for (i = 0; i < txn->num; i ++)
+    {
+        klen = rt_strlen(txn->ops[i].key);
+        hash = _kv_hash(txn->ops[i].key, klen);
+        if (txn->ops[i].value)
+            _kv_index_set(kv, txn->ops[i].key, klen, hash, addr[i], REC_SIZE(klen, txn->ops[i].len));
+        else
+            _kv_index_del(kv, txn->ops[i].key, klen, hash);
+    }
+
+__exit:
+    rt_mutex_release(&kv->lock);
+    txn->num = 0;
+
+    return result;
+}
+RTM_EXPORT(rt_mtd_kv_txn_commit);
+
+/**
+ * This function will run the garbage collector, it's suggested to call it in the idle
+ * time so the updates are not delayed by the collection.
+ *
+ * @param kv the key-value storage object
+ * @param steps the maximum number of moved records and erased blocks
+ *
+ * @return RT_EOK on successful, -RT_EEMPTY when there is nothing to collect
+ */
+rt_err_t rt_mtd_kv_gc(rt_mtd_kv_t kv, rt_uint32_t steps)
+{
+    rt_err_t result = RT_EOK;
+
+    RT_ASSERT(kv);
+
+    rt_mutex_take(&kv->lock, RT_WAITING_FOREVER);
+    while (steps-- && result == RT_EOK)
+    {
+        /* keep the blocks which are mostly live */
+        if (kv->free_num >= RT_MTD_KV_GC_WATERMARK &&
+                kv->sectors[kv->tail].live > (kv->sector_size - SECTOR_HDR_SIZE) / 2)
+        {
+            result = -RT_EEMPTY;
+            break;
+        }
+        result = _kv_gc_step(kv);
+    }
+    rt_mutex_release(&kv->lock);
+
+    return result;
+}
+RTM_EXPORT(rt_mtd_kv_gc);
+
+/**
+ * This function will write the index into the log, so the next initialization doesn't
+ * need to scan the log when there is no update after the checkpoint.
+ *
+ * @param kv the key-value storage object
+ *
+ * @return RT_EOK on successful, -RT_EFULL when the index is too large
+ */
+rt_err_t rt_mtd_kv_checkpoint(rt_mtd_kv_t kv)
+{
+    struct mtd_kv_ckpt_hdr *ckpt;
+    struct mtd_kv_ckpt_node *cnode;
+    rt_uint32_t size, addr;
+    rt_uint16_t i, index;
+    rt_err_t result;
+
+    RT_ASSERT(kv);
+
+    rt_mutex_take(&kv->lock, RT_WAITING_FOREVER);
+
+    size = sizeof(struct mtd_kv_ckpt_hdr) + kv->key_num * sizeof(struct mtd_kv_ckpt_node);
+    if (size > 0xFFFF || REC_SIZE(0, size) > kv->sector_size - SECTOR_HDR_SIZE)
+    {
+        result = -RT_EFULL;
+        goto __exit;
+    }
+
+    ckpt = (struct mtd_kv_ckpt_hdr *)rt_malloc(size);
+    if (ckpt == RT_NULL)
+    {
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+    ckpt->key_num = kv->key_num;
+    ckpt->txn = kv->txn;
+    cnode = (struct mtd_kv_ckpt_node *)(ckpt + 1);
+    for (i = 0; i <= kv->bucket_mask; i ++)
+    {
+        for (index = kv->buckets[i]; index != MTD_KV_NIL; index = kv->nodes[index].next)
+        {
+            cnode->hash = kv->nodes[index].hash;
+            cnode->addr = kv->nodes[index].addr;
+            cnode->size = kv->nodes[index].size;
+            cnode ++;
+        }
+    }
+
+    result = _kv_reserve(kv, REC_SIZE(0, size), REC_SIZE(0, size));
+    if (result == RT_EOK)
+    {
+        /* the collector may move records, fill the addresses again */
+        cnode = (struct mtd_kv_ckpt_node *)(ckpt + 1);
+        for (i = 0; i <= kv->bucket_mask; i ++)
+        {
+            for (index = kv->buckets[i]; index != MTD_KV_NIL; index = kv->nodes[index].next)
+                (cnode++)->addr = kv->nodes[index].addr;
+        }
+        result = _kv_append(kv, MTD_KV_REC_CKPT, 0, RT_NULL, 0, ckpt, size, RT_FALSE, &addr);
+    }
+    rt_free(ckpt);
+
+__exit:
+    rt_mutex_release(&kv->lock);
+
+    return result;
+}
+RTM_EXPORT(rt_mtd_kv_checkpoint);
+
+/**
+ * This function will print the usage and wear of the key-value storage.
+ *
+ * @param kv the key-value storage object
+ */
+void rt_mtd_kv_dump(rt_mtd_kv_t kv)
+{
+    rt_uint32_t min = MTD_KV_SEQ_FREE, max = 0, live = 0;
+    rt_uint16_t i;
+
+    RT_ASSERT(kv);
+
+    rt_mutex_take(&kv->lock, RT_WAITING_FOREVER);
+    for (i = 0; i < kv->sector_num; i ++)
+    {
+        if (kv->sectors[i].erase_count < min) min = kv->sectors[i].erase_count;
+        if (kv->sectors[i].erase_count > max) max = kv->sectors[i].erase_count;
+        live += kv->sectors[i].live;
+    }
+
+    rt_kprintf("keys      : %d/%d\n", kv->key_num, kv->node_max);
+    rt_kprintf("blocks    : %d x %d bytes, %d free\n", kv->sector_num, kv->sector_size, kv->free_num);
+    rt_kprintf("live data : %d bytes\n", live);
+    rt_kprintf("erase     : %d times, per block %d - %d\n", kv->erase_num, min, max);
+    rt_kprintf("program   : %d bytes\n", kv->prog_bytes);
+    rt_kprintf("gc moved  : %d records\n", kv->gc_moved);
+    rt_mutex_release(&kv->lock);
+}
+RTM_EXPORT(rt_mtd_kv_dump);
+
+#endif /* RT_USING_MTD_NOR_KV */
@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-18     liujiahao    burst transfer of buffer memory, drain the received packets per interrupt
  */
 #include "enc28j60.h"
 
@@ -18,6 +19,9 @@
     #define NET_DEBUG(...)
 #endif /* #ifdef NET_TRACE */
 
+/* the maximum pbuf segments of buffer memory transferred in one SPI burst */
+#define SPI_BURST_SEGMENTS    8
+
 struct enc28j60_tx_list_typedef
 {
     struct enc28j60_tx_list_typedef *prev;
@@ -38,6 +42,10 @@ static void spi_write_op(struct rt_spi_device *spi_device, uint8_t op, uint8_t a
 
 static uint8_t spi_read(struct rt_spi_device *spi_device, uint8_t address);
 static void spi_write(struct rt_spi_device *spi_device, rt_uint8_t address, rt_uint8_t data);
+static void spi_write_word(struct rt_spi_device *spi_device, rt_uint8_t address, rt_uint16_t data);
+static void spi_read_buffer(struct rt_spi_device *spi_device, rt_uint8_t *buffer, rt_size_t length);
+static void spi_burst_buffer(struct rt_spi_device *spi_device, const rt_uint8_t *cmd, rt_size_t cmd_len,
+                             struct pbuf *p, rt_bool_t read);
 
 static void enc28j60_clkout(struct rt_spi_device *spi_device, rt_uint8_t clk);
 static void enc28j60_set_bank(struct rt_spi_device *spi_device, uint8_t address);
@@ -55,6 +63,15 @@ static struct net_device  enc28j60_dev;
 static uint8_t  Enc28j60Bank;
 //struct rt_spi_device * spi_device;
 static uint16_t NextPacketPtr;
+/* the received packets are drained with the interrupt disabled */
+static rt_bool_t rx_draining;
+static uint32_t rx_level;
+static uint32_t rx_pending;
+/* the maximum packets drained in a wakeup, the interrupt is enabled after them */
+#ifndef ENC28J60_RX_BUDGET
+#define ENC28J60_RX_BUDGET      16
+#endif
+static uint32_t rx_budget;
 
 static void _delay_us(uint32_t us)
 {
@@ -106,13 +123,27 @@ static void enc28j60_clkout(struct rt_spi_device *spi_device, rt_uint8_t clk)
 
 static void enc28j60_set_bank(struct rt_spi_device *spi_device, uint8_t address)
 {
+    uint8_t bank = address & BANK_MASK;
+
+    /* EIE, EIR, ESTAT, ECON2 and ECON1 are available in all banks. */
+    if ((address & ADDR_MASK) >= EIE)
+    {
+        return;
+    }
+
     /* set the bank (if needed) .*/
-    if ((address & BANK_MASK) != Enc28j60Bank)
+    if (bank != Enc28j60Bank)
     {
-        /* set the bank. */
-        spi_write_op(spi_device, ENC28J60_BIT_FIELD_CLR, ECON1, (ECON1_BSEL1 | ECON1_BSEL0));
-        spi_write_op(spi_device, ENC28J60_BIT_FIELD_SET, ECON1, (address & BANK_MASK) >> 5);
-        Enc28j60Bank = (address & BANK_MASK);
+        /* only change the different bits of BSEL. */
+        if (Enc28j60Bank & ~bank)
+        {
+            spi_write_op(spi_device, ENC28J60_BIT_FIELD_CLR, ECON1, (Enc28j60Bank & ~bank) >> 5);
+        }
+        if (bank & ~Enc28j60Bank)
+        {
+            spi_write_op(spi_device, ENC28J60_BIT_FIELD_SET, ECON1, (bank & ~Enc28j60Bank) >> 5);
+        }
+        Enc28j60Bank = bank;
     }
 }
 
@@ -132,6 +163,131 @@ static void spi_write(struct rt_spi_device *spi_device, rt_uint8_t address, rt_u
     spi_write_op(spi_device, ENC28J60_WRITE_CTRL_REG, address, data);
 }
 
+/* write the low and high byte of a pointer register in one SPI transfer */
+static void spi_write_word(struct rt_spi_device *spi_device, rt_uint8_t address, rt_uint16_t data)
+{
+    struct rt_spi_message message[2];
+    uint8_t buffer[4];
+
+    /* set the bank. */
+    enc28j60_set_bank(spi_device, address);
+
+    buffer[0] = ENC28J60_WRITE_CTRL_REG | (address & ADDR_MASK);
+    buffer[1] = data & 0xFF;
+    buffer[2] = ENC28J60_WRITE_CTRL_REG | ((address + 1) & ADDR_MASK);
+    buffer[3] = data >> 8;
+
+    message[0].send_buf   = &buffer[0];
+    message[0].recv_buf   = RT_NULL;
+    message[0].length     = 2;
+    message[0].cs_take    = 1;
+    message[0].cs_release = 1;
+    message[0].next       = &message[1];
+
+    message[1].send_buf   = &buffer[2];
+    message[1].recv_buf   = RT_NULL;
+    message[1].length     = 2;
+    message[1].cs_take    = 1;
+    message[1].cs_release = 1;
+    message[1].next       = RT_NULL;
+
+    rt_spi_transfer_message(spi_device, message);
+}
+
+/* read the buffer memory from the read pointer */
+static void spi_read_buffer(struct rt_spi_device *spi_device, rt_uint8_t *buffer, rt_size_t length)
+{
+    uint8_t cmd = ENC28J60_READ_BUF_MEM;
+
+    rt_spi_send_then_recv(spi_device, &cmd, 1, buffer, length);
+}
+
+/*
+ * Read or write the buffer memory of the whole pbuf chain. The chip select is
+ * held during a burst, so the segments are transferred behind one command and
+ * the SPI bus driver can use DMA for them.
+ */
+static void spi_burst_buffer(struct rt_spi_device *spi_device, const rt_uint8_t *cmd, rt_size_t cmd_len,
+                             struct pbuf *p, rt_bool_t read)
+{
+    struct rt_spi_message message[SPI_BURST_SEGMENTS + 1];
+    int count = 0;
+
+    for (; p != RT_NULL; p = p->next)
+    {
+        if (p->len == 0)
+        {
+            continue;
+        }
+
+        if (count == 0)
+        {
+            message[0].send_buf   = cmd;
+            message[0].recv_buf   = RT_NULL;
+            message[0].length     = cmd_len;
+            message[0].cs_take    = 1;
+            message[0].cs_release = 0;
+            message[0].next       = RT_NULL;
+            count = 1;
+            /* the buffer pointer is auto-incremented, only the opcode is sent to continue */
+            cmd_len = 1;
+        }
+
+        message[count].send_buf   = read ? RT_NULL : p->payload;
+        message[count].recv_buf   = read ? p->payload : RT_NULL;
+        message[count].length     = p->len;
+        message[count].cs_take    = 0;
+        message[count].cs_release = 0;
+        message[count].next       = RT_NULL;
+        message[count - 1].next   = &message[count];
+        count++;
+
+        if (count == SPI_BURST_SEGMENTS + 1)
+        {
+            message[count - 1].cs_release = 1;
+            rt_spi_transfer_message(spi_device, message);
+            count = 0;
+        }
+    }
+
+    if (count > 0)
+    {
+        message[count - 1].cs_release = 1;
+        rt_spi_transfer_message(spi_device, message);
+    }
+}
+
+#if defined(ETH_RX_DUMP) || defined(ETH_TX_DUMP)
+static void enc28j60_dump(const char *name, struct pbuf *p)
+{
+    struct pbuf *q;
+    rt_size_t dump_count = 0;
+    rt_uint8_t *dump_ptr;
+    rt_size_t dump_i;
+
+    NET_DEBUG("%s, size:%d\r\n", name, p->tot_len);
+    for (q = p; q != RT_NULL; q = q->next)
+    {
+        dump_ptr = q->payload;
+        for (dump_i = 0; dump_i < q->len; dump_i++)
+        {
+            NET_DEBUG("%02x ", *dump_ptr);
+            if (((dump_count + 1) % 8) == 0)
+            {
+                NET_DEBUG("  ");
+            }
+            if (((dump_count + 1) % 16) == 0)
+            {
+                NET_DEBUG("\r\n");
+            }
+            dump_count++;
+            dump_ptr++;
+        }
+    }
+    NET_DEBUG("\r\n");
+}
+#endif
+
 static uint16_t enc28j60_phy_read(struct rt_spi_device *spi_device, rt_uint8_t address)
 {
     uint16_t value;
@@ -173,9 +329,6 @@ static uint32_t enc28j60_interrupt_disable(struct rt_spi_device *spi_device)
 {
     uint32_t level;
 
-    /* switch to bank 0 */
-    enc28j60_set_bank(spi_device, EIE);
-
     /* get last interrupt level */
     level = spi_read(spi_device, EIE);
     /* disable interrutps */
@@ -186,8 +339,6 @@ static uint32_t enc28j60_interrupt_disable(struct rt_spi_device *spi_device)
 
 static void enc28j60_interrupt_enable(struct rt_spi_device *spi_device, uint32_t level)
 {
-    /* switch to bank 0 */
-    enc28j60_set_bank(spi_device, EIE);
     spi_write_op(spi_device, ENC28J60_BIT_FIELD_SET, EIE, level);
 }
 
@@ -250,28 +401,27 @@ static rt_err_t enc28j60_init(rt_device_t dev)
     // perform system reset
     spi_write_op(spi_device, ENC28J60_SOFT_RESET, 0, ENC28J60_SOFT_RESET);
     rt_thread_delay(RT_TICK_PER_SECOND / 50); /* delay 20ms */
+    /* the bank 0 is selected after reset */
+    Enc28j60Bank = 0;
 
     NextPacketPtr = RXSTART_INIT;
+    rx_draining = RT_FALSE;
+    rx_pending = 0;
+    rx_budget = 0;
 
     // Rx start
-    spi_write(spi_device, ERXSTL, RXSTART_INIT & 0xFF);
-    spi_write(spi_device, ERXSTH, RXSTART_INIT >> 8);
+    spi_write_word(spi_device, ERXSTL, RXSTART_INIT);
     // set receive pointer address
-    spi_write(spi_device, ERXRDPTL, RXSTOP_INIT & 0xFF);
-    spi_write(spi_device, ERXRDPTH, RXSTOP_INIT >> 8);
+    spi_write_word(spi_device, ERXRDPTL, RXSTOP_INIT);
     // RX end
-    spi_write(spi_device, ERXNDL, RXSTOP_INIT & 0xFF);
-    spi_write(spi_device, ERXNDH, RXSTOP_INIT >> 8);
+    spi_write_word(spi_device, ERXNDL, RXSTOP_INIT);
 
     // TX start
-    spi_write(spi_device, ETXSTL, TXSTART_INIT & 0xFF);
-    spi_write(spi_device, ETXSTH, TXSTART_INIT >> 8);
+    spi_write_word(spi_device, ETXSTL, TXSTART_INIT);
     // set transmission pointer address
-    spi_write(spi_device, EWRPTL, TXSTART_INIT & 0xFF);
-    spi_write(spi_device, EWRPTH, TXSTART_INIT >> 8);
+    spi_write_word(spi_device, EWRPTL, TXSTART_INIT);
     // TX end
-    spi_write(spi_device, ETXNDL, TXSTOP_INIT & 0xFF);
-    spi_write(spi_device, ETXNDH, TXSTOP_INIT >> 8);
+    spi_write_word(spi_device, ETXNDL, TXSTOP_INIT);
 
     // do bank 1 stuff, packet filter:
     // For broadcast packets we allow only ARP packtets
@@ -306,8 +456,7 @@ static rt_err_t enc28j60_init(rt_device_t dev)
 
     // Set the maximum packet size which the controller will accept
     // Do not send packets longer than MAX_FRAMELEN:
-    spi_write(spi_device, MAMXFLL, MAX_FRAMELEN & 0xFF);
-    spi_write(spi_device, MAMXFLH, MAX_FRAMELEN >> 8);
+    spi_write_word(spi_device, MAMXFLL, MAX_FRAMELEN);
 
     // do bank 3 stuff
     // write MAC address
@@ -400,13 +549,8 @@ static rt_err_t enc28j60_tx(rt_device_t dev, struct pbuf *p)
 {
     struct net_device *enc28j60 = (struct net_device *)dev;
     struct rt_spi_device *spi_device = enc28j60->spi_device;
-    struct pbuf *q;
+    rt_uint8_t cmd[2];
     rt_uint32_t level;
-#ifdef ETH_TX_DUMP
-    rt_size_t dump_count = 0;
-    rt_uint8_t *dump_ptr;
-    rt_size_t dump_i;
-#endif
 
     if (tx_current->free == RT_FALSE)
     {
@@ -431,45 +575,17 @@ static rt_err_t enc28j60_tx(rt_device_t dev, struct pbuf *p)
     level = enc28j60_interrupt_disable(spi_device);
 
     // Set the write pointer to start of transmit buffer area
-//    spi_write(EWRPTL, TXSTART_INIT&0xFF);
-//    spi_write(EWRPTH, TXSTART_INIT>>8);
-    spi_write(spi_device, EWRPTL, (tx_current->addr) & 0xFF);
-    spi_write(spi_device, EWRPTH, (tx_current->addr) >> 8);
+    spi_write_word(spi_device, EWRPTL, tx_current->addr);
     // Set the TXND pointer to correspond to the packet size given
     tx_current->len = p->tot_len;
-//    spi_write(ETXNDL, (TXSTART_INIT+ p->tot_len + 1)&0xFF);
-//    spi_write(ETXNDH, (TXSTART_INIT+ p->tot_len + 1)>>8);
 
-    // write per-packet control byte (0x00 means use macon3 settings)
-    spi_write_op(spi_device, ENC28J60_WRITE_BUF_MEM, 0, 0x00);
+    // write per-packet control byte (0x00 means use macon3 settings) and the packet in a burst
+    cmd[0] = ENC28J60_WRITE_BUF_MEM;
+    cmd[1] = 0x00;
+    spi_burst_buffer(spi_device, cmd, 2, p, RT_FALSE);
 
 #ifdef ETH_TX_DUMP
-    NET_DEBUG("tx_dump, size:%d\r\n", p->tot_len);
-#endif
-    for (q = p; q != NULL; q = q->next)
-    {
-        uint8_t cmd = ENC28J60_WRITE_BUF_MEM;
-        rt_spi_send_then_send(enc28j60->spi_device, &cmd, 1, q->payload, q->len);
-#ifdef ETH_RX_DUMP
-        dump_ptr = q->payload;
-        for (dump_i = 0; dump_i < q->len; dump_i++)
-        {
-            NET_DEBUG("%02x ", *dump_ptr);
-            if (((dump_count + 1) % 8) == 0)
-            {
-                NET_DEBUG("  ");
-            }
-            if (((dump_count + 1) % 16) == 0)
-            {
-                NET_DEBUG("\r\n");
-            }
-            dump_count++;
-            dump_ptr++;
-        }
-#endif
-    }
-#ifdef ETH_RX_DUMP
-    NET_DEBUG("\r\n");
+    enc28j60_dump("tx_dump", p);
 #endif
 
     // send the contents of the transmit buffer onto the network
@@ -477,11 +593,9 @@ static rt_err_t enc28j60_tx(rt_device_t dev, struct pbuf *p)
     {
         NET_DEBUG("[Tx] stop, restart!\r\n");
         // TX start
-        spi_write(spi_device, ETXSTL, (tx_current->addr) & 0xFF);
-        spi_write(spi_device, ETXSTH, (tx_current->addr) >> 8);
+        spi_write_word(spi_device, ETXSTL, tx_current->addr);
         // TX end
-        spi_write(spi_device, ETXNDL, (tx_current->addr + tx_current->len) & 0xFF);
-        spi_write(spi_device, ETXNDH, (tx_current->addr + tx_current->len) >> 8);
+        spi_write_word(spi_device, ETXNDL, tx_current->addr + tx_current->len);
 
         spi_write_op(spi_device, ENC28J60_BIT_FIELD_SET, ECON1, ECON1_TXRTS);
     }
@@ -507,7 +621,61 @@ static rt_err_t enc28j60_tx(rt_device_t dev, struct pbuf *p)
     return RT_EOK;
 }
 
-/* recv packet. */
+/* read a received packet, RT_NULL is returned if it's invalid or no memory */
+static struct pbuf *enc28j60_packet_read(struct rt_spi_device *spi_device)
+{
+    struct pbuf *p = RT_NULL;
+    rt_uint8_t cmd = ENC28J60_READ_BUF_MEM;
+    rt_uint8_t header[6];
+    rt_uint32_t len;
+    rt_uint16_t rxstat;
+
+    /* Set the read pointer to the start of the received packet. */
+    spi_write_word(spi_device, ERDPTL, NextPacketPtr);
+
+    /* read the next packet pointer, the packet length and the receive status
+     * (see datasheet page 43) in one burst. */
+    spi_read_buffer(spi_device, header, sizeof(header));
+    NextPacketPtr = header[0] | (header[1] << 8);
+    len = header[2] | (header[3] << 8);
+    rxstat = header[4] | (header[5] << 8);
+
+    len -= 4; //remove the CRC count
+
+    // check CRC and symbol errors (see datasheet page 44, table 7-3):
+    // The ERXFCON.CRCEN is set by default. Normally we should not
+    // need to check this.
+    if ((rxstat & 0x80) != 0)
+    {
+        /* allocation pbuf */
+        p = pbuf_alloc(PBUF_LINK, len, PBUF_POOL);
+        if (p != RT_NULL)
+        {
+            spi_burst_buffer(spi_device, &cmd, 1, p, RT_TRUE);
+#ifdef ETH_RX_DUMP
+            enc28j60_dump("rx_dump", p);
+#endif
+        }
+    }
+
+    /* Move the RX read pointer to the start of the next received packet. */
+    /* This frees the memory we just read out. */
+    spi_write_word(spi_device, ERXRDPTL, NextPacketPtr);
+
+    /* decrement the packet counter indicate we are done with this packet. */
+    spi_write_op(spi_device, ENC28J60_BIT_FIELD_SET, ECON2, ECON2_PKTDEC);
+
+    return p;
+}
+
+/*
+ * recv packet.
+ * The interrupt is disabled at the first call of a wakeup and kept disabled
+ * while the pending packets are drained, then it's enabled again when no
+ * packet is left or ENC28J60_RX_BUDGET packets are read, and RT_NULL is
+ * returned. The packets left raise the interrupt again. EIR is handled at
+ * every call, so the Tx completion and the errors are not held by a drain.
+ */
 static struct pbuf *enc28j60_rx(rt_device_t dev)
 {
     struct net_device *enc28j60 = (struct net_device *)dev;
@@ -515,15 +683,17 @@ static struct pbuf *enc28j60_rx(rt_device_t dev)
     struct pbuf *p = RT_NULL;
 
     uint8_t eir, eir_clr;
-    uint32_t pk_counter;
-    rt_uint32_t level;
-    rt_uint32_t len;
-    rt_uint16_t rxstat;
 
     enc28j60_lock(dev);
 
-    /* disable enc28j60 interrupt */
-    level = enc28j60_interrupt_disable(spi_device);
+    if (rx_draining == RT_FALSE)
+    {
+        /* disable enc28j60 interrupt */
+        rx_level = enc28j60_interrupt_disable(spi_device);
+        rx_draining = RT_TRUE;
+        rx_pending = 0;
+        rx_budget = ENC28J60_RX_BUDGET;
+    }
 
     /* get EIR */
     eir = spi_read(spi_device, EIR);
@@ -584,11 +754,9 @@ static struct pbuf *enc28j60_rx(rt_device_t dev)
             {
                 NET_DEBUG("[tx isr] Tx chain not empty, continue send the next pkt!\r\n");
                 // TX start
-                spi_write(spi_device, ETXSTL, (tx_ack->addr) & 0xFF);
-                spi_write(spi_device, ETXSTH, (tx_ack->addr) >> 8);
+                spi_write_word(spi_device, ETXSTL, tx_ack->addr);
                 // TX end
-                spi_write(spi_device, ETXNDL, (tx_ack->addr + tx_ack->len) & 0xFF);
-                spi_write(spi_device, ETXNDH, (tx_ack->addr + tx_ack->len) >> 8);
+                spi_write_word(spi_device, ETXNDL, tx_ack->addr + tx_ack->len);
 
                 spi_write_op(spi_device, ENC28J60_BIT_FIELD_SET, ECON1, ECON1_TXRTS);
             }
@@ -621,8 +789,9 @@ static struct pbuf *enc28j60_rx(rt_device_t dev)
 //            enc28j60_set_bank(spi_device, EIR);
 //            spi_write_op(spi_device, ENC28J60_BIT_FIELD_CLR, EIR, EIR_TXERIF);
 
-            /* re-init tx chain */
+            /* re-init tx chain, and wake up the sender waiting for a free buffer */
             _tx_chain_init();
+            rt_event_send(&tx_event, 0x01);
         }
 
         /* RX Error handler */
@@ -639,6 +808,8 @@ static struct pbuf *enc28j60_rx(rt_device_t dev)
             /* enable packet reception. */
             spi_write_op(spi_device, ENC28J60_BIT_FIELD_SET, ECON1, ECON1_RXEN);
             eir_clr |= EIR_RXERIF;
+            /* the packets counted before are gone */
+            rx_pending = 0;
 //            enc28j60_set_bank(spi_device, EIR);
 //            spi_write_op(spi_device, ENC28J60_BIT_FIELD_CLR, EIR, EIR_RXERIF);
         }
@@ -649,98 +820,30 @@ static struct pbuf *enc28j60_rx(rt_device_t dev)
         eir = spi_read(spi_device, EIR);
     }
 
-    /* read pkt */
-    pk_counter = spi_read(spi_device, EPKTCNT);
-    if (pk_counter)
+    /* the packets received during the draining are counted again */
+    if (rx_pending == 0 && rx_budget > 0)
     {
-        /* Set the read pointer to the start of the received packet. */
-        spi_write(spi_device, ERDPTL, (NextPacketPtr));
-        spi_write(spi_device, ERDPTH, (NextPacketPtr) >> 8);
-
-        /* read the next packet pointer. */
-        NextPacketPtr  = spi_read_op(spi_device, ENC28J60_READ_BUF_MEM, 0);
-        NextPacketPtr |= spi_read_op(spi_device, ENC28J60_READ_BUF_MEM, 0) << 8;
-
-        /* read the packet length (see datasheet page 43). */
-        len  = spi_read_op(spi_device, ENC28J60_READ_BUF_MEM, 0);       //0x54
-        len |= spi_read_op(spi_device, ENC28J60_READ_BUF_MEM, 0) << 8;  //5554
-
-        len -= 4; //remove the CRC count
-
-        // read the receive status (see datasheet page 43)
-        rxstat  = spi_read_op(spi_device, ENC28J60_READ_BUF_MEM, 0);
-        rxstat |= ((rt_uint16_t)spi_read_op(spi_device, ENC28J60_READ_BUF_MEM, 0)) << 8;
-
-        // check CRC and symbol errors (see datasheet page 44, table 7-3):
-        // The ERXFCON.CRCEN is set by default. Normally we should not
-        // need to check this.
-        if ((rxstat & 0x80) == 0)
-        {
-            // invalid
-            len = 0;
-        }
-        else
-        {
-            /* allocation pbuf */
-            p = pbuf_alloc(PBUF_LINK, len, PBUF_POOL);
-            if (p != RT_NULL)
-            {
-                struct pbuf *q;
-#ifdef ETH_RX_DUMP
-                rt_size_t dump_count = 0;
-                rt_uint8_t *dump_ptr;
-                rt_size_t dump_i;
-                NET_DEBUG("rx_dump, size:%d\r\n", len);
-#endif
-                for (q = p; q != RT_NULL; q = q->next)
-                {
-                    uint8_t cmd = ENC28J60_READ_BUF_MEM;
-                    rt_spi_send_then_recv(spi_device, &cmd, 1, q->payload, q->len);
-#ifdef ETH_RX_DUMP
-                    dump_ptr = q->payload;
-                    for (dump_i = 0; dump_i < q->len; dump_i++)
-                    {
-                        NET_DEBUG("%02x ", *dump_ptr);
-                        if (((dump_count + 1) % 8) == 0)
-                        {
-                            NET_DEBUG("  ");
-                        }
-                        if (((dump_count + 1) % 16) == 0)
-                        {
-                            NET_DEBUG("\r\n");
-                        }
-                        dump_count++;
-                        dump_ptr++;
-                    }
-#endif
-                }
-#ifdef ETH_RX_DUMP
-                NET_DEBUG("\r\n");
-#endif
-            }
-        }
-
-        /* Move the RX read pointer to the start of the next received packet. */
-        /* This frees the memory we just read out. */
-        spi_write(spi_device, ERXRDPTL, (NextPacketPtr));
-        spi_write(spi_device, ERXRDPTH, (NextPacketPtr) >> 8);
+        rx_pending = spi_read(spi_device, EPKTCNT);
+    }
 
-        /* decrement the packet counter indicate we are done with this packet. */
-        spi_write_op(spi_device, ENC28J60_BIT_FIELD_SET, ECON2, ECON2_PKTDEC);
+    /* read pkt, skip the invalid ones */
+    while (rx_pending > 0 && rx_budget > 0 && p == RT_NULL)
+    {
+        p = enc28j60_packet_read(spi_device);
+        rx_pending --;
+        rx_budget --;
     }
-    else
+
+    if (p == RT_NULL)
     {
-        /* switch to bank 0. */
-        enc28j60_set_bank(spi_device, ECON1);
         /* enable packet reception. */
         spi_write_op(spi_device, ENC28J60_BIT_FIELD_SET, ECON1, ECON1_RXEN);
 
-        level |= EIE_PKTIE;
+        /* enable enc28j60 interrupt, PKTIF is still set if there are packets left */
+        enc28j60_interrupt_enable(spi_device, rx_level | EIE_PKTIE);
+        rx_draining = RT_FALSE;
     }
 
-    /* enable enc28j60 interrupt */
-    enc28j60_interrupt_enable(spi_device, level);
-
     enc28j60_unlock(dev);
 
     return p;
@@ -790,6 +893,7 @@ rt_err_t enc28j60_attach(const char *spi_device_name)
         /* perform system reset. */
         spi_write_op(spi_device, ENC28J60_SOFT_RESET, 0, ENC28J60_SOFT_RESET);
         rt_thread_delay(1); /* delay 20ms */
+        Enc28j60Bank = 0;
 
         enc28j60_dev.emac_rev = spi_read(spi_device, EREVID);
         value = enc28j60_phy_read(spi_device, PHHID2);
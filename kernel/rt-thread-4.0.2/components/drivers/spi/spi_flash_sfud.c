@@ -536,6 +536,100 @@ __error:
     return RT_NULL;
 }
 
+#ifdef RT_USING_MTD_NOR
+static rt_err_t sfud_mtd_read_id(struct rt_mtd_nor_device *device) {
+    struct spi_flash_mtd *mtd = (struct spi_flash_mtd *) device;
+    sfud_flash *sfud_dev = (sfud_flash *) (mtd->user_data);
+
+    return (rt_err_t) ((sfud_dev->chip.mf_id << 16) | (sfud_dev->chip.type_id << 8) | sfud_dev->chip.capacity_id);
+}
+
+static rt_size_t sfud_mtd_read(struct rt_mtd_nor_device *device, rt_off_t offset, rt_uint8_t *data, rt_uint32_t length) {
+    struct spi_flash_mtd *mtd = (struct spi_flash_mtd *) device;
+    sfud_flash *sfud_dev = (sfud_flash *) (mtd->user_data);
+
+    if (sfud_read(sfud_dev, offset, length, data) != SFUD_SUCCESS) {
+        return 0;
+    }
+    return length;
+}
+
+static rt_size_t sfud_mtd_write(struct rt_mtd_nor_device *device, rt_off_t offset, const rt_uint8_t *data, rt_uint32_t length) {
+    struct spi_flash_mtd *mtd = (struct spi_flash_mtd *) device;
+    sfud_flash *sfud_dev = (sfud_flash *) (mtd->user_data);
+
+    /* program only, the caller is responsible for erasing the block before */
+    if (sfud_write(sfud_dev, offset, length, data) != SFUD_SUCCESS) {
+        return 0;
+    }
+    return length;
+}
+
+static rt_err_t sfud_mtd_erase_block(struct rt_mtd_nor_device *device, rt_off_t offset, rt_uint32_t length) {
+    struct spi_flash_mtd *mtd = (struct spi_flash_mtd *) device;
+    sfud_flash *sfud_dev = (sfud_flash *) (mtd->user_data);
+
+    if (sfud_erase(sfud_dev, offset, length) != SFUD_SUCCESS) {
+        return -RT_ERROR;
+    }
+    return RT_EOK;
+}
+
+static const struct rt_mtd_nor_driver_ops sfud_mtd_ops = {
+    sfud_mtd_read_id,
+    sfud_mtd_read,
+    sfud_mtd_write,
+    sfud_mtd_erase_block,
+};
+
+/**
+ * Register a probed SFUD flash as MTD NOR device, so the components which are
+ * using raw program/erase operations (such as the flash key-value storage)
+ * can run on it without the erase-before-write of the block device.
+ *
+ * @param mtd_name the name which will create MTD NOR device
+ * @param flash_dev_name the probed SPI flash (block) device name
+ *
+ * @return the MTD NOR device, failed will return RT_NULL
+ */
+struct rt_mtd_nor_device *rt_sfud_mtd_nor_register(const char *mtd_name, const char *flash_dev_name) {
+    struct spi_flash_mtd *mtd;
+    rt_spi_flash_device_t rtt_dev;
+    sfud_flash_t sfud_dev;
+
+    RT_ASSERT(mtd_name);
+    RT_ASSERT(flash_dev_name);
+
+    sfud_dev = rt_sfud_flash_find_by_dev_name(flash_dev_name);
+    if (sfud_dev == RT_NULL) {
+        return RT_NULL;
+    }
+    rtt_dev = (rt_spi_flash_device_t) (sfud_dev->user_data);
+
+    mtd = (struct spi_flash_mtd *) rt_malloc(sizeof(struct spi_flash_mtd));
+    if (mtd == RT_NULL) {
+        rt_kprintf("ERROR: Low memory.\n");
+        return RT_NULL;
+    }
+    rt_memset(mtd, 0, sizeof(struct spi_flash_mtd));
+
+    mtd->rt_spi_device = rtt_dev->rt_spi_device;
+    mtd->user_data = sfud_dev;
+    mtd->mtd_device.block_size = sfud_dev->chip.erase_gran;
+    mtd->mtd_device.block_start = 0;
+    mtd->mtd_device.block_end = sfud_dev->chip.capacity / sfud_dev->chip.erase_gran;
+    mtd->mtd_device.ops = &sfud_mtd_ops;
+
+    if (rt_mtd_nor_register_device(mtd_name, &(mtd->mtd_device)) != RT_EOK) {
+        rt_free(mtd);
+        return RT_NULL;
+    }
+
+    DEBUG_TRACE("Register MTD NOR device %s on %s success.\n", mtd_name, flash_dev_name);
+    return &(mtd->mtd_device);
+}
+#endif /* RT_USING_MTD_NOR */
+
 #if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
 
 #include <finsh.h>
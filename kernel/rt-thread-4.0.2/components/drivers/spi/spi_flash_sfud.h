@@ -53,4 +53,16 @@ sfud_flash_t rt_sfud_flash_find(const char *spi_dev_name);
  */
 sfud_flash_t rt_sfud_flash_find_by_dev_name(const char *flash_dev_name);
 
+#ifdef RT_USING_MTD_NOR
+/**
+ * Register a probed SFUD flash as MTD NOR device
+ *
+ * @param mtd_name the name which will create MTD NOR device
+ * @param flash_dev_name the probed SPI flash (block) device name
+ *
+ * @return the MTD NOR device, failed will return RT_NULL
+ */
+struct rt_mtd_nor_device *rt_sfud_mtd_nor_register(const char *mtd_name, const char *flash_dev_name);
+#endif
+
 #endif /* _SPI_FLASH_SFUD_H_ */
@@ -8,6 +8,7 @@
  * 2014-07-31     aozima       the first version
  * 2014-09-18     aozima       update command & response.
  * 2017-07-28     armink       fix auto reconnect feature
+ * 2026-10-18     liujiahao    receive the frame into pbuf directly
  */
 
 #include <rtthread.h>
@@ -389,13 +390,18 @@ static rt_err_t spi_wifi_transfer(struct rw009_wifi *dev)
         {
             SPI_DEBUG("no rx or tx data!\n");
         }
+        else if (resp.S2M_len && wifi_device->active)
+        {
+            /* receive into pbuf directly, or into the rx buffer if it fails */
+            p = pbuf_alloc(PBUF_RAW, max_data_len, PBUF_RAM);
+        }
 
         //SPI_DEBUG("max_data_len = %d\n", max_data_len);
 
 _bad_resp_magic:
         /* setup message */
         message.send_buf = data_packet;//&tx_buffer;
-        message.recv_buf = wifi_device->spi_hw_rx_buffer;//&rx_buffer;
+        message.recv_buf = (p != RT_NULL) ? p->payload : wifi_device->spi_hw_rx_buffer;//&rx_buffer;
         message.length = max_data_len;
         message.cs_take = 0;
         message.cs_release = 1;
@@ -412,17 +418,35 @@ _bad_resp_magic:
 
         if ((resp.S2M_len) && (resp.S2M_len <= MAX_SPI_PACKET_SIZE))
         {
-            data_packet = (struct spi_data_packet *)wifi_device->spi_hw_rx_buffer;
+            data_packet = (struct spi_data_packet *)message.recv_buf;
             if (data_packet->data_type == data_type_eth_data)
             {
 
                 if (wifi_device->active)
                 {
-                    p = pbuf_alloc(PBUF_LINK, data_packet->data_len, PBUF_RAM);
-                    pbuf_take(p, (rt_uint8_t *)data_packet->buffer, data_packet->data_len);
-
-                    rt_mb_send(&wifi_device->eth_rx_mb, (rt_uint32_t)p);
-                    eth_device_ready((struct eth_device *)dev);
+                    rt_uint32_t data_len = data_packet->data_len;
+
+                    if (p != RT_NULL)
+                    {
+                        /* strip the packet header */
+                        pbuf_header(p, -(s16_t)member_offset(struct spi_data_packet, buffer));
+                        pbuf_realloc(p, data_len);
+                    }
+                    else
+                    {
+                        p = pbuf_alloc(PBUF_LINK, data_len, PBUF_RAM);
+                        if (p != RT_NULL)
+                            pbuf_take(p, (rt_uint8_t *)data_packet->buffer, data_len);
+                    }
+
+                    if (p != RT_NULL)
+                    {
+                        if (rt_mb_send(&wifi_device->eth_rx_mb, (rt_uint32_t)p) == RT_EOK)
+                            eth_device_ready((struct eth_device *)dev);
+                        else
+                            pbuf_free(p);
+                        p = RT_NULL;
+                    }
                 }
                 else
                 {
@@ -442,6 +466,11 @@ _bad_resp_magic:
             }
         }
     }
+    if (p != RT_NULL)
+    {
+        /* it isn't an ethernet frame */
+        pbuf_free(p);
+    }
     spi_wifi_int_cmd(1);
 
     SPI_DEBUG("sequence finish!\n\n");
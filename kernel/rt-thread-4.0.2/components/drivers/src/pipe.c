@@ -7,11 +7,189 @@
  * Date           Author       Notes
  * 2012-09-30     Bernard      first version.
  * 2017-11-08     JasonJiaJie  fix memory leak issue when close a pipe.
+ * 2026-10-18     liujiahao    Add lock-free ring buffer, readv/writev and vmsplice.
  */
 #include <rthw.h>
 #include <rtdevice.h>
 #include <stdint.h>
 
+#ifdef RT_PIPE_USING_LOCKFREE
+#ifdef __GNUC__
+#define PIPE_BARRIER()          __sync_synchronize()
+#else
+/* the function call is a compiler barrier, it's enough for single core */
+#define PIPE_BARRIER()          rt_hw_interrupt_enable(rt_hw_interrupt_disable())
+#endif
+
+static rt_err_t pipe_fifo_create(rt_pipe_t *pipe)
+{
+    rt_uint32_t size = 1;
+
+    while (size < pipe->bufsz)
+        size <<= 1;
+
+    pipe->ring = (rt_uint8_t *)rt_malloc(size);
+    if (pipe->ring == RT_NULL)
+        return -RT_ENOMEM;
+
+    pipe->ring_size = size;
+    pipe->head = pipe->tail = 0;
+    pipe->seg_head = pipe->seg_tail = 0;
+    pipe->reader_waiting = pipe->writer_waiting = 0;
+
+    return RT_EOK;
+}
+
+/* drop the data and the buffers handed off to pipe */
+static void pipe_fifo_reset(rt_pipe_t *pipe)
+{
+    while (pipe->seg_tail != pipe->seg_head)
+    {
+        struct rt_pipe_segment *seg = &pipe->segments[pipe->seg_tail % RT_PIPE_SEGMENT_MAX];
+
+        if (seg->gift)
+            rt_free((void *)seg->buf);
+        pipe->seg_tail ++;
+    }
+    pipe->tail = pipe->head;
+}
+
+static void pipe_fifo_destroy(rt_pipe_t *pipe)
+{
+    if (pipe->ring == RT_NULL)
+        return;
+
+    pipe_fifo_reset(pipe);
+    rt_free(pipe->ring);
+    pipe->ring = RT_NULL;
+}
+
+static rt_size_t pipe_data_len(rt_pipe_t *pipe)
+{
+    rt_uint32_t len = pipe->head - pipe->tail;
+    rt_uint16_t index;
+
+    for (index = pipe->seg_tail; index != pipe->seg_head; index ++)
+    {
+        struct rt_pipe_segment *seg = &pipe->segments[index % RT_PIPE_SEGMENT_MAX];
+
+        len += seg->len - seg->offset;
+    }
+
+    return len;
+}
+
+static rt_size_t pipe_space_len(rt_pipe_t *pipe)
+{
+    return pipe->ring_size - (pipe->head - pipe->tail);
+}
+
+/* the writer side, it returns the bytes which are put into the ring */
+static rt_size_t pipe_fifo_put(rt_pipe_t *pipe, const rt_uint8_t *buf, rt_size_t count, rt_bool_t *was_empty)
+{
+    rt_uint32_t head, tail, index, part;
+
+    head = pipe->head;
+    tail = pipe->tail;
+    PIPE_BARRIER();
+
+    if (count > pipe->ring_size - (head - tail))
+        count = pipe->ring_size - (head - tail);
+    if (count == 0)
+        return 0;
+
+    index = head & (pipe->ring_size - 1);
+    part = pipe->ring_size - index;
+    if (part > count)
+        part = count;
+    rt_memcpy(&pipe->ring[index], buf, part);
+    rt_memcpy(&pipe->ring[0], buf + part, count - part);
+
+    /* the data must be ready before the reader sees the new head */
+    PIPE_BARRIER();
+    pipe->head = head + count;
+    *was_empty = (head == tail);
+
+    return count;
+}
+
+/* the reader side, it returns the bytes which are got from the ring or the segment */
+static rt_size_t pipe_fifo_get(rt_pipe_t *pipe, rt_uint8_t *buf, rt_size_t count, rt_bool_t *was_full)
+{
+    rt_uint32_t head, tail, limit, index, part;
+
+    /* the segment is published before the head is moved beyond it */
+    head = pipe->head;
+    tail = pipe->tail;
+    PIPE_BARRIER();
+
+    limit = head;
+    if (pipe->seg_tail != pipe->seg_head)
+    {
+        struct rt_pipe_segment *seg = &pipe->segments[pipe->seg_tail % RT_PIPE_SEGMENT_MAX];
+
+        /* the segment fields are read after its seg_head is seen */
+        PIPE_BARRIER();
+
+        if (tail == seg->pos)
+        {
+            if (count > seg->len - seg->offset)
+                count = seg->len - seg->offset;
+            rt_memcpy(buf, seg->buf + seg->offset, count);
+            seg->offset += count;
+            if (seg->offset == seg->len)
+            {
+                if (seg->gift)
+                    rt_free((void *)seg->buf);
+                PIPE_BARRIER();
+                pipe->seg_tail ++;
+                /* the writer may wait for the segment */
+                *was_full = RT_TRUE;
+            }
+
+            return count;
+        }
+        limit = seg->pos;
+    }
+
+    if (count > limit - tail)
+        count = limit - tail;
+    if (count == 0)
+        return 0;
+
+    index = tail & (pipe->ring_size - 1);
+    part = pipe->ring_size - index;
+    if (part > count)
+        part = count;
+    rt_memcpy(buf, &pipe->ring[index], part);
+    rt_memcpy(buf + part, &pipe->ring[0], count - part);
+
+    PIPE_BARRIER();
+    pipe->tail = tail + count;
+    if (head - tail == pipe->ring_size)
+        *was_full = RT_TRUE;
+
+    return count;
+}
+#else
+static rt_err_t pipe_fifo_create(rt_pipe_t *pipe)
+{
+    pipe->fifo = rt_ringbuffer_create(pipe->bufsz);
+
+    return pipe->fifo ? RT_EOK : -RT_ENOMEM;
+}
+
+static void pipe_fifo_destroy(rt_pipe_t *pipe)
+{
+    if (pipe->fifo != RT_NULL)
+        rt_ringbuffer_destroy(pipe->fifo);
+    pipe->fifo = RT_NULL;
+}
+
+#define pipe_data_len(pipe)     rt_ringbuffer_data_len((pipe)->fifo)
+#define pipe_space_len(pipe)    rt_ringbuffer_space_len((pipe)->fifo)
+#endif /* RT_PIPE_USING_LOCKFREE */
+
 #if defined(RT_USING_POSIX)
 #include <dfs_file.h>
 #include <dfs_posix.h>
@@ -31,8 +209,7 @@ static int pipe_fops_open(struct dfs_fd *fd)
 
     if (device->ref_count == 0)
     {
-        pipe->fifo = rt_ringbuffer_create(pipe->bufsz);
-        if (pipe->fifo == RT_NULL)
+        if (pipe_fifo_create(pipe) != RT_EOK)
         {
             rc = -RT_ENOMEM;
             goto __exit;
@@ -97,9 +274,7 @@ static int pipe_fops_close(struct dfs_fd *fd)
 
     if (device->ref_count == 1)
     {
-        if (pipe->fifo != RT_NULL)
-            rt_ringbuffer_destroy(pipe->fifo);
-        pipe->fifo = RT_NULL;
+        pipe_fifo_destroy(pipe);
     }
     device->ref_count --;
 
@@ -124,10 +299,10 @@ static int pipe_fops_ioctl(struct dfs_fd *fd, int cmd, void *args)
     switch (cmd)
     {
     case FIONREAD:
-        *((int*)args) = rt_ringbuffer_data_len(pipe->fifo);
+        *((int*)args) = pipe_data_len(pipe);
         break;
     case FIONWRITE:
-        *((int*)args) = rt_ringbuffer_space_len(pipe->fifo);
+        *((int*)args) = pipe_space_len(pipe);
         break;
     default:
         ret = -EINVAL;
@@ -137,6 +312,117 @@ static int pipe_fops_ioctl(struct dfs_fd *fd, int cmd, void *args)
     return ret;
 }
 
+#ifdef RT_PIPE_USING_LOCKFREE
+/* the reader and writer only wake up each other when the ring is changed from
+ * empty or full, or the other side is going to sleep */
+static int pipe_fops_read(struct dfs_fd *fd, void *buf, size_t count)
+{
+    int len = 0;
+    rt_pipe_t *pipe;
+    rt_size_t n;
+    rt_bool_t was_full = RT_FALSE;
+
+    pipe = (rt_pipe_t *)fd->data;
+
+    if (count == 0)
+        return 0;
+
+    rt_mutex_take(&(pipe->read_lock), RT_WAITING_FOREVER);
+
+    while (1)
+    {
+        while (len < count &&
+               (n = pipe_fifo_get(pipe, (rt_uint8_t *)buf + len, count - len, &was_full)) > 0)
+        {
+            len += n;
+        }
+
+        if (len > 0)
+            break;
+
+        /* no process has the pipe open for writing, return end-of-file */
+        if (pipe->writers == 0)
+            break;
+
+        if (fd->flags & O_NONBLOCK)
+        {
+            len = -EAGAIN;
+            break;
+        }
+
+        pipe->reader_waiting = 1;
+        PIPE_BARRIER();
+        if (pipe_data_len(pipe) == 0 && pipe->writers != 0)
+            rt_wqueue_wait(&(pipe->reader_queue), 0, -1);
+        pipe->reader_waiting = 0;
+    }
+
+    rt_mutex_release(&(pipe->read_lock));
+
+    PIPE_BARRIER();
+    if (len > 0 && (was_full || pipe->writer_waiting))
+        rt_wqueue_wakeup(&(pipe->writer_queue), (void*)POLLOUT);
+
+    return len;
+}
+
+static int pipe_fops_write(struct dfs_fd *fd, const void *buf, size_t count)
+{
+    int ret = 0;
+    rt_pipe_t *pipe;
+    rt_size_t len;
+    rt_bool_t was_empty = RT_FALSE;
+
+    pipe = (rt_pipe_t *)fd->data;
+
+    if (pipe->readers == 0)
+        return -EPIPE;
+
+    if (count == 0)
+        return 0;
+
+    rt_mutex_take(&(pipe->write_lock), RT_WAITING_FOREVER);
+
+    while (ret < count)
+    {
+        if (pipe->readers == 0)
+        {
+            if (ret == 0)
+                ret = -EPIPE;
+            break;
+        }
+
+        len = pipe_fifo_put(pipe, (const rt_uint8_t *)buf + ret, count - ret, &was_empty);
+        if (len > 0)
+        {
+            ret += len;
+
+            PIPE_BARRIER();
+            if (was_empty || pipe->reader_waiting)
+                rt_wqueue_wakeup(&(pipe->reader_queue), (void*)POLLIN);
+            continue;
+        }
+
+        if (fd->flags & O_NONBLOCK)
+        {
+            if (ret == 0)
+                ret = -EAGAIN;
+            break;
+        }
+
+        /* pipe full, waiting for the reader */
+        pipe->writer_waiting = 1;
+        PIPE_BARRIER();
+        if (pipe_space_len(pipe) == 0 && pipe->readers != 0)
+            rt_wqueue_wait(&(pipe->writer_queue), 0, -1);
+        pipe->writer_waiting = 0;
+    }
+
+    rt_mutex_release(&(pipe->write_lock));
+
+    return ret;
+}
+#else
 static int pipe_fops_read(struct dfs_fd *fd, void *buf, size_t count)
 {
     int len = 0;
@@ -256,6 +542,8 @@ out:
     return ret;
 }
 
+#endif /* RT_PIPE_USING_LOCKFREE */
+
 static int pipe_fops_poll(struct dfs_fd *fd, rt_pollreq_t *req)
 {
     int mask = 0;
@@ -281,7 +569,7 @@ static int pipe_fops_poll(struct dfs_fd *fd, rt_pollreq_t *req)
 
     if (mode & 1)
     {
-        if (rt_ringbuffer_data_len(pipe->fifo) != 0)
+        if (pipe_data_len(pipe) != 0)
         {
             mask |= POLLIN;
         }
@@ -293,7 +581,7 @@ static int pipe_fops_poll(struct dfs_fd *fd, rt_pollreq_t *req)
 
     if (mode & 2)
     {
-        if (rt_ringbuffer_space_len(pipe->fifo) != 0)
+        if (pipe_space_len(pipe) != 0)
         {
             mask |= POLLOUT;
         }
@@ -318,23 +606,165 @@ static const struct dfs_file_ops pipe_fops =
     RT_NULL,
     pipe_fops_poll,
 };
+
+#ifdef RT_PIPE_USING_LOCKFREE
+/**
+ * This function will hand off the buffers to the pipe, the reader copies the data
+ * from the buffers directly.
+ *
+ * @param fd the write end of pipe.
+ * @param iov the buffers.
+ * @param nr_segs the number of buffers.
+ * @param flags SPLICE_F_GIFT: the buffers allocated by rt_malloc are given to the
+ *              pipe, and freed after they are read, the function returns at once.
+ *              Otherwise the function returns after the buffers are read.
+ *              SPLICE_F_NONBLOCK: don't wait for the free segment or the reader,
+ *              the buffers must be kept until they are read without SPLICE_F_GIFT.
+ *
+ * @return the bytes handed off, or -1 on failed. The gifted buffers counted in
+ *         the bytes belong to pipe even if the reader closes, the others are
+ *         still owned by the caller.
+ */
+int vmsplice(int fd, const struct iovec *iov, rt_size_t nr_segs, unsigned int flags)
+{
+    struct dfs_fd *d;
+    rt_pipe_t *pipe;
+    rt_size_t index;
+    rt_uint16_t target;
+    int ret = 0, err = 0;
+    rt_bool_t nonblock;
+
+    d = fd_get(fd);
+    if (d == RT_NULL)
+    {
+        rt_set_errno(-EBADF);
+        return -1;
+    }
+    if (d->fops != &pipe_fops || (d->flags & O_ACCMODE) == O_RDONLY)
+    {
+        fd_put(d);
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    pipe = (rt_pipe_t *)d->data;
+    nonblock = (flags & SPLICE_F_NONBLOCK) || (d->flags & O_NONBLOCK);
+
+    rt_mutex_take(&(pipe->write_lock), RT_WAITING_FOREVER);
+
+    for (index = 0; index < nr_segs; index ++)
+    {
+        struct rt_pipe_segment *seg;
+        rt_bool_t was_empty;
+
+        if (iov[index].iov_len == 0)
+            continue;
+
+        /* wait for a free segment */
+        while ((rt_uint16_t)(pipe->seg_head - pipe->seg_tail) == RT_PIPE_SEGMENT_MAX)
+        {
+            if (pipe->readers == 0)
+                break;
+            if (nonblock)
+                break;
+
+            pipe->writer_waiting = 1;
+            PIPE_BARRIER();
+            if ((rt_uint16_t)(pipe->seg_head - pipe->seg_tail) == RT_PIPE_SEGMENT_MAX && pipe->readers != 0)
+                rt_wqueue_wait(&(pipe->writer_queue), 0, -1);
+            pipe->writer_waiting = 0;
+        }
+        if (pipe->readers == 0)
+        {
+            err = -EPIPE;
+            break;
+        }
+        if ((rt_uint16_t)(pipe->seg_head - pipe->seg_tail) == RT_PIPE_SEGMENT_MAX)
+        {
+            err = -EAGAIN;
+            break;
+        }
+
+        seg = &pipe->segments[pipe->seg_head % RT_PIPE_SEGMENT_MAX];
+        seg->buf = (const rt_uint8_t *)iov[index].iov_base;
+        seg->len = iov[index].iov_len;
+        seg->offset = 0;
+        seg->pos = pipe->head;
+        seg->gift = (flags & SPLICE_F_GIFT) ? RT_TRUE : RT_FALSE;
+        was_empty = (pipe->tail == pipe->head) && (pipe->seg_tail == pipe->seg_head);
+
+        PIPE_BARRIER();
+        pipe->seg_head ++;
+        ret += iov[index].iov_len;
+
+        PIPE_BARRIER();
+        if (was_empty || pipe->reader_waiting)
+            rt_wqueue_wakeup(&(pipe->reader_queue), (void*)POLLIN);
+    }
+
+    /* the buffers are still owned by the caller, wait for the reader */
+    target = pipe->seg_head;
+    while (ret > 0 && !(flags & SPLICE_F_GIFT) && !nonblock &&
+           (rt_int16_t)(pipe->seg_tail - target) < 0)
+    {
+        if (pipe->readers == 0)
+        {
+            err = -EPIPE;
+            break;
+        }
+
+        pipe->writer_waiting = 1;
+        PIPE_BARRIER();
+        if ((rt_int16_t)(pipe->seg_tail - target) < 0 && pipe->readers != 0)
+            rt_wqueue_wait(&(pipe->writer_queue), 0, -1);
+        pipe->writer_waiting = 0;
+    }
+
+    if (err == -EPIPE)
+    {
+        /* no reader, the buffers can't be referenced by pipe, the gifted
+         * buffers are freed here and the caller doesn't own them any more */
+        rt_mutex_take(&(pipe->read_lock), RT_WAITING_FOREVER);
+        pipe_fifo_reset(pipe);
+        rt_mutex_release(&(pipe->read_lock));
+
+        /* the buffers of caller were not read */
+        if (!(flags & SPLICE_F_GIFT))
+            ret = 0;
+    }
+
+    rt_mutex_release(&(pipe->write_lock));
+    fd_put(d);
+
+    if (ret == 0 && err < 0)
+    {
+        rt_set_errno(err);
+        return -1;
+    }
+
+    return ret;
+}
+RTM_EXPORT(vmsplice);
+#endif /* RT_PIPE_USING_LOCKFREE */
 #endif /* end of RT_USING_POSIX */
 
 rt_err_t  rt_pipe_open (rt_device_t device, rt_uint16_t oflag)
 {
     rt_pipe_t *pipe = (rt_pipe_t *)device;
+    rt_err_t ret = RT_EOK;
 
     if (device == RT_NULL) return -RT_EINVAL;
     rt_mutex_take(&(pipe->lock), RT_WAITING_FOREVER);
 
-    if (pipe->fifo == RT_NULL)
+    if (device->ref_count == 0)
     {
-        pipe->fifo = rt_ringbuffer_create(pipe->bufsz);
+        if (pipe_fifo_create(pipe) != RT_EOK)
+            ret = -RT_ENOMEM;
     }
 
     rt_mutex_release(&(pipe->lock));
 
-    return RT_EOK;
+    return ret;
 }
 
 rt_err_t  rt_pipe_close  (rt_device_t device)
@@ -346,8 +776,7 @@ rt_err_t  rt_pipe_close  (rt_device_t device)
 
     if (device->ref_count == 1)
     {
-        rt_ringbuffer_destroy(pipe->fifo);
-        pipe->fifo = RT_NULL;
+        pipe_fifo_destroy(pipe);
     }
 
     rt_mutex_release(&(pipe->lock));
@@ -369,6 +798,19 @@ rt_size_t rt_pipe_read   (rt_device_t device, rt_off_t pos, void *buffer, rt_siz
     if (count == 0) return 0;
 
     pbuf = (uint8_t*)buffer;
+#ifdef RT_PIPE_USING_LOCKFREE
+    rt_mutex_take(&(pipe->read_lock), RT_WAITING_FOREVER);
+
+    while (read_bytes < count)
+    {
+        rt_bool_t was_full = RT_FALSE;
+        int len = pipe_fifo_get(pipe, &pbuf[read_bytes], count - read_bytes, &was_full);
+        if (len <= 0) break;
+
+        read_bytes += len;
+    }
+    rt_mutex_release(&(pipe->read_lock));
+#else
     rt_mutex_take(&(pipe->lock), RT_WAITING_FOREVER);
 
     while (read_bytes < count)
@@ -379,6 +821,7 @@ rt_size_t rt_pipe_read   (rt_device_t device, rt_off_t pos, void *buffer, rt_siz
         read_bytes += len;
     }
     rt_mutex_release(&pipe->lock);
+#endif
 
     return read_bytes;
 }
@@ -397,6 +840,19 @@ rt_size_t rt_pipe_write  (rt_device_t device, rt_off_t pos, const void *buffer,
     if (count == 0) return 0;
 
     pbuf = (uint8_t*)buffer;
+#ifdef RT_PIPE_USING_LOCKFREE
+    rt_mutex_take(&(pipe->write_lock), RT_WAITING_FOREVER);
+
+    while (write_bytes < count)
+    {
+        rt_bool_t was_empty = RT_FALSE;
+        int len = pipe_fifo_put(pipe, &pbuf[write_bytes], count - write_bytes, &was_empty);
+        if (len <= 0) break;
+
+        write_bytes += len;
+    }
+    rt_mutex_release(&(pipe->write_lock));
+#else
     rt_mutex_take(&pipe->lock, -1);
 
     while (write_bytes < count)
@@ -407,6 +863,7 @@ rt_size_t rt_pipe_write  (rt_device_t device, rt_off_t pos, const void *buffer,
         write_bytes += len;
     }
     rt_mutex_release(&pipe->lock);
+#endif
 
     return write_bytes;
 }
@@ -439,6 +896,10 @@ rt_pipe_t *rt_pipe_create(const char *name, int bufsz)
     rt_memset(pipe, 0, sizeof(rt_pipe_t));
     pipe->is_named = RT_TRUE; /* initialize as a named pipe */
     rt_mutex_init(&(pipe->lock), name, RT_IPC_FLAG_FIFO);
+#ifdef RT_PIPE_USING_LOCKFREE
+    rt_mutex_init(&(pipe->read_lock), name, RT_IPC_FLAG_FIFO);
+    rt_mutex_init(&(pipe->write_lock), name, RT_IPC_FLAG_FIFO);
+#endif
     rt_wqueue_init(&(pipe->reader_queue));
     rt_wqueue_init(&(pipe->writer_queue));
 
@@ -493,14 +954,14 @@ int rt_pipe_delete(const char *name)
             pipe = (rt_pipe_t *)device;
 
             rt_mutex_detach(&(pipe->lock));
+#ifdef RT_PIPE_USING_LOCKFREE
+            rt_mutex_detach(&(pipe->read_lock));
+            rt_mutex_detach(&(pipe->write_lock));
+#endif
             rt_device_unregister(device);
 
             /* close fifo ringbuffer */
-            if (pipe->fifo) 
-            {
-                rt_ringbuffer_destroy(pipe->fifo);
-                pipe->fifo = RT_NULL;
-            }
+            pipe_fifo_destroy(pipe);
             rt_free(pipe);
         }
         else
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-08-03     tyx          the first version
+ * 2026-10-18     liujiahao    add the zero-copy frame transfer
  */
 
 #include <rthw.h>
@@ -574,6 +575,31 @@ rt_err_t rt_wlan_dev_report_data(struct rt_wlan_device *device, void *buff, int
 #endif
 }
 
+void *rt_wlan_dev_alloc_buff(struct rt_wlan_device *device, int len, void **data)
+{
+#ifdef RT_WLAN_PROT_ENABLE
+    return rt_wlan_dev_alloc_prot_buff(device, len, data);
+#else
+    return RT_NULL;
+#endif
+}
+
+rt_err_t rt_wlan_dev_report_buff(struct rt_wlan_device *device, void *buff, int len)
+{
+#ifdef RT_WLAN_PROT_ENABLE
+    return rt_wlan_dev_transfer_prot_buff(device, buff, len);
+#else
+    return -RT_ERROR;
+#endif
+}
+
+void rt_wlan_dev_free_buff(struct rt_wlan_device *device, void *buff)
+{
+#ifdef RT_WLAN_PROT_ENABLE
+    rt_wlan_dev_free_prot_buff(device, buff);
+#endif
+}
+
 static rt_err_t _rt_wlan_dev_init(rt_device_t dev)
 {
     struct rt_wlan_device *wlan = (struct rt_wlan_device *)dev;
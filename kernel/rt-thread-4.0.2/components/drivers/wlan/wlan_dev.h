@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-08-03     tyx          the first version
+ * 2026-10-18     liujiahao    add the zero-copy frame transfer
  */
 
 #ifndef __WLAN_DEVICE_H__
@@ -503,6 +504,11 @@ struct rt_wlan_dev_ops
     rt_err_t (*wlan_get_mac)(struct rt_wlan_device *wlan, rt_uint8_t mac[]);
     int (*wlan_recv)(struct rt_wlan_device *wlan, void *buff, int len);
     int (*wlan_send)(struct rt_wlan_device *wlan, void *buff, int len);
+    /* optional, send the frame of segments without copying them into one buffer.
+     * The segments may refer to the memory of application (PBUF_REF), which is
+     * reused once it returns, so the driver must finish reading or copy all of
+     * segments before it returns. */
+    int (*wlan_send_sg)(struct rt_wlan_device *wlan, const struct rt_wlan_buff *segs, int count);
 };
 
 /*
@@ -578,6 +584,16 @@ rt_country_code_t rt_wlan_dev_get_country(struct rt_wlan_device *device);
  * wlan device datat transfer interface
  */
 rt_err_t rt_wlan_dev_report_data(struct rt_wlan_device *device, void *buff, int len);
+
+/*
+ * wlan device zero-copy receive interface, the driver receives the frame into
+ * the data of the buffer lent by the protocol. RT_NULL is returned if the protocol
+ * doesn't lend buffer, then use rt_wlan_dev_report_data(). The buffer is still
+ * owned by the driver if it fails to report.
+ */
+void *rt_wlan_dev_alloc_buff(struct rt_wlan_device *device, int len, void **data);
+rt_err_t rt_wlan_dev_report_buff(struct rt_wlan_device *device, void *buff, int len);
+void rt_wlan_dev_free_buff(struct rt_wlan_device *device, void *buff);
 // void rt_wlan_dev_data_ready(struct rt_wlan_device *device, int len);
 
 /*
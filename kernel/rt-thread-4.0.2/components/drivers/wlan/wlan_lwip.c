@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-08-14     tyx          the first version
+ * 2026-10-18     liujiahao    queue the received frames for the Rx polling
+ * 2026-10-18     liujiahao    add the zero-copy frame transfer
  */
 
 #include <rthw.h>
@@ -42,6 +44,13 @@
 #define RT_WLAN_PROT_LWIP_NAME  ("lwip")
 #endif
 
+#ifndef RT_WLAN_PROT_LWIP_RX_QUEUE
+#define RT_WLAN_PROT_LWIP_RX_QUEUE  (16)
+#endif
+
+/* the maximum number of pbufs sent by wlan_send_sg, the longer chain is copied */
+#define WLAN_LWIP_SG_MAX            (8)
+
 struct lwip_prot_des
 {
     struct rt_wlan_prot prot;
@@ -49,6 +58,12 @@ struct lwip_prot_des
     rt_int8_t connected_flag;
     struct rt_timer timer;
     struct rt_work work;
+#ifdef ETHIF_RX_POLLING
+    /* the received frames polled by ethernet thread */
+    struct rt_mailbox rx_mb;
+    rt_ubase_t rx_mb_pool[RT_WLAN_PROT_LWIP_RX_QUEUE];
+    rt_uint32_t rx_drops;
+#endif
 };
 
 static void netif_is_ready(struct rt_work *work, void *parameter)
@@ -298,6 +313,54 @@ static rt_err_t rt_wlan_lwip_protocol_control(rt_device_t device, int cmd, void
     return err;
 }
 
+#ifdef ETHIF_RX_POLLING
+static struct pbuf *rt_wlan_lwip_protocol_rx(rt_device_t device)
+{
+    struct lwip_prot_des *lwip_prot = rt_container_of(device, struct lwip_prot_des, eth.parent);
+    struct pbuf *p = RT_NULL;
+
+    if (rt_mb_recv(&lwip_prot->rx_mb, (rt_ubase_t *)&p, 0) != RT_EOK)
+    {
+        return RT_NULL;
+    }
+    return p;
+}
+
+static rt_err_t rt_wlan_lwip_protocol_rx_irq(rt_device_t device, rt_bool_t enable)
+{
+    struct lwip_prot_des *lwip_prot = rt_container_of(device, struct lwip_prot_des, eth.parent);
+
+    /* the frame queued just before the polling is finished isn't notified */
+    if (enable && lwip_prot->rx_mb.entry > 0)
+    {
+        eth_device_ready(&lwip_prot->eth);
+    }
+    return RT_EOK;
+}
+#endif
+
+static rt_err_t rt_wlan_lwip_input(struct eth_device *eth_dev, struct pbuf *p)
+{
+#ifdef ETHIF_RX_POLLING
+    struct lwip_prot_des *lwip_prot = rt_container_of(eth_dev, struct lwip_prot_des, eth);
+
+    /* queue it and wake up ethernet thread only if it isn't polling */
+    if (rt_mb_send(&lwip_prot->rx_mb, (rt_ubase_t)p) != RT_EOK)
+    {
+        lwip_prot->rx_drops++;
+        return -RT_EFULL;
+    }
+    eth_device_ready(eth_dev);
+    return RT_EOK;
+#else
+    if ((eth_dev->netif->input(p, eth_dev->netif)) != ERR_OK)
+    {
+        return -RT_ERROR;
+    }
+    return RT_EOK;
+#endif
+}
+
 static rt_err_t rt_wlan_lwip_protocol_recv(struct rt_wlan_device *wlan, void *buff, int len)
 {
     struct eth_device *eth_dev = &((struct lwip_prot_des *)wlan->prot)->eth;
@@ -312,7 +375,7 @@ static rt_err_t rt_wlan_lwip_protocol_recv(struct rt_wlan_device *wlan, void *bu
 #ifdef RT_WLAN_PROT_LWIP_PBUF_FORCE
     {
         p = buff;
-        if ((eth_dev->netif->input(p, eth_dev->netif)) != ERR_OK)
+        if (rt_wlan_lwip_input(eth_dev, p) != RT_EOK)
         {
             return -RT_ERROR;
         }
@@ -345,11 +408,11 @@ static rt_err_t rt_wlan_lwip_protocol_recv(struct rt_wlan_device *wlan, void *bu
         }
         /*copy data dat -> pbuf*/
         pbuf_take(p, buff, len);
-        if ((eth_dev->netif->input(p, eth_dev->netif)) != ERR_OK)
+        if (rt_wlan_lwip_input(eth_dev, p) != RT_EOK)
         {
             LOG_D("F:%s L:%d IP input error", __FUNCTION__, __LINE__);
             pbuf_free(p);
-            p = RT_NULL;
+            return -RT_ERROR;
         }
         LOG_D("F:%s L:%d netif iput success! len:%d", __FUNCTION__, __LINE__, len);
         return RT_EOK;
@@ -357,6 +420,47 @@ static rt_err_t rt_wlan_lwip_protocol_recv(struct rt_wlan_device *wlan, void *bu
 #endif
 }
 
+static void *rt_wlan_lwip_protocol_alloc_buff(struct rt_wlan_device *wlan, int len, void **data)
+{
+    struct pbuf *p = RT_NULL;
+
+    /* the frame is received into one contiguous pbuf */
+    if (len <= PBUF_POOL_BUFSIZE)
+    {
+        p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+    }
+    if (p == RT_NULL)
+    {
+        p = pbuf_alloc(PBUF_RAW, len, PBUF_RAM);
+        if (p == RT_NULL)
+        {
+            return RT_NULL;
+        }
+    }
+
+    *data = p->payload;
+    return p;
+}
+
+static rt_err_t rt_wlan_lwip_protocol_recv_buff(struct rt_wlan_device *wlan, void *buff, int len)
+{
+    struct eth_device *eth_dev = &((struct lwip_prot_des *)wlan->prot)->eth;
+    struct pbuf *p = buff;
+
+    if (len <= 0 || len > p->tot_len)
+    {
+        return -RT_EINVAL;
+    }
+    pbuf_realloc(p, len);
+
+    return rt_wlan_lwip_input(eth_dev, p);
+}
+
+static void rt_wlan_lwip_protocol_free_buff(struct rt_wlan_device *wlan, void *buff)
+{
+    pbuf_free((struct pbuf *)buff);
+}
+
 static rt_err_t rt_wlan_lwip_protocol_send(rt_device_t device, struct pbuf *p)
 {
     struct rt_wlan_device *wlan = ((struct eth_device *)device)->parent.user_data;
@@ -385,6 +489,23 @@ static rt_err_t rt_wlan_lwip_protocol_send(rt_device_t device, struct pbuf *p)
             LOG_D("F:%s L:%d run len:%d", __FUNCTION__, __LINE__, p->tot_len);
             return RT_EOK;
         }
+        /* sending the segments directly */
+        if (wlan->ops->wlan_send_sg != RT_NULL && pbuf_clen(p) <= WLAN_LWIP_SG_MAX)
+        {
+            struct rt_wlan_buff segs[WLAN_LWIP_SG_MAX];
+            struct pbuf *q;
+            int count = 0;
+
+            for (q = p; q != RT_NULL; q = q->next)
+            {
+                segs[count].data = q->payload;
+                segs[count].len = q->len;
+                count++;
+            }
+            rt_wlan_prot_transfer_dev_sg(wlan, segs, count);
+            LOG_D("F:%s L:%d run len:%d seg:%d", __FUNCTION__, __LINE__, p->tot_len, count);
+            return RT_EOK;
+        }
         frame = rt_malloc(p->tot_len);
         if (frame == RT_NULL)
         {
@@ -472,13 +593,22 @@ static struct rt_wlan_prot *rt_wlan_lwip_protocol_register(struct rt_wlan_prot *
 #endif
 
     eth->parent.user_data  = wlan;
+#ifdef ETHIF_RX_POLLING
+    rt_mb_init(&lwip_prot->rx_mb, "wlan_rx", lwip_prot->rx_mb_pool, RT_WLAN_PROT_LWIP_RX_QUEUE, RT_IPC_FLAG_FIFO);
+    eth->eth_rx     = rt_wlan_lwip_protocol_rx;
+    eth->eth_rx_irq = rt_wlan_lwip_protocol_rx_irq;
+#else
     eth->eth_rx     = RT_NULL;
+#endif
     eth->eth_tx     = rt_wlan_lwip_protocol_send;
 
     /* register ETH device */
     if (eth_device_init(eth, eth_name) != RT_EOK)
     {
         LOG_E("eth device init failed");
+#ifdef ETHIF_RX_POLLING
+        rt_mb_detach(&lwip_prot->rx_mb);
+#endif
         rt_device_close((rt_device_t)wlan);
         rt_free(lwip_prot);
         return RT_NULL;
@@ -516,6 +646,17 @@ static void rt_wlan_lwip_protocol_unregister(struct rt_wlan_prot *prot, struct r
     }
 #endif
     eth_device_deinit(&lwip_prot->eth);
+#ifdef ETHIF_RX_POLLING
+    {
+        struct pbuf *p;
+
+        while (rt_mb_recv(&lwip_prot->rx_mb, (rt_ubase_t *)&p, 0) == RT_EOK)
+        {
+            pbuf_free(p);
+        }
+        rt_mb_detach(&lwip_prot->rx_mb);
+    }
+#endif
     rt_device_close((rt_device_t)wlan);
     rt_timer_detach(&lwip_prot->timer);
     wlan->netdev = RT_NULL;
@@ -527,7 +668,10 @@ static struct rt_wlan_prot_ops ops =
 {
     rt_wlan_lwip_protocol_recv,
     rt_wlan_lwip_protocol_register,
-    rt_wlan_lwip_protocol_unregister
+    rt_wlan_lwip_protocol_unregister,
+    rt_wlan_lwip_protocol_alloc_buff,
+    rt_wlan_lwip_protocol_recv_buff,
+    rt_wlan_lwip_protocol_free_buff
 };
 
 int rt_wlan_lwip_init(void)
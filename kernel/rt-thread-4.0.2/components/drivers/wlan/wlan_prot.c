@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-08-14     tyx          the first version
+ * 2026-10-18     liujiahao    add the zero-copy frame transfer
  */
 
 #include <rthw.h>
@@ -329,6 +330,15 @@ rt_err_t rt_wlan_prot_transfer_dev(struct rt_wlan_device *wlan, void *buff, int
     return -RT_ERROR;
 }
 
+rt_err_t rt_wlan_prot_transfer_dev_sg(struct rt_wlan_device *wlan, const struct rt_wlan_buff *segs, int count)
+{
+    if (wlan->ops->wlan_send_sg != RT_NULL)
+    {
+        return wlan->ops->wlan_send_sg(wlan, segs, count);
+    }
+    return -RT_ENOSYS;
+}
+
 rt_err_t rt_wlan_dev_transfer_prot(struct rt_wlan_device *wlan, void *buff, int len)
 {
     struct rt_wlan_prot *prot = wlan->prot;
@@ -340,6 +350,38 @@ rt_err_t rt_wlan_dev_transfer_prot(struct rt_wlan_device *wlan, void *buff, int
     return -RT_ERROR;
 }
 
+void *rt_wlan_dev_alloc_prot_buff(struct rt_wlan_device *wlan, int len, void **data)
+{
+    struct rt_wlan_prot *prot = wlan->prot;
+
+    if ((prot != RT_NULL) && (prot->ops->prot_alloc_buff != RT_NULL))
+    {
+        return prot->ops->prot_alloc_buff(wlan, len, data);
+    }
+    return RT_NULL;
+}
+
+rt_err_t rt_wlan_dev_transfer_prot_buff(struct rt_wlan_device *wlan, void *buff, int len)
+{
+    struct rt_wlan_prot *prot = wlan->prot;
+
+    if ((prot != RT_NULL) && (prot->ops->prot_recv_buff != RT_NULL))
+    {
+        return prot->ops->prot_recv_buff(wlan, buff, len);
+    }
+    return -RT_ERROR;
+}
+
+void rt_wlan_dev_free_prot_buff(struct rt_wlan_device *wlan, void *buff)
+{
+    struct rt_wlan_prot *prot = wlan->prot;
+
+    if ((prot != RT_NULL) && (prot->ops->prot_free_buff != RT_NULL))
+    {
+        prot->ops->prot_free_buff(wlan, buff);
+    }
+}
+
 extern int rt_wlan_prot_ready_event(struct rt_wlan_device *wlan, struct rt_wlan_buff *buff);
 int rt_wlan_prot_ready(struct rt_wlan_device *wlan, struct rt_wlan_buff *buff)
 {
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-08-14     tyx          the first version
+ * 2026-10-18     liujiahao    add the zero-copy frame transfer
  */
 
 #ifndef __WLAN_PROT_H__
@@ -43,6 +44,10 @@ struct rt_wlan_prot_ops
     rt_err_t (*prot_recv)(struct rt_wlan_device *wlan, void *buff, int len);
     struct rt_wlan_prot *(*dev_reg_callback)(struct rt_wlan_prot *prot, struct rt_wlan_device *wlan);
     void (*dev_unreg_callback)(struct rt_wlan_prot *prot, struct rt_wlan_device *wlan);
+    /* optional, lend the buffer which the driver receives the frame into */
+    void *(*prot_alloc_buff)(struct rt_wlan_device *wlan, int len, void **data);
+    rt_err_t (*prot_recv_buff)(struct rt_wlan_device *wlan, void *buff, int len);
+    void (*prot_free_buff)(struct rt_wlan_device *wlan, void *buff);
 };
 
 struct rt_wlan_prot
@@ -66,8 +71,16 @@ rt_err_t rt_wlan_prot_regisetr(struct rt_wlan_prot *prot);
 
 rt_err_t rt_wlan_prot_transfer_dev(struct rt_wlan_device *wlan, void *buff, int len);
 
+rt_err_t rt_wlan_prot_transfer_dev_sg(struct rt_wlan_device *wlan, const struct rt_wlan_buff *segs, int count);
+
 rt_err_t rt_wlan_dev_transfer_prot(struct rt_wlan_device *wlan, void *buff, int len);
 
+void *rt_wlan_dev_alloc_prot_buff(struct rt_wlan_device *wlan, int len, void **data);
+
+rt_err_t rt_wlan_dev_transfer_prot_buff(struct rt_wlan_device *wlan, void *buff, int len);
+
+void rt_wlan_dev_free_prot_buff(struct rt_wlan_device *wlan, void *buff);
+
 rt_err_t rt_wlan_prot_event_register(struct rt_wlan_prot *prot, rt_wlan_prot_event_t event, rt_wlan_prot_event_handler handler);
 
 rt_err_t rt_wlan_prot_event_unregister(struct rt_wlan_prot *prot, rt_wlan_prot_event_t event);
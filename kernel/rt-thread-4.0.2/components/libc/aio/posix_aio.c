@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2017/12/30     Bernard      The first version.
+ * 2026/10/18     liujiahao    Implement aio_suspend, fix the buffer and offset of
+ *                             read/write work.
  */
 
 #include <stdint.h>
@@ -20,6 +22,15 @@
 #include "posix_aio.h"
 
 struct rt_workqueue* aio_queue = NULL;
+static rt_wqueue_t aio_wait_queue;
+
+struct aio_suspend_node
+{
+    struct rt_wqueue_node wqn;
+    const struct aiocb *const *list;
+    int nent;
+    int triggered;
+};
 
 /**
  * The aio_cancel() function shall attempt to cancel one or more asynchronous I/O 
@@ -163,16 +174,19 @@ static void aio_read_work(struct rt_work* work, void* work_data)
 
     /* seek to offset */
     lseek(cb->aio_fildes, cb->aio_offset, SEEK_SET);
-    len = read(cb->aio_fildes, &buf_ptr[cb->aio_offset], cb->aio_nbytes);
+    len = read(cb->aio_fildes, buf_ptr, cb->aio_nbytes);
 
     /* modify result */
     level = rt_hw_interrupt_disable();
-    if (len <= 0)
+    if (len < 0)
         cb->aio_result = errno;
     else 
         cb->aio_result = len;
     rt_hw_interrupt_enable(level);
 
+    /* wake up the thread in aio_suspend */
+    rt_wqueue_wakeup(&aio_wait_queue, cb);
+
     return ;
 }
 
@@ -287,10 +301,99 @@ ssize_t  aio_return(struct aiocb *cb)
  * passes before any of the I/O operations referenced by list are completed, then 
  * aio_suspend() shall return with an error.
  */
+static int aio_suspend_completed(const struct aiocb *const list[], int nent)
+{
+    int index;
+
+    for (index = 0; index < nent; index ++)
+    {
+        if (list[index] && list[index]->aio_result != -EINPROGRESS)
+            return 1;
+    }
+
+    return 0;
+}
+
+static int aio_suspend_wake(struct rt_wqueue_node *wait, void *key)
+{
+    struct aio_suspend_node *node;
+    int index;
+
+    node = rt_container_of(wait, struct aio_suspend_node, wqn);
+    for (index = 0; index < node->nent; index ++)
+    {
+        if (node->list[index] == key)
+        {
+            node->triggered = 1;
+            return __wqueue_default_wake(wait, key);
+        }
+    }
+
+    return -1;
+}
+
 int aio_suspend(const struct aiocb *const list[], int nent,
              const struct timespec *timeout)
 {
-    return -ENOSYS;
+    struct aio_suspend_node node;
+    rt_thread_t thread;
+    rt_int32_t tick = RT_WAITING_FOREVER;
+    rt_base_t level;
+
+    if (list == NULL || nent <= 0)
+    {
+        errno = -EINVAL;
+        return -1;
+    }
+
+    if (timeout)
+    {
+        tick = timeout->tv_sec * RT_TICK_PER_SECOND;
+        tick += ((rt_int64_t)timeout->tv_nsec * RT_TICK_PER_SECOND) / 1000000000;
+    }
+
+    thread = rt_thread_self();
+    node.wqn.key = 0;
+    node.wqn.polling_thread = thread;
+    node.wqn.wakeup = aio_suspend_wake;
+    rt_list_init(&(node.wqn.list));
+    node.list = list;
+    node.nent = nent;
+    node.triggered = 0;
+
+    level = rt_hw_interrupt_disable();
+    if (aio_suspend_completed(list, nent))
+    {
+        rt_hw_interrupt_enable(level);
+        return 0;
+    }
+
+    if (tick != 0)
+    {
+        rt_wqueue_add(&aio_wait_queue, &(node.wqn));
+        rt_thread_suspend(thread);
+        if (tick > 0)
+        {
+            rt_timer_control(&(thread->thread_timer),
+                             RT_TIMER_CTRL_SET_TIME,
+                             &tick);
+            rt_timer_start(&(thread->thread_timer));
+        }
+
+        rt_hw_interrupt_enable(level);
+
+        rt_schedule();
+
+        level = rt_hw_interrupt_disable();
+        rt_wqueue_remove(&(node.wqn));
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (node.triggered || aio_suspend_completed(list, nent))
+        return 0;
+
+    errno = -EAGAIN;
+    return -1;
 }
 
 static void aio_write_work(struct rt_work* work, void* work_data)
@@ -305,7 +408,7 @@ static void aio_write_work(struct rt_work* work, void* work_data)
     oflags = fcntl(cb->aio_fildes, F_GETFL, 0);
     if ((oflags & O_APPEND) == 0)
     {
-        lseek(cb->aio_fildes, SEEK_SET, cb->aio_offset);
+        lseek(cb->aio_fildes, cb->aio_offset, SEEK_SET);
     }
 
     /* write data */
@@ -313,12 +416,15 @@ static void aio_write_work(struct rt_work* work, void* work_data)
 
     /* modify result */
     level = rt_hw_interrupt_disable();
-    if (len <= 0)
+    if (len < 0)
         cb->aio_result = errno;
     else 
         cb->aio_result = len;
     rt_hw_interrupt_enable(level);
 
+    /* wake up the thread in aio_suspend */
+    rt_wqueue_wakeup(&aio_wait_queue, cb);
+
     return;
 }
 
@@ -370,7 +476,7 @@ int aio_write(struct aiocb *cb)
 
     /* check access mode */
     oflags = fcntl(cb->aio_fildes, F_GETFL, 0);
-    if ((oflags & O_ACCMODE) != O_WRONLY ||
+    if ((oflags & O_ACCMODE) != O_WRONLY &&
         (oflags & O_ACCMODE) != O_RDWR)
         return -EINVAL;
 
@@ -460,6 +566,8 @@ int aio_system_init(void)
     aio_queue = rt_workqueue_create("aio", 2048, RT_THREAD_PRIORITY_MAX/2);
     RT_ASSERT(aio_queue != NULL);
 
+    rt_wqueue_init(&aio_wait_queue);
+
     return 0;
 }
 INIT_COMPONENT_EXPORT(aio_system_init);
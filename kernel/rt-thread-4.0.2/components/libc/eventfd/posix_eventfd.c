@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include <dfs_file.h>
+#include <dfs_poll.h>
+
+#include "posix_eventfd.h"
+
+#define EVENTFD_COUNT_MAX   ((eventfd_t)0xfffffffffffffffeULL)
+
+struct eventfd_ctx
+{
+    eventfd_t count;
+    int flags;
+
+    rt_wqueue_t reader_queue;
+    rt_wqueue_t writer_queue;
+};
+
+static int eventfd_fops_close(struct dfs_fd *fd)
+{
+    struct eventfd_ctx *ctx = (struct eventfd_ctx *)fd->data;
+
+    rt_free(ctx);
+    fd->data = RT_NULL;
+
+    return 0;
+}
+
+static int eventfd_fops_ioctl(struct dfs_fd *fd, int cmd, void *args)
+{
+    switch (cmd)
+    {
+    case F_GETFL:
+        return fd->flags;
+    case F_SETFL:
+        fd->flags &= ~O_NONBLOCK;
+        fd->flags |= (int)(rt_base_t)args & O_NONBLOCK;
+        return 0;
+    case FIONREAD:
+        *((int*)args) = sizeof(eventfd_t);
+        return 0;
+    }
+
+    return -EINVAL;
+}
+
+static int eventfd_fops_read(struct dfs_fd *fd, void *buf, size_t count)
+{
+    struct eventfd_ctx *ctx = (struct eventfd_ctx *)fd->data;
+    rt_base_t level;
+    eventfd_t value;
+
+    if (count < sizeof(eventfd_t))
+        return -EINVAL;
+
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        if (ctx->count != 0)
+            break;
+        rt_hw_interrupt_enable(level);
+
+        if (fd->flags & O_NONBLOCK)
+            return -EAGAIN;
+
+        rt_wqueue_wait(&(ctx->reader_queue), 0, -1);
+    }
+
+    value = (ctx->flags & EFD_SEMAPHORE) ? 1 : ctx->count;
+    ctx->count -= value;
+    rt_hw_interrupt_enable(level);
+
+    rt_memcpy(buf, &value, sizeof(eventfd_t));
+
+    /* only one waiter is woken up each time, pass on to the next one */
+    if (ctx->count != 0)
+        rt_wqueue_wakeup(&(ctx->reader_queue), (void*)POLLIN);
+    rt_wqueue_wakeup(&(ctx->writer_queue), (void*)POLLOUT);
+
+    return sizeof(eventfd_t);
+}
+
+static int eventfd_fops_write(struct dfs_fd *fd, const void *buf, size_t count)
+{
+    struct eventfd_ctx *ctx = (struct eventfd_ctx *)fd->data;
+    rt_base_t level;
+    eventfd_t value;
+
+    if (count < sizeof(eventfd_t))
+        return -EINVAL;
+
+    rt_memcpy(&value, buf, sizeof(eventfd_t));
+    if (value > EVENTFD_COUNT_MAX)
+        return -EINVAL;
+
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        if (EVENTFD_COUNT_MAX - ctx->count >= value)
+            break;
+        rt_hw_interrupt_enable(level);
+
+        if (fd->flags & O_NONBLOCK)
+            return -EAGAIN;
+
+        rt_wqueue_wait(&(ctx->writer_queue), 0, -1);
+    }
+
+    ctx->count += value;
+    rt_hw_interrupt_enable(level);
+
+    if (value != 0)
+        rt_wqueue_wakeup(&(ctx->reader_queue), (void*)POLLIN);
+
+    return sizeof(eventfd_t);
+}
+
+static int eventfd_fops_poll(struct dfs_fd *fd, rt_pollreq_t *req)
+{
+    struct eventfd_ctx *ctx = (struct eventfd_ctx *)fd->data;
+    int mask = 0;
+
+    rt_poll_add(&(ctx->reader_queue), req);
+    rt_poll_add(&(ctx->writer_queue), req);
+
+    if (ctx->count != 0)
+        mask |= POLLIN;
+    if (ctx->count < EVENTFD_COUNT_MAX)
+        mask |= POLLOUT;
+
+    return mask;
+}
+
+static const struct dfs_file_ops eventfd_fops =
+{
+    RT_NULL,
+    eventfd_fops_close,
+    eventfd_fops_ioctl,
+    eventfd_fops_read,
+    eventfd_fops_write,
+    RT_NULL, /* flush */
+    RT_NULL, /* lseek */
+    RT_NULL, /* getdents */
+    eventfd_fops_poll,
+};
+
+/**
+ * This function will create an event notification file descriptor, it holds a
+ * 64-bit counter which is added by write and taken by read. The descriptor can
+ * be waited by poll/select together with the sockets and devices.
+ *
+ * @param count the initial value of counter.
+ * @param flags EFD_SEMAPHORE, EFD_NONBLOCK and EFD_CLOEXEC.
+ *
+ * @return the file descriptor, or -1 on failed.
+ */
+int eventfd(unsigned int count, int flags)
+{
+    struct eventfd_ctx *ctx;
+    struct dfs_fd *d;
+    int fd;
+
+    if (flags & ~(EFD_SEMAPHORE | EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    ctx = (struct eventfd_ctx *)rt_malloc(sizeof(struct eventfd_ctx));
+    if (ctx == RT_NULL)
+    {
+        rt_set_errno(-ENOMEM);
+        return -1;
+    }
+    ctx->count = count;
+    ctx->flags = flags;
+    rt_wqueue_init(&(ctx->reader_queue));
+    rt_wqueue_init(&(ctx->writer_queue));
+
+    /* allocate a fd */
+    fd = fd_new();
+    if (fd < 0)
+    {
+        rt_free(ctx);
+        rt_set_errno(-ENOMEM);
+        return -1;
+    }
+
+    d = fd_get(fd);
+    d->type = FT_USER;
+    d->path = RT_NULL;
+    d->fops = &eventfd_fops;
+    d->flags = O_RDWR | (flags & EFD_NONBLOCK);
+    d->size = 0;
+    d->pos = 0;
+    d->data = ctx;
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    return fd;
+}
+RTM_EXPORT(eventfd);
+
+int eventfd_read(int fd, eventfd_t *value)
+{
+    return read(fd, value, sizeof(eventfd_t)) == sizeof(eventfd_t) ? 0 : -1;
+}
+RTM_EXPORT(eventfd_read);
+
+int eventfd_write(int fd, eventfd_t value)
+{
+    return write(fd, &value, sizeof(eventfd_t)) == sizeof(eventfd_t) ? 0 : -1;
+}
+RTM_EXPORT(eventfd_write);
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#ifndef POSIX_EVENTFD_H__
+#define POSIX_EVENTFD_H__
+
+#include <rtthread.h>
+#include <dfs_posix.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EFD_SEMAPHORE   (1 << 0)
+#define EFD_NONBLOCK    O_NONBLOCK
+#ifdef O_CLOEXEC
+#define EFD_CLOEXEC     O_CLOEXEC
+#else
+#define EFD_CLOEXEC     02000000
+#endif
+
+typedef rt_uint64_t eventfd_t;
+
+int eventfd(unsigned int count, int flags);
+int eventfd_read(int fd, eventfd_t *value);
+int eventfd_write(int fd, eventfd_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
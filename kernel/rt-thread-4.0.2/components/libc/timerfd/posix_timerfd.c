@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#include <time.h>
+#include <dfs_file.h>
+#include <dfs_poll.h>
+
+#include "posix_timerfd.h"
+
+#define TIMERFD_DELAY_MAX   (RT_TICK_MAX / 2 - 1)
+
+struct timerfd_ctx
+{
+    struct rt_timer timer;
+    int clockid;
+
+    rt_bool_t armed;
+    rt_tick_t expire;               /* the tick of next expiration */
+    rt_tick_t interval;
+    rt_uint64_t expirations;        /* the expirations since last read */
+
+    rt_wqueue_t reader_queue;
+};
+
+static rt_tick_t timespec_to_tick(const struct timespec *ts)
+{
+    rt_uint64_t tick;
+
+    tick = (rt_uint64_t)ts->tv_sec * RT_TICK_PER_SECOND;
+    /* round up, the timer never expires early */
+    tick += ((rt_uint64_t)ts->tv_nsec * RT_TICK_PER_SECOND + 999999999UL) / 1000000000UL;
+    if (tick > TIMERFD_DELAY_MAX)
+        tick = TIMERFD_DELAY_MAX;
+
+    return (rt_tick_t)tick;
+}
+
+static void tick_to_timespec(rt_tick_t tick, struct timespec *ts)
+{
+    ts->tv_sec = tick / RT_TICK_PER_SECOND;
+    ts->tv_nsec = (long)((rt_uint64_t)(tick % RT_TICK_PER_SECOND) * 1000000000UL / RT_TICK_PER_SECOND);
+}
+
+/* the timer is always periodic, the period is set to the next expiration in the
+ * timeout function, so the interval doesn't drift with the timer latency */
+static void timerfd_timeout(void *parameter)
+{
+    struct timerfd_ctx *ctx = (struct timerfd_ctx *)parameter;
+    rt_tick_t now, delay;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    now = rt_tick_get();
+
+    if ((rt_int32_t)(now - ctx->expire) < 0)
+    {
+        /* the delay is longer than the max timer tick */
+        delay = ctx->expire - now;
+        if (delay > TIMERFD_DELAY_MAX)
+            delay = TIMERFD_DELAY_MAX;
+        rt_timer_control(&(ctx->timer), RT_TIMER_CTRL_SET_TIME, &delay);
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+    if (ctx->interval == 0)
+    {
+        ctx->expirations ++;
+        ctx->armed = RT_FALSE;
+        rt_timer_control(&(ctx->timer), RT_TIMER_CTRL_SET_ONESHOT, RT_NULL);
+    }
+    else
+    {
+        rt_uint32_t overrun = (now - ctx->expire) / ctx->interval + 1;
+
+        ctx->expirations += overrun;
+        ctx->expire += overrun * ctx->interval;
+        delay = ctx->expire - now;
+        rt_timer_control(&(ctx->timer), RT_TIMER_CTRL_SET_TIME, &delay);
+    }
+    rt_hw_interrupt_enable(level);
+
+    rt_wqueue_wakeup(&(ctx->reader_queue), (void*)POLLIN);
+}
+
+static int timerfd_fops_close(struct dfs_fd *fd)
+{
+    struct timerfd_ctx *ctx = (struct timerfd_ctx *)fd->data;
+
+    rt_timer_detach(&(ctx->timer));
+    rt_free(ctx);
+    fd->data = RT_NULL;
+
+    return 0;
+}
+
+static int timerfd_fops_ioctl(struct dfs_fd *fd, int cmd, void *args)
+{
+    switch (cmd)
+    {
+    case F_GETFL:
+        return fd->flags;
+    case F_SETFL:
+        fd->flags &= ~O_NONBLOCK;
+        fd->flags |= (int)(rt_base_t)args & O_NONBLOCK;
+        return 0;
+    }
+
+    return -EINVAL;
+}
+
+static int timerfd_fops_read(struct dfs_fd *fd, void *buf, size_t count)
+{
+    struct timerfd_ctx *ctx = (struct timerfd_ctx *)fd->data;
+    rt_uint64_t value;
+    rt_base_t level;
+
+    if (count < sizeof(rt_uint64_t))
+        return -EINVAL;
+
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        if (ctx->expirations != 0)
+            break;
+        rt_hw_interrupt_enable(level);
+
+        if (fd->flags & O_NONBLOCK)
+            return -EAGAIN;
+
+        rt_wqueue_wait(&(ctx->reader_queue), 0, -1);
+    }
+
+    value = ctx->expirations;
+    ctx->expirations = 0;
+    rt_hw_interrupt_enable(level);
+
+    rt_memcpy(buf, &value, sizeof(rt_uint64_t));
+
+    return sizeof(rt_uint64_t);
+}
+
+static int timerfd_fops_poll(struct dfs_fd *fd, rt_pollreq_t *req)
+{
+    struct timerfd_ctx *ctx = (struct timerfd_ctx *)fd->data;
+    int mask = 0;
+
+    rt_poll_add(&(ctx->reader_queue), req);
+
+    if (ctx->expirations != 0)
+        mask |= POLLIN;
+
+    return mask;
+}
+
+static const struct dfs_file_ops timerfd_fops =
+{
+    RT_NULL,
+    timerfd_fops_close,
+    timerfd_fops_ioctl,
+    timerfd_fops_read,
+    RT_NULL, /* write */
+    RT_NULL, /* flush */
+    RT_NULL, /* lseek */
+    RT_NULL, /* getdents */
+    timerfd_fops_poll,
+};
+
+static struct timerfd_ctx *timerfd_get(int fd, struct dfs_fd **d)
+{
+    *d = fd_get(fd);
+    if (*d == RT_NULL)
+    {
+        rt_set_errno(-EBADF);
+        return RT_NULL;
+    }
+
+    if ((*d)->fops != &timerfd_fops)
+    {
+        fd_put(*d);
+        rt_set_errno(-EINVAL);
+        return RT_NULL;
+    }
+
+    return (struct timerfd_ctx *)(*d)->data;
+}
+
+static void timerfd_current(struct timerfd_ctx *ctx, struct itimerspec *value)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    tick_to_timespec(ctx->interval, &(value->it_interval));
+    if (ctx->armed)
+    {
+        rt_tick_t now = rt_tick_get();
+
+        tick_to_timespec((rt_int32_t)(ctx->expire - now) > 0 ? ctx->expire - now : 0,
+                         &(value->it_value));
+    }
+    else
+    {
+        value->it_value.tv_sec = 0;
+        value->it_value.tv_nsec = 0;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will create a timer file descriptor, the read of it returns the
+ * number of expirations since the last read, and it becomes readable for
+ * poll/select when the timer expires.
+ *
+ * @param clockid CLOCK_MONOTONIC or CLOCK_REALTIME, both of them are counted
+ *                by the system tick.
+ * @param flags TFD_NONBLOCK and TFD_CLOEXEC.
+ *
+ * @return the file descriptor, or -1 on failed.
+ */
+int timerfd_create(int clockid, int flags)
+{
+    struct timerfd_ctx *ctx;
+    struct dfs_fd *d;
+    int fd;
+
+    if ((clockid != CLOCK_MONOTONIC && clockid != CLOCK_REALTIME) ||
+        (flags & ~(TFD_NONBLOCK | TFD_CLOEXEC)))
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    ctx = (struct timerfd_ctx *)rt_calloc(1, sizeof(struct timerfd_ctx));
+    if (ctx == RT_NULL)
+    {
+        rt_set_errno(-ENOMEM);
+        return -1;
+    }
+    ctx->clockid = clockid;
+    rt_wqueue_init(&(ctx->reader_queue));
+    rt_timer_init(&(ctx->timer), "tfd", timerfd_timeout, ctx, 1, RT_TIMER_FLAG_PERIODIC);
+
+    /* allocate a fd */
+    fd = fd_new();
+    if (fd < 0)
+    {
+        rt_timer_detach(&(ctx->timer));
+        rt_free(ctx);
+        rt_set_errno(-ENOMEM);
+        return -1;
+    }
+
+    d = fd_get(fd);
+    d->type = FT_USER;
+    d->path = RT_NULL;
+    d->fops = &timerfd_fops;
+    d->flags = O_RDONLY | (flags & TFD_NONBLOCK);
+    d->size = 0;
+    d->pos = 0;
+    d->data = ctx;
+
+    /* release the ref-count of fd */
+    fd_put(d);
+
+    return fd;
+}
+RTM_EXPORT(timerfd_create);
+
+/**
+ * This function will arm or disarm the timer of a timer file descriptor.
+ *
+ * @param fd the timer file descriptor.
+ * @param flags TFD_TIMER_ABSTIME: the it_value is an absolute time of the clock,
+ *              the time of CLOCK_MONOTONIC is the time since boot.
+ * @param new_value the initial expiration and the interval, the timer is
+ *                  disarmed if the it_value is zero.
+ * @param old_value the setting before, it can be RT_NULL.
+ *
+ * @return 0 on successful, -1 on failed.
+ */
+int timerfd_settime(int fd, int flags, const struct itimerspec *new_value,
+                    struct itimerspec *old_value)
+{
+    struct timerfd_ctx *ctx;
+    struct dfs_fd *d;
+    rt_tick_t now, delay = 0;
+    rt_base_t level;
+
+    if (new_value == RT_NULL ||
+        new_value->it_value.tv_nsec < 0 || new_value->it_value.tv_nsec >= 1000000000L ||
+        new_value->it_interval.tv_nsec < 0 || new_value->it_interval.tv_nsec >= 1000000000L)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    ctx = timerfd_get(fd, &d);
+    if (ctx == RT_NULL)
+        return -1;
+
+    if (old_value)
+        timerfd_current(ctx, old_value);
+
+    rt_timer_stop(&(ctx->timer));
+
+    level = rt_hw_interrupt_disable();
+    now = rt_tick_get();
+    ctx->armed = RT_FALSE;
+    ctx->expirations = 0;
+    ctx->interval = timespec_to_tick(&(new_value->it_interval));
+
+    if (new_value->it_value.tv_sec != 0 || new_value->it_value.tv_nsec != 0)
+    {
+        if (!(flags & TFD_TIMER_ABSTIME))
+        {
+            delay = timespec_to_tick(&(new_value->it_value));
+        }
+        else if (ctx->clockid == CLOCK_MONOTONIC)
+        {
+            rt_tick_t target = timespec_to_tick(&(new_value->it_value));
+
+            delay = (rt_int32_t)(target - now) > 0 ? target - now : 0;
+        }
+        else
+        {
+            struct timespec ts;
+            time_t current = time(RT_NULL);
+
+            ts.tv_sec = new_value->it_value.tv_sec > current ? new_value->it_value.tv_sec - current : 0;
+            ts.tv_nsec = new_value->it_value.tv_sec >= current ? new_value->it_value.tv_nsec : 0;
+            delay = timespec_to_tick(&ts);
+        }
+
+        /* the expired time expires at the next tick */
+        if (delay == 0)
+            delay = 1;
+
+        ctx->armed = RT_TRUE;
+        ctx->expire = now + delay;
+        rt_timer_control(&(ctx->timer), RT_TIMER_CTRL_SET_TIME, &delay);
+        rt_timer_control(&(ctx->timer), RT_TIMER_CTRL_SET_PERIODIC, RT_NULL);
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (ctx->armed)
+        rt_timer_start(&(ctx->timer));
+
+    fd_put(d);
+
+    return 0;
+}
+RTM_EXPORT(timerfd_settime);
+
+/**
+ * This function will get the time until the next expiration and the interval of
+ * a timer file descriptor.
+ *
+ * @param fd the timer file descriptor.
+ * @param curr_value the current setting.
+ *
+ * @return 0 on successful, -1 on failed.
+ */
+int timerfd_gettime(int fd, struct itimerspec *curr_value)
+{
+    struct timerfd_ctx *ctx;
+    struct dfs_fd *d;
+
+    if (curr_value == RT_NULL)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    ctx = timerfd_get(fd, &d);
+    if (ctx == RT_NULL)
+        return -1;
+
+    timerfd_current(ctx, curr_value);
+    fd_put(d);
+
+    return 0;
+}
+RTM_EXPORT(timerfd_gettime);
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#ifndef POSIX_TIMERFD_H__
+#define POSIX_TIMERFD_H__
+
+#include <rtthread.h>
+#include <dfs_posix.h>
+#include <sys/time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CLOCK_REALTIME
+#define CLOCK_REALTIME      1
+#endif
+#ifndef CLOCK_MONOTONIC
+#define CLOCK_MONOTONIC     4
+#endif
+
+#define TFD_TIMER_ABSTIME   (1 << 0)
+#define TFD_NONBLOCK        O_NONBLOCK
+#ifdef O_CLOEXEC
+#define TFD_CLOEXEC         O_CLOEXEC
+#else
+#define TFD_CLOEXEC         02000000
+#endif
+
+#ifndef RT_USING_NEWLIB
+#ifndef _ITIMERSPEC_DEFINED
+#define _ITIMERSPEC_DEFINED
+struct itimerspec
+{
+    struct timespec it_interval;    /* timer period */
+    struct timespec it_value;       /* timer expiration */
+};
+#endif
+#endif
+
+int timerfd_create(int clockid, int flags);
+int timerfd_settime(int fd, int flags, const struct itimerspec *new_value,
+                    struct itimerspec *old_value);
+int timerfd_gettime(int fd, struct itimerspec *curr_value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
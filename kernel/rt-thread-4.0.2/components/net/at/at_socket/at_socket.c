@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-06-06     chenyong     first version
+ * 2026-10-18     liujiahao    socket table, receive ring buffer and send window
  */
 
 #include <at.h>
@@ -36,7 +37,7 @@
         ((unsigned char *)&addr)[2], \
         ((unsigned char *)&addr)[3]
 
-/* The maximum number of sockets structure */
+/* The maximum number of sockets structure of all AT devices */
 #ifndef AT_SOCKETS_NUM
 #define AT_SOCKETS_NUM       AT_DEVICE_SOCKETS_NUM
 #endif
@@ -48,149 +49,25 @@ typedef enum {
 } at_event_t;
 
 
-/* the global of sockets list */
-static rt_slist_t _socket_list = RT_SLIST_OBJECT_INIT(_socket_list);
+/* the sockets indexed by the socket descriptor */
+static struct at_socket *_socket_table[AT_SOCKETS_NUM];
 
 struct at_socket *at_get_socket(int socket)
 {
-    rt_base_t level;
-    rt_slist_t *node = RT_NULL;
     struct at_socket *at_sock = RT_NULL;
 
-    level = rt_hw_interrupt_disable();
-
-    rt_slist_for_each(node, &_socket_list)
-    {
-        at_sock = rt_slist_entry(node, struct at_socket, list);
-        if (socket == at_sock->socket)
-        {
-            if (at_sock && at_sock->magic == AT_SOCKET_MAGIC)
-            {
-                rt_hw_interrupt_enable(level);
-                return at_sock;
-            }
-        }
-    } 
-    
-    rt_hw_interrupt_enable(level);
-
-    return RT_NULL;
-}
-
-/* get a block to the AT socket receive list*/
-static size_t at_recvpkt_put(rt_slist_t *rlist, const char *ptr, size_t length)
-{
-    at_recv_pkt_t pkt = RT_NULL;
-
-    pkt = (at_recv_pkt_t) rt_calloc(1, sizeof(struct at_recv_pkt));
-    if (pkt == RT_NULL)
-    {
-        LOG_E("No memory for receive packet table!");
-        return 0;
-    }
-
-    pkt->bfsz_totle = length;
-    pkt->bfsz_index = 0;
-    pkt->buff = (char *) ptr;
-
-    rt_slist_append(rlist, &pkt->list);
-
-    return length;
-}
-
-/* delete and free all receive buffer list */
-static int at_recvpkt_all_delete(rt_slist_t *rlist)
-{
-    at_recv_pkt_t pkt = RT_NULL;
-    rt_slist_t *node = RT_NULL;
-
-    if (rt_slist_isempty(rlist))
-    {
-        return 0;
-    }
-
-    for(node = rt_slist_first(rlist); node; node = rt_slist_next(node))
-    {
-        pkt = rt_slist_entry(node, struct at_recv_pkt, list);
-        if (pkt->buff)
-        {
-            rt_free(pkt->buff);
-        }
-        if (pkt)
-        {
-            rt_free(pkt);
-            pkt = RT_NULL;
-        }
-    }
-
-    return 0;
-}
-
-/* delete and free specified list block */
-static int at_recvpkt_node_delete(rt_slist_t *rlist, rt_slist_t *node)
-{
-    at_recv_pkt_t pkt = RT_NULL;
-
-    if (rt_slist_isempty(rlist))
-    {
-        return 0;
-    }
-
-    rt_slist_remove(rlist, node);
-
-    pkt = rt_slist_entry(node, struct at_recv_pkt, list);
-    if (pkt->buff)
-    {
-        rt_free(pkt->buff);
-    }
-    if (pkt)
-    {
-        rt_free(pkt);
-        pkt = RT_NULL;
-    }
-
-    return 0;
-}
-
-/* get a block from AT socket receive buffer list */
-static size_t at_recvpkt_get(rt_slist_t *rlist, char *mem, size_t len)
-{
-    rt_slist_t *node = RT_NULL;
-    at_recv_pkt_t pkt = RT_NULL;
-    size_t content_pos = 0, page_pos = 0;
-
-    if (rt_slist_isempty(rlist))
+    if (socket < 0 || socket >= AT_SOCKETS_NUM)
     {
-        return 0;
+        return RT_NULL;
     }
 
-    for (node = rt_slist_first(rlist); node; node = rt_slist_next(node))
+    at_sock = _socket_table[socket];
+    if (at_sock && at_sock->magic == AT_SOCKET_MAGIC)
     {
-        pkt = rt_slist_entry(node, struct at_recv_pkt, list);
-
-        page_pos = pkt->bfsz_totle - pkt->bfsz_index;
-
-        if (page_pos >= len - content_pos)
-        {
-            memcpy((char *) mem + content_pos, pkt->buff + pkt->bfsz_index, len - content_pos);
-            pkt->bfsz_index += len - content_pos;
-            if (pkt->bfsz_index == pkt->bfsz_totle)
-            {
-                at_recvpkt_node_delete(rlist, node);
-            }
-            content_pos = len;
-            break;
-        }
-        else
-        {
-            memcpy((char *) mem + content_pos, pkt->buff + pkt->bfsz_index, page_pos);
-            content_pos += page_pos;
-            pkt->bfsz_index += page_pos;
-            at_recvpkt_node_delete(rlist, node);
-        }
+        return at_sock;
     }
 
-    return content_pos;
+    return RT_NULL;
 }
 
 static void at_do_event_changes(struct at_socket *sock, at_event_t event, rt_bool_t is_plus)
@@ -274,28 +151,22 @@ static void at_do_event_clean(struct at_socket *sock, at_event_t event)
     }
 }
 
-static int alloc_empty_socket(rt_slist_t *l)
+/* the socket descriptor is the lowest free index of socket table */
+static int alloc_empty_socket(struct at_socket *sock)
 {
     rt_base_t level;
-    rt_slist_t *node = RT_NULL;
-    rt_slist_t *pre_node = &_socket_list;
-    struct at_socket *at_sock = RT_NULL;
     int idx = 0;
 
     level = rt_hw_interrupt_disable();
 
-    rt_slist_init(l);
+    for (idx = 0; idx < AT_SOCKETS_NUM && _socket_table[idx]; idx++);
 
-    rt_slist_for_each(node, &_socket_list)
+    if (idx == AT_SOCKETS_NUM)
     {
-        at_sock = rt_slist_entry(node, struct at_socket, list);
-        if(at_sock->socket != idx)  
-            break;
-        idx++;
-        pre_node = node;
+        rt_hw_interrupt_enable(level);
+        return -1;
     }
-
-    rt_slist_insert(pre_node, l);
+    _socket_table[idx] = sock;
 
     rt_hw_interrupt_enable(level);
 
@@ -332,19 +203,17 @@ static struct at_socket *alloc_socket_by_device(struct at_device *device)
     }
 
     sock = &(device->sockets[idx]);
-    /* the socket descriptor is the number of sockte lists */
-    sock->socket = alloc_empty_socket(&(sock->list));
+    rt_memset(sock, 0x00, sizeof(struct at_socket));
     /* the socket operations is the specify operations of the device */
     sock->ops = device->class->socket_ops;
     /* the user-data is the at device socket descriptor */
     sock->user_data = (void *) idx;
     sock->device = (void *) device;
-    sock->magic = AT_SOCKET_MAGIC;
     sock->state = AT_SOCKET_NONE;
     sock->rcvevent = RT_NULL;
     sock->sendevent = RT_NULL;
     sock->errevent = RT_NULL;
-    rt_slist_init(&sock->recvpkt_list);
+    rt_slist_init(&sock->recv_overflow);
 #ifdef SAL_USING_POSIX
     rt_wqueue_init(&sock->wait_head);
 #endif
@@ -357,19 +226,51 @@ static struct at_socket *alloc_socket_by_device(struct at_device *device)
         goto __err;
     }
 
-    rt_snprintf(name, RT_NAME_MAX, "%s%d", "at_skt", idx);
     /* create AT socket receive ring buffer lock */
     if((sock->recv_lock = rt_mutex_create(name, RT_IPC_FLAG_FIFO)) == RT_NULL)
     {
         LOG_E("No memory for socket receive mutex create.");
-        rt_sem_delete(sock->recv_notice);
         goto __err;
     }
 
+    /* create AT socket receive ring buffer */
+    if ((sock->recv_ring = rt_ringbuffer_create(AT_SOCKET_RECV_BFSZ)) == RT_NULL)
+    {
+        LOG_E("No memory for socket receive ring buffer create.");
+        goto __err;
+    }
+
+    /* create AT socket send window */
+    if ((sock->send_window = rt_sem_create(name, AT_SOCKET_SEND_WINDOW, RT_IPC_FLAG_FIFO)) == RT_NULL)
+    {
+        LOG_E("No memory for socket send window create.");
+        goto __err;
+    }
+
+    sock->socket = alloc_empty_socket(sock);
+    if (sock->socket < 0)
+    {
+        LOG_E("No empty socket descriptor, the maximum number is %d.", AT_SOCKETS_NUM);
+        goto __err;
+    }
+    sock->magic = AT_SOCKET_MAGIC;
+
     rt_mutex_release(at_slock);
     return sock;
 
 __err:
+    if (sock)
+    {
+        if (sock->recv_notice)
+            rt_sem_delete(sock->recv_notice);
+        if (sock->recv_lock)
+            rt_mutex_delete(sock->recv_lock);
+        if (sock->recv_ring)
+            rt_ringbuffer_destroy(sock->recv_ring);
+        if (sock->send_window)
+            rt_sem_delete(sock->send_window);
+        rt_memset(sock, 0x00, sizeof(struct at_socket));
+    }
     rt_mutex_release(at_slock);
     return RT_NULL;
 }
@@ -441,8 +342,26 @@ int at_socket(int domain, int type, int protocol)
     return sock->socket;
 }
 
+/* delete and free all the received data in the list */
+static void at_recvpkt_all_delete(rt_slist_t *rlist)
+{
+    at_recv_pkt_t pkt = RT_NULL;
+    rt_slist_t *node = RT_NULL;
+
+    while ((node = rt_slist_first(rlist)) != RT_NULL)
+    {
+        rt_slist_remove(rlist, node);
+        pkt = rt_slist_entry(node, struct at_recv_pkt, list);
+        rt_free(pkt->buff);
+        rt_free(pkt);
+    }
+}
+
 static int free_socket(struct at_socket *sock)
 {
+    /* the callbacks of the socket return from now on */
+    sock->magic = 0;
+
     if (sock->recv_notice)
     {
         rt_sem_delete(sock->recv_notice);
@@ -453,30 +372,27 @@ static int free_socket(struct at_socket *sock)
         rt_mutex_delete(sock->recv_lock);
     }
 
-    if (!rt_slist_isempty(&sock->recvpkt_list))
+    if (sock->recv_ring)
+    {
+        rt_ringbuffer_destroy(sock->recv_ring);
+    }
+
+    at_recvpkt_all_delete(&sock->recv_overflow);
+
+    if (sock->send_window)
     {
-        at_recvpkt_all_delete(&sock->recvpkt_list);
+        rt_sem_delete(sock->send_window);
     }
 
-    /* delect socket from socket list */
+    /* delect socket from socket table */
     {
         rt_base_t level;
-        rt_slist_t *node = RT_NULL;
-        struct at_socket *at_sock = RT_NULL;
 
         level = rt_hw_interrupt_disable();
 
-        rt_slist_for_each(node, &_socket_list)
+        if (sock->socket >= 0 && sock->socket < AT_SOCKETS_NUM && _socket_table[sock->socket] == sock)
         {
-            at_sock = rt_slist_entry(node, struct at_socket, list);
-            if (sock->socket == at_sock->socket)
-            {
-                if (at_sock && at_sock->magic == AT_SOCKET_MAGIC)
-                {
-                    rt_slist_remove(&_socket_list, &at_sock->list);
-                    break;
-                }
-            }
+            _socket_table[sock->socket] = RT_NULL;
         }
 
         rt_hw_interrupt_enable(level);
@@ -589,17 +505,12 @@ int at_bind(int socket, const struct sockaddr *name, socklen_t namelen)
 
     /* input ip address is different from device ip address */
     if (ip_addr_cmp(&input_ipaddr, &local_ipaddr) == 0)
-    {   
+    {
         struct at_socket *new_sock = RT_NULL;
         struct at_device *new_device = RT_NULL;
-        enum at_socket_type type = sock->type;
+        rt_base_t level;
+        int result = -1;
 
-        /* close old socket */
-        if (at_closesocket(socket) < 0)
-        {
-            return -1;
-        }
-        
         extern struct at_device *at_device_get_by_ipaddr(ip_addr_t *ip_addr);
         new_device = at_device_get_by_ipaddr(&input_ipaddr);
         if (new_device == RT_NULL)
@@ -607,14 +518,34 @@ int at_bind(int socket, const struct sockaddr *name, socklen_t namelen)
             return -1;
         }
 
-        /* allocate new socket */
+        /* allocate new socket before the old socket is closed */
         new_sock = alloc_socket_by_device(new_device);
         if (new_sock == RT_NULL)
         {
             return -1;
         }
-        new_sock->type = type;
+        new_sock->type = sock->type;
         new_sock->state = AT_SOCKET_OPEN;
+
+        /* close old socket, it's freed even if the device fails to close it */
+        at_closesocket(socket);
+
+        /* the new socket takes the descriptor of old socket which is still used by SAL */
+        level = rt_hw_interrupt_disable();
+        if (_socket_table[socket] == RT_NULL)
+        {
+            _socket_table[new_sock->socket] = RT_NULL;
+            _socket_table[socket] = new_sock;
+            new_sock->socket = socket;
+            result = 0;
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (result < 0)
+        {
+            free_socket(new_sock);
+            return -1;
+        }
     }
 
     return 0;
@@ -633,20 +564,66 @@ static int ipaddr_to_ipstr(const struct sockaddr *sockaddr, char *ipstr)
 
 static void at_recv_notice_cb(struct at_socket *sock, at_socket_evt_t event, const char *buff, size_t bfsz)
 {
+    at_recv_pkt_t pkt = RT_NULL;
+    size_t len = 0, put_len;
+
     RT_ASSERT(buff);
     RT_ASSERT(event == AT_SOCKET_EVT_RECV);
     
     /* check the socket object status */
     if (sock->magic != AT_SOCKET_MAGIC)
     {
+        rt_free((void *) buff);
         return;
     }
 
-    /* put receive buffer to receiver packet list */
+    /* copy receive buffer to the ring buffer, the AT client parser is never held here.
+     * The data which does not fit is kept in the overflow list with its buffer, and the
+     * later data is appended to the list until it's empty to keep the order. */
     rt_mutex_take(sock->recv_lock, RT_WAITING_FOREVER);
-    at_recvpkt_put(&(sock->recvpkt_list), buff, bfsz);
+    if (sock->recv_drops > 0 && sock->type == AT_SOCKET_TCP)
+    {
+        /* the stream is broken, nothing is received after the dropped data */
+        len = 0;
+    }
+    else
+    {
+        while (len < bfsz && rt_slist_isempty(&sock->recv_overflow))
+        {
+            put_len = bfsz - len > 0xFFFF ? 0xFFFF : bfsz - len;
+            put_len = rt_ringbuffer_put(sock->recv_ring, (const rt_uint8_t *) buff + len, put_len);
+            if (put_len == 0)
+            {
+                break;
+            }
+            len += put_len;
+        }
+
+        if (len < bfsz && (pkt = (at_recv_pkt_t) rt_calloc(1, sizeof(struct at_recv_pkt))) != RT_NULL)
+        {
+            pkt->bfsz_totle = bfsz;
+            pkt->bfsz_index = len;
+            pkt->buff = (char *) buff;
+            rt_slist_append(&sock->recv_overflow, &pkt->list);
+            len = bfsz;
+        }
+    }
+    if (len < bfsz)
+    {
+        sock->recv_drops += bfsz - len;
+    }
     rt_mutex_release(sock->recv_lock);
 
+    if (pkt == RT_NULL)
+    {
+        rt_free((void *) buff);
+    }
+
+    if (len < bfsz)
+    {
+        LOG_E("AT socket (%d) no memory for receive buffer, drop %d bytes.", sock->socket, bfsz - len);
+    }
+
     rt_sem_release(sock->recv_notice);
 
     at_do_event_changes(sock, AT_EVENT_RECV, RT_TRUE);
@@ -669,6 +646,74 @@ static void at_closed_notice_cb(struct at_socket *sock, at_socket_evt_t event, c
     rt_sem_release(sock->recv_notice);
 }
 
+static void at_send_notice_cb(struct at_socket *sock, at_socket_evt_t event, const char *buff, size_t bfsz)
+{
+    RT_ASSERT(event == AT_SOCKET_EVT_SEND);
+
+    /* check the socket object status */
+    if (sock->magic != AT_SOCKET_MAGIC)
+    {
+        return;
+    }
+
+    if (bfsz == 0)
+    {
+        LOG_E("AT socket (%d) send data failed.", sock->socket);
+        at_do_event_changes(sock, AT_EVENT_ERROR, RT_TRUE);
+    }
+
+    /* the send is finished, open the send window */
+    rt_sem_release(sock->send_window);
+    at_do_event_changes(sock, AT_EVENT_SEND, RT_TRUE);
+}
+
+static void at_set_socket_event_cb(struct at_socket *sock)
+{
+    sock->ops->at_set_event_cb(AT_SOCKET_EVT_RECV, at_recv_notice_cb);
+    sock->ops->at_set_event_cb(AT_SOCKET_EVT_CLOSED, at_closed_notice_cb);
+    /* only the devices sending without waiting report the result */
+    if (sock->ops->at_send_nowait)
+    {
+        sock->ops->at_set_event_cb(AT_SOCKET_EVT_SEND, at_send_notice_cb);
+    }
+}
+
+/* send data by the device, the sends are pipelined in the send window if the device supports */
+static int at_send_data(struct at_socket *sock, const char *data, size_t size)
+{
+    int32_t timeout;
+    int len;
+
+    if (sock->ops->at_send_nowait == RT_NULL)
+    {
+        return sock->ops->at_send(sock, data, size, sock->type);
+    }
+
+    if ((timeout = sock->send_timeout) == 0)
+    {
+        timeout = RT_WAITING_FOREVER;
+    }
+    else
+    {
+        timeout = rt_tick_from_millisecond(timeout);
+    }
+
+    /* wait for the result of the earliest send when the window is full */
+    if (rt_sem_take(sock->send_window, timeout) != RT_EOK)
+    {
+        LOG_E("AT socket (%d) send timeout (%d)!", sock->socket, timeout);
+        errno = EAGAIN;
+        return -1;
+    }
+
+    if ((len = sock->ops->at_send_nowait(sock, data, size, sock->type)) < 0)
+    {
+        rt_sem_release(sock->send_window);
+    }
+
+    return len;
+}
+
 int at_connect(int socket, const struct sockaddr *name, socklen_t namelen)
 {
     struct at_socket *sock = RT_NULL;
@@ -704,8 +749,7 @@ int at_connect(int socket, const struct sockaddr *name, socklen_t namelen)
     sock->state = AT_SOCKET_CONNECT;
 
     /* set AT socket receive data callback function */
-    sock->ops->at_set_event_cb(AT_SOCKET_EVT_RECV, at_recv_notice_cb);
-    sock->ops->at_set_event_cb(AT_SOCKET_EVT_CLOSED, at_closed_notice_cb);
+    at_set_socket_event_cb(sock);
 
 __exit:
 
@@ -725,6 +769,46 @@ __exit:
     return result;
 }
 
+/* get the data from receive ring buffer, then from the overflow list which is newer */
+static size_t at_recv_ring_get(struct at_socket *sock, char *mem, size_t len)
+{
+    at_recv_pkt_t pkt = RT_NULL;
+    rt_slist_t *node = RT_NULL;
+    size_t recv_len, page_len;
+
+    rt_mutex_take(sock->recv_lock, RT_WAITING_FOREVER);
+    recv_len = rt_ringbuffer_get(sock->recv_ring, (rt_uint8_t *) mem, len > 0xFFFF ? 0xFFFF : len);
+    while (recv_len < len && (node = rt_slist_first(&sock->recv_overflow)) != RT_NULL)
+    {
+        pkt = rt_slist_entry(node, struct at_recv_pkt, list);
+        page_len = pkt->bfsz_totle - pkt->bfsz_index;
+        if (page_len > len - recv_len)
+        {
+            page_len = len - recv_len;
+        }
+
+        rt_memcpy(mem + recv_len, pkt->buff + pkt->bfsz_index, page_len);
+        pkt->bfsz_index += page_len;
+        recv_len += page_len;
+
+        if (pkt->bfsz_index == pkt->bfsz_totle)
+        {
+            rt_slist_remove(&sock->recv_overflow, node);
+            rt_free(pkt->buff);
+            rt_free(pkt);
+        }
+    }
+    rt_mutex_release(sock->recv_lock);
+
+    return recv_len;
+}
+
+/* whether there is received data not read */
+static rt_bool_t at_recv_ring_ready(struct at_socket *sock)
+{
+    return rt_ringbuffer_data_len(sock->recv_ring) > 0 || !rt_slist_isempty(&sock->recv_overflow);
+}
+
 int at_recvfrom(int socket, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen)
 {
     struct at_socket *sock = RT_NULL;
@@ -761,18 +845,23 @@ int at_recvfrom(int socket, void *mem, size_t len, int flags, struct sockaddr *f
         }
         sock->state = AT_SOCKET_CONNECT;
         /* set AT socket receive data callback function */
-        sock->ops->at_set_event_cb(AT_SOCKET_EVT_RECV, at_recv_notice_cb);
-        sock->ops->at_set_event_cb(AT_SOCKET_EVT_CLOSED, at_closed_notice_cb);
+        at_set_socket_event_cb(sock);
     }
 
-    /* receive packet list last transmission of remaining data */
-    rt_mutex_take(sock->recv_lock, RT_WAITING_FOREVER);
-    if((recv_len = at_recvpkt_get(&(sock->recvpkt_list), (char *)mem, len)) > 0)
+    /* receive ring buffer last transmission of remaining data */
+    if((recv_len = at_recv_ring_get(sock, (char *)mem, len)) > 0)
     {
-        rt_mutex_release(sock->recv_lock);
         goto __exit;
     }
-    rt_mutex_release(sock->recv_lock);
+
+    /* the received data was dropped, the TCP stream can't go on */
+    if (sock->recv_drops > 0 && sock->type == AT_SOCKET_TCP)
+    {
+        LOG_E("AT socket (%d) receive data was dropped, %d bytes.", socket, sock->recv_drops);
+        errno = ECONNRESET;
+        result = -1;
+        goto __exit;
+    }
         
     /* socket passively closed, receive function return 0 */
     if (sock->state == AT_SOCKET_CLOSED)
@@ -818,13 +907,17 @@ int at_recvfrom(int socket, void *mem, size_t len, int flags, struct sockaddr *f
             if (sock->state == AT_SOCKET_CONNECT)
             {
                 /* get receive buffer to receiver ring buffer */
-                rt_mutex_take(sock->recv_lock, RT_WAITING_FOREVER);
-                recv_len = at_recvpkt_get(&(sock->recvpkt_list), (char *) mem, len);
-                rt_mutex_release(sock->recv_lock);
+                recv_len = at_recv_ring_get(sock, (char *) mem, len);
                 if (recv_len > 0)
                 {
                     break;
                 }
+                if (sock->recv_drops > 0 && sock->type == AT_SOCKET_TCP)
+                {
+                    errno = ECONNRESET;
+                    result = -1;
+                    goto __exit;
+                }
             }
             else
             {
@@ -844,7 +937,7 @@ __exit:
             result = recv_len;
             at_do_event_changes(sock, AT_EVENT_RECV, RT_FALSE);
             errno = 0;
-            if (!rt_slist_isempty(&sock->recvpkt_list))
+            if (at_recv_ring_ready(sock))
             {
                 at_do_event_changes(sock, AT_EVENT_RECV, RT_TRUE);
             }
@@ -901,7 +994,7 @@ int at_sendto(int socket, const void *data, size_t size, int flags, const struct
             goto __exit;
         }
 
-        if ((len = sock->ops->at_send(sock, (const char *) data, size, sock->type)) < 0)
+        if ((len = at_send_data(sock, (const char *) data, size)) < 0)
         {
             result = -1;
             goto __exit;
@@ -925,11 +1018,10 @@ int at_sendto(int socket, const void *data, size_t size, int flags, const struct
             }
             sock->state = AT_SOCKET_CONNECT;
             /* set AT socket receive data callback function */
-            sock->ops->at_set_event_cb(AT_SOCKET_EVT_RECV, at_recv_notice_cb);
-            sock->ops->at_set_event_cb(AT_SOCKET_EVT_CLOSED, at_closed_notice_cb);
+            at_set_socket_event_cb(sock);
         }
 
-        if ((len = sock->ops->at_send(sock, (char *) data, size, sock->type)) < 0)
+        if ((len = at_send_data(sock, (const char *) data, size)) < 0)
         {
             result = -1;
             goto __exit;
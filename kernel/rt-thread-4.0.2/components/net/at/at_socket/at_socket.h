@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-06-06     chenYong     first version
+ * 2026-10-18     liujiahao    receive ring buffer and send window of socket
  */
 
 #ifndef __AT_SOCKET_H__
@@ -22,8 +23,14 @@
 extern "C" {
 #endif
 
+/* the size of socket receive ring buffer, it holds a maximum +IPD of ESP8266 at least */
 #ifndef AT_SOCKET_RECV_BFSZ
-#define AT_SOCKET_RECV_BFSZ            512
+#define AT_SOCKET_RECV_BFSZ            1536
+#endif
+
+/* the maximum number of sends waiting for the result, used by the devices supporting at_send_nowait */
+#ifndef AT_SOCKET_SEND_WINDOW
+#define AT_SOCKET_SEND_WINDOW          2
 #endif
 
 #define AT_DEFAULT_RECVMBOX_SIZE       10
@@ -32,6 +39,16 @@ extern "C" {
 /* sal socket magic word */
 #define AT_SOCKET_MAGIC                0xA100
 
+/* the received data which does not fit in the ring buffer */
+struct at_recv_pkt
+{
+    rt_slist_t list;
+    size_t bfsz_totle;
+    size_t bfsz_index;
+    char *buff;
+};
+typedef struct at_recv_pkt *at_recv_pkt_t;
+
 /* Current state of the AT socket. */
 enum at_socket_state
 {
@@ -53,6 +70,7 @@ typedef enum
 {
     AT_SOCKET_EVT_RECV,
     AT_SOCKET_EVT_CLOSED,
+    AT_SOCKET_EVT_SEND,                /* the result of at_send_nowait, the bfsz is the sent length, 0 is failed */
 } at_socket_evt_t;
 
 struct at_socket;
@@ -70,18 +88,10 @@ struct at_socket_ops
     int (*at_send)(struct at_socket *socket, const char *buff, size_t bfsz, enum at_socket_type type);
     int (*at_domain_resolve)(const char *name, char ip[16]);
     void (*at_set_event_cb)(at_socket_evt_t event, at_evt_cb_t cb);
+    /* optional, send the data without waiting the result, which is reported by AT_SOCKET_EVT_SEND event */
+    int (*at_send_nowait)(struct at_socket *socket, const char *buff, size_t bfsz, enum at_socket_type type);
 };
 
-/* AT receive package list structure */
-struct at_recv_pkt
-{
-    rt_slist_t list;
-    size_t bfsz_totle;
-    size_t bfsz_index;
-    char *buff;
-};
-typedef struct at_recv_pkt *at_recv_pkt_t;
-
 struct at_socket
 {
     /* AT socket magic word */
@@ -99,7 +109,14 @@ struct at_socket
     /* receive semaphore, received data release semaphore */
     rt_sem_t recv_notice;
     rt_mutex_t recv_lock;
-    rt_slist_t recvpkt_list;
+    /* received data ring buffer */
+    struct rt_ringbuffer *recv_ring;
+    /* received data list after the ring buffer is full */
+    rt_slist_t recv_overflow;
+    /* the length of received data dropped for no memory, the TCP stream is broken by it */
+    uint32_t recv_drops;
+    /* the sends waiting for the result of at_send_nowait */
+    rt_sem_t send_window;
 
     /* timeout to wait for send or received data in milliseconds */
     int32_t recv_timeout;
@@ -117,7 +134,6 @@ struct at_socket
 #ifdef SAL_USING_POSIX
     rt_wqueue_t wait_head;
 #endif
-    rt_slist_t list;
 
     /* user-specific data */
     void *user_data;
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2018-03-30     chenyong     first version
  * 2018-08-17     chenyong     multiple client support
+ * 2026-10-18     liujiahao    bulk receive and URC prefix trie of client
  */
 
 #ifndef __AT_H__
@@ -49,6 +50,11 @@ extern "C" {
 #define AT_CLIENT_NUM_MAX              1
 #endif
 
+/* the length of AT client bulk receive buffer */
+#ifndef AT_CLIENT_RECV_CHUNK_LEN
+#define AT_CLIENT_RECV_CHUNK_LEN       128
+#endif
+
 #define AT_CMD_EXPORT(_name_, _args_expr_, _test_, _query_, _setup_, _exec_)   \
     RT_USED static const struct at_cmd __at_cmd_##_test_##_query_##_setup_##_exec_ SECTION("RtAtCmdTab") = \
     {                                                                          \
@@ -158,6 +164,9 @@ struct at_urc_table
 };
 typedef struct at_urc *at_urc_table_t;
 
+/* the prefix trie of all URC tables, it's built by `at_obj_set_urc_table()` function */
+struct at_urc_trie;
+
 struct at_client
 {
     rt_device_t device;
@@ -171,6 +180,10 @@ struct at_client
     rt_size_t recv_line_len;
     /* The maximum supported receive data length */
     rt_size_t recv_bufsz;
+    /* the data read from device in bulk, the lines are scanned in place */
+    char *recv_chunk_buf;
+    rt_size_t recv_chunk_pos;
+    rt_size_t recv_chunk_len;
     rt_sem_t rx_notice;
     rt_mutex_t lock;
 
@@ -180,6 +193,7 @@ struct at_client
 
     struct at_urc_table *urc_table;
     rt_size_t urc_table_size;
+    struct at_urc_trie *urc_trie;
 
     rt_thread_t parser;
 };
@@ -8,9 +8,11 @@
  * 2018-03-30     chenyong     first version
  * 2018-04-12     chenyong     add client implement
  * 2018-08-17     chenyong     multiple client support
+ * 2026-10-18     liujiahao    bulk receive and URC prefix trie
  */
 
 #include <at.h>
+#include <rthw.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,6 +27,38 @@
 #define AT_RESP_END_FAIL               "FAIL"
 #define AT_END_CR_LF                   "\r\n"
 
+/* the node of URC prefix trie, the children of one node are linked by sibling */
+struct at_urc_node
+{
+    struct at_urc_node *child;
+    struct at_urc_node *sibling;
+    struct at_urc_node *urc_parent;    /* the nearest ancestor with URCs */
+    struct at_urc_entry *urc;          /* the URCs with the prefix ended at this node */
+    char ch;
+};
+
+struct at_urc_entry
+{
+    const struct at_urc *urc;
+    struct at_urc_entry *next;
+    rt_size_t order;                   /* the first URC of tables is matched first */
+    rt_size_t prefix_len;
+    rt_size_t suffix_len;
+};
+
+struct at_urc_trie
+{
+    struct at_urc_node *nodes;         /* the root is the first one */
+    rt_size_t node_num;
+    /* the last characters of URC suffixes, the line is matched only when ended by them */
+    rt_uint32_t suffix_map[256 / 32];
+    /* the replaced tries, they are freed by the parser when it isn't walking them */
+    struct at_urc_trie *retired;
+};
+
+#define AT_URC_SUFFIX_MAP_SET(trie, ch)    ((trie)->suffix_map[(rt_uint8_t)(ch) >> 5] |= 1UL << ((rt_uint8_t)(ch) & 0x1F))
+#define AT_URC_SUFFIX_MAP_TEST(trie, ch)   ((trie)->suffix_map[(rt_uint8_t)(ch) >> 5] & (1UL << ((rt_uint8_t)(ch) & 0x1F)))
+
 static struct at_client at_client_table[AT_CLIENT_NUM_MAX] = { 0 };
 
 extern rt_size_t at_vprintfln(rt_device_t device, const char *format, va_list args);
@@ -430,20 +464,47 @@ rt_size_t at_client_obj_send(at_client_t client, const char *buf, rt_size_t size
     return rt_device_write(client->device, 0, buf, size);
 }
 
-static rt_err_t at_client_getchar(at_client_t client, char *ch, rt_int32_t timeout)
+/* read the data in bulk, wait for the data when the device is empty */
+static rt_size_t at_client_device_read(at_client_t client, char *buf, rt_size_t size, rt_int32_t timeout)
 {
-    rt_err_t result = RT_EOK;
+    rt_size_t len;
 
-    while (rt_device_read(client->device, 0, ch, 1) == 0)
+    while (1)
     {
+        /* the notice released before reading is out of date */
         rt_sem_control(client->rx_notice, RT_IPC_CMD_RESET, RT_NULL);
 
-        result = rt_sem_take(client->rx_notice, rt_tick_from_millisecond(timeout));
-        if (result != RT_EOK)
+        len = rt_device_read(client->device, 0, buf, size);
+        if (len > 0)
+        {
+            return len;
+        }
+
+        if (rt_sem_take(client->rx_notice, rt_tick_from_millisecond(timeout)) != RT_EOK)
         {
-            return result;
+            return 0;
         }
     }
+}
+
+/* fill the bulk receive buffer when it's empty */
+static rt_err_t at_client_recv_chunk(at_client_t client, rt_int32_t timeout)
+{
+    rt_size_t len;
+
+    if (client->recv_chunk_pos < client->recv_chunk_len)
+    {
+        return RT_EOK;
+    }
+
+    len = at_client_device_read(client, client->recv_chunk_buf, AT_CLIENT_RECV_CHUNK_LEN, timeout);
+    if (len == 0)
+    {
+        return -RT_ETIMEOUT;
+    }
+
+    client->recv_chunk_pos = 0;
+    client->recv_chunk_len = len;
 
     return RT_EOK;
 }
@@ -463,9 +524,7 @@ static rt_err_t at_client_getchar(at_client_t client, char *ch, rt_int32_t timeo
  */
 rt_size_t at_client_obj_recv(at_client_t client, char *buf, rt_size_t size, rt_int32_t timeout)
 {
-    rt_size_t read_idx = 0;
-    rt_err_t result = RT_EOK;
-    char ch;
+    rt_size_t read_idx = 0, len;
 
     RT_ASSERT(buf);
 
@@ -475,23 +534,30 @@ rt_size_t at_client_obj_recv(at_client_t client, char *buf, rt_size_t size, rt_i
         return 0;
     }
 
-    while (1)
+    while (read_idx < size)
     {
-        if (read_idx < size)
+        /* the rest of bulk receive buffer first, then the device directly */
+        if (client->recv_chunk_pos < client->recv_chunk_len)
         {
-            result = at_client_getchar(client, &ch, timeout);
-            if (result != RT_EOK)
+            len = client->recv_chunk_len - client->recv_chunk_pos;
+            if (len > size - read_idx)
             {
-                LOG_E("AT Client receive failed, uart device get data error(%d)", result);
-                return 0;
+                len = size - read_idx;
             }
-
-            buf[read_idx++] = ch;
+            rt_memcpy(buf + read_idx, client->recv_chunk_buf + client->recv_chunk_pos, len);
+            client->recv_chunk_pos += len;
         }
         else
         {
-            break;
+            len = at_client_device_read(client, buf + read_idx, size - read_idx, timeout);
+            if (len == 0)
+            {
+                LOG_E("AT Client receive failed, uart device get data error(%d)", -RT_ETIMEOUT);
+                return 0;
+            }
         }
+
+        read_idx += len;
     }
 
 #ifdef AT_PRINT_RAW_CMD
@@ -518,6 +584,109 @@ void at_obj_set_end_sign(at_client_t client, char ch)
     client->end_sign = ch;
 }
 
+/* build the prefix trie of all URC tables */
+static struct at_urc_trie *urc_trie_build(struct at_urc_table *urc_table, rt_size_t table_num)
+{
+    rt_size_t i, j, urc_num = 0, node_max = 1, order = 0;
+    struct at_urc_trie *trie;
+    struct at_urc_node *node, *child;
+    struct at_urc_entry *entry, *entries, **tail;
+    const struct at_urc *urc;
+    const char *prefix;
+
+    for (i = 0; i < table_num; i++)
+    {
+        for (j = 0; j < urc_table[i].urc_size; j++)
+        {
+            node_max += rt_strlen(urc_table[i].urc[j].cmd_prefix);
+            urc_num++;
+        }
+    }
+
+    trie = (struct at_urc_trie *) rt_calloc(1, sizeof(struct at_urc_trie) + node_max * sizeof(struct at_urc_node)
+            + urc_num * sizeof(struct at_urc_entry));
+    if (trie == RT_NULL)
+    {
+        return RT_NULL;
+    }
+    trie->nodes = (struct at_urc_node *) (trie + 1);
+    trie->node_num = 1;
+    entries = (struct at_urc_entry *) (trie->nodes + node_max);
+
+    for (i = 0; i < table_num; i++)
+    {
+        for (j = 0; j < urc_table[i].urc_size; j++)
+        {
+            urc = urc_table[i].urc + j;
+
+            /* walk down the prefix, add the missing nodes */
+            node = trie->nodes;
+            for (prefix = urc->cmd_prefix; *prefix; prefix++)
+            {
+                for (child = node->child; child && child->ch != *prefix; child = child->sibling);
+                if (child == RT_NULL)
+                {
+                    child = &trie->nodes[trie->node_num++];
+                    child->ch = *prefix;
+                    child->sibling = node->child;
+                    node->child = child;
+                }
+                node = child;
+            }
+
+            entry = &entries[order];
+            entry->urc = urc;
+            entry->order = order++;
+            entry->prefix_len = prefix - urc->cmd_prefix;
+            entry->suffix_len = rt_strlen(urc->cmd_suffix);
+            if (entry->suffix_len)
+            {
+                AT_URC_SUFFIX_MAP_SET(trie, urc->cmd_suffix[entry->suffix_len - 1]);
+            }
+
+            /* keep the order of tables */
+            for (tail = &node->urc; *tail; tail = &(*tail)->next);
+            *tail = entry;
+        }
+    }
+
+    /* the parent is created before its children */
+    for (i = 0; i < trie->node_num; i++)
+    {
+        node = &trie->nodes[i];
+        for (child = node->child; child; child = child->sibling)
+        {
+            child->urc_parent = node->urc ? node : node->urc_parent;
+        }
+    }
+
+    return trie;
+}
+
+/* match the URCs of the prefix ended at the node or its ancestors with the line */
+static const struct at_urc *urc_trie_match(struct at_urc_node *node, const char *line, rt_size_t len)
+{
+    struct at_urc_entry *entry, *matched = RT_NULL;
+
+    for (node = node->urc ? node : node->urc_parent; node; node = node->urc_parent)
+    {
+        for (entry = node->urc; entry; entry = entry->next)
+        {
+            if (len < entry->prefix_len + entry->suffix_len || (matched && entry->order > matched->order))
+            {
+                continue;
+            }
+            if (entry->suffix_len == 0 ||
+                    !rt_memcmp(line + len - entry->suffix_len, entry->urc->cmd_suffix, entry->suffix_len))
+            {
+                matched = entry;
+            }
+        }
+    }
+
+    return matched ? matched->urc : RT_NULL;
+}
+
 /**
  * set URC(Unsolicited Result Code) table
  *
@@ -528,6 +697,9 @@ void at_obj_set_end_sign(at_client_t client, char ch)
 int at_obj_set_urc_table(at_client_t client, const struct at_urc *urc_table, rt_size_t table_sz)
 {
     rt_size_t idx;
+    struct at_urc_table *new_urc_table, *old_urc_table;
+    struct at_urc_trie *new_trie;
+    rt_base_t level;
 
     if (client == RT_NULL)
     {
@@ -541,46 +713,36 @@ int at_obj_set_urc_table(at_client_t client, const struct at_urc *urc_table, rt_
         RT_ASSERT(urc_table[idx].cmd_suffix);
     }
 
-    if (client->urc_table_size == 0)
+    new_urc_table = (struct at_urc_table *) rt_malloc((client->urc_table_size + 1) * sizeof(struct at_urc_table));
+    if (new_urc_table == RT_NULL)
     {
-        client->urc_table = (struct at_urc_table *) rt_calloc(1, sizeof(struct at_urc_table));
-        if (client->urc_table == RT_NULL)
-        {
-            return -RT_ENOMEM;
-        }
-
-        client->urc_table[0].urc = urc_table;
-        client->urc_table[0].urc_size = table_sz;
-        client->urc_table_size++;
+        return -RT_ENOMEM;
     }
-    else
+    if (client->urc_table_size)
     {
-        struct at_urc_table *old_urc_table = RT_NULL;
-        size_t old_table_size = client->urc_table_size * sizeof(struct at_urc_table);
-
-        old_urc_table = (struct at_urc_table *) rt_malloc(old_table_size);
-        if (old_urc_table == RT_NULL)
-        {
-            return -RT_ENOMEM;
-        }
-        rt_memcpy(old_urc_table, client->urc_table, old_table_size);
+        rt_memcpy(new_urc_table, client->urc_table, client->urc_table_size * sizeof(struct at_urc_table));
+    }
+    new_urc_table[client->urc_table_size].urc = urc_table;
+    new_urc_table[client->urc_table_size].urc_size = table_sz;
 
-        /* realloc urc table space */
-        client->urc_table = (struct at_urc_table *) rt_realloc(client->urc_table,
-                old_table_size + sizeof(struct at_urc_table));
-        if (client->urc_table == RT_NULL)
-        {
-            rt_free(old_urc_table);
-            return -RT_ENOMEM;
-        }
-        rt_memcpy(client->urc_table, old_urc_table, old_table_size);
-        client->urc_table[client->urc_table_size].urc = urc_table;
-        client->urc_table[client->urc_table_size].urc_size = table_sz;
-        client->urc_table_size++;
-        
-        rt_free(old_urc_table);
+    /* the prefix trie is built once here, the parser walks it by the received characters */
+    new_trie = urc_trie_build(new_urc_table, client->urc_table_size + 1);
+    if (new_trie == RT_NULL)
+    {
+        rt_free(new_urc_table);
+        return -RT_ENOMEM;
     }
 
+    level = rt_hw_interrupt_disable();
+    old_urc_table = client->urc_table;
+    client->urc_table = new_urc_table;
+    client->urc_table_size++;
+    new_trie->retired = client->urc_trie;
+    client->urc_trie = new_trie;
+    rt_hw_interrupt_enable(level);
+
+    rt_free(old_urc_table);
+
     return RT_EOK;
 }
 
@@ -599,7 +761,8 @@ at_client_t at_client_get(const char *dev_name)
 
     for (idx = 0; idx < AT_CLIENT_NUM_MAX; idx++)
     {
-        if (rt_strcmp(at_client_table[idx].device->parent.name, dev_name) == 0)
+        if (at_client_table[idx].device &&
+            rt_strcmp(at_client_table[idx].device->parent.name, dev_name) == 0)
         {
             return &at_client_table[idx];
         }
@@ -623,83 +786,120 @@ at_client_t at_client_get_first(void)
     return &at_client_table[0];
 }
 
-static const struct at_urc *get_urc_obj(at_client_t client)
+/* get the current URC prefix trie, and free the replaced ones which aren't walked any more */
+static struct at_urc_trie *urc_trie_get(at_client_t client)
 {
-    rt_size_t i, j, prefix_len, suffix_len;
-    rt_size_t bufsz;
-    char *buffer = RT_NULL;
-    const struct at_urc *urc = RT_NULL;
-    struct at_urc_table *urc_table = RT_NULL;
+    struct at_urc_trie *trie, *retired, *next;
+    rt_base_t level;
 
-    if (client->urc_table == RT_NULL)
+    level = rt_hw_interrupt_disable();
+    trie = client->urc_trie;
+    retired = RT_NULL;
+    if (trie)
     {
-        return RT_NULL;
+        retired = trie->retired;
+        trie->retired = RT_NULL;
     }
+    rt_hw_interrupt_enable(level);
 
-    buffer = client->recv_line_buf;
-    bufsz = client->recv_line_len;
-
-    for (i = 0; i < client->urc_table_size; i++)
+    for (; retired; retired = next)
     {
-        for (j = 0; j < client->urc_table[i].urc_size; j++)
-        {
-            urc_table = client->urc_table + i;
-            urc = urc_table->urc + j;
-
-            prefix_len = rt_strlen(urc->cmd_prefix);
-            suffix_len = rt_strlen(urc->cmd_suffix);
-            if (bufsz < prefix_len + suffix_len)
-            {
-                continue;
-            }
-            if ((prefix_len ? !rt_strncmp(buffer, urc->cmd_prefix, prefix_len) : 1)
-                    && (suffix_len ? !rt_strncmp(buffer + bufsz - suffix_len, urc->cmd_suffix, suffix_len) : 1))
-            {
-                return urc;
-            }
-        }
+        next = retired->retired;
+        rt_free(retired);
     }
 
-    return RT_NULL;
+    return trie;
 }
 
-static int at_recv_readline(at_client_t client)
+static int at_recv_readline(at_client_t client, const struct at_urc **urc)
 {
+    struct at_urc_trie *trie = urc_trie_get(client);
+    struct at_urc_node *node = RT_NULL, *child;
+    char *line = client->recv_line_buf;
+    const char *chunk, *chunk_end;
     rt_size_t read_len = 0;
     char ch = 0, last_ch = 0;
-    rt_bool_t is_full = RT_FALSE;
+    rt_bool_t is_full = RT_FALSE, is_end = RT_FALSE, walking = RT_TRUE, entered;
 
-    rt_memset(client->recv_line_buf, 0x00, client->recv_bufsz);
+    *urc = RT_NULL;
     client->recv_line_len = 0;
-
-    while (1)
+    if (trie)
     {
-        at_client_getchar(client, &ch, RT_WAITING_FOREVER);
+        node = trie->nodes;
+    }
 
-        if (read_len < client->recv_bufsz)
-        {
-            client->recv_line_buf[read_len++] = ch;
-            client->recv_line_len = read_len;
-        }
-        else
+    while (!is_end)
+    {
+        if (at_client_recv_chunk(client, RT_WAITING_FOREVER) != RT_EOK)
         {
-            is_full = RT_TRUE;
+            continue;
         }
 
-        /* is newline or URC data */
-        if ((ch == '\n' && last_ch == '\r') || (client->end_sign != 0 && ch == client->end_sign)
-                || get_urc_obj(client))
+        /* scan the line in the bulk receive buffer */
+        chunk = client->recv_chunk_buf + client->recv_chunk_pos;
+        chunk_end = client->recv_chunk_buf + client->recv_chunk_len;
+        while (chunk < chunk_end)
         {
-            if (is_full)
+            ch = *chunk++;
+
+            if (read_len < client->recv_bufsz)
             {
-                LOG_E("read line failed. The line data length is out of buffer size(%d)!", client->recv_bufsz);
-                rt_memset(client->recv_line_buf, 0x00, client->recv_bufsz);
-                client->recv_line_len = 0;
-                return -RT_EFULL;
+                line[read_len++] = ch;
+
+                if (trie)
+                {
+                    /* walk down the prefix trie, the URCs of the prefix are matched when it's entered */
+                    entered = (read_len == 1 && node->urc != RT_NULL);
+                    if (walking)
+                    {
+                        for (child = node->child; child && child->ch != ch; child = child->sibling);
+                        if (child)
+                        {
+                            node = child;
+                            entered = entered || (child->urc != RT_NULL);
+                        }
+                        else
+                        {
+                            walking = RT_FALSE;
+                        }
+                    }
+
+                    /* is URC data */
+                    if ((entered || AT_URC_SUFFIX_MAP_TEST(trie, ch)) &&
+                            (*urc = urc_trie_match(node, line, read_len)) != RT_NULL)
+                    {
+                        is_end = RT_TRUE;
+                        break;
+                    }
+                }
             }
-            break;
+            else
+            {
+                is_full = RT_TRUE;
+            }
+
+            /* is newline */
+            if ((ch == '\n' && last_ch == '\r') || (client->end_sign != 0 && ch == client->end_sign))
+            {
+                is_end = RT_TRUE;
+                break;
+            }
+            last_ch = ch;
         }
-        last_ch = ch;
+        client->recv_chunk_pos = chunk - client->recv_chunk_buf;
+    }
+
+    if (is_full)
+    {
+        LOG_E("read line failed. The line data length is out of buffer size(%d)!", client->recv_bufsz);
+        *urc = RT_NULL;
+        return -RT_EFULL;
+    }
+
+    client->recv_line_len = read_len;
+    if (read_len < client->recv_bufsz)
+    {
+        line[read_len] = '\0';
     }
 
 #ifdef AT_PRINT_RAW_CMD
@@ -715,9 +915,9 @@ static void client_parser(at_client_t client)
 
     while(1)
     {
-        if (at_recv_readline(client) > 0)
+        if (at_recv_readline(client, &urc) > 0)
         {
-            if ((urc = get_urc_obj(client)) != RT_NULL)
+            if (urc != RT_NULL)
             {
                 /* current receive is request, try to execute related operations */
                 if (urc->func != RT_NULL)
@@ -816,6 +1016,16 @@ static int at_client_para_init(at_client_t client)
         goto __exit;
     }
 
+    client->recv_chunk_pos = 0;
+    client->recv_chunk_len = 0;
+    client->recv_chunk_buf = (char *) rt_malloc(AT_CLIENT_RECV_CHUNK_LEN);
+    if (client->recv_chunk_buf == RT_NULL)
+    {
+        LOG_E("AT client initialize failed! No memory for bulk receive buffer.");
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+
     rt_snprintf(name, RT_NAME_MAX, "%s%d", AT_CLIENT_LOCK_NAME, at_client_num);
     client->lock = rt_mutex_create(name, RT_IPC_FLAG_FIFO);
     if (client->lock == RT_NULL)
@@ -845,6 +1055,7 @@ static int at_client_para_init(at_client_t client)
 
     client->urc_table = RT_NULL;
     client->urc_table_size = 0;
+    client->urc_trie = RT_NULL;
 
     rt_snprintf(name, RT_NAME_MAX, "%s%d", AT_CLIENT_THREAD_NAME, at_client_num);
     client->parser = rt_thread_create(name,
@@ -887,6 +1098,11 @@ __exit:
             rt_free(client->recv_line_buf);
         }
 
+        if (client->recv_chunk_buf)
+        {
+            rt_free(client->recv_chunk_buf);
+        }
+
         rt_memset(client, 0x00, sizeof(struct at_client));
     }
     else
@@ -29,6 +29,7 @@
  * 2012-12-8      Bernard      add file header
  *                             export bsd socket symbol for RT-Thread Application Module 
  * 2017-11-15     Bernard      add lock for init_done callback.
+ * 2026-10-18     liujiahao    input by ETHERNETIF_INPUT for the NAT fast path.
  */
 
 #include <rtthread.h>
@@ -116,7 +117,7 @@ static void tcpip_init_done_callback(void *arg)
             LOCK_TCPIP_CORE();
 
             netif_add(ethif->netif, &ipaddr, &netmask, &gw,
-                      ethif, netif_device_init, tcpip_input);
+                      ethif, netif_device_init, ETHERNETIF_INPUT);
 
             if (netif_default == RT_NULL)
                 netif_set_default(ethif->netif);
@@ -316,7 +316,10 @@ struct timeval {
 };
 #endif /* LWIP_TIMEVAL_PRIVATE */
 
+struct lwip_sock;
+
 void lwip_socket_init(void);
+struct lwip_sock *lwip_tryget_socket(int s);
 
 int lwip_accept(int s, struct sockaddr *addr, socklen_t *addrlen);
 int lwip_bind(int s, const struct sockaddr *name, socklen_t namelen);
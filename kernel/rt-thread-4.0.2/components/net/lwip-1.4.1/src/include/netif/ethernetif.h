@@ -11,6 +11,15 @@
 #define ETHERNET_MTU		RT_LWIP_ETH_MTU
 #endif
 
+/* the input function of network interfaces, the packets of NAT connections
+ * are forwarded by the fast path under the core lock */
+#if defined(LWIP_USING_NAT) && LWIP_TCPIP_CORE_LOCKING
+#include "ipv4_nat.h"
+#define ETHERNETIF_INPUT    ip_nat_netif_input
+#else
+#define ETHERNETIF_INPUT    tcpip_input
+#endif
+
 /* eth flag with auto_linkup or phy_linkup */
 #define ETHIF_LINK_AUTOUP	0x0000
 #define ETHIF_LINK_PHYUP	0x0100
@@ -37,6 +37,7 @@
  * 2012-11-12     Bernard      The network interface can be initialized
  *                             after lwIP initialization.
  * 2013-02-28     aozima       fixed list_tcps bug: ipaddr_ntoa isn't reentrant.
+ * 2026-10-18     liujiahao    input by ETHERNETIF_INPUT for the NAT fast path.
  */
 
 #include <rtthread.h>
@@ -496,7 +497,7 @@ rt_err_t eth_device_init_with_flag(struct eth_device *dev, const char *name, rt_
             netmask.addr = inet_addr(RT_LWIP_MSKADDR);
         }
 
-        netifapi_netif_add(netif, &ipaddr, &netmask, &gw, dev, eth_netif_device_init, tcpip_input);
+        netifapi_netif_add(netif, &ipaddr, &netmask, &gw, dev, eth_netif_device_init, ETHERNETIF_INPUT);
     }
 
 #ifdef RT_USING_NETDEV
@@ -142,7 +142,8 @@ struct lwip_setgetsockopt_data {
 };
 #endif /* !LWIP_TCPIP_CORE_LOCKING */
 
-#if !defined(iovec)
+#if !defined(iovec) && !defined(_STRUCT_IOVEC_DEFINED)
+#define _STRUCT_IOVEC_DEFINED
 struct iovec {
   void  *iov_base;
   size_t iov_len;
@@ -446,6 +447,7 @@ struct timeval {
 #define lwip_socket_init() /* Compatibility define, no init needed. */
 void lwip_socket_thread_init(void); /* LWIP_NETCONN_SEM_PER_THREAD==1: initialize thread-local semaphore */
 void lwip_socket_thread_cleanup(void); /* LWIP_NETCONN_SEM_PER_THREAD==1: destroy thread-local semaphore */
+struct lwip_sock *lwip_tryget_socket(int s);
 
 #if LWIP_COMPAT_SOCKETS == 2
 /* This helps code parsers/code completion by not having the COMPAT functions as defines */
@@ -488,6 +488,18 @@ lwip_tryget_socket(int fd)
   return NULL;
 }
 
+/**
+ * Release the socket got by lwip_tryget_socket.
+ *
+ * @param sock the socket returned by lwip_tryget_socket
+ */
+void
+lwip_done_socket(struct lwip_sock *sock)
+{
+  LWIP_UNUSED_ARG(sock);
+  done_socket(sock);
+}
+
 /**
  * Map a externally used socket index to the internal socket representation.
  *
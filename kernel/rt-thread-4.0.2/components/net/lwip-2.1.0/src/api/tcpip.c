@@ -67,6 +67,11 @@ sys_mutex_t lock_tcpip_core;
 
 static void tcpip_thread_handle_msg(struct tcpip_msg *msg);
 
+/* the max number of messages handled per wakeup of tcpip_thread */
+#ifndef TCPIP_MSG_BATCH
+#define TCPIP_MSG_BATCH 1
+#endif
+
 #if !LWIP_TIMERS
 /* wait for a message with timers disabled (e.g. pass a timer-check trigger into tcpip_thread) */
 #define TCPIP_MBOX_FETCH(mbox, msg) sys_mbox_fetch(mbox, msg)
@@ -127,6 +132,9 @@ static void
 tcpip_thread(void *arg)
 {
   struct tcpip_msg *msg;
+#if TCPIP_MSG_BATCH > 1
+  int batch;
+#endif /* TCPIP_MSG_BATCH > 1 */
   LWIP_UNUSED_ARG(arg);
 
   LWIP_MARK_TCPIP_THREAD();
@@ -146,6 +154,18 @@ tcpip_thread(void *arg)
       continue;
     }
     tcpip_thread_handle_msg(msg);
+#if TCPIP_MSG_BATCH > 1
+    /* handle the queued messages without releasing the core lock, the
+       timeouts are checked at the next fetch */
+    for (batch = 1; batch < TCPIP_MSG_BATCH; batch++) {
+      if (sys_arch_mbox_tryfetch(&tcpip_mbox, (void **)&msg) == SYS_MBOX_EMPTY) {
+        break;
+      }
+      if (msg != NULL) {
+        tcpip_thread_handle_msg(msg);
+      }
+    }
+#endif /* TCPIP_MSG_BATCH > 1 */
   }
 }
 
@@ -101,5 +101,11 @@ void sys_arch_assert(const char* file, int line);
 #define SYS_ARCH_PROTECT(level)		rt_enter_critical()
 #define SYS_ARCH_UNPROTECT(level) 	rt_exit_critical()
 
+#ifdef RT_LWIP_USING_OPT_CHECKSUM
+/* the optimized checksum of LWIP_CHKSUM and LWIP_CHKSUM_COPY, sys_chksum.c */
+rt_uint16_t sys_chksum(const void *dataptr, int len);
+rt_uint16_t sys_chksum_copy(void *dst, const void *src, rt_uint16_t len);
+#endif
+
 #endif /* __ARCH_CC_H__ */
 
@@ -56,9 +56,25 @@ typedef u32_t sys_prot_t;
 
 typedef rt_sem_t sys_sem_t;
 typedef rt_mutex_t sys_mutex_t;
+#ifdef RT_LWIP_USING_LOCKFREE_MBOX
+typedef struct lwip_mbox *sys_mbox_t;
+#else
 typedef rt_mailbox_t  sys_mbox_t;
+#endif
 typedef rt_thread_t sys_thread_t;
 
 err_t sys_mbox_trypost_fromisr(sys_mbox_t *q, void *msg);
 
+#ifdef RT_LWIP_USING_MEMP_POOL
+struct memp_desc;
+int sys_memp_init(void);
+void *sys_memp_malloc(const struct memp_desc *desc, rt_size_t size);
+void sys_memp_free(const struct memp_desc *desc, void *mem);
+rt_size_t sys_memp_trim(void);
+
+/* the element of memp pool with MEMP_MEM_MALLOC */
+#define LWIP_MEMP_MALLOC(desc, size)    sys_memp_malloc(desc, size)
+#define LWIP_MEMP_FREE(desc, mem)       sys_memp_free(desc, mem)
+#endif
+
 #endif /* __ARCH_SYS_ARCH_H__ */
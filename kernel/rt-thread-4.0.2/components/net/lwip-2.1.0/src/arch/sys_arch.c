@@ -30,8 +30,11 @@
  *                             export bsd socket symbol for RT-Thread Application Module 
  * 2017-11-15     Bernard      add lock for init_done callback.
  * 2018-11-02     MurphyZhao   port to lwip2.1.0
+ * 2026-10-18     liujiahao    add lock-free mailbox
+ * 2026-10-18     liujiahao    add memory pools for memp
  */
 
+#include <rthw.h>
 #include <rtthread.h>
 
 #include "lwip/sys.h"
@@ -173,6 +176,10 @@ int lwip_system_init(void)
         return 0;
     }
 
+#ifdef RT_LWIP_USING_MEMP_POOL
+    sys_memp_init();
+#endif
+
     eth_system_device_init_private();
 
     /* set default netif to NULL */
@@ -359,7 +366,8 @@ err_t sys_mutex_new(sys_mutex_t *mutex)
     rt_snprintf(tname, RT_NAME_MAX, "%s%d", SYS_LWIP_MUTEX_NAME, counter);
     counter ++;
 
-    tmpmutex = rt_mutex_create(tname, RT_IPC_FLAG_FIFO);
+    /* the waiters of the core lock get it in the priority order */
+    tmpmutex = rt_mutex_create(tname, RT_IPC_FLAG_PRIO);
     if (tmpmutex == RT_NULL)
         return ERR_MEM;
     else
@@ -420,6 +428,356 @@ void sys_mutex_set_invalid(sys_mutex_t *mutex)
 
 /* ====================== Mailbox ====================== */
 
+#ifdef RT_LWIP_USING_LOCKFREE_MBOX
+/*
+ * The mailbox is a ring of cells with the sequence numbers, the producers and
+ * the consumers claim a cell by compare-and-swap on the tail or the head, so
+ * the messages are exchanged without the interrupt disabled. A thread sleeps
+ * on the semaphore only when the ring is empty or full, and it is waken up
+ * only when it is counted in the waiting number.
+ */
+struct lwip_mbox_cell
+{
+    volatile rt_uint32_t sequence;
+    void *msg;
+};
+
+struct lwip_mbox
+{
+    rt_uint32_t mask;
+    volatile rt_uint32_t head;
+    volatile rt_uint32_t tail;
+
+    volatile rt_uint32_t recv_waiting;
+    volatile rt_uint32_t send_waiting;
+    struct rt_semaphore recv_sem;
+    struct rt_semaphore send_sem;
+
+    struct lwip_mbox_cell *cells;
+};
+
+#ifdef __GNUC__
+#define MBOX_CAS(ptr, old, value)   __sync_bool_compare_and_swap(ptr, old, value)
+#define MBOX_ADD(ptr, value)        __sync_add_and_fetch(ptr, value)
+#define MBOX_BARRIER()              __sync_synchronize()
+#else
+static rt_bool_t mbox_cas(volatile rt_uint32_t *ptr, rt_uint32_t old, rt_uint32_t value)
+{
+    rt_bool_t result = RT_FALSE;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (*ptr == old)
+    {
+        *ptr = value;
+        result = RT_TRUE;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+
+static rt_uint32_t mbox_add(volatile rt_uint32_t *ptr, rt_uint32_t value)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    value += *ptr;
+    *ptr = value;
+    rt_hw_interrupt_enable(level);
+
+    return value;
+}
+
+#define MBOX_CAS(ptr, old, value)   mbox_cas(ptr, old, value)
+#define MBOX_ADD(ptr, value)        mbox_add(ptr, value)
+/* the function call is a compiler barrier, it's enough for single core */
+#define MBOX_BARRIER()              rt_hw_interrupt_enable(rt_hw_interrupt_disable())
+#endif
+
+static rt_bool_t mbox_push(struct lwip_mbox *mbox, void *msg)
+{
+    struct lwip_mbox_cell *cell;
+    rt_uint32_t pos = mbox->tail;
+    rt_int32_t diff;
+
+    while (1)
+    {
+        cell = &mbox->cells[pos & mbox->mask];
+        diff = (rt_int32_t)(cell->sequence - pos);
+        if (diff == 0)
+        {
+            if (MBOX_CAS(&mbox->tail, pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+        {
+            /* the ring is full */
+            return RT_FALSE;
+        }
+        pos = mbox->tail;
+    }
+
+    cell->msg = msg;
+    /* the message must be ready before the consumer sees the sequence */
+    MBOX_BARRIER();
+    cell->sequence = pos + 1;
+
+    return RT_TRUE;
+}
+
+static rt_bool_t mbox_pop(struct lwip_mbox *mbox, void **msg)
+{
+    struct lwip_mbox_cell *cell;
+    rt_uint32_t pos = mbox->head;
+    rt_int32_t diff;
+
+    while (1)
+    {
+        cell = &mbox->cells[pos & mbox->mask];
+        diff = (rt_int32_t)(cell->sequence - (pos + 1));
+        if (diff == 0)
+        {
+            if (MBOX_CAS(&mbox->head, pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+        {
+            /* the ring is empty, or the producer is filling the cell */
+            return RT_FALSE;
+        }
+        pos = mbox->head;
+    }
+
+    *msg = cell->msg;
+    MBOX_BARRIER();
+    /* the cell is free for the producer of next round */
+    cell->sequence = pos + mbox->mask + 1;
+
+    return RT_TRUE;
+}
+
+static void mbox_wakeup(volatile rt_uint32_t *waiting, struct rt_semaphore *sem)
+{
+    /* the waiting number is read after the ring is updated */
+    MBOX_BARRIER();
+
+    /* a pending value wakes up the next waiter already, and the waiter passes
+     * the wakeup on if there are more messages or cells */
+    if (*waiting != 0 && sem->value == 0)
+        rt_sem_release(sem);
+}
+
+static void mbox_pushed(struct lwip_mbox *mbox)
+{
+    mbox_wakeup(&mbox->recv_waiting, &mbox->recv_sem);
+    if (mbox->tail - mbox->head <= mbox->mask)
+        mbox_wakeup(&mbox->send_waiting, &mbox->send_sem);
+}
+
+static void mbox_popped(struct lwip_mbox *mbox)
+{
+    mbox_wakeup(&mbox->send_waiting, &mbox->send_sem);
+    if (mbox->tail != mbox->head)
+        mbox_wakeup(&mbox->recv_waiting, &mbox->recv_sem);
+}
+
+/*
+ * Create an empty mailbox for maximum "size" elements, the size is rounded up
+ * to the power of 2
+ *
+ * @return the operation status, ERR_OK on OK; others on error
+ */
+err_t sys_mbox_new(sys_mbox_t *mbox, int size)
+{
+    static unsigned short counter = 0;
+    char tname[RT_NAME_MAX];
+    struct lwip_mbox *tmpmbox;
+    rt_uint32_t cells = 2, index;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    while ((int)cells < size)
+        cells <<= 1;
+
+    tmpmbox = (struct lwip_mbox *)rt_malloc(sizeof(struct lwip_mbox) +
+                                            cells * sizeof(struct lwip_mbox_cell));
+    if (tmpmbox == RT_NULL)
+        return ERR_MEM;
+
+    rt_snprintf(tname, RT_NAME_MAX, "%s%d", SYS_LWIP_MBOX_NAME, counter);
+    counter ++;
+
+    tmpmbox->mask = cells - 1;
+    tmpmbox->head = 0;
+    tmpmbox->tail = 0;
+    tmpmbox->recv_waiting = 0;
+    tmpmbox->send_waiting = 0;
+    tmpmbox->cells = (struct lwip_mbox_cell *)(tmpmbox + 1);
+    for (index = 0; index < cells; index ++)
+    {
+        tmpmbox->cells[index].sequence = index;
+        tmpmbox->cells[index].msg = RT_NULL;
+    }
+    rt_sem_init(&tmpmbox->recv_sem, tname, 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&tmpmbox->send_sem, tname, 0, RT_IPC_FLAG_FIFO);
+
+    *mbox = tmpmbox;
+
+    return ERR_OK;
+}
+
+/*
+ * Deallocate a mailbox
+ */
+void sys_mbox_free(sys_mbox_t *mbox)
+{
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    rt_sem_detach(&(*mbox)->recv_sem);
+    rt_sem_detach(&(*mbox)->send_sem);
+    rt_free(*mbox);
+
+    return;
+}
+
+/** Post a message to an mbox - may not fail
+ * -> blocks if full, only used from tasks not from ISR
+ * @param mbox mbox to posts the message
+ * @param msg message to post (ATTENTION: can be NULL)
+ */
+void sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+    struct lwip_mbox *m = *mbox;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    while (!mbox_push(m, msg))
+    {
+        /* count in the waiters before checking the ring again */
+        MBOX_ADD(&m->send_waiting, 1);
+        if (!mbox_push(m, msg))
+        {
+            rt_sem_take(&m->send_sem, RT_WAITING_FOREVER);
+            MBOX_ADD(&m->send_waiting, (rt_uint32_t)-1);
+            continue;
+        }
+        MBOX_ADD(&m->send_waiting, (rt_uint32_t)-1);
+        break;
+    }
+    mbox_pushed(m);
+
+    return;
+}
+
+/*
+ * Try to post the "msg" to the mailbox
+ *
+ * @return return ERR_OK if the "msg" is posted, ERR_MEM if the mailbox is full
+ */
+err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+    if (!mbox_push(*mbox, msg))
+        return ERR_MEM;
+
+    mbox_pushed(*mbox);
+
+    return ERR_OK;
+}
+
+err_t
+sys_mbox_trypost_fromisr(sys_mbox_t *q, void *msg)
+{
+  return sys_mbox_trypost(q, msg);
+}
+
+/** Wait for a new message to arrive in the mbox
+ * @param mbox mbox to get a message from
+ * @param msg pointer where the message is stored
+ * @param timeout maximum time (in milliseconds) to wait for a message
+ * @return time (in milliseconds) waited for a message, may be 0 if not waited
+           or SYS_ARCH_TIMEOUT on timeout
+ *         The returned time has to be accurate to prevent timer jitter!
+ */
+u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
+{
+    struct lwip_mbox *m = *mbox;
+    rt_int32_t t, wait;
+    u32_t tick;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* get the begin tick */
+    tick = rt_tick_get();
+
+    if(timeout == 0)
+        t = RT_WAITING_FOREVER;
+    else
+    {
+        /* convirt msecond to os tick */
+        if (timeout < (1000/RT_TICK_PER_SECOND))
+            t = 1;
+        else
+            t = timeout / (1000/RT_TICK_PER_SECOND);
+    }
+
+    while (!mbox_pop(m, msg))
+    {
+        /* count in the waiters before checking the ring again */
+        MBOX_ADD(&m->recv_waiting, 1);
+        if (mbox_pop(m, msg))
+        {
+            MBOX_ADD(&m->recv_waiting, (rt_uint32_t)-1);
+            break;
+        }
+
+        wait = RT_WAITING_FOREVER;
+        if (t != RT_WAITING_FOREVER)
+        {
+            wait = t - (rt_int32_t)(rt_tick_get() - tick);
+            if (wait <= 0)
+            {
+                MBOX_ADD(&m->recv_waiting, (rt_uint32_t)-1);
+                return SYS_ARCH_TIMEOUT;
+            }
+        }
+
+        /* the wakeup may be stale, check the ring again */
+        rt_sem_take(&m->recv_sem, wait);
+        MBOX_ADD(&m->recv_waiting, (rt_uint32_t)-1);
+    }
+    mbox_popped(m);
+
+    /* get elapse msecond */
+    tick = rt_tick_get() - tick;
+
+    /* convert tick to msecond */
+    tick = tick * (1000 / RT_TICK_PER_SECOND);
+    if (tick == 0)
+        tick = 1;
+
+    return tick;
+}
+
+/** Wait for a new message to arrive in the mbox
+ * @param mbox mbox to get a message from
+ * @param msg pointer where the message is stored
+ * @param timeout maximum time (in milliseconds) to wait for a message
+ * @return 0 (milliseconds) if a message has been received
+ *         or SYS_MBOX_EMPTY if the mailbox is empty
+ */
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+    if (!mbox_pop(*mbox, msg))
+        return SYS_MBOX_EMPTY;
+
+    mbox_popped(*mbox);
+
+    return 0;
+}
+
+#else
+
 /*
  * Create an empty mailbox for maximum "size" elements
  *
@@ -566,6 +924,8 @@ u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
     return ret;
 }
 
+#endif /* RT_LWIP_USING_LOCKFREE_MBOX */
+
 #ifndef sys_mbox_valid
 /** Check if an mbox is valid/allocated:
  *  return 1 for valid, 0 for invalid
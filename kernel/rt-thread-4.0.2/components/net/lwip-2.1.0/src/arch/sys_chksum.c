@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#include <rtthread.h>
+
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/inet_chksum.h"
+
+/*
+ * The Internet checksum of LWIP_CHKSUM and LWIP_CHKSUM_COPY. The bulk of the
+ * data is summed as the aligned 32-bit words, the folded sum of the words is
+ * the same as the sum of 16-bit words in both byte orders:
+ *
+ * - Cortex-M3/M4/M7 (Thumb-2 with GCC): the add with carry chain, 4 words per loop.
+ * - Cortex-A with NEON: pairwise add of 8 halfwords into 4 lanes, 32 bytes per loop.
+ * - x86 of the simulator: SSE2 16 bytes or AVX2 32 bytes per loop.
+ * - others: the unrolled 64-bit accumulation in C.
+ *
+ * The lanes of SIMD are 32 bits, they're flushed to a 64-bit sum before overflow.
+ */
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SYS_CHKSUM_NEON
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define SYS_CHKSUM_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SYS_CHKSUM_SSE2
+#elif defined(__GNUC__) && defined(__thumb2__)
+#define SYS_CHKSUM_THUMB2
+#endif
+
+/* the loops of SIMD before the 32-bit lanes are flushed */
+#define SYS_CHKSUM_SIMD_LOOPS   8192
+
+static rt_uint16_t sys_chksum_fold(rt_uint64_t sum)
+{
+    sum = (sum >> 32) + (sum & 0xffffffffUL);
+    sum = (sum >> 16) + (sum & 0xffffUL);
+    sum = (sum >> 16) + (sum & 0xffffUL);
+    sum = (sum >> 16) + (sum & 0xffffUL);
+
+    return (rt_uint16_t)sum;
+}
+
+#if defined(SYS_CHKSUM_NEON)
+static rt_uint64_t sys_chksum_words(rt_uint32_t *dst, const rt_uint32_t *src, int words)
+{
+    uint64x2_t sum64 = vdupq_n_u64(0);
+    rt_uint64_t sum;
+
+    while (words >= 8)
+    {
+        uint32x4_t acc = vdupq_n_u32(0);
+        int loops = words / 8 > SYS_CHKSUM_SIMD_LOOPS ? SYS_CHKSUM_SIMD_LOOPS : words / 8;
+
+        words -= loops * 8;
+        while (loops --)
+        {
+            uint16x8_t v0 = vld1q_u16((const uint16_t *)src);
+            uint16x8_t v1 = vld1q_u16((const uint16_t *)(src + 4));
+
+            if (dst != RT_NULL)
+            {
+                vst1q_u16((uint16_t *)dst, v0);
+                vst1q_u16((uint16_t *)(dst + 4), v1);
+                dst += 8;
+            }
+            acc = vpadalq_u16(acc, v0);
+            acc = vpadalq_u16(acc, v1);
+            src += 8;
+        }
+        sum64 = vpadalq_u32(sum64, acc);
+    }
+    sum = vgetq_lane_u64(sum64, 0) + vgetq_lane_u64(sum64, 1);
+
+    while (words --)
+    {
+        if (dst != RT_NULL)
+            *dst ++ = *src;
+        sum += *src ++;
+    }
+
+    return sum;
+}
+#elif defined(SYS_CHKSUM_AVX2) || defined(SYS_CHKSUM_SSE2)
+#ifdef SYS_CHKSUM_AVX2
+#define SYS_CHKSUM_VEC_WORDS    8
+typedef __m256i sys_chksum_vec_t;
+#define sys_chksum_vec_zero()   _mm256_setzero_si256()
+#define sys_chksum_vec_load(p)  _mm256_loadu_si256((const __m256i *)(p))
+#define sys_chksum_vec_store(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define sys_chksum_vec_add(a, b) _mm256_add_epi32(a, b)
+#define sys_chksum_vec_lo(v, z) _mm256_unpacklo_epi16(v, z)
+#define sys_chksum_vec_hi(v, z) _mm256_unpackhi_epi16(v, z)
+#else
+#define SYS_CHKSUM_VEC_WORDS    4
+typedef __m128i sys_chksum_vec_t;
+#define sys_chksum_vec_zero()   _mm_setzero_si128()
+#define sys_chksum_vec_load(p)  _mm_loadu_si128((const __m128i *)(p))
+#define sys_chksum_vec_store(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define sys_chksum_vec_add(a, b) _mm_add_epi32(a, b)
+#define sys_chksum_vec_lo(v, z) _mm_unpacklo_epi16(v, z)
+#define sys_chksum_vec_hi(v, z) _mm_unpackhi_epi16(v, z)
+#endif /* SYS_CHKSUM_AVX2 */
+
+static rt_uint64_t sys_chksum_words(rt_uint32_t *dst, const rt_uint32_t *src, int words)
+{
+    sys_chksum_vec_t zero = sys_chksum_vec_zero();
+    rt_uint32_t lanes[SYS_CHKSUM_VEC_WORDS];
+    rt_uint64_t sum = 0;
+    int index;
+
+    while (words >= SYS_CHKSUM_VEC_WORDS)
+    {
+        sys_chksum_vec_t acc = zero;
+        int loops = words / SYS_CHKSUM_VEC_WORDS;
+
+        if (loops > SYS_CHKSUM_SIMD_LOOPS)
+            loops = SYS_CHKSUM_SIMD_LOOPS;
+        words -= loops * SYS_CHKSUM_VEC_WORDS;
+        while (loops --)
+        {
+            sys_chksum_vec_t v = sys_chksum_vec_load(src);
+
+            if (dst != RT_NULL)
+            {
+                sys_chksum_vec_store(dst, v);
+                dst += SYS_CHKSUM_VEC_WORDS;
+            }
+            /* zero extend the halfwords to the 32-bit lanes */
+            acc = sys_chksum_vec_add(acc, sys_chksum_vec_lo(v, zero));
+            acc = sys_chksum_vec_add(acc, sys_chksum_vec_hi(v, zero));
+            src += SYS_CHKSUM_VEC_WORDS;
+        }
+
+        sys_chksum_vec_store(lanes, acc);
+        for (index = 0; index < SYS_CHKSUM_VEC_WORDS; index ++)
+            sum += lanes[index];
+    }
+
+    while (words --)
+    {
+        if (dst != RT_NULL)
+            *dst ++ = *src;
+        sum += *src ++;
+    }
+
+    return sum;
+}
+#elif defined(SYS_CHKSUM_THUMB2)
+static rt_uint64_t sys_chksum_words(rt_uint32_t *dst, const rt_uint32_t *src, int words)
+{
+    rt_uint32_t sum = 0, carry = 0, w0, w1, w2, w3;
+    rt_uint64_t total;
+
+    /* the carries out of the 32-bit sum are counted, the sum is 64 bits */
+    if (dst != RT_NULL)
+    {
+        while (words >= 4)
+        {
+            __asm__ volatile(
+                "ldr    %[w0], [%[src]]         \n"
+                "ldr    %[w1], [%[src], #4]     \n"
+                "ldr    %[w2], [%[src], #8]     \n"
+                "ldr    %[w3], [%[src], #12]    \n"
+                "str    %[w0], [%[dst]]         \n"
+                "str    %[w1], [%[dst], #4]     \n"
+                "str    %[w2], [%[dst], #8]     \n"
+                "str    %[w3], [%[dst], #12]    \n"
+                "adds   %[sum], %[sum], %[w0]   \n"
+                "adcs   %[sum], %[sum], %[w1]   \n"
+                "adcs   %[sum], %[sum], %[w2]   \n"
+                "adcs   %[sum], %[sum], %[w3]   \n"
+                "adc    %[carry], %[carry], #0  \n"
+                : [sum] "+r" (sum), [carry] "+r" (carry), [w0] "=&r" (w0), [w1] "=&r" (w1), [w2] "=&r" (w2), [w3] "=&r" (w3)
+                : [src] "r" (src), [dst] "r" (dst)
+                : "cc", "memory");
+            src += 4;
+            dst += 4;
+            words -= 4;
+        }
+    }
+    else
+    {
+        while (words >= 4)
+        {
+            __asm__ volatile(
+                "ldr    %[w0], [%[src]]         \n"
+                "ldr    %[w1], [%[src], #4]     \n"
+                "ldr    %[w2], [%[src], #8]     \n"
+                "ldr    %[w3], [%[src], #12]    \n"
+                "adds   %[sum], %[sum], %[w0]   \n"
+                "adcs   %[sum], %[sum], %[w1]   \n"
+                "adcs   %[sum], %[sum], %[w2]   \n"
+                "adcs   %[sum], %[sum], %[w3]   \n"
+                "adc    %[carry], %[carry], #0  \n"
+                : [sum] "+r" (sum), [carry] "+r" (carry), [w0] "=&r" (w0), [w1] "=&r" (w1), [w2] "=&r" (w2), [w3] "=&r" (w3)
+                : [src] "r" (src)
+                : "cc", "memory");
+            src += 4;
+            words -= 4;
+        }
+    }
+
+    total = ((rt_uint64_t)carry << 32) + sum;
+    while (words --)
+    {
+        if (dst != RT_NULL)
+            *dst ++ = *src;
+        total += *src ++;
+    }
+
+    return total;
+}
+#else
+static rt_uint64_t sys_chksum_words(rt_uint32_t *dst, const rt_uint32_t *src, int words)
+{
+    rt_uint64_t sum = 0;
+
+    if (dst != RT_NULL)
+    {
+        while (words >= 4)
+        {
+            rt_uint32_t w0 = src[0], w1 = src[1], w2 = src[2], w3 = src[3];
+
+            dst[0] = w0;
+            dst[1] = w1;
+            dst[2] = w2;
+            dst[3] = w3;
+            sum += (rt_uint64_t)w0 + w1 + w2 + w3;
+            src += 4;
+            dst += 4;
+            words -= 4;
+        }
+    }
+    else
+    {
+        while (words >= 4)
+        {
+            sum += (rt_uint64_t)src[0] + src[1] + src[2] + src[3];
+            src += 4;
+            words -= 4;
+        }
+    }
+
+    while (words --)
+    {
+        if (dst != RT_NULL)
+            *dst ++ = *src;
+        sum += *src ++;
+    }
+
+    return sum;
+}
+#endif
+
+/*
+ * The checksum of the source, it's copied to the destination if it's not
+ * RT_NULL. The source and the destination have the same alignment of words.
+ */
+static rt_uint16_t sys_chksum_do(rt_uint8_t *dst, const rt_uint8_t *src, int len)
+{
+    rt_uint64_t sum = 0;
+    rt_uint16_t t = 0;
+    int odd = ((rt_ubase_t)src & 1);
+    int words;
+
+    /* get aligned to the halfword as lwip_standard_chksum() */
+    if (odd && len > 0)
+    {
+        ((rt_uint8_t *)&t)[1] = *src;
+        if (dst != RT_NULL)
+            *dst ++ = *src;
+        src ++;
+        len --;
+    }
+
+    /* get aligned to the word */
+    if (((rt_ubase_t)src & 2) && len > 1)
+    {
+        sum += *(const rt_uint16_t *)src;
+        if (dst != RT_NULL)
+        {
+            *(rt_uint16_t *)dst = *(const rt_uint16_t *)src;
+            dst += 2;
+        }
+        src += 2;
+        len -= 2;
+    }
+
+    words = len >> 2;
+    if (words > 0)
+    {
+        sum += sys_chksum_words((rt_uint32_t *)dst, (const rt_uint32_t *)src, words);
+        if (dst != RT_NULL)
+            dst += words << 2;
+        src += words << 2;
+        len &= 3;
+    }
+
+    if (len > 1)
+    {
+        sum += *(const rt_uint16_t *)src;
+        if (dst != RT_NULL)
+        {
+            *(rt_uint16_t *)dst = *(const rt_uint16_t *)src;
+            dst += 2;
+        }
+        src += 2;
+        len -= 2;
+    }
+
+    /* the left-over byte */
+    if (len > 0)
+    {
+        ((rt_uint8_t *)&t)[0] = *src;
+        if (dst != RT_NULL)
+            *dst = *src;
+    }
+
+    t = sys_chksum_fold(sum + t);
+    if (odd)
+        t = SWAP_BYTES_IN_WORD(t);
+
+    return t;
+}
+
+/**
+ * This function will calculate the Internet checksum, it's LWIP_CHKSUM and
+ * has the same result as lwip_standard_chksum().
+ *
+ * @param dataptr the data at any boundary.
+ * @param len the length of data.
+ *
+ * @return host order lwip checksum (non-inverted Internet sum).
+ */
+rt_uint16_t sys_chksum(const void *dataptr, int len)
+{
+    return sys_chksum_do(RT_NULL, (const rt_uint8_t *)dataptr, len);
+}
+RTM_EXPORT(sys_chksum);
+
+/**
+ * This function will copy the data and calculate its Internet checksum in one
+ * pass, it's LWIP_CHKSUM_COPY.
+ *
+ * @param dst the destination.
+ * @param src the source.
+ * @param len the length of data.
+ *
+ * @return the checksum of the copied data as sys_chksum().
+ */
+rt_uint16_t sys_chksum_copy(void *dst, const void *src, rt_uint16_t len)
+{
+    /* the words of the source and the destination don't line up */
+    if (((rt_ubase_t)dst ^ (rt_ubase_t)src) & 3)
+    {
+        MEMCPY(dst, src, len);
+        return sys_chksum(dst, len);
+    }
+
+    return sys_chksum_do((rt_uint8_t *)dst, (const rt_uint8_t *)src, len);
+}
+RTM_EXPORT(sys_chksum_copy);
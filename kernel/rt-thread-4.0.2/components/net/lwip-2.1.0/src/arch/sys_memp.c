@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+#include "lwip/mem.h"
+#include "lwip/memp.h"
+#include "lwip/priv/memp_priv.h"
+
+/*
+ * The lwIP memp pools with MEMP_MEM_MALLOC. Each pool is a list of RT-Thread
+ * memory pools, the chunks, allocated from the memory heap of lwIP on demand.
+ * The chunks are allocated in order from the list head, so the chunks at the
+ * tail become idle after the bursts, and the idle chunks are freed when the
+ * memory heap is exhausted or by sys_memp_trim().
+ */
+
+#ifndef RT_LWIP_MEMP_HEAP_SIZE
+#define RT_LWIP_MEMP_HEAP_SIZE      16384
+#endif
+
+#ifndef RT_LWIP_MEMP_CHUNK_BLOCKS
+#define RT_LWIP_MEMP_CHUNK_BLOCKS   4
+#endif
+
+struct sys_memp_chunk
+{
+    struct rt_mempool mp;
+    struct sys_memp_chunk *next;
+};
+
+struct sys_memp_pool
+{
+    const struct memp_desc *desc;
+    rt_size_t block_size;
+    struct sys_memp_chunk *chunks;
+
+    rt_uint32_t used;
+    rt_uint32_t max_used;                   /* the high-water of used blocks */
+    rt_uint32_t total;                      /* the blocks of all chunks */
+    rt_uint32_t chunk_count;
+    rt_uint32_t errors;
+};
+
+static const char *const sys_memp_names[MEMP_MAX] =
+{
+#define LWIP_MEMPOOL(name,num,size,desc) desc,
+#include "lwip/priv/memp_std.h"
+};
+
+static struct sys_memp_pool sys_memp_pools[MEMP_MAX];
+static struct rt_memheap sys_memp_heap;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t sys_memp_heap_buf[RT_LWIP_MEMP_HEAP_SIZE];
+
+static struct sys_memp_pool *sys_memp_pool_get(const struct memp_desc *desc)
+{
+    int index;
+
+    for (index = 0; index < MEMP_MAX; index ++)
+    {
+        if (sys_memp_pools[index].desc == desc)
+            return &sys_memp_pools[index];
+    }
+
+    /* the private pool of LWIP_MEMPOOL_DECLARE */
+    return RT_NULL;
+}
+
+static struct sys_memp_chunk *sys_memp_chunk_alloc(struct sys_memp_pool *pool)
+{
+    struct sys_memp_chunk *chunk;
+    rt_size_t size;
+
+    size = RT_LWIP_MEMP_CHUNK_BLOCKS * (RT_ALIGN(pool->block_size, RT_ALIGN_SIZE) + sizeof(rt_uint8_t *));
+
+    chunk = (struct sys_memp_chunk *)rt_memheap_alloc(&sys_memp_heap, sizeof(struct sys_memp_chunk) + size);
+    if (chunk == RT_NULL)
+    {
+        /* the memory pressure, free the idle chunks of all pools and try again */
+        if (sys_memp_trim() == 0)
+            return RT_NULL;
+        chunk = (struct sys_memp_chunk *)rt_memheap_alloc(&sys_memp_heap, sizeof(struct sys_memp_chunk) + size);
+        if (chunk == RT_NULL)
+            return RT_NULL;
+    }
+
+    rt_mp_init(&chunk->mp, "lwipmp", chunk + 1, size, pool->block_size);
+    chunk->next = RT_NULL;
+
+    return chunk;
+}
+
+/**
+ * This function will allocate an element of lwIP memp pool, the pool grows by
+ * a chunk if all of its chunks are used.
+ *
+ * @param desc the descriptor of memp pool.
+ * @param size the size of element.
+ *
+ * @return the element, or RT_NULL on no memory.
+ */
+void *sys_memp_malloc(const struct memp_desc *desc, rt_size_t size)
+{
+    struct sys_memp_pool *pool;
+    struct sys_memp_chunk *chunk, **tail;
+    rt_base_t level;
+    void *mem = RT_NULL;
+
+    pool = sys_memp_pool_get(desc);
+    if (pool == RT_NULL)
+        return mem_malloc(size);
+    RT_ASSERT(size <= pool->block_size);
+
+    level = rt_hw_interrupt_disable();
+    for (tail = &pool->chunks; *tail != RT_NULL; tail = &(*tail)->next)
+    {
+        mem = rt_mp_alloc(&(*tail)->mp, 0);
+        if (mem != RT_NULL)
+            break;
+    }
+    rt_hw_interrupt_enable(level);
+
+    /* the memory heap can't be used in the interrupt */
+    if (mem == RT_NULL && rt_interrupt_get_nest() == 0)
+    {
+        chunk = sys_memp_chunk_alloc(pool);
+        if (chunk != RT_NULL)
+        {
+            mem = rt_mp_alloc(&chunk->mp, 0);
+
+            level = rt_hw_interrupt_disable();
+            for (tail = &pool->chunks; *tail != RT_NULL; tail = &(*tail)->next);
+            *tail = chunk;
+            pool->total += chunk->mp.block_total_count;
+            pool->chunk_count ++;
+            rt_hw_interrupt_enable(level);
+        }
+    }
+
+    level = rt_hw_interrupt_disable();
+    if (mem != RT_NULL)
+    {
+        pool->used ++;
+        if (pool->used > pool->max_used)
+            pool->max_used = pool->used;
+    }
+    else
+    {
+        pool->errors ++;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return mem;
+}
+
+/**
+ * This function will free an element of lwIP memp pool.
+ *
+ * @param desc the descriptor of memp pool.
+ * @param mem the element.
+ */
+void sys_memp_free(const struct memp_desc *desc, void *mem)
+{
+    struct sys_memp_pool *pool;
+    rt_base_t level;
+
+    pool = sys_memp_pool_get(desc);
+    if (pool == RT_NULL)
+    {
+        mem_free(mem);
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    pool->used --;
+    rt_hw_interrupt_enable(level);
+
+    /* the block knows its chunk */
+    rt_mp_free(mem);
+}
+
+/**
+ * This function will free the idle chunks, which have no used block, of all
+ * lwIP memp pools to the memory heap of lwIP.
+ *
+ * @return the number of freed bytes.
+ */
+rt_size_t sys_memp_trim(void)
+{
+    struct sys_memp_chunk *chunk, **prev;
+    rt_size_t freed = 0;
+    rt_base_t level;
+    int index;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    for (index = 0; index < MEMP_MAX; index ++)
+    {
+        struct sys_memp_pool *pool = &sys_memp_pools[index];
+
+        while (1)
+        {
+            level = rt_hw_interrupt_disable();
+            for (prev = &pool->chunks; *prev != RT_NULL; prev = &(*prev)->next)
+            {
+                if ((*prev)->mp.block_free_count == (*prev)->mp.block_total_count)
+                    break;
+            }
+            chunk = *prev;
+            if (chunk != RT_NULL)
+            {
+                /* no one can allocate from the chunk after it's removed */
+                *prev = chunk->next;
+                pool->total -= chunk->mp.block_total_count;
+                pool->chunk_count --;
+            }
+            rt_hw_interrupt_enable(level);
+
+            if (chunk == RT_NULL)
+                break;
+
+            freed += sizeof(struct sys_memp_chunk) + chunk->mp.size;
+            rt_mp_detach(&chunk->mp);
+            rt_memheap_free(chunk);
+        }
+    }
+
+    return freed;
+}
+RTM_EXPORT(sys_memp_trim);
+
+/**
+ * This function will initialize the memory heap and the pools of lwIP memp.
+ *
+ * @return RT_EOK on successful.
+ */
+int sys_memp_init(void)
+{
+    int index;
+
+    rt_memheap_init(&sys_memp_heap, "lwipmem", sys_memp_heap_buf, sizeof(sys_memp_heap_buf));
+
+    for (index = 0; index < MEMP_MAX; index ++)
+    {
+        rt_memset(&sys_memp_pools[index], 0, sizeof(struct sys_memp_pool));
+        sys_memp_pools[index].desc = memp_pools[index];
+        sys_memp_pools[index].block_size = MEMP_SIZE + MEMP_ALIGN_SIZE(memp_pools[index]->size);
+    }
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void list_memp(void)
+{
+    struct sys_memp_pool *pool;
+    int index;
+
+    rt_kprintf("pool             size  used  max   total chunk error\n");
+    rt_kprintf("---------------- ----- ----- ----- ----- ----- -----\n");
+    for (index = 0; index < MEMP_MAX; index ++)
+    {
+        pool = &sys_memp_pools[index];
+        rt_kprintf("%-16.16s %-5d %-5d %-5d %-5d %-5d %-5d\n", sys_memp_names[index],
+                   pool->block_size, pool->used, pool->max_used, pool->total,
+                   pool->chunk_count, pool->errors);
+    }
+    rt_kprintf("heap %d bytes, %d available, %d max used\n", sys_memp_heap.pool_size,
+               sys_memp_heap.available_size, sys_memp_heap.max_used_size);
+}
+MSH_CMD_EXPORT(list_memp, list lwIP memp pools);
+
+static void memp_trim(void)
+{
+    rt_kprintf("%d bytes freed\n", sys_memp_trim());
+}
+MSH_CMD_EXPORT(memp_trim, free the idle chunks of lwIP memp pools);
+#endif /* RT_USING_FINSH */
@@ -87,6 +87,14 @@ const struct memp_desc *const memp_pools[MEMP_MAX] = {
 #include LWIP_HOOK_FILENAME
 #endif
 
+#if MEMP_MEM_MALLOC
+/* the port may allocate the elements from the memory of each pool */
+#ifndef LWIP_MEMP_MALLOC
+#define LWIP_MEMP_MALLOC(desc, size) mem_malloc(size)
+#define LWIP_MEMP_FREE(desc, mem)    mem_free(mem)
+#endif
+#endif /* MEMP_MEM_MALLOC */
+
 #if MEMP_MEM_MALLOC && MEMP_OVERFLOW_CHECK >= 2
 #undef MEMP_OVERFLOW_CHECK
 /* MEMP_OVERFLOW_CHECK >= 2 does not work with MEMP_MEM_MALLOC, use 1 instead */
@@ -251,7 +259,7 @@ do_memp_malloc_pool_fn(const struct memp_desc *desc, const char *file, const int
   SYS_ARCH_DECL_PROTECT(old_level);
 
 #if MEMP_MEM_MALLOC
-  memp = (struct memp *)mem_malloc(MEMP_SIZE + MEMP_ALIGN_SIZE(desc->size));
+  memp = (struct memp *)LWIP_MEMP_MALLOC(desc, MEMP_SIZE + MEMP_ALIGN_SIZE(desc->size));
   SYS_ARCH_PROTECT(old_level);
 #else /* MEMP_MEM_MALLOC */
   SYS_ARCH_PROTECT(old_level);
@@ -380,7 +388,7 @@ do_memp_free_pool(const struct memp_desc *desc, void *mem)
 #if MEMP_MEM_MALLOC
   LWIP_UNUSED_ARG(desc);
   SYS_ARCH_UNPROTECT(old_level);
-  mem_free(memp);
+  LWIP_MEMP_FREE(desc, memp);
 #else /* MEMP_MEM_MALLOC */
   memp->next = *desc->tab;
   *desc->tab = memp;
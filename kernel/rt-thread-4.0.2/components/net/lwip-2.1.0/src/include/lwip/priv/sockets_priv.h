@@ -141,6 +141,8 @@ struct lwip_setgetsockopt_data {
 #endif
 
 struct lwip_sock* lwip_socket_dbg_get_socket(int fd);
+struct lwip_sock* lwip_tryget_socket(int fd);
+void lwip_done_socket(struct lwip_sock *sock);
 
 #if LWIP_SOCKET_SELECT || LWIP_SOCKET_POLL
 
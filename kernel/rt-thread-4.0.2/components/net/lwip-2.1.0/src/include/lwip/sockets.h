@@ -117,7 +117,8 @@ typedef u32_t socklen_t;
 #error "IOV_MAX larger than supported by LwIP"
 #endif /* IOV_MAX */
 
-#if !defined(iovec)
+#if !defined(iovec) && !defined(_STRUCT_IOVEC_DEFINED)
+#define _STRUCT_IOVEC_DEFINED
 struct iovec {
   void  *iov_base;
   size_t iov_len;
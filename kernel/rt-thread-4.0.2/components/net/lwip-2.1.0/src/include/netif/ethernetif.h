@@ -15,6 +15,11 @@
 #define ETHIF_LINK_AUTOUP	0x0000
 #define ETHIF_LINK_PHYUP	0x0100
 
+/* the ethernetif supports the Rx polling with eth_rx_irq, it's done by the Rx thread */
+#ifndef LWIP_NO_RX_THREAD
+#define ETHIF_RX_POLLING
+#endif
+
 struct eth_device
 {
     /* inherit from rt_device */
@@ -31,6 +36,15 @@ struct eth_device
     /* eth device interface */
     struct pbuf* (*eth_rx)(rt_device_t dev);
     rt_err_t (*eth_tx)(rt_device_t dev, struct pbuf* p);
+
+    /* optional, mask or unmask the Rx interrupt for the Rx polling. The Rx interrupt is
+     * masked by eth_device_ready() and unmasked when eth_rx returns RT_NULL, so the
+     * driver must raise the pending Rx interrupt again when it is unmasked. */
+    rt_err_t (*eth_rx_irq)(rt_device_t dev, rt_bool_t enable);
+    rt_uint8_t rx_polling;
+    /* the Rx thread is notified by the pending list when its mailbox is full */
+    rt_uint8_t rx_pending;
+    struct eth_device *rx_pending_next;
 };
 
 #ifdef __cplusplus
@@ -245,7 +245,11 @@
 //#define MEMP_USE_CUSTOM_POOLS       1
 //#define MEM_SIZE                    (1024*64)
 
+#ifdef RT_LWIP_USING_MEMP_POOL
+#define MEMP_MEM_MALLOC             1
+#else
 #define MEMP_MEM_MALLOC             0
+#endif
 
 /* MEMP_NUM_PBUF: the number of memp struct pbufs. If the application
    sends a lot of data out of ROM (or other static memory), this
@@ -383,6 +387,9 @@
 #define TCPIP_THREAD_STACKSIZE      4096
 #endif
 #define TCPIP_THREAD_NAME           "tcpip"
+#ifdef RT_LWIP_TCPTHREAD_MSG_BATCH
+#define TCPIP_MSG_BATCH             RT_LWIP_TCPTHREAD_MSG_BATCH
+#endif
 #define DEFAULT_TCP_RECVMBOX_SIZE   10
 
 /* ---------- ARP options ---------- */
@@ -400,6 +407,12 @@
 #define CHECKSUM_CHECK_UDP              0
 #define CHECKSUM_CHECK_TCP              0
 #define CHECKSUM_CHECK_ICMP             0
+#elif defined(RT_LWIP_USING_OPT_CHECKSUM)
+#define LWIP_CHKSUM                     sys_chksum
+#ifdef RT_LWIP_USING_CHECKSUM_ON_COPY
+#define LWIP_CHECKSUM_ON_COPY           1
+#define LWIP_CHKSUM_COPY(dst, src, len) sys_chksum_copy(dst, src, len)
+#endif
 #endif
 
 /* ---------- IP options ---------- */
@@ -627,5 +640,22 @@
 #define TFTP_MAX_FILENAME_LEN           64
 #endif
 
+/*
+   ------------------------------------
+   ---------- Hook options ------------
+   ------------------------------------
+*/
+
+/* the virtual Ethernet pair of netbench and the sockets bound to the network interface
+ * device selected by the netdev policy are routed by the source address */
+#if defined(NETBENCH_USING_VNET) || defined(NETDEV_USING_POLICY)
+struct ip4_addr;
+struct netif;
+#ifdef NETBENCH_USING_VNET
+struct netif *netbench_vnet_route(const struct ip4_addr *src, const struct ip4_addr *dest);
+#endif
+struct netif *lwip_ip4_route_src(const struct ip4_addr *src, const struct ip4_addr *dest);
+#define LWIP_HOOK_IP4_ROUTE_SRC(src, dest)  lwip_ip4_route_src(src, dest)
+#endif
 
 #endif /* __LWIPOPTS_H__ */
@@ -39,6 +39,9 @@
  * 2013-02-28     aozima       fixed list_tcps bug: ipaddr_ntoa isn't reentrant.
  * 2016-08-18     Bernard      port to lwIP 2.0.0
  * 2018-11-02     MurphyZhao   port to lwIP 2.1.0
+ * 2026-10-18     liujiahao    add the Rx polling and the batched packet input
+ * 2026-10-18     liujiahao    add the source based route of the netdev policy
+ * 2026-10-18     liujiahao    keep the Rx polling on the full Rx thread mailbox
  */
 
 #include "lwip/opt.h"
@@ -52,6 +55,8 @@
 #include "lwip/netif.h"
 #include "lwip/stats.h"
 #include "lwip/tcpip.h"
+#include "lwip/ip.h"
+#include "lwip/priv/tcpip_priv.h"
 #include "lwip/dhcp.h"
 #include "lwip/netifapi.h"
 
@@ -95,8 +100,26 @@ static char eth_tx_thread_stack[RT_LWIP_ETHTHREAD_STACKSIZE];
 #endif
 
 #ifndef LWIP_NO_RX_THREAD
+/* the maximum number of packets received and input to lwIP at a time */
+#ifndef RT_LWIP_ETH_RX_BUDGET
+#define RT_LWIP_ETH_RX_BUDGET           16
+#endif
+
+/**
+ * The batch of received packets input to lwIP by one call
+ */
+struct eth_rx_batch
+{
+    struct tcpip_api_call_data call;
+    struct netif *netif;
+    int count;
+    struct pbuf *buf[RT_LWIP_ETH_RX_BUDGET];
+};
+
 static struct rt_mailbox eth_rx_thread_mb;
 static struct rt_thread eth_rx_thread;
+/* the polling devices which are not posted to the full mailbox */
+static struct eth_device *eth_rx_pending;
 #ifndef RT_LWIP_ETHTHREAD_MBOX_SIZE
 static char eth_rx_thread_mb_pool[48 * 4];
 static char eth_rx_thread_stack[1024];
@@ -375,6 +398,34 @@ static int netdev_flags_sync(struct netif *lwip_netif)
 }
 #endif /* RT_USING_NETDEV */
 
+#if defined(NETBENCH_USING_VNET) || defined(NETDEV_USING_POLICY)
+/* the route of the source address, NULL goes to the route of destination */
+struct netif *lwip_ip4_route_src(const ip4_addr_t *src, const ip4_addr_t *dest)
+{
+    struct netif *netif = RT_NULL;
+
+    if (src == RT_NULL || ip4_addr_isany(src))
+        return RT_NULL;
+
+#ifdef NETBENCH_USING_VNET
+    netif = netbench_vnet_route(src, dest);
+    if (netif != RT_NULL)
+        return netif;
+#endif
+
+#ifdef NETDEV_USING_POLICY
+    /* the socket bound to the address of interface goes out through it */
+    NETIF_FOREACH(netif)
+    {
+        if (netif_is_up(netif) && netif_is_link_up(netif) && ip4_addr_cmp(src, netif_ip4_addr(netif)))
+            return netif;
+    }
+#endif
+
+    return RT_NULL;
+}
+#endif /* NETBENCH_USING_VNET || NETDEV_USING_POLICY */
+
 static err_t ethernetif_linkoutput(struct netif *netif, struct pbuf *p)
 {
 #ifndef LWIP_NO_TX_THREAD
@@ -587,8 +638,49 @@ void eth_device_deinit(struct eth_device *dev)
 rt_err_t eth_device_ready(struct eth_device* dev)
 {
     if (dev->netif)
+    {
+        if (dev->eth_rx_irq)
+        {
+            rt_uint32_t level;
+
+            level = rt_hw_interrupt_disable();
+            if (dev->rx_polling)
+            {
+                /* the Rx thread is polling it */
+                rt_hw_interrupt_enable(level);
+                return RT_EOK;
+            }
+            dev->rx_polling = 0x01;
+            rt_hw_interrupt_enable(level);
+
+            /* mask the Rx interrupt until all of buffer is received */
+            dev->eth_rx_irq(&(dev->parent), RT_FALSE);
+        }
+
         /* post message to Ethernet thread */
-        return rt_mb_send(&eth_rx_thread_mb, (rt_uint32_t)dev);
+        if (rt_mb_send(&eth_rx_thread_mb, (rt_uint32_t)dev) == RT_EOK)
+            return RT_EOK;
+
+        if (dev->eth_rx_irq)
+        {
+            rt_uint32_t level;
+
+            /* the Rx interrupt is masked, the Rx thread takes it after the messages
+             * in the full mailbox, or the Rx stops forever */
+            level = rt_hw_interrupt_disable();
+            if (!dev->rx_pending)
+            {
+                dev->rx_pending = 0x01;
+                dev->rx_pending_next = eth_rx_pending;
+                eth_rx_pending = dev;
+            }
+            rt_hw_interrupt_enable(level);
+
+            return RT_EOK;
+        }
+
+        return -RT_EFULL;
+    }
     else
         return ERR_OK; /* netif is not initialized yet, just return. */
 }
@@ -656,6 +748,134 @@ static void eth_tx_thread_entry(void* parameter)
 #endif
 
 #ifndef LWIP_NO_RX_THREAD
+static err_t eth_rx_batch_input(struct tcpip_api_call_data *call)
+{
+    struct eth_rx_batch *batch = (struct eth_rx_batch *)call;
+    struct netif *netif = batch->netif;
+    netif_input_fn input = netif->input;
+    int index;
+
+    /* the packets are input in lwIP thread or under the core lock, so skip the message of
+     * tcpip_input() unless the input is hooked */
+    if (input == tcpip_input)
+    {
+#if LWIP_ETHERNET
+        if (netif->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET))
+            input = ethernet_input;
+        else
+#endif /* LWIP_ETHERNET */
+            input = ip_input;
+    }
+
+    for (index = 0; index < batch->count; index++)
+    {
+        if (input(batch->buf[index], netif) != ERR_OK)
+        {
+            LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: Input error\n"));
+            pbuf_free(batch->buf[index]);
+        }
+    }
+
+    return ERR_OK;
+}
+
+/* receive a budget of packets and input them to lwIP at a time, return the number received */
+static int eth_rx_poll(struct eth_device *device)
+{
+    static struct eth_rx_batch batch;
+    struct pbuf *p;
+
+    batch.netif = device->netif;
+    batch.count = 0;
+    while (batch.count < RT_LWIP_ETH_RX_BUDGET)
+    {
+        p = device->eth_rx(&(device->parent));
+        if (p == RT_NULL) break;
+
+        batch.buf[batch.count++] = p;
+    }
+
+    if (batch.count > 0 && tcpip_api_call(eth_rx_batch_input, &batch.call) != ERR_OK)
+    {
+        int index;
+
+        /* notify to upper layer one by one */
+        for (index = 0; index < batch.count; index++)
+        {
+            if (device->netif->input(batch.buf[index], device->netif) != ERR_OK)
+            {
+                LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: Input error\n"));
+                pbuf_free(batch.buf[index]);
+            }
+        }
+    }
+
+    return batch.count;
+}
+
+/* take a device from the pending list */
+static struct eth_device *eth_rx_pending_take(void)
+{
+    struct eth_device *device;
+    rt_uint32_t level;
+
+    level = rt_hw_interrupt_disable();
+    device = eth_rx_pending;
+    if (device)
+    {
+        eth_rx_pending = device->rx_pending_next;
+        device->rx_pending_next = RT_NULL;
+        device->rx_pending = 0x00;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return device;
+}
+
+static void eth_rx_handle(struct eth_device *device)
+{
+    rt_uint32_t level;
+
+    /* check link status */
+    if (device->link_changed)
+    {
+        int status;
+
+        level = rt_hw_interrupt_disable();
+        status = device->link_status;
+        device->link_changed = 0x00;
+        rt_hw_interrupt_enable(level);
+
+        if (status)
+            netifapi_netif_set_link_up(device->netif);
+        else
+            netifapi_netif_set_link_down(device->netif);
+    }
+
+    if (device->eth_rx == RT_NULL) return;
+
+    if (device->eth_rx_irq == RT_NULL)
+    {
+        /* receive all of buffer */
+        while (eth_rx_poll(device) == RT_LWIP_ETH_RX_BUDGET);
+    }
+    else if (device->rx_polling)
+    {
+        if (eth_rx_poll(device) == RT_LWIP_ETH_RX_BUDGET
+                && rt_mb_send(&eth_rx_thread_mb, (rt_uint32_t)device) == RT_EOK)
+        {
+            /* the budget is exhausted, poll it again after the other devices */
+            return;
+        }
+
+        /* all of buffer is received, unmask the Rx interrupt */
+        level = rt_hw_interrupt_disable();
+        device->rx_polling = 0x00;
+        rt_hw_interrupt_enable(level);
+        device->eth_rx_irq(&(device->parent), RT_TRUE);
+    }
+}
+
 /* Ethernet Rx Thread */
 static void eth_rx_thread_entry(void* parameter)
 {
@@ -665,42 +885,13 @@ static void eth_rx_thread_entry(void* parameter)
     {
         if (rt_mb_recv(&eth_rx_thread_mb, (rt_ubase_t *)&device, RT_WAITING_FOREVER) == RT_EOK)
         {
-            struct pbuf *p;
+            eth_rx_handle(device);
 
-            /* check link status */
-            if (device->link_changed)
+            /* the devices are pended only when the mailbox is full, so they are
+             * seen after one of the messages at least */
+            while ((device = eth_rx_pending_take()) != RT_NULL)
             {
-                int status;
-                rt_uint32_t level;
-
-                level = rt_hw_interrupt_disable();
-                status = device->link_status;
-                device->link_changed = 0x00;
-                rt_hw_interrupt_enable(level);
-
-                if (status)
-                    netifapi_netif_set_link_up(device->netif);
-                else
-                    netifapi_netif_set_link_down(device->netif);
-            }
-
-            /* receive all of buffer */
-            while (1)
-            {
-                if(device->eth_rx == RT_NULL) break;
-                
-                p = device->eth_rx(&(device->parent));
-                if (p != RT_NULL)
-                {
-                    /* notify to upper layer */
-                    if( device->netif->input(p, device->netif) != ERR_OK )
-                    {
-                        LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: Input error\n"));
-                        pbuf_free(p);
-                        p = NULL;
-                    }
-                }
-                else break;
+                eth_rx_handle(device);
             }
         }
         else
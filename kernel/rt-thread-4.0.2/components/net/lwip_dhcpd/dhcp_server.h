@@ -34,11 +34,16 @@
  * 2013-08-08     aozima       support different network segments.
  * 2015-01-30     bernard      release to RT-Thread RTOS.
  * 2017-12-27     aozima       add [mac-ip] table support.
+ * 2026-10-18     liujiahao    add the key-value storage of leases.
  */
 
 #ifndef DHCPV4_SERVER_H__
 #define DHCPV4_SERVER_H__
 
+#ifdef DHCPD_USING_LEASE_KV
+#include <drivers/mtd_nor_kv.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -46,6 +51,11 @@ extern "C" {
 void dhcpd_start(const char *netif_name);
 void dhcpd_stop(const char *netif_name);
 
+#ifdef DHCPD_USING_LEASE_KV
+/* the leases are restored from and saved to the storage, set it before dhcpd_start */
+void dhcpd_lease_kv_set(rt_mtd_kv_t kv);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
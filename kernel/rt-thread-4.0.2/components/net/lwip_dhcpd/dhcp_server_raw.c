@@ -31,6 +31,10 @@
  * Date           Author       Notes
  * 2014-04-01     Ren.Haibo    the first version
  * 2018-06-12     aozima       ignore DHCP_OPTION_SERVER_ID.
+ * 2026-10-18     liujiahao    hash the leases by MAC and IP, allocate the IP by bitmap
+ *                             and save the leases to file.
+ * 2026-10-18     liujiahao    expire the default leases and save the leases to MTD NOR
+ *                             key-value storage.
  */
 
 #include <stdio.h>
@@ -45,6 +49,10 @@
 #include <netif/ethernetif.h>
 #include <lwip/ip.h>
 #include <lwip/init.h>
+#include <lwip/priv/tcpip_priv.h>
+#include <lwip/timeouts.h>
+
+#include "dhcp_server.h"
 
 #if (LWIP_VERSION) < 0x02000000U
     #error "not support old LWIP"
@@ -73,6 +81,39 @@
     #define DHCPD_SERVER_IP "192.168.169.1"
 #endif
 
+/* the size of the lease hash tables, it must be power of 2 */
+#ifndef DHCPD_LEASE_HASH_SIZE
+    #define DHCPD_LEASE_HASH_SIZE   64
+#endif
+
+#if defined(DHCPD_USING_LEASE_FILE) || defined(DHCPD_USING_LEASE_KV)
+    #define DHCPD_USING_LEASE_SAVE
+#endif
+
+#ifdef DHCPD_USING_LEASE_SAVE
+    #include <ipc/workqueue.h>
+
+    /* the leases changed in a burst of joining are saved once */
+    #define DHCPD_LEASE_SAVE_DELAY  (RT_TICK_PER_SECOND * 5)
+#endif
+
+#ifdef DHCPD_USING_LEASE_FILE
+    #include <dfs_posix.h>
+
+    #ifndef DHCPD_LEASE_FILE
+        #define DHCPD_LEASE_FILE    "/dhcpd.leases"
+    #endif
+    #define DHCPD_LEASE_FILE_MAGIC  0x4C504844  /* "DHPL" */
+#endif
+
+#ifdef DHCPD_USING_LEASE_KV
+    #include <drivers/mtd_nor_kv.h>
+
+    #ifndef DHCPD_LEASE_KEY
+        #define DHCPD_LEASE_KEY     "dhcpd.leases"
+    #endif
+#endif
+
 #define DHCP_DEBUG_PRINTF
 
 #ifdef  DHCP_DEBUG_PRINTF
@@ -88,8 +129,18 @@
 
 /** Mac address length  */
 #define DHCP_MAX_HLEN               6
-/** dhcp default live time */
-#define DHCP_DEFAULT_LIVE_TIME      0x80510100
+/** dhcp default live time, two hours */
+#define DHCP_DEFAULT_LIVE_TIME      7200
+
+/* the lease time of clients in seconds, 0xFFFFFFFF is infinite (RFC 2132) */
+#ifndef DHCPD_LEASE_TIME
+    #define DHCPD_LEASE_TIME        DHCP_DEFAULT_LIVE_TIME
+#endif
+#define DHCPD_LEASE_INFINITE        0
+/* the longer leases expire after this, so the lease end is compared in 32 bits */
+#define DHCPD_LEASE_TIME_MAX        0x7FFFFFFFUL
+/* the seconds are counted before the tick wraps around */
+#define DHCPD_SECONDS_INTERVAL      (3600 * 1000UL)
 
 /** Minimum length for request before packet is parsed */
 #define DHCP_MIN_REQUEST_LEN        44
@@ -106,10 +157,12 @@
 */
 struct dhcp_client_node
 {
-    struct dhcp_client_node *next;
+    struct dhcp_client_node *next;      /* the next node of the same MAC hash */
+    struct dhcp_client_node *ip_next;   /* the next node of the same IP hash */
     u8_t chaddr[DHCP_MAX_HLEN];
+    u8_t hlen;
     ip4_addr_t ipaddr;
-    u32_t lease_end;
+    u32_t lease_end;                    /* the second when the lease expires, 0 is infinite */
 };
 
 /**
@@ -120,10 +173,14 @@ struct dhcp_server
     struct dhcp_server *next;
     struct netif *netif;
     struct udp_pcb *pcb;
-    struct dhcp_client_node *node_list;
+    struct dhcp_client_node *mac_table[DHCPD_LEASE_HASH_SIZE];
+    struct dhcp_client_node *ip_table[DHCPD_LEASE_HASH_SIZE];
+    u32_t *ip_bitmap;                   /* the leased addresses from start to end */
+    u32_t ip_count;
+    u32_t lease_count;
+    u32_t current;                      /* the index of address where the next allocation starts */
     ip4_addr_t start;
     ip4_addr_t end;
-    ip4_addr_t current;
 };
 
 static u8_t *dhcp_server_option_find(u8_t *buf, u16_t len, u8_t option);
@@ -133,6 +190,96 @@ static u8_t *dhcp_server_option_find(u8_t *buf, u16_t len, u8_t option);
 */
 static struct dhcp_server *lw_dhcp_server;
 
+#ifdef DHCPD_USING_LEASE_SAVE
+static void dhcp_server_lease_changed(void);
+#else
+#define dhcp_server_lease_changed()
+#endif
+
+/* the seconds counted by tick deltas, they don't wrap around with the tick */
+static u32_t dhcp_server_sec;
+static rt_tick_t dhcp_server_sec_tick;
+
+static u32_t
+dhcp_server_seconds(void)
+{
+    rt_tick_t elapsed = rt_tick_get() - dhcp_server_sec_tick;
+
+    if (elapsed >= RT_TICK_PER_SECOND)
+    {
+        dhcp_server_sec += elapsed / RT_TICK_PER_SECOND;
+        dhcp_server_sec_tick += elapsed - elapsed % RT_TICK_PER_SECOND;
+    }
+
+    return dhcp_server_sec;
+}
+
+/* count the seconds while no request comes */
+static void
+dhcp_server_seconds_timer(void *arg)
+{
+    LWIP_UNUSED_ARG(arg);
+
+    dhcp_server_seconds();
+    sys_timeout(DHCPD_SECONDS_INTERVAL, dhcp_server_seconds_timer, NULL);
+}
+
+static u32_t
+dhcp_server_lease_end(void)
+{
+    u32_t lease_time = (u32_t)DHCPD_LEASE_TIME;
+    u32_t lease_end;
+
+    if (lease_time == 0xFFFFFFFFUL)
+    {
+        return DHCPD_LEASE_INFINITE;
+    }
+    if (lease_time > DHCPD_LEASE_TIME_MAX)
+    {
+        lease_time = DHCPD_LEASE_TIME_MAX;
+    }
+
+    lease_end = dhcp_server_seconds() + lease_time;
+    return lease_end == DHCPD_LEASE_INFINITE ? 1 : lease_end;
+}
+
+static int
+dhcp_client_expired(struct dhcp_client_node *node, u32_t now)
+{
+    return node->lease_end != DHCPD_LEASE_INFINITE && (s32_t)(now - node->lease_end) >= 0;
+}
+
+static u32_t
+dhcp_client_mac_hash(const u8_t *chaddr, u8_t hlen)
+{
+    u32_t hash = 2166136261UL;
+    u8_t i;
+
+    for (i = 0; i < hlen; i++)
+    {
+        hash = (hash ^ chaddr[i]) * 16777619UL;
+    }
+
+    return hash & (DHCPD_LEASE_HASH_SIZE - 1);
+}
+
+static u32_t
+dhcp_client_ip_hash(const ip4_addr_t *ip)
+{
+    return lwip_ntohl(ip->addr) & (DHCPD_LEASE_HASH_SIZE - 1);
+}
+
+/* the index of address in the pool, ip_count if it's out of the pool */
+static u32_t
+dhcp_server_ip_index(struct dhcp_server *dhcpserver, const ip4_addr_t *ip)
+{
+    u32_t index = lwip_ntohl(ip->addr) - lwip_ntohl(dhcpserver->start.addr);
+
+    return index < dhcpserver->ip_count ? index : dhcpserver->ip_count;
+}
+
+#define DHCP_SERVER_IP_USED(server, index)  ((server)->ip_bitmap[(index) >> 5] & (1UL << ((index) & 0x1F)))
+
 /**
 * Find a dhcp client node by mac address
 *
@@ -146,7 +293,7 @@ dhcp_client_find_by_mac(struct dhcp_server *dhcpserver, const u8_t *chaddr, u8_t
 {
     struct dhcp_client_node *node;
 
-    for (node = dhcpserver->node_list; node != NULL; node = node->next)
+    for (node = dhcpserver->mac_table[dhcp_client_mac_hash(chaddr, hlen)]; node != NULL; node = node->next)
     {
         if (memcmp(node->chaddr, chaddr, hlen) == 0)
         {
@@ -161,8 +308,7 @@ dhcp_client_find_by_mac(struct dhcp_server *dhcpserver, const u8_t *chaddr, u8_t
 * Find a dhcp client node by ip address
 *
 * @param dhcpserver The dhcp server
-* @param chaddr Mac address
-* @param hlen   Mac address length
+* @param ip IP address
 * @return dhcp client node
 */
 static struct dhcp_client_node *
@@ -170,7 +316,7 @@ dhcp_client_find_by_ip(struct dhcp_server *dhcpserver, const ip4_addr_t *ip)
 {
     struct dhcp_client_node *node;
 
-    for (node = dhcpserver->node_list; node != NULL; node = node->next)
+    for (node = dhcpserver->ip_table[dhcp_client_ip_hash(ip)]; node != NULL; node = node->ip_next)
     {
         if (ip4_addr_cmp(&node->ipaddr, ip))
         {
@@ -182,54 +328,202 @@ dhcp_client_find_by_ip(struct dhcp_server *dhcpserver, const ip4_addr_t *ip)
 }
 
 /**
-* Find a dhcp client node by ip address
+* Add a dhcp client node with the mac and ip address
 *
 * @param dhcpserver The dhcp server
 * @param chaddr Mac address
 * @param hlen   Mac address length
+* @param index  The index of ip address in the pool, it must be free
 * @return dhcp client node
 */
 static struct dhcp_client_node *
-dhcp_client_find(struct dhcp_server *dhcpserver, struct dhcp_msg *msg,
-                 u8_t *opt_buf, u16_t len)
+dhcp_client_add(struct dhcp_server *dhcpserver, const u8_t *chaddr, u8_t hlen, u32_t index)
 {
-    u8_t *opt;
-    //u32_t ipaddr;
     struct dhcp_client_node *node;
+    u32_t hash;
 
-    node = dhcp_client_find_by_mac(dhcpserver, msg->chaddr, msg->hlen);
-    if (node != NULL)
+    node = (struct dhcp_client_node *)mem_malloc(sizeof(struct dhcp_client_node));
+    if (node == NULL)
     {
-        return node;
+        return NULL;
     }
+    memset(node, 0, sizeof(struct dhcp_client_node));
+    SMEMCPY(node->chaddr, chaddr, hlen);
+    node->hlen = hlen;
+    node->ipaddr.addr = lwip_htonl(lwip_ntohl(dhcpserver->start.addr) + index);
+    node->lease_end = dhcp_server_lease_end();
 
-    opt = dhcp_server_option_find(opt_buf, len, DHCP_OPTION_REQUESTED_IP);
-    if (opt != NULL)
+    hash = dhcp_client_mac_hash(chaddr, hlen);
+    node->next = dhcpserver->mac_table[hash];
+    dhcpserver->mac_table[hash] = node;
+
+    hash = dhcp_client_ip_hash(&node->ipaddr);
+    node->ip_next = dhcpserver->ip_table[hash];
+    dhcpserver->ip_table[hash] = node;
+
+    dhcpserver->ip_bitmap[index >> 5] |= 1UL << (index & 0x1F);
+    dhcpserver->lease_count++;
+    dhcp_server_lease_changed();
+
+    return node;
+}
+
+/**
+* Remove a dhcp client node and free its ip address
+*
+* @param dhcpserver The dhcp server
+* @param node The dhcp client node
+*/
+static void
+dhcp_client_remove(struct dhcp_server *dhcpserver, struct dhcp_client_node *node)
+{
+    struct dhcp_client_node **pnode;
+    u32_t index;
+
+    for (pnode = &dhcpserver->mac_table[dhcp_client_mac_hash(node->chaddr, node->hlen)]; *pnode; pnode = &(*pnode)->next)
     {
-        node = dhcp_client_find_by_ip(dhcpserver, (ip4_addr_t *)(&opt[2]));
-        if (node != NULL)
+        if (*pnode == node)
         {
-            return node;
+            *pnode = node->next;
+            break;
         }
     }
 
-    return NULL;
+    for (pnode = &dhcpserver->ip_table[dhcp_client_ip_hash(&node->ipaddr)]; *pnode; pnode = &(*pnode)->ip_next)
+    {
+        if (*pnode == node)
+        {
+            *pnode = node->ip_next;
+            break;
+        }
+    }
+
+    index = dhcp_server_ip_index(dhcpserver, &node->ipaddr);
+    if (index < dhcpserver->ip_count)
+    {
+        dhcpserver->ip_bitmap[index >> 5] &= ~(1UL << (index & 0x1F));
+    }
+    dhcpserver->lease_count--;
+    mem_free(node);
+    dhcp_server_lease_changed();
 }
 
 /**
-* Find a dhcp client node by ip address
+* Remove all dhcp client nodes
 *
 * @param dhcpserver The dhcp server
-* @param chaddr Mac address
-* @param hlen   Mac address length
+*/
+static void
+dhcp_client_remove_all(struct dhcp_server *dhcpserver)
+{
+    struct dhcp_client_node *node, *next;
+    u32_t i;
+
+    for (i = 0; i < DHCPD_LEASE_HASH_SIZE; i++)
+    {
+        for (node = dhcpserver->mac_table[i]; node != NULL; node = next)
+        {
+            next = node->next;
+            mem_free(node);
+        }
+        dhcpserver->mac_table[i] = NULL;
+        dhcpserver->ip_table[i] = NULL;
+    }
+
+    if (dhcpserver->ip_bitmap)
+    {
+        memset(dhcpserver->ip_bitmap, 0, ((dhcpserver->ip_count + 31) >> 5) * sizeof(u32_t));
+    }
+    dhcpserver->lease_count = 0;
+}
+
+/**
+* Remove the expired dhcp client nodes
+*
+* @param dhcpserver The dhcp server
+* @return the number of removed nodes
+*/
+static u32_t
+dhcp_client_remove_expired(struct dhcp_server *dhcpserver)
+{
+    struct dhcp_client_node *node, *next;
+    u32_t now = dhcp_server_seconds();
+    u32_t i, count = 0;
+
+    for (i = 0; i < DHCPD_LEASE_HASH_SIZE; i++)
+    {
+        for (node = dhcpserver->mac_table[i]; node != NULL; node = next)
+        {
+            next = node->next;
+            if (dhcp_client_expired(node, now))
+            {
+                dhcp_client_remove(dhcpserver, node);
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+* Allocate a free ip address from the pool
+*
+* @param dhcpserver The dhcp server
+* @return the index of ip address, ip_count if the pool is exhausted
+*/
+static u32_t
+dhcp_server_ip_alloc(struct dhcp_server *dhcpserver)
+{
+    u32_t words = (dhcpserver->ip_count + 31) >> 5;
+    u32_t word, mask, index, i;
+    int bit;
+
+    if (dhcpserver->lease_count >= dhcpserver->ip_count && dhcp_client_remove_expired(dhcpserver) == 0)
+    {
+        return dhcpserver->ip_count;
+    }
+
+    /* go round from the current one, so the released addresses are not reused at once.
+     * The addresses before the current one in its word are checked when it goes round */
+    index = dhcpserver->current;
+    word = index >> 5;
+    mask = 0xFFFFFFFFUL << (index & 0x1F);
+    for (i = 0; i <= words; i++)
+    {
+        bit = __rt_ffs((int)(~dhcpserver->ip_bitmap[word] & mask));
+        if (bit != 0)
+        {
+            index = (word << 5) + bit - 1;
+            if (index < dhcpserver->ip_count)
+            {
+                dhcpserver->current = (index + 1) % dhcpserver->ip_count;
+                return index;
+            }
+        }
+        mask = 0xFFFFFFFFUL;
+        word = (word + 1) % words;
+    }
+
+    return dhcpserver->ip_count;
+}
+
+/**
+* Find a dhcp client node by mac address, or add it for the requested ip address
+*
+* @param dhcpserver The dhcp server
+* @param msg The dhcp message
+* @param opt_buf The options of message
+* @param len The options length
 * @return dhcp client node
 */
 static struct dhcp_client_node *
-dhcp_client_alloc(struct dhcp_server *dhcpserver, struct dhcp_msg *msg,
-                  u8_t *opt_buf, u16_t len)
+dhcp_client_find(struct dhcp_server *dhcpserver, struct dhcp_msg *msg,
+                 u8_t *opt_buf, u16_t len)
 {
     u8_t *opt;
-    u32_t ipaddr;
+    ip4_addr_t ipaddr;
+    u32_t index;
     struct dhcp_client_node *node;
 
     node = dhcp_client_find_by_mac(dhcpserver, msg->chaddr, msg->hlen);
@@ -238,40 +532,51 @@ dhcp_client_alloc(struct dhcp_server *dhcpserver, struct dhcp_msg *msg,
         return node;
     }
 
+    /* the client rebooting with the address which is leased by nobody */
     opt = dhcp_server_option_find(opt_buf, len, DHCP_OPTION_REQUESTED_IP);
     if (opt != NULL)
     {
-        node = dhcp_client_find_by_ip(dhcpserver, (ip4_addr_t *)(&opt[2]));
-        if (node != NULL)
+        SMEMCPY(&ipaddr, &opt[2], 4);
+        index = dhcp_server_ip_index(dhcpserver, &ipaddr);
+        if (index < dhcpserver->ip_count && !DHCP_SERVER_IP_USED(dhcpserver, index))
         {
-            return node;
+            return dhcp_client_add(dhcpserver, msg->chaddr, msg->hlen, index);
         }
     }
 
-dhcp_alloc_again:
-    node = dhcp_client_find_by_ip(dhcpserver, &dhcpserver->current);
+    return NULL;
+}
+
+/**
+* Find a dhcp client node by mac address, or allocate a new ip address for it
+*
+* @param dhcpserver The dhcp server
+* @param msg The dhcp message
+* @param opt_buf The options of message
+* @param len The options length
+* @return dhcp client node
+*/
+static struct dhcp_client_node *
+dhcp_client_alloc(struct dhcp_server *dhcpserver, struct dhcp_msg *msg,
+                  u8_t *opt_buf, u16_t len)
+{
+    struct dhcp_client_node *node;
+    u32_t index;
+
+    node = dhcp_client_find(dhcpserver, msg, opt_buf, len);
     if (node != NULL)
     {
-        ipaddr = (ntohl(dhcpserver->current.addr) + 1);
-        if (ipaddr > ntohl(dhcpserver->end.addr))
-        {
-            ipaddr = ntohl(dhcpserver->start.addr);
-        }
-        dhcpserver->current.addr = htonl(ipaddr);
-        goto dhcp_alloc_again;
+        return node;
     }
-    node = (struct dhcp_client_node *)mem_malloc(sizeof(struct dhcp_client_node));
-    if (node == NULL)
+
+    index = dhcp_server_ip_alloc(dhcpserver);
+    if (index >= dhcpserver->ip_count)
     {
+        LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_LEVEL_WARNING, ("dhcp server address pool exhausted\n"));
         return NULL;
     }
-    SMEMCPY(node->chaddr, msg->chaddr, msg->hlen);
-    node->ipaddr = dhcpserver->current;
 
-    node->next = dhcpserver->node_list;
-    dhcpserver->node_list = node;
-
-    return node;
+    return dhcp_client_add(dhcpserver, msg->chaddr, msg->hlen, index);
 }
 
 /**
@@ -304,6 +609,7 @@ static void
 dhcp_server_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *recv_addr, u16_t port)
 {
     struct dhcp_server *dhcp_server = (struct dhcp_server *)arg;
+    struct dhcp_server *server;
     struct dhcp_msg *msg;
     struct pbuf *q;
     u8_t *opt_buf;
@@ -314,12 +620,22 @@ dhcp_server_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t
     ip_addr_t addr = *recv_addr;
     u32_t tmp;
 
-    LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE, ("[%s:%d] %c%c recv %d\n", __FUNCTION__, __LINE__, dhcp_server->netif->name[0], dhcp_server->netif->name[1], p->tot_len));
     /* prevent warnings about unused arguments */
     LWIP_UNUSED_ARG(pcb);
     LWIP_UNUSED_ARG(addr);
     LWIP_UNUSED_ARG(port);
 
+    /* the port is bound by the first server, the others are found by the input netif */
+    for (server = lw_dhcp_server; server != NULL; server = server->next)
+    {
+        if (server->netif == ip_current_input_netif())
+        {
+            dhcp_server = server;
+            break;
+        }
+    }
+    LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE, ("[%s:%d] %c%c recv %d\n", __FUNCTION__, __LINE__, dhcp_server->netif->name[0], dhcp_server->netif->name[1], p->tot_len));
+
     if (p->len < DHCP_MIN_REQUEST_LEN)
     {
         LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_LEVEL_WARNING, ("DHCP request message or pbuf too short\n"));
@@ -375,7 +691,7 @@ dhcp_server_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t
             {
                 goto free_pbuf_and_return;
             }
-            node->lease_end = DHCP_DEFAULT_LIVE_TIME;
+            node->lease_end = dhcp_server_lease_end();
             /* create dhcp offer and send */
             msg->op = DHCP_BOOTREPLY;
             msg->hops = 0;
@@ -401,7 +717,7 @@ dhcp_server_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t
             /* add_lease_time */
             *opt_buf++ = DHCP_OPTION_LEASE_TIME;
             *opt_buf++ = 4;
-            tmp = PP_HTONL(DHCP_DEFAULT_LIVE_TIME);
+            tmp = PP_HTONL(DHCPD_LEASE_TIME);
             SMEMCPY(opt_buf, &tmp, 4);
             opt_buf += 4;
 
@@ -451,8 +767,9 @@ dhcp_server_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t
                     node = dhcp_client_find(dhcp_server, msg, opt_buf, length);
                     if (node != NULL)
                     {
-                        /* Send ack */
-                        node->lease_end = DHCP_DEFAULT_LIVE_TIME;
+                        /* Send ack, the renewed lease is saved */
+                        node->lease_end = dhcp_server_lease_end();
+                        dhcp_server_lease_changed();
                         /* create dhcp offer and send */
                         msg->op = DHCP_BOOTREPLY;
                         msg->hops = 0;
@@ -478,7 +795,7 @@ dhcp_server_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t
                         /* add_lease_time */
                         *opt_buf++ = DHCP_OPTION_LEASE_TIME;
                         *opt_buf++ = 4;
-                        tmp = PP_HTONL(DHCP_DEFAULT_LIVE_TIME);
+                        tmp = PP_HTONL(DHCPD_LEASE_TIME);
                         SMEMCPY(opt_buf, &tmp, 4);
                         opt_buf += 4;
 
@@ -558,29 +875,10 @@ dhcp_server_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t
                 }
                 else if (msg_type == DHCP_RELEASE)
                 {
-                    struct dhcp_client_node *node_prev = NULL;
-
-                    for (node = dhcp_server->node_list; node != NULL; node = node->next)
-                    {
-                        if (memcmp(node->chaddr, msg->chaddr, msg->hlen) == 0)
-                        {
-                            if (node == dhcp_server->node_list)
-                            {
-                                dhcp_server->node_list = node->next;
-                            }
-                            else
-                            {
-                                node_prev->next = node->next;
-                            }
-                            break;
-                        }
-                        node_prev = node;
-                        node = node->next;
-                    }
-
+                    node = dhcp_client_find_by_mac(dhcp_server, msg->chaddr, msg->hlen);
                     if (node != NULL)
                     {
-                        mem_free(node);
+                        dhcp_client_remove(dhcp_server, node);
                     }
                 }
                 else if (msg_type ==  DHCP_DECLINE)
@@ -599,73 +897,638 @@ free_pbuf_and_return:
     pbuf_free(q);
 }
 
-/**
-* start dhcp server for a netif
-*
-* @param netif The netif which use dhcp server
-* @param start The Start IP address
-* @param end The netif which use dhcp server
-* @return lwIP error code
-* - ERR_OK - No error
-* - ERR_MEM - Out of memory
-*/
-err_t
-dhcp_server_start(struct netif *netif, ip4_addr_t *start, ip4_addr_t *end)
+#ifdef DHCPD_USING_LEASE_SAVE
+/* the lease record in file or key-value storage */
+struct dhcp_lease_record
+{
+    char name[2];                       /* the name of netif */
+    u8_t hlen;
+    u8_t chaddr[DHCP_MAX_HLEN];
+    u8_t reserved[3];
+    u32_t ipaddr;
+    u32_t lease_remain;                 /* the remaining seconds of lease, 0 is infinite */
+};
+
+struct dhcp_lease_snapshot
+{
+    struct tcpip_api_call_data call;
+    struct dhcp_lease_record *records;
+    u32_t count;
+};
+
+static struct rt_work dhcp_lease_work;
+static struct rt_mutex dhcp_lease_lock;     /* keep the order of snapshot and write */
+static rt_bool_t dhcp_lease_work_inited = RT_FALSE;
+static volatile rt_bool_t dhcp_lease_save_pending = RT_FALSE;
+#ifdef DHCPD_USING_LEASE_KV
+static rt_mtd_kv_t dhcp_lease_kv = RT_NULL;
+#endif
+
+static void dhcp_server_lease_save(struct rt_work *work, void *work_data);
+
+static void
+dhcp_server_lease_init(void)
+{
+    if (!dhcp_lease_work_inited)
+    {
+        rt_mutex_init(&dhcp_lease_lock, "dhcpd", RT_IPC_FLAG_FIFO);
+        rt_work_init(&dhcp_lease_work, dhcp_server_lease_save, RT_NULL);
+        dhcp_lease_work_inited = RT_TRUE;
+    }
+}
+
+/* copy the leases of all servers, it's called in the tcpip thread */
+static err_t
+dhcp_server_lease_copy(struct dhcp_lease_snapshot *snapshot)
 {
     struct dhcp_server *dhcp_server;
+    struct dhcp_client_node *node;
+    struct dhcp_lease_record *record;
+    u32_t now = dhcp_server_seconds();
+    u32_t i, count = 0;
 
-    /* If this netif alreday use the dhcp server. */
     for (dhcp_server = lw_dhcp_server; dhcp_server != NULL; dhcp_server = dhcp_server->next)
     {
-        if (dhcp_server->netif == netif)
-        {
-            dhcp_server->start = *start;
-            dhcp_server->end = *end;
-            dhcp_server->current = *start;
-            return ERR_OK;
-        }
+        count += dhcp_server->lease_count;
     }
 
-    dhcp_server = NULL;
-    LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE, ("dhcp_server_start(): starting new DHCP server\n"));
-    dhcp_server = (struct dhcp_server *)mem_malloc(sizeof(struct dhcp_server));
-    if (dhcp_server == NULL)
+    snapshot->count = 0;
+    snapshot->records = RT_NULL;
+    if (count == 0)
     {
-        LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE, ("dhcp_server_start(): could not allocate dhcp\n"));
-        return ERR_MEM;
+        return ERR_OK;
     }
 
-    /* clear data structure */
-    memset(dhcp_server, 0, sizeof(struct dhcp_server));
-
-    /* store this dhcp server to list */
-    dhcp_server->next = lw_dhcp_server;
-    lw_dhcp_server = dhcp_server;
-    dhcp_server->netif = netif;
-    dhcp_server->node_list = NULL;
-    dhcp_server->start = *start;
-    dhcp_server->end = *end;
-    dhcp_server->current = *start;
-
-    /* allocate UDP PCB */
-    dhcp_server->pcb = udp_new();
-    if (dhcp_server->pcb == NULL)
+    snapshot->records = (struct dhcp_lease_record *)rt_calloc(count, sizeof(struct dhcp_lease_record));
+    if (snapshot->records == RT_NULL)
     {
-        LWIP_DEBUGF(DHCP_DEBUG  | LWIP_DBG_TRACE, ("dhcp_server_start(): could not obtain pcb\n"));
         return ERR_MEM;
     }
 
-    ip_set_option(dhcp_server->pcb, SOF_BROADCAST);
-    /* set up local and remote port for the pcb */
-    udp_bind(dhcp_server->pcb, IP_ADDR_ANY, DHCP_SERVER_PORT);
-    //udp_connect(dhcp_server->pcb, IP_ADDR_ANY, DHCP_CLIENT_PORT);
-    /* set up the recv callback and argument */
-    udp_recv(dhcp_server->pcb, dhcp_server_recv, dhcp_server);
-    LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE, ("dhcp_server_start(): starting DHCP server\n"));
-
+    for (dhcp_server = lw_dhcp_server; dhcp_server != NULL; dhcp_server = dhcp_server->next)
+    {
+        for (i = 0; i < DHCPD_LEASE_HASH_SIZE; i++)
+        {
+            for (node = dhcp_server->mac_table[i]; node != NULL && snapshot->count < count; node = node->next)
+            {
+                if (dhcp_client_expired(node, now))
+                {
+                    continue;
+                }
+
+                record = &snapshot->records[snapshot->count++];
+                record->name[0] = dhcp_server->netif->name[0];
+                record->name[1] = dhcp_server->netif->name[1];
+                record->hlen = node->hlen;
+                SMEMCPY(record->chaddr, node->chaddr, DHCP_MAX_HLEN);
+                record->ipaddr = node->ipaddr.addr;
+                record->lease_remain = node->lease_end == DHCPD_LEASE_INFINITE ? 0 : node->lease_end - now;
+            }
+        }
+    }
+
+    return ERR_OK;
+}
+
+static err_t
+dhcp_server_lease_snapshot(struct tcpip_api_call_data *call)
+{
+    struct dhcp_lease_snapshot *snapshot = (struct dhcp_lease_snapshot *)call;
+
+    /* the leases have been saved when a server stopped */
+    if (!dhcp_lease_save_pending)
+    {
+        return ERR_ALREADY;
+    }
+    dhcp_lease_save_pending = RT_FALSE;
+
+    return dhcp_server_lease_copy(snapshot);
+}
+
+#ifdef DHCPD_USING_LEASE_FILE
+static void
+dhcp_server_lease_write(struct dhcp_lease_record *records, u32_t count)
+{
+    u32_t magic = DHCPD_LEASE_FILE_MAGIC;
+    int fd;
+
+    fd = open(DHCPD_LEASE_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0);
+    if (fd < 0)
+    {
+        DEBUG_PRINTF("open %s failed!\r\n", DHCPD_LEASE_FILE);
+        return;
+    }
+
+    if (write(fd, &magic, sizeof(magic)) != sizeof(magic) ||
+        (count && write(fd, records, count * sizeof(struct dhcp_lease_record)) !=
+         (int)(count * sizeof(struct dhcp_lease_record))))
+    {
+        DEBUG_PRINTF("write %s failed!\r\n", DHCPD_LEASE_FILE);
+    }
+    close(fd);
+}
+#else
+/* all the leases are one value, it must be in an erase block of the storage */
+static void
+dhcp_server_lease_write(struct dhcp_lease_record *records, u32_t count)
+{
+    rt_err_t result;
+
+    if (dhcp_lease_kv == RT_NULL)
+    {
+        return;
+    }
+
+    if (count == 0)
+    {
+        result = rt_mtd_kv_del(dhcp_lease_kv, DHCPD_LEASE_KEY);
+        if (result == -RT_EEMPTY)
+        {
+            result = RT_EOK;
+        }
+    }
+    else
+    {
+        result = rt_mtd_kv_set(dhcp_lease_kv, DHCPD_LEASE_KEY, records, count * sizeof(struct dhcp_lease_record));
+    }
+
+    if (result != RT_EOK)
+    {
+        DEBUG_PRINTF("save %d leases to %s failed: %d\r\n", count, DHCPD_LEASE_KEY, result);
+    }
+}
+#endif /* DHCPD_USING_LEASE_FILE */
+
+/* save the leases in the system workqueue */
+static void
+dhcp_server_lease_save(struct rt_work *work, void *work_data)
+{
+    struct dhcp_lease_snapshot snapshot;
+    err_t err;
+
+    rt_mutex_take(&dhcp_lease_lock, RT_WAITING_FOREVER);
+    err = tcpip_api_call(dhcp_server_lease_snapshot, &snapshot.call);
+    if (err == ERR_OK)
+    {
+        dhcp_server_lease_write(snapshot.records, snapshot.count);
+        if (snapshot.records)
+        {
+            rt_free(snapshot.records);
+        }
+    }
+    else if (err != ERR_ALREADY)
+    {
+        DEBUG_PRINTF("snapshot leases failed!\r\n");
+    }
+    rt_mutex_release(&dhcp_lease_lock);
+}
+
+/* schedule to save the leases, it's called in the tcpip thread */
+static void
+dhcp_server_lease_changed(void)
+{
+    if (dhcp_lease_save_pending || !dhcp_lease_work_inited)
+    {
+        return;
+    }
+
+    dhcp_lease_save_pending = RT_TRUE;
+    if (rt_work_submit(&dhcp_lease_work, DHCPD_LEASE_SAVE_DELAY) != RT_EOK)
+    {
+        dhcp_lease_save_pending = RT_FALSE;
+    }
+}
+
+/**
+* Restore a saved lease if it belongs to the netif and it's in the pool
+*
+* @param dhcpserver The dhcp server
+* @param record The saved lease
+* @return 0 if there is no memory for more leases
+*/
+static int
+dhcp_server_lease_restore(struct dhcp_server *dhcpserver, const struct dhcp_lease_record *record)
+{
+    struct dhcp_client_node *node;
+    ip4_addr_t ipaddr;
+    u32_t index;
+
+    if (record->name[0] != dhcpserver->netif->name[0] || record->name[1] != dhcpserver->netif->name[1] ||
+        record->hlen > DHCP_MAX_HLEN)
+    {
+        return 1;
+    }
+
+    ipaddr.addr = record->ipaddr;
+    index = dhcp_server_ip_index(dhcpserver, &ipaddr);
+    if (index >= dhcpserver->ip_count || DHCP_SERVER_IP_USED(dhcpserver, index) ||
+        dhcp_client_find_by_mac(dhcpserver, record->chaddr, record->hlen) != NULL)
+    {
+        return 1;
+    }
+
+    node = dhcp_client_add(dhcpserver, record->chaddr, record->hlen, index);
+    if (node == NULL)
+    {
+        return 0;
+    }
+    node->lease_end = DHCPD_LEASE_INFINITE;
+    if (record->lease_remain != 0)
+    {
+        node->lease_end = dhcp_server_seconds() + record->lease_remain;
+    }
+
+    return 1;
+}
+
+/**
+* Restore the saved leases which belong to the netif, it's called in the tcpip thread
+*
+* @param dhcpserver The dhcp server
+* @param snapshot The leases read from the storage
+*/
+static void
+dhcp_server_lease_load(struct dhcp_server *dhcpserver, const struct dhcp_lease_snapshot *snapshot)
+{
+    u32_t i;
+
+    for (i = 0; i < snapshot->count; i++)
+    {
+        if (!dhcp_server_lease_restore(dhcpserver, &snapshot->records[i]))
+        {
+            break;
+        }
+    }
+    if (snapshot->count)
+    {
+        DEBUG_PRINTF("%d leases restored\r\n", dhcpserver->lease_count);
+    }
+}
+
+#ifdef DHCPD_USING_LEASE_FILE
+/* read the saved leases from file, it's called out of the tcpip thread */
+static void
+dhcp_server_lease_read(struct dhcp_lease_snapshot *snapshot)
+{
+    u32_t magic = 0;
+    int fd, len;
+
+    snapshot->records = RT_NULL;
+    snapshot->count = 0;
+
+    fd = open(DHCPD_LEASE_FILE, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    if (read(fd, &magic, sizeof(magic)) != sizeof(magic) || magic != DHCPD_LEASE_FILE_MAGIC)
+    {
+        DEBUG_PRINTF("%s is not a lease file!\r\n", DHCPD_LEASE_FILE);
+        goto __exit;
+    }
+
+    len = lseek(fd, 0, SEEK_END) - (int)sizeof(magic);
+    if (len < (int)sizeof(struct dhcp_lease_record) || lseek(fd, sizeof(magic), SEEK_SET) < 0)
+    {
+        goto __exit;
+    }
+
+    snapshot->records = (struct dhcp_lease_record *)rt_malloc(len);
+    if (snapshot->records == RT_NULL)
+    {
+        goto __exit;
+    }
+
+    len = read(fd, snapshot->records, len);
+    if (len > 0)
+    {
+        snapshot->count = len / sizeof(struct dhcp_lease_record);
+    }
+
+__exit:
+    close(fd);
+}
+#else
+/* read the saved leases from the key-value storage, it's called out of the tcpip thread */
+static void
+dhcp_server_lease_read(struct dhcp_lease_snapshot *snapshot)
+{
+    int len;
+
+    snapshot->records = RT_NULL;
+    snapshot->count = 0;
+
+    if (dhcp_lease_kv == RT_NULL)
+    {
+        return;
+    }
+
+    len = rt_mtd_kv_get(dhcp_lease_kv, DHCPD_LEASE_KEY, RT_NULL, 0);
+    if (len < (int)sizeof(struct dhcp_lease_record))
+    {
+        return;
+    }
+
+    snapshot->records = (struct dhcp_lease_record *)rt_malloc(len);
+    if (snapshot->records == RT_NULL)
+    {
+        return;
+    }
+
+    len = rt_mtd_kv_get(dhcp_lease_kv, DHCPD_LEASE_KEY, snapshot->records, len);
+    if (len > 0)
+    {
+        snapshot->count = len / sizeof(struct dhcp_lease_record);
+    }
+}
+
+/**
+* Set the key-value storage where the leases are saved, it's called before the servers start
+*
+* @param kv The initialized key-value storage
+*/
+void
+dhcpd_lease_kv_set(rt_mtd_kv_t kv)
+{
+    dhcp_lease_kv = kv;
+}
+#endif /* DHCPD_USING_LEASE_FILE */
+#endif /* DHCPD_USING_LEASE_SAVE */
+
+/**
+* initialize the address pool of dhcp server
+*
+* @param dhcpserver The dhcp server
+* @param start The Start IP address
+* @param end The End IP address
+* @return lwIP error code
+*/
+static err_t
+dhcp_server_pool_init(struct dhcp_server *dhcpserver, ip4_addr_t *start, ip4_addr_t *end)
+{
+    u32_t count = lwip_ntohl(end->addr) - lwip_ntohl(start->addr) + 1;
+
+    if (lwip_ntohl(end->addr) < lwip_ntohl(start->addr))
+    {
+        return ERR_ARG;
+    }
+
+    dhcp_client_remove_all(dhcpserver);
+    if (dhcpserver->ip_bitmap == NULL || ((dhcpserver->ip_count + 31) >> 5) != ((count + 31) >> 5))
+    {
+        if (dhcpserver->ip_bitmap)
+        {
+            mem_free(dhcpserver->ip_bitmap);
+        }
+        dhcpserver->ip_bitmap = (u32_t *)mem_malloc(((count + 31) >> 5) * sizeof(u32_t));
+        if (dhcpserver->ip_bitmap == NULL)
+        {
+            dhcpserver->ip_count = 0;
+            return ERR_MEM;
+        }
+    }
+    memset(dhcpserver->ip_bitmap, 0, ((count + 31) >> 5) * sizeof(u32_t));
+
+    dhcpserver->ip_count = count;
+    dhcpserver->current = 0;
+    dhcpserver->start = *start;
+    dhcpserver->end = *end;
+
+    return ERR_OK;
+}
+
+/* the start and stop of dhcp server in the tcpip thread */
+struct dhcp_server_call
+{
+    struct tcpip_api_call_data call;
+    struct netif *netif;
+    ip4_addr_t *start;
+    ip4_addr_t *end;
+#ifdef DHCPD_USING_LEASE_SAVE
+    struct dhcp_lease_snapshot leases;  /* the leases to restore at start, or to save at stop */
+    rt_bool_t flush;
+#endif
+};
+
+static err_t
+dhcp_server_start_call(struct tcpip_api_call_data *call)
+{
+    struct dhcp_server_call *msg = (struct dhcp_server_call *)call;
+    struct netif *netif = msg->netif;
+    struct dhcp_server *dhcp_server;
+
+    /* If this netif alreday use the dhcp server. */
+    for (dhcp_server = lw_dhcp_server; dhcp_server != NULL; dhcp_server = dhcp_server->next)
+    {
+        if (dhcp_server->netif == netif)
+        {
+            if (dhcp_server_pool_init(dhcp_server, msg->start, msg->end) != ERR_OK)
+            {
+                return ERR_MEM;
+            }
+#ifdef DHCPD_USING_LEASE_SAVE
+            dhcp_server_lease_load(dhcp_server, &msg->leases);
+#endif
+            return ERR_OK;
+        }
+    }
+
+    LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE, ("dhcp_server_start(): starting new DHCP server\n"));
+    dhcp_server = (struct dhcp_server *)mem_malloc(sizeof(struct dhcp_server));
+    if (dhcp_server == NULL)
+    {
+        LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE, ("dhcp_server_start(): could not allocate dhcp\n"));
+        return ERR_MEM;
+    }
+
+    /* clear data structure */
+    memset(dhcp_server, 0, sizeof(struct dhcp_server));
+
+    /* store this dhcp server to list */
+    dhcp_server->next = lw_dhcp_server;
+    lw_dhcp_server = dhcp_server;
+    dhcp_server->netif = netif;
+    if (dhcp_server->next == NULL)
+    {
+        dhcp_server_seconds();
+        sys_timeout(DHCPD_SECONDS_INTERVAL, dhcp_server_seconds_timer, NULL);
+    }
+    if (dhcp_server_pool_init(dhcp_server, msg->start, msg->end) != ERR_OK)
+    {
+        LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE, ("dhcp_server_start(): could not allocate pool\n"));
+        return ERR_MEM;
+    }
+#ifdef DHCPD_USING_LEASE_SAVE
+    dhcp_server_lease_load(dhcp_server, &msg->leases);
+#endif
+
+    /* allocate UDP PCB */
+    dhcp_server->pcb = udp_new();
+    if (dhcp_server->pcb == NULL)
+    {
+        LWIP_DEBUGF(DHCP_DEBUG  | LWIP_DBG_TRACE, ("dhcp_server_start(): could not obtain pcb\n"));
+        return ERR_MEM;
+    }
+
+    ip_set_option(dhcp_server->pcb, SOF_BROADCAST);
+    /* set up local and remote port for the pcb */
+    udp_bind(dhcp_server->pcb, IP_ADDR_ANY, DHCP_SERVER_PORT);
+    //udp_connect(dhcp_server->pcb, IP_ADDR_ANY, DHCP_CLIENT_PORT);
+    /* set up the recv callback and argument */
+    udp_recv(dhcp_server->pcb, dhcp_server_recv, dhcp_server);
+    LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE, ("dhcp_server_start(): starting DHCP server\n"));
+
     return ERR_OK;
 }
 
+static err_t
+dhcp_server_stop_call(struct tcpip_api_call_data *call)
+{
+    struct dhcp_server_call *msg = (struct dhcp_server_call *)call;
+    struct dhcp_server *dhcp_server, *server_node;
+
+    /* If this netif alreday use the dhcp server. */
+    for (dhcp_server = lw_dhcp_server; dhcp_server != NULL; dhcp_server = dhcp_server->next)
+    {
+        if (dhcp_server->netif == msg->netif)
+        {
+            break;
+        }
+    }
+    if (dhcp_server == RT_NULL)
+    {
+        return ERR_VAL;
+    }
+
+#ifdef DHCPD_USING_LEASE_SAVE
+    /* the pending save would lose the leases of this server */
+    if (dhcp_lease_save_pending)
+    {
+        rt_work_cancel(&dhcp_lease_work);
+        dhcp_lease_save_pending = RT_FALSE;
+        msg->flush = dhcp_server_lease_copy(&msg->leases) == ERR_OK;
+    }
+#endif
+
+    /* remove dhcp server */
+    if (dhcp_server == lw_dhcp_server)
+    {
+        lw_dhcp_server = lw_dhcp_server->next;
+    }
+    else
+    {
+        server_node = lw_dhcp_server;
+        while (server_node->next && server_node->next != dhcp_server)
+        {
+            server_node = server_node->next;
+        }
+        if (server_node->next != RT_NULL)
+        {
+            server_node->next = server_node->next->next;
+        }
+    }
+
+    udp_disconnect(dhcp_server->pcb);
+    udp_remove(dhcp_server->pcb);
+
+    /* remove all client node */
+    dhcp_client_remove_all(dhcp_server);
+    if (dhcp_server->ip_bitmap)
+    {
+        mem_free(dhcp_server->ip_bitmap);
+    }
+
+    mem_free(dhcp_server);
+
+    if (lw_dhcp_server == NULL)
+    {
+        sys_untimeout(dhcp_server_seconds_timer, NULL);
+    }
+
+    return ERR_OK;
+}
+
+/**
+* start dhcp server for a netif
+*
+* @param netif The netif which use dhcp server
+* @param start The Start IP address
+* @param end The netif which use dhcp server
+* @return lwIP error code
+* - ERR_OK - No error
+* - ERR_MEM - Out of memory
+*/
+err_t
+dhcp_server_start(struct netif *netif, ip4_addr_t *start, ip4_addr_t *end)
+{
+    struct dhcp_server_call msg;
+    err_t err;
+
+    msg.netif = netif;
+    msg.start = start;
+    msg.end = end;
+#ifdef DHCPD_USING_LEASE_SAVE
+    dhcp_server_lease_init();
+    rt_mutex_take(&dhcp_lease_lock, RT_WAITING_FOREVER);
+    dhcp_server_lease_read(&msg.leases);
+    rt_mutex_release(&dhcp_lease_lock);
+#endif
+
+    /* the tables of servers are only changed in the tcpip thread */
+    err = tcpip_api_call(dhcp_server_start_call, &msg.call);
+
+#ifdef DHCPD_USING_LEASE_SAVE
+    if (msg.leases.records)
+    {
+        rt_free(msg.leases.records);
+    }
+#endif
+
+    return err;
+}
+
+/**
+* stop dhcp server of a netif, the pending save of leases is flushed with
+* the leases of this server, so they are restored when it starts again
+*
+* @param netif The netif which use dhcp server
+* @return lwIP error code
+* - ERR_OK - No error
+* - ERR_VAL - The netif doesn't use dhcp server
+*/
+static err_t
+dhcp_server_stop(struct netif *netif)
+{
+    struct dhcp_server_call msg;
+    err_t err;
+
+    msg.netif = netif;
+#ifdef DHCPD_USING_LEASE_SAVE
+    msg.leases.records = RT_NULL;
+    msg.leases.count = 0;
+    msg.flush = RT_FALSE;
+    dhcp_server_lease_init();
+    rt_mutex_take(&dhcp_lease_lock, RT_WAITING_FOREVER);
+#endif
+
+    err = tcpip_api_call(dhcp_server_stop_call, &msg.call);
+
+#ifdef DHCPD_USING_LEASE_SAVE
+    if (msg.flush)
+    {
+        dhcp_server_lease_write(msg.leases.records, msg.leases.count);
+    }
+    rt_mutex_release(&dhcp_lease_lock);
+    if (msg.leases.records)
+    {
+        rt_free(msg.leases.records);
+    }
+#endif
+
+    return err;
+}
+
 extern void set_if(const char *netif_name, const char *ip_addr, const char *gw_addr, const char *nm_addr);
 
 void dhcpd_start(const char *netif_name)
@@ -751,9 +1614,7 @@ _exit:
 
 void dhcpd_stop(const char *netif_name)
 {
-    struct dhcp_server *dhcp_server, *server_node;
     struct netif *netif = netif_list;
-    struct dhcp_client_node *node, *next;
 
     DEBUG_PRINTF("%s: %s\r\n", __FUNCTION__, netif_name);
 
@@ -782,48 +1643,11 @@ void dhcpd_stop(const char *netif_name)
         goto _exit;
     }
 
-    /* If this netif alreday use the dhcp server. */
-    for (dhcp_server = lw_dhcp_server; dhcp_server != NULL; dhcp_server = dhcp_server->next)
-    {
-        if (dhcp_server->netif == netif)
-        {
-            break;
-        }
-    }
-    if (dhcp_server == RT_NULL)
+    if (dhcp_server_stop(netif) != ERR_OK)
     {
         goto _exit;
     }
 
-    /* remove dhcp server */
-    if (dhcp_server == lw_dhcp_server)
-    {
-        lw_dhcp_server = lw_dhcp_server->next;
-    }
-    else
-    {
-        server_node = lw_dhcp_server;
-        while (server_node->next && server_node->next != dhcp_server)
-        {
-            server_node = server_node->next;
-        }
-        if (server_node->next != RT_NULL)
-        {
-            server_node->next = server_node->next->next;
-        }
-    }
-
-    udp_disconnect(dhcp_server->pcb);
-    udp_remove(dhcp_server->pcb);
-
-    /* remove all client node */
-    for (node = dhcp_server->node_list; node != NULL; node = next)
-    {
-        next = node->next;
-        mem_free(node);
-    }
-
-    mem_free(dhcp_server);
     set_if(netif_name, "0.0.0.0", "0.0.0.0", "0.0.0.0");
 
 _exit:
@@ -31,23 +31,19 @@
  * Date           Author       Notes
  * 2015-01-26     Hichard      porting to RT-Thread
  * 2015-01-27     Bernard      code cleanup for lwIP in RT-Thread
+ * 2026-10-18     liujiahao    hash tables and timer wheel for NAT connections,
+ *                             fast path from network interface input
  */
 
 /*
  * TODOS:
- *  - we should decide if we want to use static tables for NAT or a linked
- *    list.
  *  - we should allocate icmp ping id if multiple clients are sending
  *    ping requests.
- *  - maybe we could hash the identifiers for TCP, ICMP and UDP and use
- *    a single table structure. This would reduce the code amount although
- *    it will cost performance.
  *  - NAT code must check for broadcast addresses and NOT forward
  *    them.
  *
  *  - netif_remove must notify NAT code when a NAT'ed interface is removed
  *  - allocate NAT entries from a new memp pool instead of the heap
- *  - let ttl be ticks, not seconds
  *
  * HOWTO USE:
  *
@@ -82,6 +78,8 @@
 #include "lwip/mem.h"
 #include "lwip/sys.h"
 #include "lwip/timers.h"
+#include "lwip/tcpip.h"
+#include "lwip/inet_chksum.h"
 #include "netif/etharp.h"
 
 #include <limits.h>
@@ -92,20 +90,30 @@
 #define LWIP_NAT_DEBUG      LWIP_DBG_OFF
 #endif
 
-#define LWIP_NAT_TTL_INFINITE                    (INT_MAX)
 #define LWIP_NAT_DEFAULT_TTL_SECONDS             (128)
 #define LWIP_NAT_FORWARD_HEADER_SIZE_MIN         (sizeof(struct eth_hdr))
 
-#define LWIP_NAT_DEFAULT_STATE_TABLES_ICMP       (4)
-#define LWIP_NAT_DEFAULT_STATE_TABLES_TCP        (32)
-#define LWIP_NAT_DEFAULT_STATE_TABLES_UDP        (32)
+/** The limit of NAT connections */
+#ifndef LWIP_NAT_MAX_CONNS
+#define LWIP_NAT_MAX_CONNS                       (256)
+#endif
+
+/** The hash tables grow and shrink between these sizes (power of 2) with
+ * the number of connections */
+#ifndef LWIP_NAT_HASH_SIZE_MIN
+#define LWIP_NAT_HASH_SIZE_MIN                   (16)
+#endif
+#ifndef LWIP_NAT_HASH_SIZE_MAX
+#define LWIP_NAT_HASH_SIZE_MAX                   (1024)
+#endif
 
-#define LWIP_NAT_DEFAULT_TCP_SOURCE_PORT         (40000)
-#define LWIP_NAT_DEFAULT_UDP_SOURCE_PORT         (40000)
+/** The slots of the timer wheel, ip_nat_tmr() checks one slot per call */
+#define LWIP_NAT_WHEEL_SLOTS                     (64)
 
-#define IPNAT_ENTRY_RESET(x) do { \
-  (x)->ttl = 0; \
-} while(0)
+#define LWIP_NAT_DEFAULT_TTL_TICKS \
+  ((LWIP_NAT_DEFAULT_TTL_SECONDS + LWIP_NAT_TMR_INTERVAL_SEC - 1) / LWIP_NAT_TMR_INTERVAL_SEC)
+
+#define LWIP_NAT_DEFAULT_SOURCE_PORT             (40000)
 
 typedef struct ip_nat_conf
 {
@@ -113,54 +121,45 @@ typedef struct ip_nat_conf
   ip_nat_entry_t      entry;
 } ip_nat_conf_t;
 
-typedef struct ip_nat_entry_common
-{
-  s32_t           ttl; /* @todo: do we really need this to be signed?? */
-  ip_addr_t       source;
-  ip_addr_t       dest;
-  ip_nat_conf_t   *cfg;
-} ip_nat_entry_common_t;
-
-typedef struct ip_nat_entries_icmp
+/** A NAT connection of TCP, UDP or ICMP echo. It's linked in the hash tables
+ * of both directions and in a slot of the timer wheel. The ICMP echo uses
+ * the id as sport and nport, and the seqno as dport.
+ */
+typedef struct ip_nat_conn
 {
-  ip_nat_entry_common_t common;
-  u16_t                 id;
-  u16_t                 seqno;
-} ip_nat_entries_icmp_t;
+  struct ip_nat_conn  *out_next;
+  struct ip_nat_conn  *in_next;
+  struct ip_nat_conn  *wheel_next;
+  struct ip_nat_conn **wheel_pprev;
+  u32_t                expire; /* the ip_nat_tmr() tick to expire */
+  ip_addr_t            source;
+  ip_addr_t            dest;
+  ip_nat_conf_t       *cfg;
+  u16_t                sport;
+  u16_t                dport;
+  u16_t                nport;
+  u8_t                 proto;
+} ip_nat_conn_t;
 
-typedef struct ip_nat_entries_tcp
-{
-  ip_nat_entry_common_t common;
-  u16_t                 nport;
-  u16_t                 sport;
-  u16_t                 dport;
-} ip_nat_entries_tcp_t;
+static ip_nat_conf_t *ip_nat_cfg = NULL;
 
-typedef struct ip_nat_entries_udp
-{
-  ip_nat_entry_common_t common;
-  u16_t                 nport;
-  u16_t                 sport;
-  u16_t                 dport;
-} ip_nat_entries_udp_t;
+/* outgoing: (proto, source, dest, sport, dport), incoming: (proto, dest, dport, nport) */
+static ip_nat_conn_t **ip_nat_out_table = NULL;
+static ip_nat_conn_t **ip_nat_in_table = NULL;
+static u16_t ip_nat_table_size = 0;
+static u16_t ip_nat_conn_count = 0;
 
-typedef union u_nat_entry
-{
-  ip_nat_entry_common_t *cmn;
-  ip_nat_entries_tcp_t  *tcp;
-  ip_nat_entries_icmp_t *icmp;
-  ip_nat_entries_udp_t  *udp;
-} nat_entry_t;
+static ip_nat_conn_t *ip_nat_wheel[LWIP_NAT_WHEEL_SLOTS];
+static u32_t ip_nat_ticks = 0;
+static u16_t ip_nat_next_port = LWIP_NAT_DEFAULT_SOURCE_PORT;
 
-static ip_nat_conf_t *ip_nat_cfg = NULL;
-static ip_nat_entries_icmp_t ip_nat_icmp_table[LWIP_NAT_DEFAULT_STATE_TABLES_ICMP];
-static ip_nat_entries_tcp_t ip_nat_tcp_table[LWIP_NAT_DEFAULT_STATE_TABLES_TCP];
-static ip_nat_entries_udp_t ip_nat_udp_table[LWIP_NAT_DEFAULT_STATE_TABLES_UDP];
+#define IP_NAT_OUT_INDEX(proto, source, dest, sport, dport) \
+  (ip_nat_hash((proto), (source), (dest), (sport), (dport)) & (ip_nat_table_size - 1))
+#define IP_NAT_IN_INDEX(proto, dest, dport, nport) \
+  (ip_nat_hash((proto), 0, (dest), (dport), (nport)) & (ip_nat_table_size - 1))
 
 /* ----------------------- Static functions (COMMON) --------------------*/
 static void     ip_nat_chksum_adjust(u8_t *chksum, const u8_t *optr, s16_t olen, const u8_t *nptr, s16_t nlen);
-static void     ip_nat_cmn_init(ip_nat_conf_t *nat_config, const struct ip_hdr *iphdr,
-                                 ip_nat_entry_common_t *nat_entry);
 static ip_nat_conf_t *ip_nat_shallnat(const struct ip_hdr *iphdr);
 static void     ip_nat_reset_state(ip_nat_conf_t *cfg);
 
@@ -168,32 +167,22 @@ static void     ip_nat_reset_state(ip_nat_conf_t *cfg);
 #if defined(LWIP_DEBUG) && (LWIP_NAT_DEBUG & LWIP_DBG_ON)
 static void     ip_nat_dbg_dump(const char *msg, const struct ip_hdr *iphdr);
 static void     ip_nat_dbg_dump_ip(const ip_addr_t *addr);
-static void     ip_nat_dbg_dump_icmp_nat_entry(const char *msg, const ip_nat_entries_icmp_t *nat_entry);
-static void     ip_nat_dbg_dump_tcp_nat_entry(const char *msg, const ip_nat_entries_tcp_t *nat_entry);
-static void     ip_nat_dbg_dump_udp_nat_entry(const char *msg, const ip_nat_entries_udp_t *nat_entry);
+static void     ip_nat_dbg_dump_conn(const char *msg, const ip_nat_conn_t *conn);
 static void     ip_nat_dbg_dump_init(ip_nat_conf_t *ip_nat_cfg_new);
 static void     ip_nat_dbg_dump_remove(ip_nat_conf_t *cur);
 #else /* defined(LWIP_DEBUG) && (LWIP_NAT_DEBUG & LWIP_DBG_ON) */
 #define ip_nat_dbg_dump(msg, iphdr)
 #define ip_nat_dbg_dump_ip(addr)
-#define ip_nat_dbg_dump_icmp_nat_entry(msg, nat_entry)
-#define ip_nat_dbg_dump_tcp_nat_entry(msg, nat_entry)
-#define ip_nat_dbg_dump_udp_nat_entry(msg, nat_entry)
+#define ip_nat_dbg_dump_conn(msg, conn)
 #define ip_nat_dbg_dump_init(ip_nat_cfg_new)
 #define ip_nat_dbg_dump_remove(cur)
 #endif /* defined(LWIP_DEBUG) && (LWIP_NAT_DEBUG & LWIP_DBG_ON) */
 
-/* ----------------------- Static functions (TCP) -----------------------*/
-static ip_nat_entries_tcp_t *ip_nat_tcp_lookup_incoming(const struct ip_hdr *iphdr, const struct tcp_hdr *tcphdr);
-static ip_nat_entries_tcp_t *ip_nat_tcp_lookup_outgoing(ip_nat_conf_t *nat_config,
-                                                         const struct ip_hdr *iphdr, const struct tcp_hdr *tcphdr,
-                                                         u8_t allocate);
-
-/* ----------------------- Static functions (UDP) -----------------------*/
-static ip_nat_entries_udp_t *ip_nat_udp_lookup_incoming(const struct ip_hdr *iphdr, const struct udp_hdr *udphdr);
-static ip_nat_entries_udp_t *ip_nat_udp_lookup_outgoing(ip_nat_conf_t *nat_config,
-                                                         const struct ip_hdr *iphdr, const struct udp_hdr *udphdr,
-                                                         u8_t allocate);
+/* ----------------------- Static functions (CONNECTION) ----------------*/
+static ip_nat_conn_t *ip_nat_lookup_incoming(u8_t proto, u32_t dest, u16_t dport, u16_t nport);
+static ip_nat_conn_t *ip_nat_lookup_outgoing(ip_nat_conf_t *nat_config, u8_t proto,
+                                             const struct ip_hdr *iphdr, u16_t sport, u16_t dport,
+                                             u8_t allocate);
 
 /**
  * Timer callback function that calls ip_nat_tmr() and reschedules itself.
@@ -210,23 +199,138 @@ nat_timer(void *arg)
   sys_timeout(LWIP_NAT_TMR_INTERVAL_SEC * 1000, nat_timer, NULL);
 }
 
-/** Initialize this module */
-void
-ip_nat_init(void)
+/** Hash the identifiers of a connection */
+static u32_t
+ip_nat_hash(u8_t proto, u32_t addr1, u32_t addr2, u16_t port1, u16_t port2)
+{
+  u32_t hash;
+
+  hash = addr1 ^ (addr2 * 0x9E3779B1UL) ^ (((u32_t)port1 << 16) | port2) ^ proto;
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6BUL;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+/** Link a connection in the hash tables of both directions */
+static void
+ip_nat_conn_hash(ip_nat_conn_t *conn)
+{
+  u32_t index;
+
+  index = IP_NAT_OUT_INDEX(conn->proto, conn->source.addr, conn->dest.addr, conn->sport, conn->dport);
+  conn->out_next = ip_nat_out_table[index];
+  ip_nat_out_table[index] = conn;
+
+  index = IP_NAT_IN_INDEX(conn->proto, conn->dest.addr, conn->dport, conn->nport);
+  conn->in_next = ip_nat_in_table[index];
+  ip_nat_in_table[index] = conn;
+}
+
+/** Unlink a connection from the hash tables of both directions */
+static void
+ip_nat_conn_unhash(ip_nat_conn_t *conn)
+{
+  ip_nat_conn_t **pconn;
+
+  pconn = &ip_nat_out_table[IP_NAT_OUT_INDEX(conn->proto, conn->source.addr, conn->dest.addr,
+                                             conn->sport, conn->dport)];
+  while (*pconn != conn) {
+    pconn = &(*pconn)->out_next;
+  }
+  *pconn = conn->out_next;
+
+  pconn = &ip_nat_in_table[IP_NAT_IN_INDEX(conn->proto, conn->dest.addr, conn->dport, conn->nport)];
+  while (*pconn != conn) {
+    pconn = &(*pconn)->in_next;
+  }
+  *pconn = conn->in_next;
+}
+
+/** Link a connection in the slot of its expiration */
+static void
+ip_nat_wheel_insert(ip_nat_conn_t *conn)
+{
+  ip_nat_conn_t **slot = &ip_nat_wheel[conn->expire % LWIP_NAT_WHEEL_SLOTS];
+
+  conn->wheel_next = *slot;
+  conn->wheel_pprev = slot;
+  if (*slot != NULL) {
+    (*slot)->wheel_pprev = &conn->wheel_next;
+  }
+  *slot = conn;
+}
+
+/** Unlink a connection from its slot of the timer wheel */
+static void
+ip_nat_wheel_remove(ip_nat_conn_t *conn)
+{
+  *conn->wheel_pprev = conn->wheel_next;
+  if (conn->wheel_next != NULL) {
+    conn->wheel_next->wheel_pprev = conn->wheel_pprev;
+  }
+}
+
+/** Free a connection which has been unlinked from the timer wheel */
+static void
+ip_nat_conn_free(ip_nat_conn_t *conn)
 {
+  ip_nat_dbg_dump_conn("ip_nat_conn_free: removed nat entry: ", conn);
+  ip_nat_conn_unhash(conn);
+  ip_nat_conn_count--;
+  mem_free(conn);
+}
+
+/** Resize the hash tables of both directions. The old tables are kept if
+ * there is no memory for the new ones.
+ *
+ * @param size the new number of buckets, a power of 2
+ */
+static void
+ip_nat_resize(u16_t size)
+{
+  ip_nat_conn_t **out_table, **in_table;
+  ip_nat_conn_t *conn;
   int i;
-  extern void lwip_ip_input_set_hook(int (*hook)(struct pbuf *p, struct netif *inp));
 
-  /* @todo: this can be omitted since we trust static variables
-            to be initialized to zero */
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-    IPNAT_ENTRY_RESET(&ip_nat_icmp_table[i].common);
+  out_table = (ip_nat_conn_t **)mem_malloc(size * sizeof(ip_nat_conn_t *));
+  in_table = (ip_nat_conn_t **)mem_malloc(size * sizeof(ip_nat_conn_t *));
+  if ((out_table == NULL) || (in_table == NULL)) {
+    LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_resize: no memory for %" U16_F " buckets\n", size));
+    if (out_table != NULL) {
+      mem_free(out_table);
+    }
+    if (in_table != NULL) {
+      mem_free(in_table);
+    }
+    return;
   }
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    IPNAT_ENTRY_RESET(&ip_nat_tcp_table[i].common);
+  memset(out_table, 0, size * sizeof(ip_nat_conn_t *));
+  memset(in_table, 0, size * sizeof(ip_nat_conn_t *));
+
+  if (ip_nat_out_table != NULL) {
+    mem_free(ip_nat_out_table);
+    mem_free(ip_nat_in_table);
+  }
+  ip_nat_out_table = out_table;
+  ip_nat_in_table = in_table;
+  ip_nat_table_size = size;
+
+  /* all connections are linked in the timer wheel */
+  for (i = 0; i < LWIP_NAT_WHEEL_SLOTS; i++) {
+    for (conn = ip_nat_wheel[i]; conn != NULL; conn = conn->wheel_next) {
+      ip_nat_conn_hash(conn);
+    }
   }
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    IPNAT_ENTRY_RESET(&ip_nat_udp_table[i].common);
+}
+
+/** Initialize this module */
+void
+ip_nat_init(void)
+{
+  /* the hash tables grow again on the first connection if this fails */
+  if (ip_nat_table_size == 0) {
+    ip_nat_resize(LWIP_NAT_HASH_SIZE_MIN);
   }
 
   /* we must lock scheduler to protect following code */
@@ -331,30 +435,23 @@ ip_nat_remove(const ip_nat_entry_t *remove_entry)
 }
 
 /** Reset a NAT configured entry to be reused.
- * Effectively calls IPNAT_ENTRY_RESET() on 'cfg'.
+ * Frees all connections of 'cfg'.
  *
  * @param cfg NAT entry to reset
  */
 static void
 ip_nat_reset_state(ip_nat_conf_t *cfg)
 {
+  ip_nat_conn_t *conn, *next;
   int i;
 
-  /* @todo: optimize this!!!
-     why do we search for it anyway, if we have the pointer??? */
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-    if(ip_nat_icmp_table[i].common.cfg == cfg) {
-      IPNAT_ENTRY_RESET(&ip_nat_icmp_table[i].common);
-    }
-  }
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    if(ip_nat_tcp_table[i].common.cfg == cfg) {
-      IPNAT_ENTRY_RESET(&ip_nat_tcp_table[i].common);
-    }
-  }
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    if(ip_nat_udp_table[i].common.cfg == cfg) {
-      IPNAT_ENTRY_RESET(&ip_nat_udp_table[i].common);
+  for (i = 0; i < LWIP_NAT_WHEEL_SLOTS; i++) {
+    for (conn = ip_nat_wheel[i]; conn != NULL; conn = next) {
+      next = conn->wheel_next;
+      if (conn->cfg == cfg) {
+        ip_nat_wheel_remove(conn);
+        ip_nat_conn_free(conn);
+      }
     }
   }
 }
@@ -407,6 +504,25 @@ ip_nat_check_header(struct pbuf *p, u16_t min_size)
   return ret;
 }
 
+/** Refresh a connection by a packet of either direction
+ *
+ * @param conn the connection
+ * @param tcphdr the TCP header, NULL for UDP and ICMP
+ */
+static void
+ip_nat_conn_refresh(ip_nat_conn_t *conn, const struct tcp_hdr *tcphdr)
+{
+  if ((tcphdr != NULL) && (TCPH_FLAGS(tcphdr) & TCP_RST)) {
+    /* the connection is reset, expire it at the next timer */
+    ip_nat_wheel_remove(conn);
+    conn->expire = ip_nat_ticks + 1;
+    ip_nat_wheel_insert(conn);
+  } else {
+    /* the timer wheel moves the connection to the slot of expiration lazily */
+    conn->expire = ip_nat_ticks + LWIP_NAT_DEFAULT_TTL_TICKS;
+  }
+}
+
 /** Input processing: check if a received packet belongs to a NAT entry
  * and if so, translated it and send it on.
  *
@@ -421,13 +537,13 @@ ip_nat_input(struct pbuf *p)
   struct tcp_hdr       *tcphdr;
   struct udp_hdr       *udphdr;
   struct icmp_echo_hdr *icmphdr;
-  nat_entry_t           nat_entry;
+  ip_nat_conn_t        *conn = NULL;
+  struct netif         *in_if;
+  ip_addr_t             out_addr;
+  ip_addr_t             source;
   err_t                 err;
-  u8_t                  consumed = 0;
-  int                   i;
   struct pbuf          *q = NULL;
 
-  nat_entry.cmn = NULL;
   ip_nat_dbg_dump("ip_nat_in: checking nat for", iphdr);
 
   switch (IPH_PROTO(iphdr)) {
@@ -436,20 +552,18 @@ ip_nat_input(struct pbuf *p)
       if (tcphdr == NULL) {
         LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: short tcp packet (%" U16_F " bytes) discarded\n", p->tot_len));
       } else {
-        nat_entry.tcp = ip_nat_tcp_lookup_incoming(iphdr, tcphdr);
-        if (nat_entry.tcp != NULL) {
+        conn = ip_nat_lookup_incoming(IP_PROTO_TCP, iphdr->src.addr, tcphdr->src, tcphdr->dest);
+        if (conn != NULL) {
           /* Refresh TCP entry */
-          nat_entry.tcp->common.ttl = LWIP_NAT_DEFAULT_TTL_SECONDS;
-          tcphdr->dest = nat_entry.tcp->sport;
+          ip_nat_conn_refresh(conn, tcphdr);
+          tcphdr->dest = conn->sport;
           /* Adjust TCP checksum for changed destination port */
           ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
-            (u8_t *)&(nat_entry.tcp->nport), 2, (u8_t *)&(tcphdr->dest), 2);
+            (u8_t *)&(conn->nport), 2, (u8_t *)&(tcphdr->dest), 2);
           /* Adjust TCP checksum for changing dest IP address */
           ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
-            (u8_t *)&(nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4,
-            (u8_t *)&(nat_entry.cmn->source.addr), 4);
-
-          consumed = 1;
+            (u8_t *)&(conn->cfg->entry.out_if->ip_addr.addr), 4,
+            (u8_t *)&(conn->source.addr), 4);
         }
       }
       break;
@@ -461,20 +575,18 @@ ip_nat_input(struct pbuf *p)
           ("ip_nat_input: short udp packet (%" U16_F " bytes) discarded\n",
           p->tot_len));
       } else {
-        nat_entry.udp = ip_nat_udp_lookup_incoming(iphdr, udphdr);
-        if (nat_entry.udp != NULL) {
+        conn = ip_nat_lookup_incoming(IP_PROTO_UDP, iphdr->src.addr, udphdr->src, udphdr->dest);
+        if (conn != NULL) {
           /* Refresh UDP entry */
-          nat_entry.udp->common.ttl = LWIP_NAT_DEFAULT_TTL_SECONDS;
-          udphdr->dest = nat_entry.udp->sport;
+          ip_nat_conn_refresh(conn, NULL);
+          udphdr->dest = conn->sport;
           /* Adjust UDP checksum for changed destination port */
           ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
-            (u8_t *)&(nat_entry.udp->nport), 2, (u8_t *)&(udphdr->dest), 2);
+            (u8_t *)&(conn->nport), 2, (u8_t *)&(udphdr->dest), 2);
           /* Adjust UDP checksum for changing dest IP address */
           ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
-            (u8_t *)&(nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4,
-            (u8_t *)&(nat_entry.cmn->source.addr), 4);
-
-          consumed = 1;
+            (u8_t *)&(conn->cfg->entry.out_if->ip_addr.addr), 4,
+            (u8_t *)&(conn->source.addr), 4);
         }
       }
       break;
@@ -487,18 +599,7 @@ ip_nat_input(struct pbuf *p)
           p->tot_len));
       } else {
         if (ICMP_ER == ICMPH_TYPE(icmphdr)) {
-          for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-            nat_entry.icmp = &ip_nat_icmp_table[i];
-            if ((nat_entry.icmp->common.ttl) &&
-                (iphdr->src.addr == nat_entry.icmp->common.dest.addr) &&
-                (nat_entry.icmp->id == icmphdr->id) &&
-                (nat_entry.icmp->seqno == icmphdr->seqno)) {
-              ip_nat_dbg_dump_icmp_nat_entry("found existing nat entry: ", nat_entry.icmp);
-              consumed = 1;
-              IPNAT_ENTRY_RESET(nat_entry.cmn);
-              break;
-            }
-          }
+          conn = ip_nat_lookup_incoming(IP_PROTO_ICMP, iphdr->src.addr, icmphdr->seqno, icmphdr->id);
         }
       }
       break;
@@ -507,415 +608,458 @@ ip_nat_input(struct pbuf *p)
       break;
   }
 
-  if(consumed) {
-    /* packet consumed, send it out on in_if */
-    struct netif *in_if;
-
-    /* check if the pbuf has room for link headers */
-    if (pbuf_header(p, PBUF_LINK_HLEN)) {
-      /* pbuf has no room for link headers, allocate an extra pbuf */
-      q = pbuf_alloc(PBUF_LINK, 0, PBUF_RAM);
-      if (q == NULL) {
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: no pbuf for outgoing header\n"));
-        // rt_kprintf("ip_nat_input: no pbuf for outgoing header\n");
-        /* @todo: stats? */
-        pbuf_free(p);
-        p = NULL;
-        return 1;
-      } else {
-        pbuf_cat(q, p);
-      }
-    } else {
-      /* restore p->payload to IP header */
-      if (pbuf_header(p, -PBUF_LINK_HLEN)) {
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: restoring header failed\n"));
-        // rt_kprintf("ip_nat_input: restoring header failed\n");
-        /* @todo: stats? */
-        pbuf_free(p);
-        p = NULL;
-        return 1;
-      }
-      else q = p;
-    }
-    /* if we come here, q is the pbuf to send (either points to p or to a chain) */
-    in_if = nat_entry.cmn->cfg->entry.in_if;
-    iphdr->dest.addr = nat_entry.cmn->source.addr;
-    ip_nat_chksum_adjust((u8_t *) & IPH_CHKSUM(iphdr),
-      (u8_t *) & (nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4,
-      (u8_t *) & (iphdr->dest.addr), 4);
+  if (conn == NULL) {
+    return 0;
+  }
 
-    ip_nat_dbg_dump("ip_nat_input: packet back to source after nat: ", iphdr);
-    LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: sending packet on interface ("));
-    ip_nat_dbg_dump_ip(&(in_if->ip_addr));
-    LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
+  /* packet consumed, send it out on in_if */
+  in_if = conn->cfg->entry.in_if;
+  ip_addr_copy(out_addr, conn->cfg->entry.out_if->ip_addr);
+  ip_addr_copy(source, conn->source);
+  if (conn->proto == IP_PROTO_ICMP) {
+    /* the echo is answered */
+    ip_nat_wheel_remove(conn);
+    ip_nat_conn_free(conn);
+  }
 
-    err = in_if->output(in_if, q, (ip_addr_t *)&(iphdr->dest));
-    if(err != ERR_OK) {
-      LWIP_DEBUGF(LWIP_NAT_DEBUG,
-        ("ip_nat_input: failed to send rewritten packet. link layer returned %d\n",
-        err));
-      // rt_kprintf("ip_nat_input: failed to send rewritten packet. link layer returned %d\n", err);
+  /* check if the pbuf has room for link headers */
+  if (pbuf_header(p, PBUF_LINK_HLEN)) {
+    /* pbuf has no room for link headers, allocate an extra pbuf */
+    q = pbuf_alloc(PBUF_LINK, 0, PBUF_RAM);
+    if (q == NULL) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: no pbuf for outgoing header\n"));
+      // rt_kprintf("ip_nat_input: no pbuf for outgoing header\n");
+      /* @todo: stats? */
+      pbuf_free(p);
+      p = NULL;
+      return 1;
+    } else {
+      pbuf_cat(q, p);
+    }
+  } else {
+    /* restore p->payload to IP header */
+    if (pbuf_header(p, -PBUF_LINK_HLEN)) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: restoring header failed\n"));
+      // rt_kprintf("ip_nat_input: restoring header failed\n");
+      /* @todo: stats? */
+      pbuf_free(p);
+      p = NULL;
+      return 1;
     }
-    /* now that q (and/or p) is sent (or not), give up the reference to it
-       this frees the input pbuf (p) as we have consumed it. */
-    pbuf_free(q);
+    else q = p;
   }
-  return consumed;
-}
+  /* if we come here, q is the pbuf to send (either points to p or to a chain) */
+  iphdr->dest.addr = source.addr;
+  ip_nat_chksum_adjust((u8_t *) & IPH_CHKSUM(iphdr),
+    (u8_t *) & (out_addr.addr), 4,
+    (u8_t *) & (iphdr->dest.addr), 4);
+
+  ip_nat_dbg_dump("ip_nat_input: packet back to source after nat: ", iphdr);
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_input: sending packet on interface ("));
+  ip_nat_dbg_dump_ip(&(in_if->ip_addr));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
 
-/** Check if one NAT entry timed out */
-static void
-ip_nat_check_timeout(ip_nat_entry_common_t *nat_entry)
-{
-  if(nat_entry->ttl > 0) {
-    if(nat_entry->ttl != LWIP_NAT_TTL_INFINITE) {
-      /* this is not a 'no-timeout' entry */
-      if(nat_entry->ttl > LWIP_NAT_TMR_INTERVAL_SEC) {
-        nat_entry->ttl -= LWIP_NAT_TMR_INTERVAL_SEC;
-      } else {
-        nat_entry->ttl = 0;
-      }
-    }
+  err = in_if->output(in_if, q, (ip_addr_t *)&(iphdr->dest));
+  if(err != ERR_OK) {
+    LWIP_DEBUGF(LWIP_NAT_DEBUG,
+      ("ip_nat_input: failed to send rewritten packet. link layer returned %d\n",
+      err));
+    // rt_kprintf("ip_nat_input: failed to send rewritten packet. link layer returned %d\n", err);
   }
+  /* now that q (and/or p) is sent (or not), give up the reference to it
+     this frees the input pbuf (p) as we have consumed it. */
+  pbuf_free(q);
+  return 1;
 }
 
 /** The NAT timer function, to be called at an interval of
- * LWIP_NAT_TMR_INTERVAL_SEC seconds.
+ * LWIP_NAT_TMR_INTERVAL_SEC seconds. It checks one slot of the timer wheel,
+ * the connections refreshed since they were linked in the slot move to the
+ * slot of their new expiration.
  */
 void
 ip_nat_tmr(void)
 {
-  int i;
+  ip_nat_conn_t *conn, *next;
 
   LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_tmr: removing old entries\n"));
 
-  for(i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-    ip_nat_check_timeout((ip_nat_entry_common_t *) & ip_nat_icmp_table[i]);
-  }
-  for(i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    ip_nat_check_timeout((ip_nat_entry_common_t *) & ip_nat_tcp_table[i]);
+  ip_nat_ticks++;
+  conn = ip_nat_wheel[ip_nat_ticks % LWIP_NAT_WHEEL_SLOTS];
+  ip_nat_wheel[ip_nat_ticks % LWIP_NAT_WHEEL_SLOTS] = NULL;
+  for (; conn != NULL; conn = next) {
+    next = conn->wheel_next;
+    if ((s32_t)(conn->expire - ip_nat_ticks) <= 0) {
+      ip_nat_conn_free(conn);
+    } else {
+      ip_nat_wheel_insert(conn);
+    }
   }
-  for(i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    ip_nat_check_timeout((ip_nat_entry_common_t *) & ip_nat_udp_table[i]);
+
+  /* shrink the hash tables after a burst of connections */
+  if ((ip_nat_table_size > LWIP_NAT_HASH_SIZE_MIN) && (ip_nat_conn_count < ip_nat_table_size / 4)) {
+    ip_nat_resize(ip_nat_table_size / 2);
   }
 }
 
-/** Check if we want to perform NAT with this packet. If so, send it out on
- * the correct interface.
+/** Find the connection of a packet to be sent on the external interface and
+ * translate the packet. p->payload is the IP header on return.
  *
- * @param p the packet to test/send
- * @return 1: the packet has been sent using NAT,
- *         0: the packet did not belong to a NAT entry
+ * @param p the packet to translate
+ * @param allocate If no existing connection is found and this flag is true
+ *        a connection is allocated.
+ * @return the connection of the translated packet,
+ *         NULL if the packet did not belong to a NAT entry
  */
-u8_t
-ip_nat_out(struct pbuf *p)
+static ip_nat_conn_t *
+ip_nat_out_translate(struct pbuf *p, u8_t allocate)
 {
-  u8_t                  sent = 0;
-  err_t                 err;
   struct ip_hdr        *iphdr = p->payload;
   struct icmp_echo_hdr *icmphdr;
   struct tcp_hdr       *tcphdr;
   struct udp_hdr       *udphdr;
   ip_nat_conf_t        *nat_config;
-  nat_entry_t           nat_entry;
-  int             i;
-
-  nat_entry.cmn = NULL;
+  ip_nat_conn_t        *conn = NULL;
 
   ip_nat_dbg_dump("ip_nat_out: checking nat for", iphdr);
 
   /* Check if this packet should be routed or should be translated */
   nat_config = ip_nat_shallnat(iphdr);
-  if (nat_config != NULL ) {
-    if (nat_config->entry.out_if == NULL) {
-      LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: no external interface for nat table entry\n"));
-    } else {
-      switch (IPH_PROTO(iphdr))
-      {
-      case IP_PROTO_TCP:
-        tcphdr = (struct tcp_hdr *)ip_nat_check_header(p, sizeof(struct tcp_hdr));
-        if (tcphdr == NULL) {
-          LWIP_DEBUGF(LWIP_NAT_DEBUG,
-            ("ip_nat_out: short tcp packet (%" U16_F " bytes) discarded\n", p->tot_len));
-        } else {
-          nat_entry.tcp = ip_nat_tcp_lookup_outgoing(nat_config, iphdr, tcphdr, 1);
-          if (nat_entry.tcp != NULL) {
-            /* Adjust TCP checksum for changing source port */
-            tcphdr->src = nat_entry.tcp->nport;
-            ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
-              (u8_t *)&(nat_entry.tcp->sport), 2, (u8_t *)&(tcphdr->src), 2);
-            /* Adjust TCP checksum for changing source IP address */
-            ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
-              (u8_t *)&(nat_entry.cmn->source.addr), 4,
-              (u8_t *)&(nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4);
-          }
-        }
-        break;
+  if (nat_config == NULL) {
+    return NULL;
+  }
+  if (nat_config->entry.out_if == NULL) {
+    LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: no external interface for nat table entry\n"));
+    return NULL;
+  }
 
-      case IP_PROTO_UDP:
-        udphdr = (struct udp_hdr *)ip_nat_check_header(p, sizeof(struct udp_hdr));
-        if (udphdr == NULL) {
-          LWIP_DEBUGF(LWIP_NAT_DEBUG,
-            ("ip_nat_out: short udp packet (%" U16_F " bytes) discarded\n", p->tot_len));
-        } else {
-          nat_entry.udp = ip_nat_udp_lookup_outgoing(nat_config, iphdr, udphdr, 1);
-          if (nat_entry.udp != NULL) {
-            /* Adjust UDP checksum for changing source port */
-            udphdr->src = nat_entry.udp->nport;
-            ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
-              (u8_t *)&(nat_entry.udp->sport), 2, (u8_t *) & (udphdr->src), 2);
-            /* Adjust UDP checksum for changing source IP address */
-            ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
-              (u8_t *)&(nat_entry.cmn->source.addr), 4,
-              (u8_t *)&(nat_entry.cmn->cfg->entry.out_if->ip_addr.addr), 4);
-          }
-        }
-        break;
+  switch (IPH_PROTO(iphdr))
+  {
+  case IP_PROTO_TCP:
+    tcphdr = (struct tcp_hdr *)ip_nat_check_header(p, sizeof(struct tcp_hdr));
+    if (tcphdr == NULL) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG,
+        ("ip_nat_out: short tcp packet (%" U16_F " bytes) discarded\n", p->tot_len));
+    } else {
+      conn = ip_nat_lookup_outgoing(nat_config, IP_PROTO_TCP, iphdr, tcphdr->src, tcphdr->dest, allocate);
+      if (conn != NULL) {
+        ip_nat_conn_refresh(conn, tcphdr);
+        /* Adjust TCP checksum for changing source port */
+        tcphdr->src = conn->nport;
+        ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
+          (u8_t *)&(conn->sport), 2, (u8_t *)&(tcphdr->src), 2);
+        /* Adjust TCP checksum for changing source IP address */
+        ip_nat_chksum_adjust((u8_t *)&(tcphdr->chksum),
+          (u8_t *)&(conn->source.addr), 4,
+          (u8_t *)&(conn->cfg->entry.out_if->ip_addr.addr), 4);
+      }
+    }
+    break;
 
-      case IP_PROTO_ICMP:
-        icmphdr = (struct icmp_echo_hdr *)ip_nat_check_header(p, sizeof(struct icmp_echo_hdr));
-        if(icmphdr == NULL) {
-          LWIP_DEBUGF(LWIP_NAT_DEBUG,
-            ("ip_nat_out: short icmp echo packet (%" U16_F " bytes) discarded\n", p->tot_len));
-        } else {
-          if (ICMPH_TYPE(icmphdr) == ICMP_ECHO) {
-            for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_ICMP; i++) {
-              if (!ip_nat_icmp_table[i].common.ttl) {
-                nat_entry.icmp = &ip_nat_icmp_table[i];
-                ip_nat_cmn_init(nat_config, iphdr, nat_entry.cmn);
-                nat_entry.icmp->id = icmphdr->id;
-                nat_entry.icmp->seqno = icmphdr->seqno;
-                ip_nat_dbg_dump_icmp_nat_entry(" ip_nat_out: created new NAT entry ", nat_entry.icmp);
-                break;
-              }
-            }
-            if (NULL == nat_entry.icmp)
-            {
-              LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: no more NAT entries for ICMP available\n"));
-            }
-          }
-        }
-        break;
-      default:
-        break;
+  case IP_PROTO_UDP:
+    udphdr = (struct udp_hdr *)ip_nat_check_header(p, sizeof(struct udp_hdr));
+    if (udphdr == NULL) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG,
+        ("ip_nat_out: short udp packet (%" U16_F " bytes) discarded\n", p->tot_len));
+    } else {
+      conn = ip_nat_lookup_outgoing(nat_config, IP_PROTO_UDP, iphdr, udphdr->src, udphdr->dest, allocate);
+      if (conn != NULL) {
+        ip_nat_conn_refresh(conn, NULL);
+        /* Adjust UDP checksum for changing source port */
+        udphdr->src = conn->nport;
+        ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
+          (u8_t *)&(conn->sport), 2, (u8_t *) & (udphdr->src), 2);
+        /* Adjust UDP checksum for changing source IP address */
+        ip_nat_chksum_adjust((u8_t *)&(udphdr->chksum),
+          (u8_t *)&(conn->source.addr), 4,
+          (u8_t *)&(conn->cfg->entry.out_if->ip_addr.addr), 4);
       }
+    }
+    break;
 
-      if (nat_entry.cmn != NULL) {
-        struct netif *out_if = nat_entry.cmn->cfg->entry.out_if;
-        /* Exchange the IP source address with the address of the interface
-        * where the packet will be sent.
-        */
-        /* @todo: check nat_config->entry.out_if agains nat_entry.cmn->cfg->entry.out_if */
-        iphdr->src.addr = nat_config->entry.out_if->ip_addr.addr;
-        ip_nat_chksum_adjust((u8_t *) & IPH_CHKSUM(iphdr),
-          (u8_t *) & (nat_entry.cmn->source.addr), 4, (u8_t *) & iphdr->src.addr, 4);
-
-        ip_nat_dbg_dump("ip_nat_out: rewritten packet", iphdr);
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: sending packet on interface ("));
-        ip_nat_dbg_dump_ip(&(out_if->ip_addr));
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
-
-        err = out_if->output(out_if, p, (ip_addr_t *)&(iphdr->dest));
-        if (err != ERR_OK) {
-          LWIP_DEBUGF(LWIP_NAT_DEBUG,
-            ("ip_nat_out: failed to send rewritten packet. link layer returned %d\n", err));
-          // rt_kprintf("ip_nat_out: failed to send rewritten packet. link layer returned %d\n", err);
-        } else {
-          sent = 1;
-        }
+  case IP_PROTO_ICMP:
+    icmphdr = (struct icmp_echo_hdr *)ip_nat_check_header(p, sizeof(struct icmp_echo_hdr));
+    if(icmphdr == NULL) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG,
+        ("ip_nat_out: short icmp echo packet (%" U16_F " bytes) discarded\n", p->tot_len));
+    } else {
+      if (ICMPH_TYPE(icmphdr) == ICMP_ECHO) {
+        /* a retransmitted echo uses the connection of the last one */
+        conn = ip_nat_lookup_outgoing(nat_config, IP_PROTO_ICMP, iphdr, icmphdr->id, icmphdr->seqno, allocate);
       }
     }
+    break;
+  default:
+    break;
   }
 
-  return sent;
+  if (conn != NULL) {
+    /* Exchange the IP source address with the address of the interface
+    * where the packet will be sent.
+    */
+    iphdr->src.addr = conn->cfg->entry.out_if->ip_addr.addr;
+    ip_nat_chksum_adjust((u8_t *) & IPH_CHKSUM(iphdr),
+      (u8_t *) & (conn->source.addr), 4, (u8_t *) & iphdr->src.addr, 4);
+
+    ip_nat_dbg_dump("ip_nat_out: rewritten packet", iphdr);
+  }
+  return conn;
 }
 
-/** Initialize common parts of a NAT entry
+/** Send a translated packet on the external interface of its connection
  *
- * @param nat_config NAT config entry
- * @param iphdr IP header from which to initialize the entry
- * @param nat_entry entry to initialize
+ * @param p the translated packet
+ * @param conn the connection of the packet
+ * @return 1: the packet has been sent, 0: the link layer failed
  */
-static void
-ip_nat_cmn_init(ip_nat_conf_t *nat_config, const struct ip_hdr *iphdr, ip_nat_entry_common_t *nat_entry)
+static u8_t
+ip_nat_out_send(struct pbuf *p, ip_nat_conn_t *conn)
 {
-  LWIP_ASSERT("NULL != nat_entry", NULL != nat_entry);
-  LWIP_ASSERT("NULL != nat_config", NULL != nat_config);
-  LWIP_ASSERT("NULL != iphdr", NULL != iphdr);
-  nat_entry->cfg = nat_config;
-  nat_entry->dest = *((ip_addr_t *)&iphdr->dest);
-  nat_entry->source = *((ip_addr_t *)&iphdr->src);
-  nat_entry->ttl = LWIP_NAT_DEFAULT_TTL_SECONDS;
+  struct ip_hdr *iphdr = p->payload;
+  struct netif  *out_if = conn->cfg->entry.out_if;
+  err_t          err;
+
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_out: sending packet on interface ("));
+  ip_nat_dbg_dump_ip(&(out_if->ip_addr));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
+
+  err = out_if->output(out_if, p, (ip_addr_t *)&(iphdr->dest));
+  if (err != ERR_OK) {
+    LWIP_DEBUGF(LWIP_NAT_DEBUG,
+      ("ip_nat_out: failed to send rewritten packet. link layer returned %d\n", err));
+    // rt_kprintf("ip_nat_out: failed to send rewritten packet. link layer returned %d\n", err);
+    return 0;
+  }
+  return 1;
 }
 
-/**
- * This function checks for incoming packets if we already have a NAT entry.
- * If yes a pointer to the NAT entry is returned. Otherwise NULL.
+/** Check if we want to perform NAT with this packet. If so, send it out on
+ * the correct interface.
  *
- * @param nat_config NAT configuration.
- * @param iphdr The IP header.
- * @param udphdr The UDP header.
- * @return A pointer to an existing NAT entry or
- *         NULL if none is found.
+ * @param p the packet to test/send
+ * @return 1: the packet has been sent using NAT,
+ *         0: the packet did not belong to a NAT entry
  */
-static ip_nat_entries_udp_t *
-ip_nat_udp_lookup_incoming(const struct ip_hdr *iphdr, const struct udp_hdr *udphdr)
+u8_t
+ip_nat_out(struct pbuf *p)
 {
-  int i;
-  ip_nat_entries_udp_t *nat_entry = NULL;
-
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    if (ip_nat_udp_table[i].common.ttl) {
-      if ((iphdr->src.addr == ip_nat_udp_table[i].common.dest.addr) &&
-          (udphdr->src == ip_nat_udp_table[i].dport) &&
-          (udphdr->dest == ip_nat_udp_table[i].nport)) {
-        nat_entry = &ip_nat_udp_table[i];
-        ip_nat_dbg_dump_udp_nat_entry("ip_nat_udp_lookup_incoming: found existing nat entry: ",
-                                      nat_entry);
-        break;
-      }
-    }
+  ip_nat_conn_t *conn;
+
+  conn = ip_nat_out_translate(p, 1);
+  if (conn == NULL) {
+    return 0;
   }
-  return nat_entry;
+  return ip_nat_out_send(p, conn);
 }
 
-/**
- * This function checks if we already have a NAT entry for this UDP connection.
- * If yes the a pointer to this NAT entry is returned.
+#if LWIP_TCPIP_CORE_LOCKING
+/** The input function of network interfaces with the NAT fast path. The
+ * packets of existing NAT connections are translated and forwarded in the
+ * receiving thread under the core lock, without the tcpip thread mailbox.
+ * The first packet of a connection and all other packets go to
+ * tcpip_input() as before.
  *
- * @param iphdr The IP header.
- * @param udphdr The UDP header.
- * @param allocate If no existing NAT entry is found and this flag is true
- *        a NAT entry is allocated.
+ * @param p the received packet, p->payload pointing to the Ethernet header
+ * @param inp the network interface on which the packet was received
+ * @return ERR_OK if the packet has been forwarded or queued
  */
-static ip_nat_entries_udp_t *
-ip_nat_udp_lookup_outgoing(ip_nat_conf_t *nat_config, const struct ip_hdr *iphdr,
-                           const struct udp_hdr *udphdr, u8_t allocate)
+err_t
+ip_nat_netif_input(struct pbuf *p, struct netif *inp)
 {
-  int i;
-  nat_entry_t nat_entry;
-  int last_free = -1;
-
-  nat_entry.cmn = NULL;
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_UDP; i++) {
-    if (ip_nat_udp_table[i].common.ttl) {
-      if ((iphdr->src.addr == ip_nat_udp_table[i].common.source.addr) &&
-          (iphdr->dest.addr == ip_nat_udp_table[i].common.dest.addr) &&
-          (udphdr->src == ip_nat_udp_table[i].sport) &&
-          (udphdr->dest == ip_nat_udp_table[i].dport)) {
-        nat_entry.udp = &ip_nat_udp_table[i];
-
-        ip_nat_dbg_dump_udp_nat_entry("ip_nat_udp_lookup_outgoing: found existing nat entry: ",
-                                      nat_entry.udp);
+  struct eth_hdr *ethhdr = (struct eth_hdr *)p->payload;
+  struct ip_hdr  *iphdr;
+  struct netif   *netif;
+  ip_nat_conn_t  *conn;
+  u16_t           iphdr_hlen;
+  u16_t           iphdr_len;
+  u8_t            taken = 0;
+
+  if ((ip_nat_cfg == NULL) || !(inp->flags & NETIF_FLAG_ETHARP) ||
+      (p->len < SIZEOF_ETH_HDR + IP_HLEN) || (ethhdr->type != PP_HTONS(ETHTYPE_IP))) {
+    return tcpip_input(p, inp);
+  }
+
+  /* the fragments and the bad packets are handled by ip_input() */
+  iphdr = (struct ip_hdr *)((u8_t *)p->payload + SIZEOF_ETH_HDR);
+  iphdr_hlen = IPH_HL(iphdr) * 4;
+  iphdr_len = ntohs(IPH_LEN(iphdr));
+  if ((IPH_V(iphdr) != 4) || (iphdr_hlen < IP_HLEN) || (p->len < SIZEOF_ETH_HDR + iphdr_hlen) ||
+      (iphdr_len < iphdr_hlen) || (iphdr_len > p->tot_len - SIZEOF_ETH_HDR) ||
+      ((IPH_OFFSET(iphdr) & PP_HTONS(IP_OFFMASK | IP_MF)) != 0) ||
+      ip_addr_ismulticast(&(iphdr->dest))
+#if CHECKSUM_CHECK_IP
+      || (inet_chksum(iphdr, iphdr_hlen) != 0)
+#endif /* CHECKSUM_CHECK_IP */
+      ) {
+    return tcpip_input(p, inp);
+  }
+
+  LOCK_TCPIP_CORE();
+  if (!ip_addr_isbroadcast(&(iphdr->dest), inp)) {
+    /* p->payload is the IP header and the padding is trimmed as ip_input() does */
+    pbuf_header(p, -(s16_t)SIZEOF_ETH_HDR);
+    pbuf_realloc(p, iphdr_len);
+
+    for (netif = netif_list; netif != NULL; netif = netif->next) {
+      if (netif_is_up(netif) && ip_addr_cmp(&(iphdr->dest), &(netif->ip_addr))) {
         break;
       }
-    } else {
-        last_free = i;
     }
-  }
-  if (nat_entry.cmn == NULL) {
-    if (allocate) {
-      if (last_free != -1) {
-        nat_entry.udp = &ip_nat_udp_table[last_free];
-        nat_entry.udp->nport = htons((u16_t) (LWIP_NAT_DEFAULT_UDP_SOURCE_PORT + i));
-        nat_entry.udp->sport = udphdr->src;
-        nat_entry.udp->dport = udphdr->dest;
-        ip_nat_cmn_init(nat_config, iphdr, nat_entry.cmn);
-
-        ip_nat_dbg_dump_udp_nat_entry("ip_nat_udp_lookup_outgoing: created new nat entry: ",
-                                      nat_entry.udp);
-      } else {
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_udp_lookup_outgoing: no more NAT entries available\n"));
-        // rt_kprintf("ip_nat_udp_lookup_outgoing: no more NAT entries available\n");
+    if (netif != NULL) {
+      /* a reply of the connection, ip_nat_input() frees the consumed packet */
+      taken = ip_nat_input(p);
+    } else {
+      /* not for us, forward the packet of an existing connection */
+      conn = ip_nat_out_translate(p, 0);
+      if (conn != NULL) {
+        ip_nat_out_send(p, conn);
+        pbuf_free(p);
+        taken = 1;
       }
     }
+
+    if (!taken) {
+      pbuf_header(p, (s16_t)SIZEOF_ETH_HDR);
+    }
+  }
+  UNLOCK_TCPIP_CORE();
+
+  if (taken) {
+    return ERR_OK;
   }
-  return nat_entry.udp;
+  return tcpip_input(p, inp);
 }
+#endif /* LWIP_TCPIP_CORE_LOCKING */
 
 /**
  * This function checks for incoming packets if we already have a NAT entry.
  * If yes a pointer to the NAT entry is returned. Otherwise NULL.
  *
- * @param nat_config NAT configuration.
- * @param iphdr The IP header.
- * @param tcphdr The TCP header.
- * @return A pointer to an existing NAT entry or NULL if none is found.
+ * @param proto The IP protocol.
+ * @param dest The remote address, the source of incoming packet.
+ * @param dport The remote port, the seqno of ICMP echo.
+ * @param nport The translated port, the id of ICMP echo.
+ * @return A pointer to an existing NAT entry or
+ *         NULL if none is found.
  */
-static ip_nat_entries_tcp_t *
-ip_nat_tcp_lookup_incoming(const struct ip_hdr *iphdr, const struct tcp_hdr *tcphdr)
+static ip_nat_conn_t *
+ip_nat_lookup_incoming(u8_t proto, u32_t dest, u16_t dport, u16_t nport)
 {
-  int i;
-  ip_nat_entries_tcp_t *nat_entry = NULL;
+  ip_nat_conn_t *conn;
 
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    if (ip_nat_tcp_table[i].common.ttl) {
-      if ((iphdr->src.addr == ip_nat_tcp_table[i].common.dest.addr) &&
-          (tcphdr->src == ip_nat_tcp_table[i].dport) &&
-          (tcphdr->dest == ip_nat_tcp_table[i].nport)) {
-        nat_entry = &ip_nat_tcp_table[i];
+  if (ip_nat_table_size == 0) {
+    return NULL;
+  }
 
-        ip_nat_dbg_dump_tcp_nat_entry("ip_nat_tcp_lookup_incoming: found existing nat entry: ",
-                                      nat_entry);
-        break;
-      }
+  for (conn = ip_nat_in_table[IP_NAT_IN_INDEX(proto, dest, dport, nport)]; conn != NULL; conn = conn->in_next) {
+    if ((conn->proto == proto) && (conn->dest.addr == dest) &&
+        (conn->dport == dport) && (conn->nport == nport)) {
+      ip_nat_dbg_dump_conn("ip_nat_lookup_incoming: found existing nat entry: ", conn);
+      break;
     }
   }
-  return nat_entry;
+  return conn;
 }
 
 /**
- * This function checks if we already have a NAT entry for this TCP connection.
+ * This function allocates a translated port which is not used with the
+ * remote address and port.
+ *
+ * @return the port in network byte order, 0 if all ports are used.
+ */
+static u16_t
+ip_nat_port_alloc(u8_t proto, u32_t dest, u16_t dport)
+{
+  u16_t nport;
+  int i;
+
+  /* there are at most LWIP_NAT_MAX_CONNS ports in use */
+  for (i = 0; i <= LWIP_NAT_MAX_CONNS; i++) {
+    nport = htons(ip_nat_next_port);
+    if (++ip_nat_next_port == 0) {
+      ip_nat_next_port = LWIP_NAT_DEFAULT_SOURCE_PORT;
+    }
+    if (ip_nat_lookup_incoming(proto, dest, dport, nport) == NULL) {
+      return nport;
+    }
+  }
+  return 0;
+}
+
+/**
+ * This function checks if we already have a NAT entry for this connection.
  * If yes the a pointer to this NAT entry is returned.
  *
+ * @param nat_config NAT configuration.
+ * @param proto The IP protocol.
  * @param iphdr The IP header.
- * @param tcphdr The TCP header.
+ * @param sport The source port, the id of ICMP echo.
+ * @param dport The destination port, the seqno of ICMP echo.
  * @param allocate If no existing NAT entry is found and this flag is true
- *   a NAT entry is allocated.
+ *        a NAT entry is allocated.
  */
-static ip_nat_entries_tcp_t *
-ip_nat_tcp_lookup_outgoing(ip_nat_conf_t *nat_config, const struct ip_hdr *iphdr,
-                           const struct tcp_hdr *tcphdr, u8_t allocate)
+static ip_nat_conn_t *
+ip_nat_lookup_outgoing(ip_nat_conf_t *nat_config, u8_t proto, const struct ip_hdr *iphdr,
+                       u16_t sport, u16_t dport, u8_t allocate)
 {
-  int i;
-  nat_entry_t nat_entry;
-  int last_free = -1;
-
-  nat_entry.cmn = NULL;
-  for (i = 0; i < LWIP_NAT_DEFAULT_STATE_TABLES_TCP; i++) {
-    if (ip_nat_tcp_table[i].common.ttl) {
-      if ((iphdr->src.addr == ip_nat_tcp_table[i].common.source.addr) &&
-          (iphdr->dest.addr == ip_nat_tcp_table[i].common.dest.addr) &&
-          (tcphdr->src == ip_nat_tcp_table[i].sport) &&
-          (tcphdr->dest == ip_nat_tcp_table[i].dport)) {
-        nat_entry.tcp = &ip_nat_tcp_table[i];
-
-        ip_nat_dbg_dump_tcp_nat_entry("ip_nat_tcp_lookup_outgoing: found existing nat entry: ",
-                                      nat_entry.tcp);
-        break;
+  ip_nat_conn_t *conn = NULL;
+
+  if (ip_nat_table_size != 0) {
+    for (conn = ip_nat_out_table[IP_NAT_OUT_INDEX(proto, iphdr->src.addr, iphdr->dest.addr, sport, dport)];
+         conn != NULL; conn = conn->out_next) {
+      if ((conn->proto == proto) &&
+          (conn->source.addr == iphdr->src.addr) && (conn->dest.addr == iphdr->dest.addr) &&
+          (conn->sport == sport) && (conn->dport == dport)) {
+        ip_nat_dbg_dump_conn("ip_nat_lookup_outgoing: found existing nat entry: ", conn);
+        return conn;
       }
-    } else {
-        last_free = i;
     }
   }
-  if (nat_entry.cmn == NULL) {
-    if (allocate) {
-      if (last_free != -1) {
-        nat_entry.tcp = &ip_nat_tcp_table[last_free];
-        nat_entry.tcp->nport = htons((u16_t) (LWIP_NAT_DEFAULT_TCP_SOURCE_PORT + i));
-        nat_entry.tcp->sport = tcphdr->src;
-        nat_entry.tcp->dport = tcphdr->dest;
-        ip_nat_cmn_init(nat_config, iphdr, nat_entry.cmn);
-
-        ip_nat_dbg_dump_tcp_nat_entry("ip_nat_tcp_lookup_outgoing: created new nat entry: ",
-                                      nat_entry.tcp);
-      } else {
-        LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_udp_lookup_outgoing: no more NAT entries available\n"));
-        // rt_kprintf("ip_nat_udp_lookup_outgoing: no more NAT entries available\n");
-      }
+  if (!allocate) {
+    return NULL;
+  }
+
+  if (ip_nat_conn_count >= LWIP_NAT_MAX_CONNS) {
+    LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_lookup_outgoing: no more NAT entries available\n"));
+    return NULL;
+  }
+  /* keep the chains short, the connections are no more than the buckets */
+  if ((ip_nat_conn_count >= ip_nat_table_size) && (ip_nat_table_size < LWIP_NAT_HASH_SIZE_MAX)) {
+    ip_nat_resize(ip_nat_table_size ? ip_nat_table_size * 2 : LWIP_NAT_HASH_SIZE_MIN);
+  }
+  if (ip_nat_table_size == 0) {
+    return NULL;
+  }
+
+  conn = (ip_nat_conn_t *)mem_malloc(sizeof(ip_nat_conn_t));
+  if (conn == NULL) {
+    LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_lookup_outgoing: no memory for NAT entry\n"));
+    return NULL;
+  }
+  conn->proto = proto;
+  conn->cfg = nat_config;
+  conn->source.addr = iphdr->src.addr;
+  conn->dest.addr = iphdr->dest.addr;
+  conn->sport = sport;
+  conn->dport = dport;
+  if (proto == IP_PROTO_ICMP) {
+    conn->nport = sport;
+  } else {
+    conn->nport = ip_nat_port_alloc(proto, conn->dest.addr, dport);
+    if (conn->nport == 0) {
+      LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ip_nat_lookup_outgoing: no more NAT ports available\n"));
+      mem_free(conn);
+      return NULL;
     }
   }
-  return nat_entry.tcp;
+  conn->expire = ip_nat_ticks + LWIP_NAT_DEFAULT_TTL_TICKS;
+
+  ip_nat_conn_hash(conn);
+  ip_nat_wheel_insert(conn);
+  ip_nat_conn_count++;
+
+  ip_nat_dbg_dump_conn("ip_nat_lookup_outgoing: created new nat entry: ", conn);
+  return conn;
 }
 
 /** Adjusts the checksum of a NAT'ed packet without having to completely recalculate it
@@ -999,92 +1143,32 @@ ip_nat_dbg_dump(const char *msg, const struct ip_hdr *iphdr)
 }
 
 /**
- * This function dumps an ICMP echo reply/recho request nat entry.
- *
- * @param msg a message to print
- * @param nat_entry the ICMP NAT entry to print
- */
-static void
-ip_nat_dbg_dump_icmp_nat_entry(const char *msg, const ip_nat_entries_icmp_t *nat_entry)
-{
-  LWIP_ASSERT("NULL != msg", NULL != msg);
-  LWIP_ASSERT("NULL != nat_entry", NULL != nat_entry);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg", NULL != nat_entry->common.cfg);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg->entry.out_if",
-    NULL != nat_entry->common.cfg->entry.out_if);
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("%s", msg));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("ICMP : ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.source));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" id=%" U16_F, ntohs(nat_entry->id)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (", seq=%" U16_F, ntohs(nat_entry->seqno)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (") mapped at ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.cfg->entry.out_if->ip_addr));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" id=%" U16_F, ntohs(nat_entry->id)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (", seq=%" U16_F, ntohs(nat_entry->seqno)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
-}
-
-/**
- * This function dumps an TCP nat entry.
- *
- * @param msg a message to print
- * @param nat_entry the TCP NAT entry to print
- */
-static void
-ip_nat_dbg_dump_tcp_nat_entry(const char *msg, const ip_nat_entries_tcp_t *nat_entry)
-{
-  LWIP_ASSERT("NULL != msg", NULL != msg);
-  LWIP_ASSERT("NULL != nat_entry", NULL != nat_entry);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg", NULL != nat_entry->common.cfg);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg->entry.out_if",
-    NULL != nat_entry->common.cfg->entry.out_if);
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("%s", msg));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("TCP : ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.source));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->sport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->dport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (") mapped at ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.cfg->entry.out_if->ip_addr));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->nport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->dport)));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
-}
-
-/**
- * This function dumps a UDP NAT entry.
+ * This function dumps a NAT connection.
  *
  * @param msg a message to print
- * @param nat_entry the UDP NAT entry to print
+ * @param conn the NAT connection to print
  */
 static void
-ip_nat_dbg_dump_udp_nat_entry(const char *msg, const ip_nat_entries_udp_t *nat_entry)
+ip_nat_dbg_dump_conn(const char *msg, const ip_nat_conn_t *conn)
 {
   LWIP_ASSERT("NULL != msg", NULL != msg);
-  LWIP_ASSERT("NULL != nat_entry", NULL != nat_entry);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg", NULL != nat_entry->common.cfg);
-  LWIP_ASSERT("NULL != nat_entry->common.cfg->entry.out_if",
-    NULL != nat_entry->common.cfg->entry.out_if);
+  LWIP_ASSERT("NULL != conn", NULL != conn);
+  LWIP_ASSERT("NULL != conn->cfg", NULL != conn->cfg);
+  LWIP_ASSERT("NULL != conn->cfg->entry.out_if", NULL != conn->cfg->entry.out_if);
   LWIP_DEBUGF(LWIP_NAT_DEBUG, ("%s", msg));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("UDP : ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.source));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->sport)));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, ("%s : (", conn->proto == IP_PROTO_TCP ? "TCP" :
+    (conn->proto == IP_PROTO_UDP ? "UDP" : "ICMP")));
+  ip_nat_dbg_dump_ip(&(conn->source));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(conn->sport)));
   LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->dport)));
+  ip_nat_dbg_dump_ip(&(conn->dest));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(conn->dport)));
   LWIP_DEBUGF(LWIP_NAT_DEBUG, (") mapped at ("));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.cfg->entry.out_if->ip_addr));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->nport)));
+  ip_nat_dbg_dump_ip(&(conn->cfg->entry.out_if->ip_addr));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(conn->nport)));
   LWIP_DEBUGF(LWIP_NAT_DEBUG, (" --> "));
-  ip_nat_dbg_dump_ip(&(nat_entry->common.dest));
-  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(nat_entry->dport)));
+  ip_nat_dbg_dump_ip(&(conn->dest));
+  LWIP_DEBUGF(LWIP_NAT_DEBUG, (":%" U16_F, ntohs(conn->dport)));
   LWIP_DEBUGF(LWIP_NAT_DEBUG, (")\n"));
 }
 
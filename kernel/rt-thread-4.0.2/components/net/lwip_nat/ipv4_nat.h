@@ -31,6 +31,7 @@
  * Date           Author       Notes
  * 2015-01-26     Hichard      porting to RT-Thread
  * 2015-01-27     Bernard      code cleanup for lwIP in RT-Thread
+ * 2026-10-18     liujiahao    add ip_nat_netif_input fast path
  */
 
 #ifndef __LWIP_NAT_H__
@@ -44,8 +45,8 @@
 #include "lwip/ip_addr.h"
 #include "lwip/opt.h"
 
-/** Timer interval at which to call ip_nat_tmr() */
-#define LWIP_NAT_TMR_INTERVAL_SEC        (30)
+/** Timer interval at which to call ip_nat_tmr(), a slot of the timer wheel */
+#define LWIP_NAT_TMR_INTERVAL_SEC        (4)
 
 #ifdef __cplusplus
 extern "C" {
@@ -68,6 +69,9 @@ void  ip_nat_init(void);
 void  ip_nat_tmr(void);
 u8_t  ip_nat_input(struct pbuf *p);
 u8_t  ip_nat_out(struct pbuf *p);
+#if LWIP_TCPIP_CORE_LOCKING
+err_t ip_nat_netif_input(struct pbuf *p, struct netif *inp);
+#endif /* LWIP_TCPIP_CORE_LOCKING */
 
 err_t ip_nat_add(const ip_nat_entry_t *new_entry);
 void  ip_nat_remove(const ip_nat_entry_t *remove_entry);
@@ -0,0 +1,729 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * The network benchmark over SAL sockets, like iperf and netperf:
+ *
+ *     msh />netbench tcp_stream|udp_stream|tcp_rr|udp_rr|tcp_crr [-H host] [-d netdev] [-p port] [-t seconds] [-l size]
+ *     msh />netbench server [-p port]
+ *     msh />netbench stop
+ *
+ * tcp_stream, udp_stream: send the messages to the discard port, in Mbit/s and packets/s.
+ * tcp_rr, udp_rr:         the request and response on the echo port, in transactions/s
+ *                         and the latency percentiles.
+ * tcp_crr:                connect, request, response and close, in connections/s and the
+ *                         latency percentiles, the size 0 is connect and close only.
+ *
+ * The discard port is the port, 5201 by default, the echo port is the port + 1, so any
+ * discard and echo servers can be the peer. The local servers are started for a local
+ * host, 127.0.0.1 by default, and the receiver side results are reported too.
+ *
+ * The client is bound to the address of netdev by -d, so the sockets go through the
+ * protocol family of netdev, such as lwIP or AT socket. The host "vnet" is the virtual
+ * Ethernet pair of lwIP, the client is on v0 and the server is on v1.
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_NETBENCH) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdev.h>
+
+#ifdef RT_USING_CPUTIME
+#include <rtdevice.h>
+#endif
+
+#define DBG_TAG                 "netbench"
+#define DBG_LVL                 DBG_INFO
+#include <rtdbg.h>
+
+#define NETBENCH_PORT           5201
+#define NETBENCH_SIZE_MAX       8192
+#define NETBENCH_SAMPLES        1024    /* the reservoir of latency samples */
+#define NETBENCH_POLL_MS        100     /* the receive timeout of servers to check the stop */
+#define NETBENCH_STACK_SIZE     2048
+
+enum netbench_test
+{
+    NETBENCH_TCP_STREAM,
+    NETBENCH_UDP_STREAM,
+    NETBENCH_TCP_RR,
+    NETBENCH_UDP_RR,
+    NETBENCH_TCP_CRR,
+};
+
+enum netbench_service
+{
+    NETBENCH_TCP_DISCARD,
+    NETBENCH_TCP_ECHO,
+    NETBENCH_UDP_DISCARD,
+    NETBENCH_UDP_ECHO,
+    NETBENCH_SERVICE_MAX,
+};
+
+struct netbench_service_stat
+{
+    rt_uint64_t bytes;
+    rt_uint32_t packets;                /* the datagrams of UDP, the receptions of TCP */
+    rt_uint32_t connections;
+};
+
+struct netbench_server
+{
+    volatile int stop;
+    int port;
+    int running;
+    struct netbench_service_stat stat[NETBENCH_SERVICE_MAX];
+    struct rt_semaphore done;
+};
+
+struct netbench_latency
+{
+    rt_uint32_t *samples;
+    rt_uint32_t count;                  /* all of the samples, not only the reservoir */
+    rt_uint32_t min;
+    rt_uint32_t max;
+    rt_uint64_t sum;
+};
+
+struct netbench_result
+{
+    rt_uint64_t bytes;
+    rt_uint32_t packets;
+    rt_uint32_t errors;
+    rt_uint32_t elapsed_ms;
+    struct netbench_latency latency;
+};
+
+struct netbench_args
+{
+    enum netbench_test test;
+    struct sockaddr_in host;
+    struct sockaddr_in local;           /* the address of netdev, or INADDR_ANY */
+    int seconds;
+    int size;
+};
+
+static const char *netbench_test_name[] = {"tcp_stream", "udp_stream", "tcp_rr", "udp_rr", "tcp_crr"};
+static const char *netbench_service_name[] = {"tcp discard", "tcp echo", "udp discard", "udp echo"};
+
+static struct netbench_server netbench_server;
+
+static rt_uint32_t netbench_now_us(void)
+{
+#ifdef RT_USING_CPUTIME
+    return (rt_uint32_t)clock_cpu_microsecond(clock_cpu_gettime());
+#else
+    return (rt_uint32_t)((rt_uint64_t)rt_tick_get() * 1000000 / RT_TICK_PER_SECOND);
+#endif
+}
+
+static rt_uint32_t netbench_ip4_addr(const ip_addr_t *ipaddr)
+{
+#if NETDEV_IPV4 && NETDEV_IPV6
+    return ipaddr->u_addr.ip4.addr;
+#else
+    return ipaddr->addr;
+#endif
+}
+
+static rt_bool_t netbench_is_local(rt_uint32_t addr)
+{
+    ip_addr_t ipaddr;
+
+    if ((ntohl(addr) >> 24) == 127)
+        return RT_TRUE;
+
+#if NETDEV_IPV4 && NETDEV_IPV6
+    ipaddr.u_addr.ip4.addr = addr;
+    ipaddr.type = IPADDR_TYPE_V4;
+#else
+    ipaddr.addr = addr;
+#endif
+
+    return netdev_get_by_ipaddr(&ipaddr) != RT_NULL;
+}
+
+static void netbench_set_timeout(int sock, int ms)
+{
+    struct timeval timeout;
+
+    timeout.tv_sec = ms / 1000;
+    timeout.tv_usec = (ms % 1000) * 1000;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+}
+
+static void netbench_service_entry(void *parameter)
+{
+    enum netbench_service service = (enum netbench_service)(rt_ubase_t)parameter;
+    struct netbench_service_stat *stat = &netbench_server.stat[service];
+    struct sockaddr_in addr;
+    socklen_t addr_len;
+    int tcp = (service == NETBENCH_TCP_DISCARD || service == NETBENCH_TCP_ECHO);
+    int echo = (service == NETBENCH_TCP_ECHO || service == NETBENCH_UDP_ECHO);
+    int sock, conn, len, sent, result, on = 1;
+    char *buf;
+
+    buf = rt_malloc(NETBENCH_SIZE_MAX);
+    sock = socket(AF_INET, tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+    if (buf == RT_NULL || sock < 0)
+        goto __exit;
+
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(netbench_server.port + (echo ? 1 : 0));
+    addr.sin_addr.s_addr = INADDR_ANY;
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 || (tcp && listen(sock, 4) < 0))
+    {
+        LOG_E("%s bind port %d failed", netbench_service_name[service], ntohs(addr.sin_port));
+        goto __exit;
+    }
+    netbench_set_timeout(sock, NETBENCH_POLL_MS);
+
+    while (!netbench_server.stop)
+    {
+        addr_len = sizeof(addr);
+        if (!tcp)
+        {
+            len = recvfrom(sock, buf, NETBENCH_SIZE_MAX, 0, (struct sockaddr *)&addr, &addr_len);
+            if (len <= 0)
+                continue;
+            stat->bytes += len;
+            stat->packets ++;
+            if (echo)
+                sendto(sock, buf, len, 0, (struct sockaddr *)&addr, addr_len);
+            continue;
+        }
+
+        conn = accept(sock, (struct sockaddr *)&addr, &addr_len);
+        if (conn < 0)
+            continue;
+        stat->connections ++;
+        setsockopt(conn, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        netbench_set_timeout(conn, NETBENCH_POLL_MS);
+
+        /* serve the connection until it's closed */
+        while (!netbench_server.stop)
+        {
+            len = recv(conn, buf, NETBENCH_SIZE_MAX, 0);
+            if (len == 0 || (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+                break;
+            if (len < 0)
+                continue;
+            stat->bytes += len;
+            stat->packets ++;
+
+            for (sent = 0; echo && sent < len; sent += result)
+            {
+                result = send(conn, buf + sent, len - sent, 0);
+                if (result <= 0)
+                    break;
+            }
+        }
+        closesocket(conn);
+    }
+
+__exit:
+    if (sock >= 0)
+        closesocket(sock);
+    rt_free(buf);
+    rt_sem_release(&netbench_server.done);
+}
+
+static int netbench_server_start(int port)
+{
+    rt_thread_t tid;
+    int index;
+
+    if (netbench_server.running)
+        return -RT_EBUSY;
+
+    rt_memset(&netbench_server, 0, sizeof(netbench_server));
+    netbench_server.port = port;
+    rt_sem_init(&netbench_server.done, "nbench", 0, RT_IPC_FLAG_FIFO);
+
+    for (index = 0; index < NETBENCH_SERVICE_MAX; index ++)
+    {
+        tid = rt_thread_create("nbench", netbench_service_entry, (void *)(rt_ubase_t)index,
+                               NETBENCH_STACK_SIZE, RT_THREAD_PRIORITY_MAX / 2, 10);
+        if (tid == RT_NULL)
+            break;
+        rt_thread_startup(tid);
+        netbench_server.running ++;
+    }
+
+    if (netbench_server.running != NETBENCH_SERVICE_MAX)
+    {
+        LOG_E("create server thread failed");
+        return -RT_ENOMEM;
+    }
+
+    return RT_EOK;
+}
+
+static void netbench_server_stop(void)
+{
+    if (netbench_server.running == 0)
+        return;
+
+    netbench_server.stop = 1;
+    while (netbench_server.running)
+    {
+        rt_sem_take(&netbench_server.done, RT_WAITING_FOREVER);
+        netbench_server.running --;
+    }
+    rt_sem_detach(&netbench_server.done);
+}
+
+/* Algorithm R, the reservoir is a uniform sample of all */
+static void netbench_latency_add(struct netbench_latency *latency, rt_uint32_t us)
+{
+    rt_uint32_t index;
+
+    if (latency->count == 0 || us < latency->min)
+        latency->min = us;
+    if (us > latency->max)
+        latency->max = us;
+    latency->sum += us;
+
+    if (latency->count < NETBENCH_SAMPLES)
+    {
+        latency->samples[latency->count] = us;
+    }
+    else
+    {
+        index = (rt_uint32_t)rand() % (latency->count + 1);
+        if (index < NETBENCH_SAMPLES)
+            latency->samples[index] = us;
+    }
+    latency->count ++;
+}
+
+static int netbench_latency_compare(const void *a, const void *b)
+{
+    rt_uint32_t x = *(const rt_uint32_t *)a, y = *(const rt_uint32_t *)b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static int netbench_connect(struct netbench_args *args, int type, int echo)
+{
+    struct sockaddr_in addr = args->host;
+    int sock, on = 1;
+
+    sock = socket(AF_INET, type, 0);
+    if (sock < 0)
+        return -1;
+
+    /* the netdev of local address selects the protocol family of socket */
+    if (args->local.sin_addr.s_addr != INADDR_ANY &&
+        bind(sock, (struct sockaddr *)&args->local, sizeof(args->local)) < 0)
+    {
+        closesocket(sock);
+        return -1;
+    }
+
+    netbench_set_timeout(sock, 1000);
+    if (type == SOCK_STREAM)
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+    addr.sin_port = htons(ntohs(addr.sin_port) + (echo ? 1 : 0));
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        closesocket(sock);
+        return -1;
+    }
+
+    return sock;
+}
+
+/* send the message and receive the echo, return the latency in microseconds or -1 */
+static int netbench_transact(int sock, char *buf, int size, int tcp)
+{
+    rt_uint32_t begin = netbench_now_us();
+    int len, result;
+
+    if (send(sock, buf, size, 0) != size)
+        return -1;
+
+    for (len = 0; len < size; len += result)
+    {
+        result = recv(sock, buf + len, size - len, 0);
+        if (result <= 0)
+            return -1;
+        if (!tcp)
+            break;
+    }
+
+    return (int)(netbench_now_us() - begin);
+}
+
+static int netbench_run(struct netbench_args *args, struct netbench_result *result, char *buf)
+{
+    int tcp = (args->test != NETBENCH_UDP_STREAM && args->test != NETBENCH_UDP_RR);
+    int sock = -1, us;
+    rt_tick_t begin, end;
+
+    begin = rt_tick_get();
+    end = begin + args->seconds * RT_TICK_PER_SECOND;
+
+    if (args->test != NETBENCH_TCP_CRR)
+    {
+        sock = netbench_connect(args, tcp ? SOCK_STREAM : SOCK_DGRAM,
+                                args->test == NETBENCH_TCP_RR || args->test == NETBENCH_UDP_RR);
+        if (sock < 0)
+        {
+            rt_kprintf("connect failed\n");
+            return -1;
+        }
+    }
+
+    while ((rt_int32_t)(rt_tick_get() - end) < 0)
+    {
+        switch (args->test)
+        {
+        case NETBENCH_TCP_STREAM:
+        case NETBENCH_UDP_STREAM:
+            us = send(sock, buf, args->size, 0);
+            if (us <= 0)
+            {
+                /* UDP is out of buffers, TCP is broken */
+                result->errors ++;
+                if (tcp)
+                    goto __exit;
+                rt_thread_yield();
+                continue;
+            }
+            result->bytes += us;
+            result->packets ++;
+            break;
+
+        case NETBENCH_TCP_RR:
+        case NETBENCH_UDP_RR:
+            us = netbench_transact(sock, buf, args->size, tcp);
+            if (us < 0)
+            {
+                /* the datagram is lost */
+                result->errors ++;
+                if (tcp)
+                    goto __exit;
+                continue;
+            }
+            netbench_latency_add(&result->latency, us);
+            result->bytes += args->size;
+            result->packets ++;
+            break;
+
+        case NETBENCH_TCP_CRR:
+        {
+            rt_uint32_t start = netbench_now_us();
+
+            sock = netbench_connect(args, SOCK_STREAM, 1);
+            if (sock < 0 || (args->size > 0 && netbench_transact(sock, buf, args->size, 1) < 0))
+            {
+                result->errors ++;
+            }
+            else
+            {
+                netbench_latency_add(&result->latency, netbench_now_us() - start);
+                result->bytes += args->size;
+                result->packets ++;
+            }
+            if (sock >= 0)
+                closesocket(sock);
+            sock = -1;
+            break;
+        }
+        }
+    }
+
+__exit:
+    result->elapsed_ms = (rt_tick_get() - begin) * 1000 / RT_TICK_PER_SECOND;
+    if (result->elapsed_ms == 0)
+        result->elapsed_ms = 1;
+    if (sock >= 0)
+        closesocket(sock);
+
+    return 0;
+}
+
+static void netbench_print_rate(const char *name, rt_uint64_t bytes, rt_uint32_t packets, rt_uint32_t ms)
+{
+    rt_uint32_t kbps = (rt_uint32_t)(bytes * 8 / ms);
+
+    rt_kprintf("%-9s %d bytes, %d packets in %d ms, %d.%02d Mbit/s, %d packets/s\n", name,
+               (rt_uint32_t)bytes, packets, ms, kbps / 1000, kbps % 1000 / 10,
+               (rt_uint32_t)((rt_uint64_t)packets * 1000 / ms));
+}
+
+static void netbench_print_latency(struct netbench_latency *latency)
+{
+    rt_uint32_t num = latency->count < NETBENCH_SAMPLES ? latency->count : NETBENCH_SAMPLES;
+
+    if (num == 0)
+        return;
+
+    qsort(latency->samples, num, sizeof(rt_uint32_t), netbench_latency_compare);
+    rt_kprintf("latency   avg %d us, min %d us, p50 %d us, p90 %d us, p99 %d us, max %d us\n",
+               (rt_uint32_t)(latency->sum / latency->count), latency->min, latency->samples[num / 2],
+               latency->samples[num * 90 / 100], latency->samples[num * 99 / 100], latency->max);
+}
+
+static void netbench_report(struct netbench_args *args, struct netbench_result *result,
+                            struct netbench_service_stat *served)
+{
+    rt_uint32_t ms = result->elapsed_ms;
+
+    rt_kprintf("%s to %s:%d, %d bytes\n", netbench_test_name[args->test],
+               inet_ntoa(args->host.sin_addr), ntohs(args->host.sin_port), args->size);
+
+    switch (args->test)
+    {
+    case NETBENCH_TCP_STREAM:
+    case NETBENCH_UDP_STREAM:
+        netbench_print_rate("sent", result->bytes, result->packets, ms);
+        if (served != RT_NULL)
+        {
+            netbench_print_rate("received", served->bytes, served->packets, ms);
+            if (args->test == NETBENCH_UDP_STREAM && result->packets > 0)
+            {
+                rt_uint32_t lost = result->packets > served->packets ? result->packets - served->packets : 0;
+
+                rt_kprintf("lost      %d datagrams, %d.%02d%%\n", lost, lost * 100 / result->packets,
+                           (rt_uint32_t)((rt_uint64_t)lost * 10000 / result->packets % 100));
+            }
+        }
+        if (result->errors)
+            rt_kprintf("errors    %d sends failed\n", result->errors);
+        break;
+
+    case NETBENCH_TCP_RR:
+    case NETBENCH_UDP_RR:
+        rt_kprintf("rate      %d transactions in %d ms, %d transactions/s, %d failed\n", result->packets, ms,
+                   (rt_uint32_t)((rt_uint64_t)result->packets * 1000 / ms), result->errors);
+        netbench_print_latency(&result->latency);
+        break;
+
+    case NETBENCH_TCP_CRR:
+        rt_kprintf("rate      %d connections in %d ms, %d connections/s, %d failed\n", result->packets, ms,
+                   (rt_uint32_t)((rt_uint64_t)result->packets * 1000 / ms), result->errors);
+        if (served != RT_NULL)
+            rt_kprintf("served    %d connections\n", served->connections);
+        netbench_print_latency(&result->latency);
+        break;
+    }
+}
+
+static int netbench_parse(struct netbench_args *args, int argc, char **argv, int *port)
+{
+    const char *host = "127.0.0.1";
+    struct netdev *netdev;
+    int index;
+
+    for (index = 2; index < argc; index ++)
+    {
+        if (index + 1 >= argc || argv[index][0] != '-')
+            return -1;
+
+        switch (argv[index][1])
+        {
+        case 'H':
+            host = argv[++ index];
+            break;
+        case 'd':
+            netdev = netdev_get_by_name(argv[++ index]);
+            if (netdev == RT_NULL)
+            {
+                rt_kprintf("netdev %s not found\n", argv[index]);
+                return -1;
+            }
+            args->local.sin_addr.s_addr = netbench_ip4_addr(&netdev->ip_addr);
+            break;
+        case 'p':
+            *port = atoi(argv[++ index]);
+            break;
+        case 't':
+            args->seconds = atoi(argv[++ index]);
+            break;
+        case 'l':
+            args->size = atoi(argv[++ index]);
+            break;
+        default:
+            return -1;
+        }
+    }
+
+#ifdef NETBENCH_USING_VNET
+    if (strcmp(host, "vnet") == 0)
+    {
+        host = NETBENCH_VNET_IPADDR1;
+        args->local.sin_addr.s_addr = inet_addr(NETBENCH_VNET_IPADDR0);
+    }
+#endif
+
+    args->host.sin_family = AF_INET;
+    args->host.sin_port = htons(*port);
+    args->host.sin_addr.s_addr = inet_addr(host);
+    args->local.sin_family = AF_INET;
+
+    if (args->host.sin_addr.s_addr == IPADDR_NONE || *port <= 0 || *port >= 0xFFFF || args->seconds <= 0 ||
+        args->size < (args->test == NETBENCH_TCP_CRR ? 0 : 1) || args->size > NETBENCH_SIZE_MAX)
+        return -1;
+
+    return 0;
+}
+
+static void netbench_usage(void)
+{
+    rt_kprintf("Usage: netbench tcp_stream|udp_stream|tcp_rr|udp_rr|tcp_crr [options]\n");
+    rt_kprintf("       netbench server [-p port]\n");
+    rt_kprintf("       netbench stop\n");
+    rt_kprintf("  -H host     the server, 127.0.0.1 by default");
+#ifdef NETBENCH_USING_VNET
+    rt_kprintf(", vnet for the virtual Ethernet pair");
+#endif
+    rt_kprintf("\n");
+    rt_kprintf("  -d netdev   bind the client to the address of netdev\n");
+    rt_kprintf("  -p port     the discard port, the echo port is port + 1, %d by default\n", NETBENCH_PORT);
+    rt_kprintf("  -t seconds  the duration, 5 by default\n");
+    rt_kprintf("  -l size     the message size <= %d, 1024 for streams and 1 for others by default\n",
+               NETBENCH_SIZE_MAX);
+}
+
+static void netbench(int argc, char **argv)
+{
+    struct netbench_args args;
+    struct netbench_result result;
+    struct netbench_service_stat served[NETBENCH_SERVICE_MAX];
+    enum netbench_service service;
+    int port = NETBENCH_PORT, local_server = 0, index;
+    char *buf = RT_NULL;
+
+    if (argc < 2)
+        goto __usage;
+
+    if (strcmp(argv[1], "stop") == 0)
+    {
+        netbench_server_stop();
+        return;
+    }
+    if (strcmp(argv[1], "server") == 0)
+    {
+        if (argc == 4 && strcmp(argv[2], "-p") == 0)
+            port = atoi(argv[3]);
+        else if (argc != 2)
+            goto __usage;
+        if (netbench_server_start(port) != RT_EOK)
+        {
+            rt_kprintf("start server failed\n");
+            netbench_server_stop();
+            return;
+        }
+        rt_kprintf("discard on port %d, echo on port %d\n", port, port + 1);
+        return;
+    }
+
+    rt_memset(&args, 0, sizeof(args));
+    rt_memset(&result, 0, sizeof(result));
+    for (index = 0; index < sizeof(netbench_test_name) / sizeof(netbench_test_name[0]); index ++)
+    {
+        if (strcmp(argv[1], netbench_test_name[index]) == 0)
+            break;
+    }
+    if (index == sizeof(netbench_test_name) / sizeof(netbench_test_name[0]))
+        goto __usage;
+    args.test = (enum netbench_test)index;
+    args.seconds = 5;
+    args.size = (args.test == NETBENCH_TCP_STREAM || args.test == NETBENCH_UDP_STREAM) ? 1024 : 1;
+    if (netbench_parse(&args, argc, argv, &port) < 0)
+        goto __usage;
+
+    buf = rt_malloc(NETBENCH_SIZE_MAX);
+    result.latency.samples = rt_malloc(NETBENCH_SAMPLES * sizeof(rt_uint32_t));
+    if (buf == RT_NULL || result.latency.samples == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        goto __exit;
+    }
+    rt_memset(buf, 0x5A, NETBENCH_SIZE_MAX);
+
+    /* the local host is served by the local servers, which count the received */
+    if (netbench_is_local(args.host.sin_addr.s_addr))
+    {
+        if (netbench_server.running == 0)
+        {
+            if (netbench_server_start(port) != RT_EOK)
+            {
+                rt_kprintf("start server failed\n");
+                netbench_server_stop();
+                goto __exit;
+            }
+            local_server = 1;
+            /* the servers are listening */
+            rt_thread_mdelay(NETBENCH_POLL_MS);
+        }
+        else if (netbench_server.port != port)
+        {
+            rt_kprintf("the server is running on port %d\n", netbench_server.port);
+            goto __exit;
+        }
+        rt_memcpy(served, netbench_server.stat, sizeof(served));
+    }
+
+    netbench_run(&args, &result, buf);
+
+    if (netbench_is_local(args.host.sin_addr.s_addr))
+    {
+        /* the data in flight is received */
+        rt_thread_mdelay(NETBENCH_POLL_MS);
+
+        switch (args.test)
+        {
+        case NETBENCH_TCP_STREAM:
+            service = NETBENCH_TCP_DISCARD;
+            break;
+        case NETBENCH_UDP_STREAM:
+            service = NETBENCH_UDP_DISCARD;
+            break;
+        case NETBENCH_UDP_RR:
+            service = NETBENCH_UDP_ECHO;
+            break;
+        default:
+            service = NETBENCH_TCP_ECHO;
+            break;
+        }
+        served[service].bytes = netbench_server.stat[service].bytes - served[service].bytes;
+        served[service].packets = netbench_server.stat[service].packets - served[service].packets;
+        served[service].connections = netbench_server.stat[service].connections - served[service].connections;
+        netbench_report(&args, &result, &served[service]);
+    }
+    else
+    {
+        netbench_report(&args, &result, RT_NULL);
+    }
+
+__exit:
+    if (local_server)
+        netbench_server_stop();
+    rt_free(result.latency.samples);
+    rt_free(buf);
+    return;
+
+__usage:
+    netbench_usage();
+}
+MSH_CMD_EXPORT(netbench, network benchmark: netbench tcp_stream|udp_stream|tcp_rr|udp_rr|tcp_crr|server|stop);
+
+#endif /* defined(RT_USING_NETBENCH) && defined(RT_USING_FINSH) */
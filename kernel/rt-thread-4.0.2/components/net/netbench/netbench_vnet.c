@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * The virtual Ethernet pair v0 and v1 for the network benchmark, the frames sent on one
+ * are received on the other one, like veth of Linux.
+ *
+ * Both of them are in the same lwIP, so the source based route of LWIP_HOOK_IP4_ROUTE_SRC
+ * sends the packets from the address of one to the address of the other one through the
+ * pair instead of the loopback.
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_NETBENCH) && defined(NETBENCH_USING_VNET)
+#include <lwip/opt.h>
+#include <lwip/pbuf.h>
+#include <lwip/netif.h>
+#include <lwip/netifapi.h>
+#include <lwip/inet.h>
+#include <netif/ethernetif.h>
+
+#define DBG_TAG                 "netbench.vnet"
+#define DBG_LVL                 DBG_INFO
+#include <rtdbg.h>
+
+#define NETBENCH_VNET_NUM       2
+#define NETBENCH_VNET_QUEUE     64
+
+struct netbench_vnet
+{
+    struct eth_device parent;
+
+    struct netbench_vnet *peer;
+    struct rt_mailbox queue;            /* the frames from the peer */
+    rt_ubase_t queue_pool[NETBENCH_VNET_QUEUE];
+    rt_uint8_t dev_addr[6];
+
+    rt_uint32_t tx_packets;
+    rt_uint32_t rx_packets;
+    rt_uint32_t drops;
+};
+
+static struct netbench_vnet netbench_vnet_devices[NETBENCH_VNET_NUM];
+static const char *netbench_vnet_ipaddr[NETBENCH_VNET_NUM] = {NETBENCH_VNET_IPADDR0, NETBENCH_VNET_IPADDR1};
+
+static rt_err_t netbench_vnet_control(rt_device_t dev, int cmd, void *args)
+{
+    struct netbench_vnet *vnet = (struct netbench_vnet *)dev;
+
+    switch (cmd)
+    {
+    case NIOCTL_GADDR:
+        if (args == RT_NULL)
+            return -RT_ERROR;
+        rt_memcpy(args, vnet->dev_addr, 6);
+        break;
+
+    default:
+        break;
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t netbench_vnet_tx(rt_device_t dev, struct pbuf *p)
+{
+    struct netbench_vnet *vnet = (struct netbench_vnet *)dev;
+    struct pbuf *q;
+
+    /* the sent pbuf belongs to the sender, the peer receives a copy like the wire */
+    q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_POOL);
+    if (q == RT_NULL)
+    {
+        vnet->drops ++;
+        return -RT_ENOMEM;
+    }
+    pbuf_copy(q, p);
+
+    if (rt_mb_send(&vnet->peer->queue, (rt_ubase_t)q) != RT_EOK)
+    {
+        pbuf_free(q);
+        vnet->drops ++;
+        return -RT_EFULL;
+    }
+    vnet->tx_packets ++;
+
+    eth_device_ready(&vnet->peer->parent);
+
+    return RT_EOK;
+}
+
+static struct pbuf *netbench_vnet_rx(rt_device_t dev)
+{
+    struct netbench_vnet *vnet = (struct netbench_vnet *)dev;
+    rt_ubase_t value;
+
+    if (rt_mb_recv(&vnet->queue, &value, 0) != RT_EOK)
+        return RT_NULL;
+    vnet->rx_packets ++;
+
+    return (struct pbuf *)value;
+}
+
+/* the source based route of the pair, the others use the route of destination */
+struct netif *netbench_vnet_route(const ip4_addr_t *src, const ip4_addr_t *dest)
+{
+    struct netbench_vnet *vnet;
+    struct netif *netif, *peer;
+    int index;
+
+    if (src == RT_NULL)
+        return RT_NULL;
+
+    for (index = 0; index < NETBENCH_VNET_NUM; index ++)
+    {
+        vnet = &netbench_vnet_devices[index];
+        netif = vnet->parent.netif;
+        if (vnet->peer == RT_NULL || netif == RT_NULL || vnet->peer->parent.netif == RT_NULL)
+            continue;
+        peer = vnet->peer->parent.netif;
+
+        if (ip4_addr_cmp(src, netif_ip4_addr(netif)) && ip4_addr_cmp(dest, netif_ip4_addr(peer)) &&
+            netif_is_up(netif) && netif_is_link_up(netif))
+            return netif;
+    }
+
+    return RT_NULL;
+}
+
+static int netbench_vnet_init(void)
+{
+    struct netbench_vnet *vnet;
+    ip4_addr_t ipaddr, netmask, gw;
+    char name[RT_NAME_MAX];
+    int index;
+
+    for (index = 0; index < NETBENCH_VNET_NUM; index ++)
+    {
+        vnet = &netbench_vnet_devices[index];
+        vnet->peer = &netbench_vnet_devices[(index + 1) % NETBENCH_VNET_NUM];
+
+        /* the locally administered address */
+        vnet->dev_addr[0] = 0x02;
+        vnet->dev_addr[5] = index + 1;
+
+        rt_snprintf(name, sizeof(name), "v%d", index);
+        rt_mb_init(&vnet->queue, name, vnet->queue_pool, NETBENCH_VNET_QUEUE, RT_IPC_FLAG_FIFO);
+
+        vnet->parent.parent.control = netbench_vnet_control;
+        vnet->parent.eth_rx = netbench_vnet_rx;
+        vnet->parent.eth_tx = netbench_vnet_tx;
+
+        if (eth_device_init_with_flag(&vnet->parent, name,
+                                      NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | ETHIF_LINK_PHYUP) != RT_EOK)
+        {
+            LOG_E("%s init failed", name);
+            return -RT_ERROR;
+        }
+
+#if LWIP_DHCP
+        netifapi_dhcp_stop(vnet->parent.netif);
+#endif
+        ipaddr.addr = inet_addr(netbench_vnet_ipaddr[index]);
+        netmask.addr = inet_addr("255.255.255.0");
+        gw.addr = 0;
+        netifapi_netif_set_addr(vnet->parent.netif, &ipaddr, &netmask, &gw);
+    }
+
+    return RT_EOK;
+}
+INIT_APP_EXPORT(netbench_vnet_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void netbench_vnet(int argc, char **argv)
+{
+    struct netbench_vnet *vnet;
+    int index;
+
+    for (index = 0; index < NETBENCH_VNET_NUM; index ++)
+    {
+        vnet = &netbench_vnet_devices[index];
+        rt_kprintf("v%d %-15s tx %d, rx %d, drop %d\n", index, netbench_vnet_ipaddr[index],
+                   vnet->tx_packets, vnet->rx_packets, vnet->drops);
+    }
+}
+MSH_CMD_EXPORT(netbench_vnet, show the packets of the virtual Ethernet pair);
+#endif /* RT_USING_FINSH */
+
+#endif /* defined(RT_USING_NETBENCH) && defined(NETBENCH_USING_VNET) */
@@ -0,0 +1,726 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * The packet capture of lwIP network interfaces to pcap:
+ *
+ *     msh />netcap start [-i netdev] [-t tcp|udp|icmp|arp] [-p port] [-H host] [-s snaplen] -w file|tcp://host:port
+ *     msh />netcap stop
+ *     msh />netcap
+ *
+ * The input and linkoutput functions of the captured network interfaces are replaced by the
+ * tap during the capture only, so there is no overhead when it's stopped. The tap filters the
+ * packets by the headers, and copies at most snaplen bytes of the matched packets to a slot of
+ * the preallocated ring buffer, the packets are dropped when the ring buffer is full. A low
+ * priority thread writes the slots to the pcap file or the TCP stream of lwIP socket.
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+
+#ifdef RT_USING_NETCAP
+#include <string.h>
+#include <stdlib.h>
+#include <lwip/opt.h>
+#include <lwip/pbuf.h>
+#include <lwip/netif.h>
+#include <lwip/sockets.h>
+#include <lwip/netdb.h>
+#include <netdev.h>
+#include <netcap.h>
+
+#ifdef RT_USING_DFS
+#include <dfs_posix.h>
+#endif
+
+#define DBG_TAG                 "netcap"
+#define DBG_LVL                 DBG_INFO
+#include <rtdbg.h>
+
+#define NETCAP_NETIF_MAX        4
+#define NETCAP_SNAPLEN_MAX      1522
+#define NETCAP_HDR_LEN          82      /* Ethernet, VLAN tag, IPv4 with options and ports */
+#define NETCAP_STACK_SIZE       2048
+#define NETCAP_POLL_MS          100
+
+#define NETCAP_ETHTYPE_IP       0x0800
+#define NETCAP_ETHTYPE_ARP      0x0806
+#define NETCAP_ETHTYPE_VLAN     0x8100
+
+#define NETCAP_PCAP_MAGIC       0xa1b2c3d4
+#define NETCAP_LINKTYPE_ETH     1
+
+struct netcap_pcap_hdr
+{
+    rt_uint32_t magic;
+    rt_uint16_t version_major;
+    rt_uint16_t version_minor;
+    rt_int32_t thiszone;
+    rt_uint32_t sigfigs;
+    rt_uint32_t snaplen;
+    rt_uint32_t network;
+};
+
+struct netcap_pcap_rec
+{
+    rt_uint32_t ts_sec;
+    rt_uint32_t ts_usec;
+    rt_uint32_t incl_len;
+    rt_uint32_t orig_len;
+};
+
+/* the slot of ring buffer, the record is followed by the data and written as is */
+struct netcap_slot
+{
+    volatile rt_uint32_t ready;
+    struct netcap_pcap_rec rec;
+};
+
+struct netcap_hook
+{
+    struct netif *netif;
+    netif_input_fn input;
+    netif_linkoutput_fn linkoutput;
+};
+
+struct netcap
+{
+    volatile rt_bool_t running;
+    rt_thread_t thread;
+    struct rt_semaphore notice;
+
+    struct netcap_filter filter;
+    rt_size_t snaplen;
+    int fd;
+    rt_bool_t is_socket;
+    rt_uint16_t stream_port;            /* the local port of TCP stream, which isn't captured */
+
+    rt_uint8_t *ring;
+    rt_uint32_t slot_size;
+    rt_uint32_t slot_num;
+    rt_uint32_t head;                   /* the next slot to reserve */
+    rt_uint32_t tail;                   /* the next slot to write */
+    volatile rt_uint32_t busy;          /* the slots in copying */
+
+    struct netcap_hook hooks[NETCAP_NETIF_MAX];
+    int hook_num;
+
+    struct netcap_stat stat;
+};
+
+static struct netcap netcap;
+
+static struct netcap_hook *netcap_hook_find(struct netif *netif)
+{
+    int index;
+
+    for (index = 0; index < netcap.hook_num; index++)
+    {
+        if (netcap.hooks[index].netif == netif)
+            return &netcap.hooks[index];
+    }
+
+    return RT_NULL;
+}
+
+static rt_bool_t netcap_match_host(const rt_uint8_t *addr1, const rt_uint8_t *addr2)
+{
+    return rt_memcmp(addr1, &netcap.filter.host, 4) == 0 || rt_memcmp(addr2, &netcap.filter.host, 4) == 0;
+}
+
+/* match the packet with the filter by the headers */
+static rt_bool_t netcap_match(struct pbuf *p)
+{
+    struct netcap_filter *filter = &netcap.filter;
+    rt_uint8_t buf[NETCAP_HDR_LEN];
+    const rt_uint8_t *pkt;
+    rt_uint16_t len, type, offset = 14, ihl, sport, dport;
+    rt_uint8_t proto;
+
+    if (filter->proto == NETCAP_PROTO_ANY && filter->port == 0 && filter->host == 0 && netcap.stream_port == 0)
+        return RT_TRUE;
+
+    len = p->tot_len < NETCAP_HDR_LEN ? p->tot_len : NETCAP_HDR_LEN;
+    if (p->len >= len)
+    {
+        pkt = (const rt_uint8_t *)p->payload;
+    }
+    else
+    {
+        pbuf_copy_partial(p, buf, len, 0);
+        pkt = buf;
+    }
+
+    if (len < offset)
+        return RT_FALSE;
+
+    type = (pkt[12] << 8) | pkt[13];
+    if (type == NETCAP_ETHTYPE_VLAN && len >= offset + 4)
+    {
+        type = (pkt[16] << 8) | pkt[17];
+        offset += 4;
+    }
+
+    if (type == NETCAP_ETHTYPE_ARP)
+    {
+        if ((filter->proto != NETCAP_PROTO_ANY && filter->proto != NETCAP_PROTO_ARP) || filter->port)
+            return RT_FALSE;
+        /* the sender and target protocol addresses */
+        if (filter->host && (len < offset + 28 || !netcap_match_host(pkt + offset + 14, pkt + offset + 24)))
+            return RT_FALSE;
+        return RT_TRUE;
+    }
+
+    if (type != NETCAP_ETHTYPE_IP)
+        return filter->proto == NETCAP_PROTO_ANY && filter->port == 0 && filter->host == 0;
+
+    if (filter->proto == NETCAP_PROTO_ARP || len < offset + 20)
+        return RT_FALSE;
+
+    ihl = (pkt[offset] & 0x0F) * 4;
+    proto = pkt[offset + 9];
+    if ((filter->proto == NETCAP_PROTO_TCP && proto != 6) ||
+        (filter->proto == NETCAP_PROTO_UDP && proto != 17) ||
+        (filter->proto == NETCAP_PROTO_ICMP && proto != 1))
+        return RT_FALSE;
+
+    if (filter->host && !netcap_match_host(pkt + offset + 12, pkt + offset + 16))
+        return RT_FALSE;
+
+    /* the ports are in the first fragment of TCP and UDP only */
+    if ((proto == 6 || proto == 17) && (((pkt[offset + 6] & 0x1F) << 8) | pkt[offset + 7]) == 0 &&
+        len >= offset + ihl + 4)
+    {
+        sport = (pkt[offset + ihl] << 8) | pkt[offset + ihl + 1];
+        dport = (pkt[offset + ihl + 2] << 8) | pkt[offset + ihl + 3];
+    }
+    else
+    {
+        sport = dport = 0;
+    }
+
+    /* the capture stream itself */
+    if (netcap.stream_port && proto == 6 && (sport == netcap.stream_port || dport == netcap.stream_port))
+        return RT_FALSE;
+
+    if (filter->port && sport != filter->port && dport != filter->port)
+        return RT_FALSE;
+
+    return RT_TRUE;
+}
+
+/* copy the packet to a slot of ring buffer, it's called by the threads of lwIP and drivers */
+static void netcap_tap(struct pbuf *p)
+{
+    struct netcap_slot *slot;
+    rt_tick_t tick;
+    rt_base_t level;
+    rt_uint32_t index;
+    rt_bool_t empty;
+
+    if (!netcap_match(p))
+    {
+        netcap.stat.filtered++;
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    if (!netcap.running || netcap.head - netcap.tail >= netcap.slot_num)
+    {
+        if (netcap.running)
+            netcap.stat.dropped++;
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+    empty = netcap.head == netcap.tail;
+    index = netcap.head++ % netcap.slot_num;
+    netcap.busy++;
+    rt_hw_interrupt_enable(level);
+
+    slot = (struct netcap_slot *)(netcap.ring + index * netcap.slot_size);
+    tick = rt_tick_get();
+    slot->rec.ts_sec = tick / RT_TICK_PER_SECOND;
+    slot->rec.ts_usec = (tick % RT_TICK_PER_SECOND) * (1000000 / RT_TICK_PER_SECOND);
+    slot->rec.orig_len = p->tot_len;
+    slot->rec.incl_len = pbuf_copy_partial(p, slot + 1, p->tot_len < netcap.snaplen ? p->tot_len : netcap.snaplen, 0);
+    slot->ready = 1;
+
+    level = rt_hw_interrupt_disable();
+    netcap.stat.captured++;
+    netcap.busy--;
+    rt_hw_interrupt_enable(level);
+
+    if (empty)
+        rt_sem_release(&netcap.notice);
+}
+
+static err_t netcap_input(struct pbuf *p, struct netif *netif)
+{
+    struct netcap_hook *hook = netcap_hook_find(netif);
+
+    if (hook == RT_NULL)
+        return ERR_IF;
+
+    netcap_tap(p);
+
+    return hook->input(p, netif);
+}
+
+static err_t netcap_linkoutput(struct netif *netif, struct pbuf *p)
+{
+    struct netcap_hook *hook = netcap_hook_find(netif);
+
+    if (hook == RT_NULL)
+        return ERR_IF;
+
+    netcap_tap(p);
+
+    return hook->linkoutput(netif, p);
+}
+
+static int netcap_output_write(const void *buf, rt_size_t len)
+{
+#if LWIP_SOCKET
+    if (netcap.is_socket)
+        return lwip_send(netcap.fd, buf, len, 0);
+#endif
+#ifdef RT_USING_DFS
+    return write(netcap.fd, buf, len);
+#else
+    return -1;
+#endif
+}
+
+static void netcap_output_close(void)
+{
+#if LWIP_SOCKET
+    if (netcap.is_socket)
+    {
+        lwip_close(netcap.fd);
+        return;
+    }
+#endif
+#ifdef RT_USING_DFS
+    close(netcap.fd);
+#endif
+}
+
+static int netcap_output_open(const char *output)
+{
+    if (rt_strncmp(output, "tcp://", 6) == 0)
+    {
+#if LWIP_SOCKET
+        struct sockaddr_in addr;
+        struct hostent *host;
+        socklen_t len;
+        char name[64];
+        char *port;
+
+        rt_strncpy(name, output + 6, sizeof(name) - 1);
+        name[sizeof(name) - 1] = '\0';
+        port = strchr(name, ':');
+        if (port == RT_NULL)
+        {
+            LOG_E("no port in %s.", output);
+            return -RT_ERROR;
+        }
+        *port++ = '\0';
+
+        host = lwip_gethostbyname(name);
+        if (host == RT_NULL)
+        {
+            LOG_E("resolve %s failed.", name);
+            return -RT_ERROR;
+        }
+
+        netcap.fd = lwip_socket(AF_INET, SOCK_STREAM, 0);
+        if (netcap.fd < 0)
+        {
+            LOG_E("create socket failed.");
+            return -RT_ERROR;
+        }
+
+        rt_memset(&addr, 0x00, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(atoi(port));
+        rt_memcpy(&addr.sin_addr, host->h_addr_list[0], sizeof(addr.sin_addr));
+        if (lwip_connect(netcap.fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            LOG_E("connect %s failed.", output);
+            lwip_close(netcap.fd);
+            return -RT_ERROR;
+        }
+        netcap.is_socket = RT_TRUE;
+
+        len = sizeof(addr);
+        if (lwip_getsockname(netcap.fd, (struct sockaddr *)&addr, &len) == 0)
+            netcap.stream_port = ntohs(addr.sin_port);
+
+        return RT_EOK;
+#else
+        LOG_E("the TCP stream needs LWIP_SOCKET.");
+        return -RT_ERROR;
+#endif /* LWIP_SOCKET */
+    }
+
+#ifdef RT_USING_DFS
+    netcap.fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0);
+    if (netcap.fd < 0)
+    {
+        LOG_E("open %s failed.", output);
+        return -RT_ERROR;
+    }
+    netcap.is_socket = RT_FALSE;
+
+    return RT_EOK;
+#else
+    LOG_E("the pcap file needs RT_USING_DFS.");
+    return -RT_ERROR;
+#endif /* RT_USING_DFS */
+}
+
+/* write the ready slots in order */
+static void netcap_flush(void)
+{
+    struct netcap_slot *slot;
+    rt_size_t len;
+
+    while (netcap.tail != netcap.head)
+    {
+        slot = (struct netcap_slot *)(netcap.ring + (netcap.tail % netcap.slot_num) * netcap.slot_size);
+        if (!slot->ready)
+            break;
+
+        len = sizeof(struct netcap_pcap_rec) + slot->rec.incl_len;
+        if (netcap.fd >= 0 && netcap_output_write(&slot->rec, len) != len)
+        {
+            netcap.stat.write_errors++;
+            /* the stream is broken, the rest are not written */
+            if (netcap.is_socket)
+            {
+                netcap_output_close();
+                netcap.fd = -1;
+            }
+        }
+        else if (netcap.fd >= 0)
+        {
+            netcap.stat.written++;
+        }
+
+        slot->ready = 0;
+        netcap.tail++;
+    }
+}
+
+static void netcap_thread_entry(void *parameter)
+{
+    while (netcap.running)
+    {
+        rt_sem_take(&netcap.notice, rt_tick_from_millisecond(NETCAP_POLL_MS));
+        netcap_flush();
+    }
+
+    /* wait for the taps copying to the slots */
+    while (netcap.busy)
+    {
+        rt_thread_mdelay(1);
+    }
+    netcap_flush();
+
+    if (netcap.fd >= 0)
+    {
+        netcap_output_close();
+        netcap.fd = -1;
+    }
+    rt_free(netcap.ring);
+    netcap.ring = RT_NULL;
+    rt_sem_detach(&netcap.notice);
+
+    LOG_I("capture stopped, %d packets written.", netcap.stat.written);
+    netcap.thread = RT_NULL;
+}
+
+static int netcap_hook_add(struct netif *netif)
+{
+    struct netcap_hook *hook;
+
+    if (netcap_hook_find(netif))
+        return RT_EOK;
+
+    if (netcap.hook_num == NETCAP_NETIF_MAX)
+    {
+        LOG_W("capture %d network interfaces at most.", NETCAP_NETIF_MAX);
+        return -RT_EFULL;
+    }
+
+    /* the link output of Ethernet network interfaces is captured */
+    if (!(netif->flags & NETIF_FLAG_ETHARP) || netif->input == RT_NULL || netif->linkoutput == RT_NULL)
+        return -RT_EINVAL;
+
+    hook = &netcap.hooks[netcap.hook_num++];
+    hook->netif = netif;
+    hook->input = netif->input;
+    hook->linkoutput = netif->linkoutput;
+
+    return RT_EOK;
+}
+
+int netcap_start(const char *name, const struct netcap_filter *filter, rt_size_t snaplen, const char *output)
+{
+    struct netcap_pcap_hdr hdr;
+    struct netdev *netdev;
+    struct netif *netif;
+    int index;
+
+    RT_ASSERT(output);
+
+    if (netcap.thread)
+    {
+        LOG_E("the capture is running.");
+        return -RT_EBUSY;
+    }
+
+    if (snaplen == 0 || snaplen > NETCAP_SNAPLEN_MAX)
+        snaplen = NETCAP_SNAPLEN_MAX;
+
+    rt_memset(&netcap, 0x00, sizeof(netcap));
+    netcap.fd = -1;
+    netcap.snaplen = snaplen;
+    if (filter)
+        netcap.filter = *filter;
+
+    /* find the network interfaces */
+    if (name)
+    {
+        netdev = netdev_get_by_name(name);
+        if (netdev == RT_NULL || netdev_family_get(netdev) != AF_INET || netdev->user_data == RT_NULL ||
+            netcap_hook_add((struct netif *)netdev->user_data) != RT_EOK)
+        {
+            LOG_E("%s isn't an Ethernet interface of lwIP.", name);
+            return -RT_EINVAL;
+        }
+    }
+    else
+    {
+        rt_enter_critical();
+        for (netif = netif_list; netif != RT_NULL; netif = netif->next)
+        {
+            netcap_hook_add(netif);
+        }
+        rt_exit_critical();
+
+        if (netcap.hook_num == 0)
+        {
+            LOG_E("no Ethernet interface of lwIP.");
+            return -RT_EINVAL;
+        }
+    }
+
+    netcap.slot_size = RT_ALIGN(sizeof(struct netcap_slot) + snaplen, RT_ALIGN_SIZE);
+    netcap.slot_num = NETCAP_RING_SIZE / netcap.slot_size;
+    if (netcap.slot_num < 2)
+    {
+        LOG_E("the ring buffer %d is too small for snaplen %d.", NETCAP_RING_SIZE, snaplen);
+        return -RT_EINVAL;
+    }
+
+    netcap.ring = rt_malloc(netcap.slot_num * netcap.slot_size);
+    if (netcap.ring == RT_NULL)
+    {
+        LOG_E("no memory for the ring buffer.");
+        return -RT_ENOMEM;
+    }
+    rt_memset(netcap.ring, 0x00, netcap.slot_num * netcap.slot_size);
+
+    if (netcap_output_open(output) != RT_EOK)
+        goto __exit;
+
+    hdr.magic = NETCAP_PCAP_MAGIC;
+    hdr.version_major = 2;
+    hdr.version_minor = 4;
+    hdr.thiszone = 0;
+    hdr.sigfigs = 0;
+    hdr.snaplen = snaplen;
+    hdr.network = NETCAP_LINKTYPE_ETH;
+    if (netcap_output_write(&hdr, sizeof(hdr)) != sizeof(hdr))
+    {
+        LOG_E("write %s failed.", output);
+        netcap_output_close();
+        goto __exit;
+    }
+
+    rt_sem_init(&netcap.notice, "netcap", 0, RT_IPC_FLAG_FIFO);
+    netcap.thread = rt_thread_create("netcap", netcap_thread_entry, RT_NULL,
+                                     NETCAP_STACK_SIZE, NETCAP_THREAD_PRIORITY, 10);
+    if (netcap.thread == RT_NULL)
+    {
+        LOG_E("create the capture thread failed.");
+        rt_sem_detach(&netcap.notice);
+        netcap_output_close();
+        goto __exit;
+    }
+
+    /* replace the functions of network interfaces by the tap */
+    netcap.running = RT_TRUE;
+    rt_enter_critical();
+    for (index = 0; index < netcap.hook_num; index++)
+    {
+        netcap.hooks[index].netif->input = netcap_input;
+        netcap.hooks[index].netif->linkoutput = netcap_linkoutput;
+    }
+    rt_exit_critical();
+
+    rt_thread_startup(netcap.thread);
+
+    return RT_EOK;
+
+__exit:
+    rt_free(netcap.ring);
+    netcap.ring = RT_NULL;
+    netcap.fd = -1;
+
+    return -RT_ERROR;
+}
+
+int netcap_stop(void)
+{
+    struct netcap_hook *hook;
+    int index;
+
+    if (netcap.thread == RT_NULL || !netcap.running)
+        return -RT_ERROR;
+
+    /* restore the functions of network interfaces, the hooks are kept for the taps in calling */
+    rt_enter_critical();
+    for (index = 0; index < netcap.hook_num; index++)
+    {
+        hook = &netcap.hooks[index];
+        if (hook->netif->input == netcap_input)
+            hook->netif->input = hook->input;
+        if (hook->netif->linkoutput == netcap_linkoutput)
+            hook->netif->linkoutput = hook->linkoutput;
+    }
+    netcap.running = RT_FALSE;
+    rt_exit_critical();
+
+    rt_sem_release(&netcap.notice);
+    while (netcap.thread)
+    {
+        rt_thread_mdelay(NETCAP_POLL_MS / 10);
+    }
+
+    return RT_EOK;
+}
+
+void netcap_get_stat(struct netcap_stat *stat)
+{
+    RT_ASSERT(stat);
+
+    *stat = netcap.stat;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void netcap_usage(void)
+{
+    rt_kprintf("Usage: netcap start [-i netdev] [-t tcp|udp|icmp|arp] [-p port] [-H host] [-s snaplen] -w file|tcp://host:port\n");
+    rt_kprintf("       netcap stop\n");
+    rt_kprintf("       netcap\n");
+}
+
+static void netcap_cmd(int argc, char **argv)
+{
+    static const char *proto_name[] = {"any", "tcp", "udp", "icmp", "arp"};
+    struct netcap_filter filter;
+    struct netcap_stat stat;
+    const char *name = RT_NULL, *output = RT_NULL;
+    rt_size_t snaplen = NETCAP_SNAPLEN;
+    int index, proto;
+
+    if (argc == 1)
+    {
+        netcap_get_stat(&stat);
+        rt_kprintf("capture %s, %d slots of %d bytes\n", netcap.thread ? "running" : "stopped",
+                   netcap.slot_num, netcap.slot_size);
+        rt_kprintf("captured %d, filtered %d, dropped %d, written %d, write errors %d\n",
+                   stat.captured, stat.filtered, stat.dropped, stat.written, stat.write_errors);
+        return;
+    }
+
+    if (strcmp(argv[1], "stop") == 0)
+    {
+        if (netcap_stop() != RT_EOK)
+            rt_kprintf("the capture isn't running\n");
+        return;
+    }
+
+    if (strcmp(argv[1], "start") != 0)
+    {
+        netcap_usage();
+        return;
+    }
+
+    rt_memset(&filter, 0x00, sizeof(filter));
+    for (index = 2; index < argc; index++)
+    {
+        if (index + 1 >= argc || argv[index][0] != '-')
+            goto __usage;
+
+        switch (argv[index][1])
+        {
+        case 'i':
+            name = argv[++index];
+            break;
+        case 't':
+            index++;
+            for (proto = NETCAP_PROTO_TCP; proto <= NETCAP_PROTO_ARP; proto++)
+            {
+                if (strcmp(argv[index], proto_name[proto]) == 0)
+                    break;
+            }
+            if (proto > NETCAP_PROTO_ARP)
+                goto __usage;
+            filter.proto = (enum netcap_proto)proto;
+            break;
+        case 'p':
+            filter.port = atoi(argv[++index]);
+            break;
+        case 'H':
+            filter.host = ipaddr_addr(argv[++index]);
+            break;
+        case 's':
+            snaplen = atoi(argv[++index]);
+            break;
+        case 'w':
+            output = argv[++index];
+            break;
+        default:
+            goto __usage;
+        }
+    }
+
+    if (output == RT_NULL)
+        goto __usage;
+
+    if (netcap_start(name, &filter, snaplen, output) == RT_EOK)
+    {
+        rt_kprintf("capture %s to %s, %s, snaplen %d\n", name ? name : "all interfaces", output,
+                   proto_name[filter.proto], netcap.snaplen);
+    }
+    return;
+
+__usage:
+    netcap_usage();
+}
+MSH_CMD_EXPORT_ALIAS(netcap_cmd, netcap, capture packets to pcap: netcap start|stop);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_USING_NETCAP */
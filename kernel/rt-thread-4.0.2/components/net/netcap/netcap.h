@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#ifndef NETCAP_H__
+#define NETCAP_H__
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the size of the preallocated capture ring buffer */
+#ifndef NETCAP_RING_SIZE
+#define NETCAP_RING_SIZE               16384
+#endif
+
+/* the default maximum length of each captured packet */
+#ifndef NETCAP_SNAPLEN
+#define NETCAP_SNAPLEN                 128
+#endif
+
+#ifndef NETCAP_THREAD_PRIORITY
+#define NETCAP_THREAD_PRIORITY         (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+
+enum netcap_proto
+{
+    NETCAP_PROTO_ANY,
+    NETCAP_PROTO_TCP,
+    NETCAP_PROTO_UDP,
+    NETCAP_PROTO_ICMP,
+    NETCAP_PROTO_ARP,
+};
+
+struct netcap_filter
+{
+    enum netcap_proto proto;
+    rt_uint16_t port;                  /* the source or destination port, 0 is any */
+    rt_uint32_t host;                  /* the source or destination IPv4 address in network byte order, 0 is any */
+};
+
+struct netcap_stat
+{
+    rt_uint32_t captured;
+    rt_uint32_t filtered;              /* the packets not matched by the filter */
+    rt_uint32_t dropped;               /* the packets dropped for the full ring buffer */
+    rt_uint32_t written;               /* the packets written to the output */
+    rt_uint32_t write_errors;
+};
+
+/*
+ * Start to capture the Ethernet packets of lwIP network interface, the name RT_NULL captures
+ * all of them. The output is a pcap file path on DFS or "tcp://host:port" which the pcap stream
+ * is sent to, such as "nc -l 9000 | wireshark -k -i -".
+ */
+int netcap_start(const char *name, const struct netcap_filter *filter, rt_size_t snaplen, const char *output);
+int netcap_stop(void);
+void netcap_get_stat(struct netcap_stat *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NETCAP_H__ */
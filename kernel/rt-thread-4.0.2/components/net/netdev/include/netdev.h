@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-03-18     ChenYong     First version
+ * 2026-10-18     liujiahao    Add the statistics for the policy selection
  */
 
 #ifndef __NETDEV_H__
@@ -76,6 +77,26 @@ typedef void (*netdev_callback_fn )(struct netdev *netdev, enum netdev_cb_type t
 
 struct netdev_ops;
 
+#ifdef NETDEV_USING_POLICY
+/* network interface device statistics for the policy selection */
+struct netdev_stat
+{
+    uint32_t tx_bytes;                                 /* the bytes sent by sockets */
+    uint32_t rx_bytes;                                 /* the bytes received by sockets */
+    uint32_t tx_rate;                                  /* the bytes per second sent in the last period */
+    uint32_t rx_rate;                                  /* the bytes per second received in the last period */
+    uint32_t latency;                                  /* the smoothed connect latency in milliseconds, 0 is unknown */
+    uint32_t connects;                                 /* the connections established */
+    uint32_t connect_errors;                           /* the connections failed */
+    uint32_t migrations;                               /* the new connections migrated to it on link loss */
+    uint16_t flows;                                    /* the sockets using it */
+    uint16_t cost;                                     /* the cost set by application, the lower is preferred */
+
+    uint32_t last_tx_bytes;
+    uint32_t last_rx_bytes;
+};
+#endif /* NETDEV_USING_POLICY */
+
 /* network interface device object */
 struct netdev
 {
@@ -103,6 +124,10 @@ struct netdev
     void *sal_user_data;                               /* user-specific data for SAL */
 #endif /* RT_USING_SAL */
     void *user_data;                                   /* user-specific data */
+
+#ifdef NETDEV_USING_POLICY
+    struct netdev_stat stat;                           /* statistics for the policy selection */
+#endif /* NETDEV_USING_POLICY */
 };
 
 /* The list of network interface device */
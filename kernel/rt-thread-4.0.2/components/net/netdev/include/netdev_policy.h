@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    First version
+ */
+
+#ifndef __NETDEV_POLICY_H__
+#define __NETDEV_POLICY_H__
+
+#include <netdev.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the period of the throughput statistics in seconds */
+#ifndef NETDEV_POLICY_PERIOD
+#define NETDEV_POLICY_PERIOD           2
+#endif
+
+/* the maximum number of network interface devices selected from */
+#ifndef NETDEV_POLICY_CANDIDATES
+#define NETDEV_POLICY_CANDIDATES       8
+#endif
+
+/* the policy of the network interface device selection */
+enum netdev_policy
+{
+    NETDEV_POLICY_DEFAULT,             /* the default one, or the first available one if it's down */
+    NETDEV_POLICY_LATENCY,             /* the lowest connect latency */
+    NETDEV_POLICY_COST,                /* the lowest cost, the flows of same cost are distributed by hash */
+    NETDEV_POLICY_LOAD,                /* the lowest throughput, then the fewest flows */
+    NETDEV_POLICY_HASH,                /* the flows are distributed by hash */
+    NETDEV_POLICY_MAX,
+};
+
+/* return RT_TRUE if the network interface device can be selected */
+typedef rt_bool_t (*netdev_policy_filter_fn)(struct netdev *netdev, void *arg);
+
+/* Set and get the global policy */
+void netdev_policy_set(enum netdev_policy policy);
+enum netdev_policy netdev_policy_get(void);
+const char *netdev_policy_name(enum netdev_policy policy);
+
+/* Set the cost of network interface device, such as the cellular uplink is more costly */
+void netdev_set_cost(struct netdev *netdev, uint16_t cost);
+
+/* Check the network interface device is up, link up and has the IP address */
+rt_bool_t netdev_policy_available(struct netdev *netdev);
+
+/* Select the network interface device by the policy and the hash of flow, RT_NULL is none available */
+struct netdev *netdev_policy_select(enum netdev_policy policy, uint32_t hash,
+                                    netdev_policy_filter_fn filter, void *arg);
+
+/* Update the statistics of network interface device */
+void netdev_policy_flow(struct netdev *netdev, rt_bool_t add);
+void netdev_policy_traffic(struct netdev *netdev, uint32_t tx_bytes, uint32_t rx_bytes);
+void netdev_policy_connected(struct netdev *netdev, rt_tick_t ticks, rt_bool_t success);
+void netdev_policy_migrated(struct netdev *netdev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NETDEV_POLICY_H__ */
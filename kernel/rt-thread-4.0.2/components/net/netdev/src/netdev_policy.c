@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    First version
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <rtthread.h>
+#include <rthw.h>
+
+#include <netdev_ipaddr.h>
+#include <netdev.h>
+
+#ifdef NETDEV_USING_POLICY
+#include <netdev_policy.h>
+
+#define DBG_TAG              "netdev.policy"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+static enum netdev_policy netdev_global_policy = NETDEV_POLICY_DEFAULT;
+static struct rt_timer netdev_policy_timer;
+
+static const char *netdev_policy_names[NETDEV_POLICY_MAX] =
+{
+    "default", "latency", "cost", "load", "hash"
+};
+
+/* update the throughput of all network interface devices in the last period */
+static void netdev_policy_timeout(void *parameter)
+{
+    rt_slist_t *node = RT_NULL;
+    struct netdev *netdev = RT_NULL;
+    rt_base_t level;
+
+    if (netdev_list == RT_NULL)
+    {
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    for (node = &(netdev_list->list); node; node = rt_slist_next(node))
+    {
+        netdev = rt_slist_entry(node, struct netdev, list);
+        netdev->stat.tx_rate = (netdev->stat.tx_bytes - netdev->stat.last_tx_bytes) / NETDEV_POLICY_PERIOD;
+        netdev->stat.rx_rate = (netdev->stat.rx_bytes - netdev->stat.last_rx_bytes) / NETDEV_POLICY_PERIOD;
+        netdev->stat.last_tx_bytes = netdev->stat.tx_bytes;
+        netdev->stat.last_rx_bytes = netdev->stat.rx_bytes;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+static int netdev_policy_init(void)
+{
+    rt_timer_init(&netdev_policy_timer, "netdev_p", netdev_policy_timeout, RT_NULL,
+                  NETDEV_POLICY_PERIOD * RT_TICK_PER_SECOND, RT_TIMER_FLAG_PERIODIC);
+    rt_timer_start(&netdev_policy_timer);
+
+    return 0;
+}
+INIT_COMPONENT_EXPORT(netdev_policy_init);
+
+/**
+ * This function will set the global policy of network interface device selection.
+ *
+ * @param policy the new policy
+ */
+void netdev_policy_set(enum netdev_policy policy)
+{
+    if (policy < NETDEV_POLICY_MAX)
+    {
+        netdev_global_policy = policy;
+    }
+}
+
+/**
+ * This function will get the global policy of network interface device selection.
+ *
+ * @return the global policy
+ */
+enum netdev_policy netdev_policy_get(void)
+{
+    return netdev_global_policy;
+}
+
+const char *netdev_policy_name(enum netdev_policy policy)
+{
+    return (policy < NETDEV_POLICY_MAX) ? netdev_policy_names[policy] : "unknown";
+}
+
+/**
+ * This function will set the cost of network interface device.
+ *
+ * @param netdev the network interface device to change
+ * @param cost the new cost, the lower is preferred by the cost policy
+ */
+void netdev_set_cost(struct netdev *netdev, uint16_t cost)
+{
+    RT_ASSERT(netdev);
+
+    netdev->stat.cost = cost;
+}
+
+/**
+ * This function will check the network interface device can be selected by the policy.
+ *
+ * @param netdev the network interface device to check
+ *
+ * @return RT_TRUE: it's up, link up and has the IP address
+ */
+rt_bool_t netdev_policy_available(struct netdev *netdev)
+{
+    return (netdev && netdev_is_up(netdev) && netdev_is_link_up(netdev) &&
+            !ip_addr_isany(&(netdev->ip_addr))) ? RT_TRUE : RT_FALSE;
+}
+
+/* the lower key is preferred */
+static uint32_t netdev_policy_key(enum netdev_policy policy, struct netdev *netdev)
+{
+    uint32_t rate;
+
+    switch (policy)
+    {
+    case NETDEV_POLICY_LATENCY:
+        /* the unknown latency is tried after the known ones */
+        return netdev->stat.latency ? netdev->stat.latency : UINT32_MAX;
+
+    case NETDEV_POLICY_COST:
+        return netdev->stat.cost;
+
+    case NETDEV_POLICY_LOAD:
+        rate = (netdev->stat.tx_rate + netdev->stat.rx_rate) / 1024;
+        return ((rate > 0xFFFF ? 0xFFFF : rate) << 16) | netdev->stat.flows;
+
+    case NETDEV_POLICY_HASH:
+        return 0;
+
+    default:
+        return (netdev == netdev_default) ? 0 : 1;
+    }
+}
+
+/**
+ * This function will select the network interface device by the policy.
+ *
+ * @param policy the policy of selection
+ * @param hash the hash of flow, the flows of the same hash select the same one
+ * @param filter the filter of network interface devices, RT_NULL is all of them
+ * @param arg the argument of filter
+ *
+ * @return != NULL: the selected network interface device
+ *            NULL: no network interface device available
+ */
+struct netdev *netdev_policy_select(enum netdev_policy policy, uint32_t hash,
+                                    netdev_policy_filter_fn filter, void *arg)
+{
+    struct netdev *candidates[NETDEV_POLICY_CANDIDATES];
+    uint32_t keys[NETDEV_POLICY_CANDIDATES];
+    struct netdev *netdev = RT_NULL;
+    rt_slist_t *node = RT_NULL;
+    uint32_t min_key = UINT32_MAX;
+    int count = 0, ties = 0, index, tie;
+    rt_base_t level;
+
+    if (netdev_list == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    level = rt_hw_interrupt_disable();
+    for (node = &(netdev_list->list); node && count < NETDEV_POLICY_CANDIDATES; node = rt_slist_next(node))
+    {
+        netdev = rt_slist_entry(node, struct netdev, list);
+        if (netdev_policy_available(netdev))
+        {
+            candidates[count++] = netdev;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    /* filter the candidates and find the lowest key */
+    for (index = 0; index < count; index++)
+    {
+        if (filter && filter(candidates[index], arg) == RT_FALSE)
+        {
+            candidates[index] = RT_NULL;
+            continue;
+        }
+
+        keys[index] = netdev_policy_key(policy, candidates[index]);
+        if (ties == 0 || keys[index] < min_key)
+        {
+            min_key = keys[index];
+            ties = 1;
+        }
+        else if (keys[index] == min_key)
+        {
+            ties++;
+        }
+    }
+
+    if (ties == 0)
+    {
+        return RT_NULL;
+    }
+
+    /* the flows of same key are distributed by hash, or prefer the default one */
+    tie = (policy == NETDEV_POLICY_COST || policy == NETDEV_POLICY_HASH) ? (int)(hash % ties) : -1;
+    netdev = RT_NULL;
+    for (index = 0; index < count; index++)
+    {
+        if (candidates[index] == RT_NULL || keys[index] != min_key)
+        {
+            continue;
+        }
+
+        if (netdev == RT_NULL || candidates[index] == netdev_default)
+        {
+            netdev = candidates[index];
+        }
+        if (tie-- == 0)
+        {
+            netdev = candidates[index];
+            break;
+        }
+    }
+
+    return netdev;
+}
+
+/**
+ * This function will count the sockets using the network interface device.
+ *
+ * @param netdev the network interface device
+ * @param add RT_TRUE: a socket starts to use it, RT_FALSE: a socket stops using it
+ */
+void netdev_policy_flow(struct netdev *netdev, rt_bool_t add)
+{
+    rt_base_t level;
+
+    if (netdev == RT_NULL)
+    {
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    if (add)
+    {
+        netdev->stat.flows++;
+    }
+    else if (netdev->stat.flows > 0)
+    {
+        netdev->stat.flows--;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will count the bytes sent and received by sockets.
+ */
+void netdev_policy_traffic(struct netdev *netdev, uint32_t tx_bytes, uint32_t rx_bytes)
+{
+    rt_base_t level;
+
+    if (netdev == RT_NULL)
+    {
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    netdev->stat.tx_bytes += tx_bytes;
+    netdev->stat.rx_bytes += rx_bytes;
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will update the connect latency of network interface device.
+ *
+ * @param netdev the network interface device
+ * @param ticks the ticks of connecting
+ * @param success RT_TRUE: the connection is established
+ */
+void netdev_policy_connected(struct netdev *netdev, rt_tick_t ticks, rt_bool_t success)
+{
+    uint32_t latency;
+    rt_base_t level;
+
+    if (netdev == RT_NULL)
+    {
+        return;
+    }
+
+    latency = ticks * 1000 / RT_TICK_PER_SECOND;
+    if (latency == 0)
+    {
+        latency = 1;
+    }
+
+    level = rt_hw_interrupt_disable();
+    if (success)
+    {
+        /* smooth it as 7/8 of the last latency and 1/8 of the new one */
+        netdev->stat.latency = netdev->stat.latency ? (netdev->stat.latency * 7 + latency) / 8 : latency;
+        netdev->stat.connects++;
+    }
+    else
+    {
+        netdev->stat.connect_errors++;
+    }
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will count the new connections migrated to the network interface device.
+ */
+void netdev_policy_migrated(struct netdev *netdev)
+{
+    if (netdev)
+    {
+        netdev->stat.migrations++;
+        LOG_D("new connection migrated to network interface device(%s).", netdev->name);
+    }
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void netdev_policy_list(void)
+{
+    rt_slist_t *node = RT_NULL;
+    struct netdev *netdev = RT_NULL;
+
+    rt_kprintf("policy: %s\n", netdev_policy_name(netdev_global_policy));
+    rt_kprintf("netdev   avail cost flows tx(B/s)  rx(B/s)  tx bytes   rx bytes   latency connects errors migrated\n");
+    rt_kprintf("-------- ----- ---- ----- -------- -------- ---------- ---------- ------- -------- ------ --------\n");
+
+    if (netdev_list == RT_NULL)
+    {
+        return;
+    }
+
+    for (node = &(netdev_list->list); node; node = rt_slist_next(node))
+    {
+        netdev = rt_slist_entry(node, struct netdev, list);
+
+        rt_kprintf("%-8.*s %-5s %-4d %-5d %-8d %-8d %-10u %-10u %-7d %-8d %-6d %d\n",
+                   RT_NAME_MAX, netdev->name, netdev_policy_available(netdev) ? "yes" : "no",
+                   netdev->stat.cost, netdev->stat.flows, netdev->stat.tx_rate, netdev->stat.rx_rate,
+                   netdev->stat.tx_bytes, netdev->stat.rx_bytes, netdev->stat.latency,
+                   netdev->stat.connects, netdev->stat.connect_errors, netdev->stat.migrations);
+    }
+}
+
+int netdev_netpolicy(int argc, char **argv)
+{
+    struct netdev *netdev = RT_NULL;
+    int policy;
+
+    if (argc == 1)
+    {
+        netdev_policy_list();
+        return 0;
+    }
+
+    if (argc == 2)
+    {
+        for (policy = 0; policy < NETDEV_POLICY_MAX; policy++)
+        {
+            if (strcmp(argv[1], netdev_policy_names[policy]) == 0)
+            {
+                netdev_policy_set((enum netdev_policy) policy);
+                return 0;
+            }
+        }
+    }
+    else if (argc == 4 && strcmp(argv[1], "cost") == 0)
+    {
+        netdev = netdev_get_by_name(argv[2]);
+        if (netdev == RT_NULL)
+        {
+            rt_kprintf("bad network interface device name(%s).\n", argv[2]);
+            return -1;
+        }
+
+        netdev_set_cost(netdev, (uint16_t) atoi(argv[3]));
+        return 0;
+    }
+
+    rt_kprintf("Please input: netpolicy [default|latency|cost|load|hash]\n");
+    rt_kprintf("              netpolicy cost <netdev name> <cost>\n");
+    return -1;
+}
+FINSH_FUNCTION_EXPORT_ALIAS(netdev_netpolicy, __cmd_netpolicy, list and set the network interface selection policy);
+#endif /* RT_USING_FINSH */
+
+#endif /* NETDEV_USING_POLICY */
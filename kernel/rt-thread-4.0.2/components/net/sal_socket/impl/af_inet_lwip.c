@@ -6,6 +6,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-05-17     ChenYong     First version
+ * 2026-10-18     liujiahao    Add fast data path to netconn and raw API
+ * 2026-10-18     liujiahao    Add zero-copy network buffer by pbuf
+ * 2026-10-18     liujiahao    Add sendmsg/recvmsg and batched sendmmsg
  */
 
 #include <rtthread.h>
@@ -16,6 +19,18 @@
 #include <lwip/init.h>
 #include <lwip/netif.h>
 
+#if LWIP_VERSION >= 0x20100ff
+#include <lwip/priv/sockets_priv.h>
+#include <lwip/priv/tcpip_priv.h>
+#include <lwip/tcp.h>
+#include <lwip/udp.h>
+#include <sal_msg.h>
+#endif
+
+#if defined(SAL_USING_NETBUF) && (LWIP_VERSION >= 0x20100ff)
+#define SAL_LWIP_USING_NETBUF
+#endif
+
 #ifdef SAL_USING_POSIX
 #include <dfs_poll.h>
 #endif
@@ -43,9 +58,7 @@
 
 #ifdef SAL_USING_POSIX
 
-#if LWIP_VERSION >= 0x20100ff
-#include <lwip/priv/sockets_priv.h>
-#else /* LWIP_VERSION < 0x20100ff */
+#if LWIP_VERSION < 0x20100ff
 /*
  * Re-define lwip socket
  *
@@ -77,9 +90,7 @@ struct lwip_sock {
 
     rt_wqueue_t wait_head;
 };
-#endif /* LWIP_VERSION >= 0x20100ff */
-
-extern struct lwip_sock *lwip_tryget_socket(int s);
+#endif /* LWIP_VERSION < 0x20100ff */
 
 static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len)
 {
@@ -283,6 +294,219 @@ static int inet_poll(struct dfs_fd *file, struct rt_pollreq *req)
 }
 #endif
 
+#if LWIP_VERSION >= 0x20100ff
+static int inet_sockaddr_to_addr(const struct sockaddr *to, socklen_t tolen, ip_addr_t *addr, u16_t *port)
+{
+    if (to->sa_family == AF_INET && tolen >= sizeof(struct sockaddr_in))
+    {
+        const struct sockaddr_in *to_in = (const struct sockaddr_in *) to;
+
+        ip_addr_set_ip4_u32(addr, to_in->sin_addr.s_addr);
+        *port = lwip_ntohs(to_in->sin_port);
+        return 0;
+    }
+#if LWIP_IPV6
+    if (to->sa_family == AF_INET6 && tolen >= sizeof(struct sockaddr_in6))
+    {
+        const struct sockaddr_in6 *to_in6 = (const struct sockaddr_in6 *) to;
+
+        inet6_addr_to_ip6addr(ip_2_ip6(addr), &to_in6->sin6_addr);
+        IP_SET_TYPE_VAL(*addr, IPADDR_TYPE_V6);
+        *port = lwip_ntohs(to_in6->sin6_port);
+        return 0;
+    }
+#endif
+
+    return -1;
+}
+
+#if defined(SAL_USING_LWIP_FASTPATH) || defined(SAL_LWIP_USING_NETBUF)
+static void inet_addr_to_sockaddr(const ip_addr_t *addr, u16_t port, struct sockaddr *from, socklen_t *fromlen)
+{
+    if (from == RT_NULL || fromlen == RT_NULL)
+    {
+        return;
+    }
+
+#if LWIP_IPV6
+    if (IP_IS_V6(addr))
+    {
+        struct sockaddr_in6 from_in6;
+
+        rt_memset(&from_in6, 0x00, sizeof(from_in6));
+        from_in6.sin6_len = sizeof(from_in6);
+        from_in6.sin6_family = AF_INET6;
+        from_in6.sin6_port = lwip_htons(port);
+        inet6_addr_from_ip6addr(&from_in6.sin6_addr, ip_2_ip6(addr));
+        rt_memcpy(from, &from_in6, LWIP_MIN(*fromlen, sizeof(from_in6)));
+        *fromlen = sizeof(from_in6);
+        return;
+    }
+#endif
+    {
+        struct sockaddr_in from_in;
+
+        rt_memset(&from_in, 0x00, sizeof(from_in));
+        from_in.sin_len = sizeof(from_in);
+        from_in.sin_family = AF_INET;
+        from_in.sin_port = lwip_htons(port);
+        from_in.sin_addr.s_addr = ip4_addr_get_u32(ip_2_ip4(addr));
+        rt_memcpy(from, &from_in, LWIP_MIN(*fromlen, sizeof(from_in)));
+        *fromlen = sizeof(from_in);
+    }
+}
+#endif
+
+#if LWIP_UDP
+struct inet_sendmmsg_call
+{
+    struct tcpip_api_call_data call;
+    struct netconn *conn;
+    struct mmsghdr *msgvec;
+    unsigned int vlen;
+    unsigned int sent;
+};
+
+/* send the datagrams in tcpip thread, the data of iovecs is referenced by pbufs */
+static err_t inet_sendmmsg_udp(struct tcpip_api_call_data *call)
+{
+    struct inet_sendmmsg_call *msg = (struct inet_sendmmsg_call *) call;
+    struct udp_pcb *pcb = msg->conn->pcb.udp;
+    err_t err = ERR_OK;
+
+    if (pcb == RT_NULL)
+    {
+        return ERR_CONN;
+    }
+
+    for (; msg->sent < msg->vlen; msg->sent++)
+    {
+        struct msghdr *hdr = &(msg->msgvec[msg->sent].msg_hdr);
+        struct pbuf *p = RT_NULL, *q;
+        ip_addr_t addr;
+        u16_t port = 0;
+        size_t len = 0;
+        int index;
+
+        if (hdr->msg_name && inet_sockaddr_to_addr((const struct sockaddr *) hdr->msg_name,
+                                                   hdr->msg_namelen, &addr, &port) < 0)
+        {
+            err = ERR_VAL;
+            break;
+        }
+
+        for (index = 0; index < hdr->msg_iovlen && err == ERR_OK; index++)
+        {
+            if (hdr->msg_iov[index].iov_len == 0)
+            {
+                continue;
+            }
+
+            len += hdr->msg_iov[index].iov_len;
+            if (len > 0xFFFF)
+            {
+                err = ERR_VAL;
+                break;
+            }
+
+            q = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
+            if (q == RT_NULL)
+            {
+                err = ERR_MEM;
+                break;
+            }
+            q->payload = hdr->msg_iov[index].iov_base;
+            q->len = q->tot_len = (u16_t) hdr->msg_iov[index].iov_len;
+
+            if (p == RT_NULL)
+            {
+                p = q;
+            }
+            else
+            {
+                pbuf_cat(p, q);
+            }
+        }
+
+        /* the empty datagram */
+        if (err == ERR_OK && p == RT_NULL)
+        {
+            p = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_RAM);
+            err = (p == RT_NULL) ? ERR_MEM : ERR_OK;
+        }
+
+        if (err == ERR_OK)
+        {
+            err = hdr->msg_name ? udp_sendto(pcb, p, &addr, port) : udp_send(pcb, p);
+        }
+
+        if (p)
+        {
+            pbuf_free(p);
+        }
+
+        if (err != ERR_OK)
+        {
+            break;
+        }
+        msg->msgvec[msg->sent].msg_len = (unsigned int) len;
+    }
+
+    return err;
+}
+#endif /* LWIP_UDP */
+
+static int inet_sendmmsg(int socket, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    struct lwip_sock *sock = lwip_tryget_socket(socket);
+    unsigned int index;
+    ssize_t ret;
+
+    if (sock == RT_NULL)
+    {
+        set_errno(EBADF);
+        return -1;
+    }
+
+#if LWIP_UDP
+    /* the datagrams go to tcpip thread once */
+    if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_UDP && (flags & ~MSG_DONTWAIT) == 0)
+    {
+        struct inet_sendmmsg_call msg;
+        err_t err;
+
+        msg.conn = sock->conn;
+        msg.msgvec = msgvec;
+        msg.vlen = vlen;
+        msg.sent = 0;
+
+        err = tcpip_api_call(inet_sendmmsg_udp, &msg.call);
+        lwip_done_socket(sock);
+        if (msg.sent == 0 && err != ERR_OK)
+        {
+            set_errno(err_to_errno(err));
+            return -1;
+        }
+
+        return (int) msg.sent;
+    }
+#endif /* LWIP_UDP */
+    lwip_done_socket(sock);
+
+    for (index = 0; index < vlen; index++)
+    {
+        ret = lwip_sendmsg(socket, &(msgvec[index].msg_hdr), flags);
+        if (ret < 0)
+        {
+            break;
+        }
+        msgvec[index].msg_len = (unsigned int) ret;
+    }
+
+    return (index > 0) ? (int) index : -1;
+}
+#endif /* LWIP_VERSION >= 0x20100ff */
+
 static const struct sal_socket_ops lwip_socket_ops =
 {
     inet_socket,
@@ -303,7 +527,587 @@ static const struct sal_socket_ops lwip_socket_ops =
 #ifdef SAL_USING_POSIX
     inet_poll,
 #endif
+#if LWIP_VERSION >= 0x20100ff
+    (int (*)(int, const struct msghdr *, int))lwip_sendmsg,
+    (int (*)(int, struct msghdr *, int))lwip_recvmsg,
+    inet_sendmmsg,
+#endif
+};
+
+#ifdef SAL_USING_LWIP_FASTPATH
+/* the socket object of lwIP is looked up on every call, it is never cached */
+static int inet_fastpath_attach(int socket)
+{
+    struct lwip_sock *sock = lwip_tryget_socket(socket);
+    int type;
+
+    if (sock == RT_NULL)
+    {
+        return -1;
+    }
+    type = NETCONNTYPE_GROUP(netconn_type(sock->conn));
+    lwip_done_socket(sock);
+
+    return (type == NETCONN_TCP || type == NETCONN_UDP) ? 0 : -1;
+}
+
+#if LWIP_TCPIP_CORE_LOCKING
+/* write the TCP data by raw API, it doesn't wait for the send buffer */
+static err_t inet_fastpath_tcp_write(struct netconn *conn, const void *data, size_t size, int flags)
+{
+    struct tcp_pcb *pcb;
+    err_t err = ERR_WOULDBLOCK;
+
+    LOCK_TCPIP_CORE();
+    pcb = conn->pcb.tcp;
+    /* keep the order with the blocked writing of other threads */
+    if (pcb != RT_NULL && conn->state == NETCONN_NONE && conn->current_msg == RT_NULL &&
+        (pcb->state == ESTABLISHED || pcb->state == CLOSE_WAIT) &&
+        size <= tcp_sndbuf(pcb))
+    {
+        err = tcp_write(pcb, data, (u16_t) size, TCP_WRITE_FLAG_COPY |
+                        ((flags & MSG_MORE) ? TCP_WRITE_FLAG_MORE : 0));
+        if (err == ERR_OK)
+        {
+            if (!(flags & MSG_MORE))
+            {
+                tcp_output(pcb);
+            }
+
+            /* the same as lwip_netconn_do_writemore(), the sent callback signals
+             * the free space */
+            if ((tcp_sndbuf(pcb) <= TCP_SNDLOWAT) || (tcp_sndqueuelen(pcb) >= TCP_SNDQUEUELOWAT))
+            {
+                netconn_set_flags(conn, NETCONN_FLAG_CHECK_WRITESPACE);
+                if (conn->callback)
+                {
+                    conn->callback(conn, NETCONN_EVT_SENDMINUS, 0);
+                }
+            }
+        }
+    }
+    UNLOCK_TCPIP_CORE();
+
+    return err;
+}
+
+/* send the UDP datagram by raw API, the data is referenced by pbuf without copy */
+static err_t inet_fastpath_udp_send(struct netconn *conn, const void *data, size_t size,
+                                    const ip_addr_t *addr, u16_t port)
+{
+    struct udp_pcb *pcb;
+    struct pbuf *p;
+    err_t err;
+
+    p = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
+    if (p == RT_NULL)
+    {
+        return ERR_MEM;
+    }
+    p->payload = (void *) data;
+    p->len = p->tot_len = (u16_t) size;
+
+    LOCK_TCPIP_CORE();
+    pcb = conn->pcb.udp;
+    if (pcb == RT_NULL)
+    {
+        err = ERR_CLSD;
+    }
+    else if (addr)
+    {
+        err = udp_sendto(pcb, p, addr, port);
+    }
+    else if (pcb->flags & UDP_FLAGS_CONNECTED)
+    {
+        err = udp_send(pcb, p);
+    }
+    else
+    {
+        err = ERR_CONN;
+    }
+    UNLOCK_TCPIP_CORE();
+
+    pbuf_free(p);
+
+    return err;
+}
+
+static int inet_fastpath_send(struct lwip_sock *sock, const void *data, size_t size, int flags,
+                              const struct sockaddr *to, socklen_t tolen)
+{
+    struct netconn *conn = sock->conn;
+    ip_addr_t addr;
+    u16_t port = 0;
+    err_t err;
+
+    if ((flags & ~(MSG_DONTWAIT | MSG_MORE)) != 0 || size == 0 || size > 0xFFFF)
+    {
+        return lwip_sendto(conn->socket, data, size, flags, to, tolen);
+    }
+
+    if (NETCONNTYPE_GROUP(netconn_type(conn)) == NETCONN_TCP)
+    {
+        /* the data which doesn't fit in the send buffer goes the blocking way */
+        if (inet_fastpath_tcp_write(conn, data, size, flags) == ERR_OK)
+        {
+            return (int) size;
+        }
+    }
+    else if (NETCONNTYPE_GROUP(netconn_type(conn)) == NETCONN_UDP &&
+             (to == RT_NULL || inet_sockaddr_to_addr(to, tolen, &addr, &port) == 0))
+    {
+        err = inet_fastpath_udp_send(conn, data, size, to ? &addr : RT_NULL, port);
+        if (err != ERR_OK)
+        {
+            set_errno(err_to_errno(err));
+            return -1;
+        }
+        return (int) size;
+    }
+
+    return lwip_sendto(conn->socket, data, size, flags, to, tolen);
+}
+#else
+#define inet_fastpath_send(sock, data, size, flags, to, tolen) \
+    lwip_sendto((sock)->conn->socket, data, size, flags, to, tolen)
+#endif /* LWIP_TCPIP_CORE_LOCKING */
+
+static int inet_fastpath_sendto(int socket, const void *data, size_t size, int flags,
+                                const struct sockaddr *to, socklen_t tolen)
+{
+    struct lwip_sock *sock = lwip_tryget_socket(socket);
+    int ret;
+
+    if (sock == RT_NULL)
+    {
+        set_errno(EBADF);
+        return -1;
+    }
+    /* the socket is held until the data path returns, the same as lwIP socket API */
+    ret = inet_fastpath_send(sock, data, size, flags, to, tolen);
+    lwip_done_socket(sock);
+
+    return ret;
+}
+
+/* receive the TCP data from pbuf, the left data is kept for the next reading */
+static int inet_fastpath_recv_tcp(struct lwip_sock *sock, void *mem, size_t len, u8_t apiflags)
+{
+    struct netconn *conn = sock->conn;
+    struct pbuf *p;
+    u16_t copied;
+    err_t err;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    p = sock->lastdata.pbuf;
+    sock->lastdata.pbuf = RT_NULL;
+    SYS_ARCH_UNPROTECT(lev);
+
+    if (p == RT_NULL)
+    {
+        /* the receive window is updated by the copied length */
+        err = netconn_recv_tcp_pbuf_flags(conn, &p, apiflags | NETCONN_NOAUTORCVD);
+        if (err != ERR_OK)
+        {
+            if (err == ERR_CLSD)
+            {
+                return 0;
+            }
+            set_errno(err_to_errno(err));
+            return -1;
+        }
+    }
+
+    copied = pbuf_copy_partial(p, mem, (u16_t) LWIP_MIN(len, p->tot_len), 0);
+    if (copied < p->tot_len)
+    {
+        p = pbuf_free_header(p, copied);
+
+        SYS_ARCH_PROTECT(lev);
+        sock->lastdata.pbuf = p;
+        SYS_ARCH_UNPROTECT(lev);
+    }
+    else
+    {
+        pbuf_free(p);
+    }
+    netconn_tcp_recvd(conn, copied);
+
+    return copied;
+}
+
+/* receive the UDP datagram from netbuf, the part exceeding the buffer is discarded */
+static int inet_fastpath_recv_udp(struct lwip_sock *sock, void *mem, size_t len, u8_t apiflags,
+                                  struct sockaddr *from, socklen_t *fromlen)
+{
+    struct netbuf *nbuf;
+    u16_t copied;
+    err_t err;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    nbuf = sock->lastdata.netbuf;
+    sock->lastdata.netbuf = RT_NULL;
+    SYS_ARCH_UNPROTECT(lev);
+
+    if (nbuf == RT_NULL)
+    {
+        err = netconn_recv_udp_raw_netbuf_flags(sock->conn, &nbuf, apiflags);
+        if (err != ERR_OK)
+        {
+            set_errno(err_to_errno(err));
+            return -1;
+        }
+    }
+
+    copied = pbuf_copy_partial(nbuf->p, mem, (u16_t) LWIP_MIN(len, nbuf->p->tot_len), 0);
+    inet_addr_to_sockaddr(netbuf_fromaddr(nbuf), netbuf_fromport(nbuf), from, fromlen);
+    netbuf_delete(nbuf);
+
+    return copied;
+}
+
+static int inet_fastpath_recvfrom(int socket, void *mem, size_t len, int flags,
+                                  struct sockaddr *from, socklen_t *fromlen)
+{
+    struct lwip_sock *sock = lwip_tryget_socket(socket);
+    u8_t apiflags = 0;
+    int ret;
+
+    if (sock == RT_NULL)
+    {
+        set_errno(EBADF);
+        return -1;
+    }
+
+    if ((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn))
+    {
+        apiflags = NETCONN_DONTBLOCK;
+    }
+
+    /* peeking and the peer address of TCP go the way of lwIP socket API */
+    if ((flags & ~MSG_DONTWAIT) != 0 || len == 0 || len > 0xFFFF)
+    {
+        ret = lwip_recvfrom(socket, mem, len, flags, from, fromlen);
+    }
+    else if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP && from == RT_NULL)
+    {
+        ret = inet_fastpath_recv_tcp(sock, mem, len, apiflags);
+    }
+    else if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_UDP)
+    {
+        ret = inet_fastpath_recv_udp(sock, mem, len, apiflags, from, fromlen);
+    }
+    else
+    {
+        ret = lwip_recvfrom(socket, mem, len, flags, from, fromlen);
+    }
+    lwip_done_socket(sock);
+
+    return ret;
+}
+
+static const struct sal_fastpath_ops lwip_fastpath_ops =
+{
+    inet_fastpath_attach,
+    inet_fastpath_sendto,
+    inet_fastpath_recvfrom,
+};
+#endif /* SAL_USING_LWIP_FASTPATH */
+
+#ifdef SAL_LWIP_USING_NETBUF
+static void inet_netbuf_set(struct sal_netbuf *buf, struct pbuf *p)
+{
+    buf->user_data = p;
+    buf->segment = p;
+    buf->payload = p->payload;
+    buf->len = p->len;
+    buf->tot_len = p->tot_len;
+}
+
+static int inet_netbuf_alloc(int socket, struct sal_netbuf *buf, size_t size)
+{
+    struct lwip_sock *sock;
+    struct pbuf *p;
+    int type;
+
+    if (size > 0xFFFF)
+    {
+        set_errno(EINVAL);
+        return -1;
+    }
+
+    sock = lwip_tryget_socket(socket);
+    if (sock == RT_NULL)
+    {
+        set_errno(EBADF);
+        return -1;
+    }
+    type = NETCONNTYPE_GROUP(netconn_type(sock->conn));
+    lwip_done_socket(sock);
+
+    /* the room of headers is reserved before the datagram, it is sent without copy */
+    p = pbuf_alloc(type == NETCONN_TCP ? PBUF_RAW : PBUF_TRANSPORT, (u16_t) size, PBUF_RAM);
+    if (p == RT_NULL)
+    {
+        set_errno(ENOMEM);
+        return -1;
+    }
+
+    inet_netbuf_set(buf, p);
+
+    return 0;
+}
+
+/*
+ * The TCP data is copied to the segments by NETCONN_COPY, the pbuf is released
+ * after the send while the segments are kept until acknowledged. Only the UDP
+ * datagram is sent without copy.
+ */
+static int inet_netbuf_write(struct netconn *conn, struct pbuf *p, size_t size, int flags)
+{
+    size_t written = 0, bytes, len;
+    u8_t apiflags = NETCONN_COPY;
+    err_t err = ERR_OK;
+
+    if (flags & MSG_DONTWAIT)
+    {
+        apiflags |= NETCONN_DONTBLOCK;
+    }
+
+    for (; p != RT_NULL && written < size; p = p->next)
+    {
+        len = LWIP_MIN(p->len, size - written);
+        bytes = 0;
+        err = netconn_write_partly(conn, p->payload, len,
+                                   apiflags | ((written + len < size || (flags & MSG_MORE)) ? NETCONN_MORE : 0),
+                                   &bytes);
+        written += bytes;
+        if (err != ERR_OK || bytes < len)
+        {
+            break;
+        }
+    }
+
+    if (written == 0 && err != ERR_OK)
+    {
+        set_errno(err_to_errno(err));
+        return -1;
+    }
+
+    return (int) written;
+}
+
+static int inet_netbuf_send(struct netconn *conn, struct pbuf *p, size_t size, int flags,
+                            const struct sockaddr *to, socklen_t tolen)
+{
+    struct netbuf nbuf;
+    ip_addr_t addr;
+    u16_t port = 0;
+    err_t err;
+
+    if (NETCONNTYPE_GROUP(netconn_type(conn)) == NETCONN_TCP)
+    {
+        return inet_netbuf_write(conn, p, size, flags);
+    }
+
+    if (to && inet_sockaddr_to_addr(to, tolen, &addr, &port) < 0)
+    {
+        set_errno(EAFNOSUPPORT);
+        return -1;
+    }
+
+    /* the datagram is the pbuf itself */
+    pbuf_realloc(p, (u16_t) size);
+    rt_memset(&nbuf, 0x00, sizeof(nbuf));
+    nbuf.p = nbuf.ptr = p;
+
+    if (to)
+    {
+        err = netconn_sendto(conn, &nbuf, &addr, port);
+    }
+    else
+    {
+        err = netconn_send(conn, &nbuf);
+    }
+
+    if (err != ERR_OK)
+    {
+        set_errno(err_to_errno(err));
+        return -1;
+    }
+
+    return (int) size;
+}
+
+static int inet_netbuf_sendto(int socket, struct sal_netbuf *buf, size_t size, int flags,
+                              const struct sockaddr *to, socklen_t tolen)
+{
+    struct lwip_sock *sock = lwip_tryget_socket(socket);
+    int ret;
+
+    if (sock == RT_NULL)
+    {
+        set_errno(EBADF);
+        return -1;
+    }
+    /* the socket is held until the buffer is sent */
+    ret = inet_netbuf_send(sock->conn, (struct pbuf *) buf->user_data, size, flags, to, tolen);
+    lwip_done_socket(sock);
+
+    return ret;
+}
+
+/* the received data is taken out of the lwIP socket without copy */
+static err_t inet_netbuf_take(struct lwip_sock *sock, u8_t apiflags, struct pbuf **pbuf,
+                              struct sockaddr *from, socklen_t *fromlen)
+{
+    struct netconn *conn = sock->conn;
+    struct pbuf *p = RT_NULL;
+    err_t err;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    if (NETCONNTYPE_GROUP(netconn_type(conn)) == NETCONN_TCP)
+    {
+        /* the data left by the last recv() goes first, it's checked by select and poll */
+        SYS_ARCH_PROTECT(lev);
+        p = sock->lastdata.pbuf;
+        sock->lastdata.pbuf = RT_NULL;
+        SYS_ARCH_UNPROTECT(lev);
+
+        if (p)
+        {
+            netconn_tcp_recvd(conn, p->tot_len);
+        }
+        else
+        {
+            /* the receive window is updated when the pbuf is taken */
+            err = netconn_recv_tcp_pbuf_flags(conn, &p, apiflags);
+            if (err != ERR_OK)
+            {
+                return err;
+            }
+        }
+
+        if (from && fromlen)
+        {
+            ip_addr_t addr;
+            u16_t port;
+
+            if (netconn_peer(conn, &addr, &port) == ERR_OK)
+            {
+                inet_addr_to_sockaddr(&addr, port, from, fromlen);
+            }
+        }
+    }
+    else
+    {
+        struct netbuf *nbuf;
+
+        SYS_ARCH_PROTECT(lev);
+        nbuf = sock->lastdata.netbuf;
+        sock->lastdata.netbuf = RT_NULL;
+        SYS_ARCH_UNPROTECT(lev);
+
+        if (nbuf == RT_NULL)
+        {
+            err = netconn_recv_udp_raw_netbuf_flags(conn, &nbuf, apiflags);
+            if (err != ERR_OK)
+            {
+                return err;
+            }
+        }
+
+        inet_addr_to_sockaddr(netbuf_fromaddr(nbuf), netbuf_fromport(nbuf), from, fromlen);
+
+        /* take the pbuf out of netbuf */
+        p = nbuf->p;
+        nbuf->p = nbuf->ptr = RT_NULL;
+        netbuf_delete(nbuf);
+    }
+
+    *pbuf = p;
+
+    return ERR_OK;
+}
+
+static int inet_netbuf_recvfrom(int socket, struct sal_netbuf *buf, int flags,
+                                struct sockaddr *from, socklen_t *fromlen)
+{
+    struct lwip_sock *sock;
+    struct pbuf *p = RT_NULL;
+    u8_t apiflags = 0;
+    err_t err;
+
+    /* the buffer is handed over to the application, it can't be peeked */
+    if (flags & MSG_PEEK)
+    {
+        set_errno(EOPNOTSUPP);
+        return -1;
+    }
+
+    sock = lwip_tryget_socket(socket);
+    if (sock == RT_NULL)
+    {
+        set_errno(EBADF);
+        return -1;
+    }
+
+    if ((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn))
+    {
+        apiflags |= NETCONN_DONTBLOCK;
+    }
+
+    err = inet_netbuf_take(sock, apiflags, &p, from, fromlen);
+    lwip_done_socket(sock);
+
+    if (err != ERR_OK)
+    {
+        set_errno(err_to_errno(err));
+        return err == ERR_CLSD ? 0 : -1;
+    }
+
+    inet_netbuf_set(buf, p);
+
+    return (int) p->tot_len;
+}
+
+static int inet_netbuf_next(struct sal_netbuf *buf)
+{
+    struct pbuf *p = (struct pbuf *) buf->segment;
+
+    if (p == RT_NULL || p->next == RT_NULL)
+    {
+        return -1;
+    }
+
+    p = p->next;
+    buf->segment = p;
+    buf->payload = p->payload;
+    buf->len = p->len;
+
+    return 0;
+}
+
+static void inet_netbuf_free(struct sal_netbuf *buf)
+{
+    if (buf->user_data)
+    {
+        pbuf_free((struct pbuf *) buf->user_data);
+        buf->user_data = RT_NULL;
+    }
+}
+
+static const struct sal_netbuf_ops lwip_netbuf_ops =
+{
+    inet_netbuf_alloc,
+    inet_netbuf_sendto,
+    inet_netbuf_recvfrom,
+    inet_netbuf_next,
+    inet_netbuf_free,
 };
+#endif /* SAL_LWIP_USING_NETBUF */
 
 static const struct sal_netdb_ops lwip_netdb_ops =
 {
@@ -323,6 +1127,16 @@ static const struct sal_proto_family lwip_inet_family =
 #endif 
     &lwip_socket_ops,
     &lwip_netdb_ops,
+#ifdef SAL_USING_LWIP_FASTPATH
+    &lwip_fastpath_ops,
+#endif
+#ifdef SAL_USING_NETBUF
+#ifdef SAL_LWIP_USING_NETBUF
+    &lwip_netbuf_ops,
+#else
+    RT_NULL,
+#endif
+#endif
 };
 
 /* Set lwIP network interface device protocol family information */
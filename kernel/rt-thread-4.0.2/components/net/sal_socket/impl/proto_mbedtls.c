@@ -6,6 +6,8 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-11-12     ChenYong     First version
+ * 2026-10-18     liujiahao    Add session resumption cache and shared configuration
+ * 2026-10-18     liujiahao    Use the session without the configuration of MbedTLSSession
  */
 
 #include <rtthread.h>
@@ -22,6 +24,10 @@
 
 #include <netdev.h>
 
+#define DBG_TAG              "sal.tls"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
 #ifdef SAL_USING_TLS
 
 #if !defined(MBEDTLS_CONFIG_FILE)
@@ -37,43 +43,327 @@
 #define SAL_MEBDTLS_BUFFER_LEN         1024
 #endif
 
-static void *mebdtls_socket(int socket)
+/* the number of sessions cached for resumption, 0 is no session resumption */
+#ifndef SAL_MBEDTLS_SESSION_CACHE_NUM
+#define SAL_MBEDTLS_SESSION_CACHE_NUM  4
+#endif
+
+/* the number of closed sessions kept with their I/O buffers for the next sockets */
+#ifndef SAL_MBEDTLS_POOL_NUM
+#define SAL_MBEDTLS_POOL_NUM           1
+#endif
+
+/* the maximum fragment length requested to the server, 0 is the default of 16384 bytes */
+#ifndef SAL_MBEDTLS_MAX_FRAG_LEN
+#define SAL_MBEDTLS_MAX_FRAG_LEN       0
+#endif
+
+#if SAL_MBEDTLS_MAX_FRAG_LEN == 0
+#elif SAL_MBEDTLS_MAX_FRAG_LEN <= 512
+#define SAL_MBEDTLS_MFL_CODE           MBEDTLS_SSL_MAX_FRAG_LEN_512
+#elif SAL_MBEDTLS_MAX_FRAG_LEN <= 1024
+#define SAL_MBEDTLS_MFL_CODE           MBEDTLS_SSL_MAX_FRAG_LEN_1024
+#elif SAL_MBEDTLS_MAX_FRAG_LEN <= 2048
+#define SAL_MBEDTLS_MFL_CODE           MBEDTLS_SSL_MAX_FRAG_LEN_2048
+#else
+#define SAL_MBEDTLS_MFL_CODE           MBEDTLS_SSL_MAX_FRAG_LEN_4096
+#endif
+
+/* the TLS session with the peer address, the configuration is shared by all sessions */
+struct sal_mbedtls_session
+{
+    unsigned char *buffer;
+    size_t buffer_len;
+    mbedtls_ssl_context ssl;
+    mbedtls_net_context server_fd;
+
+    uint32_t peer_addr;                 /* network byte order, 0 is unknown */
+    uint16_t peer_port;
+    struct sal_mbedtls_session *next;   /* the next in the pool */
+};
+
+struct sal_mbedtls_cache_entry
+{
+    uint32_t peer_addr;
+    uint16_t peer_port;
+    rt_tick_t tick;                     /* the last used tick, 0 is empty */
+    mbedtls_ssl_session session;
+};
+
+struct sal_mbedtls_stat
+{
+    rt_uint32_t handshakes;
+    rt_uint32_t resumed;
+    rt_uint32_t failed;
+    rt_uint32_t total_ms;
+    rt_uint32_t max_ms;
+    rt_uint32_t pool_hits;
+};
+
+/* the configuration, CA chain and random generator shared by all sessions */
+static struct
+{
+    mbedtls_ssl_config conf;
+    mbedtls_x509_crt cacert;
+    mbedtls_ctr_drbg_context ctr_drbg;
+    mbedtls_entropy_context entropy;
+    rt_bool_t ready;
+} mbedtls_shared;
+
+static struct rt_mutex mbedtls_lock;
+static struct rt_mutex mbedtls_rng_lock;
+static struct sal_mbedtls_session *mbedtls_pool;
+static int mbedtls_pool_num;
+static struct sal_mbedtls_stat mbedtls_stat;
+#if SAL_MBEDTLS_SESSION_CACHE_NUM > 0
+static struct sal_mbedtls_cache_entry mbedtls_cache[SAL_MBEDTLS_SESSION_CACHE_NUM];
+#endif
+
+/* the random generator is shared by the handshakes of threads */
+static int mbedtls_shared_random(void *p_rng, unsigned char *output, size_t output_len)
+{
+    int ret;
+
+    rt_mutex_take(&mbedtls_rng_lock, RT_WAITING_FOREVER);
+    ret = mbedtls_ctr_drbg_random(p_rng, output, output_len);
+    rt_mutex_release(&mbedtls_rng_lock);
+
+    return ret;
+}
+
+/* initialize the shared objects once, it is called with mbedtls_lock */
+static int mbedtls_shared_init(void)
 {
-    MbedTLSSession *session = RT_NULL;
     char *pers = "mbedtls";
+    int ret;
+
+    if (mbedtls_shared.ready)
+    {
+        return RT_EOK;
+    }
+
+    mbedtls_ssl_config_init(&mbedtls_shared.conf);
+    mbedtls_x509_crt_init(&mbedtls_shared.cacert);
+    mbedtls_ctr_drbg_init(&mbedtls_shared.ctr_drbg);
+    mbedtls_entropy_init(&mbedtls_shared.entropy);
+
+    ret = mbedtls_ctr_drbg_seed(&mbedtls_shared.ctr_drbg, mbedtls_entropy_func, &mbedtls_shared.entropy,
+                                (const unsigned char *) pers, rt_strlen(pers));
+    if (ret != 0)
+    {
+        LOG_E("seed the random generator failed (-0x%x).", -ret);
+        goto __exit;
+    }
+
+    ret = mbedtls_x509_crt_parse(&mbedtls_shared.cacert, (const unsigned char *) mbedtls_root_certificate,
+                                 mbedtls_root_certificate_len);
+    if (ret < 0)
+    {
+        LOG_E("parse the root certificates failed (-0x%x).", -ret);
+        goto __exit;
+    }
+
+    ret = mbedtls_ssl_config_defaults(&mbedtls_shared.conf, MBEDTLS_SSL_IS_CLIENT,
+                                      MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret != 0)
+    {
+        LOG_E("set the configuration defaults failed (-0x%x).", -ret);
+        goto __exit;
+    }
+
+    mbedtls_ssl_conf_authmode(&mbedtls_shared.conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
+    mbedtls_ssl_conf_ca_chain(&mbedtls_shared.conf, &mbedtls_shared.cacert, RT_NULL);
+    mbedtls_ssl_conf_rng(&mbedtls_shared.conf, mbedtls_shared_random, &mbedtls_shared.ctr_drbg);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&mbedtls_shared.conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH) && defined(SAL_MBEDTLS_MFL_CODE)
+    mbedtls_ssl_conf_max_frag_len(&mbedtls_shared.conf, SAL_MBEDTLS_MFL_CODE);
+#endif
+
+    mbedtls_shared.ready = RT_TRUE;
+
+    return RT_EOK;
+
+__exit:
+    mbedtls_ssl_config_free(&mbedtls_shared.conf);
+    mbedtls_x509_crt_free(&mbedtls_shared.cacert);
+    mbedtls_ctr_drbg_free(&mbedtls_shared.ctr_drbg);
+    mbedtls_entropy_free(&mbedtls_shared.entropy);
+
+    return -RT_ERROR;
+}
+
+static void mbedtls_session_free(struct sal_mbedtls_session *session)
+{
+    mbedtls_ssl_free(&session->ssl);
+    tls_free(session->buffer);
+    tls_free(session);
+}
+
+#if SAL_MBEDTLS_SESSION_CACHE_NUM > 0
+/* find the cached session of the peer, it is called with mbedtls_lock */
+static struct sal_mbedtls_cache_entry *mbedtls_cache_find(uint32_t addr, uint16_t port)
+{
+    int index;
+
+    for (index = 0; index < SAL_MBEDTLS_SESSION_CACHE_NUM; index++)
+    {
+        if (mbedtls_cache[index].tick && mbedtls_cache[index].peer_addr == addr &&
+                mbedtls_cache[index].peer_port == port)
+        {
+            return &mbedtls_cache[index];
+        }
+    }
+
+    return RT_NULL;
+}
+
+static void mbedtls_cache_remove(uint32_t addr, uint16_t port)
+{
+    struct sal_mbedtls_cache_entry *entry;
+
+    rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+    entry = mbedtls_cache_find(addr, port);
+    if (entry)
+    {
+        mbedtls_ssl_session_free(&entry->session);
+        entry->tick = 0;
+    }
+    rt_mutex_release(&mbedtls_lock);
+}
+
+/* set the cached session of the peer to resume, return RT_TRUE if it is set */
+static rt_bool_t mbedtls_cache_load(struct sal_mbedtls_session *session)
+{
+    struct sal_mbedtls_cache_entry *entry;
+    rt_bool_t loaded = RT_FALSE;
+
+    rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+    entry = mbedtls_cache_find(session->peer_addr, session->peer_port);
+    if (entry && mbedtls_ssl_set_session(&session->ssl, &entry->session) == 0)
+    {
+        entry->tick = rt_tick_get() ? rt_tick_get() : 1;
+        loaded = RT_TRUE;
+    }
+    rt_mutex_release(&mbedtls_lock);
+
+    return loaded;
+}
+
+/* save the negotiated session of the peer, the least recently used one is replaced */
+static void mbedtls_cache_save(struct sal_mbedtls_session *session)
+{
+    struct sal_mbedtls_cache_entry *entry;
+    int index;
+
+    rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+    entry = mbedtls_cache_find(session->peer_addr, session->peer_port);
+    if (entry == RT_NULL)
+    {
+        entry = &mbedtls_cache[0];
+        for (index = 1; index < SAL_MBEDTLS_SESSION_CACHE_NUM && entry->tick; index++)
+        {
+            if (mbedtls_cache[index].tick == 0 ||
+                    (rt_int32_t)(mbedtls_cache[index].tick - entry->tick) < 0)
+            {
+                entry = &mbedtls_cache[index];
+            }
+        }
+    }
+
+    mbedtls_ssl_session_free(&entry->session);
+    mbedtls_ssl_session_init(&entry->session);
+    if (mbedtls_ssl_get_session(&session->ssl, &entry->session) == 0)
+    {
+        entry->peer_addr = session->peer_addr;
+        entry->peer_port = session->peer_port;
+        entry->tick = rt_tick_get() ? rt_tick_get() : 1;
+    }
+    else
+    {
+        mbedtls_ssl_session_free(&entry->session);
+        entry->tick = 0;
+    }
+    rt_mutex_release(&mbedtls_lock);
+}
+#endif /* SAL_MBEDTLS_SESSION_CACHE_NUM > 0 */
+
+static void *mebdtls_socket(int socket)
+{
+    struct sal_mbedtls_session *session = RT_NULL;
 
     if (socket < 0)
     {
         return RT_NULL;
     }
 
-    session = (MbedTLSSession *) tls_calloc(1, sizeof(MbedTLSSession));
-    if (session == RT_NULL)
+    rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+    if (mbedtls_shared_init() != RT_EOK)
     {
+        rt_mutex_release(&mbedtls_lock);
         return RT_NULL;
     }
 
-    session->buffer_len = SAL_MEBDTLS_BUFFER_LEN;
-    session->buffer = tls_calloc(1, session->buffer_len);
-    if (session->buffer == RT_NULL)
+    /* the pooled session keeps the I/O buffers of the closed socket */
+    if (mbedtls_pool)
     {
-        tls_free(session);
-        session = RT_NULL;
-        
-        return RT_NULL;
+        session = mbedtls_pool;
+        mbedtls_pool = session->next;
+        mbedtls_pool_num--;
+        mbedtls_stat.pool_hits++;
     }
+    rt_mutex_release(&mbedtls_lock);
 
-    /* initialize TLS Client sesison */
-    if (mbedtls_client_init(session, (void *) pers, rt_strlen(pers)) != RT_EOK)
+    if (session == RT_NULL)
     {
-        mbedtls_client_close(session);
-        return RT_NULL;
-    }  
+        session = (struct sal_mbedtls_session *) tls_calloc(1, sizeof(struct sal_mbedtls_session));
+        if (session == RT_NULL)
+        {
+            return RT_NULL;
+        }
+
+        session->buffer_len = SAL_MEBDTLS_BUFFER_LEN;
+        session->buffer = tls_calloc(1, session->buffer_len);
+        if (session->buffer == RT_NULL)
+        {
+            tls_free(session);
+            return RT_NULL;
+        }
+
+        /* initialize TLS Client sesison with the shared configuration */
+        mbedtls_ssl_init(&session->ssl);
+        if (mbedtls_ssl_setup(&session->ssl, &mbedtls_shared.conf) != 0)
+        {
+            mbedtls_session_free(session);
+            return RT_NULL;
+        }
+    }
+
+    session->next = RT_NULL;
+    session->peer_addr = 0;
+    session->peer_port = 0;
     session->server_fd.fd = socket;
 
     return (void *)session;
 }
 
+static int mbedtls_set_peer(void *sock, const struct sockaddr *name, uint32_t namelen)
+{
+    struct sal_mbedtls_session *session = (struct sal_mbedtls_session *) sock;
+    const struct sockaddr_in *sin = (const struct sockaddr_in *) name;
+
+    if (name == RT_NULL || namelen < sizeof(struct sockaddr_in) || name->sa_family != AF_INET)
+    {
+        return -1;
+    }
+
+    session->peer_addr = sin->sin_addr.s_addr;
+    session->peer_port = sin->sin_port;
+
+    return 0;
+}
+
 int mbedtls_net_send_cb(void *ctx, const unsigned char *buf, size_t len)
 {
     struct sal_socket *sock;
@@ -148,25 +438,68 @@ int mbedtls_net_recv_cb( void *ctx, unsigned char *buf, size_t len)
     return ret;
 }
 
+static int mbedtls_send(void *sock, const void *data, size_t size)
+{
+    struct sal_mbedtls_session *session = (struct sal_mbedtls_session *) sock;
+    int ret;
+
+    if (session == RT_NULL || data == RT_NULL)
+    {
+        return -RT_ERROR;
+    }
+
+    ret = mbedtls_ssl_write(&session->ssl, (const unsigned char *) data, size);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+    {
+        LOG_E("socket (%d) write failed (-0x%x).", session->server_fd.fd, -ret);
+    }
+
+    return ret;
+}
+
+static int mbedtls_recv(void *sock, void *mem, size_t len)
+{
+    struct sal_mbedtls_session *session = (struct sal_mbedtls_session *) sock;
+    int ret;
+
+    if (session == RT_NULL || mem == RT_NULL)
+    {
+        return -RT_ERROR;
+    }
+
+    ret = mbedtls_ssl_read(&session->ssl, (unsigned char *) mem, len);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
+    {
+        LOG_E("socket (%d) read failed (-0x%x).", session->server_fd.fd, -ret);
+    }
+
+    return ret;
+}
+
 static int mbedtls_connect(void *sock)
 {
-    MbedTLSSession *session = RT_NULL;
+    struct sal_mbedtls_session *session = RT_NULL;
+    rt_bool_t resuming = RT_FALSE, resumed = RT_FALSE;
+    rt_tick_t tick;
+    rt_uint32_t ms;
     int ret = 0;
 
     RT_ASSERT(sock);
 
-    session = (MbedTLSSession *) sock;
+    session = (struct sal_mbedtls_session *) sock;
 
-    /* Set the SSL Configure infromation */
-    ret = mbedtls_client_context(session);
-    if (ret < 0)
+#if SAL_MBEDTLS_SESSION_CACHE_NUM > 0
+    /* offer the cached session of the peer to skip the full handshake */
+    if (session->peer_addr)
     {
-        goto __exit;
+        resuming = mbedtls_cache_load(session);
     }
+#endif
 
     /* Set the underlying BIO callbacks for write, read and read-with-timeout.  */
     mbedtls_ssl_set_bio(&session->ssl, &session->server_fd, mbedtls_net_send_cb, mbedtls_net_recv_cb, RT_NULL);
 
+    tick = rt_tick_get();
     while ((ret = mbedtls_ssl_handshake(&session->ssl)) != 0)
     {
         if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
@@ -174,6 +507,7 @@ static int mbedtls_connect(void *sock)
             goto __exit;
         }
     }
+    ms = (rt_tick_get() - tick) * 1000 / RT_TICK_PER_SECOND;
 
     /* Return the result of the certificate verification */
     ret = mbedtls_ssl_get_verify_result(&session->ssl);
@@ -183,20 +517,64 @@ static int mbedtls_connect(void *sock)
         mbedtls_x509_crt_verify_info((char *)session->buffer, session->buffer_len, "  ! ", ret);
         goto __exit;
     }
-    
+
+#if SAL_MBEDTLS_SESSION_CACHE_NUM > 0
+    if (session->peer_addr)
+    {
+        struct sal_mbedtls_cache_entry *entry;
+
+        /* the server accepting the session returns the same session ID */
+        rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+        entry = mbedtls_cache_find(session->peer_addr, session->peer_port);
+        resumed = resuming && entry && entry->session.id_len &&
+                  entry->session.id_len == session->ssl.session->id_len &&
+                  rt_memcmp(entry->session.id, session->ssl.session->id, entry->session.id_len) == 0;
+        rt_mutex_release(&mbedtls_lock);
+
+        if (!resumed)
+        {
+            mbedtls_cache_save(session);
+        }
+    }
+#endif
+
+    rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+    mbedtls_stat.handshakes++;
+    if (resumed)
+    {
+        mbedtls_stat.resumed++;
+    }
+    mbedtls_stat.total_ms += ms;
+    if (ms > mbedtls_stat.max_ms)
+    {
+        mbedtls_stat.max_ms = ms;
+    }
+    rt_mutex_release(&mbedtls_lock);
+
+    LOG_D("socket (%d) handshake %s in %d ms.", session->server_fd.fd, resumed ? "resumed" : "done", ms);
+
     return ret;
 
 __exit:
-    if (session)
+    rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+    mbedtls_stat.failed++;
+    rt_mutex_release(&mbedtls_lock);
+
+#if SAL_MBEDTLS_SESSION_CACHE_NUM > 0
+    /* the cached session may be rejected or broken, do the full handshake next time */
+    if (resuming)
     {
-        mbedtls_client_close(session);
+        mbedtls_cache_remove(session->peer_addr, session->peer_port);
     }
+#endif
 
+    /* the session is freed by closesocket */
     return ret;
 }
 
 static int mbedtls_closesocket(void *sock)
 {
+    struct sal_mbedtls_session *session = (struct sal_mbedtls_session *) sock;
     struct sal_socket *ssock;
     int socket;
     
@@ -205,7 +583,7 @@ static int mbedtls_closesocket(void *sock)
         return 0;
     }
     
-    socket = ((MbedTLSSession *) sock)->server_fd.fd;
+    socket = session->server_fd.fd;
     ssock = sal_get_socket(socket);
     if (ssock == RT_NULL)
     {
@@ -213,8 +591,24 @@ static int mbedtls_closesocket(void *sock)
     }
     
     /* Close TLS client session, and clean user-data in SAL socket */
-    mbedtls_client_close((MbedTLSSession *) sock);
+    mbedtls_ssl_close_notify(&session->ssl);
     ssock->user_data_tls = RT_NULL;
+
+    /* keep the session with its I/O buffers in the pool, the socket is closed by SAL */
+    rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+    if (mbedtls_pool_num < SAL_MBEDTLS_POOL_NUM && mbedtls_ssl_session_reset(&session->ssl) == 0)
+    {
+        session->next = mbedtls_pool;
+        mbedtls_pool = session;
+        mbedtls_pool_num++;
+        session = RT_NULL;
+    }
+    rt_mutex_release(&mbedtls_lock);
+
+    if (session)
+    {
+        mbedtls_session_free(session);
+    }
     
     return 0;
 }
@@ -224,9 +618,14 @@ static const struct sal_proto_tls_ops mbedtls_proto_ops=
     RT_NULL,
     mebdtls_socket,
     mbedtls_connect,
-    (int (*)(void *sock, const void *data, size_t size)) mbedtls_client_write,
-    (int (*)(void *sock, void *mem, size_t len)) mbedtls_client_read,
+    mbedtls_send,
+    mbedtls_recv,
     mbedtls_closesocket,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    mbedtls_set_peer,
 };
 
 static const struct sal_proto_tls mbedtls_proto =
@@ -237,6 +636,9 @@ static const struct sal_proto_tls mbedtls_proto =
 
 int sal_mbedtls_proto_init(void)
 {
+    rt_mutex_init(&mbedtls_lock, "tls_lock", RT_IPC_FLAG_FIFO);
+    rt_mutex_init(&mbedtls_rng_lock, "tls_rng", RT_IPC_FLAG_FIFO);
+
     /* register MbedTLS protocol options to SAL */
     sal_proto_tls_register(&mbedtls_proto);
 
@@ -244,4 +646,65 @@ int sal_mbedtls_proto_init(void)
 }
 INIT_COMPONENT_EXPORT(sal_mbedtls_proto_init);
 
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void tls_session(int argc, char **argv)
+{
+    struct sal_mbedtls_stat stat;
+    int index, pool_num;
+
+    if (argc == 2 && rt_strcmp(argv[1], "flush") == 0)
+    {
+#if SAL_MBEDTLS_SESSION_CACHE_NUM > 0
+        rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+        for (index = 0; index < SAL_MBEDTLS_SESSION_CACHE_NUM; index++)
+        {
+            if (mbedtls_cache[index].tick)
+            {
+                mbedtls_ssl_session_free(&mbedtls_cache[index].session);
+                mbedtls_cache[index].tick = 0;
+            }
+        }
+        rt_mutex_release(&mbedtls_lock);
+#endif
+        return;
+    }
+    else if (argc != 1)
+    {
+        rt_kprintf("Usage: tls_session [flush]\n");
+        return;
+    }
+
+    rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+    stat = mbedtls_stat;
+    pool_num = mbedtls_pool_num;
+    rt_mutex_release(&mbedtls_lock);
+
+    rt_kprintf("handshakes %d, resumed %d (%d%%), failed %d\n", stat.handshakes, stat.resumed,
+               stat.handshakes ? stat.resumed * 100 / stat.handshakes : 0, stat.failed);
+    rt_kprintf("handshake time average %d ms, max %d ms\n",
+               stat.handshakes ? stat.total_ms / stat.handshakes : 0, stat.max_ms);
+    rt_kprintf("pooled sessions %d/%d, reused %d\n", pool_num, SAL_MBEDTLS_POOL_NUM, stat.pool_hits);
+
+#if SAL_MBEDTLS_SESSION_CACHE_NUM > 0
+    rt_mutex_take(&mbedtls_lock, RT_WAITING_FOREVER);
+    for (index = 0; index < SAL_MBEDTLS_SESSION_CACHE_NUM; index++)
+    {
+        uint32_t addr = mbedtls_cache[index].peer_addr;
+
+        if (mbedtls_cache[index].tick == 0)
+        {
+            continue;
+        }
+        rt_kprintf("%d.%d.%d.%d:%d, used %d ticks ago\n",
+                   ((uint8_t *)&addr)[0], ((uint8_t *)&addr)[1], ((uint8_t *)&addr)[2], ((uint8_t *)&addr)[3],
+                   ntohs(mbedtls_cache[index].peer_port), rt_tick_get() - mbedtls_cache[index].tick);
+    }
+    rt_mutex_release(&mbedtls_lock);
+#endif
+}
+MSH_CMD_EXPORT(tls_session, show the TLS handshakes and cached sessions: tls_session [flush]);
+#endif /* RT_USING_FINSH */
+
 #endif /* SAL_USING_TLS */
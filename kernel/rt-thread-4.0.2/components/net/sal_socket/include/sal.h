@@ -6,6 +6,10 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-05-17     ChenYong     First version
+ * 2026-10-18     liujiahao    Add fast data path operations.
+ * 2026-10-18     liujiahao    Add zero-copy network buffer operations.
+ * 2026-10-18     liujiahao    Add message operations.
+ * 2026-10-18     liujiahao    Add network interface device selection policy.
  */
 
 #ifndef SAL_H__
@@ -17,6 +21,10 @@
 #include <dfs_file.h>
 #endif
 
+#ifdef SAL_USING_NETBUF
+#include <sal_netbuf.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -58,8 +66,18 @@ struct sal_socket
 #ifdef SAL_USING_TLS
     void *user_data_tls;               /* user-specific TLS data */
 #endif
+#ifdef SAL_USING_LWIP_FASTPATH
+    const struct sal_fastpath_ops *fastpath;
+#endif
+#ifdef NETDEV_USING_POLICY
+    int policy;                        /* the network interface selection policy, -1 is the global one */
+    uint32_t policy_flags;
+#endif
 };
 
+struct msghdr;
+struct mmsghdr;
+
 /* network interface socket opreations */
 struct sal_socket_ops
 {
@@ -80,8 +98,39 @@ struct sal_socket_ops
 #ifdef SAL_USING_POSIX
     int (*poll)       (struct dfs_fd *file, struct rt_pollreq *req);
 #endif
+    /* optional, the messages are copied to or from a buffer without them */
+    int (*sendmsg)    (int s, const struct msghdr *message, int flags);
+    int (*recvmsg)    (int s, struct msghdr *message, int flags);
+    int (*sendmmsg)   (int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
 };
 
+#ifdef SAL_USING_LWIP_FASTPATH
+/* the data path which goes to the protocol stack object directly */
+struct sal_fastpath_ops
+{
+    int (*attach)     (int s);
+    int (*sendto)     (int s, const void *data, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
+    int (*recvfrom)   (int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen);
+};
+#endif
+
+#ifdef SAL_USING_NETBUF
+/* The data size of the copied network buffer received */
+#ifndef SAL_NETBUF_COPY_SIZE
+#define SAL_NETBUF_COPY_SIZE           1460
+#endif
+
+/* zero-copy network buffer opreations */
+struct sal_netbuf_ops
+{
+    int  (*alloc)     (int s, struct sal_netbuf *buf, size_t size);
+    int  (*sendto)    (int s, struct sal_netbuf *buf, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
+    int  (*recvfrom)  (int s, struct sal_netbuf *buf, int flags, struct sockaddr *from, socklen_t *fromlen);
+    int  (*next)      (struct sal_netbuf *buf);
+    void (*free)      (struct sal_netbuf *buf);
+};
+#endif
+
 /* sal network database name resolving */
 struct sal_netdb_ops
 {
@@ -97,6 +146,12 @@ struct sal_proto_family
     int sec_family;                              /* secondary protocol families type */
     const struct sal_socket_ops *skt_ops;        /* socket opreations */
     const struct sal_netdb_ops *netdb_ops;       /* network database opreations */
+#ifdef SAL_USING_LWIP_FASTPATH
+    const struct sal_fastpath_ops *fastpath_ops; /* fast data path opreations, optional */
+#endif
+#ifdef SAL_USING_NETBUF
+    const struct sal_netbuf_ops *netbuf_ops;     /* zero-copy network buffer opreations, optional */
+#endif
 };
 
 /* SAL(Socket Abstraction Layer) initialize */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#ifndef SAL_DNS_CACHE_H__
+#define SAL_DNS_CACHE_H__
+
+#include <rtthread.h>
+#include <netdev_ipaddr.h>
+#include <sal_netdb.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the number of cached names */
+#ifndef SAL_DNS_CACHE_NUM
+#define SAL_DNS_CACHE_NUM              8
+#endif
+
+/* the maximum length of cached names, the longer names aren't cached */
+#ifndef SAL_DNS_CACHE_NAME_LEN
+#define SAL_DNS_CACHE_NAME_LEN         64
+#endif
+
+/* the time to live of resolved names in seconds */
+#ifndef SAL_DNS_CACHE_TTL
+#define SAL_DNS_CACHE_TTL              300
+#endif
+
+/* the time to live of the names which don't exist in seconds, 0 is no negative caching */
+#ifndef SAL_DNS_CACHE_NEG_TTL
+#define SAL_DNS_CACHE_NEG_TTL          30
+#endif
+
+/* the result of sal_dns_cache_lookup() */
+#define SAL_DNS_CACHE_HIT              0    /* the address is cached */
+#define SAL_DNS_CACHE_NEGATIVE         1    /* the name isn't found recently */
+#define SAL_DNS_CACHE_RESOLVE          2    /* resolve it and call sal_dns_cache_update() */
+#define SAL_DNS_CACHE_BYPASS           3    /* resolve it without the cache */
+
+struct sal_dns_cache_stat
+{
+    rt_uint32_t lookups;
+    rt_uint32_t hits;
+    rt_uint32_t negative_hits;
+    rt_uint32_t misses;
+    rt_uint32_t coalesced;              /* the lookups waiting for the same name in resolving */
+    rt_uint32_t bypassed;
+    rt_uint32_t evictions;
+};
+
+struct netdev;
+
+int sal_dns_cache_init(void);
+int sal_dns_cache_lookup(struct netdev *netdev, int family, const char *name, ip4_addr_t *addr);
+void sal_dns_cache_update(struct netdev *netdev, int family, const char *name, const ip4_addr_t *addr, int result);
+void sal_dns_cache_flush(void);
+void sal_dns_cache_get_stat(struct sal_dns_cache_stat *stat);
+
+struct hostent *sal_dns_cache_hostent(const char *name, const ip4_addr_t *addr);
+int sal_dns_cache_hostent_r(const char *name, const ip4_addr_t *addr, struct hostent *ret,
+                            char *buf, size_t buflen, struct hostent **result, int *h_errnop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAL_DNS_CACHE_H__ */
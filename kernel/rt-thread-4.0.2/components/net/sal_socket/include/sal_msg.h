@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#ifndef SAL_MSG_H__
+#define SAL_MSG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * message vector of sendmmsg/recvmmsg, the struct msghdr is defined by
+ * sal_socket.h or the socket header of protocol stack before it
+ */
+struct mmsghdr
+{
+    struct msghdr  msg_hdr;        /* message header */
+    unsigned int   msg_len;        /* number of bytes transmitted */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAL_MSG_H__ */
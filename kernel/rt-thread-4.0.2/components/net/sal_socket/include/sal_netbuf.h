@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#ifndef SAL_NETBUF_H__
+#define SAL_NETBUF_H__
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sal_netbuf_ops;
+
+/* zero-copy network buffer, the data is kept in the buffers of protocol stack */
+struct sal_netbuf
+{
+    void *payload;                      /* data of the current segment */
+    size_t len;                         /* length of the current segment */
+    size_t tot_len;                     /* total length of the buffer */
+
+    const struct sal_netbuf_ops *ops;   /* protocol stack operations, RT_NULL for the copied buffer */
+    void *user_data;                    /* buffer of protocol stack */
+    void *segment;                      /* current segment of protocol stack */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAL_NETBUF_H__ */
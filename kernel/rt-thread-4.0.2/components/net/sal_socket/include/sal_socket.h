@@ -6,12 +6,18 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-05-24     ChenYong     First version
+ * 2026-10-18     liujiahao    Add zero-copy network buffer
+ * 2026-10-18     liujiahao    Add sendmsg/recvmsg and sendmmsg/recvmmsg
+ * 2026-10-18     liujiahao    Add SO_BINDTODEVICE and SO_NETDEV_POLICY
  */
 
 #ifndef SAL_SOCKET_H__
 #define SAL_SOCKET_H__
 
 #include <arpa/inet.h>
+#ifdef SAL_USING_NETBUF
+#include <sal_netbuf.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -62,6 +68,10 @@ typedef uint16_t in_port_t;
 #define SO_TYPE         0x1008 /* get socket type */
 #define SO_CONTIMEO     0x1009 /* Unimplemented: connect timeout */
 #define SO_NO_CHECK     0x100a /* don't create UDP checksum */
+#define SO_BINDTODEVICE 0x100b /* bind to the network interface device by name */
+
+/* SAL options, the network interface device selection policy of socket */
+#define SO_NETDEV_POLICY 0x1100
 
 /* Level number for (get/set)sockopt() to apply to socket itself */
 #define  SOL_SOCKET     0xfff    /* options for socket level */
@@ -96,6 +106,11 @@ typedef uint16_t in_port_t;
 #define MSG_OOB         0x04    /* Unimplemented: Requests out-of-band data. The significance and semantics of out-of-band data are protocol-specific */
 #define MSG_DONTWAIT    0x08    /* Nonblocking i/o for this operation only */
 #define MSG_MORE        0x10    /* Sender will send more */
+#define MSG_WAITFORONE  0x10000 /* recvmmsg(): the messages after the first one are received without blocking */
+
+/* struct msghdr->msg_flags bit field values */
+#define MSG_TRUNC       0x04
+#define MSG_CTRUNC      0x08
 
 /* Options for level IPPROTO_IP */
 #define IP_TOS             1
@@ -193,6 +208,33 @@ struct sockaddr_storage
 #endif /* NETDEV_IPV6 */
 };
 
+/* scatter/gather I/O, it's the same as the iovec in lwIP */
+#ifndef _STRUCT_IOVEC_DEFINED
+#define _STRUCT_IOVEC_DEFINED
+struct iovec
+{
+    void  *iov_base;
+    size_t iov_len;
+};
+#endif
+
+/* message header, it's the same as the msghdr in lwIP */
+struct msghdr
+{
+    void          *msg_name;       /* optional address */
+    socklen_t      msg_namelen;    /* size of address */
+    struct iovec  *msg_iov;        /* scatter/gather array */
+    int            msg_iovlen;     /* elements in msg_iov */
+    void          *msg_control;    /* ancillary data, unsupported */
+    socklen_t      msg_controllen; /* ancillary data buffer len */
+    int            msg_flags;      /* flags on received message */
+};
+
+/* message vector of sendmmsg/recvmmsg */
+#include <sal_msg.h>
+
+struct timespec;
+
 int sal_accept(int socket, struct sockaddr *addr, socklen_t *addrlen);
 int sal_bind(int socket, const struct sockaddr *name, socklen_t namelen);
 int sal_shutdown(int socket, int how);
@@ -209,6 +251,21 @@ int sal_sendto(int socket, const void *dataptr, size_t size, int flags,
 int sal_socket(int domain, int type, int protocol);
 int sal_closesocket(int socket);
 int sal_ioctlsocket(int socket, long cmd, void *arg);
+int sal_sendmsg(int socket, const struct msghdr *message, int flags);
+int sal_recvmsg(int socket, struct msghdr *message, int flags);
+int sal_sendmmsg(int socket, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+int sal_recvmmsg(int socket, struct mmsghdr *msgvec, unsigned int vlen, int flags,
+    struct timespec *timeout);
+
+#ifdef SAL_USING_NETBUF
+struct sal_netbuf *sal_netbuf_alloc(int socket, size_t size);
+int sal_netbuf_send(int socket, struct sal_netbuf *buf, size_t size, int flags,
+    const struct sockaddr *to, socklen_t tolen);
+int sal_netbuf_recv(int socket, struct sal_netbuf **buf, int flags,
+    struct sockaddr *from, socklen_t *fromlen);
+int sal_netbuf_next(struct sal_netbuf *buf);
+void sal_netbuf_free(struct sal_netbuf *buf);
+#endif /* SAL_USING_NETBUF */
 
 #ifdef __cplusplus
 }
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-11-10     ChenYong     First version
+ * 2026-10-18     liujiahao    Add the peer address operation
  */
 #ifndef __SAL_TLS_H__
 #define __SAL_TLS_H__
@@ -16,6 +17,8 @@ extern "C" {
 
 #include <rtthread.h>
 
+struct sockaddr;
+
 /* Protocol level for TLS.
  * Here, the same socket protocol level for TLS as in Linux was used.
  */
@@ -50,6 +53,8 @@ struct sal_proto_tls_ops
     int (*set_ciphersurite)(void *sock, const void* ciphersurite, size_t size);   /* Set select ciphersuites */
     int (*set_peer_verify)(void *sock, const void* peer_verify, size_t size);     /* Set peer verification */
     int (*set_dtls_role)(void *sock, const void *dtls_role, size_t size);         /* Set role for DTLS */
+    /* optional, set the peer address before connect, used to resume the session with the peer */
+    int (*set_peer)(void *sock, const struct sockaddr *name, uint32_t namelen);
 };
 
 struct sal_proto_tls
@@ -7,6 +7,8 @@
  * Date           Author       Notes
  * 2015-02-17     Bernard      First version
  * 2018-05-17     ChenYong     Add socket abstraction layer
+ * 2026-10-18     liujiahao    Add zero-copy network buffer
+ * 2026-10-18     liujiahao    Add sendmsg/recvmsg and sendmmsg/recvmmsg
  */
 
 #ifndef SYS_SOCKET_H_
@@ -41,6 +43,18 @@ int sendto(int s, const void *dataptr, size_t size, int flags,
 int socket(int domain, int type, int protocol);
 int closesocket(int s);
 int ioctlsocket(int s, long cmd, void *arg);
+int sendmsg(int s, const struct msghdr *message, int flags);
+int recvmsg(int s, struct msghdr *message, int flags);
+int sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+int recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags,
+    struct timespec *timeout);
+#ifdef SAL_USING_NETBUF
+struct sal_netbuf *sock_netbuf_alloc(int s, size_t size);
+int sock_netbuf_send(int s, struct sal_netbuf *buf, size_t size, int flags,
+    const struct sockaddr *to, socklen_t tolen);
+int sock_netbuf_recv(int s, struct sal_netbuf **buf, int flags,
+    struct sockaddr *from, socklen_t *fromlen);
+#endif
 #else
 #define accept(s, addr, addrlen)                           sal_accept(s, addr, addrlen)
 #define bind(s, name, namelen)                             sal_bind(s, name, namelen)
@@ -58,6 +72,15 @@ int ioctlsocket(int s, long cmd, void *arg);
 #define socket(domain, type, protocol)                     sal_socket(domain, type, protocol)
 #define closesocket(s)                                     sal_closesocket(s)
 #define ioctlsocket(s, cmd, arg)                           sal_ioctlsocket(s, cmd, arg)
+#define sendmsg(s, message, flags)                         sal_sendmsg(s, message, flags)
+#define recvmsg(s, message, flags)                         sal_recvmsg(s, message, flags)
+#define sendmmsg(s, msgvec, vlen, flags)                   sal_sendmmsg(s, msgvec, vlen, flags)
+#define recvmmsg(s, msgvec, vlen, flags, timeout)          sal_recvmmsg(s, msgvec, vlen, flags, timeout)
+#ifdef SAL_USING_NETBUF
+#define sock_netbuf_alloc(s, size)                         sal_netbuf_alloc(s, size)
+#define sock_netbuf_send(s, buf, size, flags, to, tolen)   sal_netbuf_send(s, buf, size, flags, to, tolen)
+#define sock_netbuf_recv(s, buf, flags, from, fromlen)     sal_netbuf_recv(s, buf, flags, from, fromlen)
+#endif
 #endif /* SAL_USING_POSIX */
 
 #ifdef __cplusplus
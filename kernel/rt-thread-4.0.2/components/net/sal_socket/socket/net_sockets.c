@@ -7,6 +7,8 @@
  * Date           Author       Notes
  * 2015-02-17     Bernard      First version
  * 2018-05-17     ChenYong     Add socket abstraction layer
+ * 2026-10-18     liujiahao    Add zero-copy network buffer
+ * 2026-10-18     liujiahao    Add sendmsg/recvmsg and sendmmsg/recvmmsg
  */
 
 #include <dfs.h>
@@ -291,3 +293,64 @@ int ioctlsocket(int s, long cmd, void *arg)
     return sal_ioctlsocket(socket, cmd, arg);
 }
 RTM_EXPORT(ioctlsocket);
+
+int sendmsg(int s, const struct msghdr *message, int flags)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_sendmsg(socket, message, flags);
+}
+RTM_EXPORT(sendmsg);
+
+int recvmsg(int s, struct msghdr *message, int flags)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_recvmsg(socket, message, flags);
+}
+RTM_EXPORT(recvmsg);
+
+int sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_sendmmsg(socket, msgvec, vlen, flags);
+}
+RTM_EXPORT(sendmmsg);
+
+int recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags,
+             struct timespec *timeout)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_recvmmsg(socket, msgvec, vlen, flags, timeout);
+}
+RTM_EXPORT(recvmmsg);
+
+#ifdef SAL_USING_NETBUF
+struct sal_netbuf *sock_netbuf_alloc(int s, size_t size)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_netbuf_alloc(socket, size);
+}
+RTM_EXPORT(sock_netbuf_alloc);
+
+int sock_netbuf_send(int s, struct sal_netbuf *buf, size_t size, int flags,
+                     const struct sockaddr *to, socklen_t tolen)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_netbuf_send(socket, buf, size, flags, to, tolen);
+}
+RTM_EXPORT(sock_netbuf_send);
+
+int sock_netbuf_recv(int s, struct sal_netbuf **buf, int flags,
+                     struct sockaddr *from, socklen_t *fromlen)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_netbuf_recv(socket, buf, flags, from, fromlen);
+}
+RTM_EXPORT(sock_netbuf_recv);
+#endif /* SAL_USING_NETBUF */
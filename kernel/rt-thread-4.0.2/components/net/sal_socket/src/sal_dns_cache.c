@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+#include <rtthread.h>
+
+#ifdef SAL_USING_DNS_CACHE
+#include <string.h>
+#include <errno.h>
+#include <sal_dns_cache.h>
+#include <netdev.h>
+
+#define DBG_TAG                        "sal.dns"
+#define DBG_LVL                        DBG_INFO
+#include <rtdbg.h>
+
+enum sal_dns_cache_state
+{
+    SAL_DNS_CACHE_EMPTY,
+    SAL_DNS_CACHE_PENDING,              /* resolving by one, the others wait for it */
+    SAL_DNS_CACHE_FOUND,
+    SAL_DNS_CACHE_NOT_FOUND,
+};
+
+struct sal_dns_cache_entry
+{
+    char name[SAL_DNS_CACHE_NAME_LEN];
+    struct netdev *netdev;              /* the names are resolved by the DNS servers of netdev */
+    int family;                         /* the protocol family of netdev */
+    rt_uint8_t state;
+    rt_uint8_t waiters;
+    ip4_addr_t addr;
+    rt_tick_t expire;
+    rt_tick_t used;                     /* the least recently used is replaced */
+    struct rt_semaphore done;           /* released for each waiter when resolved */
+};
+
+/* the hostent of sal_dns_cache_hostent_r() in the buffer of caller */
+struct sal_dns_cache_hostent_helper
+{
+    ip_addr_t *addr_list[2];
+    ip_addr_t addr;
+    char *aliases;
+};
+
+static struct sal_dns_cache_entry dns_cache_table[SAL_DNS_CACHE_NUM];
+static struct sal_dns_cache_stat dns_cache_stat;
+static struct rt_mutex dns_cache_lock;
+
+static int dns_cache_name_cmp(const char *a, const char *b)
+{
+    char x, y;
+
+    /* the domain names are case insensitive */
+    do
+    {
+        x = *a++;
+        y = *b++;
+        if (x >= 'A' && x <= 'Z')
+            x += 'a' - 'A';
+        if (y >= 'A' && y <= 'Z')
+            y += 'a' - 'A';
+    } while (x == y && x != '\0');
+
+    return x - y;
+}
+
+static struct sal_dns_cache_entry *dns_cache_find(struct netdev *netdev, int family, const char *name)
+{
+    struct sal_dns_cache_entry *entry;
+    int index;
+
+    for (index = 0; index < SAL_DNS_CACHE_NUM; index ++)
+    {
+        entry = &dns_cache_table[index];
+        if (entry->state != SAL_DNS_CACHE_EMPTY && entry->netdev == netdev && entry->family == family &&
+            dns_cache_name_cmp(entry->name, name) == 0)
+            return entry;
+    }
+
+    return RT_NULL;
+}
+
+static rt_bool_t dns_cache_expired(struct sal_dns_cache_entry *entry, rt_tick_t now)
+{
+    return (rt_int32_t)(now - entry->expire) >= 0;
+}
+
+/* the empty entry, or the expired one, or the least recently used one */
+static struct sal_dns_cache_entry *dns_cache_victim(rt_tick_t now)
+{
+    struct sal_dns_cache_entry *entry, *victim = RT_NULL;
+    int index;
+
+    for (index = 0; index < SAL_DNS_CACHE_NUM; index ++)
+    {
+        entry = &dns_cache_table[index];
+        if (entry->state == SAL_DNS_CACHE_PENDING || entry->waiters)
+            continue;
+        if (entry->state == SAL_DNS_CACHE_EMPTY || dns_cache_expired(entry, now))
+            return entry;
+        if (victim == RT_NULL || (rt_int32_t)(entry->used - victim->used) < 0)
+            victim = entry;
+    }
+
+    if (victim != RT_NULL)
+        dns_cache_stat.evictions ++;
+
+    return victim;
+}
+
+int sal_dns_cache_init(void)
+{
+    int index;
+
+    rt_memset(dns_cache_table, 0, sizeof(dns_cache_table));
+    for (index = 0; index < SAL_DNS_CACHE_NUM; index ++)
+    {
+        rt_sem_init(&dns_cache_table[index].done, "dns_c", 0, RT_IPC_FLAG_FIFO);
+    }
+    rt_mutex_init(&dns_cache_lock, "dns_c", RT_IPC_FLAG_FIFO);
+
+    return 0;
+}
+
+/**
+ * This function will look up the name in the DNS cache. The concurrent lookups of the
+ * name in resolving wait for the result of the first one.
+ *
+ * @param netdev the network interface device which resolves the name
+ * @param family the protocol family of network interface device
+ * @param name the host name
+ * @param addr the cached address
+ *
+ * @return SAL_DNS_CACHE_HIT: the address is cached
+ *         SAL_DNS_CACHE_NEGATIVE: the name isn't found recently
+ *         SAL_DNS_CACHE_RESOLVE: the caller must resolve it and call sal_dns_cache_update()
+ *         SAL_DNS_CACHE_BYPASS: the caller resolves it without the cache
+ */
+int sal_dns_cache_lookup(struct netdev *netdev, int family, const char *name, ip4_addr_t *addr)
+{
+    struct sal_dns_cache_entry *entry;
+    rt_bool_t waited = RT_FALSE;
+    ip4_addr_t numeric;
+    rt_tick_t now;
+    int result;
+
+    /* the numeric address is never resolved */
+    if (name == RT_NULL || strlen(name) >= SAL_DNS_CACHE_NAME_LEN || netdev_ip4addr_aton(name, &numeric))
+    {
+        rt_mutex_take(&dns_cache_lock, RT_WAITING_FOREVER);
+        dns_cache_stat.lookups ++;
+        dns_cache_stat.bypassed ++;
+        rt_mutex_release(&dns_cache_lock);
+        return SAL_DNS_CACHE_BYPASS;
+    }
+
+    rt_mutex_take(&dns_cache_lock, RT_WAITING_FOREVER);
+    dns_cache_stat.lookups ++;
+
+    while (1)
+    {
+        now = rt_tick_get();
+        entry = dns_cache_find(netdev, family, name);
+        if (entry == RT_NULL || entry->state != SAL_DNS_CACHE_PENDING)
+            break;
+
+        /* wait for the resolving one, it may be aborted then resolve it again */
+        if (!waited)
+            dns_cache_stat.coalesced ++;
+        waited = RT_TRUE;
+        entry->waiters ++;
+        rt_mutex_release(&dns_cache_lock);
+        rt_sem_take(&entry->done, RT_WAITING_FOREVER);
+        rt_mutex_take(&dns_cache_lock, RT_WAITING_FOREVER);
+        entry->waiters --;
+    }
+
+    if (entry != RT_NULL && !dns_cache_expired(entry, now))
+    {
+        entry->used = now;
+        if (entry->state == SAL_DNS_CACHE_FOUND)
+        {
+            *addr = entry->addr;
+            dns_cache_stat.hits ++;
+            result = SAL_DNS_CACHE_HIT;
+        }
+        else
+        {
+            dns_cache_stat.negative_hits ++;
+            result = SAL_DNS_CACHE_NEGATIVE;
+        }
+        goto __exit;
+    }
+
+    if (entry == RT_NULL)
+    {
+        entry = dns_cache_victim(now);
+        if (entry == RT_NULL)
+        {
+            /* all of the entries are in resolving */
+            dns_cache_stat.bypassed ++;
+            result = SAL_DNS_CACHE_BYPASS;
+            goto __exit;
+        }
+        strcpy(entry->name, name);
+        entry->netdev = netdev;
+        entry->family = family;
+    }
+
+    entry->state = SAL_DNS_CACHE_PENDING;
+    entry->used = now;
+    dns_cache_stat.misses ++;
+    result = SAL_DNS_CACHE_RESOLVE;
+
+__exit:
+    rt_mutex_release(&dns_cache_lock);
+
+    return result;
+}
+
+/**
+ * This function will update the name resolved after SAL_DNS_CACHE_RESOLVE of
+ * sal_dns_cache_lookup(), and wake up the lookups waiting for it.
+ *
+ * @param netdev the network interface device which resolves the name
+ * @param family the protocol family of network interface device
+ * @param name the host name
+ * @param addr the resolved address, RT_NULL if it isn't an IPv4 address
+ * @param result 0: resolved
+ *              <0: the protocol stack reports the name doesn't exist, it's cached
+ *                  as the negative one
+ *              >0: failed for the other reason like timeout, it isn't cached
+ */
+void sal_dns_cache_update(struct netdev *netdev, int family, const char *name, const ip4_addr_t *addr, int result)
+{
+    struct sal_dns_cache_entry *entry;
+    rt_tick_t now = rt_tick_get();
+    int waiters;
+
+    rt_mutex_take(&dns_cache_lock, RT_WAITING_FOREVER);
+
+    entry = dns_cache_find(netdev, family, name);
+    if (entry == RT_NULL || entry->state != SAL_DNS_CACHE_PENDING)
+        goto __exit;
+
+    if (result == 0 && addr != RT_NULL)
+    {
+        entry->state = SAL_DNS_CACHE_FOUND;
+        entry->addr = *addr;
+        entry->expire = now + SAL_DNS_CACHE_TTL * RT_TICK_PER_SECOND;
+    }
+    else if (result < 0 && SAL_DNS_CACHE_NEG_TTL > 0)
+    {
+        entry->state = SAL_DNS_CACHE_NOT_FOUND;
+        entry->expire = now + SAL_DNS_CACHE_NEG_TTL * RT_TICK_PER_SECOND;
+    }
+    else
+    {
+        entry->state = SAL_DNS_CACHE_EMPTY;
+    }
+
+    for (waiters = entry->waiters; waiters > 0; waiters --)
+    {
+        rt_sem_release(&entry->done);
+    }
+
+__exit:
+    rt_mutex_release(&dns_cache_lock);
+}
+
+void sal_dns_cache_flush(void)
+{
+    int index;
+
+    rt_mutex_take(&dns_cache_lock, RT_WAITING_FOREVER);
+    for (index = 0; index < SAL_DNS_CACHE_NUM; index ++)
+    {
+        /* the resolving one is updated by its resolver */
+        if (dns_cache_table[index].state != SAL_DNS_CACHE_PENDING)
+            dns_cache_table[index].state = SAL_DNS_CACHE_EMPTY;
+    }
+    rt_mutex_release(&dns_cache_lock);
+}
+
+void sal_dns_cache_get_stat(struct sal_dns_cache_stat *stat)
+{
+    rt_mutex_take(&dns_cache_lock, RT_WAITING_FOREVER);
+    *stat = dns_cache_stat;
+    rt_mutex_release(&dns_cache_lock);
+}
+
+static void dns_cache_fill_hostent(struct hostent *host, char *name, ip_addr_t *addr, ip_addr_t **addr_list,
+                                   char **aliases, const ip4_addr_t *ip4addr)
+{
+#if NETDEV_IPV4 && NETDEV_IPV6
+    addr->u_addr.ip4 = *ip4addr;
+    addr->type = IPADDR_TYPE_V4;
+#elif NETDEV_IPV4
+    *addr = *ip4addr;
+#elif NETDEV_IPV6
+#error "not only support IPV6"
+#endif /* NETDEV_IPV4 && NETDEV_IPV6 */
+
+    addr_list[0] = addr;
+    addr_list[1] = RT_NULL;
+    *aliases = RT_NULL;
+    host->h_name = name;
+    host->h_aliases = aliases;
+    host->h_addrtype = AF_INET;
+    host->h_length = sizeof(ip_addr_t);
+    host->h_addr_list = (char **)addr_list;
+}
+
+/* the cached hostent is in the static buffer like gethostbyname() of protocol stack */
+struct hostent *sal_dns_cache_hostent(const char *name, const ip4_addr_t *addr)
+{
+    static struct hostent s_hostent;
+    static char *s_aliases;
+    static ip_addr_t s_hostent_addr;
+    static ip_addr_t *s_phostent_addr[2];
+    static char s_hostname[SAL_DNS_CACHE_NAME_LEN];
+
+    strncpy(s_hostname, name, SAL_DNS_CACHE_NAME_LEN - 1);
+    s_hostname[SAL_DNS_CACHE_NAME_LEN - 1] = '\0';
+    dns_cache_fill_hostent(&s_hostent, s_hostname, &s_hostent_addr, s_phostent_addr, &s_aliases, addr);
+
+    return &s_hostent;
+}
+
+/* the cached hostent is in the buffer of caller like gethostbyname_r() of protocol stack */
+int sal_dns_cache_hostent_r(const char *name, const ip4_addr_t *addr, struct hostent *ret,
+                            char *buf, size_t buflen, struct hostent **result, int *h_errnop)
+{
+    struct sal_dns_cache_hostent_helper *helper;
+    char *hostname;
+    size_t namelen = strlen(name);
+
+    *result = RT_NULL;
+    helper = (struct sal_dns_cache_hostent_helper *)RT_ALIGN((rt_ubase_t)buf, sizeof(void *));
+    if ((char *)helper + sizeof(*helper) + namelen + 1 > buf + buflen)
+    {
+        if (h_errnop)
+            *h_errnop = ERANGE;
+        return -1;
+    }
+
+    hostname = (char *)helper + sizeof(*helper);
+    rt_memcpy(hostname, name, namelen + 1);
+    dns_cache_fill_hostent(ret, hostname, &helper->addr, helper->addr_list, &helper->aliases, addr);
+    *result = ret;
+
+    return 0;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void dns_cache(int argc, char **argv)
+{
+    struct sal_dns_cache_stat stat;
+    struct sal_dns_cache_entry *entry;
+    rt_tick_t now = rt_tick_get();
+    char ipstr[16];
+    int index, answered;
+
+    if (argc == 2 && strcmp(argv[1], "flush") == 0)
+    {
+        sal_dns_cache_flush();
+        return;
+    }
+    else if (argc != 1)
+    {
+        rt_kprintf("Usage: dns_cache [flush]\n");
+        return;
+    }
+
+    rt_mutex_take(&dns_cache_lock, RT_WAITING_FOREVER);
+    for (index = 0; index < SAL_DNS_CACHE_NUM; index ++)
+    {
+        entry = &dns_cache_table[index];
+        switch (entry->state)
+        {
+        case SAL_DNS_CACHE_PENDING:
+            rt_kprintf("%-32s %-8s resolving, %d waiting\n", entry->name, entry->netdev->name, entry->waiters);
+            break;
+        case SAL_DNS_CACHE_FOUND:
+        case SAL_DNS_CACHE_NOT_FOUND:
+            if (dns_cache_expired(entry, now))
+                break;
+            if (entry->state == SAL_DNS_CACHE_FOUND)
+                netdev_ip4addr_ntoa_r(&entry->addr, ipstr, sizeof(ipstr));
+            else
+                strcpy(ipstr, "not found");
+            rt_kprintf("%-32s %-8s %-15s ttl %d s\n", entry->name, entry->netdev->name, ipstr,
+                       (entry->expire - now) / RT_TICK_PER_SECOND);
+            break;
+        default:
+            break;
+        }
+    }
+    rt_mutex_release(&dns_cache_lock);
+
+    sal_dns_cache_get_stat(&stat);
+    answered = stat.hits + stat.negative_hits;
+    rt_kprintf("lookups %d, hits %d, negative hits %d, misses %d, coalesced %d, bypassed %d, evictions %d\n",
+               stat.lookups, stat.hits, stat.negative_hits, stat.misses, stat.coalesced, stat.bypassed,
+               stat.evictions);
+    rt_kprintf("hit rate %d%%\n", stat.lookups ? answered * 100 / stat.lookups : 0);
+}
+MSH_CMD_EXPORT(dns_cache, show the DNS cache of SAL: dns_cache [flush]);
+#endif /* RT_USING_FINSH */
+
+#endif /* SAL_USING_DNS_CACHE */
@@ -7,6 +7,12 @@
  * Date           Author       Notes
  * 2018-05-23     ChenYong     First version
  * 2018-11-12     ChenYong     Add TLS support
+ * 2026-10-18     liujiahao    Add fast data path to protocol stack
+ * 2026-10-18     liujiahao    Add zero-copy network buffer
+ * 2026-10-18     liujiahao    Add sendmsg/recvmsg and sendmmsg/recvmmsg
+ * 2026-10-18     liujiahao    Add DNS cache
+ * 2026-10-18     liujiahao    Pass the peer address to TLS
+ * 2026-10-18     liujiahao    Select network interface device by policy
  */
 
 #include <rtthread.h>
@@ -18,8 +24,15 @@
 #ifdef SAL_USING_TLS
 #include <sal_tls.h>
 #endif
+#ifdef SAL_USING_DNS_CACHE
+#include <sal_dns_cache.h>
+#endif
 #include <sal.h>
 #include <netdev.h>
+#ifdef NETDEV_USING_POLICY
+#include <netdev_policy.h>
+#include <errno.h>
+#endif
 
 #include <ipc/workqueue.h>
 
@@ -85,6 +98,24 @@ do {
     }                                                                             \
 }while(0)                                                                         \
 
+#ifdef NETDEV_USING_POLICY
+/* the socket is bound to an address or a device, it's not moved by the policy */
+#define SAL_POLICY_BOUND               0x01
+#define SAL_POLICY_DEVICE              0x02
+/* the options are set to the protocol stack, it can't be moved to another one */
+#define SAL_POLICY_OPTIONS             0x04
+
+#define SAL_NETDEV_TRAFFIC(sock, tx, rx)                                          \
+do {                                                                              \
+    if ((tx) > 0 || (rx) > 0) {                                                   \
+        netdev_policy_traffic((sock)->netdev, (tx) > 0 ? (tx) : 0, (rx) > 0 ? (rx) : 0); \
+    }                                                                             \
+}while(0)                                                                         \
+
+#else
+#define SAL_NETDEV_TRAFFIC(sock, tx, rx)
+#endif /* NETDEV_USING_POLICY */
+
 #define SAL_NETDEV_NETDBOPS_VALID(netdev, pf, ops)                                \
     ((netdev) && netdev_is_up(netdev) &&                                          \
     ((pf) = (struct sal_proto_family *) (netdev)->sal_user_data) != RT_NULL &&    \
@@ -119,6 +150,10 @@ int sal_init(void)
     /* create sal socket lock */
     rt_mutex_init(&sal_core_lock, "sal_lock", RT_IPC_FLAG_FIFO);
 
+#ifdef SAL_USING_DNS_CACHE
+    sal_dns_cache_init();
+#endif
+
     LOG_I("Socket Abstraction Layer initialize success.");
     init_ok = RT_TRUE;
 
@@ -379,6 +414,48 @@ int sal_netdev_cleanup(struct netdev *netdev)
     return 0;
 }
 
+/* set the network interface device of socket, and count the sockets using it */
+static void socket_netdev_set(struct sal_socket *sock, struct netdev *netdev)
+{
+#ifdef NETDEV_USING_POLICY
+    netdev_policy_flow(sock->netdev, RT_FALSE);
+    netdev_policy_flow(netdev, RT_TRUE);
+#endif
+    sock->netdev = netdev;
+}
+
+#ifdef NETDEV_USING_POLICY
+static enum netdev_policy socket_policy(struct sal_socket *sock)
+{
+    return sock->policy < 0 ? netdev_policy_get() : (enum netdev_policy) sock->policy;
+}
+
+/* check the network interface device can carry the socket */
+static rt_bool_t socket_netdev_filter(struct netdev *netdev, void *arg)
+{
+    struct sal_socket *sock = (struct sal_socket *) arg;
+    struct sal_proto_family *pf, *cur_pf;
+
+    pf = (struct sal_proto_family *) netdev->sal_user_data;
+    if (pf == RT_NULL || pf->skt_ops == RT_NULL || (pf->family != sock->domain && pf->sec_family != sock->domain))
+    {
+        return RT_FALSE;
+    }
+
+    /* the options of protocol stack are lost if the socket is re-created by another one */
+    if ((sock->policy_flags & SAL_POLICY_OPTIONS) && sock->netdev)
+    {
+        cur_pf = (struct sal_proto_family *) sock->netdev->sal_user_data;
+        if (cur_pf && cur_pf->family != pf->family)
+        {
+            return RT_FALSE;
+        }
+    }
+
+    return RT_TRUE;
+}
+#endif /* NETDEV_USING_POLICY */
+
 /**
  * This function will initialize sal socket object and set socket options
  *
@@ -416,13 +493,23 @@ static int socket_init(int family, int type, int protocol, struct sal_socket **r
     sock->type = type;
     sock->protocol = protocol;
 
+#ifdef NETDEV_USING_POLICY
+    /* select by the policy, the socket descriptor spreads the sockets as the hash */
+    netdev = netdev_policy_select(socket_policy(sock), (uint32_t) sock->socket, socket_netdev_filter, sock);
+    if (netdev)
+    {
+        socket_netdev_set(sock, netdev);
+        return 0;
+    }
+#endif
+
     if (netdv_def && netdev_is_up(netdv_def))
     {
         /* check default network interface device protocol family */
         pf = (struct sal_proto_family *) netdv_def->sal_user_data;
         if (pf != RT_NULL && pf->skt_ops && (pf->family == family || pf->sec_family == family))
         {
-            sock->netdev = netdv_def;
+            socket_netdev_set(sock, netdv_def);
             flag = RT_TRUE;
         }
     }
@@ -437,7 +524,7 @@ static int socket_init(int family, int type, int protocol, struct sal_socket **r
             return -3;
         }
 
-        sock->netdev = netdev;
+        socket_netdev_set(sock, netdev);
     }
 
     return 0;
@@ -529,6 +616,13 @@ static int socket_new(void)
 #ifdef SAL_USING_TLS
     sock->user_data_tls = RT_NULL;
 #endif
+#ifdef SAL_USING_LWIP_FASTPATH
+    sock->fastpath = RT_NULL;
+#endif
+#ifdef NETDEV_USING_POLICY
+    sock->policy = -1;
+    sock->policy_flags = 0;
+#endif
 
 __result:
     sal_unlock();
@@ -550,11 +644,116 @@ static void socket_delete(int socket)
     sock = sal_get_socket(socket);
     RT_ASSERT(sock != RT_NULL);
     sock->magic = 0;
-    sock->netdev = RT_NULL;
+    socket_netdev_set(sock, RT_NULL);
     socket_free(st, idx);
     sal_unlock();
 }
 
+#ifdef SAL_USING_LWIP_FASTPATH
+/* use the data path of the protocol stack when the socket supports it, the
+ * stack object is looked up by the socket descriptor on every call */
+static void socket_fastpath_attach(struct sal_socket *sock, struct sal_proto_family *pf)
+{
+    sock->fastpath = RT_NULL;
+
+#ifdef SAL_USING_TLS
+    if (IS_SOCKET_PROTO_TLS(sock))
+    {
+        return;
+    }
+#endif
+
+    if (pf->fastpath_ops && pf->fastpath_ops->attach)
+    {
+        if (pf->fastpath_ops->attach((int) sock->user_data) == 0)
+        {
+            sock->fastpath = pf->fastpath_ops;
+        }
+    }
+}
+#else
+#define socket_fastpath_attach(sock, pf)
+#endif /* SAL_USING_LWIP_FASTPATH */
+
+/* bind the protocol socket to the IPv4 address of network interface device, the
+ * packets are routed by the source address in the protocol stack, and the AT
+ * socket is re-created on the AT device of this address */
+static int socket_netdev_bind(struct sal_socket *sock)
+{
+    struct sal_proto_family *pf = (struct sal_proto_family *) sock->netdev->sal_user_data;
+    struct sockaddr_in local;
+
+    if (pf->skt_ops->bind == RT_NULL || (pf->family != AF_INET && pf->family != AF_AT))
+    {
+        return 0;
+    }
+
+    rt_memset(&local, 0x00, sizeof(local));
+    local.sin_len = sizeof(local);
+    local.sin_family = AF_INET;
+    local.sin_port = 0;
+#if NETDEV_IPV4 && NETDEV_IPV6
+    if (sock->netdev->ip_addr.type != IPADDR_TYPE_V4)
+    {
+        return 0;
+    }
+    local.sin_addr.s_addr = sock->netdev->ip_addr.u_addr.ip4.addr;
+#elif NETDEV_IPV4
+    local.sin_addr.s_addr = sock->netdev->ip_addr.addr;
+#endif
+
+    if (pf->skt_ops->bind((int) sock->user_data, (struct sockaddr *) &local, sizeof(local)) < 0)
+    {
+        LOG_D("bind socket(%d) to network interface device(%s) failed.", sock->socket, sock->netdev->name);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* move the socket to another network interface device, the protocol socket is
+ * re-created if the protocol family is different or it is an AT socket */
+static int socket_netdev_move(struct sal_socket *sock, struct netdev *netdev)
+{
+    struct sal_proto_family *local_pf, *input_pf;
+    int new_socket;
+
+    local_pf = (struct sal_proto_family *) sock->netdev->sal_user_data;
+    input_pf = (struct sal_proto_family *) netdev->sal_user_data;
+
+    if (input_pf->family != local_pf->family)
+    {
+        new_socket = input_pf->skt_ops->socket(input_pf->family, sock->type, sock->protocol);
+        if (new_socket < 0)
+        {
+            return -1;
+        }
+        local_pf->skt_ops->closesocket((int) sock->user_data);
+
+        sock->user_data = (void *) new_socket;
+        socket_netdev_set(sock, netdev);
+        socket_fastpath_attach(sock, input_pf);
+    }
+    else if (input_pf->family == AF_AT && netdev != sock->netdev)
+    {
+        struct netdev *old_netdev = sock->netdev;
+
+        /* the AT socket belongs to the AT device where it is created */
+        socket_netdev_set(sock, netdev);
+        if (socket_netdev_bind(sock) < 0)
+        {
+            socket_netdev_set(sock, old_netdev);
+            return -1;
+        }
+    }
+    else
+    {
+        socket_netdev_set(sock, netdev);
+    }
+
+    return 0;
+}
+
 int sal_accept(int socket, struct sockaddr *addr, socklen_t *addrlen)
 {
     int new_socket;
@@ -594,8 +793,11 @@ int sal_accept(int socket, struct sockaddr *addr, socklen_t *addrlen)
             return -1;
         }
 
+        /* the accepted socket is on the network interface device of listening socket */
+        socket_netdev_set(new_sock, sock->netdev);
         /* socket structure user_data used to store the acquired new socket */
         new_sock->user_data = (void *) new_socket;
+        socket_fastpath_attach(new_sock, pf);
 
         return new_sal_socket;
     }
@@ -647,22 +849,14 @@ int sal_bind(int socket, const struct sockaddr *name, socklen_t namelen)
         SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, local_pf, bind);
         SAL_NETDEV_SOCKETOPS_VALID(new_netdev, input_pf, bind);
 
-        /* check the network interface protocol family type */
-        if (input_pf->family != local_pf->family)
+        /* protocol family is different, close old socket and create new socket by input ip address */
+        if (socket_netdev_move(sock, new_netdev) < 0)
         {
-            int new_socket = -1;
-
-            /* protocol family is different, close old socket and create new socket by input ip address */
-            local_pf->skt_ops->closesocket(socket);
-
-            new_socket = input_pf->skt_ops->socket(input_pf->family, sock->type, sock->protocol);
-            if (new_socket < 0)
-            {
-                return -1;
-            }
-            sock->netdev = new_netdev;
-            sock->user_data = (void *) new_socket;
+            return -1;
         }
+#ifdef NETDEV_USING_POLICY
+        sock->policy_flags |= SAL_POLICY_BOUND;
+#endif
     }
 
     /* check and get protocol families by the network interface device */
@@ -747,6 +941,90 @@ int sal_getsockopt(int socket, int level, int optname, void *optval, socklen_t *
     return pf->skt_ops->getsockopt((int) sock->user_data, level, optname, optval, optlen);
 }
 
+#ifdef NETDEV_USING_POLICY
+/* select the network interface device of new connection by the policy */
+static void socket_policy_route(struct sal_socket *sock, const struct sockaddr *name)
+{
+    const struct sockaddr_in *sin = (const struct sockaddr_in *) name;
+    enum netdev_policy policy = socket_policy(sock);
+    struct netdev *netdev, *old_netdev = sock->netdev;
+    uint32_t hash;
+
+    if (sock->policy_flags & SAL_POLICY_BOUND)
+    {
+        return;
+    }
+
+    if ((sock->policy_flags & SAL_POLICY_DEVICE) == 0 && name->sa_family == AF_INET)
+    {
+        /* the connections to the same peer are spread by the socket descriptor */
+        hash = sin->sin_addr.s_addr ^ ((uint32_t) sin->sin_port << 16) ^ ((uint32_t) sock->socket * 2654435761U);
+        netdev = netdev_policy_select(policy, hash, socket_netdev_filter, sock);
+        if (netdev && netdev != old_netdev && socket_netdev_move(sock, netdev) == 0)
+        {
+            if (!netdev_policy_available(old_netdev))
+            {
+                netdev_policy_migrated(netdev);
+            }
+        }
+    }
+
+    /* the default policy goes to the default route of protocol stack */
+    if (policy != NETDEV_POLICY_DEFAULT || sock->netdev != old_netdev || (sock->policy_flags & SAL_POLICY_DEVICE))
+    {
+        socket_netdev_bind(sock);
+    }
+}
+
+static int socket_policy_setsockopt(struct sal_socket *sock, int optname, const void *optval, socklen_t optlen)
+{
+    char name[RT_NAME_MAX + 1];
+    struct netdev *netdev;
+    int policy;
+
+    if (optname == SO_NETDEV_POLICY)
+    {
+        if (optval == RT_NULL || optlen < sizeof(int))
+        {
+            return -1;
+        }
+
+        policy = *(const int *) optval;
+        if (policy < -1 || policy >= NETDEV_POLICY_MAX)
+        {
+            return -1;
+        }
+        sock->policy = policy;
+        return 0;
+    }
+
+    /* SO_BINDTODEVICE, the empty name removes the binding */
+    if (optval == RT_NULL || optlen == 0 || *(const char *) optval == '\0')
+    {
+        sock->policy_flags &= ~SAL_POLICY_DEVICE;
+        return 0;
+    }
+
+    optlen = optlen > RT_NAME_MAX ? RT_NAME_MAX : optlen;
+    rt_memcpy(name, optval, optlen);
+    name[optlen] = '\0';
+
+    netdev = netdev_get_by_name(name);
+    if (netdev == RT_NULL || socket_netdev_filter(netdev, sock) == RT_FALSE)
+    {
+        return -1;
+    }
+
+    if (netdev != sock->netdev && socket_netdev_move(sock, netdev) < 0)
+    {
+        return -1;
+    }
+    sock->policy_flags |= SAL_POLICY_DEVICE;
+
+    return 0;
+}
+#endif /* NETDEV_USING_POLICY */
+
 int sal_setsockopt(int socket, int level, int optname, const void *optval, socklen_t optlen)
 {
     struct sal_socket *sock;
@@ -758,6 +1036,19 @@ int sal_setsockopt(int socket, int level, int optname, const void *optval, sockl
     /* check the network interface socket opreation */
     SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, setsockopt);
 
+#ifdef NETDEV_USING_POLICY
+    if (level == SOL_SOCKET && (optname == SO_BINDTODEVICE || optname == SO_NETDEV_POLICY))
+    {
+        return socket_policy_setsockopt(sock, optname, optval, optlen);
+    }
+#ifdef SAL_USING_TLS
+    if (level != SOL_TLS)
+#endif
+    {
+        sock->policy_flags |= SAL_POLICY_OPTIONS;
+    }
+#endif
+
 #ifdef SAL_USING_TLS
     if (level == SOL_TLS)
     {
@@ -799,19 +1090,46 @@ int sal_connect(int socket, const struct sockaddr *name, socklen_t namelen)
     struct sal_socket *sock;
     struct sal_proto_family *pf;
     int ret;
+#ifdef NETDEV_USING_POLICY
+    rt_tick_t tick;
+#endif
 
     /* get the socket object by socket descriptor */
     SAL_SOCKET_OBJ_GET(sock, socket);
 
+    /* the address is checked before the network interface device is selected by it */
+    if (name == RT_NULL || namelen < sizeof(struct sockaddr_in))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+#ifdef NETDEV_USING_POLICY
+    socket_policy_route(sock, name);
+    tick = rt_tick_get();
+#endif
+
     /* check the network interface is up status */
     SAL_NETDEV_IS_UP(sock->netdev);
     /* check the network interface socket opreation */
     SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, connect);
 
     ret = pf->skt_ops->connect((int) sock->user_data, name, namelen);
+#ifdef NETDEV_USING_POLICY
+    /* the latency of non-blocking connection is unknown */
+    if (ret >= 0 || errno != EINPROGRESS)
+    {
+        netdev_policy_connected(sock->netdev, rt_tick_get() - tick, ret >= 0 ? RT_TRUE : RT_FALSE);
+    }
+#endif
 #ifdef SAL_USING_TLS
     if (ret >= 0 && SAL_SOCKOPS_PROTO_TLS_VALID(sock, connect))
     {
+        if (proto_tls->ops->set_peer)
+        {
+            proto_tls->ops->set_peer(sock->user_data_tls, name, namelen);
+        }
+
         if (proto_tls->ops->connect(sock->user_data_tls) < 0)
         {
             return -1;
@@ -843,33 +1161,44 @@ int sal_recvfrom(int socket, void *mem, size_t len, int flags,
 {
     struct sal_socket *sock;
     struct sal_proto_family *pf;
+    int ret;
 
     /* get the socket object by socket descriptor */
     SAL_SOCKET_OBJ_GET(sock, socket);
 
     /* check the network interface is up status  */
     SAL_NETDEV_IS_UP(sock->netdev);
+
+#ifdef SAL_USING_LWIP_FASTPATH
+    if (sock->fastpath)
+    {
+        ret = sock->fastpath->recvfrom((int) sock->user_data, mem, len, flags, from, fromlen);
+        SAL_NETDEV_TRAFFIC(sock, 0, ret);
+        return ret;
+    }
+#endif
+
     /* check the network interface socket opreation */
     SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, recvfrom);
 
 #ifdef SAL_USING_TLS
     if (SAL_SOCKOPS_PROTO_TLS_VALID(sock, recv))
     {
-        int ret;
-
         if ((ret = proto_tls->ops->recv(sock->user_data_tls, mem, len)) < 0)
         {
             return -1;
         }
-        return ret;
     }
     else
     {
-        return pf->skt_ops->recvfrom((int) sock->user_data, mem, len, flags, from, fromlen);
+        ret = pf->skt_ops->recvfrom((int) sock->user_data, mem, len, flags, from, fromlen);
     }
 #else
-    return pf->skt_ops->recvfrom((int) sock->user_data, mem, len, flags, from, fromlen);
+    ret = pf->skt_ops->recvfrom((int) sock->user_data, mem, len, flags, from, fromlen);
 #endif
+
+    SAL_NETDEV_TRAFFIC(sock, 0, ret);
+    return ret;
 }
 
 int sal_sendto(int socket, const void *dataptr, size_t size, int flags,
@@ -877,94 +1206,597 @@ int sal_sendto(int socket, const void *dataptr, size_t size, int flags,
 {
     struct sal_socket *sock;
     struct sal_proto_family *pf;
+    int ret;
 
     /* get the socket object by socket descriptor */
     SAL_SOCKET_OBJ_GET(sock, socket);
 
     /* check the network interface is up status  */
     SAL_NETDEV_IS_UP(sock->netdev);
+
+#ifdef SAL_USING_LWIP_FASTPATH
+    if (sock->fastpath)
+    {
+        ret = sock->fastpath->sendto((int) sock->user_data, dataptr, size, flags, to, tolen);
+        SAL_NETDEV_TRAFFIC(sock, ret, 0);
+        return ret;
+    }
+#endif
+
     /* check the network interface socket opreation */
     SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, sendto);
 
 #ifdef SAL_USING_TLS
     if (SAL_SOCKOPS_PROTO_TLS_VALID(sock, send))
     {
-        int ret;
-
         if ((ret = proto_tls->ops->send(sock->user_data_tls, dataptr, size)) < 0)
         {
             return -1;
         }
-        return ret;
     }
     else
     {
-        return pf->skt_ops->sendto((int) sock->user_data, dataptr, size, flags, to, tolen);
+        ret = pf->skt_ops->sendto((int) sock->user_data, dataptr, size, flags, to, tolen);
     }
 #else
-    return pf->skt_ops->sendto((int) sock->user_data, dataptr, size, flags, to, tolen);
+    ret = pf->skt_ops->sendto((int) sock->user_data, dataptr, size, flags, to, tolen);
+#endif
+
+    SAL_NETDEV_TRAFFIC(sock, ret, 0);
+    return ret;
+}
+
+/* the message operations of protocol stack are used unless the data goes through TLS */
+static const struct sal_socket_ops *socket_msg_ops(struct sal_socket *sock, struct sal_proto_family *pf)
+{
+#ifdef SAL_USING_TLS
+    if (IS_SOCKET_PROTO_TLS(sock))
+    {
+        return RT_NULL;
+    }
 #endif
+
+    return pf->skt_ops;
 }
 
-int sal_socket(int domain, int type, int protocol)
+static size_t socket_msg_len(const struct msghdr *message)
+{
+    size_t len = 0;
+    int index;
+
+    for (index = 0; index < message->msg_iovlen; index++)
+    {
+        len += message->msg_iov[index].iov_len;
+    }
+
+    return len;
+}
+
+int sal_sendmsg(int socket, const struct msghdr *message, int flags)
 {
-    int retval;
-    int socket, proto_socket;
     struct sal_socket *sock;
     struct sal_proto_family *pf;
+    const struct sal_socket_ops *ops;
+    size_t len, offset;
+    char *buf;
+    int index, ret;
 
-    /* allocate a new socket and registered socket options */
-    socket = socket_new();
-    if (socket < 0)
+    if (message == RT_NULL || (message->msg_iovlen > 0 && message->msg_iov == RT_NULL))
     {
         return -1;
     }
 
-    /* get sal socket object by socket descriptor */
-    sock = sal_get_socket(socket);
-    if (sock == RT_NULL)
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+    /* check the network interface socket opreation */
+    SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, sendto);
+
+    ops = socket_msg_ops(sock, pf);
+    if (ops && ops->sendmsg)
     {
-        return -1;
+        return ops->sendmsg((int) sock->user_data, message, flags);
     }
 
-    /* Initialize sal socket object */
-    retval = socket_init(domain, type, protocol, &sock);
-    if (retval < 0)
+    if (message->msg_iovlen == 1)
     {
-        LOG_E("SAL socket protocol family input failed, return error %d.", retval);
-        socket_delete(socket);
-        return -1;
+        return sal_sendto(socket, message->msg_iov[0].iov_base, message->msg_iov[0].iov_len, flags,
+                          (const struct sockaddr *) message->msg_name, message->msg_namelen);
     }
 
-    /* valid the network interface socket opreation */
-    SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, socket);
+    /* gather the data, the datagram is sent once */
+    len = socket_msg_len(message);
+    buf = (char *) rt_malloc(len > 0 ? len : 1);
+    if (buf == RT_NULL)
+    {
+        return -1;
+    }
 
-    proto_socket = pf->skt_ops->socket(domain, type, protocol);
-    if (proto_socket >= 0)
+    for (index = 0, offset = 0; index < message->msg_iovlen; index++)
     {
-#ifdef SAL_USING_TLS
-        if (SAL_SOCKOPS_PROTO_TLS_VALID(sock, socket))
-        {
-            sock->user_data_tls = proto_tls->ops->socket(socket);
-            if (sock->user_data_tls == RT_NULL)
-            {
-                socket_delete(socket);
-                return -1;
-            }
-        }
-#endif
-        sock->user_data = (void *) proto_socket;
-        return sock->socket;
+        rt_memcpy(buf + offset, message->msg_iov[index].iov_base, message->msg_iov[index].iov_len);
+        offset += message->msg_iov[index].iov_len;
     }
 
-    return -1;
+    ret = sal_sendto(socket, buf, len, flags, (const struct sockaddr *) message->msg_name, message->msg_namelen);
+    rt_free(buf);
+
+    return ret;
 }
 
-int sal_closesocket(int socket)
+int sal_recvmsg(int socket, struct msghdr *message, int flags)
 {
     struct sal_socket *sock;
     struct sal_proto_family *pf;
-    int error = 0;
+    const struct sal_socket_ops *ops;
+    size_t len, offset, copy;
+    char *buf;
+    int index, ret;
+
+    if (message == RT_NULL || (message->msg_iovlen > 0 && message->msg_iov == RT_NULL))
+    {
+        return -1;
+    }
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+    /* check the network interface socket opreation */
+    SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, recvfrom);
+
+    ops = socket_msg_ops(sock, pf);
+    if (ops && ops->recvmsg)
+    {
+        return ops->recvmsg((int) sock->user_data, message, flags);
+    }
+
+    /* the ancillary data is not supported */
+    message->msg_controllen = 0;
+    message->msg_flags = 0;
+
+    if (message->msg_iovlen == 1)
+    {
+        return sal_recvfrom(socket, message->msg_iov[0].iov_base, message->msg_iov[0].iov_len, flags,
+                            (struct sockaddr *) message->msg_name, message->msg_name ? &(message->msg_namelen) : RT_NULL);
+    }
+
+    /* receive in a buffer and scatter the data */
+    len = socket_msg_len(message);
+    buf = (char *) rt_malloc(len > 0 ? len : 1);
+    if (buf == RT_NULL)
+    {
+        return -1;
+    }
+
+    ret = sal_recvfrom(socket, buf, len, flags, (struct sockaddr *) message->msg_name,
+                       message->msg_name ? &(message->msg_namelen) : RT_NULL);
+    for (index = 0, offset = 0; ret > 0 && index < message->msg_iovlen && offset < (size_t) ret; index++)
+    {
+        copy = message->msg_iov[index].iov_len;
+        if (copy > (size_t) ret - offset)
+        {
+            copy = (size_t) ret - offset;
+        }
+        rt_memcpy(message->msg_iov[index].iov_base, buf + offset, copy);
+        offset += copy;
+    }
+    rt_free(buf);
+
+    return ret;
+}
+
+int sal_sendmmsg(int socket, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    struct sal_socket *sock;
+    struct sal_proto_family *pf;
+    const struct sal_socket_ops *ops;
+    unsigned int index;
+    int ret;
+
+    if (msgvec == RT_NULL)
+    {
+        return -1;
+    }
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+    /* check the network interface socket opreation */
+    SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, sendto);
+
+    if (vlen == 0)
+    {
+        return 0;
+    }
+
+    /* the protocol stack sends the batch at once */
+    ops = socket_msg_ops(sock, pf);
+    if (ops && ops->sendmmsg)
+    {
+        return ops->sendmmsg((int) sock->user_data, msgvec, vlen, flags);
+    }
+
+    for (index = 0; index < vlen; index++)
+    {
+        ret = sal_sendmsg(socket, &(msgvec[index].msg_hdr), flags);
+        if (ret < 0)
+        {
+            break;
+        }
+        msgvec[index].msg_len = (unsigned int) ret;
+    }
+
+    return (index > 0) ? (int) index : -1;
+}
+
+int sal_recvmmsg(int socket, struct mmsghdr *msgvec, unsigned int vlen, int flags,
+                 struct timespec *timeout)
+{
+    struct sal_socket *sock;
+    rt_tick_t deadline = 0;
+    unsigned int index;
+    int ret;
+
+    if (msgvec == RT_NULL)
+    {
+        return -1;
+    }
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+
+    if (vlen == 0)
+    {
+        return 0;
+    }
+
+    if (timeout)
+    {
+        deadline = rt_tick_get() + timeout->tv_sec * RT_TICK_PER_SECOND +
+                   (rt_tick_t) ((rt_uint64_t) timeout->tv_nsec * RT_TICK_PER_SECOND / 1000000000UL);
+    }
+
+    for (index = 0; index < vlen; index++)
+    {
+        ret = sal_recvmsg(socket, &(msgvec[index].msg_hdr), flags & ~MSG_WAITFORONE);
+        if (ret < 0)
+        {
+            break;
+        }
+        msgvec[index].msg_len = (unsigned int) ret;
+
+        /* the connection is closed */
+        if (ret == 0 && sock->type == SOCK_STREAM)
+        {
+            return (int) index;
+        }
+
+        if (flags & MSG_WAITFORONE)
+        {
+            flags |= MSG_DONTWAIT;
+        }
+
+        /* the timeout is checked after each message is received */
+        if (timeout && (rt_int32_t) (rt_tick_get() - deadline) >= 0)
+        {
+            index++;
+            break;
+        }
+    }
+
+    return (index > 0) ? (int) index : -1;
+}
+
+#ifdef SAL_USING_NETBUF
+/* the buffers of protocol stack are used unless the data goes through TLS */
+static const struct sal_netbuf_ops *socket_netbuf_ops(struct sal_socket *sock)
+{
+    struct sal_proto_family *pf = (struct sal_proto_family *) sock->netdev->sal_user_data;
+
+#ifdef SAL_USING_TLS
+    if (IS_SOCKET_PROTO_TLS(sock))
+    {
+        return RT_NULL;
+    }
+#endif
+
+    return pf->netbuf_ops;
+}
+
+/* the copied buffer, the data follows the buffer structure */
+static struct sal_netbuf *socket_netbuf_copied(size_t size)
+{
+    struct sal_netbuf *buf;
+
+    buf = (struct sal_netbuf *) rt_malloc(sizeof(struct sal_netbuf) + size);
+    if (buf == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    rt_memset(buf, 0x00, sizeof(struct sal_netbuf));
+    buf->payload = (void *) (buf + 1);
+    buf->len = buf->tot_len = size;
+
+    return buf;
+}
+
+/**
+ * This function will allocate a network buffer to be filled in place and sent
+ * by sal_netbuf_send(). The buffer may be made up of several segments, they
+ * are visited by sal_netbuf_next().
+ *
+ * @param socket the socket descriptor
+ * @param size the data size of buffer
+ *
+ * @return the network buffer, or RT_NULL on failed
+ */
+struct sal_netbuf *sal_netbuf_alloc(int socket, size_t size)
+{
+    struct sal_socket *sock;
+    const struct sal_netbuf_ops *ops;
+    struct sal_netbuf *buf;
+
+    sock = sal_get_socket(socket);
+    if (sock == RT_NULL || size == 0)
+    {
+        return RT_NULL;
+    }
+
+    ops = socket_netbuf_ops(sock);
+    if (ops == RT_NULL || ops->alloc == RT_NULL)
+    {
+        return socket_netbuf_copied(size);
+    }
+
+    buf = (struct sal_netbuf *) rt_calloc(1, sizeof(struct sal_netbuf));
+    if (buf == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    buf->ops = ops;
+    if (ops->alloc((int) sock->user_data, buf, size) < 0)
+    {
+        rt_free(buf);
+        return RT_NULL;
+    }
+
+    return buf;
+}
+
+/**
+ * This function will send the data of a network buffer, the buffer is released
+ * whether it is sent or not. The datagram is sent without copy, the stream
+ * socket may copy the data to its own segments.
+ *
+ * @param socket the socket descriptor
+ * @param buf the buffer allocated by sal_netbuf_alloc() or received
+ * @param size the data size to send, from the start of buffer
+ * @param flags the flags of send
+ * @param to the destination address, RT_NULL for the connected socket
+ * @param tolen the length of destination address
+ *
+ * @return the size sent, or -1 on failed
+ */
+int sal_netbuf_send(int socket, struct sal_netbuf *buf, size_t size, int flags,
+                    const struct sockaddr *to, socklen_t tolen)
+{
+    struct sal_socket *sock;
+    const struct sal_netbuf_ops *ops;
+    int ret = -1;
+
+    if (buf == RT_NULL)
+    {
+        return -1;
+    }
+
+    sock = sal_get_socket(socket);
+    if (sock == RT_NULL || size > buf->tot_len || !netdev_is_up(sock->netdev))
+    {
+        goto __exit;
+    }
+
+    ops = socket_netbuf_ops(sock);
+    if (buf->ops && buf->ops == ops && ops->sendto)
+    {
+        ret = ops->sendto((int) sock->user_data, buf, size, flags, to, tolen);
+    }
+    else if (buf->ops == RT_NULL)
+    {
+        /* the copied buffer has only one segment */
+        ret = sal_sendto(socket, buf->payload, size, flags, to, tolen);
+    }
+
+__exit:
+    sal_netbuf_free(buf);
+
+    return ret;
+}
+
+/**
+ * This function will receive the data in a network buffer, the buffer refers
+ * to the data kept by protocol stack without copy and it must be released by
+ * sal_netbuf_free() or sal_netbuf_send().
+ *
+ * @param socket the socket descriptor
+ * @param buf the network buffer received
+ * @param flags the flags of receive, MSG_PEEK is not supported by the buffer
+ *              of protocol stack
+ * @param from the source address, it can be RT_NULL
+ * @param fromlen the length of source address
+ *
+ * @note Without the buffer operations of protocol stack, the data is copied into
+ *       a buffer of SAL_NETBUF_COPY_SIZE or the size of FIONREAD if it's larger.
+ *
+ * @return the size received, 0 on the connection closed, or -1 on failed
+ */
+int sal_netbuf_recv(int socket, struct sal_netbuf **buf, int flags,
+                    struct sockaddr *from, socklen_t *fromlen)
+{
+    struct sal_socket *sock;
+    const struct sal_netbuf_ops *ops;
+    struct sal_netbuf *netbuf;
+    int ret;
+
+    RT_ASSERT(buf);
+    *buf = RT_NULL;
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+
+    ops = socket_netbuf_ops(sock);
+    if (ops && ops->recvfrom)
+    {
+        netbuf = (struct sal_netbuf *) rt_calloc(1, sizeof(struct sal_netbuf));
+        if (netbuf == RT_NULL)
+        {
+            return -1;
+        }
+
+        netbuf->ops = ops;
+        ret = ops->recvfrom((int) sock->user_data, netbuf, flags, from, fromlen);
+    }
+    else
+    {
+        struct sal_proto_family *pf = (struct sal_proto_family *) sock->netdev->sal_user_data;
+        int size = 0;
+
+        /* the datagram larger than the copied buffer would be truncated, it's
+         * sized by the pending data when the stack reports it */
+        if (pf->skt_ops->ioctlsocket == RT_NULL ||
+            pf->skt_ops->ioctlsocket((int) sock->user_data, FIONREAD, &size) < 0 ||
+            size < SAL_NETBUF_COPY_SIZE)
+        {
+            size = SAL_NETBUF_COPY_SIZE;
+        }
+
+        netbuf = socket_netbuf_copied(size);
+        if (netbuf == RT_NULL)
+        {
+            return -1;
+        }
+
+        ret = sal_recvfrom(socket, netbuf->payload, size, flags, from, fromlen);
+        if (ret > 0)
+        {
+            netbuf->len = netbuf->tot_len = ret;
+        }
+    }
+
+    if (ret <= 0)
+    {
+        rt_free(netbuf);
+        return ret;
+    }
+
+    *buf = netbuf;
+
+    return ret;
+}
+
+/**
+ * This function will move the current segment of network buffer to the next.
+ *
+ * @param buf the network buffer
+ *
+ * @return 0 on the next segment, -1 on the end of buffer
+ */
+int sal_netbuf_next(struct sal_netbuf *buf)
+{
+    if (buf && buf->ops && buf->ops->next)
+    {
+        return buf->ops->next(buf);
+    }
+
+    return -1;
+}
+
+/**
+ * This function will release a network buffer and the data of protocol stack.
+ *
+ * @param buf the network buffer
+ */
+void sal_netbuf_free(struct sal_netbuf *buf)
+{
+    if (buf == RT_NULL)
+    {
+        return;
+    }
+
+    if (buf->ops && buf->ops->free)
+    {
+        buf->ops->free(buf);
+    }
+    rt_free(buf);
+}
+#endif /* SAL_USING_NETBUF */
+
+int sal_socket(int domain, int type, int protocol)
+{
+    int retval;
+    int socket, proto_socket;
+    struct sal_socket *sock;
+    struct sal_proto_family *pf;
+
+    /* allocate a new socket and registered socket options */
+    socket = socket_new();
+    if (socket < 0)
+    {
+        return -1;
+    }
+
+    /* get sal socket object by socket descriptor */
+    sock = sal_get_socket(socket);
+    if (sock == RT_NULL)
+    {
+        return -1;
+    }
+
+    /* Initialize sal socket object */
+    retval = socket_init(domain, type, protocol, &sock);
+    if (retval < 0)
+    {
+        LOG_E("SAL socket protocol family input failed, return error %d.", retval);
+        socket_delete(socket);
+        return -1;
+    }
+
+    /* valid the network interface socket opreation */
+    SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, socket);
+
+    proto_socket = pf->skt_ops->socket(domain, type, protocol);
+    if (proto_socket >= 0)
+    {
+#ifdef SAL_USING_TLS
+        if (SAL_SOCKOPS_PROTO_TLS_VALID(sock, socket))
+        {
+            sock->user_data_tls = proto_tls->ops->socket(socket);
+            if (sock->user_data_tls == RT_NULL)
+            {
+                socket_delete(socket);
+                return -1;
+            }
+        }
+#endif
+        sock->user_data = (void *) proto_socket;
+        socket_fastpath_attach(sock, pf);
+        return sock->socket;
+    }
+
+    return -1;
+}
+
+int sal_closesocket(int socket)
+{
+    struct sal_socket *sock;
+    struct sal_proto_family *pf;
+    int error = 0;
 
     /* get the socket object by socket descriptor */
     SAL_SOCKET_OBJ_GET(sock, socket);
@@ -1008,6 +1840,10 @@ int sal_ioctlsocket(int socket, long cmd, void *arg)
     /* check the network interface socket opreation */
     SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, ioctlsocket);
 
+#ifdef NETDEV_USING_POLICY
+    sock->policy_flags |= SAL_POLICY_OPTIONS;
+#endif
+
     return pf->skt_ops->ioctlsocket((int) sock->user_data, cmd, arg);
 }
 
@@ -1030,26 +1866,81 @@ int sal_poll(struct dfs_fd *file, struct rt_pollreq *req)
 }
 #endif
 
+#ifdef SAL_USING_DNS_CACHE
+/* the IPv4 address of hostent, the others aren't cached */
+static const ip4_addr_t *netdb_hostent_ip4addr(const struct hostent *host)
+{
+    const ip_addr_t *addr;
+
+    if (host->h_addr_list == RT_NULL || host->h_addr == RT_NULL || host->h_length != sizeof(ip_addr_t))
+    {
+        return RT_NULL;
+    }
+
+    addr = (const ip_addr_t *) host->h_addr;
+#if NETDEV_IPV4 && NETDEV_IPV6
+    return IP_IS_V4(addr) ? ip_2_ip4(addr) : RT_NULL;
+#else
+    return addr;
+#endif
+}
+
+/* the first IPv4 address of addrinfo, the others aren't cached */
+static const ip4_addr_t *netdb_addrinfo_ip4addr(const struct addrinfo *ai, ip4_addr_t *addr)
+{
+    for (; ai != RT_NULL; ai = ai->ai_next)
+    {
+        if (ai->ai_family == AF_INET && ai->ai_addr != RT_NULL)
+        {
+            addr->addr = ((const struct sockaddr_in *) ai->ai_addr)->sin_addr.s_addr;
+            return addr;
+        }
+    }
+
+    return RT_NULL;
+}
+#endif /* SAL_USING_DNS_CACHE */
+
 struct hostent *sal_gethostbyname(const char *name)
 {
     struct netdev *netdev = netdev_default;
     struct sal_proto_family *pf;
+#ifdef SAL_USING_DNS_CACHE
+    struct hostent *host;
+    ip4_addr_t addr;
+#endif
 
-    if (SAL_NETDEV_NETDBOPS_VALID(netdev, pf, gethostbyname))
-    {
-        return pf->netdb_ops->gethostbyname(name);
-    }
-    else
+    if (!SAL_NETDEV_NETDBOPS_VALID(netdev, pf, gethostbyname))
     {
         /* get the first network interface device with up status */
         netdev = netdev_get_first_by_flags(NETDEV_FLAG_UP);
-        if (SAL_NETDEV_NETDBOPS_VALID(netdev, pf, gethostbyname))
+        if (!SAL_NETDEV_NETDBOPS_VALID(netdev, pf, gethostbyname))
         {
-            return pf->netdb_ops->gethostbyname(name);
+            return RT_NULL;
         }
     }
 
-    return RT_NULL;
+#ifdef SAL_USING_DNS_CACHE
+    switch (sal_dns_cache_lookup(netdev, pf->family, name, &addr))
+    {
+    case SAL_DNS_CACHE_HIT:
+        return sal_dns_cache_hostent(name, &addr);
+
+    case SAL_DNS_CACHE_NEGATIVE:
+        return RT_NULL;
+
+    case SAL_DNS_CACHE_RESOLVE:
+        host = pf->netdb_ops->gethostbyname(name);
+        /* the failure of gethostbyname() may be the timeout, it isn't cached */
+        sal_dns_cache_update(netdev, pf->family, name, host ? netdb_hostent_ip4addr(host) : RT_NULL, host ? 0 : 1);
+        return host;
+
+    default:
+        break;
+    }
+#endif /* SAL_USING_DNS_CACHE */
+
+    return pf->netdb_ops->gethostbyname(name);
 }
 
 int sal_gethostbyname_r(const char *name, struct hostent *ret, char *buf,
@@ -1057,22 +1948,63 @@ int sal_gethostbyname_r(const char *name, struct hostent *ret, char *buf,
 {
     struct netdev *netdev = netdev_default;
     struct sal_proto_family *pf;
+#ifdef SAL_USING_DNS_CACHE
+    ip4_addr_t addr;
+    int errnum = 0, rc;
+#endif
 
-    if (SAL_NETDEV_NETDBOPS_VALID(netdev, pf, gethostbyname_r))
+    if (!SAL_NETDEV_NETDBOPS_VALID(netdev, pf, gethostbyname_r))
+    {
+        /* get the first network interface device with up status */
+        netdev = netdev_get_first_by_flags(NETDEV_FLAG_UP);
+        if (!SAL_NETDEV_NETDBOPS_VALID(netdev, pf, gethostbyname_r))
+        {
+            return -1;
+        }
+    }
+
+#ifdef SAL_USING_DNS_CACHE
+    if (name == RT_NULL || ret == RT_NULL || buf == RT_NULL || result == RT_NULL)
     {
         return pf->netdb_ops->gethostbyname_r(name, ret, buf, buflen, result, h_errnop);
     }
-    else
+
+    switch (sal_dns_cache_lookup(netdev, pf->family, name, &addr))
     {
-        /* get the first network interface device with up status */
-        netdev = netdev_get_first_by_flags(NETDEV_FLAG_UP);
-        if (SAL_NETDEV_NETDBOPS_VALID(netdev, pf, gethostbyname_r))
+    case SAL_DNS_CACHE_HIT:
+        return sal_dns_cache_hostent_r(name, &addr, ret, buf, buflen, result, h_errnop);
+
+    case SAL_DNS_CACHE_NEGATIVE:
+        *result = RT_NULL;
+        if (h_errnop)
+        {
+            *h_errnop = HOST_NOT_FOUND;
+        }
+        return -1;
+
+    case SAL_DNS_CACHE_RESOLVE:
+        rc = pf->netdb_ops->gethostbyname_r(name, ret, buf, buflen, result, &errnum);
+        if (rc == 0 && *result)
         {
-            return pf->netdb_ops->gethostbyname_r(name, ret, buf, buflen, result, h_errnop);
+            sal_dns_cache_update(netdev, pf->family, name, netdb_hostent_ip4addr(*result), 0);
         }
+        else
+        {
+            /* HOST_NOT_FOUND is also reported for the timeout, it isn't cached */
+            sal_dns_cache_update(netdev, pf->family, name, RT_NULL, 1);
+        }
+        if (h_errnop)
+        {
+            *h_errnop = errnum;
+        }
+        return rc;
+
+    default:
+        break;
     }
+#endif /* SAL_USING_DNS_CACHE */
 
-    return -1;
+    return pf->netdb_ops->gethostbyname_r(name, ret, buf, buflen, result, h_errnop);
 }
 
 int sal_getaddrinfo(const char *nodename,
@@ -1082,22 +2014,61 @@ int sal_getaddrinfo(const char *nodename,
 {
     struct netdev *netdev = netdev_default;
     struct sal_proto_family *pf;
+#ifdef SAL_USING_DNS_CACHE
+    ip4_addr_t addr;
+    char ipstr[16];
+    int rc;
+#endif
 
-    if (SAL_NETDEV_NETDBOPS_VALID(netdev, pf, getaddrinfo))
+    if (!SAL_NETDEV_NETDBOPS_VALID(netdev, pf, getaddrinfo))
+    {
+        /* get the first network interface device with up status */
+        netdev = netdev_get_first_by_flags(NETDEV_FLAG_UP);
+        if (!SAL_NETDEV_NETDBOPS_VALID(netdev, pf, getaddrinfo))
+        {
+            return -1;
+        }
+    }
+
+#ifdef SAL_USING_DNS_CACHE
+    /* only the IPv4 addresses are cached */
+    if (nodename == RT_NULL || res == RT_NULL ||
+        (hints && ((hints->ai_family != AF_UNSPEC && hints->ai_family != AF_INET) ||
+                   (hints->ai_flags & AI_NUMERICHOST))))
     {
         return pf->netdb_ops->getaddrinfo(nodename, servname, hints, res);
     }
-    else
+
+    switch (sal_dns_cache_lookup(netdev, pf->family, nodename, &addr))
     {
-        /* get the first network interface device with up status */
-        netdev = netdev_get_first_by_flags(NETDEV_FLAG_UP);
-        if (SAL_NETDEV_NETDBOPS_VALID(netdev, pf, getaddrinfo))
+    case SAL_DNS_CACHE_HIT:
+        /* the protocol stack allocates the addrinfo of the cached address without resolving */
+        netdev_ip4addr_ntoa_r(&addr, ipstr, sizeof(ipstr));
+        return pf->netdb_ops->getaddrinfo(ipstr, servname, hints, res);
+
+    case SAL_DNS_CACHE_NEGATIVE:
+        *res = RT_NULL;
+        return EAI_FAIL;
+
+    case SAL_DNS_CACHE_RESOLVE:
+        rc = pf->netdb_ops->getaddrinfo(nodename, servname, hints, res);
+        if (rc == 0)
+        {
+            sal_dns_cache_update(netdev, pf->family, nodename, netdb_addrinfo_ip4addr(*res, &addr), 0);
+        }
+        else
         {
-            return pf->netdb_ops->getaddrinfo(nodename, servname, hints, res);
+            /* only EAI_NONAME tells the name doesn't exist, EAI_FAIL may be the timeout */
+            sal_dns_cache_update(netdev, pf->family, nodename, RT_NULL, rc == EAI_NONAME ? -1 : 1);
         }
+        return rc;
+
+    default:
+        break;
     }
+#endif /* SAL_USING_DNS_CACHE */
 
-    return -1;
+    return pf->netdb_ops->getaddrinfo(nodename, servname, hints, res);
 }
 
 void sal_freeaddrinfo(struct addrinfo *ai)
@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-18     liujiahao    add the zero-copy area
  */
 #ifndef __VBUS_API_H__
 #define __VBUS_API_H__
@@ -78,6 +79,59 @@ enum rt_vbus_chn_status
 };
 #endif
 
+/* The zero-copy area is an optional shared memory besides the rings. The
+ * sender allocates a buffer in its area, fills the data into it and posts the
+ * descriptor referencing the buffer. The receiver uses the data in place and
+ * releases the buffer to the sender when it's done. */
+#define RT_VBUS_ZC_MAGIC     0x5642435A
+
+/* number of buffers in a zero-copy area, it should be the power of 2 */
+#ifndef RT_VBUS_ZC_BUF_NR
+#define RT_VBUS_ZC_BUF_NR    64
+#endif
+
+/* size of a buffer, including the head reserved for the receiver */
+#ifndef RT_VBUS_ZC_BUF_SZ
+#define RT_VBUS_ZC_BUF_SZ    2048
+#endif
+
+#define RT_VBUS_ZC_HEAD_SZ    16
+#define RT_VBUS_ZC_MAX_PKT_SZ (RT_VBUS_ZC_BUF_SZ - RT_VBUS_ZC_HEAD_SZ)
+
+#ifndef __ASSEMBLY__
+struct rt_vbus_zc_desc
+{
+    unsigned char id;
+    unsigned char qos;
+    unsigned short slot;
+    unsigned int len;
+    /* number of packets put into the ring before this buffer, the receiver
+     * gets them first so the packets are received in the posted order */
+    unsigned int ring_seq;
+} __attribute__((packed));
+
+struct rt_vbus_zc_area
+{
+    /* RT_VBUS_ZC_MAGIC after the sender has initialized the area. */
+    volatile unsigned int ready;
+    /* whether the sender is blocked on no free buffer. The receiver clears
+     * it and notifies the sender when it releases a buffer, the sender sets
+     * it again after reclaiming if it's still short of buffers. */
+    volatile unsigned int blocked;
+    /* The indexes are free running, the entry is at (idx % RT_VBUS_ZC_BUF_NR).
+     * The descriptors of posted buffers are put by the sender and got by the
+     * receiver. The released buffers are put by the receiver and got by the
+     * sender. */
+    volatile size_t put_idx;
+    volatile size_t get_idx;
+    volatile size_t free_put_idx;
+    volatile size_t free_get_idx;
+    struct rt_vbus_zc_desc descs[RT_VBUS_ZC_BUF_NR];
+    unsigned short free_slots[RT_VBUS_ZC_BUF_NR];
+    unsigned char bufs[RT_VBUS_ZC_BUF_NR][RT_VBUS_ZC_BUF_SZ];
+};
+#endif
+
 #undef BUILD_ASSERT
 /* borrowed from http://lxr.linux.no/linux+v2.6.26.5/include/linux/kernel.h#L494 */
 #define BUILD_ASSERT(condition) ((void)sizeof(char[1 - 2*!(condition)]))
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-11-04     Grissiom     add comment
+ * 2026-10-18     liujiahao    add zero-copy buffers, coalesce the notifications
  */
 
 #include <rthw.h>
@@ -102,7 +103,9 @@ struct rt_vbus_pkg {
     rt_uint8_t id;
     rt_uint8_t prio;
     rt_uint8_t finished;
-    rt_uint8_t len;
+    /* the data is a buffer in the zero-copy area */
+    rt_uint8_t zero_copy;
+    rt_uint16_t len;
     const void *data;
 };
 
@@ -177,6 +180,190 @@ static void _vbus_indicate(enum rt_vbus_event_id eve, unsigned char chnr)
         _vbus_rx_indi[eve][chnr].indicate(_vbus_rx_indi[eve][chnr].ctx);
 }
 
+#ifdef RT_VBUS_USING_ZERO_COPY
+#include <watermark_queue.h>
+struct rt_vbus_zc_area *RT_VBUS_ZC_OUT;
+struct rt_vbus_zc_area *RT_VBUS_ZC_IN;
+
+/* The level is the number of buffers in the out area not released by the
+ * other side. The allocating threads are suspended above the high mark and
+ * resumed at the low mark. */
+static struct rt_watermark_queue _zc_buf_wm;
+/* number of buffers released by the other side and reclaimed */
+static size_t _zc_reclaimed;
+/* buffers freed by this side without posting */
+static unsigned short _zc_local_slots[RT_VBUS_ZC_BUF_NR];
+static unsigned int _zc_local_nr;
+/* whether this side waits for the buffers from the high mark to the low mark */
+static int _zc_waiting;
+
+rt_inline int _zc_buf_in(struct rt_vbus_zc_area *area, const void *buf)
+{
+    return area &&
+           (const char*)buf >= (const char*)area->bufs &&
+           (const char*)buf < (const char*)area->bufs + sizeof(area->bufs);
+}
+
+rt_inline unsigned int _zc_buf_slot(struct rt_vbus_zc_area *area, const void *buf)
+{
+    return ((const char*)buf - RT_VBUS_ZC_HEAD_SZ - (const char*)area->bufs)
+           / RT_VBUS_ZC_BUF_SZ;
+}
+
+/* Reclaim the buffers released by the other side. */
+static void _zc_reclaim(void)
+{
+    rt_ubase_t lvl;
+    size_t nr;
+
+    while (1)
+    {
+        lvl = rt_hw_interrupt_disable();
+        rt_vbus_smp_rmb();
+        nr = RT_VBUS_ZC_OUT->free_put_idx - _zc_reclaimed;
+        _zc_reclaimed += nr;
+        rt_hw_interrupt_enable(lvl);
+
+        while (nr--)
+            rt_wm_que_dec(&_zc_buf_wm);
+
+        lvl = rt_hw_interrupt_disable();
+        if (!_zc_waiting)
+            break;
+
+        if (_zc_buf_wm.level <= _zc_buf_wm.low_mark)
+        {
+            /* Half of the buffers are released, stop the notifications. */
+            _zc_waiting = 0;
+            RT_VBUS_ZC_OUT->blocked = 0;
+            break;
+        }
+
+        /* The other side clears the flag when it notifies, so the buffers
+         * released before this one are notified once. Ask it again. */
+        if (RT_VBUS_ZC_OUT->blocked)
+            break;
+        RT_VBUS_ZC_OUT->blocked = 1;
+        rt_hw_interrupt_enable(lvl);
+
+        /* the buffers may be released before the other side sees the flag */
+        rt_vbus_smp_wmb();
+    }
+    rt_hw_interrupt_enable(lvl);
+}
+
+/* Release the buffer in the in area to the other side. */
+static void _zc_release(unsigned int slot)
+{
+    rt_ubase_t lvl;
+    int blocked;
+
+    lvl = rt_hw_interrupt_disable();
+    RT_VBUS_ZC_IN->free_slots[RT_VBUS_ZC_IN->free_put_idx % RT_VBUS_ZC_BUF_NR] = slot;
+    rt_vbus_smp_wmb();
+    RT_VBUS_ZC_IN->free_put_idx++;
+    rt_vbus_smp_wmb();
+
+    /* Notify once, the buffers released until the other side reclaims them
+     * don't notify again. It sets the flag again if it's still short. */
+    rt_vbus_smp_rmb();
+    blocked = RT_VBUS_ZC_IN->blocked;
+    if (blocked)
+        RT_VBUS_ZC_IN->blocked = 0;
+    rt_hw_interrupt_enable(lvl);
+
+    if (blocked)
+        rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
+}
+
+void *rt_vbus_buf_alloc(rt_size_t size, rt_int32_t timeout)
+{
+    rt_ubase_t lvl;
+    unsigned int slot;
+    int blocked = 0;
+
+    if (!RT_VBUS_ZC_OUT || !RT_VBUS_ZC_IN ||
+        RT_VBUS_ZC_IN->ready != RT_VBUS_ZC_MAGIC ||
+        size > RT_VBUS_ZC_MAX_PKT_SZ)
+        return RT_NULL;
+
+    if (rt_wm_que_inc(&_zc_buf_wm, timeout) != RT_EOK)
+        return RT_NULL;
+
+    lvl = rt_hw_interrupt_disable();
+    if (_zc_local_nr > 0)
+    {
+        slot = _zc_local_slots[--_zc_local_nr];
+    }
+    else
+    {
+        /* There is a reclaimed buffer at least, as the level is increased. */
+        RT_ASSERT(RT_VBUS_ZC_OUT->free_get_idx != _zc_reclaimed);
+        slot = RT_VBUS_ZC_OUT->free_slots[RT_VBUS_ZC_OUT->free_get_idx % RT_VBUS_ZC_BUF_NR];
+        RT_VBUS_ZC_OUT->free_get_idx++;
+    }
+    if (_zc_buf_wm.level > _zc_buf_wm.high_mark)
+    {
+        /* It's the last buffer, ask the other side to notify on releasing. */
+        RT_VBUS_ZC_OUT->blocked = 1;
+        _zc_waiting = 1;
+        blocked = 1;
+    }
+    rt_hw_interrupt_enable(lvl);
+
+    if (blocked)
+    {
+        /* the buffers may be released before the other side sees the flag */
+        rt_vbus_smp_wmb();
+        _zc_reclaim();
+    }
+
+    return RT_VBUS_ZC_OUT->bufs[slot] + RT_VBUS_ZC_HEAD_SZ;
+}
+
+void rt_vbus_buf_free(void *buf)
+{
+    rt_ubase_t lvl;
+
+    RT_ASSERT(_zc_buf_in(RT_VBUS_ZC_OUT, buf));
+
+    lvl = rt_hw_interrupt_disable();
+    _zc_local_slots[_zc_local_nr++] = _zc_buf_slot(RT_VBUS_ZC_OUT, buf);
+    rt_hw_interrupt_enable(lvl);
+
+    rt_wm_que_dec(&_zc_buf_wm);
+
+    /* It may reach the low mark without the buffers of the other side. */
+    lvl = rt_hw_interrupt_disable();
+    if (_zc_waiting && _zc_buf_wm.level <= _zc_buf_wm.low_mark)
+    {
+        _zc_waiting = 0;
+        RT_VBUS_ZC_OUT->blocked = 0;
+    }
+    rt_hw_interrupt_enable(lvl);
+}
+
+/* number of packets put into the out ring */
+static rt_uint32_t _bus_out_ring_seq;
+
+/* Put the descriptor of buffer into the out area. The descriptors will not
+ * overflow as they are no more than the buffers. */
+static void _bus_out_zc_put(struct rt_vbus_pkg *pkg)
+{
+    struct rt_vbus_zc_desc *desc;
+
+    desc = &RT_VBUS_ZC_OUT->descs[RT_VBUS_ZC_OUT->put_idx % RT_VBUS_ZC_BUF_NR];
+    desc->id   = pkg->id;
+    desc->qos  = pkg->prio;
+    desc->slot = _zc_buf_slot(RT_VBUS_ZC_OUT, pkg->data);
+    desc->len  = pkg->len;
+    desc->ring_seq = _bus_out_ring_seq;
+
+    rt_vbus_smp_wmb();
+    RT_VBUS_ZC_OUT->put_idx++;
+}
+#endif
+
 #define _BUS_OUT_THRD_STACK_SZ  2048
 #define _BUS_OUT_THRD_PRIO      8
 #define _BUS_OUT_PKG_NR         RT_VMM_RB_BLK_NR
@@ -184,6 +371,39 @@ static void _vbus_indicate(enum rt_vbus_event_id eve, unsigned char chnr)
 static struct rt_thread _bus_out_thread;
 static rt_uint8_t _bus_out_thread_stack[_BUS_OUT_THRD_STACK_SZ];
 struct rt_prio_queue *_bus_out_que;
+/* number of packages written but not notified to the other side */
+static unsigned int _bus_out_unkicked;
+
+static void _bus_out_kick(void)
+{
+    if (_bus_out_unkicked == 0)
+        return;
+
+    _bus_out_unkicked = 0;
+    rt_vbus_smp_wmb();
+    rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
+}
+
+/* The notification is coalesced until the out queue is drained. But the
+ * commands are notified at once, and the other side is notified when the ring
+ * is filled to RT_VBUS_RB_LOW_TICK or there are too many packages. A channel
+ * with the lower post water mark is notified more frequently. */
+static void _bus_out_written(unsigned char id)
+{
+    unsigned int step = RT_VBUS_RB_TICK_STEP;
+
+#ifdef RT_VBUS_USING_FLOW_CONTROL
+    if (_chn_wm_que[id].high_mark < step)
+        step = _chn_wm_que[id].high_mark + 1;
+#endif
+
+    _bus_out_unkicked++;
+    if (id == 0 || _bus_out_unkicked >= step ||
+        _bus_ring_space_nr(RT_VBUS_OUT_RING) < RT_VMM_RB_BLK_NR - RT_VBUS_RB_LOW_TICK)
+    {
+        _bus_out_kick();
+    }
+}
 
 static void _bus_out_entry(void *param)
 {
@@ -199,19 +419,50 @@ static void _bus_out_entry(void *param)
         return;
     }
 
-    while (rt_prio_queue_pop(_bus_out_que, &dpkg,
-                             RT_WAITING_FOREVER) == RT_EOK)
+    while (1)
     {
         int sp;
         rt_uint32_t nxtidx;
-        const int dnr = LEN2BNR(dpkg.len);
+        int dnr;
+
+        /* post the packages in batch, notify the other side when the queue
+         * is drained */
+        if (rt_prio_queue_pop(_bus_out_que, &dpkg, 0) != RT_EOK)
+        {
+            _bus_out_kick();
+            if (rt_prio_queue_pop(_bus_out_que, &dpkg,
+                                  RT_WAITING_FOREVER) != RT_EOK)
+                break;
+        }
 
 #ifdef RT_VBUS_USING_FLOW_CONTROL
         rt_wm_que_dec(&_chn_wm_que[dpkg.id]);
 #endif
 
         if (!_chn_connected(dpkg.id))
+        {
+#ifdef RT_VBUS_USING_ZERO_COPY
+            if (dpkg.zero_copy)
+                rt_vbus_buf_free((void*)dpkg.data);
+#endif
             continue;
+        }
+
+#ifdef RT_VBUS_USING_ZERO_COPY
+        if (dpkg.zero_copy)
+        {
+            vbus_debug("vmm bus out zero-copy"
+                       "(data: %p, len: %d, prio: %d, id: %d)\n",
+                       dpkg.data, dpkg.len, dpkg.prio, dpkg.id);
+
+            _bus_out_zc_put(&dpkg);
+            _bus_out_written(dpkg.id);
+            _vbus_indicate(RT_VBUS_EVENT_ID_TX, dpkg.id);
+            continue;
+        }
+#endif
+
+        dnr = LEN2BNR(dpkg.len);
 
         sp = _bus_ring_space_nr(RT_VBUS_OUT_RING);
 
@@ -228,6 +479,7 @@ static void _bus_out_entry(void *param)
             rt_vbus_smp_wmb();
 
             /* kick the guest, hoping this could force it do the work */
+            _bus_out_unkicked = 0;
             rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
 
             rt_thread_suspend(rt_thread_self());
@@ -274,9 +526,11 @@ static void _bus_out_entry(void *param)
             rt_vbus_smp_wmb();
             RT_VBUS_OUT_RING->put_idx = nxtidx;
         }
+#ifdef RT_VBUS_USING_ZERO_COPY
+        _bus_out_ring_seq++;
+#endif
 
-        rt_vbus_smp_wmb();
-        rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
+        _bus_out_written(dpkg.id);
 
         if (dpkg.finished)
         {
@@ -292,28 +546,9 @@ void rt_vbus_resume_out_thread(void)
     rt_schedule();
 }
 
-rt_err_t rt_vbus_post(rt_uint8_t id,
-                      rt_uint8_t prio,
-                      const void *data,
-                      rt_size_t size,
-                      rt_int32_t timeout)
+/* Wait for the channel resumed by the other side. */
+static rt_err_t _bus_post_wait(rt_uint8_t id, rt_int32_t timeout)
 {
-    rt_err_t err = RT_EOK;
-    struct rt_vbus_pkg pkg;
-    unsigned int putsz;
-    const unsigned char *dp;
-
-    if (!_bus_out_que)
-    {
-        rt_kprintf("post (data: %p, size: %d, timeout: %d) "
-                   "to bus before initialition\n",
-                   data, size, timeout);
-        return -RT_ERROR;
-    }
-
-    if (id >= RT_VBUS_CHANNEL_NR)
-        return -RT_ERROR;
-
     if (timeout != 0)
     {
         RT_DEBUG_IN_THREAD_CONTEXT;
@@ -355,9 +590,39 @@ rt_err_t rt_vbus_post(rt_uint8_t id,
     if (_chn_status[id] != RT_VBUS_CHN_ST_ESTABLISHED)
         return -RT_ERROR;
 
+    return RT_EOK;
+}
+
+rt_err_t rt_vbus_post(rt_uint8_t id,
+                      rt_uint8_t prio,
+                      const void *data,
+                      rt_size_t size,
+                      rt_int32_t timeout)
+{
+    rt_err_t err = RT_EOK;
+    struct rt_vbus_pkg pkg;
+    unsigned int putsz;
+    const unsigned char *dp;
+
+    if (!_bus_out_que)
+    {
+        rt_kprintf("post (data: %p, size: %d, timeout: %d) "
+                   "to bus before initialition\n",
+                   data, size, timeout);
+        return -RT_ERROR;
+    }
+
+    if (id >= RT_VBUS_CHANNEL_NR)
+        return -RT_ERROR;
+
+    err = _bus_post_wait(id, timeout);
+    if (err != RT_EOK)
+        return err;
+
     dp       = data;
     pkg.id   = id;
     pkg.prio = prio;
+    pkg.zero_copy = 0;
     for (putsz = 0; size; size -= putsz)
     {
         pkg.data = dp;
@@ -394,6 +659,47 @@ rt_err_t rt_vbus_post(rt_uint8_t id,
     return err;
 }
 
+#ifdef RT_VBUS_USING_ZERO_COPY
+rt_err_t rt_vbus_buf_post(rt_uint8_t id,
+                          rt_uint8_t prio,
+                          void *buf,
+                          rt_size_t size,
+                          rt_int32_t timeout)
+{
+    rt_err_t err;
+    struct rt_vbus_pkg pkg;
+
+    RT_ASSERT(_zc_buf_in(RT_VBUS_ZC_OUT, buf));
+
+    /* the commands on channel 0 are not posted in the zero-copy area */
+    if (!_bus_out_que || id == 0 || id >= RT_VBUS_CHANNEL_NR ||
+        size > RT_VBUS_ZC_MAX_PKT_SZ)
+        return -RT_ERROR;
+
+    err = _bus_post_wait(id, timeout);
+    if (err != RT_EOK)
+        return err;
+
+    pkg.id        = id;
+    pkg.prio      = prio;
+    pkg.finished  = 1;
+    pkg.zero_copy = 1;
+    pkg.len       = size;
+    pkg.data      = buf;
+
+#ifdef RT_VBUS_USING_FLOW_CONTROL
+    err = rt_wm_que_inc(&_chn_wm_que[id], timeout);
+    if (err != RT_EOK)
+        return err;
+#endif
+
+    vbus_debug("post zero-copy (data: %p, size: %d, timeout: %d)\n",
+               buf, size, timeout);
+
+    return rt_prio_queue_push(_bus_out_que, prio, &pkg, timeout);
+}
+#endif
+
 struct rt_completion _chn0_post_cmp;
 
 void _chn0_tx_listener(void *p)
@@ -553,6 +859,18 @@ struct rt_vbus_data* rt_vbus_data_pop(unsigned int id)
     return act;
 }
 
+void rt_vbus_data_free(struct rt_vbus_data *data)
+{
+#ifdef RT_VBUS_USING_ZERO_COPY
+    if (_zc_buf_in(RT_VBUS_ZC_IN, data + 1))
+    {
+        _zc_release(_zc_buf_slot(RT_VBUS_ZC_IN, data + 1));
+        return;
+    }
+#endif
+    rt_free(data);
+}
+
 /* dump cmd that is not start with ACK/NAK */
 static size_t __dump_naked_cmd(char *dst, size_t lsize,
                                unsigned char *dp, size_t dsize)
@@ -977,7 +1295,7 @@ Out:
 
 void rt_vbus_close_chn(unsigned char chnr)
 {
-    void *p;
+    struct rt_vbus_data *p;
     rt_err_t err;
     unsigned char buf[2];
 
@@ -1005,7 +1323,7 @@ void rt_vbus_close_chn(unsigned char chnr)
 
     /* cleanup the remaining data */
     for (p = rt_vbus_data_pop(chnr); p; p = rt_vbus_data_pop(chnr))
-        rt_free(p);
+        rt_vbus_data_free(p);
     /* FIXME: there is a chance that there are some data left on the send
      * buffer. So if we connect other channel with the same number immediately,
      * the new channel will receive some garbage data. However, this is highly
@@ -1016,104 +1334,220 @@ void rt_vbus_close_chn(unsigned char chnr)
 static unsigned int _total_data_sz;
 #endif
 
-static void _bus_in_entry(void *param)
+/* number of packets got from the in ring */
+static rt_uint32_t _bus_in_ring_seq;
+
+#ifdef RT_VBUS_USING_ZERO_COPY
+/* Whether the next buffer posted in the in area is received before the next
+ * packet in the in ring. The packets written in the ring before the buffer is
+ * posted are visible if the descriptor is visible. */
+static int _bus_in_zc_first(void)
 {
-    rt_sem_init(&_bus_in_sem, "vbus", 0, RT_IPC_FLAG_FIFO);
-    rt_event_init(&_bus_in_event, "vbus", RT_IPC_FLAG_FIFO);
-    rt_memset(_bus_in_action, 0, sizeof(_bus_in_action));
+    struct rt_vbus_zc_desc *desc;
 
-    while (rt_sem_take(&_bus_in_sem,
-                       RT_WAITING_FOREVER) == RT_EOK)
+    if (!RT_VBUS_ZC_IN || RT_VBUS_ZC_IN->ready != RT_VBUS_ZC_MAGIC ||
+        RT_VBUS_ZC_IN->get_idx == RT_VBUS_ZC_IN->put_idx)
+        return 0;
+
+    rt_vbus_smp_rmb();
+    if (RT_VBUS_IN_RING->get_idx == RT_VBUS_IN_RING->put_idx)
+        return 1;
+
+    desc = &RT_VBUS_ZC_IN->descs[RT_VBUS_ZC_IN->get_idx % RT_VBUS_ZC_BUF_NR];
+    return (rt_int32_t)(desc->ring_seq - _bus_in_ring_seq) <= 0;
+}
+
+/* Receive the next buffer posted in the in area, the data is used in place. */
+static rt_uint32_t _bus_in_zc_one(void)
+{
+    struct rt_vbus_zc_desc *desc;
+    struct rt_vbus_data *act;
+    unsigned int id, slot, len;
+
+    desc = &RT_VBUS_ZC_IN->descs[RT_VBUS_ZC_IN->get_idx % RT_VBUS_ZC_BUF_NR];
+    id   = desc->id;
+    slot = desc->slot;
+    len  = desc->len;
+
+    rt_vbus_smp_wmb();
+    RT_VBUS_ZC_IN->get_idx++;
+
+    vbus_debug("vmm bus in zero-copy: chnr %d, slot %d, size %d\n",
+               id, slot, len);
+
+    if (slot >= RT_VBUS_ZC_BUF_NR)
     {
-        rt_uint32_t event_set = 0;
+        vbus_error("drop on invalid slot %d\n", slot);
+        return 0;
+    }
 
-        /* while(not empty) */
-        while (RT_VBUS_IN_RING->get_idx != RT_VBUS_IN_RING->put_idx)
-        {
-            unsigned int id, nxtidx;
-            rt_size_t size;
-            struct rt_vbus_data *act;
+    /* Suspended channel can still recv data. */
+    if (id == 0 || id >= RT_VBUS_CHANNEL_NR || !_chn_connected(id) ||
+        len > RT_VBUS_ZC_MAX_PKT_SZ)
+    {
+        vbus_error("drop on invalid chn %d\n", id);
+        _zc_release(slot);
+        return 0;
+    }
 
-            rt_vbus_smp_rmb();
-            size = RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].len;
-            id = RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].id;
+#ifdef RT_VBUS_STATISTICS
+    _total_data_sz += len;
+#endif
 
-            vbus_debug("vmm bus in: chnr %d, size %d\n", id, size);
+    /* the head of data is placed in the reserved head of buffer */
+    act = (struct rt_vbus_data *)(RT_VBUS_ZC_IN->bufs[slot] + RT_VBUS_ZC_HEAD_SZ) - 1;
+    act->size = len;
+    act->next = RT_NULL;
 
-            /* Suspended channel can still recv data. */
-            if (id > RT_VBUS_CHANNEL_NR || !_chn_connected(id))
-            {
-                vbus_error("drop on invalid chn %d\n", id);
-                /* drop the invalid packet */
-                _ring_add_get_bnr(RT_VBUS_IN_RING, LEN2BNR(size));
-                continue;
-            }
+    rt_vbus_data_push(id, act);
 
-            if (id == 0)
-            {
-                if (size > 60)
-                    vbus_error("too big(%d) packet on chn0\n", size);
-                else
-                    _chn0_actor(RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].data, size);
-                _ring_add_get_bnr(RT_VBUS_IN_RING, LEN2BNR(size));
-                continue;
-            }
+    return 1 << id;
+}
+#endif
+
+/* Receive the next packet in the in ring. */
+static rt_uint32_t _bus_in_ring_one(int *ticked)
+{
+    unsigned int id, nxtidx;
+    rt_size_t size;
+    struct rt_vbus_data *act;
+
+    rt_vbus_smp_rmb();
+    size = RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].len;
+    id = RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].id;
+    _bus_in_ring_seq++;
+
+    vbus_debug("vmm bus in: chnr %d, size %d\n", id, size);
+
+    /* Suspended channel can still recv data. */
+    if (id > RT_VBUS_CHANNEL_NR || !_chn_connected(id))
+    {
+        vbus_error("drop on invalid chn %d\n", id);
+        /* drop the invalid packet */
+        _ring_add_get_bnr(RT_VBUS_IN_RING, LEN2BNR(size));
+        return 0;
+    }
+
+    if (id == 0)
+    {
+        if (size > 60)
+            vbus_error("too big(%d) packet on chn0\n", size);
+        else
+            _chn0_actor(RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].data, size);
+        _ring_add_get_bnr(RT_VBUS_IN_RING, LEN2BNR(size));
+        return 0;
+    }
 
 #ifdef RT_VBUS_STATISTICS
-            _total_data_sz += size;
+    _total_data_sz += size;
 #endif
 
-            act = rt_malloc(sizeof(*act) + size);
-            if (act == RT_NULL)
-            {
-                //vbus_error("drop on OOM (%d, %d)\n", id, size);
-                /* drop the packet on malloc fall */
-                _ring_add_get_bnr(RT_VBUS_IN_RING, LEN2BNR(size));
-                continue;
-            }
+    act = rt_malloc(sizeof(*act) + size);
+    if (act == RT_NULL)
+    {
+        //vbus_error("drop on OOM (%d, %d)\n", id, size);
+        /* drop the packet on malloc fall */
+        _ring_add_get_bnr(RT_VBUS_IN_RING, LEN2BNR(size));
+        return 0;
+    }
 
-            act->size = size;
-            act->next = RT_NULL;
+    act->size = size;
+    act->next = RT_NULL;
 
-            nxtidx = RT_VBUS_IN_RING->get_idx + LEN2BNR(size);
-            if (nxtidx >= RT_VMM_RB_BLK_NR)
-            {
-                unsigned int tailsz;
+    nxtidx = RT_VBUS_IN_RING->get_idx + LEN2BNR(size);
+    if (nxtidx >= RT_VMM_RB_BLK_NR)
+    {
+        unsigned int tailsz;
 
-                tailsz = (RT_VMM_RB_BLK_NR - RT_VBUS_IN_RING->get_idx)
-                          * sizeof(RT_VBUS_IN_RING->blks[0]) - RT_VBUS_BLK_HEAD_SZ;
+        tailsz = (RT_VMM_RB_BLK_NR - RT_VBUS_IN_RING->get_idx)
+                  * sizeof(RT_VBUS_IN_RING->blks[0]) - RT_VBUS_BLK_HEAD_SZ;
 
-                /* the remaining block is sufficient for the data */
-                if (tailsz > size)
-                    tailsz = size;
+        /* the remaining block is sufficient for the data */
+        if (tailsz > size)
+            tailsz = size;
 
-                rt_memcpy(act+1, &RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].data, tailsz);
-                rt_memcpy((char*)(act+1) + tailsz, &RT_VBUS_IN_RING->blks[0], size - tailsz);
+        rt_memcpy(act+1, &RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].data, tailsz);
+        rt_memcpy((char*)(act+1) + tailsz, &RT_VBUS_IN_RING->blks[0], size - tailsz);
 
-                /* It shall make sure the CPU has finished reading the item
-                 * before it writes the new tail pointer, which will erase the
-                 * item. */
-                rt_vbus_smp_wmb();
-                RT_VBUS_IN_RING->get_idx = nxtidx - RT_VMM_RB_BLK_NR;
-            }
-            else
-            {
-                rt_memcpy(act+1, &RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].data, size);
+        /* It shall make sure the CPU has finished reading the item
+         * before it writes the new tail pointer, which will erase the
+         * item. */
+        rt_vbus_smp_wmb();
+        RT_VBUS_IN_RING->get_idx = nxtidx - RT_VMM_RB_BLK_NR;
+    }
+    else
+    {
+        rt_memcpy(act+1, &RT_VBUS_IN_RING->blks[RT_VBUS_IN_RING->get_idx].data, size);
 
-                rt_vbus_smp_wmb();
-                RT_VBUS_IN_RING->get_idx = nxtidx;
-            }
+        rt_vbus_smp_wmb();
+        RT_VBUS_IN_RING->get_idx = nxtidx;
+    }
+
+    rt_vbus_data_push(id, act);
+
+    /* The writer of the other side is waiting for the space. Don't
+     * wait for the end of the batch if there is enough space. */
+    if (!*ticked && RT_VBUS_IN_RING->blocked &&
+        _bus_ring_space_nr(RT_VBUS_IN_RING) >= RT_VBUS_RB_LOW_TICK)
+    {
+        rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
+        *ticked = 1;
+    }
 
-            rt_vbus_data_push(id, act);
-            _vbus_indicate(RT_VBUS_EVENT_ID_RX, id);
-            event_set |= 1 << id;
+    return 1 << id;
+}
+
+static void _bus_in_entry(void *param)
+{
+    rt_sem_init(&_bus_in_sem, "vbus", 0, RT_IPC_FLAG_FIFO);
+    rt_event_init(&_bus_in_event, "vbus", RT_IPC_FLAG_FIFO);
+    rt_memset(_bus_in_action, 0, sizeof(_bus_in_action));
+
+    while (rt_sem_take(&_bus_in_sem,
+                       RT_WAITING_FOREVER) == RT_EOK)
+    {
+        rt_uint32_t event_set = 0;
+        int ticked = 0;
+        size_t get_idx = RT_VBUS_IN_RING->get_idx;
+        unsigned int chnr;
 
-            if (RT_VBUS_IN_RING->blocked)
-                rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
+#ifdef RT_VBUS_USING_ZERO_COPY
+        if (RT_VBUS_ZC_OUT)
+            _zc_reclaim();
+#endif
+
+        /* The ring packets and the zero-copy buffers are received in the
+         * order they are posted, so the packets of a channel are not
+         * reordered and the commands of channel 0 follow the data before. */
+        while (1)
+        {
+#ifdef RT_VBUS_USING_ZERO_COPY
+            if (_bus_in_zc_first())
+            {
+                event_set |= _bus_in_zc_one();
+                continue;
+            }
+#endif
+            if (RT_VBUS_IN_RING->get_idx == RT_VBUS_IN_RING->put_idx)
+                break;
+
+            event_set |= _bus_in_ring_one(&ticked);
         }
 
+        if (!ticked && RT_VBUS_IN_RING->blocked &&
+            RT_VBUS_IN_RING->get_idx != get_idx)
+            rt_vbus_tick(0, RT_VBUS_GUEST_VIRQ);
+
         if (event_set != 0)
+        {
+            /* indicate the packets received in the batch once */
+            for (chnr = 1; chnr < RT_VBUS_CHANNEL_NR; chnr++)
+            {
+                if (event_set & (1 << chnr))
+                    _vbus_indicate(RT_VBUS_EVENT_ID_RX, chnr);
+            }
             rt_vbus_notify_set(event_set);
+        }
     }
     RT_ASSERT(0);
 }
@@ -1145,6 +1579,10 @@ int rt_vbus_init(void *outr, void *inr)
 
     rt_memset(RT_VBUS_OUT_RING, 0, sizeof(*RT_VBUS_OUT_RING));
     rt_memset(RT_VBUS_IN_RING,  0, sizeof(*RT_VBUS_IN_RING));
+    _bus_in_ring_seq = 0;
+#ifdef RT_VBUS_USING_ZERO_COPY
+    _bus_out_ring_seq = 0;
+#endif
     _chn_status[0] = RT_VBUS_CHN_ST_ESTABLISHED;
     for (i = 1; i < ARRAY_SIZE(_chn_status); i++)
     {
@@ -1212,6 +1650,43 @@ int rt_vbus_init(void *outr, void *inr)
     return 0;
 }
 
+#ifdef RT_VBUS_USING_ZERO_COPY
+int rt_vbus_zc_init(void *outz, void *inz)
+{
+    struct rt_vbus_zc_area *area = outz;
+    int i;
+
+    BUILD_ASSERT(sizeof(struct rt_vbus_data) <= RT_VBUS_ZC_HEAD_SZ);
+    BUILD_ASSERT((RT_VBUS_ZC_BUF_NR & (RT_VBUS_ZC_BUF_NR - 1)) == 0);
+    BUILD_ASSERT(RT_VBUS_ZC_MAX_PKT_SZ <= 0xFFFF);
+
+    RT_ASSERT(area && inz);
+
+    /* The buffers are not cleared. All of them are free at first. */
+    rt_memset(area, 0, (char*)area->bufs - (char*)area);
+    for (i = 0; i < RT_VBUS_ZC_BUF_NR; i++)
+    {
+        area->free_slots[i] = i;
+    }
+    area->free_put_idx = RT_VBUS_ZC_BUF_NR;
+    _zc_reclaimed = RT_VBUS_ZC_BUF_NR;
+    _zc_local_nr = 0;
+    _zc_waiting = 0;
+    rt_wm_que_init(&_zc_buf_wm, RT_VBUS_ZC_BUF_NR / 2, RT_VBUS_ZC_BUF_NR - 1);
+
+    RT_VBUS_ZC_IN  = inz;
+    RT_VBUS_ZC_OUT = area;
+
+    rt_vbus_smp_wmb();
+    area->ready = RT_VBUS_ZC_MAGIC;
+
+    rt_kprintf("VBus zero-copy loaded: %d buffers of %d bytes\n",
+               RT_VBUS_ZC_BUF_NR, RT_VBUS_ZC_BUF_SZ);
+
+    return 0;
+}
+#endif
+
 void rt_vbus_rb_dump(void)
 {
     rt_kprintf("OUT ring:(%s blocked)\n", RT_VBUS_OUT_RING->blocked ? "is" : "not");
@@ -1224,6 +1699,25 @@ void rt_vbus_rb_dump(void)
     rt_kprintf("put idx: %8x, get idx: %8x\n",
                RT_VBUS_IN_RING->put_idx, RT_VBUS_IN_RING->get_idx);
     rt_kprintf("space: %d\n", _bus_ring_space_nr(RT_VBUS_IN_RING));
+
+#ifdef RT_VBUS_USING_ZERO_COPY
+    if (RT_VBUS_ZC_OUT)
+    {
+        rt_kprintf("OUT zero-copy area:(%s blocked)\n", RT_VBUS_ZC_OUT->blocked ? "is" : "not");
+        rt_kprintf("put idx: %8x, get idx: %8x, free put idx: %8x, free get idx: %8x\n",
+                   RT_VBUS_ZC_OUT->put_idx, RT_VBUS_ZC_OUT->get_idx,
+                   RT_VBUS_ZC_OUT->free_put_idx, RT_VBUS_ZC_OUT->free_get_idx);
+        rt_wm_que_dump(&_zc_buf_wm);
+    }
+    if (RT_VBUS_ZC_IN)
+    {
+        rt_kprintf("IN zero-copy area:(%s)\n",
+                   RT_VBUS_ZC_IN->ready == RT_VBUS_ZC_MAGIC ? "ready" : "not ready");
+        rt_kprintf("put idx: %8x, get idx: %8x, free put idx: %8x, free get idx: %8x\n",
+                   RT_VBUS_ZC_IN->put_idx, RT_VBUS_ZC_IN->get_idx,
+                   RT_VBUS_ZC_IN->free_put_idx, RT_VBUS_ZC_IN->free_get_idx);
+    }
+#endif
 }
 
 void rt_vbus_chn_dump(void)
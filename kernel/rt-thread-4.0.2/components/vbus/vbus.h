@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2014-06-09     Grissiom     version 2.0.2; add comment
  * 2015-01-06     Grissiom     version 2.0.3; API change, no functional changes
+ * 2026-10-18     liujiahao    add zero-copy buffers and notification coalescing
  */
 #ifndef __VBUS_H__
 #define __VBUS_H__
@@ -43,7 +44,7 @@ rt_err_t rt_vbus_post(rt_uint8_t chnr,
 
 struct rt_vbus_data {
     /* Number of bytes in current data package. */
-    unsigned char size;
+    rt_uint16_t size;
     /* Used internally in VBus. Don't modify this field as it may corrupt the
      * receive queue. */
     struct rt_vbus_data *next;
@@ -78,7 +79,8 @@ void rt_vbus_set_recv_wm(unsigned char chnr, unsigned int low, unsigned int high
 typedef void (*rt_vbus_event_listener)(void *ctx);
 
 enum rt_vbus_event_id {
-    /* On a packet received in channel. */
+    /* On packets received in channel. It's indicated once for all the packets
+     * received on the same interrupt. */
     RT_VBUS_EVENT_ID_RX,
     /* On the data of rt_vbus_post has been written to the ring buffer. */
     RT_VBUS_EVENT_ID_TX,
@@ -109,9 +111,51 @@ void rt_vbus_data_push(unsigned int chnr,
 /** Pop a data package from the receive queue of the channel @chnr.
  *
  * The actual data is following the struct rt_vbus_data. After using it, it
- * should be freed by rt_free.
+ * should be freed by rt_vbus_data_free.
  */
 struct rt_vbus_data* rt_vbus_data_pop(unsigned int chnr);
+/** Free a data package popped from the receive queue.
+ *
+ * The data package received in the zero-copy area is released to the sender,
+ * the others are freed by rt_free.
+ */
+void rt_vbus_data_free(struct rt_vbus_data *data);
+
+#ifdef RT_VBUS_USING_ZERO_COPY
+/** Init the zero-copy areas.
+ *
+ * @outz is the area of buffers posted by this side, it's initialized here.
+ * @inz is the area of buffers posted by the other side, it's initialized by
+ * the other side.
+ */
+int rt_vbus_zc_init(void *outz, void *inz);
+
+/** Allocate a buffer in the zero-copy area.
+ *
+ * @param size number of byte of the data, up to RT_VBUS_ZC_MAX_PKT_SZ
+ * @param timeout the ticks to wait for a buffer released by the other side
+ *
+ * @return the buffer to fill the data. RT_NULL if the other side doesn't
+ * support the zero-copy area or no buffer available in @timeout.
+ */
+void *rt_vbus_buf_alloc(rt_size_t size, rt_int32_t timeout);
+
+/** Free a buffer allocated by rt_vbus_buf_alloc but not posted. */
+void rt_vbus_buf_free(void *buf);
+
+/** Post a buffer allocated by rt_vbus_buf_alloc on channel without copying.
+ *
+ * The buffer is owned by VBus after it returns RT_EOK, it shall not be used
+ * any more. Otherwise it should be freed by rt_vbus_buf_free.
+ *
+ * @sa rt_vbus_post .
+ */
+rt_err_t rt_vbus_buf_post(rt_uint8_t chnr,
+                          rt_uint8_t prio,
+                          void *buf,
+                          rt_size_t size,
+                          rt_int32_t timeout);
+#endif
 
 struct rt_vbus_dev
 {
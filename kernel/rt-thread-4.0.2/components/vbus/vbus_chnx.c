@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2013-11-04     Grissiom     add comment
+ * 2026-10-18     liujiahao    free the data package by rt_vbus_data_free
  */
 
 #include <rthw.h>
@@ -100,7 +101,7 @@ static rt_size_t _read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t si
                 RT_ASSERT(0);
 
             /* free old and get new */
-            rt_free(vdev->act);
+            rt_vbus_data_free(vdev->act);
             vdev->act = rt_vbus_data_pop(vdev->chnr);
             vdev->pos = 0;
         }
@@ -8,6 +8,9 @@
  * 2014-04-16     Grissiom     first version
  */
 
+#ifndef __WATERMARK_QUEUE_H__
+#define __WATERMARK_QUEUE_H__
+
 struct rt_watermark_queue
 {
     /* Current water level. */
@@ -128,3 +131,5 @@ rt_inline void rt_wm_que_dec(struct rt_watermark_queue *wg)
     if (need_sched)
         rt_schedule();
 }
+
+#endif /* end of include guard: __WATERMARK_QUEUE_H__ */
@@ -0,0 +1,677 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * File system benchmark.
+ *
+ * Every job works on its own file "<path>/fsbench.<job>" in a thread, the files are
+ * written before the test. The patterns are sequential and random read/write with
+ * the block size, the queue depth more than 1 submits the requests by AIO.
+ *
+ *     msh />fsbench /sd -m randread -b 4k -s 1m -j 2 -q 4
+ *
+ * The RAM disk "ram0" is made by the command ramdisk, so the benchmark runs without
+ * storage, for example on the simulator:
+ *
+ *     msh />ramdisk 1024
+ *     msh />mkfs -t elm ram0
+ *     msh />mkdir /ram
+ *     msh />mount ram0 /ram elm
+ *     msh />fsbench /ram
+ *
+ * The latency of every request is measured by the CPU time if RT_USING_CPUTIME is
+ * enabled, otherwise by the OS tick.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(RT_USING_DFS) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <dfs_posix.h>
+#include <stdlib.h>
+
+#ifdef RT_USING_POSIX_AIO
+#include <posix_aio.h>
+#endif
+
+#define FSBENCH_JOB_MAX         8
+#define FSBENCH_QD_MAX          32
+
+#define MODE_READ               0x01
+#define MODE_RANDOM             0x02
+
+/* latency histogram: exact below 16us, then 8 buckets for every power of 2 */
+#define HIST_NUM                (16 + 28 * 8)
+
+struct fsbench
+{
+    const char *path;
+    int mode;
+    rt_uint32_t block_size;
+    rt_uint32_t file_size;
+    rt_uint32_t nr_ios;                 /* requests of every job */
+    int jobs;
+    int qd;
+
+    struct rt_semaphore done;
+};
+
+struct fsbench_job
+{
+    struct fsbench *bench;
+    int id;
+    int fd;
+    int error;
+    rt_uint32_t seed;
+    rt_uint8_t *buf;
+
+    rt_uint32_t ios;
+    rt_uint32_t lat_min;
+    rt_uint32_t lat_max;
+    rt_uint64_t lat_sum;
+    rt_uint32_t hist[HIST_NUM];
+};
+
+static rt_uint32_t fsbench_now(void)
+{
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_gettime();
+#else
+    return rt_tick_get();
+#endif
+}
+
+static rt_uint32_t fsbench_us(rt_uint32_t begin)
+{
+    rt_uint32_t elapsed = fsbench_now() - begin;
+
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_microsecond(elapsed);
+#else
+    return (rt_uint32_t)((rt_uint64_t)elapsed * 1000000 / RT_TICK_PER_SECOND);
+#endif
+}
+
+static int hist_index(rt_uint32_t us)
+{
+    int msb = 4;
+
+    if (us < 16)
+        return us;
+
+    while ((us >> msb) > 1)
+        msb ++;
+
+    return 16 + (msb - 4) * 8 + ((us >> (msb - 3)) & 0x07);
+}
+
+/* the middle value of the bucket */
+static rt_uint32_t hist_value(int index)
+{
+    int msb;
+
+    if (index < 16)
+        return index;
+
+    msb = (index - 16) / 8 + 4;
+    return ((rt_uint32_t)(8 + (index - 16) % 8) << (msb - 3)) + ((1UL << (msb - 3)) >> 1);
+}
+
+static void job_account(struct fsbench_job *job, rt_uint32_t us)
+{
+    job->ios ++;
+    job->lat_sum += us;
+    if (us < job->lat_min)
+        job->lat_min = us;
+    if (us > job->lat_max)
+        job->lat_max = us;
+    job->hist[hist_index(us)] ++;
+}
+
+static off_t job_offset(struct fsbench_job *job, rt_uint32_t index)
+{
+    struct fsbench *bench = job->bench;
+
+    if (!(bench->mode & MODE_RANDOM))
+        return (off_t)(index % (bench->file_size / bench->block_size)) * bench->block_size;
+
+    /* xorshift */
+    job->seed ^= job->seed << 13;
+    job->seed ^= job->seed >> 17;
+    job->seed ^= job->seed << 5;
+    return (off_t)(job->seed % (bench->file_size / bench->block_size)) * bench->block_size;
+}
+
+static void job_sync(struct fsbench_job *job)
+{
+    struct fsbench *bench = job->bench;
+    rt_uint32_t index, begin;
+    int length;
+
+    for (index = 0; index < bench->nr_ios; index ++)
+    {
+        off_t offset = job_offset(job, index);
+
+        /* the sequential pattern seeks only when it's wrapped */
+        begin = fsbench_now();
+        if (((bench->mode & MODE_RANDOM) || (offset == 0 && index > 0)) &&
+            lseek(job->fd, offset, SEEK_SET) != offset)
+        {
+            job->error = -EIO;
+            break;
+        }
+        if (bench->mode & MODE_READ)
+            length = read(job->fd, job->buf, bench->block_size);
+        else
+            length = write(job->fd, job->buf, bench->block_size);
+        if (length != (int)bench->block_size)
+        {
+            job->error = length < 0 ? rt_get_errno() : -EIO;
+            break;
+        }
+        job_account(job, fsbench_us(begin));
+    }
+}
+
+#ifdef RT_USING_POSIX_AIO
+static void job_aio(struct fsbench_job *job)
+{
+    struct fsbench *bench = job->bench;
+    struct aiocb *cbs;
+    rt_uint32_t begin[FSBENCH_QD_MAX];
+    rt_uint32_t submitted = 0, completed = 0;
+    int slot, result;
+
+    cbs = (struct aiocb *)rt_calloc(bench->qd, sizeof(struct aiocb));
+    if (cbs == RT_NULL)
+    {
+        job->error = -ENOMEM;
+        return;
+    }
+
+    while (completed < bench->nr_ios)
+    {
+        /* keep the queue full */
+        while (submitted < bench->nr_ios && submitted - completed < (rt_uint32_t)bench->qd)
+        {
+            struct aiocb *cb;
+
+            slot = submitted % bench->qd;
+            cb = &cbs[slot];
+            cb->aio_fildes = job->fd;
+            cb->aio_offset = job_offset(job, submitted);
+            cb->aio_buf = job->buf + slot * bench->block_size;
+            cb->aio_nbytes = bench->block_size;
+
+            begin[slot] = fsbench_now();
+            if (bench->mode & MODE_READ)
+                result = aio_read(cb);
+            else
+                result = aio_write(cb);
+            if (result != 0)
+            {
+                job->error = result;
+                goto __exit;
+            }
+            submitted ++;
+        }
+
+        /* the requests are completed in order by the AIO work queue */
+        {
+            const struct aiocb *list[1];
+
+            slot = completed % bench->qd;
+            list[0] = &cbs[slot];
+            while (aio_error(&cbs[slot]) == -EINPROGRESS)
+                aio_suspend(list, 1, RT_NULL);
+        }
+        if (aio_return(&cbs[slot]) != (int)bench->block_size)
+        {
+            job->error = -EIO;
+            completed ++;
+            break;
+        }
+        job_account(job, fsbench_us(begin[slot]));
+        completed ++;
+    }
+
+__exit:
+    /* the requests in the queue use the buffer */
+    while (completed < submitted)
+    {
+        const struct aiocb *list[1];
+
+        slot = completed % bench->qd;
+        list[0] = &cbs[slot];
+        while (aio_error(&cbs[slot]) == -EINPROGRESS)
+            aio_suspend(list, 1, RT_NULL);
+        completed ++;
+    }
+    rt_free(cbs);
+}
+#endif
+
+static void job_entry(void *parameter)
+{
+    struct fsbench_job *job = (struct fsbench_job *)parameter;
+    struct fsbench *bench = job->bench;
+
+#ifdef RT_USING_POSIX_AIO
+    if (bench->qd > 1)
+        job_aio(job);
+    else
+#endif
+        job_sync(job);
+
+    /* the time of sync is in the run time */
+    if (!(bench->mode & MODE_READ) && job->error == 0)
+        fsync(job->fd);
+
+    rt_sem_release(&bench->done);
+}
+
+/* write the file of job before the test */
+static int job_layout(struct fsbench *bench, int id, rt_uint8_t *buf)
+{
+    char name[DFS_PATH_MAX];
+    struct stat st;
+    rt_uint32_t offset;
+    int fd;
+
+    rt_snprintf(name, sizeof(name), "%s/fsbench.%d", bench->path, id);
+    if (stat(name, &st) == 0 && st.st_size >= bench->file_size)
+        return 0;
+
+    fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0);
+    if (fd < 0)
+        return -1;
+
+    for (offset = 0; offset < bench->file_size; offset += bench->block_size)
+    {
+        if (write(fd, buf, bench->block_size) != (int)bench->block_size)
+        {
+            close(fd);
+            return -1;
+        }
+    }
+    close(fd);
+
+    return 0;
+}
+
+static void fsbench_report(struct fsbench *bench, struct fsbench_job *jobs, rt_tick_t tick)
+{
+    static const rt_uint16_t permille[] = {500, 900, 990, 999};
+    static const char *name[] = {"50.0", "90.0", "99.0", "99.9"};
+    rt_uint32_t hist[HIST_NUM];
+    rt_uint32_t ios = 0, lat_min = 0xFFFFFFFF, lat_max = 0, ms, kbytes, target, sum;
+    rt_uint64_t lat_sum = 0;
+    int id, index, p;
+
+    rt_memset(hist, 0, sizeof(hist));
+    for (id = 0; id < bench->jobs; id ++)
+    {
+        if (jobs[id].error)
+            rt_kprintf("job%d error %d after %d requests\n", id, jobs[id].error, jobs[id].ios);
+
+        ios += jobs[id].ios;
+        lat_sum += jobs[id].lat_sum;
+        if (jobs[id].lat_min < lat_min)
+            lat_min = jobs[id].lat_min;
+        if (jobs[id].lat_max > lat_max)
+            lat_max = jobs[id].lat_max;
+        for (index = 0; index < HIST_NUM; index ++)
+            hist[index] += jobs[id].hist[index];
+    }
+    if (ios == 0)
+        return;
+
+    ms = tick * 1000 / RT_TICK_PER_SECOND;
+    if (ms == 0)
+        ms = 1;
+    kbytes = (rt_uint32_t)((rt_uint64_t)ios * bench->block_size / 1024);
+
+    rt_kprintf("  io=%dKB, bw=%dKB/s, iops=%d, runt=%dms\n", kbytes,
+               (rt_uint32_t)((rt_uint64_t)kbytes * 1000 / ms),
+               (rt_uint32_t)((rt_uint64_t)ios * 1000 / ms), ms);
+    rt_kprintf("  lat(us): min=%d, max=%d, avg=%d\n", lat_min, lat_max,
+               (rt_uint32_t)(lat_sum / ios));
+
+    rt_kprintf("  lat percentiles(us):");
+    for (p = 0, sum = 0, index = 0; p < (int)(sizeof(permille) / sizeof(permille[0])); p ++)
+    {
+        target = (rt_uint32_t)(((rt_uint64_t)ios * permille[p] + 999) / 1000);
+        while (index < HIST_NUM - 1 && sum + hist[index] < target)
+            sum += hist[index++];
+        rt_kprintf(" %sth=%d", name[p], hist_value(index) < lat_max ? hist_value(index) : lat_max);
+    }
+    rt_kprintf("\n");
+}
+
+static int fsbench_run(struct fsbench *bench)
+{
+    static const char *mode_name[] = {"write", "read", "randwrite", "randread"};
+    struct fsbench_job *jobs;
+    char name[DFS_PATH_MAX];
+    rt_thread_t tid;
+    rt_tick_t tick;
+    int id, started = 0;
+
+    jobs = (struct fsbench_job *)rt_calloc(bench->jobs, sizeof(struct fsbench_job));
+    if (jobs == RT_NULL)
+        return -RT_ENOMEM;
+
+    rt_kprintf("%s: bs=%d, size=%dKB, jobs=%d, qd=%d\n", mode_name[bench->mode], bench->block_size,
+               bench->file_size / 1024, bench->jobs, bench->qd);
+
+    for (id = 0; id < bench->jobs; id ++)
+        jobs[id].fd = -1;
+    for (id = 0; id < bench->jobs; id ++)
+    {
+        struct fsbench_job *job = &jobs[id];
+
+        job->bench = bench;
+        job->id = id;
+        job->seed = 0x2545F491 * (id + 1);
+        job->lat_min = 0xFFFFFFFF;
+        job->buf = (rt_uint8_t *)rt_malloc(bench->block_size * bench->qd);
+        rt_snprintf(name, sizeof(name), "%s/fsbench.%d", bench->path, id);
+        job->fd = open(name, (bench->mode & MODE_READ) ? O_RDONLY : O_WRONLY, 0);
+        if (job->buf == RT_NULL || job->fd < 0)
+        {
+            rt_kprintf("prepare job%d failed\n", id);
+            goto __exit;
+        }
+        rt_memset(job->buf, 0x5A, bench->block_size * bench->qd);
+    }
+
+    tick = rt_tick_get();
+    for (id = 0; id < bench->jobs; id ++)
+    {
+        rt_snprintf(name, sizeof(name), "fsb%d", id);
+        tid = rt_thread_create(name, job_entry, &jobs[id], 2048,
+                               rt_thread_self()->current_priority, 10);
+        if (tid == RT_NULL)
+        {
+            rt_kprintf("create job%d failed\n", id);
+            break;
+        }
+        rt_thread_startup(tid);
+        started ++;
+    }
+    for (id = 0; id < started; id ++)
+        rt_sem_take(&bench->done, RT_WAITING_FOREVER);
+    tick = rt_tick_get() - tick;
+
+    fsbench_report(bench, jobs, tick);
+
+__exit:
+    for (id = 0; id < bench->jobs; id ++)
+    {
+        if (jobs[id].fd >= 0)
+            close(jobs[id].fd);
+        rt_free(jobs[id].buf);
+    }
+    rt_free(jobs);
+
+    return RT_EOK;
+}
+
+static rt_uint32_t parse_size(const char *str)
+{
+    rt_uint32_t size = 0;
+
+    while (*str >= '0' && *str <= '9')
+        size = size * 10 + (*str++ - '0');
+
+    if (*str == 'k' || *str == 'K')
+        size *= 1024;
+    else if (*str == 'm' || *str == 'M')
+        size *= 1024 * 1024;
+
+    return size;
+}
+
+static void fsbench_usage(void)
+{
+    rt_kprintf("Usage: fsbench <path> [options]\n");
+    rt_kprintf("  -m <mode>  read, write, randread, randwrite or all (default)\n");
+    rt_kprintf("  -b <size>  block size, default 4k\n");
+    rt_kprintf("  -s <size>  file size of every job, default 256k\n");
+    rt_kprintf("  -n <num>   requests of every job, default file size / block size\n");
+    rt_kprintf("  -j <num>   jobs, default 1, max %d\n", FSBENCH_JOB_MAX);
+    rt_kprintf("  -q <num>   queue depth by AIO, default 1, max %d\n", FSBENCH_QD_MAX);
+    rt_kprintf("  -k         keep the test files\n");
+}
+
+static void fsbench(int argc, char **argv)
+{
+    static const char *modes[] = {"write", "read", "randwrite", "randread"};
+    struct fsbench bench;
+    rt_uint8_t *buf;
+    char name[DFS_PATH_MAX];
+    rt_bool_t keep = RT_FALSE;
+    int mode = -1, index, id;
+
+    if (argc < 2 || argv[1][0] == '-')
+    {
+        fsbench_usage();
+        return;
+    }
+
+    rt_memset(&bench, 0, sizeof(bench));
+    bench.path = argv[1];
+    bench.block_size = 4096;
+    bench.file_size = 256 * 1024;
+    bench.jobs = 1;
+    bench.qd = 1;
+
+    for (index = 2; index < argc; index ++)
+    {
+        const char *value = (index + 1 < argc) ? argv[index + 1] : RT_NULL;
+
+        if (rt_strcmp(argv[index], "-k") == 0)
+        {
+            keep = RT_TRUE;
+            continue;
+        }
+        if (value == RT_NULL)
+        {
+            fsbench_usage();
+            return;
+        }
+
+        if (rt_strcmp(argv[index], "-m") == 0)
+        {
+            for (mode = 0; mode < 4 && rt_strcmp(value, modes[mode]) != 0; mode ++);
+            if (mode == 4)
+                mode = -1;
+        }
+        else if (rt_strcmp(argv[index], "-b") == 0)
+            bench.block_size = parse_size(value);
+        else if (rt_strcmp(argv[index], "-s") == 0)
+            bench.file_size = parse_size(value);
+        else if (rt_strcmp(argv[index], "-n") == 0)
+            bench.nr_ios = parse_size(value);
+        else if (rt_strcmp(argv[index], "-j") == 0)
+            bench.jobs = atoi(value);
+        else if (rt_strcmp(argv[index], "-q") == 0)
+            bench.qd = atoi(value);
+        else
+        {
+            fsbench_usage();
+            return;
+        }
+        index ++;
+    }
+
+    if (bench.block_size == 0 || bench.file_size < bench.block_size ||
+        bench.jobs <= 0 || bench.jobs > FSBENCH_JOB_MAX ||
+        bench.qd <= 0 || bench.qd > FSBENCH_QD_MAX)
+    {
+        fsbench_usage();
+        return;
+    }
+#ifndef RT_USING_POSIX_AIO
+    if (bench.qd > 1)
+    {
+        rt_kprintf("queue depth needs RT_USING_POSIX_AIO\n");
+        return;
+    }
+#endif
+    bench.file_size -= bench.file_size % bench.block_size;
+
+    buf = (rt_uint8_t *)rt_malloc(bench.block_size);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return;
+    }
+    rt_memset(buf, 0x5A, bench.block_size);
+    for (id = 0; id < bench.jobs; id ++)
+    {
+        if (job_layout(&bench, id, buf) != 0)
+        {
+            rt_kprintf("write %s/fsbench.%d failed\n", bench.path, id);
+            rt_free(buf);
+            return;
+        }
+    }
+    rt_free(buf);
+
+    if (bench.nr_ios == 0)
+        bench.nr_ios = bench.file_size / bench.block_size;
+
+    rt_sem_init(&bench.done, "fsbench", 0, RT_IPC_FLAG_FIFO);
+    for (index = 0; index < 4; index ++)
+    {
+        if (mode >= 0 && index != mode)
+            continue;
+
+        bench.mode = index;
+        fsbench_run(&bench);
+    }
+    rt_sem_detach(&bench.done);
+
+    if (!keep)
+    {
+        for (id = 0; id < bench.jobs; id ++)
+        {
+            rt_snprintf(name, sizeof(name), "%s/fsbench.%d", bench.path, id);
+            unlink(name);
+        }
+    }
+}
+MSH_CMD_EXPORT(fsbench, file system benchmark: fsbench <path> [-m mode] [-b bs] [-s size] [-j jobs] [-q depth]);
+
+/* RAM disk for the benchmark */
+#define RAMDISK_SECTOR_SIZE     512
+
+struct ramdisk
+{
+    struct rt_device parent;
+    rt_uint8_t *mem;
+    rt_uint32_t sector_count;
+};
+
+static struct ramdisk _ramdisk;
+
+static rt_size_t ramdisk_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    struct ramdisk *disk = (struct ramdisk *)dev;
+
+    if (pos + size > disk->sector_count)
+        return 0;
+
+    rt_memcpy(buffer, disk->mem + pos * RAMDISK_SECTOR_SIZE, size * RAMDISK_SECTOR_SIZE);
+    return size;
+}
+
+static rt_size_t ramdisk_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct ramdisk *disk = (struct ramdisk *)dev;
+
+    if (pos + size > disk->sector_count)
+        return 0;
+
+    rt_memcpy(disk->mem + pos * RAMDISK_SECTOR_SIZE, buffer, size * RAMDISK_SECTOR_SIZE);
+    return size;
+}
+
+static rt_err_t ramdisk_control(rt_device_t dev, int cmd, void *args)
+{
+    struct ramdisk *disk = (struct ramdisk *)dev;
+
+    if (cmd == RT_DEVICE_CTRL_BLK_GETGEOME)
+    {
+        struct rt_device_blk_geometry *geometry = (struct rt_device_blk_geometry *)args;
+
+        geometry->bytes_per_sector = RAMDISK_SECTOR_SIZE;
+        geometry->block_size = RAMDISK_SECTOR_SIZE;
+        geometry->sector_count = disk->sector_count;
+    }
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops ramdisk_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    ramdisk_read,
+    ramdisk_write,
+    ramdisk_control
+};
+#endif
+
+static void ramdisk(int argc, char **argv)
+{
+    rt_uint32_t size = 512 * 1024;
+
+    if (argc > 1)
+        size = parse_size(argv[1]) * 1024;
+    if (size < 64 * 1024)
+    {
+        rt_kprintf("Usage: ramdisk [size KB], 64KB at least\n");
+        return;
+    }
+    if (_ramdisk.mem != RT_NULL)
+    {
+        rt_kprintf("ram0 has been created\n");
+        return;
+    }
+
+    _ramdisk.mem = (rt_uint8_t *)rt_malloc(size);
+    if (_ramdisk.mem == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return;
+    }
+    rt_memset(_ramdisk.mem, 0, size);
+    _ramdisk.sector_count = size / RAMDISK_SECTOR_SIZE;
+
+    _ramdisk.parent.type = RT_Device_Class_Block;
+#ifdef RT_USING_DEVICE_OPS
+    _ramdisk.parent.ops = &ramdisk_ops;
+#else
+    _ramdisk.parent.read = ramdisk_read;
+    _ramdisk.parent.write = ramdisk_write;
+    _ramdisk.parent.control = ramdisk_control;
+#endif
+    rt_device_register(&_ramdisk.parent, "ram0", RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_STANDALONE);
+
+    rt_kprintf("ram0: %d sectors of %d bytes\n", _ramdisk.sector_count, RAMDISK_SECTOR_SIZE);
+}
+MSH_CMD_EXPORT(ramdisk, create RAM disk ram0: ramdisk [size KB]);
+
+#endif /* defined(RT_USING_DFS) && defined(RT_USING_FINSH) */
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * The AT client parser fed by a captured modem log:
+ *
+ *     msh />at_replay [rounds] [file]
+ *
+ * The log is the raw data received from the modem, such as the capture of a
+ * logic analyzer or the AT_PRINT_RAW_CMD output, a built-in log of ESP8266 and
+ * SIM800 is used without file. It's replayed by the device "at_rply" to an AT
+ * client with the URC table of ESP8266 and SIM800 devices, the "+IPD" data is
+ * received by at_client_recv(). The parsing throughput and the URCs dispatched
+ * are reported.
+ *
+ * It needs a free AT client, AT_CLIENT_NUM_MAX must be more than the clients of
+ * AT devices.
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+
+#if defined(AT_USING_CLIENT) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <at.h>
+
+#ifdef RT_USING_DFS
+#include <dfs_posix.h>
+#endif
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif
+
+#define AT_REPLAY_DEVICE        "at_rply"
+#define AT_REPLAY_RECV_BUFSZ    512
+#define AT_REPLAY_FILE_MAX      (32 * 1024)
+
+struct at_replay_device
+{
+    struct rt_device parent;
+
+    const char *log;
+    rt_size_t log_len;
+    rt_size_t pos;
+    rt_bool_t finished;
+    struct rt_semaphore done;           /* the log is consumed */
+};
+
+static struct at_replay_device at_replay_dev;
+static at_client_t at_replay_client;
+
+static rt_uint32_t at_replay_urcs;
+static rt_uint32_t at_replay_ipd_bytes;
+
+static const char at_replay_builtin_log[] =
+    "AT\r\r\nOK\r\n"
+    "ATE0\r\r\nOK\r\n"
+    "WIFI CONNECTED\r\n"
+    "WIFI GOT IP\r\n"
+    "AT+CIPMUX=1\r\n\r\nOK\r\n"
+    "0,CONNECT\r\n\r\nOK\r\n"
+    "\r\nOK\r\n> \r\nRecv 64 bytes\r\n\r\nSEND OK\r\n"
+    "\r\n+IPD,0,57:GET /index.html HTTP/1.1\r\nHost: www.rt-thread.org\r\n\r\n\r\n\r\n"
+    "\r\n+IPD,0,32:0123456789abcdef0123456789abcdef\r\n"
+    "+CREG: 1,\"1A2B\",\"00C3D4E5\",7\r\n"
+    "+CSQ: 23,99\r\n\r\nOK\r\n"
+    "+CPIN: READY\r\n"
+    "RING\r\n"
+    "+CLIP: \"13800000000\",129,\"\",0,\"\",0\r\n"
+    "+CGATT: 1\r\n\r\nOK\r\n"
+    "+CIFSR: STAIP,\"192.168.1.100\"\r\n+CIFSR: STAMAC,\"18:fe:34:00:00:01\"\r\n\r\nOK\r\n"
+    "busy p...\r\n"
+    "0,CLOSED\r\n"
+    "WIFI DISCONNECT\r\n";
+
+static void at_replay_urc_func(struct at_client *client, const char *data, rt_size_t size)
+{
+    at_replay_urcs++;
+}
+
+static void at_replay_ipd_func(struct at_client *client, const char *data, rt_size_t size)
+{
+    char buf[64];
+    int device_socket = 0, bfsz = 0, len;
+
+    at_replay_urcs++;
+    sscanf(data, "+IPD,%d,%d:", &device_socket, &bfsz);
+
+    /* the data follows the URC */
+    while (bfsz > 0)
+    {
+        len = bfsz < sizeof(buf) ? bfsz : sizeof(buf);
+        if (at_client_obj_recv(client, buf, len, 100) != len)
+            break;
+        at_replay_ipd_bytes += len;
+        bfsz -= len;
+    }
+}
+
+/* the URCs of ESP8266 and SIM800 devices */
+static const struct at_urc at_replay_urc_table[] =
+{
+    {"SEND OK",          "\r\n",           at_replay_urc_func},
+    {"SEND FAIL",        "\r\n",           at_replay_urc_func},
+    {"Recv",             "bytes\r\n",      at_replay_urc_func},
+    {"",                 ",CONNECT FAIL\r\n", at_replay_urc_func},
+    {"",                 ",CLOSED\r\n",    at_replay_urc_func},
+    {"+IPD",             ":",              at_replay_ipd_func},
+    {"WIFI CONNECTED",   "\r\n",           at_replay_urc_func},
+    {"WIFI DISCONNECT",  "\r\n",           at_replay_urc_func},
+    {"WIFI GOT IP",      "\r\n",           at_replay_urc_func},
+    {"busy p",           "\r\n",           at_replay_urc_func},
+    {"busy s",           "\r\n",           at_replay_urc_func},
+    {"+CREG:",           "\r\n",           at_replay_urc_func},
+    {"+CSQ:",            "\r\n",           at_replay_urc_func},
+    {"+CPIN:",           "\r\n",           at_replay_urc_func},
+    {"+PDP: DEACT",      "\r\n",           at_replay_urc_func},
+    {"RING",             "\r\n",           at_replay_urc_func},
+    {"+CLIP:",           "\r\n",           at_replay_urc_func},
+    {"+CMTI:",           "\r\n",           at_replay_urc_func},
+};
+
+static rt_size_t at_replay_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    struct at_replay_device *replay = (struct at_replay_device *)dev;
+    rt_size_t len;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    len = replay->log_len - replay->pos;
+    if (len > size)
+        len = size;
+    rt_memcpy(buffer, replay->log + replay->pos, len);
+    replay->pos += len;
+
+    /* the parser asks for more data, the log is consumed */
+    if (len == 0 && replay->log != RT_NULL && !replay->finished)
+    {
+        replay->finished = RT_TRUE;
+        rt_sem_release(&replay->done);
+    }
+    rt_hw_interrupt_enable(level);
+
+    return len;
+}
+
+static rt_size_t at_replay_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    return size;
+}
+
+static rt_err_t at_replay_control(rt_device_t dev, int cmd, void *args)
+{
+    return RT_EOK;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops at_replay_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    at_replay_read,
+    at_replay_write,
+    at_replay_control
+};
+#endif
+
+static int at_replay_client_init(void)
+{
+    if (at_replay_client != RT_NULL)
+        return RT_EOK;
+
+    rt_sem_init(&at_replay_dev.done, "at_rply", 0, RT_IPC_FLAG_FIFO);
+    at_replay_dev.parent.type = RT_Device_Class_Char;
+#ifdef RT_USING_DEVICE_OPS
+    at_replay_dev.parent.ops = &at_replay_ops;
+#else
+    at_replay_dev.parent.read = at_replay_read;
+    at_replay_dev.parent.write = at_replay_write;
+    at_replay_dev.parent.control = at_replay_control;
+#endif
+    rt_device_register(&at_replay_dev.parent, AT_REPLAY_DEVICE, RT_DEVICE_FLAG_RDWR);
+
+    if (at_client_init(AT_REPLAY_DEVICE, AT_REPLAY_RECV_BUFSZ) != RT_EOK)
+    {
+        rt_device_unregister(&at_replay_dev.parent);
+        rt_sem_detach(&at_replay_dev.done);
+        return -RT_ERROR;
+    }
+    at_replay_client = at_client_get(AT_REPLAY_DEVICE);
+    at_obj_set_urc_table(at_replay_client, at_replay_urc_table,
+                         sizeof(at_replay_urc_table) / sizeof(at_replay_urc_table[0]));
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_DFS
+static char *at_replay_load(const char *path, rt_size_t *size)
+{
+    struct stat st;
+    char *log;
+    int fd, len;
+
+    if (stat(path, &st) < 0 || st.st_size <= 0 || st.st_size > AT_REPLAY_FILE_MAX)
+    {
+        rt_kprintf("%s isn't a log of 1 to %d bytes\n", path, AT_REPLAY_FILE_MAX);
+        return RT_NULL;
+    }
+
+    log = rt_malloc(st.st_size);
+    fd = open(path, O_RDONLY, 0);
+    if (log == RT_NULL || fd < 0)
+    {
+        rt_kprintf("load %s failed\n", path);
+        goto __exit;
+    }
+
+    len = read(fd, log, st.st_size);
+    if (len != st.st_size)
+    {
+        rt_kprintf("read %s failed\n", path);
+        goto __exit;
+    }
+    close(fd);
+    *size = len;
+
+    return log;
+
+__exit:
+    if (fd >= 0)
+        close(fd);
+    rt_free(log);
+    return RT_NULL;
+}
+#endif /* RT_USING_DFS */
+
+static rt_uint32_t at_replay_now(void)
+{
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_gettime();
+#else
+    return rt_tick_get();
+#endif
+}
+
+static void at_replay(int argc, char **argv)
+{
+    const char *log = at_replay_builtin_log;
+    char *loaded = RT_NULL;
+    rt_size_t log_len = sizeof(at_replay_builtin_log) - 1;
+    rt_uint64_t bytes, elapsed = 0;
+    rt_uint32_t begin;
+    rt_base_t level;
+    int rounds = 100, round;
+
+    if (argc > 1)
+        rounds = atoi(argv[1]);
+    if (rounds <= 0 || argc > 3)
+    {
+        rt_kprintf("Usage: at_replay [rounds] [file]\n");
+        return;
+    }
+
+    if (argc > 2)
+    {
+#ifdef RT_USING_DFS
+        loaded = at_replay_load(argv[2], &log_len);
+        if (loaded == RT_NULL)
+            return;
+        log = loaded;
+#else
+        rt_kprintf("the log file needs RT_USING_DFS\n");
+        return;
+#endif
+    }
+
+    if (at_replay_client_init() != RT_EOK)
+    {
+        rt_kprintf("no free AT client, please increase AT_CLIENT_NUM_MAX(%d)\n", AT_CLIENT_NUM_MAX);
+        rt_free(loaded);
+        return;
+    }
+
+    at_replay_urcs = 0;
+    at_replay_ipd_bytes = 0;
+    for (round = 0; round < rounds; round++)
+    {
+        level = rt_hw_interrupt_disable();
+        at_replay_dev.log = log;
+        at_replay_dev.log_len = log_len;
+        at_replay_dev.pos = 0;
+        at_replay_dev.finished = RT_FALSE;
+        rt_hw_interrupt_enable(level);
+
+        begin = at_replay_now();
+        /* the log is received like a DMA transfer of UART */
+        at_replay_dev.parent.rx_indicate(&at_replay_dev.parent, log_len);
+        rt_sem_take(&at_replay_dev.done, RT_WAITING_FOREVER);
+        elapsed += at_replay_now() - begin;
+    }
+
+    level = rt_hw_interrupt_disable();
+    at_replay_dev.log = RT_NULL;
+    at_replay_dev.log_len = 0;
+    at_replay_dev.pos = 0;
+    rt_hw_interrupt_enable(level);
+
+    bytes = (rt_uint64_t)log_len * rounds;
+    if (elapsed == 0)
+        elapsed = 1;
+    rt_kprintf("%d rounds of %d bytes, %d URCs, %d +IPD data bytes\n", rounds, log_len,
+               at_replay_urcs, at_replay_ipd_bytes);
+#ifdef RT_USING_CPUTIME
+    rt_kprintf("%d us, %d KB/s, %d.%02d counts/byte\n",
+               (rt_uint32_t)clock_cpu_microsecond(elapsed),
+               (rt_uint32_t)(bytes * 1000000 / 1024 / (clock_cpu_microsecond(elapsed) + 1)),
+               (rt_uint32_t)(elapsed / bytes), (rt_uint32_t)(elapsed * 100 / bytes % 100));
+#else
+    rt_kprintf("%d ticks, %d KB/s\n", (rt_uint32_t)elapsed,
+               (rt_uint32_t)(bytes * RT_TICK_PER_SECOND / 1024 / elapsed));
+#endif
+
+    rt_free(loaded);
+}
+MSH_CMD_EXPORT(at_replay, AT client parser replay benchmark: at_replay [rounds] [file]);
+
+#endif /* defined(AT_USING_CLIENT) && defined(RT_USING_FINSH) */
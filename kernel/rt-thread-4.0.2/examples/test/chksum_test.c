@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * The optimized checksum of lwIP against the generic one:
+ *
+ *     msh />chksum_test [count]
+ *     msh />chksum_bench [size] [count]
+ *
+ * chksum_test compares sys_chksum() and sys_chksum_copy() with the generic
+ * lwip_standard_chksum() on the random data of random alignment and length.
+ * chksum_bench measures the bytes per cputime count of both, it's bytes/cycle
+ * when the cputime counts the CPU cycles, such as DWT on Cortex-M.
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_LWIP210) && defined(RT_LWIP_USING_OPT_CHECKSUM) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lwip/opt.h>
+#include <lwip/def.h>
+#include <lwip/inet_chksum.h>
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif
+
+#define CHKSUM_TEST_SIZE_MAX    2048
+
+/* lwip_standard_chksum() of LWIP_CHKSUM_ALGORITHM 2, it isn't built with LWIP_CHKSUM */
+static u16_t chksum_generic(const void *dataptr, int len)
+{
+    const u8_t *pb = (const u8_t *)dataptr;
+    const u16_t *ps;
+    u16_t t = 0;
+    u32_t sum = 0;
+    int odd = ((mem_ptr_t)pb & 1);
+
+    if (odd && len > 0)
+    {
+        ((u8_t *)&t)[1] = *pb++;
+        len--;
+    }
+
+    ps = (const u16_t *)(const void *)pb;
+    while (len > 1)
+    {
+        sum += *ps++;
+        len -= 2;
+    }
+
+    if (len > 0)
+        ((u8_t *)&t)[0] = *(const u8_t *)ps;
+
+    sum += t;
+    sum = FOLD_U32T(sum);
+    sum = FOLD_U32T(sum);
+    if (odd)
+        sum = SWAP_BYTES_IN_WORD(sum);
+
+    return (u16_t)sum;
+}
+
+static void chksum_test(int argc, char **argv)
+{
+    rt_uint8_t *src, *dst;
+    int count = 10000, index, offset, len, pattern, i;
+    int errors = 0;
+    u16_t expect, result;
+
+    if (argc > 1)
+        count = atoi(argv[1]);
+    if (count <= 0)
+    {
+        rt_kprintf("Usage: chksum_test [count]\n");
+        return;
+    }
+
+    src = rt_malloc(CHKSUM_TEST_SIZE_MAX + 16);
+    dst = rt_malloc(CHKSUM_TEST_SIZE_MAX + 16);
+    if (src == RT_NULL || dst == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        goto __exit;
+    }
+
+    for (index = 0; index < count; index ++)
+    {
+        offset = rand() % 8;
+        len = (index & 1) ? rand() % 128 : rand() % (CHKSUM_TEST_SIZE_MAX + 1);
+        pattern = rand() % 4;
+
+        /* all ones and all zeros are the corner cases of the carries */
+        for (i = 0; i < len + 8; i ++)
+            src[i] = pattern == 0 ? 0xff : (pattern == 1 ? 0 : rand());
+
+        expect = chksum_generic(src + offset, len);
+        result = sys_chksum(src + offset, len);
+        if (result != expect)
+        {
+            if (errors ++ < 8)
+                rt_kprintf("sum: offset %d, len %d, 0x%04x != 0x%04x\n", offset, len, result, expect);
+        }
+
+        i = rand() % 8;
+        rt_memset(dst, 0xA5, len + 16);
+        result = sys_chksum_copy(dst + i, src + offset, len);
+        if (result != chksum_generic(dst + i, len) || rt_memcmp(dst + i, src + offset, len) != 0 ||
+            dst[i + len] != 0xA5 || (i > 0 && dst[i - 1] != 0xA5))
+        {
+            if (errors ++ < 8)
+                rt_kprintf("copy: offset %d to %d, len %d\n", offset, i, len);
+        }
+    }
+
+    rt_kprintf("%d cases, %d errors\n", count, errors);
+
+__exit:
+    rt_free(src);
+    rt_free(dst);
+}
+MSH_CMD_EXPORT(chksum_test, checksum test against the generic one: chksum_test [count]);
+
+static rt_uint32_t chksum_bench_now(void)
+{
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_gettime();
+#else
+    return rt_tick_get();
+#endif
+}
+
+static void chksum_bench_print(const char *name, int size, int count, rt_uint32_t elapsed)
+{
+    rt_uint64_t bytes = (rt_uint64_t)size * count;
+
+    if (elapsed == 0)
+        elapsed = 1;
+#ifdef RT_USING_CPUTIME
+    /* bytes per count in 1/100 */
+    rt_kprintf("%-10s %d.%02d bytes/count\n", name, (rt_uint32_t)(bytes / elapsed),
+               (rt_uint32_t)(bytes * 100 / elapsed % 100));
+#else
+    rt_kprintf("%-10s %d KB/s\n", name, (rt_uint32_t)(bytes * RT_TICK_PER_SECOND / 1024 / elapsed));
+#endif
+}
+
+static void chksum_bench(int argc, char **argv)
+{
+    rt_uint8_t *src, *dst;
+    rt_uint32_t begin;
+    volatile u16_t sum = 0;
+    int size = 1460, count = 10000, index;
+
+    if (argc > 1)
+        size = atoi(argv[1]);
+    if (argc > 2)
+        count = atoi(argv[2]);
+    if (size <= 0 || size > CHKSUM_TEST_SIZE_MAX || count <= 0)
+    {
+        rt_kprintf("Usage: chksum_bench [size <= %d] [count]\n", CHKSUM_TEST_SIZE_MAX);
+        return;
+    }
+
+    src = rt_malloc(size);
+    dst = rt_malloc(size);
+    if (src == RT_NULL || dst == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        goto __exit;
+    }
+    for (index = 0; index < size; index ++)
+        src[index] = rand();
+
+    begin = chksum_bench_now();
+    for (index = 0; index < count; index ++)
+        sum += chksum_generic(src, size);
+    chksum_bench_print("generic", size, count, chksum_bench_now() - begin);
+
+    begin = chksum_bench_now();
+    for (index = 0; index < count; index ++)
+        sum += sys_chksum(src, size);
+    chksum_bench_print("optimized", size, count, chksum_bench_now() - begin);
+
+    begin = chksum_bench_now();
+    for (index = 0; index < count; index ++)
+    {
+        rt_memcpy(dst, src, size);
+        sum += sys_chksum(dst, size);
+    }
+    chksum_bench_print("memcpy+sum", size, count, chksum_bench_now() - begin);
+
+    begin = chksum_bench_now();
+    for (index = 0; index < count; index ++)
+        sum += sys_chksum_copy(dst, src, size);
+    chksum_bench_print("copy", size, count, chksum_bench_now() - begin);
+
+__exit:
+    rt_free(src);
+    rt_free(dst);
+}
+MSH_CMD_EXPORT(chksum_bench, checksum throughput: chksum_bench [size] [count]);
+
+#endif /* defined(RT_USING_LWIP210) && defined(RT_LWIP_USING_OPT_CHECKSUM) && defined(RT_USING_FINSH) */
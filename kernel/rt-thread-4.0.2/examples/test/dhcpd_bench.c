@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * The burst joining of DHCP clients to the DHCP server:
+ *
+ *     msh />dhcpd_bench [clients]
+ *
+ * A simulated lwIP network interface "db" runs the DHCP server, the clients
+ * with the MAC address 02:db:00:00:xx:xx send the DISCOVER of all of them at
+ * once, then the REQUEST of all of them, and the OFFER and ACK are received by
+ * the output of interface. The leases are released at last.
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_LWIP) && defined(LWIP_USING_DHCPD) && defined(RT_USING_FINSH) && \
+    (defined(RT_USING_LWIP202) || defined(RT_USING_LWIP210))
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lwip/netifapi.h>
+#include <lwip/tcpip.h>
+#include <lwip/inet_chksum.h>
+#include <lwip/prot/dhcp.h>
+#include <netif/etharp.h>
+#include <dhcp_server.h>
+
+#define DHCPD_BENCH_NETIF        "db"
+#define DHCPD_BENCH_CLIENTS      200
+#define DHCPD_BENCH_CLIENTS_MAX  253
+#define DHCPD_BENCH_MSG_LEN      300
+#define DHCPD_BENCH_FRAME_LEN    (14 + 20 + 8 + DHCPD_BENCH_MSG_LEN)
+#define DHCPD_BENCH_TIMEOUT      (RT_TICK_PER_SECOND * 5)
+#define DHCPD_BENCH_SERVER_PORT  67
+#define DHCPD_BENCH_CLIENT_PORT  68
+
+struct dhcpd_bench
+{
+    struct netif netif;
+    rt_bool_t attached;
+
+    rt_uint32_t expect;
+    volatile rt_uint32_t offers;
+    volatile rt_uint32_t acks;
+    volatile rt_uint32_t naks;
+    struct rt_semaphore done;
+
+    rt_uint32_t yiaddr[DHCPD_BENCH_CLIENTS_MAX];
+    rt_uint32_t server;
+    rt_uint8_t frame[DHCPD_BENCH_FRAME_LEN];
+};
+
+static struct dhcpd_bench dhcpd_bench_dev;
+static const rt_uint8_t dhcpd_bench_mac[6] = {0x02, 0xdb, 0x00, 0x00, 0x00, 0x00};
+static const rt_uint8_t dhcpd_bench_server_mac[6] = {0x02, 0xdb, 0x00, 0x01, 0x00, 0x01};
+
+/* the replies of DHCP server are parsed when they are sent */
+static err_t dhcpd_bench_linkoutput(struct netif *netif, struct pbuf *p)
+{
+    struct dhcpd_bench *bench = (struct dhcpd_bench *)netif->state;
+    rt_uint8_t reply[14 + 20 + 8 + 244];
+    rt_uint8_t *msg = reply + 14 + 20 + 8;
+    rt_uint32_t index;
+
+    if (pbuf_copy_partial(p, reply, sizeof(reply), 0) != sizeof(reply) ||
+        reply[12] != 0x08 || reply[13] != 0x00 || reply[14 + 9] != IP_PROTO_UDP ||
+        reply[14 + 20 + 2] != 0 || reply[14 + 20 + 3] != DHCPD_BENCH_CLIENT_PORT ||
+        msg[0] != DHCP_BOOTREPLY || msg[240] != DHCP_OPTION_MESSAGE_TYPE)
+        return ERR_OK;
+
+    index = (msg[28 + 4] << 8) | msg[28 + 5];
+    if (index >= DHCPD_BENCH_CLIENTS_MAX)
+        return ERR_OK;
+
+    switch (msg[242])
+    {
+    case DHCP_OFFER:
+        rt_memcpy(&bench->yiaddr[index], msg + 16, 4);
+        rt_memcpy(&bench->server, msg + 20, 4);
+        bench->offers ++;
+        break;
+    case DHCP_ACK:
+        bench->acks ++;
+        break;
+    case DHCP_NAK:
+        bench->naks ++;
+        break;
+    default:
+        return ERR_OK;
+    }
+
+    if (bench->offers + bench->acks + bench->naks == bench->expect)
+        rt_sem_release(&bench->done);
+
+    return ERR_OK;
+}
+
+static err_t dhcpd_bench_netif_init(struct netif *netif)
+{
+    netif->name[0] = DHCPD_BENCH_NETIF[0];
+    netif->name[1] = DHCPD_BENCH_NETIF[1];
+    netif->output = etharp_output;
+    netif->linkoutput = dhcpd_bench_linkoutput;
+    netif->mtu = 1500;
+    netif->hwaddr_len = 6;
+    rt_memcpy(netif->hwaddr, dhcpd_bench_server_mac, 6);
+    netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET | NETIF_FLAG_LINK_UP;
+
+    return ERR_OK;
+}
+
+static int dhcpd_bench_attach(struct dhcpd_bench *bench)
+{
+    ip4_addr_t addr;
+
+    if (bench->attached)
+        return RT_EOK;
+
+    ip4_addr_set_zero(&addr);
+    if (netifapi_netif_add(&bench->netif, &addr, &addr, &addr, bench, dhcpd_bench_netif_init, tcpip_input) != ERR_OK)
+    {
+        rt_kprintf("add the network interface %s failed\n", DHCPD_BENCH_NETIF);
+        return -RT_ERROR;
+    }
+
+    rt_sem_init(&bench->done, "db_done", 0, RT_IPC_FLAG_FIFO);
+    bench->attached = RT_TRUE;
+
+    return RT_EOK;
+}
+
+/* build the DHCP message broadcast by the client */
+static int dhcpd_bench_build(struct dhcpd_bench *bench, rt_uint32_t index, rt_uint8_t type)
+{
+    rt_uint8_t *frame = bench->frame;
+    rt_uint8_t *ip = frame + 14;
+    rt_uint8_t *udp = ip + 20;
+    rt_uint8_t *msg = udp + 8;
+    rt_uint8_t *opt = msg + 240;
+    rt_uint16_t chksum;
+
+    rt_memset(frame, 0, DHCPD_BENCH_FRAME_LEN);
+
+    rt_memset(frame, 0xff, 6);
+    rt_memcpy(frame + 6, dhcpd_bench_mac, 6);
+    frame[6 + 4] = index >> 8;
+    frame[6 + 5] = index & 0xff;
+    frame[12] = 0x08;
+    frame[13] = 0x00;
+
+    ip[0] = 0x45;
+    ip[2] = (20 + 8 + DHCPD_BENCH_MSG_LEN) >> 8;
+    ip[3] = (20 + 8 + DHCPD_BENCH_MSG_LEN) & 0xff;
+    ip[4] = index >> 8;
+    ip[5] = index & 0xff;
+    ip[8] = 64;
+    ip[9] = IP_PROTO_UDP;
+    rt_memset(ip + 16, 0xff, 4);
+    chksum = inet_chksum(ip, 20);
+    rt_memcpy(ip + 10, &chksum, 2);
+
+    udp[1] = DHCPD_BENCH_CLIENT_PORT;
+    udp[3] = DHCPD_BENCH_SERVER_PORT;
+    udp[4] = (8 + DHCPD_BENCH_MSG_LEN) >> 8;
+    udp[5] = (8 + DHCPD_BENCH_MSG_LEN) & 0xff;
+
+    msg[0] = DHCP_BOOTREQUEST;
+    msg[1] = 1;                 /* Ethernet */
+    msg[2] = 6;
+    msg[4] = 0xdb;
+    msg[6] = index >> 8;
+    msg[7] = index & 0xff;
+    msg[10] = 0x80;
+    rt_memcpy(msg + 28, frame + 6, 6);
+    msg[236] = 0x63;
+    msg[237] = 0x82;
+    msg[238] = 0x53;
+    msg[239] = 0x63;
+
+    *opt++ = DHCP_OPTION_MESSAGE_TYPE;
+    *opt++ = 1;
+    *opt++ = type;
+    if (type == DHCP_REQUEST)
+    {
+        *opt++ = DHCP_OPTION_REQUESTED_IP;
+        *opt++ = 4;
+        rt_memcpy(opt, &bench->yiaddr[index], 4);
+        opt += 4;
+        *opt++ = DHCP_OPTION_SERVER_ID;
+        *opt++ = 4;
+        rt_memcpy(opt, &bench->server, 4);
+        opt += 4;
+    }
+    *opt++ = DHCP_OPTION_END;
+
+    return DHCPD_BENCH_FRAME_LEN;
+}
+
+/* the frame is input again while the mailbox of tcpip thread is full */
+static int dhcpd_bench_input(struct dhcpd_bench *bench, int len)
+{
+    struct pbuf *p;
+    int retry;
+
+    p = pbuf_alloc(PBUF_RAW, len, PBUF_RAM);
+    if (p == RT_NULL)
+        return -RT_ENOMEM;
+    pbuf_take(p, bench->frame, len);
+
+    for (retry = 0; retry < 100; retry++)
+    {
+        if (bench->netif.input(p, &bench->netif) == ERR_OK)
+            return RT_EOK;
+        rt_thread_mdelay(1);
+    }
+
+    pbuf_free(p);
+    return -RT_EBUSY;
+}
+
+/* all clients send the message at once, it returns the ticks to get the replies */
+static rt_tick_t dhcpd_bench_burst(struct dhcpd_bench *bench, rt_uint32_t clients, rt_uint8_t type)
+{
+    rt_tick_t tick;
+    rt_uint32_t index;
+
+    bench->expect = (type == DHCP_RELEASE) ? 0 : clients;
+    bench->offers = bench->acks = bench->naks = 0;
+    rt_sem_control(&bench->done, RT_IPC_CMD_RESET, RT_NULL);
+
+    tick = rt_tick_get();
+    for (index = 0; index < clients; index++)
+    {
+        if (dhcpd_bench_input(bench, dhcpd_bench_build(bench, index, type)) != RT_EOK)
+        {
+            rt_kprintf("input the message of client %d failed\n", index);
+            break;
+        }
+    }
+
+    if (bench->expect)
+        rt_sem_take(&bench->done, DHCPD_BENCH_TIMEOUT);
+
+    return rt_tick_get() - tick;
+}
+
+static void dhcpd_bench_report(const char *name, rt_uint32_t replies, rt_tick_t ticks)
+{
+    rt_uint32_t ms = ticks * 1000 / RT_TICK_PER_SECOND;
+
+    rt_kprintf("%-8s %4d replies in %5d ms, %d replies/s\n", name, replies, ms,
+               ms ? replies * 1000 / ms : replies * RT_TICK_PER_SECOND);
+}
+
+static int dhcpd_bench(int argc, char **argv)
+{
+    struct dhcpd_bench *bench = &dhcpd_bench_dev;
+    rt_uint32_t clients = DHCPD_BENCH_CLIENTS;
+    rt_uint32_t index, other, duplicates = 0;
+    rt_tick_t ticks;
+
+    if (argc > 1)
+        clients = atoi(argv[1]);
+    if (clients == 0 || clients > DHCPD_BENCH_CLIENTS_MAX)
+    {
+        rt_kprintf("Usage: dhcpd_bench [clients], 1 ~ %d clients\n", DHCPD_BENCH_CLIENTS_MAX);
+        return -1;
+    }
+
+    if (dhcpd_bench_attach(bench) != RT_EOK)
+        return -1;
+
+    dhcpd_start(DHCPD_BENCH_NETIF);
+    rt_memset(bench->yiaddr, 0, sizeof(bench->yiaddr));
+
+    ticks = dhcpd_bench_burst(bench, clients, DHCP_DISCOVER);
+    dhcpd_bench_report("discover", bench->offers, ticks);
+
+    ticks = dhcpd_bench_burst(bench, clients, DHCP_REQUEST);
+    dhcpd_bench_report("request", bench->acks, ticks);
+    if (bench->naks)
+        rt_kprintf("%d requests are not acknowledged\n", bench->naks);
+
+    for (index = 0; index < clients; index++)
+    {
+        for (other = index + 1; other < clients; other++)
+        {
+            if (bench->yiaddr[index] && bench->yiaddr[index] == bench->yiaddr[other])
+                duplicates ++;
+        }
+    }
+    rt_kprintf("%d duplicated addresses\n", duplicates);
+
+    dhcpd_bench_burst(bench, clients, DHCP_RELEASE);
+    /* the API call is done after the messages queued before it */
+    netifapi_netif_set_link_up(&bench->netif);
+    dhcpd_stop(DHCPD_BENCH_NETIF);
+
+    return 0;
+}
+MSH_CMD_EXPORT(dhcpd_bench, DHCP server burst joining benchmark);
+#endif
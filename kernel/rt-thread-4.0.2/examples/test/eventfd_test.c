@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * A single thread event loop over an eventfd and a timerfd:
+ *
+ *     msh />eventfd_test [events] [period ms]
+ *
+ * The notifier thread writes the eventfd in the period, the timerfd expires
+ * in the same period, the loop waits both of them by poll().
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_POSIX_EVENTFD) && defined(RT_USING_POSIX_TIMERFD) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+#include <dfs_poll.h>
+#include <posix_eventfd.h>
+#include <posix_timerfd.h>
+
+struct eventfd_notifier
+{
+    int efd;
+    int count;
+    int period;
+    struct rt_semaphore done;
+};
+
+static void eventfd_notifier_entry(void *parameter)
+{
+    struct eventfd_notifier *notifier = (struct eventfd_notifier *)parameter;
+    int index;
+
+    for (index = 0; index < notifier->count; index ++)
+    {
+        rt_thread_mdelay(notifier->period);
+        eventfd_write(notifier->efd, 1);
+    }
+    rt_sem_release(&notifier->done);
+}
+
+static void eventfd_test(int argc, char **argv)
+{
+    struct eventfd_notifier notifier;
+    struct itimerspec its;
+    struct pollfd fds[2];
+    eventfd_t value;
+    rt_thread_t tid;
+    rt_tick_t tick;
+    int tfd, events = 0, expirations = 0, wakeups = 0;
+
+    notifier.count = argc > 1 ? atoi(argv[1]) : 10;
+    notifier.period = argc > 2 ? atoi(argv[2]) : 100;
+    if (notifier.count <= 0 || notifier.period <= 0)
+    {
+        rt_kprintf("Usage: eventfd_test [events] [period ms]\n");
+        return;
+    }
+
+    notifier.efd = eventfd(0, EFD_NONBLOCK);
+    tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    if (notifier.efd < 0 || tfd < 0)
+    {
+        rt_kprintf("create eventfd or timerfd failed\n");
+        goto __exit;
+    }
+
+    its.it_value.tv_sec = notifier.period / 1000;
+    its.it_value.tv_nsec = (notifier.period % 1000) * 1000000;
+    its.it_interval = its.it_value;
+    timerfd_settime(tfd, 0, &its, RT_NULL);
+
+    rt_sem_init(&notifier.done, "efdtest", 0, RT_IPC_FLAG_FIFO);
+    tid = rt_thread_create("efdtest", eventfd_notifier_entry, &notifier, 1024,
+                           RT_THREAD_PRIORITY_MAX / 2, 10);
+    if (tid == RT_NULL)
+    {
+        rt_sem_detach(&notifier.done);
+        goto __exit;
+    }
+    tick = rt_tick_get();
+    rt_thread_startup(tid);
+
+    fds[0].fd = notifier.efd;
+    fds[0].events = POLLIN;
+    fds[1].fd = tfd;
+    fds[1].events = POLLIN;
+    while (events < notifier.count)
+    {
+        if (poll(fds, 2, notifier.period * 10) <= 0)
+        {
+            rt_kprintf("poll timeout\n");
+            break;
+        }
+        wakeups ++;
+
+        if ((fds[0].revents & POLLIN) && eventfd_read(notifier.efd, &value) == 0)
+            events += (int)value;
+        if ((fds[1].revents & POLLIN) && read(tfd, &value, sizeof(value)) == sizeof(value))
+            expirations += (int)value;
+    }
+    tick = rt_tick_get() - tick;
+
+    rt_sem_take(&notifier.done, RT_WAITING_FOREVER);
+    rt_sem_detach(&notifier.done);
+
+    rt_kprintf("%d events, %d timer expirations, %d wakeups in %d ticks\n",
+               events, expirations, wakeups, tick);
+
+__exit:
+    if (notifier.efd >= 0)
+        close(notifier.efd);
+    if (tfd >= 0)
+        close(tfd);
+}
+MSH_CMD_EXPORT(eventfd_test, eventfd and timerfd event loop: eventfd_test [events] [period ms]);
+
+#endif
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * Benchmark of the MTD NOR key-value storage against the file based storage.
+ *
+ * Two NOR flashes are simulated in RAM:
+ *   "ramnor" - MTD NOR device for the key-value storage
+ *   "ramblk" - block device which erases the sector before write like the SFUD block
+ *              device, it's for the file system:
+ *
+ *     msh />mkfs -t elm ramblk
+ *     msh />mount ramblk /nor elm
+ *     msh />kv_bench 1000 /nor
+ *
+ * The elm FAT needs RT_DFS_ELM_MAX_SECTOR_SIZE 4096 for this device.
+ *
+ * The erase and program counters of both flashes give the flash time of a real NOR
+ * (sector erase 45ms, page program 0.7ms / 256 bytes).
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(RT_USING_MTD_NOR_KV) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+
+#ifdef RT_USING_DFS
+#include <dfs_posix.h>
+#endif
+
+#define RAMNOR_SECTOR_SIZE      4096
+#define RAMNOR_SECTOR_NUM       16
+#define RAMBLK_SECTOR_NUM       128
+
+#define NOR_ERASE_US            45000
+#define NOR_PROG_NS_PER_BYTE    2734
+
+struct ramnor
+{
+    struct rt_mtd_nor_device mtd;
+    rt_uint8_t *mem;
+    rt_uint32_t erase_num;
+    rt_uint32_t prog_bytes;
+};
+
+struct ramblk
+{
+    struct rt_device parent;
+    rt_uint8_t *mem;
+    rt_uint32_t erase_num;
+    rt_uint32_t prog_bytes;
+};
+
+static struct ramnor _ramnor;
+static struct ramblk _ramblk;
+
+static rt_err_t ramnor_read_id(struct rt_mtd_nor_device *device)
+{
+    return 0x00EF4018;
+}
+
+static rt_size_t ramnor_read(struct rt_mtd_nor_device *device, rt_off_t offset, rt_uint8_t *data, rt_uint32_t length)
+{
+    struct ramnor *nor = (struct ramnor *)device;
+
+    rt_memcpy(data, nor->mem + offset, length);
+    return length;
+}
+
+static rt_size_t ramnor_write(struct rt_mtd_nor_device *device, rt_off_t offset, const rt_uint8_t *data, rt_uint32_t length)
+{
+    struct ramnor *nor = (struct ramnor *)device;
+    rt_uint32_t i;
+
+    /* NOR program only clears bits */
+    for (i = 0; i < length; i ++)
+        nor->mem[offset + i] &= data[i];
+
+    nor->prog_bytes += length;
+    return length;
+}
+
+static rt_err_t ramnor_erase_block(struct rt_mtd_nor_device *device, rt_off_t offset, rt_uint32_t length)
+{
+    struct ramnor *nor = (struct ramnor *)device;
+
+    rt_memset(nor->mem + offset, 0xFF, length);
+    nor->erase_num += length / RAMNOR_SECTOR_SIZE;
+    return RT_EOK;
+}
+
+static const struct rt_mtd_nor_driver_ops ramnor_ops =
+{
+    ramnor_read_id,
+    ramnor_read,
+    ramnor_write,
+    ramnor_erase_block,
+};
+
+static rt_size_t ramblk_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    struct ramblk *blk = (struct ramblk *)dev;
+
+    rt_memcpy(buffer, blk->mem + pos * RAMNOR_SECTOR_SIZE, size * RAMNOR_SECTOR_SIZE);
+    return size;
+}
+
+static rt_size_t ramblk_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    struct ramblk *blk = (struct ramblk *)dev;
+
+    /* the same as sfud_erase_write() */
+    rt_memcpy(blk->mem + pos * RAMNOR_SECTOR_SIZE, buffer, size * RAMNOR_SECTOR_SIZE);
+    blk->erase_num += size;
+    blk->prog_bytes += size * RAMNOR_SECTOR_SIZE;
+    return size;
+}
+
+static rt_err_t ramblk_control(rt_device_t dev, int cmd, void *args)
+{
+    if (cmd == RT_DEVICE_CTRL_BLK_GETGEOME)
+    {
+        struct rt_device_blk_geometry *geometry = (struct rt_device_blk_geometry *)args;
+
+        geometry->bytes_per_sector = RAMNOR_SECTOR_SIZE;
+        geometry->block_size = RAMNOR_SECTOR_SIZE;
+        geometry->sector_count = RAMBLK_SECTOR_NUM;
+    }
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops ramblk_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    ramblk_read,
+    ramblk_write,
+    ramblk_control
+};
+#endif
+
+static int ramnor_init(void)
+{
+    _ramnor.mem = rt_malloc(RAMNOR_SECTOR_SIZE * RAMNOR_SECTOR_NUM);
+    _ramblk.mem = rt_malloc(RAMNOR_SECTOR_SIZE * RAMBLK_SECTOR_NUM);
+    if (_ramnor.mem == RT_NULL || _ramblk.mem == RT_NULL)
+    {
+        rt_free(_ramnor.mem);
+        rt_free(_ramblk.mem);
+        return -RT_ENOMEM;
+    }
+    rt_memset(_ramnor.mem, 0xFF, RAMNOR_SECTOR_SIZE * RAMNOR_SECTOR_NUM);
+    rt_memset(_ramblk.mem, 0xFF, RAMNOR_SECTOR_SIZE * RAMBLK_SECTOR_NUM);
+
+    _ramnor.mtd.block_size = RAMNOR_SECTOR_SIZE;
+    _ramnor.mtd.block_start = 0;
+    _ramnor.mtd.block_end = RAMNOR_SECTOR_NUM;
+    _ramnor.mtd.ops = &ramnor_ops;
+    rt_mtd_nor_register_device("ramnor", &_ramnor.mtd);
+
+    _ramblk.parent.type = RT_Device_Class_Block;
+#ifdef RT_USING_DEVICE_OPS
+    _ramblk.parent.ops = &ramblk_ops;
+#else
+    _ramblk.parent.read = ramblk_read;
+    _ramblk.parent.write = ramblk_write;
+    _ramblk.parent.control = ramblk_control;
+#endif
+    rt_device_register(&_ramblk.parent, "ramblk", RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_STANDALONE);
+
+    return RT_EOK;
+}
+INIT_DEVICE_EXPORT(ramnor_init);
+
+static void bench_report(const char *name, int count, rt_tick_t tick, rt_uint32_t erase_num, rt_uint32_t prog_bytes)
+{
+    rt_uint32_t flash_ms;
+
+    flash_ms = erase_num * (NOR_ERASE_US / 1000) + (rt_uint32_t)((rt_uint64_t)prog_bytes * NOR_PROG_NS_PER_BYTE / 1000000);
+    rt_kprintf("%-6s %6d updates in %5d ticks, erase %6d, program %8d bytes, NOR time %d.%03ds (%d us/update)\n",
+               name, count, tick, erase_num, prog_bytes, flash_ms / 1000, flash_ms % 1000,
+               (rt_uint32_t)((rt_uint64_t)flash_ms * 1000 / count));
+}
+
+static void kv_bench(int argc, char **argv)
+{
+    struct rt_mtd_kv kv;
+    char key[16];
+    rt_uint32_t value, erase_num, prog_bytes;
+    rt_tick_t tick;
+    int count = 1000, i;
+
+    if (argc > 1)
+        count = atoi(argv[1]);
+    if (count <= 0)
+    {
+        rt_kprintf("Usage: kv_bench [updates] [mounted path]\n");
+        return;
+    }
+
+    /* 16 counters are updated in turn */
+    if (rt_mtd_kv_init(&kv, &_ramnor.mtd, 64) != RT_EOK || rt_mtd_kv_format(&kv) != RT_EOK)
+    {
+        rt_kprintf("initialize key-value storage failed\n");
+        return;
+    }
+    erase_num = _ramnor.erase_num;
+    prog_bytes = _ramnor.prog_bytes;
+    tick = rt_tick_get();
+    for (i = 0; i < count; i ++)
+    {
+        rt_snprintf(key, sizeof(key), "counter%d", i % 16);
+        value = i;
+        if (rt_mtd_kv_set(&kv, key, &value, sizeof(value)) != RT_EOK)
+        {
+            rt_kprintf("set %s failed\n", key);
+            break;
+        }
+    }
+    tick = rt_tick_get() - tick;
+    bench_report("kv", i, tick, _ramnor.erase_num - erase_num, _ramnor.prog_bytes - prog_bytes);
+
+    /* verify the last values after the index is rebuilt */
+    rt_mtd_kv_deinit(&kv);
+    rt_mtd_kv_init(&kv, &_ramnor.mtd, 64);
+    for (i = count - 16 > 0 ? count - 16 : 0; i < count; i ++)
+    {
+        rt_snprintf(key, sizeof(key), "counter%d", i % 16);
+        if (rt_mtd_kv_get(&kv, key, &value, sizeof(value)) != sizeof(value) || value != i)
+        {
+            rt_kprintf("verify %s failed\n", key);
+            break;
+        }
+    }
+    rt_mtd_kv_dump(&kv);
+    rt_mtd_kv_deinit(&kv);
+
+#ifdef RT_USING_DFS
+    if (argc > 2)
+    {
+        char path[64];
+        int fd;
+
+        erase_num = _ramblk.erase_num;
+        prog_bytes = _ramblk.prog_bytes;
+        tick = rt_tick_get();
+        for (i = 0; i < count; i ++)
+        {
+            rt_snprintf(path, sizeof(path), "%s/counter%d", argv[2], i % 16);
+            fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0);
+            if (fd < 0)
+            {
+                rt_kprintf("open %s failed\n", path);
+                break;
+            }
+            value = i;
+            write(fd, &value, sizeof(value));
+            close(fd);
+        }
+        tick = rt_tick_get() - tick;
+        bench_report("file", i, tick, _ramblk.erase_num - erase_num, _ramblk.prog_bytes - prog_bytes);
+    }
+#endif
+}
+MSH_CMD_EXPORT(kv_bench, key-value storage benchmark: kv_bench [updates] [mounted path]);
+
+#endif /* defined(RT_USING_MTD_NOR_KV) && defined(RT_USING_FINSH) */
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * Small message round trip latency of SAL sockets over the loopback:
+ *
+ *     msh />net_latency [tcp|udp] [count] [size]
+ *
+ * An echo server thread and the client run on the same board, the client sends
+ * a message to 127.0.0.1 and waits for the echo. lwIP needs RT_LWIP_NETIF_LOOPBACK
+ * and a network interface which is up. Compare the results with and without
+ * SAL_USING_LWIP_FASTPATH.
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_SAL) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif
+
+#define NET_LATENCY_PORT        5001
+#define NET_LATENCY_SIZE_MAX    1024
+
+struct net_latency_server
+{
+    int tcp;
+    int size;
+    int count;
+    int sock;
+    struct rt_semaphore done;
+};
+
+static rt_uint32_t net_latency_now(void)
+{
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_gettime();
+#else
+    return rt_tick_get();
+#endif
+}
+
+static rt_uint32_t net_latency_us(rt_uint32_t begin)
+{
+    rt_uint32_t elapsed = net_latency_now() - begin;
+
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_microsecond(elapsed);
+#else
+    return (rt_uint32_t)((rt_uint64_t)elapsed * 1000000 / RT_TICK_PER_SECOND);
+#endif
+}
+
+/* receive the whole message of TCP stream */
+static int net_latency_recv(int sock, char *buf, int size, int tcp)
+{
+    int len = 0, result;
+
+    do
+    {
+        result = recv(sock, buf + len, size - len, 0);
+        if (result <= 0)
+            return -1;
+        len += result;
+    } while (tcp && len < size);
+
+    return len;
+}
+
+static void net_latency_server_entry(void *parameter)
+{
+    struct net_latency_server *server = (struct net_latency_server *)parameter;
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    char *buf;
+    int sock = -1, index, len, on = 1;
+
+    buf = rt_malloc(server->size);
+    if (buf == RT_NULL)
+        goto __exit;
+
+    if (server->tcp)
+    {
+        sock = accept(server->sock, (struct sockaddr *)&addr, &addr_len);
+        if (sock < 0)
+            goto __exit;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        for (index = 0; index < server->count; index ++)
+        {
+            if (net_latency_recv(sock, buf, server->size, 1) < 0 ||
+                send(sock, buf, server->size, 0) != server->size)
+                break;
+        }
+    }
+    else
+    {
+        for (index = 0; index < server->count; index ++)
+        {
+            len = recvfrom(server->sock, buf, server->size, 0, (struct sockaddr *)&addr, &addr_len);
+            if (len <= 0)
+                break;
+            sendto(server->sock, buf, len, 0, (struct sockaddr *)&addr, addr_len);
+        }
+    }
+
+__exit:
+    if (sock >= 0)
+        closesocket(sock);
+    rt_free(buf);
+    rt_sem_release(&server->done);
+}
+
+static int net_latency_compare(const void *a, const void *b)
+{
+    rt_uint32_t x = *(const rt_uint32_t *)a, y = *(const rt_uint32_t *)b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void net_latency(int argc, char **argv)
+{
+    struct net_latency_server server;
+    struct sockaddr_in addr;
+    struct timeval timeout;
+    rt_uint32_t *samples = RT_NULL, begin;
+    rt_uint64_t sum = 0;
+    rt_thread_t tid;
+    char *buf = RT_NULL;
+    int sock = -1, index, on = 1;
+
+    rt_memset(&server, 0, sizeof(server));
+    server.sock = -1;
+    server.tcp = 1;
+    server.count = 1000;
+    server.size = 32;
+
+    if (argc > 1)
+    {
+        if (strcmp(argv[1], "udp") == 0)
+            server.tcp = 0;
+        else if (strcmp(argv[1], "tcp") != 0)
+            goto __usage;
+    }
+    if (argc > 2)
+        server.count = atoi(argv[2]);
+    if (argc > 3)
+        server.size = atoi(argv[3]);
+    if (server.count <= 0 || server.size <= 0 || server.size > NET_LATENCY_SIZE_MAX)
+        goto __usage;
+
+    samples = rt_malloc(server.count * sizeof(rt_uint32_t));
+    buf = rt_malloc(server.size);
+    if (samples == RT_NULL || buf == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        goto __exit;
+    }
+    rt_memset(buf, 0x5A, server.size);
+
+    /* the server socket is ready before the client starts */
+    server.sock = socket(AF_INET, server.tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+    sock = socket(AF_INET, server.tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+    if (server.sock < 0 || sock < 0)
+    {
+        rt_kprintf("create socket failed\n");
+        goto __exit;
+    }
+
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(NET_LATENCY_PORT);
+    addr.sin_addr.s_addr = INADDR_ANY;
+    if (bind(server.sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        (server.tcp && listen(server.sock, 1) < 0))
+    {
+        rt_kprintf("bind port %d failed\n", NET_LATENCY_PORT);
+        goto __exit;
+    }
+
+    /* don't wait forever if the datagram is lost or the client fails */
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    setsockopt(server.sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    rt_sem_init(&server.done, "nlat", 0, RT_IPC_FLAG_FIFO);
+    tid = rt_thread_create("nlat", net_latency_server_entry, &server, 2048,
+                           RT_THREAD_PRIORITY_MAX / 2, 10);
+    if (tid == RT_NULL)
+    {
+        rt_sem_detach(&server.done);
+        goto __exit;
+    }
+    rt_thread_startup(tid);
+
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        rt_kprintf("connect failed\n");
+        index = 0;
+        goto __wait;
+    }
+    if (server.tcp)
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+    for (index = 0; index < server.count; index ++)
+    {
+        begin = net_latency_now();
+        if (send(sock, buf, server.size, 0) != server.size ||
+            net_latency_recv(sock, buf, server.size, server.tcp) < 0)
+        {
+            rt_kprintf("round trip %d failed\n", index);
+            break;
+        }
+        samples[index] = net_latency_us(begin);
+        sum += samples[index];
+    }
+
+__wait:
+    /* the server exits on the closed connection or the receive timeout */
+    closesocket(sock);
+    sock = -1;
+    rt_sem_take(&server.done, RT_WAITING_FOREVER);
+    rt_sem_detach(&server.done);
+
+    if (index > 0)
+    {
+        qsort(samples, index, sizeof(rt_uint32_t), net_latency_compare);
+        rt_kprintf("%s %d bytes, %d round trips: avg %d us, min %d us, p50 %d us, p99 %d us, max %d us\n",
+                   server.tcp ? "tcp" : "udp", server.size, index, (rt_uint32_t)(sum / index),
+                   samples[0], samples[index / 2], samples[index * 99 / 100], samples[index - 1]);
+    }
+
+__exit:
+    if (sock >= 0)
+        closesocket(sock);
+    if (server.sock >= 0)
+        closesocket(server.sock);
+    rt_free(samples);
+    rt_free(buf);
+    return;
+
+__usage:
+    rt_kprintf("Usage: net_latency [tcp|udp] [count] [size <= %d]\n", NET_LATENCY_SIZE_MAX);
+}
+MSH_CMD_EXPORT(net_latency, socket round trip latency: net_latency [tcp|udp] [count] [size]);
+
+#endif /* defined(RT_USING_SAL) && defined(RT_USING_FINSH) */
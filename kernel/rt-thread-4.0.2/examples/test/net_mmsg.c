@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * Small UDP datagrams over the loopback, sent one by one and in batches:
+ *
+ *     msh />net_mmsg [count] [batch] [size]
+ *
+ * Each datagram is a 4 bytes sequence header and a payload in two iovecs.
+ * The receiver thread takes them by recvmmsg() with MSG_WAITFORONE. lwIP
+ * needs RT_LWIP_NETIF_LOOPBACK and a network interface which is up.
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_SAL) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#define NET_MMSG_PORT           5003
+#define NET_MMSG_BATCH_MAX      32
+#define NET_MMSG_SIZE_MAX       512
+
+struct net_mmsg_receiver
+{
+    int sock;
+    int size;
+    rt_uint32_t datagrams;
+    rt_uint32_t calls;
+    rt_uint32_t errors;
+    rt_uint32_t sequence;
+    struct rt_semaphore done;
+};
+
+static void net_mmsg_receiver_entry(void *parameter)
+{
+    struct net_mmsg_receiver *receiver = (struct net_mmsg_receiver *)parameter;
+    static struct mmsghdr msgs[NET_MMSG_BATCH_MAX];
+    static struct iovec iovs[NET_MMSG_BATCH_MAX][2];
+    static rt_uint32_t headers[NET_MMSG_BATCH_MAX];
+    char *payloads;
+    int index, count;
+
+    payloads = rt_malloc(NET_MMSG_BATCH_MAX * NET_MMSG_SIZE_MAX);
+    if (payloads == RT_NULL)
+        goto __exit;
+
+    while (1)
+    {
+        rt_memset(msgs, 0, sizeof(msgs));
+        for (index = 0; index < NET_MMSG_BATCH_MAX; index ++)
+        {
+            iovs[index][0].iov_base = &headers[index];
+            iovs[index][0].iov_len = sizeof(rt_uint32_t);
+            iovs[index][1].iov_base = payloads + index * NET_MMSG_SIZE_MAX;
+            iovs[index][1].iov_len = NET_MMSG_SIZE_MAX;
+            msgs[index].msg_hdr.msg_iov = iovs[index];
+            msgs[index].msg_hdr.msg_iovlen = 2;
+        }
+
+        /* exit on the receive timeout */
+        count = recvmmsg(receiver->sock, msgs, NET_MMSG_BATCH_MAX, MSG_WAITFORONE, RT_NULL);
+        if (count <= 0)
+            break;
+        receiver->calls ++;
+
+        for (index = 0; index < count; index ++)
+        {
+            if (msgs[index].msg_len != sizeof(rt_uint32_t) + receiver->size)
+                receiver->errors ++;
+            /* the loopback keeps the order, the lost datagrams are counted by the sender */
+            if (headers[index] < receiver->sequence)
+                receiver->errors ++;
+            receiver->sequence = headers[index] + 1;
+        }
+        receiver->datagrams += count;
+    }
+
+__exit:
+    rt_free(payloads);
+    rt_sem_release(&receiver->done);
+}
+
+static int net_mmsg_send(int sock, struct sockaddr_in *addr, int count, int batch, int size,
+                         char *payload, rt_uint32_t *sequence)
+{
+    static struct mmsghdr msgs[NET_MMSG_BATCH_MAX];
+    static struct iovec iovs[NET_MMSG_BATCH_MAX][2];
+    static rt_uint32_t headers[NET_MMSG_BATCH_MAX];
+    int index, sent = 0, result;
+
+    while (sent < count)
+    {
+        int num = count - sent < batch ? count - sent : batch;
+
+        rt_memset(msgs, 0, sizeof(msgs));
+        for (index = 0; index < num; index ++)
+        {
+            headers[index] = (*sequence) ++;
+            iovs[index][0].iov_base = &headers[index];
+            iovs[index][0].iov_len = sizeof(rt_uint32_t);
+            iovs[index][1].iov_base = payload;
+            iovs[index][1].iov_len = size;
+            msgs[index].msg_hdr.msg_name = addr;
+            msgs[index].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            msgs[index].msg_hdr.msg_iov = iovs[index];
+            msgs[index].msg_hdr.msg_iovlen = 2;
+        }
+
+        if (batch == 1)
+            result = sendmsg(sock, &msgs[0].msg_hdr, 0) < 0 ? -1 : 1;
+        else
+            result = sendmmsg(sock, msgs, num, 0);
+        if (result <= 0)
+            break;
+        /* the datagrams not sent are sent again by the next call */
+        *sequence -= num - result;
+        sent += result;
+    }
+
+    return sent;
+}
+
+static void net_mmsg(int argc, char **argv)
+{
+    struct net_mmsg_receiver receiver;
+    struct sockaddr_in addr;
+    struct timeval timeout;
+    rt_uint32_t sequence = 0;
+    rt_thread_t tid;
+    rt_tick_t tick[2];
+    char *payload = RT_NULL;
+    int sock = -1, count = 10000, batch = 16, sent[2] = {0, 0};
+
+    rt_memset(&receiver, 0, sizeof(receiver));
+    receiver.sock = -1;
+    receiver.size = 32;
+
+    if (argc > 1)
+        count = atoi(argv[1]);
+    if (argc > 2)
+        batch = atoi(argv[2]);
+    if (argc > 3)
+        receiver.size = atoi(argv[3]);
+    if (count <= 0 || batch <= 0 || batch > NET_MMSG_BATCH_MAX ||
+        receiver.size <= 0 || receiver.size > NET_MMSG_SIZE_MAX)
+    {
+        rt_kprintf("Usage: net_mmsg [count] [batch <= %d] [size <= %d]\n",
+                   NET_MMSG_BATCH_MAX, NET_MMSG_SIZE_MAX);
+        return;
+    }
+
+    payload = rt_malloc(receiver.size);
+    receiver.sock = socket(AF_INET, SOCK_DGRAM, 0);
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (payload == RT_NULL || receiver.sock < 0 || sock < 0)
+    {
+        rt_kprintf("create socket failed\n");
+        goto __exit;
+    }
+    rt_memset(payload, 0x5A, receiver.size);
+
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(NET_MMSG_PORT);
+    addr.sin_addr.s_addr = INADDR_ANY;
+    if (bind(receiver.sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        rt_kprintf("bind port %d failed\n", NET_MMSG_PORT);
+        goto __exit;
+    }
+
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    setsockopt(receiver.sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    rt_sem_init(&receiver.done, "nmmsg", 0, RT_IPC_FLAG_FIFO);
+    tid = rt_thread_create("nmmsg", net_mmsg_receiver_entry, &receiver, 2048,
+                           RT_THREAD_PRIORITY_MAX / 2, 10);
+    if (tid == RT_NULL)
+    {
+        rt_sem_detach(&receiver.done);
+        goto __exit;
+    }
+    rt_thread_startup(tid);
+
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    /* one datagram per call, then the batches */
+    tick[0] = rt_tick_get();
+    sent[0] = net_mmsg_send(sock, &addr, count, 1, receiver.size, payload, &sequence);
+    tick[0] = rt_tick_get() - tick[0];
+
+    tick[1] = rt_tick_get();
+    sent[1] = net_mmsg_send(sock, &addr, count, batch, receiver.size, payload, &sequence);
+    tick[1] = rt_tick_get() - tick[1];
+
+    rt_sem_take(&receiver.done, RT_WAITING_FOREVER);
+    rt_sem_detach(&receiver.done);
+
+    rt_kprintf("sendmsg:  %d datagrams in %d ticks\n", sent[0], tick[0]);
+    rt_kprintf("sendmmsg: %d datagrams in %d ticks, batch %d\n", sent[1], tick[1], batch);
+    rt_kprintf("recvmmsg: %d datagrams in %d calls, %d lost, %d errors\n",
+               receiver.datagrams, receiver.calls, sent[0] + sent[1] - receiver.datagrams,
+               receiver.errors);
+
+__exit:
+    if (sock >= 0)
+        closesocket(sock);
+    if (receiver.sock >= 0)
+        closesocket(receiver.sock);
+    rt_free(payload);
+}
+MSH_CMD_EXPORT(net_mmsg, batched UDP datagrams: net_mmsg [count] [batch] [size]);
+
+#endif /* defined(RT_USING_SAL) && defined(RT_USING_FINSH) */
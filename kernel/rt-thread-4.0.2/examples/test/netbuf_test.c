@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * Zero-copy network buffer over the loopback:
+ *
+ *     msh />netbuf_test [tcp|udp] [count] [size]
+ *
+ * The client fills the network buffers in place and sends them to 127.0.0.1,
+ * the receiver thread checks the data in the received buffers segment by
+ * segment. lwIP needs RT_LWIP_NETIF_LOOPBACK and a network interface which is up.
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_SAL) && defined(SAL_USING_NETBUF) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#define NETBUF_TEST_PORT        5002
+#define NETBUF_TEST_SIZE_MAX    1400
+
+struct netbuf_test_receiver
+{
+    int tcp;
+    int sock;
+    rt_uint32_t expect;
+    rt_uint32_t bytes;
+    rt_uint32_t buffers;
+    rt_uint32_t errors;
+    struct rt_semaphore done;
+};
+
+/* the byte of stream offset, the datagram starts from 0 */
+#define NETBUF_TEST_BYTE(offset)    ((rt_uint8_t)((offset) % 251))
+
+static void netbuf_test_receiver_entry(void *parameter)
+{
+    struct netbuf_test_receiver *receiver = (struct netbuf_test_receiver *)parameter;
+    struct sal_netbuf *buf;
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    rt_uint32_t offset;
+    rt_uint8_t *data;
+    int sock = receiver->sock, index;
+
+    if (receiver->tcp)
+    {
+        sock = accept(receiver->sock, (struct sockaddr *)&addr, &addr_len);
+        if (sock < 0)
+            goto __exit;
+    }
+
+    while (receiver->bytes < receiver->expect)
+    {
+        if (sock_netbuf_recv(sock, &buf, 0, RT_NULL, RT_NULL) <= 0)
+            break;
+        receiver->buffers ++;
+
+        offset = receiver->tcp ? receiver->bytes : 0;
+        do
+        {
+            data = (rt_uint8_t *)buf->payload;
+            for (index = 0; index < buf->len; index ++, offset ++)
+            {
+                if (data[index] != NETBUF_TEST_BYTE(offset))
+                    receiver->errors ++;
+            }
+        } while (sal_netbuf_next(buf) == 0);
+
+        receiver->bytes += buf->tot_len;
+        sal_netbuf_free(buf);
+    }
+
+__exit:
+    if (receiver->tcp && sock >= 0)
+        closesocket(sock);
+    rt_sem_release(&receiver->done);
+}
+
+static void netbuf_test(int argc, char **argv)
+{
+    struct netbuf_test_receiver receiver;
+    struct sockaddr_in addr;
+    struct timeval timeout;
+    struct sal_netbuf *buf;
+    rt_uint32_t offset = 0;
+    rt_thread_t tid;
+    rt_tick_t tick;
+    rt_uint8_t *data;
+    int sock = -1, count = 1000, size = 1024, index = 0, len;
+
+    rt_memset(&receiver, 0, sizeof(receiver));
+    receiver.sock = -1;
+    receiver.tcp = 1;
+
+    if (argc > 1)
+    {
+        if (strcmp(argv[1], "udp") == 0)
+            receiver.tcp = 0;
+        else if (strcmp(argv[1], "tcp") != 0)
+            goto __usage;
+    }
+    if (argc > 2)
+        count = atoi(argv[2]);
+    if (argc > 3)
+        size = atoi(argv[3]);
+    if (count <= 0 || size <= 0 || size > NETBUF_TEST_SIZE_MAX)
+        goto __usage;
+    receiver.expect = count * size;
+
+    receiver.sock = socket(AF_INET, receiver.tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+    sock = socket(AF_INET, receiver.tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+    if (receiver.sock < 0 || sock < 0)
+    {
+        rt_kprintf("create socket failed\n");
+        goto __exit;
+    }
+
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(NETBUF_TEST_PORT);
+    addr.sin_addr.s_addr = INADDR_ANY;
+    if (bind(receiver.sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        (receiver.tcp && listen(receiver.sock, 1) < 0))
+    {
+        rt_kprintf("bind port %d failed\n", NETBUF_TEST_PORT);
+        goto __exit;
+    }
+
+    /* the lost datagrams don't block the receiver */
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    setsockopt(receiver.sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    rt_sem_init(&receiver.done, "nbuf", 0, RT_IPC_FLAG_FIFO);
+    tid = rt_thread_create("nbuf", netbuf_test_receiver_entry, &receiver, 2048,
+                           RT_THREAD_PRIORITY_MAX / 2, 10);
+    if (tid == RT_NULL)
+    {
+        rt_sem_detach(&receiver.done);
+        goto __exit;
+    }
+    rt_thread_startup(tid);
+
+    tick = rt_tick_get();
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        rt_kprintf("connect failed\n");
+        goto __wait;
+    }
+
+    for (index = 0; index < count; index ++)
+    {
+        buf = sock_netbuf_alloc(sock, size);
+        if (buf == RT_NULL)
+        {
+            rt_kprintf("no network buffer\n");
+            break;
+        }
+
+        /* fill the data in place */
+        if (!receiver.tcp)
+            offset = 0;
+        do
+        {
+            data = (rt_uint8_t *)buf->payload;
+            for (len = 0; len < buf->len; len ++, offset ++)
+                data[len] = NETBUF_TEST_BYTE(offset);
+        } while (sal_netbuf_next(buf) == 0);
+
+        if (sock_netbuf_send(sock, buf, size, 0, RT_NULL, 0) != size)
+        {
+            rt_kprintf("send %d failed\n", index);
+            break;
+        }
+    }
+
+__wait:
+    /* the receiver exits on the closed connection or the receive timeout */
+    closesocket(sock);
+    sock = -1;
+    rt_sem_take(&receiver.done, RT_WAITING_FOREVER);
+    rt_sem_detach(&receiver.done);
+    tick = rt_tick_get() - tick;
+
+    rt_kprintf("%s sent %d buffers, received %d bytes in %d buffers, %d errors, %d ticks\n",
+               receiver.tcp ? "tcp" : "udp", index, receiver.bytes, receiver.buffers,
+               receiver.errors, tick);
+
+__exit:
+    if (sock >= 0)
+        closesocket(sock);
+    if (receiver.sock >= 0)
+        closesocket(receiver.sock);
+    return;
+
+__usage:
+    rt_kprintf("Usage: netbuf_test [tcp|udp] [count] [size <= %d]\n", NETBUF_TEST_SIZE_MAX);
+}
+MSH_CMD_EXPORT(netbuf_test, zero-copy network buffer test: netbuf_test [tcp|udp] [count] [size]);
+
+#endif /* defined(RT_USING_SAL) && defined(SAL_USING_NETBUF) && defined(RT_USING_FINSH) */
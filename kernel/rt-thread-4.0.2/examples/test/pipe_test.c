@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * Throughput of pipe between two threads:
+ *
+ *     msh />pipe_bench [write|writev|vmsplice] [block size] [total KB]
+ *
+ * write    - the writer thread writes the block by write()
+ * writev   - the block is written in 4 parts by writev()
+ * vmsplice - the block is malloc'd and given to the pipe by vmsplice(SPLICE_F_GIFT),
+ *            the reader copies it directly without the ring buffer
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(RT_USING_POSIX) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <dfs_posix.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PIPE_BENCH_WRITE        0
+#define PIPE_BENCH_WRITEV       1
+#define PIPE_BENCH_VMSPLICE     2
+
+struct pipe_bench
+{
+    int fd;
+    int mode;
+    rt_size_t block;
+    rt_size_t total;
+    rt_size_t written;
+    struct rt_semaphore done;
+};
+
+static void pipe_bench_writer(void *parameter)
+{
+    struct pipe_bench *bench = (struct pipe_bench *)parameter;
+    rt_uint8_t *buf;
+    int result;
+
+    buf = rt_malloc(bench->block);
+    if (buf == RT_NULL)
+        goto __exit;
+    rt_memset(buf, 0x5A, bench->block);
+
+    while (bench->written < bench->total)
+    {
+        if (bench->mode == PIPE_BENCH_WRITEV)
+        {
+            struct iovec iov[4];
+            rt_size_t part = bench->block / 4;
+            int index;
+
+            for (index = 0; index < 4; index ++)
+            {
+                iov[index].iov_base = buf + index * part;
+                iov[index].iov_len = (index == 3) ? bench->block - 3 * part : part;
+            }
+            result = writev(bench->fd, iov, 4);
+        }
+#ifdef RT_PIPE_USING_LOCKFREE
+        else if (bench->mode == PIPE_BENCH_VMSPLICE)
+        {
+            struct iovec iov;
+
+            /* the buffer is owned by the pipe after it's given */
+            iov.iov_base = rt_malloc(bench->block);
+            if (iov.iov_base == RT_NULL)
+                break;
+            iov.iov_len = bench->block;
+            result = vmsplice(bench->fd, &iov, 1, SPLICE_F_GIFT);
+            if (result < 0)
+                rt_free(iov.iov_base);
+        }
+#endif
+        else
+        {
+            result = write(bench->fd, buf, bench->block);
+        }
+
+        if (result <= 0)
+            break;
+        bench->written += result;
+    }
+
+    rt_free(buf);
+
+__exit:
+    close(bench->fd);
+    rt_sem_release(&bench->done);
+}
+
+static void pipe_bench(int argc, char **argv)
+{
+    struct pipe_bench bench;
+    rt_thread_t tid;
+    rt_uint8_t *buf;
+    int fds[2], result;
+    rt_size_t bytes = 0;
+    rt_tick_t tick;
+
+    rt_memset(&bench, 0, sizeof(bench));
+    bench.block = 256;
+    bench.total = 1024 * 1024;
+
+    if (argc > 1)
+    {
+        if (strcmp(argv[1], "writev") == 0)
+            bench.mode = PIPE_BENCH_WRITEV;
+        else if (strcmp(argv[1], "vmsplice") == 0)
+            bench.mode = PIPE_BENCH_VMSPLICE;
+        else if (strcmp(argv[1], "write") != 0)
+            goto __usage;
+    }
+    if (argc > 2)
+        bench.block = atoi(argv[2]);
+    if (argc > 3)
+        bench.total = atoi(argv[3]) * 1024;
+    if (bench.block < 4 || bench.total == 0)
+        goto __usage;
+
+#ifndef RT_PIPE_USING_LOCKFREE
+    if (bench.mode == PIPE_BENCH_VMSPLICE)
+    {
+        rt_kprintf("vmsplice needs RT_PIPE_USING_LOCKFREE\n");
+        return;
+    }
+#endif
+
+    buf = rt_malloc(bench.block);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return;
+    }
+
+    if (pipe(fds) < 0)
+    {
+        rt_kprintf("create pipe failed\n");
+        rt_free(buf);
+        return;
+    }
+    bench.fd = fds[1];
+    rt_sem_init(&bench.done, "pbench", 0, RT_IPC_FLAG_FIFO);
+
+    tid = rt_thread_create("pbench", pipe_bench_writer, &bench, 2048,
+                           RT_THREAD_PRIORITY_MAX / 2, 10);
+    if (tid == RT_NULL)
+    {
+        rt_kprintf("create thread failed\n");
+        close(fds[0]);
+        close(fds[1]);
+        rt_sem_detach(&bench.done);
+        rt_free(buf);
+        return;
+    }
+
+    tick = rt_tick_get();
+    rt_thread_startup(tid);
+
+    /* read until the writer closes the pipe */
+    while ((result = read(fds[0], buf, bench.block)) > 0)
+    {
+        bytes += result;
+    }
+    tick = rt_tick_get() - tick;
+
+    rt_sem_take(&bench.done, RT_WAITING_FOREVER);
+    close(fds[0]);
+    rt_sem_detach(&bench.done);
+    rt_free(buf);
+
+    if (tick == 0)
+        tick = 1;
+    rt_kprintf("%s: block %d, %d bytes in %d ticks, %d KB/s\n",
+               argc > 1 ? argv[1] : "write", bench.block, bytes, tick,
+               (rt_uint32_t)((rt_uint64_t)bytes * RT_TICK_PER_SECOND / tick / 1024));
+    if (bytes != bench.written)
+        rt_kprintf("read %d bytes, but %d bytes written\n", bytes, bench.written);
+    return;
+
+__usage:
+    rt_kprintf("Usage: pipe_bench [write|writev|vmsplice] [block size] [total KB]\n");
+}
+MSH_CMD_EXPORT(pipe_bench, pipe throughput: pipe_bench [write|writev|vmsplice] [block size] [total KB]);
+
+#endif /* defined(RT_USING_POSIX) && defined(RT_USING_FINSH) */
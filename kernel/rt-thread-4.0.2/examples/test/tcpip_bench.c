@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * Message throughput of lwIP thread and mailbox:
+ *
+ *     msh />tcpip_bench [mbox|callback|api] [threads] [count]
+ *
+ * mbox:     the threads post the messages to a mailbox, a consumer thread fetches them.
+ * callback: the threads post tcpip_callback() to lwIP thread, a message per call.
+ * api:      the threads call tcpip_api_call(), it's a direct call under the core
+ *           lock when LWIP_TCPIP_CORE_LOCKING is enabled.
+ *
+ * Compare the results with and without RT_LWIP_USING_LOCKFREE_MBOX, and with
+ * the different RT_LWIP_TCPTHREAD_MSG_BATCH.
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_LWIP210) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lwip/sys.h>
+#include <lwip/tcpip.h>
+#include <lwip/priv/tcpip_priv.h>
+
+#define TCPIP_BENCH_THREADS_MAX 8
+
+enum tcpip_bench_mode
+{
+    TCPIP_BENCH_MBOX,
+    TCPIP_BENCH_CALLBACK,
+    TCPIP_BENCH_API,
+};
+
+struct tcpip_bench
+{
+    enum tcpip_bench_mode mode;
+    int count;                          /* the messages of each thread */
+    rt_uint32_t total;
+    volatile rt_uint32_t handled;
+    volatile rt_uint32_t retries;       /* the calls failed on no tcpip_msg */
+    sys_mbox_t mbox;
+    struct rt_semaphore done;
+};
+
+struct tcpip_bench_call
+{
+    struct tcpip_api_call_data call;
+    struct tcpip_bench *bench;
+};
+
+static const char *tcpip_bench_name[] = {"mbox", "callback", "api"};
+
+static void tcpip_bench_handler(void *ctx)
+{
+    struct tcpip_bench *bench = (struct tcpip_bench *)ctx;
+
+    /* in lwIP thread or under the core lock */
+    if (++ bench->handled == bench->total)
+        rt_sem_release(&bench->done);
+}
+
+static err_t tcpip_bench_api(struct tcpip_api_call_data *call)
+{
+    tcpip_bench_handler(((struct tcpip_bench_call *)call)->bench);
+
+    return ERR_OK;
+}
+
+static void tcpip_bench_consumer_entry(void *parameter)
+{
+    struct tcpip_bench *bench = (struct tcpip_bench *)parameter;
+    void *msg;
+
+    while (bench->handled < bench->total)
+    {
+        sys_arch_mbox_fetch(&bench->mbox, &msg, 0);
+        bench->handled ++;
+    }
+    rt_sem_release(&bench->done);
+}
+
+static void tcpip_bench_producer_entry(void *parameter)
+{
+    struct tcpip_bench *bench = (struct tcpip_bench *)parameter;
+    struct tcpip_bench_call call;
+    int index;
+
+    call.bench = bench;
+    for (index = 0; index < bench->count; index ++)
+    {
+        switch (bench->mode)
+        {
+        case TCPIP_BENCH_MBOX:
+            sys_mbox_post(&bench->mbox, bench);
+            break;
+        case TCPIP_BENCH_CALLBACK:
+            while (tcpip_callback(tcpip_bench_handler, bench) != ERR_OK)
+            {
+                bench->retries ++;
+                rt_thread_delay(1);
+            }
+            break;
+        case TCPIP_BENCH_API:
+            while (tcpip_api_call(tcpip_bench_api, &call.call) != ERR_OK)
+            {
+                bench->retries ++;
+                rt_thread_delay(1);
+            }
+            break;
+        }
+    }
+    rt_sem_release(&bench->done);
+}
+
+static void tcpip_bench(int argc, char **argv)
+{
+    struct tcpip_bench bench;
+    rt_thread_t tids[TCPIP_BENCH_THREADS_MAX + 1];
+    rt_tick_t tick;
+    int threads = 2, created = 0, index;
+
+    rt_memset(&bench, 0, sizeof(bench));
+    bench.mode = TCPIP_BENCH_CALLBACK;
+    bench.count = 10000;
+
+    if (argc > 1)
+    {
+        for (index = 0; index < sizeof(tcpip_bench_name) / sizeof(tcpip_bench_name[0]); index ++)
+        {
+            if (strcmp(argv[1], tcpip_bench_name[index]) == 0)
+                break;
+        }
+        if (index == sizeof(tcpip_bench_name) / sizeof(tcpip_bench_name[0]))
+            goto __usage;
+        bench.mode = (enum tcpip_bench_mode)index;
+    }
+    if (argc > 2)
+        threads = atoi(argv[2]);
+    if (argc > 3)
+        bench.count = atoi(argv[3]);
+    if (threads <= 0 || threads > TCPIP_BENCH_THREADS_MAX || bench.count <= 0)
+        goto __usage;
+    bench.total = threads * bench.count;
+
+    if (bench.mode == TCPIP_BENCH_MBOX && sys_mbox_new(&bench.mbox, TCPIP_MBOX_SIZE) != ERR_OK)
+    {
+        rt_kprintf("create mailbox failed\n");
+        return;
+    }
+    rt_sem_init(&bench.done, "tbench", 0, RT_IPC_FLAG_FIFO);
+
+    /* the producers run below lwIP thread as the application threads do, the
+     * consumer of mailbox has the priority of lwIP thread */
+    for (created = 0; created < threads; created ++)
+    {
+        tids[created] = rt_thread_create("tbprod", tcpip_bench_producer_entry, &bench, 1024,
+                                         TCPIP_THREAD_PRIO + 1, 10);
+        if (tids[created] == RT_NULL)
+            break;
+    }
+    if (created == threads && bench.mode == TCPIP_BENCH_MBOX)
+    {
+        tids[created] = rt_thread_create("tbcons", tcpip_bench_consumer_entry, &bench, 1024,
+                                         TCPIP_THREAD_PRIO, 10);
+        if (tids[created] != RT_NULL)
+            created ++;
+    }
+    if (created != threads + (bench.mode == TCPIP_BENCH_MBOX))
+    {
+        rt_kprintf("create thread failed\n");
+        while (created --)
+            rt_thread_delete(tids[created]);
+        goto __exit;
+    }
+
+    tick = rt_tick_get();
+    for (index = 0; index < created; index ++)
+        rt_thread_startup(tids[index]);
+
+    /* the producers exit and the last message is handled */
+    for (index = 0; index < threads + 1; index ++)
+        rt_sem_take(&bench.done, RT_WAITING_FOREVER);
+    tick = rt_tick_get() - tick;
+    if (tick == 0)
+        tick = 1;
+
+    rt_kprintf("%s: %d threads, %d messages, %d retries in %d ticks, %d msgs/s\n",
+               tcpip_bench_name[bench.mode], threads, bench.handled, bench.retries, tick,
+               (rt_uint32_t)((rt_uint64_t)bench.handled * RT_TICK_PER_SECOND / tick));
+
+__exit:
+    rt_sem_detach(&bench.done);
+    if (bench.mode == TCPIP_BENCH_MBOX)
+        sys_mbox_free(&bench.mbox);
+    return;
+
+__usage:
+    rt_kprintf("Usage: tcpip_bench [mbox|callback|api] [threads <= %d] [count]\n",
+               TCPIP_BENCH_THREADS_MAX);
+}
+MSH_CMD_EXPORT(tcpip_bench, lwIP message throughput: tcpip_bench [mbox|callback|api] [threads] [count]);
+
+#endif /* defined(RT_USING_LWIP210) && defined(RT_USING_FINSH) */
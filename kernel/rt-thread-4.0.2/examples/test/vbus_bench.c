@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * The VBus channel throughput between two RT-Thread instances:
+ *
+ *     msh />vbus_bench server
+ *     msh />vbus_bench client [copy|zc] [count] [size]
+ *
+ * It runs between two RT-Thread instances sharing memory, the out ring and area
+ * of one instance are the in ring and area of the other one. The server listens
+ * on the channel "vbench" in one instance, then the client in the other instance
+ * posts the packets on it.
+ *
+ * The port of platform must provide the VBus glue, which is not in this tree:
+ * rt_vbus_init and rt_vbus_zc_init on the shared memory, rt_vbus_tick raising
+ * the interrupt of the other instance, and rt_vbus_isr called on it. No BSP of
+ * this tree does it, so the command is built but can't run on them yet.
+ *
+ * copy: the packets are posted by rt_vbus_post and copied into the ring.
+ * zc:   the packets are filled into the buffers of rt_vbus_buf_alloc and
+ *       posted by rt_vbus_buf_post without copying.
+ *
+ * The server replies the number of packets and bytes received at the end.
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_VBUS) && defined(RT_USING_FINSH)
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vbus.h>
+
+#define VBUS_BENCH_CHN          "vbench"
+#define VBUS_BENCH_PRIO         20
+#define VBUS_BENCH_COUNT        10000
+#define VBUS_BENCH_TIMEOUT      (RT_TICK_PER_SECOND * 5)
+
+#define VBUS_BENCH_DATA         'D'
+#define VBUS_BENCH_END          'E'
+#define VBUS_BENCH_REPORT       'R'
+
+struct vbus_bench_report
+{
+    rt_uint8_t type;
+    rt_uint8_t reserved[3];
+    rt_uint32_t packets;
+    rt_uint32_t bytes;
+};
+
+static rt_thread_t vbus_bench_server_tid = RT_NULL;
+static struct vbus_bench_report vbus_bench_server_report;
+static rt_uint8_t vbus_bench_buf[RT_VBUS_MAX_PKT_SZ];
+static const rt_uint8_t vbus_bench_end = VBUS_BENCH_END;
+
+static void vbus_bench_request(struct rt_vbus_request *req, int is_server)
+{
+    rt_memset(req, 0, sizeof(*req));
+    req->prio = VBUS_BENCH_PRIO;
+    req->name = VBUS_BENCH_CHN;
+    req->is_server = is_server;
+    req->recv_wm.low = RT_VMM_RB_BLK_NR / 3;
+    req->recv_wm.high = RT_VMM_RB_BLK_NR * 2 / 3;
+    req->post_wm.low = RT_VMM_RB_BLK_NR / 3;
+    req->post_wm.high = RT_VMM_RB_BLK_NR * 2 / 3;
+}
+
+static void vbus_bench_server_entry(void *parameter)
+{
+    struct vbus_bench_report *report = &vbus_bench_server_report;
+    struct rt_vbus_request req;
+    struct rt_vbus_data *data;
+    int chnr;
+
+    vbus_bench_request(&req, 1);
+
+    while (1)
+    {
+        chnr = rt_vbus_request_chn(&req, RT_WAITING_FOREVER);
+        if (chnr < 0)
+        {
+            rt_thread_mdelay(1000);
+            continue;
+        }
+
+        report->packets = 0;
+        report->bytes = 0;
+
+        /* it fails when the channel is closed by the client */
+        while (rt_vbus_listen_on(chnr, RT_WAITING_FOREVER) == RT_EOK)
+        {
+            while ((data = rt_vbus_data_pop(chnr)) != RT_NULL)
+            {
+                rt_uint8_t type = *(rt_uint8_t *)(data + 1);
+
+                if (type == VBUS_BENCH_DATA)
+                {
+                    report->packets ++;
+                    report->bytes += data->size;
+                }
+                else if (type == VBUS_BENCH_END)
+                {
+                    report->type = VBUS_BENCH_REPORT;
+                    rt_vbus_post(chnr, VBUS_BENCH_PRIO, report, sizeof(*report), RT_WAITING_FOREVER);
+                }
+                rt_vbus_data_free(data);
+            }
+        }
+
+        rt_vbus_close_chn(chnr);
+    }
+}
+
+/* post a packet of the type, it's in the zero-copy area if zc is set */
+static rt_err_t vbus_bench_post(int chnr, rt_bool_t zc, rt_uint8_t type, rt_size_t size)
+{
+#ifdef RT_VBUS_USING_ZERO_COPY
+    if (zc)
+    {
+        rt_uint8_t *buf;
+        rt_err_t err;
+
+        buf = rt_vbus_buf_alloc(size, VBUS_BENCH_TIMEOUT);
+        if (buf == RT_NULL)
+            return -RT_ENOMEM;
+
+        buf[0] = type;
+        err = rt_vbus_buf_post(chnr, VBUS_BENCH_PRIO, buf, size, RT_WAITING_FOREVER);
+        if (err != RT_EOK)
+            rt_vbus_buf_free(buf);
+
+        return err;
+    }
+#endif
+
+    /* the static data is not changed before it's written into the ring */
+    if (type == VBUS_BENCH_END)
+        return rt_vbus_post(chnr, VBUS_BENCH_PRIO, &vbus_bench_end, 1, RT_WAITING_FOREVER);
+
+    return rt_vbus_post(chnr, VBUS_BENCH_PRIO, vbus_bench_buf, size, RT_WAITING_FOREVER);
+}
+
+/* wait for the report of server */
+static rt_err_t vbus_bench_wait_report(int chnr, struct vbus_bench_report *report)
+{
+    struct rt_vbus_data *data;
+    rt_err_t err;
+
+    while ((err = rt_vbus_listen_on(chnr, VBUS_BENCH_TIMEOUT)) == RT_EOK)
+    {
+        while ((data = rt_vbus_data_pop(chnr)) != RT_NULL)
+        {
+            if (data->size == sizeof(*report) && *(rt_uint8_t *)(data + 1) == VBUS_BENCH_REPORT)
+            {
+                rt_memcpy(report, data + 1, sizeof(*report));
+                rt_vbus_data_free(data);
+                return RT_EOK;
+            }
+            rt_vbus_data_free(data);
+        }
+    }
+
+    return err;
+}
+
+static int vbus_bench_client(rt_bool_t zc, rt_uint32_t count, rt_size_t size)
+{
+    struct rt_vbus_request req;
+    struct vbus_bench_report report;
+    rt_uint32_t index, ms;
+    rt_tick_t tick;
+    int chnr;
+
+    vbus_bench_request(&req, 0);
+    chnr = rt_vbus_request_chn(&req, VBUS_BENCH_TIMEOUT);
+    if (chnr < 0)
+    {
+        rt_kprintf("request the channel %s failed: %d\n", VBUS_BENCH_CHN, chnr);
+        return -1;
+    }
+
+    vbus_bench_buf[0] = VBUS_BENCH_DATA;
+
+    tick = rt_tick_get();
+    for (index = 0; index < count; index++)
+    {
+        if (vbus_bench_post(chnr, zc, VBUS_BENCH_DATA, size) != RT_EOK)
+        {
+            rt_kprintf("post the packet %d failed\n", index);
+            break;
+        }
+    }
+
+    if (vbus_bench_post(chnr, zc, VBUS_BENCH_END, zc ? size : 1) != RT_EOK ||
+        vbus_bench_wait_report(chnr, &report) != RT_EOK)
+    {
+        rt_kprintf("no report from the server\n");
+        rt_vbus_close_chn(chnr);
+        return -1;
+    }
+    tick = rt_tick_get() - tick;
+    ms = tick * 1000 / RT_TICK_PER_SECOND;
+
+    rt_kprintf("%s: %d packets of %d bytes posted in %d ms\n", zc ? "zc" : "copy", index, size, ms);
+    rt_kprintf("server received %d packets, %d bytes, %d KB/s\n", report.packets, report.bytes,
+               ms ? report.bytes / ms * 1000 / 1024 : report.bytes / 1024 * RT_TICK_PER_SECOND);
+
+    rt_vbus_close_chn(chnr);
+
+    return 0;
+}
+
+static int vbus_bench(int argc, char **argv)
+{
+    rt_bool_t zc = RT_FALSE;
+    rt_uint32_t count = VBUS_BENCH_COUNT;
+    rt_size_t size, size_max = RT_VBUS_MAX_PKT_SZ;
+
+    if (argc == 2 && strcmp(argv[1], "server") == 0)
+    {
+        if (vbus_bench_server_tid != RT_NULL)
+        {
+            rt_kprintf("the server is running\n");
+            return 0;
+        }
+
+        vbus_bench_server_tid = rt_thread_create("vbench", vbus_bench_server_entry, RT_NULL,
+                                                 2048, RT_THREAD_PRIORITY_MAX / 2, 10);
+        if (vbus_bench_server_tid == RT_NULL)
+            return -1;
+
+        rt_thread_startup(vbus_bench_server_tid);
+        return 0;
+    }
+
+    if (argc < 2 || strcmp(argv[1], "client") != 0)
+        goto __usage;
+
+    if (argc > 2)
+    {
+        if (strcmp(argv[2], "zc") == 0)
+        {
+#ifdef RT_VBUS_USING_ZERO_COPY
+            zc = RT_TRUE;
+            size_max = RT_VBUS_ZC_MAX_PKT_SZ;
+#else
+            rt_kprintf("the zero-copy area is not enabled\n");
+            return -1;
+#endif
+        }
+        else if (strcmp(argv[2], "copy") != 0)
+        {
+            goto __usage;
+        }
+    }
+    if (argc > 3)
+        count = atoi(argv[3]);
+    size = (argc > 4) ? atoi(argv[4]) : size_max;
+
+    if (count == 0 || size == 0 || size > size_max)
+        goto __usage;
+
+    return vbus_bench_client(zc, count, size);
+
+__usage:
+    rt_kprintf("Usage: vbus_bench server\n");
+    rt_kprintf("       vbus_bench client [copy|zc] [count] [size]\n");
+    rt_kprintf("the size is up to %d bytes of copy", RT_VBUS_MAX_PKT_SZ);
+#ifdef RT_VBUS_USING_ZERO_COPY
+    rt_kprintf(", %d bytes of zc", RT_VBUS_ZC_MAX_PKT_SZ);
+#endif
+    rt_kprintf("\n");
+    return -1;
+}
+MSH_CMD_EXPORT(vbus_bench, VBus channel throughput benchmark);
+#endif
@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2006-2018, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-18     liujiahao    the first version
+ */
+
+/*
+ * The WLAN data path throughput between wlan_dev and lwIP:
+ *
+ *     msh />wlan_bench [rx|tx] [copy|zc] [count] [size]
+ *
+ * A loopback WLAN device "wlan_lb" is attached to the lwIP protocol with the
+ * address 192.168.250.1/24, it works without the WLAN hardware, such as on the
+ * simulator.
+ *
+ * rx: the device receives the UDP frames from 192.168.250.2 to the port 5001,
+ *     they are received by a socket. The "copy" frames are received into the
+ *     buffer of device and reported by rt_wlan_dev_report_data(), the "zc" frames
+ *     are received into the buffer lent by rt_wlan_dev_alloc_buff().
+ * tx: a socket sends the UDP datagrams to 192.168.250.255, they are sent by the
+ *     device with wlan_send or wlan_send_sg of "zc".
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_USING_WIFI) && defined(RT_WLAN_PROT_LWIP_ENABLE) && defined(RT_USING_NETDEV) && \
+    defined(RT_USING_FINSH) && !defined(RT_WLAN_PROT_LWIP_PBUF_FORCE)
+#include <finsh.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wlan_dev.h>
+#include <wlan_prot.h>
+#include <lwip/sockets.h>
+#include <lwip/netifapi.h>
+#include <lwip/inet_chksum.h>
+#include <netdev.h>
+
+#ifndef RT_WLAN_PROT_LWIP_NAME
+#define RT_WLAN_PROT_LWIP_NAME  "lwip"
+#endif
+
+#define WLAN_BENCH_DEVICE       "wlan_lb"
+#define WLAN_BENCH_ADDR         "192.168.250.1"
+#define WLAN_BENCH_PEER         "192.168.250.2"
+#define WLAN_BENCH_BROADCAST    "192.168.250.255"
+#define WLAN_BENCH_NETMASK      "255.255.255.0"
+#define WLAN_BENCH_PORT         5001
+#define WLAN_BENCH_HDR_LEN      (14 + 20 + 8)
+#define WLAN_BENCH_SIZE_MAX     1472
+#define WLAN_BENCH_TIMEOUT      (RT_TICK_PER_SECOND * 2)
+
+struct wlan_bench
+{
+    struct rt_wlan_device wlan;
+    rt_bool_t attached;
+    struct netif *netif;
+
+    rt_uint32_t tx_expect;
+    volatile rt_uint32_t tx_frames;
+    volatile rt_uint32_t tx_bytes;
+    volatile rt_uint32_t tx_segs;
+    struct rt_semaphore tx_done;
+
+    rt_uint32_t rx_expect;
+    rt_uint32_t rx_frames;
+    rt_uint32_t rx_bytes;
+    rt_tick_t rx_tick;                  /* the tick when the last frame is received */
+    struct rt_semaphore rx_ready;
+    struct rt_semaphore rx_done;
+
+    rt_uint8_t frame[WLAN_BENCH_HDR_LEN + WLAN_BENCH_SIZE_MAX];
+    rt_uint8_t dma_buf[WLAN_BENCH_HDR_LEN + WLAN_BENCH_SIZE_MAX];
+};
+
+static struct wlan_bench wlan_bench_dev;
+static const rt_uint8_t wlan_bench_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const rt_uint8_t wlan_bench_peer_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+
+static rt_err_t wlan_bench_init(struct rt_wlan_device *wlan)
+{
+    return RT_EOK;
+}
+
+static rt_err_t wlan_bench_mode(struct rt_wlan_device *wlan, rt_wlan_mode_t mode)
+{
+    return RT_EOK;
+}
+
+static rt_err_t wlan_bench_get_mac(struct rt_wlan_device *wlan, rt_uint8_t mac[])
+{
+    rt_memcpy(mac, wlan_bench_mac, sizeof(wlan_bench_mac));
+    return RT_EOK;
+}
+
+static void wlan_bench_sent(struct wlan_bench *bench, int len, int segs)
+{
+    bench->tx_bytes += len;
+    bench->tx_segs += segs;
+    if (++ bench->tx_frames == bench->tx_expect)
+        rt_sem_release(&bench->tx_done);
+}
+
+static int wlan_bench_send(struct rt_wlan_device *wlan, void *buff, int len)
+{
+    struct wlan_bench *bench = (struct wlan_bench *)wlan;
+
+    /* the frame is transferred by DMA from the buffer */
+    wlan_bench_sent(bench, len, 1);
+    return len;
+}
+
+static int wlan_bench_send_sg(struct rt_wlan_device *wlan, const struct rt_wlan_buff *segs, int count)
+{
+    struct wlan_bench *bench = (struct wlan_bench *)wlan;
+    int index, len = 0;
+
+    /* the segments are transferred by DMA one by one */
+    for (index = 0; index < count; index++)
+        len += segs[index].len;
+
+    wlan_bench_sent(bench, len, count);
+    return len;
+}
+
+static const struct rt_wlan_dev_ops wlan_bench_copy_ops =
+{
+    .wlan_init = wlan_bench_init,
+    .wlan_mode = wlan_bench_mode,
+    .wlan_get_mac = wlan_bench_get_mac,
+    .wlan_send = wlan_bench_send,
+};
+
+static const struct rt_wlan_dev_ops wlan_bench_zc_ops =
+{
+    .wlan_init = wlan_bench_init,
+    .wlan_mode = wlan_bench_mode,
+    .wlan_get_mac = wlan_bench_get_mac,
+    .wlan_send = wlan_bench_send,
+    .wlan_send_sg = wlan_bench_send_sg,
+};
+
+static int wlan_bench_attach(struct wlan_bench *bench)
+{
+    ip4_addr_t addr, netmask, gw;
+
+    if (bench->attached)
+        return RT_EOK;
+
+    if (rt_wlan_dev_register(&bench->wlan, WLAN_BENCH_DEVICE, &wlan_bench_copy_ops, 0, RT_NULL) != RT_EOK)
+    {
+        rt_kprintf("register %s failed\n", WLAN_BENCH_DEVICE);
+        return -RT_ERROR;
+    }
+    if (rt_wlan_prot_attach_dev(&bench->wlan, RT_WLAN_PROT_LWIP_NAME) != RT_EOK || bench->wlan.netdev == RT_NULL)
+    {
+        rt_kprintf("attach %s to lwIP failed\n", WLAN_BENCH_DEVICE);
+        return -RT_ERROR;
+    }
+    bench->netif = (struct netif *)bench->wlan.netdev->user_data;
+
+    ip4addr_aton(WLAN_BENCH_ADDR, &addr);
+    ip4addr_aton(WLAN_BENCH_NETMASK, &netmask);
+    ip4_addr_set_zero(&gw);
+#if LWIP_DHCP
+    netifapi_dhcp_stop(bench->netif);
+#endif
+    netifapi_netif_set_addr(bench->netif, &addr, &netmask, &gw);
+    netifapi_netif_set_link_up(bench->netif);
+
+    rt_sem_init(&bench->tx_done, "wb_tx", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&bench->rx_ready, "wb_rdy", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&bench->rx_done, "wb_rx", 0, RT_IPC_FLAG_FIFO);
+    bench->attached = RT_TRUE;
+    rt_kprintf("%s %c%c: %s\n", WLAN_BENCH_DEVICE, bench->netif->name[0], bench->netif->name[1], WLAN_BENCH_ADDR);
+
+    return RT_EOK;
+}
+
+/* build the UDP frame from the peer to the device */
+static void wlan_bench_build(struct wlan_bench *bench, int size)
+{
+    rt_uint8_t *frame = bench->frame;
+    rt_uint8_t *ip = frame + 14;
+    rt_uint8_t *udp = ip + 20;
+    ip4_addr_t src, dst;
+    rt_uint16_t chksum;
+    int index;
+
+    ip4addr_aton(WLAN_BENCH_PEER, &src);
+    ip4addr_aton(WLAN_BENCH_ADDR, &dst);
+
+    rt_memcpy(frame, bench->netif->hwaddr, 6);
+    rt_memcpy(frame + 6, wlan_bench_peer_mac, 6);
+    frame[12] = 0x08;
+    frame[13] = 0x00;
+
+    rt_memset(ip, 0, 20);
+    ip[0] = 0x45;
+    ip[2] = (20 + 8 + size) >> 8;
+    ip[3] = (20 + 8 + size) & 0xff;
+    ip[8] = 64;
+    ip[9] = IP_PROTO_UDP;
+    rt_memcpy(ip + 12, &src, 4);
+    rt_memcpy(ip + 16, &dst, 4);
+    chksum = inet_chksum(ip, 20);
+    rt_memcpy(ip + 10, &chksum, 2);
+
+    /* the source and destination port are same, the checksum is 0 */
+    udp[0] = udp[2] = WLAN_BENCH_PORT >> 8;
+    udp[1] = udp[3] = WLAN_BENCH_PORT & 0xff;
+    udp[4] = (8 + size) >> 8;
+    udp[5] = (8 + size) & 0xff;
+    udp[6] = udp[7] = 0;
+
+    for (index = 0; index < size; index++)
+        udp[8 + index] = (rt_uint8_t)index;
+}
+
+/* the device receives the frame, return RT_EOK if it's reported to lwIP */
+static rt_err_t wlan_bench_input(struct wlan_bench *bench, rt_bool_t zero_copy, int len)
+{
+    void *buff, *data;
+
+    if (!zero_copy)
+    {
+        /* received into the buffer of device by DMA, then copied into pbuf */
+        rt_memcpy(bench->dma_buf, bench->frame, len);
+        return rt_wlan_dev_report_data(&bench->wlan, bench->dma_buf, len);
+    }
+
+    buff = rt_wlan_dev_alloc_buff(&bench->wlan, len, &data);
+    if (buff == RT_NULL)
+        return -RT_ENOMEM;
+
+    /* received into pbuf by DMA */
+    rt_memcpy(data, bench->frame, len);
+    if (rt_wlan_dev_report_buff(&bench->wlan, buff, len) != RT_EOK)
+    {
+        rt_wlan_dev_free_buff(&bench->wlan, buff);
+        return -RT_EFULL;
+    }
+    return RT_EOK;
+}
+
+static void wlan_bench_recv_entry(void *parameter)
+{
+    struct wlan_bench *bench = (struct wlan_bench *)parameter;
+    struct sockaddr_in addr;
+    struct timeval timeout;
+    static char buf[WLAN_BENCH_SIZE_MAX];
+    int sock, len;
+
+    sock = lwip_socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+        goto __exit;
+
+    timeout.tv_sec = WLAN_BENCH_TIMEOUT / RT_TICK_PER_SECOND;
+    timeout.tv_usec = 0;
+    lwip_setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(WLAN_BENCH_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (lwip_bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        goto __exit;
+
+    rt_sem_release(&bench->rx_ready);
+    while (bench->rx_frames < bench->rx_expect)
+    {
+        len = lwip_recv(sock, buf, sizeof(buf), 0);
+        if (len <= 0)
+            break;
+
+        bench->rx_frames++;
+        bench->rx_bytes += len;
+        bench->rx_tick = rt_tick_get();
+    }
+
+__exit:
+    if (sock >= 0)
+        lwip_close(sock);
+    else
+        rt_kprintf("create the socket failed\n");
+    rt_sem_release(&bench->rx_ready);
+    rt_sem_release(&bench->rx_done);
+}
+
+static void wlan_bench_rx(struct wlan_bench *bench, rt_bool_t zero_copy, int count, int size)
+{
+    rt_thread_t tid;
+    rt_uint32_t retries = 0;
+    rt_tick_t tick;
+    int index;
+
+    bench->rx_expect = count;
+    bench->rx_frames = 0;
+    bench->rx_bytes = 0;
+    rt_sem_control(&bench->rx_ready, RT_IPC_CMD_RESET, 0);
+    rt_sem_control(&bench->rx_done, RT_IPC_CMD_RESET, 0);
+    wlan_bench_build(bench, size);
+
+    /* the receiver is prior to the device */
+    tid = rt_thread_create("wb_recv", wlan_bench_recv_entry, bench, 2048,
+                           rt_thread_self()->current_priority - 1, 10);
+    if (tid == RT_NULL)
+    {
+        rt_kprintf("create the receiver failed\n");
+        return;
+    }
+    rt_thread_startup(tid);
+    rt_sem_take(&bench->rx_ready, RT_WAITING_FOREVER);
+
+    tick = rt_tick_get();
+    for (index = 0; index < count; index++)
+    {
+        while (wlan_bench_input(bench, zero_copy, WLAN_BENCH_HDR_LEN + size) != RT_EOK)
+        {
+            /* the queue of lwIP protocol is full */
+            retries++;
+            rt_thread_delay(1);
+        }
+    }
+    rt_sem_take(&bench->rx_done, RT_WAITING_FOREVER);
+    tick = (bench->rx_frames ? bench->rx_tick : rt_tick_get()) - tick;
+    if (tick == 0)
+        tick = 1;
+
+    rt_kprintf("rx %s: %d/%d frames, %d bytes, %d retries in %d ticks, %d KB/s\n",
+               zero_copy ? "zc" : "copy", bench->rx_frames, count, bench->rx_bytes, retries, tick,
+               (rt_uint32_t)((rt_uint64_t)bench->rx_bytes * RT_TICK_PER_SECOND / 1024 / tick));
+}
+
+static void wlan_bench_tx(struct wlan_bench *bench, rt_bool_t zero_copy, int count, int size)
+{
+    struct sockaddr_in addr;
+    static char buf[WLAN_BENCH_SIZE_MAX];
+    rt_tick_t tick;
+    int sock, index, optval = 1;
+
+    bench->tx_expect = count;
+    bench->tx_frames = 0;
+    bench->tx_bytes = 0;
+    bench->tx_segs = 0;
+    rt_sem_control(&bench->tx_done, RT_IPC_CMD_RESET, 0);
+
+    sock = lwip_socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0)
+    {
+        rt_kprintf("create the socket failed\n");
+        return;
+    }
+    lwip_setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &optval, sizeof(optval));
+
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(WLAN_BENCH_PORT);
+    addr.sin_addr.s_addr = ipaddr_addr(WLAN_BENCH_BROADCAST);
+    for (index = 0; index < size; index++)
+        buf[index] = (char)index;
+
+    tick = rt_tick_get();
+    for (index = 0; index < count; index++)
+    {
+        while (lwip_sendto(sock, buf, size, 0, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+            rt_thread_delay(1);
+    }
+    rt_sem_take(&bench->tx_done, WLAN_BENCH_TIMEOUT);
+    tick = rt_tick_get() - tick;
+    if (tick == 0)
+        tick = 1;
+    lwip_close(sock);
+
+    rt_kprintf("tx %s: %d/%d frames, %d bytes, %d segments in %d ticks, %d KB/s\n",
+               zero_copy ? "zc" : "copy", bench->tx_frames, count, bench->tx_bytes, bench->tx_segs, tick,
+               (rt_uint32_t)((rt_uint64_t)bench->tx_bytes * RT_TICK_PER_SECOND / 1024 / tick));
+}
+
+static void wlan_bench(int argc, char **argv)
+{
+    struct wlan_bench *bench = &wlan_bench_dev;
+    rt_bool_t rx = RT_TRUE, zero_copy = RT_TRUE;
+    int count = 1000, size = 1024;
+
+    if (argc > 1)
+    {
+        if (!strcmp(argv[1], "tx"))
+            rx = RT_FALSE;
+        else if (strcmp(argv[1], "rx"))
+            goto __usage;
+    }
+    if (argc > 2)
+    {
+        if (!strcmp(argv[2], "copy"))
+            zero_copy = RT_FALSE;
+        else if (strcmp(argv[2], "zc"))
+            goto __usage;
+    }
+    if (argc > 3)
+        count = atoi(argv[3]);
+    if (argc > 4)
+        size = atoi(argv[4]);
+    if (count <= 0 || size <= 0 || size > WLAN_BENCH_SIZE_MAX)
+        goto __usage;
+
+    if (wlan_bench_attach(bench) != RT_EOK)
+        return;
+
+    bench->wlan.ops = zero_copy ? &wlan_bench_zc_ops : &wlan_bench_copy_ops;
+    if (rx)
+        wlan_bench_rx(bench, zero_copy, count, size);
+    else
+        wlan_bench_tx(bench, zero_copy, count, size);
+    return;
+
+__usage:
+    rt_kprintf("Usage: wlan_bench [rx|tx] [copy|zc] [count] [size <= %d]\n", WLAN_BENCH_SIZE_MAX);
+}
+MSH_CMD_EXPORT(wlan_bench, WLAN data path throughput: wlan_bench [rx|tx] [copy|zc] [count] [size]);
+#endif